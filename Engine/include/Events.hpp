@@ -32,6 +32,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 typedef const void* Sender; ///< A pointer to an object that sent the event
 template<typename... Params> class Event;
 
@@ -91,10 +95,10 @@ class RDelegate : public DelegateBase {
 public:
     typedef Ret(*CallStub)(DelegateBase::Caller, DelegateBase::Function, Args...); ///< Function type for a stub
 
-    RDelegate(Caller c, Function f, CallStub s, Deleter d) : DelegateBase(c, f, s, d) {
+    RDelegate(Caller c, Function f, CallStub s, Deleter d) : DelegateBase(c, f, (UnknownStub)s, d) {
         // Empty
     }
-    RDelegate() : DelegateBase(nullptr, nullptr, simpleCall, doNothing) {
+    RDelegate() : DelegateBase(nullptr, nullptr, (UnknownStub)simpleCall, doNothing) {
         // Empty
     }
 
@@ -119,7 +123,7 @@ public:
         return new RDelegate(no, *(Function*)&f, objectCall<T>, freeObject<T>);
     }
     static RDelegate create(Ret(*f)(Args...)) {
-        return RDelegate(nullptr, f, simpleCall, doNothing);
+        return RDelegate(nullptr, (Function)f, simpleCall, doNothing);
     }
 
     Ret invoke(Args... args) const {
@@ -140,9 +144,12 @@ protected:
     static Ret objectCall(Caller obj, Function func, Args... args) {
         typedef Ret(T::*fType)(Args...);
 
-        // Properly cast internal values
+        // Properly cast internal values. Member pointers can be wider than Function (two words
+        // on the Itanium ABI), so rebuild one with a zero this-adjustment instead of reading past func.
         auto p = static_cast<T*>(obj);
-        fType f = *(fType*)&func;
+        fType f;
+        std::memset(&f, 0, sizeof(f));
+        std::memcpy(&f, &func, sizeof(func) < sizeof(f) ? sizeof(func) : sizeof(f));
 
         // Call function using object
         return (p->*f)(args...);
@@ -157,7 +164,10 @@ protected:
 
 template<typename... Args>
 class Delegate : public RDelegate<void, Args...> {
+    typedef RDelegate<void, Args...> Base;
 public:
+    typedef typename Base::CallStub CallStub;
+
     Delegate(DelegateBase::Caller c, DelegateBase::Function f, CallStub s, DelegateBase::Deleter d) : RDelegate<void, Args...>(c, f, s, d) {
         // Empty
     }
@@ -167,26 +177,26 @@ public:
 
     template<typename T>
     static Delegate create(const T* o, void(T::*f)(Args...) const) {
-        return Delegate(const_cast<T*>(o), *(DelegateBase::Function*)&f, objectCall<T>, doNothing);
+        return Delegate(const_cast<T*>(o), *(DelegateBase::Function*)&f, Base::template objectCall<T>, DelegateBase::doNothing);
     }
     template<typename T>
     static Delegate* createCopy(const T* o, void(T::*f)(Args...) const) {
         T* no = (T*)operator new(sizeof(T));
         new (no)T(*o);
-        return new Delegate(no, *(DelegateBase::Function*)&f, objectCall<T>, freeObject<T>);
+        return new Delegate(no, *(DelegateBase::Function*)&f, Base::template objectCall<T>, DelegateBase::template freeObject<T>);
     }
     template<typename T>
     static Delegate create(T* o, void(T::*f)(Args...)) {
-        return Delegate(o, *(DelegateBase::Function*)&f, objectCall<T>, doNothing);
+        return Delegate(o, *(DelegateBase::Function*)&f, Base::template objectCall<T>, DelegateBase::doNothing);
     }
     template<typename T>
     static Delegate* createCopy(T* o, void(T::*f)(Args...)) {
         T* no = (T*)operator new(sizeof(T));
         new (no)T(*o);
-        return new Delegate(no, *(DelegateBase::Function*)&f, objectCall<T>, freeObject<T>);
+        return new Delegate(no, *(DelegateBase::Function*)&f, Base::template objectCall<T>, DelegateBase::template freeObject<T>);
     }
     static Delegate create(void(*f)(Args...)) {
-        return Delegate(nullptr, f, simpleCall, doNothing);
+        return Delegate(nullptr, (DelegateBase::Function)f, Base::simpleCall, DelegateBase::doNothing);
     }
 };
 
@@ -214,30 +224,30 @@ RDelegate<Ret, Args...> makeRDelegate(Ret(*f)(Args...)) {
 }
 template<typename T, typename Ret, typename... Args>
 RDelegate<Ret, Args...> makeRDelegate(T& obj, Ret(T::*f)(Args...)const) {
-    return RDelegate<Ret, Args...>::create<T>(&obj, f);
+    return RDelegate<Ret, Args...>::template create<T>(&obj, f);
 }
 template<typename T, typename Ret, typename... Args>
 RDelegate<Ret, Args...> makeRDelegate(T& obj, Ret(T::*f)(Args...)) {
-    return RDelegate<Ret, Args...>::create<T>(&obj, f);
+    return RDelegate<Ret, Args...>::template create<T>(&obj, f);
 }
 template<typename Ret, typename... Args, typename F>
 RDelegate<Ret, Args...> makeRDelegate(F& obj) {
     typedef Ret(F::*fType)(Args...) const;
     fType f = &F::operator();
-    return RDelegate<Ret, Args...>::create<F>(&obj, f);
+    return RDelegate<Ret, Args...>::template create<F>(&obj, f);
 }
 
 template<typename F>
 typename RDelegateType<F>::type* makeRFunctor(F& obj) {
-    return RDelegateType<F>::type::createCopy<F>(&obj, &F::operator());
+    return RDelegateType<F>::type::template createCopy<F>(&obj, &F::operator());
 }
 template<typename T, typename Ret, typename... Args>
 RDelegate<Ret, Args...>* makeRFunctor(T& obj, Ret(T::*f)(Args...)const) {
-    return RDelegate<Ret, Args...>::createCopy<T>(&obj, f);
+    return RDelegate<Ret, Args...>::template createCopy<T>(&obj, f);
 }
 template<typename T, typename Ret, typename... Args>
 RDelegate<Ret, Args...>* makeRFunctor(T& obj, Ret(T::*f)(Args...)) {
-    return RDelegate<Ret, Args...>::createCopy<T>(&obj, f);
+    return RDelegate<Ret, Args...>::template createCopy<T>(&obj, f);
 }
 
 template<typename... Args>
@@ -246,30 +256,30 @@ Delegate<Args...> makeDelegate(void(*f)(Args...)) {
 }
 template<typename T, typename... Args>
 Delegate<Args...> makeDelegate(T& obj, void(T::*f)(Args...)const) {
-    return Delegate<Args...>::create<T>(&obj, f);
+    return Delegate<Args...>::template create<T>(&obj, f);
 }
 template<typename T, typename... Args>
 Delegate<Args...> makeDelegate(T& obj, void(T::*f)(Args...)) {
-    return Delegate<Args...>::create<T>(&obj, f);
+    return Delegate<Args...>::template create<T>(&obj, f);
 }
 template<typename... Args, typename F>
 Delegate<Args...> makeDelegate(F& obj) {
     typedef void(F::*fType)(Args...) const;
     fType f = &F::operator();
-    return Delegate<Args...>::create<F>(&obj, f);
+    return Delegate<Args...>::template create<F>(&obj, f);
 }
 
 template<typename F>
 typename DelegateType<F>::type* makeFunctor(F& obj) {
-    return DelegateType<F>::type::createCopy<F>(&obj, &F::operator());
+    return DelegateType<F>::type::template createCopy<F>(&obj, &F::operator());
 }
 template<typename T, typename... Args>
 Delegate<Args...>* makeFunctor(T& obj, void(T::*f)(Args...)const) {
-    return Delegate<Args...>::createCopy<T>(&obj, f);
+    return Delegate<Args...>::template createCopy<T>(&obj, f);
 }
 template<typename T, typename... Args>
 Delegate<Args...>* makeFunctor(T& obj, void(T::*f)(Args...)) {
-    return Delegate<Args...>::createCopy<T>(&obj, f);
+    return Delegate<Args...>::template createCopy<T>(&obj, f);
 }
 
 /// An event that invokes methods taking certain arguments
@@ -373,7 +383,7 @@ public:
     /// @param f: Callback function
     template<typename F, typename... Params>
     void addAutoHook(Event<Params...>& e, F f) {
-        auto fd = e.addFunctor<F>(f);
+        auto fd = e.template addFunctor<F>(f);
 
         Deleter d = makeFunctor<>([fd, &e]() {
             e -= *fd;
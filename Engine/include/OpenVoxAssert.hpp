@@ -35,6 +35,7 @@
 
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <iostream>
 #include <sstream>
@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <climits>
+
 #include "OpenVox.h"
 
 namespace openvox {
@@ -111,7 +113,7 @@ namespace openvox {
             return m_displayMode.screenHeight;
         }
         u32v2 getViewportDims() const {
-            return ui32v2(m_displayMode.screenWidth, m_displayMode.screenHeight);
+            return u32v2(m_displayMode.screenWidth, m_displayMode.screenHeight);
         }
         f32 getAspectRatio() const {
             return (float)m_displayMode.screenWidth / (float)m_displayMode.screenHeight;
@@ -159,7 +161,6 @@ namespace openvox {
 
     private:
         OPENVOX_NON_COPYABLE(Window);
-        OPENVOX_NON_COPYABLE(Window);
 
         void onResize(Sender s, const WindowResizeEvent& e);
         void onQuitSignal(Sender);
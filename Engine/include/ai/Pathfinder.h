@@ -0,0 +1,166 @@
+//
+// Pathfinder.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file Pathfinder.h
+* @brief Hierarchical A* pathfinding for walkers on the voxel grid.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../Events.hpp"
+#include "../voxel/ChunkMap.h"
+
+#define PATH_MAX_DROP 3 ///< Highest ledge a walker will drop down
+#define PATH_MOVE_COST 10 ///< Cost of one horizontal step
+#define PATH_CLIMB_COST 5 ///< Extra cost of stepping up one block
+#define PATH_DROP_COST 2 ///< Extra cost per block dropped
+#define PATH_NO_COST 0xFFFFFFFFu
+#define DEFAULT_PATH_REQUEST_BUDGET 1024 ///< Requests solved per update()
+
+namespace openvox {
+    class JobSystem;
+    struct PathContext; ///< Per-thread search memory, reused between searches
+
+    typedef u32 PathRequestID;
+
+    enum class PathStatus {
+        FOUND,
+        NO_PATH,
+        INVALID_ENDPOINT ///< Start or goal is not walkable, or its chunk is not in the graph
+    };
+
+    struct PathResult {
+        PathRequestID id;
+        PathStatus status;
+        u32 cost;
+        std::vector<i32v3> path; ///< Cells after the start, up to and including the goal
+    };
+
+    /*! @brief Finds paths for walkers that are one voxel wide and two voxels tall.
+    *
+    * A walkable cell is air with air above it and a solid voxel below it. A walker steps to
+    * the four horizontal neighbors, climbs one block and drops up to PATH_MAX_DROP blocks.
+    *
+    * Every chunk added to the pathfinder is a cluster of the abstract graph. Moves between
+    * two clusters are grouped into connected entrances and each entrance contributes one
+    * transition, whose ends become abstract nodes. Nodes of a cluster are joined by the cost
+    * of the shortest path between them inside the cluster. A query connects its start and
+    * goal to the nodes of their clusters, searches the abstract graph and then refines each
+    * abstract edge with an A* search confined to one cluster.
+    *
+    * Clusters are rebuilt lazily at the next update() after a voxel or chunk near them
+    * changed. requestPath() queues a query that is solved in a batch by update(), spread
+    * over the job system, and delivered through onPathComplete.
+    */
+    class Pathfinder {
+    public:
+        Pathfinder(const ChunkMap* chunkMap);
+        ~Pathfinder();
+
+        /*! @brief Adds a loaded chunk to the graph, or marks it for rebuilding if already added.
+        */
+        void addChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        /*! @brief Removes an unloading chunk from the graph.
+        */
+        void removeChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        /*! @brief Marks the clusters a voxel change can affect for rebuilding.
+        */
+        void invalidateVoxel(UNIT_SPACE(VOXEL) const i32v3& voxelPos);
+
+        /*! @brief Queues a path query that is solved during a later update().
+        */
+        PathRequestID requestPath(UNIT_SPACE(VOXEL) const i32v3& start, UNIT_SPACE(VOXEL) const i32v3& goal);
+        /*! @brief Rebuilds changed clusters and solves queued requests up to the request budget.
+        *
+        * The ChunkMap must not change while update() runs.
+        * @param jobs: Optional job system that spreads the work over its threads.
+        */
+        void update(OPT JobSystem* jobs = nullptr);
+        /*! @brief Finds a path immediately, rebuilding changed clusters first.
+        *
+        * @param path: Receives the cells after start up to and including goal.
+        * @param cost: Optional cost of the path.
+        */
+        PathStatus findPath(UNIT_SPACE(VOXEL) const i32v3& start, UNIT_SPACE(VOXEL) const i32v3& goal,
+                            OUT std::vector<i32v3>& path, OPT u32* cost = nullptr);
+
+        bool isWalkable(UNIT_SPACE(VOXEL) const i32v3& voxelPos) const;
+
+        /*! @brief Sets the maximum number of requests solved per update().
+        */
+        void setRequestBudget(size_t requests) {
+            m_requestBudget = requests;
+        }
+
+        size_t getClusterCount() const {
+            return m_clusters.size();
+        }
+        size_t getDirtyClusterCount() const {
+            return m_dirty.size();
+        }
+        size_t getPendingRequestCount() const {
+            return m_requests.size();
+        }
+
+        Event<const PathResult&> onPathComplete; ///< Sent from update() for every solved request
+
+    private:
+        OPENVOX_NON_COPYABLE(Pathfinder);
+
+        /// Edge to a node in another cluster, found by its cell since node indices change on rebuild
+        struct InterEdge {
+            i32v3 target;
+            u32 cost;
+        };
+        struct IntraEdge {
+            u16 node;
+            u32 cost;
+        };
+        struct Node {
+            i32v3 position;
+            u16 voxelIndex;
+            std::vector<IntraEdge> intra;
+            std::vector<InterEdge> inter;
+        };
+        struct Cluster {
+            i32v3 position;
+            u32 id; ///< Stable identifier used to key search states
+            bool dirty;
+            std::vector<Node> nodes; ///< Sorted by voxelIndex
+        };
+        struct Request {
+            PathRequestID id;
+            i32v3 start;
+            i32v3 goal;
+        };
+
+        void markDirty(const i32v3& chunkPos);
+        void rebuildDirty(OPT JobSystem* jobs);
+        void buildCluster(PathContext& ctx, Cluster* c) const;
+        void solve(PathContext& ctx, const i32v3& start, const i32v3& goal, OUT PathResult& result) const;
+        Cluster* getCluster(const i32v3& chunkPos) const;
+        /// @return Index of the node at a voxel index, or -1
+        static int findNode(const Cluster* c, u16 voxelIndex);
+        PathContext* acquireContext();
+        void releaseContext(PathContext* ctx);
+
+        const ChunkMap* m_chunkMap;
+        std::unordered_map<i32v3, Cluster*, PositionHash> m_clusters;
+        std::vector<Cluster*> m_dirty;
+        u32 m_nextClusterID = 0;
+        std::vector<Request> m_requests;
+        PathRequestID m_nextRequestID = 1;
+        size_t m_requestBudget = DEFAULT_PATH_REQUEST_BUDGET;
+        std::vector<PathContext*> m_contexts; ///< Every context ever created
+        std::vector<PathContext*> m_freeContexts; ///< Contexts not in use, guarded by m_contextLock
+        std::mutex m_contextLock;
+    };
+}
@@ -0,0 +1,104 @@
+//
+// Archetype.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file Archetype.h
+* @brief Chunked SoA storage for all entities with one exact set of components.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "../Decorators.h"
+#include "Component.hpp"
+
+#define ECS_CHUNK_BYTES 16384 ///< Size of one archetype chunk
+#define ECS_COLUMN_ALIGNMENT 64 ///< Every component array in a chunk starts on a cache line
+
+namespace openvox {
+    /*! @brief Stores entities that have exactly the same component types.
+    *
+    * Entities live in fixed size chunks. Within a chunk each component type has its own
+    * contiguous, 64-byte aligned array, so systems stream through exactly the data they use.
+    * Every chunk except the last is full; removal swaps the last entity into the hole.
+    */
+    class Archetype {
+    public:
+        /*! @brief Creates an empty archetype and computes the chunk layout.
+        */
+        Archetype(ComponentMask mask);
+        /*! @brief Destroys all stored components and frees the chunks.
+        */
+        ~Archetype();
+
+        /*! @brief Reserves a row for an entity. Components in the row are left unconstructed.
+        *
+        * @param e: Entity stored in the row.
+        * @param chunk: Receives the chunk index.
+        * @param row: Receives the row inside the chunk.
+        */
+        void allocateRow(Entity e, OUT u32& chunk, OUT u32& row);
+        /*! @brief Destroys the components in a row and fills it with the last entity.
+        *
+        * @return The entity moved into the row, or INVALID_ENTITY if the row was the last.
+        */
+        Entity removeRow(u32 chunk, u32 row);
+
+        bool hasComponent(ComponentTypeID t) const {
+            return (m_mask & ((ComponentMask)1 << t)) != 0;
+        }
+        /*! @brief Gets the array of one component type in a chunk.
+        */
+        void* getColumn(u32 chunk, ComponentTypeID t) const {
+            return m_chunks[chunk].data + m_columns[t].offset;
+        }
+        void* getComponent(u32 chunk, u32 row, ComponentTypeID t) const {
+            return m_chunks[chunk].data + m_columns[t].offset + (size_t)row * m_columns[t].size;
+        }
+        Entity* getEntities(u32 chunk) const {
+            return reinterpret_cast<Entity*>(m_chunks[chunk].data);
+        }
+
+        ComponentMask getMask() const {
+            return m_mask;
+        }
+        const std::vector<ComponentTypeID>& getTypes() const {
+            return m_types;
+        }
+        u32 getChunkCount() const {
+            return (u32)m_chunks.size();
+        }
+        u32 getChunkEntityCount(u32 chunk) const {
+            return m_chunks[chunk].count;
+        }
+        u32 getChunkCapacity() const {
+            return m_capacity;
+        }
+        size_t getEntityCount() const {
+            return m_entityCount;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(Archetype);
+
+        struct Column {
+            u32 offset = 0; ///< Byte offset of the array from the chunk start
+            u32 size = 0; ///< Size of one component
+        };
+        struct Chunk {
+            u8* data;
+            u32 count;
+        };
+
+        ComponentMask m_mask;
+        std::vector<ComponentTypeID> m_types; ///< Component types in ascending ID order
+        Column m_columns[MAX_COMPONENT_TYPES]; ///< Layout indexed by ComponentTypeID
+        std::vector<Chunk> m_chunks;
+        u32 m_capacity = 0; ///< Entities per chunk
+        size_t m_entityCount = 0;
+    };
+}
@@ -0,0 +1,148 @@
+//
+// Component.hpp
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file Component.hpp
+* @brief Entity handles and runtime component type information for the ECS.
+*/
+
+#pragma once
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "../Types.h"
+
+#define MAX_COMPONENT_TYPES 64 ///< Component type IDs must fit in a ComponentMask
+
+namespace openvox {
+    typedef u32 ComponentTypeID; ///< Index of a registered component type
+    typedef u64 ComponentMask; ///< One bit per ComponentTypeID
+
+    /*! @brief Handle to an entity in an EcsWorld.
+    *
+    * The generation changes every time an index is reused, so stale handles can be detected.
+    */
+    struct Entity {
+    public:
+        u32 index;
+        u32 generation;
+
+        bool operator==(const Entity& o) const {
+            return index == o.index && generation == o.generation;
+        }
+        bool operator!=(const Entity& o) const {
+            return index != o.index || generation != o.generation;
+        }
+    };
+    const Entity INVALID_ENTITY = { 0xFFFFFFFFu, 0xFFFFFFFFu }; ///< Handle that never refers to an entity
+
+    /*! @brief Type erased operations needed to store a component in raw chunk memory.
+    */
+    struct ComponentInfo {
+    public:
+        size_t size;
+        size_t alignment;
+        void(*construct)(void* dst); ///< Default construct in place
+        void(*copyConstruct)(void* dst, const void* src); ///< Copy construct in place
+        void(*moveConstruct)(void* dst, void* src); ///< Move construct in place, src must still be destroyed
+        void(*destroy)(void* dst); ///< Call the destructor
+    };
+
+    namespace impl {
+        template<typename T>
+        void constructComponent(void* dst) {
+            new (dst) T();
+        }
+        template<typename T>
+        void copyConstructComponent(void* dst, const void* src) {
+            new (dst) T(*static_cast<const T*>(src));
+        }
+        template<typename T>
+        void moveConstructComponent(void* dst, void* src) {
+            new (dst) T(std::move(*static_cast<T*>(src)));
+        }
+        template<typename T>
+        void destroyComponent(void* dst) {
+            static_cast<T*>(dst)->~T();
+        }
+
+        /// Holds the ID for one component type, registered on first use
+        template<typename T>
+        struct ComponentTypeRegistry {
+            static ComponentTypeID id();
+        };
+    }
+
+    /*! @brief Registers a component type. Called automatically the first time a type is used.
+    *
+    * Throws std::length_error if MAX_COMPONENT_TYPES types are already registered.
+    *
+    * @return The new type's ID.
+    */
+    ComponentTypeID registerComponentType(const ComponentInfo& info);
+    /*! @brief Gets the operations for a registered component type.
+    */
+    const ComponentInfo& getComponentInfo(ComponentTypeID id);
+    /*! @brief Number of component types registered so far.
+    */
+    u32 getComponentTypeCount();
+
+    /*! @brief Gets the ID of a component type, registering it if needed.
+    *
+    * Any default constructible, copyable type can be a component, including the vector
+    * types from Types.h. Qualifiers are ignored, so const T and T share an ID.
+    */
+    template<typename T>
+    inline ComponentTypeID getComponentTypeID() {
+        return impl::ComponentTypeRegistry<typename std::remove_cv<T>::type>::id();
+    }
+    template<typename T>
+    inline ComponentMask getComponentMask() {
+        return (ComponentMask)1 << getComponentTypeID<T>();
+    }
+
+    /*! @brief Mask of several component types.
+    */
+    template<typename... Cs>
+    struct ComponentMaskOf;
+    template<>
+    struct ComponentMaskOf<> {
+        static ComponentMask get() {
+            return 0;
+        }
+    };
+    template<typename C, typename... Rest>
+    struct ComponentMaskOf<C, Rest...> {
+        static ComponentMask get() {
+            return getComponentMask<C>() | ComponentMaskOf<Rest...>::get();
+        }
+    };
+
+    template<typename T>
+    ComponentTypeID impl::ComponentTypeRegistry<T>::id() {
+        // Function local statics are initialized once, even across threads
+        static const ComponentTypeID s_id = registerComponentType({
+            sizeof(T), std::alignment_of<T>::value,
+            &constructComponent<T>, &copyConstructComponent<T>,
+            &moveConstructComponent<T>, &destroyComponent<T>
+        });
+        return s_id;
+    }
+}
+
+/*! @brief Declares a distinct component type that behaves like a vector type.
+*
+* Each component type may appear once per entity, so use this to store several vectors
+* on one entity, e.g. OPENVOX_VECTOR_COMPONENT(Velocity, f32v3).
+*/
+#define OPENVOX_VECTOR_COMPONENT(NAME, VECTOR_TYPE) \
+    struct NAME : public VECTOR_TYPE { \
+        NAME() : VECTOR_TYPE() {} \
+        NAME(const VECTOR_TYPE& v) : VECTOR_TYPE(v) {} \
+        using VECTOR_TYPE::VECTOR_TYPE; \
+    }
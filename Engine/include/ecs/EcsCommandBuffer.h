@@ -0,0 +1,104 @@
+//
+// EcsCommandBuffer.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file EcsCommandBuffer.h
+* @brief Records structural changes to an EcsWorld so they can be applied after iteration.
+*/
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "EcsWorld.h"
+
+#define ECS_COMMAND_BLOCK_BYTES 65536 ///< Size of one block of recorded component data
+
+namespace openvox {
+    /*! @brief Queue of entity creations, destructions and component changes.
+    *
+    * Recording is thread safe, so systems running under EcsWorld::forEachChunkParallel can
+    * share one buffer. Entities created through the buffer get placeholder handles that are
+    * only valid for further commands in the same buffer until playback() resolves them.
+    */
+    class EcsCommandBuffer {
+    public:
+        EcsCommandBuffer() {}
+        ~EcsCommandBuffer();
+
+        /*! @brief Queues creation of an entity with no components.
+        *
+        * @return Placeholder handle usable in later commands on this buffer.
+        */
+        Entity create();
+        /*! @brief Queues destruction of an entity.
+        */
+        void destroy(Entity e);
+        /*! @brief Queues adding or assigning a component.
+        */
+        template<typename T>
+        void add(Entity e, const T& component);
+        /*! @brief Queues removal of a component.
+        */
+        template<typename T>
+        void remove(Entity e) {
+            record(Command::REMOVE, e, getComponentTypeID<T>(), nullptr);
+        }
+
+        /*! @brief Applies all commands in recording order and clears the buffer.
+        *
+        * The buffer is not locked while commands are applied, so handlers of the world's
+        * events may record into it. Their commands are applied by the next playback().
+        *
+        * @param created: Optional list that receives the real handles of created entities, in order.
+        */
+        void playback(EcsWorld& world, OPT std::vector<Entity>* created = nullptr);
+        /*! @brief Discards all commands.
+        */
+        void clear();
+
+        bool isEmpty() const {
+            return m_commands.empty();
+        }
+        size_t getCommandCount() const {
+            return m_commands.size();
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(EcsCommandBuffer);
+
+        struct Command {
+            enum Type : u8 { CREATE, DESTROY, ADD, REMOVE };
+            Type type;
+            Entity entity;
+            ComponentTypeID component;
+            void* data; ///< Copy of the component for ADD
+        };
+
+        static const u32 PENDING_GENERATION = 0xFFFFFFFEu; ///< Marks placeholder handles
+
+        void record(Command::Type type, Entity e, ComponentTypeID t, void* data);
+        /// Reserves aligned space for component data. Blocks never move, so data stays valid.
+        void* allocate(size_t size, size_t alignment);
+
+        std::mutex m_lock;
+        std::vector<Command> m_commands;
+        std::vector<u8*> m_blocks;
+        size_t m_blockUsed = ECS_COMMAND_BLOCK_BYTES; ///< Bytes used in the last block
+        u32 m_pendingCount = 0; ///< Placeholder handles handed out
+    };
+
+    template<typename T>
+    inline void EcsCommandBuffer::add(Entity e, const T& component) {
+        ComponentTypeID t = getComponentTypeID<T>();
+        std::lock_guard<std::mutex> l(m_lock);
+        void* data = allocate(sizeof(T), std::alignment_of<T>::value);
+        new (data) T(component);
+        Command c = { Command::ADD, e, t, data };
+        m_commands.push_back(c);
+    }
+}
@@ -0,0 +1,163 @@
+//
+// EcsWorld.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file EcsWorld.h
+* @brief Archetype based entity component system.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../Events.hpp"
+#include "../jobs/JobSystem.h"
+#include "Archetype.h"
+
+namespace openvox {
+    /*! @brief Owns entities and their components.
+    *
+    * Entities with the same set of components share an Archetype. Queries walk the list of
+    * archetypes, skip those that lack a requested component, and hand each matching chunk to
+    * the caller as plain arrays.
+    *
+    * Adding or removing components moves the entity to another archetype. These structural
+    * changes must not happen while iterating; record them in an EcsCommandBuffer instead.
+    */
+    class EcsWorld {
+    public:
+        EcsWorld();
+        ~EcsWorld();
+
+        /*! @brief Creates an entity with no components.
+        */
+        Entity create();
+        /*! @brief Creates an entity with components copied from the arguments.
+        */
+        template<typename... Cs>
+        Entity create(const Cs&... components);
+        /*! @brief Destroys an entity and its components.
+        *
+        * @return False if the handle was stale.
+        */
+        bool destroy(Entity e);
+        bool isAlive(Entity e) const {
+            return e.index < m_records.size() && m_records[e.index].generation == e.generation && m_records[e.index].archetype;
+        }
+
+        /*! @brief Adds a component, or assigns it if the entity already has one.
+        *
+        * @return The stored component.
+        */
+        template<typename T>
+        T* add(Entity e, const T& component = T());
+        /*! @brief Removes a component.
+        *
+        * @return False if the entity did not have it.
+        */
+        template<typename T>
+        bool remove(Entity e) {
+            return removeComponent(e, getComponentTypeID<T>());
+        }
+        template<typename T>
+        bool has(Entity e) const {
+            return isAlive(e) && m_records[e.index].archetype->hasComponent(getComponentTypeID<T>());
+        }
+        /*! @brief Gets a component.
+        *
+        * @return The component, or nullptr if the entity does not have it.
+        */
+        template<typename T>
+        T* get(Entity e) const {
+            return static_cast<T*>(getComponent(e, getComponentTypeID<T>()));
+        }
+
+        /*! @brief Type erased add, default constructing the component if it is new.
+        *
+        * @return The stored component.
+        */
+        void* addComponent(Entity e, ComponentTypeID t);
+        /*! @brief Type erased add that move constructs the component from value.
+        *
+        * onComponentAdded is sent after the value is in place. If the entity already has the
+        * component it is replaced and no event is sent.
+        *
+        * @param value: Component to move from. The caller still destroys it.
+        * @return The stored component.
+        */
+        void* addComponent(Entity e, ComponentTypeID t, void* value);
+        /*! @brief Type erased remove.
+        */
+        bool removeComponent(Entity e, ComponentTypeID t);
+        /*! @brief Type erased get.
+        */
+        void* getComponent(Entity e, ComponentTypeID t) const;
+
+        /*! @brief Calls f once per chunk that has all of Cs.
+        *
+        * f is called as f(size_t count, const Entity* entities, Cs*... components), where each
+        * component pointer is a 64-byte aligned array of count elements.
+        */
+        template<typename... Cs, typename F>
+        void forEachChunk(F f);
+        /*! @brief Like forEachChunk, but chunks are spread over the job system.
+        *
+        * f may run concurrently on different chunks and must not make structural changes.
+        */
+        template<typename... Cs, typename F>
+        void forEachChunkParallel(JobSystem& jobs, F f);
+        /*! @brief Calls f(Entity, Cs&...) for every entity that has all of Cs.
+        */
+        template<typename... Cs, typename F>
+        void each(F f);
+
+        /*! @brief Counts entities that have all of Cs.
+        */
+        template<typename... Cs>
+        size_t count() const;
+
+        size_t getEntityCount() const {
+            return m_entityCount;
+        }
+        size_t getArchetypeCount() const {
+            return m_archetypeList.size();
+        }
+
+        Event<Entity> onEntityCreated; ///< Sent after an entity is created
+        Event<Entity> onEntityDestroyed; ///< Sent before an entity's components are destroyed
+        Event<Entity, ComponentTypeID> onComponentAdded; ///< Sent after a component is added
+        Event<Entity, ComponentTypeID> onComponentRemoved; ///< Sent before a component is removed
+
+    private:
+        OPENVOX_NON_COPYABLE(EcsWorld);
+
+        struct EntityRecord {
+            Archetype* archetype = nullptr; ///< Null when the index is free
+            u32 chunk = 0;
+            u32 row = 0;
+            u32 generation = 0;
+        };
+
+        /// Gets or creates the archetype for a component set
+        Archetype* getArchetype(ComponentMask mask);
+        /// Allocates an entity handle and a row in an archetype
+        Entity allocateEntity(Archetype* archetype);
+        /// Moves an entity's components into another archetype. New components are left unconstructed.
+        void moveEntity(Entity e, Archetype* to);
+        /// Fixes the record of an entity that was swapped into a freed row
+        void relocated(Entity moved, u32 chunk, u32 row);
+
+        std::unordered_map<ComponentMask, Archetype*> m_archetypes;
+        std::vector<Archetype*> m_archetypeList; ///< Archetypes in creation order, for iteration
+        std::vector<EntityRecord> m_records; ///< Indexed by Entity::index
+        std::vector<u32> m_freeIndices;
+        size_t m_entityCount = 0;
+    };
+}
+
+#include "EcsWorld.inl"
@@ -0,0 +1,87 @@
+/* This file implements the templated functions of EcsWorld. */
+
+template<typename... Cs>
+inline openvox::Entity openvox::EcsWorld::create(const Cs&... components) {
+    Archetype* archetype = getArchetype(ComponentMaskOf<Cs...>::get());
+    Entity e = allocateEntity(archetype);
+    const EntityRecord& r = m_records[e.index];
+
+    // Copy construct each component into its column
+    int expand[] = { 0, (new (archetype->getComponent(r.chunk, r.row, getComponentTypeID<Cs>())) Cs(components), 0)... };
+    (void)expand;
+
+    onEntityCreated(e);
+    return e;
+}
+
+template<typename T>
+inline T* openvox::EcsWorld::add(Entity e, const T& component /*= T()*/) {
+    openvox_assert(isAlive(e), "Adding a component to a dead entity");
+    ComponentTypeID t = getComponentTypeID<T>();
+    Archetype* from = m_records[e.index].archetype;
+    if (from->hasComponent(t)) {
+        T* existing = static_cast<T*>(from->getComponent(m_records[e.index].chunk, m_records[e.index].row, t));
+        *existing = component;
+        return existing;
+    }
+
+    moveEntity(e, getArchetype(from->getMask() | ((ComponentMask)1 << t)));
+    const EntityRecord& r = m_records[e.index];
+    T* stored = new (r.archetype->getComponent(r.chunk, r.row, t)) T(component);
+    onComponentAdded(e, t);
+    return stored;
+}
+
+template<typename... Cs, typename F>
+inline void openvox::EcsWorld::forEachChunk(F f) {
+    const ComponentMask mask = ComponentMaskOf<Cs...>::get();
+    for (size_t i = 0; i < m_archetypeList.size(); i++) {
+        Archetype* a = m_archetypeList[i];
+        if ((a->getMask() & mask) != mask) continue;
+        for (u32 c = 0; c < a->getChunkCount(); c++) {
+            f((size_t)a->getChunkEntityCount(c), (const Entity*)a->getEntities(c),
+              static_cast<Cs*>(a->getColumn(c, getComponentTypeID<Cs>()))...);
+        }
+    }
+}
+
+template<typename... Cs, typename F>
+inline void openvox::EcsWorld::forEachChunkParallel(JobSystem& jobs, F f) {
+    const ComponentMask mask = ComponentMaskOf<Cs...>::get();
+    std::vector<std::pair<Archetype*, u32> > work;
+    for (size_t i = 0; i < m_archetypeList.size(); i++) {
+        Archetype* a = m_archetypeList[i];
+        if ((a->getMask() & mask) != mask) continue;
+        for (u32 c = 0; c < a->getChunkCount(); c++) {
+            work.push_back(std::make_pair(a, c));
+        }
+    }
+
+    jobs.parallelFor(work.size(), 4, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            Archetype* a = work[i].first;
+            u32 c = work[i].second;
+            f((size_t)a->getChunkEntityCount(c), (const Entity*)a->getEntities(c),
+              static_cast<Cs*>(a->getColumn(c, getComponentTypeID<Cs>()))...);
+        }
+    });
+}
+
+template<typename... Cs, typename F>
+inline void openvox::EcsWorld::each(F f) {
+    forEachChunk<Cs...>([&f](size_t n, const Entity* entities, Cs*... components) {
+        for (size_t i = 0; i < n; i++) {
+            f(entities[i], components[i]...);
+        }
+    });
+}
+
+template<typename... Cs>
+inline size_t openvox::EcsWorld::count() const {
+    const ComponentMask mask = ComponentMaskOf<Cs...>::get();
+    size_t n = 0;
+    for (size_t i = 0; i < m_archetypeList.size(); i++) {
+        if ((m_archetypeList[i]->getMask() & mask) == mask) n += m_archetypeList[i]->getEntityCount();
+    }
+    return n;
+}
@@ -0,0 +1,86 @@
+//
+// ColumnCache.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file ColumnCache.h
+* @brief Shares 2D terrain data between vertically stacked chunks.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#include "NoiseLattice.h"
+
+namespace openvox {
+    /*! @brief 2D terrain values sampled at one XZ position.
+    */
+    struct ColumnSample {
+        f32 height; ///< Surface height in voxels
+        u16 biome;
+    };
+
+    /*! @brief 2D terrain data of one chunk column, X fastest then Z.
+    */
+    struct ColumnData {
+        f32 height[CHUNK_LAYER];
+        u16 biome[CHUNK_LAYER];
+    };
+
+    /*! @brief Computes ColumnData once per chunk column and hands it to every chunk in the column.
+    *
+    * Columns are sampled on the lattice of a NoiseLattice with the same stride. Heights are
+    * interpolated bilinearly. Biomes cannot be interpolated, so each voxel column takes the
+    * biome of the lattice point nearest to it.
+    *
+    * get() may be called from any thread. Two threads asking for a missing column at the same
+    * time may both compute it, but only one result is kept.
+    */
+    class ColumnCache {
+    public:
+        typedef std::function<ColumnSample(f32 x, f32 z)> ColumnFunc; ///< 2D terrain at a world voxel position
+
+        ColumnCache(ColumnFunc func, u32 stride = 4);
+        ~ColumnCache();
+
+        /*! @brief Gets the data of a column, computing it if needed.
+        *
+        * @param columnPos: Chunk position of the column in XZ.
+        * @return Data that stays valid until the column is removed.
+        */
+        const ColumnData& get(UNIT_SPACE(CHUNK) const i32v2& columnPos);
+        /*! @brief Frees a column, e.g. once the last chunk in it finished generating.
+        *
+        * @pre No thread is using the column's data.
+        */
+        void removeColumn(UNIT_SPACE(CHUNK) const i32v2& columnPos);
+        /*! @brief Frees every column.
+        *
+        * @pre No thread is using any column's data.
+        */
+        void clear();
+
+        size_t getColumnCount() const;
+        /*! @brief Number of columns computed, counting ones computed twice by racing threads.
+        */
+        u64 getColumnsComputed() const {
+            return m_columnsComputed.load(std::memory_order_relaxed);
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(ColumnCache);
+
+        void compute(const i32v2& columnPos, OUT ColumnData& data) const;
+
+        ColumnFunc m_func;
+        NoiseLattice m_lattice;
+        std::unordered_map<i32v2, ColumnData*, PositionHash> m_columns;
+        mutable std::mutex m_lock;
+        std::atomic<u64> m_columnsComputed; ///< Written by job threads, read by anyone
+    };
+}
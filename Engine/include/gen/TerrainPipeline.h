@@ -0,0 +1,180 @@
+//
+// TerrainPipeline.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TerrainPipeline.h
+* @brief Generates chunks through ordered stages in parallel while respecting neighbor dependencies.
+*/
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "../Events.hpp"
+#include "../jobs/JobSystem.h"
+#include "../voxel/ChunkMap.h"
+#include "../voxel/VoxelEditor.h"
+
+#define MAX_STAGE_WRITE_RADIUS 1 ///< Furthest a stage may write into neighboring chunks, in chunks
+
+namespace openvox {
+    class TerrainPipeline;
+
+    /*! @brief What a stage function sees while it runs on one chunk.
+    */
+    class GenContext {
+    public:
+        UNIT_SPACE(CHUNK) const i32v3& getChunkPosition() const {
+            return m_chunkPos;
+        }
+        Chunk& getChunk() {
+            return *m_chunk;
+        }
+        u32 getStage() const {
+            return m_stage;
+        }
+        u64 getSeed() const {
+            return m_seed;
+        }
+
+        /*! @brief Writes a block anywhere within the stage's write radius.
+        *
+        * Blocks inside the chunk are written immediately. Blocks in neighbors are deferred and
+        * applied to the neighbor before its next stage, after every chunk around it finished this one.
+        */
+        void setBlock(UNIT_SPACE(VOXEL) const i32v3& voxelPos, BlockID id, EditMode mode = EditMode::REPLACE);
+
+    private:
+        friend class TerrainPipeline;
+        struct DeferredEdit {
+            i32v3 source; ///< Chunk that made the edit, used to order edits
+            i32v3 target; ///< Chunk the edit lands in
+            u16 voxelIndex;
+            BlockID id;
+            EditMode mode;
+        };
+
+        GenContext() {}
+
+        Chunk* m_chunk = nullptr;
+        i32v3 m_chunkPos;
+        u32 m_stage = 0;
+        i32 m_writeRadius = 0;
+        u64 m_seed = 0;
+        std::vector<DeferredEdit> m_deferred;
+    };
+
+    /*! @brief Runs chunks through generation stages such as density, caves, surface and features.
+    *
+    * Chunks advance one stage per job. A chunk starts a stage once every chunk within the write
+    * radius of the previous stage has finished that stage, so all blocks it spilled into the
+    * chunk are known. Spilled blocks are applied ordered by the chunk that wrote them, and stage
+    * functions only read their own chunk, so the output does not depend on the thread count or
+    * the order jobs ran in, as long as stage functions are deterministic for a chunk and seed.
+    *
+    * Chunks that are generated only so a requested neighbor can finish are kept part way and
+    * completed if they are requested later.
+    */
+    class TerrainPipeline {
+    public:
+        typedef std::function<void(GenContext& context)> StageFunc;
+
+        TerrainPipeline(ChunkMap* chunkMap, u64 seed);
+        ~TerrainPipeline();
+
+        /*! @brief Appends a stage. Stages cannot be added once generation started.
+        *
+        * @param writeRadius: How many chunks away the stage may write, up to MAX_STAGE_WRITE_RADIUS.
+        * @return Index of the stage.
+        */
+        u32 addStage(const char* name, StageFunc func, i32 writeRadius = 0);
+
+        /*! @brief Queues a chunk for full generation. Its ChunkMap chunk is created if needed.
+        */
+        void requestChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @brief Collects finished jobs and schedules every chunk that is ready for its next stage.
+        *
+        * @param jobs: Optional job system. Without one, ready stages run on the calling thread.
+        * @return Number of requested chunks that are not complete yet.
+        */
+        size_t update(OPT JobSystem* jobs = nullptr);
+        /*! @brief Calls update() until all requested chunks are complete.
+        */
+        void flush(OPT JobSystem* jobs = nullptr);
+
+        /*! @brief True once every stage ran on the chunk and all spilled blocks were applied.
+        */
+        bool isComplete(UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+        /*! @brief Forgets a chunk's generation state, e.g. when it unloads.
+        *
+        * Blocks that neighbors already spilled into the chunk are lost, so a chunk that is
+        * generated again after removal may differ at its borders.
+        * @pre No stage is running, e.g. right after flush().
+        */
+        void removeChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        u32 getStageCount() const {
+            return (u32)m_stages.size();
+        }
+        const char* getStageName(u32 stage) const {
+            return m_stages[stage].name;
+        }
+        size_t getRunningCount() const {
+            return m_running;
+        }
+        u64 getStagesRun() const {
+            return m_stagesRun;
+        }
+
+        Event<i32v3> onChunkComplete; ///< Sent from update() when a requested chunk is complete
+
+    private:
+        OPENVOX_NON_COPYABLE(TerrainPipeline);
+
+        struct Stage {
+            const char* name;
+            StageFunc func;
+            i32 writeRadius;
+        };
+        /// Generation state of one chunk
+        struct GenChunk {
+            i32v3 position;
+            Chunk* chunk;
+            u32 level; ///< Steps finished. Step k applies edits spilled by stage k - 1, then runs stage k.
+            u32 target; ///< Level this chunk must reach
+            bool requested; ///< True if requested directly rather than as a neighbor
+            bool running;
+            bool active; ///< True if listed in m_active
+            std::vector<std::vector<GenContext::DeferredEdit> > inbox; ///< Spilled edits per stage
+        };
+
+        GenChunk* getGenChunk(const i32v3& chunkPos);
+        /// Raises the target level of a chunk and of the neighbors it depends on
+        void raiseTarget(const i32v3& chunkPos, u32 target);
+        bool isReady(const GenChunk* c) const;
+        /// Runs the next step of a chunk on any thread. neighbors are the 3x3x3 chunks around it.
+        void runStep(GenChunk* c, u32 step, GenChunk* const* neighbors);
+        u32 getCompleteLevel() const {
+            return (u32)m_stages.size() + 1;
+        }
+
+        ChunkMap* m_chunkMap;
+        u64 m_seed;
+        std::vector<Stage> m_stages;
+        std::unordered_map<i32v3, GenChunk*, PositionHash> m_chunks;
+        std::vector<GenChunk*> m_active; ///< Chunks below their target level
+        std::vector<GenChunk*> m_finished; ///< Chunks whose step finished, guarded by m_lock
+        std::mutex m_lock; ///< Guards m_finished and every inbox
+        JobCounter m_counter;
+        size_t m_running = 0;
+        size_t m_incomplete = 0; ///< Requested chunks that are not complete
+        u64 m_stagesRun = 0;
+    };
+}
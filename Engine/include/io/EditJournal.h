@@ -0,0 +1,152 @@
+//
+// EditJournal.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file EditJournal.h
+* @brief Write-ahead log of voxel edits, so edits are durable long before their chunks are saved.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "../voxel/VoxelSpace.hpp"
+
+#define JOURNAL_MAX_FRAME_RECORDS 65536 ///< Records per checksummed frame, bounds replay memory
+
+namespace openvox {
+    class ChunkMap;
+    class RegionStore;
+
+    struct EditJournalStats {
+        u64 records; ///< Edits written since open()
+        u64 frames; ///< Checksummed frames written
+        u64 syncs; ///< Group commits, each ending with one sync of the journal
+        u64 bytes;
+        u64 replayed; ///< Edits replayed by open()
+    };
+
+    /*! @brief Append-only journal of voxel edits with group commit and checkpoints.
+    *
+    * Edits are 14 byte records of a world voxel position and the block written there. They
+    * are appended to a memory buffer, which a writer thread swaps out and writes as one
+    * checksummed frame followed by one sync, so every edit made while the previous sync was
+    * running shares the next one. Saving a chunk costs a region write and two syncs; an edit
+    * costs a few bytes of a shared sync instead.
+    *
+    * The journal is split into segments. checkpoint() starts a new segment, saves the loaded
+    * chunks edited in the older ones to the region files, and deletes every older segment
+    * whose chunks have all been saved. A segment with edits to chunks that were unloaded
+    * without being saved stays until markChunkSaved() covers them or a later checkpoint saves
+    * them after they are loaded again.
+    *
+    * open() replays the remaining segments in order. Records hold the block written, not a
+    * change, so replaying edits that a region file already contains is harmless. Replay of a
+    * segment stops at the first frame with a bad checksum, which after a crash is the torn
+    * tail of the last segment; nothing is ever appended after it.
+    *
+    * append(), waitDurable() and getDurableSequence() may be called from any thread.
+    * checkpoint() and markChunkSaved() must be called from the thread that applies edits to
+    * the ChunkMap, so the chunks it saves are not changing underneath it.
+    */
+    class EditJournal {
+    public:
+        typedef std::function<void(const i32v3& voxelPos, BlockID id)> ReplayFunc;
+
+        EditJournal();
+        ~EditJournal();
+
+        /*! @brief Opens the journal directory, replays its segments and starts the writer thread.
+        *
+        * @param replay: Called for every journaled edit in order, typically setting the block
+        * on a ChunkMap after loading its chunk from the region files.
+        * @return False if the directory or a new segment could not be created.
+        */
+        bool open(const std::string& directory, const ReplayFunc& replay);
+        /*! @brief Writes the buffered edits and stops the writer thread. Segments are kept.
+        */
+        void close();
+
+        /*! @brief Journals an edit. It is durable once getDurableSequence() reaches the result.
+        *
+        * @return Sequence number of the edit, starting at 1.
+        */
+        u64 append(UNIT_SPACE(VOXEL) const i32v3& voxelPos, BlockID id);
+        /*! @brief Blocks until an edit, and every edit before it, is durable.
+        */
+        void waitDurable(u64 sequence);
+        u64 getDurableSequence() const {
+            return m_durable.load(std::memory_order_acquire);
+        }
+
+        /*! @brief Saves the chunks edited in older segments and deletes the segments that no
+        * longer hold unsaved edits.
+        *
+        * @return False if a chunk could not be saved. Its edits stay in the journal.
+        */
+        bool checkpoint(const ChunkMap& chunks, RegionStore& regions);
+        /*! @brief Records that a chunk was saved outside of checkpoint(), e.g. when it was
+        * unloaded. Call it once RegionStore::sync() has made the chunk durable and before the
+        * chunk is edited again.
+        */
+        void markChunkSaved(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @brief Number of segment files, including the one being written.
+        */
+        size_t getSegmentCount();
+        EditJournalStats getStats();
+
+    private:
+        OPENVOX_NON_COPYABLE(EditJournal);
+
+        struct Record {
+            i32v3 voxelPos;
+            BlockID id;
+        };
+        struct Segment {
+            u32 index;
+            std::string path;
+            std::unordered_set<i32v3, PositionHash> chunks; ///< Edited chunks not saved since
+        };
+
+        void writerLoop();
+        /// Writes the buffered records to the current segment and syncs it. Needs m_writeMutex.
+        bool flush();
+        /// Closes the current segment and starts the next one. Needs m_writeMutex.
+        bool startSegment();
+        /// Replays one segment file and collects its edited chunks
+        void replaySegment(Segment& segment, const ReplayFunc& replay);
+        std::string getSegmentPath(u32 index) const;
+
+        std::string m_directory;
+        std::thread m_writer;
+        bool m_stopping = false;
+        std::atomic<u64> m_durable;
+
+        // Guarded by m_mutex
+        std::mutex m_mutex;
+        std::condition_variable m_wake; ///< Signals the writer that records are waiting
+        std::condition_variable m_durableChanged;
+        std::vector<Record> m_pending;
+        u64 m_appended = 0; ///< Sequence number of the last append
+
+        // Guarded by m_writeMutex, which is always locked before m_mutex
+        std::mutex m_writeMutex;
+        std::vector<Record> m_writing; ///< Records being written, swapped with m_pending
+        std::vector<u8> m_frame;
+        std::vector<Segment> m_segments; ///< Oldest first, the last one is being written
+        FILE* m_file = nullptr;
+        EditJournalStats m_stats;
+    };
+}
@@ -0,0 +1,48 @@
+//
+// FileSystem.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file FileSystem.h
+* @brief Portable directory handling and durable writes for save files.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../Decorators.h"
+#include "../Types.h"
+
+namespace openvox {
+    /*! @brief Flushes a file's buffers and waits until its data is on the storage device.
+    *
+    * Uses fdatasync() where available, which skips metadata such as timestamps that recovery
+    * does not need.
+    */
+    bool syncFile(FILE* file);
+    /*! @brief Moves to an offset of a file, which may be beyond 2 GB.
+    */
+    bool seekFile(FILE* file, u64 offset);
+    /*! @brief Gets the size of a file and moves to its end.
+    */
+    u64 getFileSize(FILE* file);
+    /*! @brief Makes the creation, removal and renaming of files in a directory durable.
+    *
+    * Does nothing on platforms where syncFile() already covers this.
+    */
+    bool syncDirectory(const std::string& path);
+    /*! @brief Creates a directory if it does not exist.
+    */
+    bool makeDirectory(const std::string& path);
+    /*! @brief Gets the names of the files in a directory.
+    */
+    bool listDirectory(const std::string& path, OUT std::vector<std::string>& names);
+    /*! @brief Atomically replaces a file with another one.
+    */
+    bool replaceFile(const std::string& from, const std::string& to);
+}
@@ -0,0 +1,120 @@
+//
+// RegionStore.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file RegionStore.h
+* @brief Saves chunks into region files that each hold a cube of chunks.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../voxel/Chunk.h"
+
+#define REGION_WIDTH_BITS 3 ///< log2 of REGION_WIDTH
+#define REGION_WIDTH 8 ///< Width of a region in chunks along every axis
+#define REGION_SIZE (REGION_WIDTH * REGION_WIDTH * REGION_WIDTH) ///< Number of chunks in a region
+
+namespace openvox {
+    /*! @brief Chunk storage in region files, one file per cube of REGION_SIZE chunks.
+    *
+    * A region file starts with a table of the offset, size and checksum of every chunk in it,
+    * followed by the chunk data. Chunks are stored as a palette of the block types they
+    * contain and the bit-packed palette index of every voxel, so uniform chunks take a few
+    * bytes and most terrain a few bits per voxel.
+    *
+    * Saved chunks are always appended, never written over their previous data, and the table
+    * only points at them once sync() has made the data durable. A crash therefore leaves
+    * every chunk at its previous or its new version, never torn. The space of replaced
+    * versions is reclaimed by compact().
+    *
+    * Not thread safe.
+    */
+    class RegionStore {
+    public:
+        RegionStore();
+        ~RegionStore();
+
+        /*! @brief Opens the directory holding the region files, creating it if needed.
+        *
+        * @return False if the directory could not be created.
+        */
+        bool open(const std::string& directory);
+        /*! @brief Syncs and closes all region files.
+        */
+        void close();
+
+        /*! @brief Writes a chunk. It replaces the stored version after the next sync().
+        *
+        * @return False if the region file could not be written.
+        */
+        bool saveChunk(const Chunk& chunk) {
+            return saveChunk(chunk.getChunkPosition(), chunk.getBlockData());
+        }
+        /*! @brief Writes the voxels of a chunk, e.g. from a snapshot of it.
+        *
+        * @param blocks: CHUNK_SIZE voxels indexed with getVoxelIndex().
+        */
+        bool saveChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos, const BlockID* blocks);
+        /*! @brief Reads the stored version of a chunk into it, using its chunk position.
+        *
+        * @return False if the chunk was never saved or its data is damaged, leaving it unchanged.
+        */
+        bool loadChunk(OUT Chunk& chunk);
+        /*! @brief Makes every chunk saved so far durable, then points the tables at them.
+        *
+        * @return False if a region file could not be written.
+        */
+        bool sync();
+        /*! @brief Rewrites region files in which replaced chunk versions take more space than
+        * the live ones. Syncs first.
+        */
+        bool compact();
+
+        /*! @brief Gets the region that contains a chunk.
+        */
+        static i32v3 toRegionPosition(UNIT_SPACE(CHUNK) const i32v3& chunkPos) {
+            return i32v3(chunkPos.x >> REGION_WIDTH_BITS, chunkPos.y >> REGION_WIDTH_BITS, chunkPos.z >> REGION_WIDTH_BITS);
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(RegionStore);
+
+        /// Location of one chunk in its region file
+        struct Entry {
+            u64 offset; ///< 0 if the chunk is not stored
+            u32 size;
+            u32 crc;
+        };
+        struct Region {
+            FILE* file;
+            std::string path;
+            Entry entries[REGION_SIZE];
+            u64 end; ///< Size of the file
+            u64 liveSize; ///< Bytes of chunk data the entries point at
+            std::vector<u32> staged; ///< Entries changed since the last sync
+            Entry stagedEntries[REGION_SIZE]; ///< Entries to write at the next sync
+        };
+
+        /// Opens or creates the file of a region
+        Region* getRegion(const i32v3& regionPos, bool create);
+        bool syncRegion(Region& region);
+        bool compactRegion(Region& region);
+        void encodeChunk(const i32v3& chunkPos, const BlockID* blocks, OUT std::vector<u8>& data);
+        bool decodeChunk(const u8* data, size_t size, OUT Chunk& chunk);
+
+        std::string m_directory;
+        std::unordered_map<i32v3, Region*, PositionHash> m_regions;
+        std::vector<u8> m_buffer; ///< Encoded chunk data
+        std::vector<u16> m_palette;
+        std::vector<u16> m_paletteIndex; ///< Indexed by BlockID, valid for the palette entries only
+        std::vector<BlockID> m_blocks; ///< Decoded voxels, copied into the chunk once all are valid
+    };
+}
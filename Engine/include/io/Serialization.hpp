@@ -0,0 +1,464 @@
+//
+// Serialization.hpp
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file Serialization.hpp
+* @brief Compact binary writers and in-place readers for engine types.
+*/
+
+#pragma once
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Types.h"
+#include "../math/OpenVoxMath.hpp"
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define OPENVOX_BIG_ENDIAN
+#endif
+
+#define VARINT_MAX_SIZE 10 ///< Bytes taken by the largest 64-bit varint
+
+namespace openvox {
+    /*! @brief Encodes a fixed size type as little-endian bytes.
+    *
+    * Defined for arithmetic types, enums and the vectors of Types.h. Specialize it to make other
+    * plain types readable and writable with BinaryWriter::write() and BinaryReader::read().
+    */
+    template<typename T, bool = std::is_arithmetic<T>::value || std::is_enum<T>::value>
+    struct SerialTraits;
+
+    template<typename T>
+    struct SerialTraits<T, true> {
+        static const size_t SIZE = sizeof(T);
+
+        static void store(u8* p, const T& v) {
+            std::memcpy(p, &v, sizeof(T));
+#if defined(OPENVOX_BIG_ENDIAN)
+            for (size_t i = 0; i < sizeof(T) / 2; i++) std::swap(p[i], p[sizeof(T) - 1 - i]);
+#endif
+        }
+        static T load(const u8* p) {
+            T v;
+#if defined(OPENVOX_BIG_ENDIAN)
+            u8 b[sizeof(T)];
+            for (size_t i = 0; i < sizeof(T); i++) b[i] = p[sizeof(T) - 1 - i];
+            std::memcpy(&v, b, sizeof(T));
+#else
+            std::memcpy(&v, p, sizeof(T));
+#endif
+            return v;
+        }
+        /// Little-endian hosts copy whole arrays at once
+        static void storeArray(u8* p, const T* v, size_t count) {
+#if defined(OPENVOX_BIG_ENDIAN)
+            for (size_t i = 0; i < count; i++) store(p + i * SIZE, v[i]);
+#else
+            std::memcpy(p, v, count * SIZE);
+#endif
+        }
+        static void loadArray(const u8* p, T* v, size_t count) {
+#if defined(OPENVOX_BIG_ENDIAN)
+            for (size_t i = 0; i < count; i++) v[i] = load(p + i * SIZE);
+#else
+            std::memcpy(v, p, count * SIZE);
+#endif
+        }
+    };
+
+    /// Shared by the vector types, which are stored as their components in order
+    template<typename V, typename T, size_t N>
+    struct VectorSerialTraits {
+        static const size_t SIZE = SerialTraits<T>::SIZE * N;
+
+        static void store(u8* p, const V& v) {
+            for (size_t i = 0; i < N; i++) SerialTraits<T>::store(p + i * SerialTraits<T>::SIZE, v[(int)i]);
+        }
+        static V load(const u8* p) {
+            V v;
+            for (size_t i = 0; i < N; i++) v[(int)i] = SerialTraits<T>::load(p + i * SerialTraits<T>::SIZE);
+            return v;
+        }
+        static void storeArray(u8* p, const V* v, size_t count) {
+            for (size_t i = 0; i < count; i++) store(p + i * SIZE, v[i]);
+        }
+        static void loadArray(const u8* p, V* v, size_t count) {
+            for (size_t i = 0; i < count; i++) v[i] = load(p + i * SIZE);
+        }
+    };
+    template<typename T>
+    struct SerialTraits<Vector2<T>, false> : public VectorSerialTraits<Vector2<T>, T, 2> {};
+    template<typename T>
+    struct SerialTraits<Vector3<T>, false> : public VectorSerialTraits<Vector3<T>, T, 3> {};
+    template<typename T>
+    struct SerialTraits<Vector4<T>, false> : public VectorSerialTraits<Vector4<T>, T, 4> {};
+
+    /*! @brief Maps signed integers to unsigned so small magnitudes make short varints.
+    */
+    inline u64 zigZagEncode(i64 v) {
+        return ((u64)v << 1) ^ (u64)(v >> 63);
+    }
+    inline i64 zigZagDecode(u64 v) {
+        return (i64)(v >> 1) ^ -(i64)(v & 1);
+    }
+
+    /*! @brief Computes the CRC-32 (IEEE) of a buffer, e.g. to detect torn or corrupt records on disk.
+    *
+    * @param crc: Result for the preceding data, to checksum a buffer in pieces.
+    */
+    inline u32 crc32(const u8* data, size_t size, u32 crc = 0) {
+        struct Table {
+            u32 entries[256];
+            Table() {
+                for (u32 i = 0; i < 256; i++) {
+                    u32 c = i;
+                    for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                    entries[i] = c;
+                }
+            }
+        };
+        static const Table table;
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++) crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    /*! @brief Appends binary data to a byte buffer.
+    *
+    * Fixed size values are written little-endian with no padding or alignment. Integers can
+    * also be written as varints, 7 bits per byte with the high bit set on all but the last,
+    * and signed ones zigzag encoded first. writeBits() packs values of any width up to 32 bits
+    * back to back; the next byte level write pads them to a whole byte.
+    *
+    * Fields make a format extendable: beginField() writes a varint tag and reserves a u32
+    * length that endField() fills in. Readers skip fields with tags they do not know and keep
+    * defaults for fields that are missing, so old and new versions read each other's data.
+    * Fields nest.
+    *
+    * The buffer grows ahead of the data so small writes do not resize it each time. It holds
+    * exactly the written bytes after finish(), which the destructor calls.
+    *
+    * @code
+    * BinaryWriter w(buffer);
+    * w.beginField(ENTITY_FIELD_POSITION);
+    * w.write(position);
+    * w.endField();
+    * w.finish();
+    * @endcode
+    */
+    class BinaryWriter {
+    public:
+        /*! @param buffer: Buffer written data is appended to. It must outlive the writer.
+        */
+        BinaryWriter(OUT std::vector<u8>& buffer) : m_buffer(buffer), m_size(buffer.size()) {}
+        ~BinaryWriter() {
+            finish();
+        }
+
+        template<typename T>
+        void write(const T& v) {
+            SerialTraits<T>::store(allocate(SerialTraits<T>::SIZE), v);
+        }
+        template<typename T>
+        void writeArray(const T* v, size_t count) {
+            if (count) SerialTraits<T>::storeArray(allocate(SerialTraits<T>::SIZE * count), v, count);
+        }
+        void writeBytes(const void* data, size_t size) {
+            if (size) std::memcpy(allocate(size), data, size);
+        }
+        /*! @brief Writes a varint length followed by the bytes.
+        */
+        void writeBlob(const void* data, size_t size) {
+            writeVarint(size);
+            writeBytes(data, size);
+        }
+
+        void writeVarint(u64 v) {
+            alignBits();
+            u8* p = ensure(VARINT_MAX_SIZE);
+            size_t n = 0;
+            while (v >= 0x80) {
+                p[n++] = (u8)(v | 0x80);
+                v >>= 7;
+            }
+            p[n++] = (u8)v;
+            m_size += n;
+        }
+        void writeZigZag(i64 v) {
+            writeVarint(zigZagEncode(v));
+        }
+
+        /*! @brief Packs the low bits of a value after the previous bits.
+        *
+        * @param bits: Number of bits, 0 to 32.
+        */
+        void writeBits(u32 v, u32 bits) {
+            if (!bits) return;
+            m_bits |= (u64)(v & (0xFFFFFFFFu >> (32 - bits))) << m_bitCount;
+            m_bitCount += bits;
+            // Whole words are flushed at once
+            if (m_bitCount >= 32) {
+                SerialTraits<u32>::store(ensure(4), (u32)m_bits);
+                m_size += 4;
+                m_bits >>= 32;
+                m_bitCount -= 32;
+            }
+        }
+        /*! @brief Pads pending bits to a whole byte.
+        */
+        void alignBits() {
+            if (!m_bitCount) return;
+            u32 bytes = (m_bitCount + 7) / 8;
+            u8* p = ensure(bytes);
+            for (u32 i = 0; i < bytes; i++) p[i] = (u8)(m_bits >> (i * 8));
+            m_size += bytes;
+            m_bits = 0;
+            m_bitCount = 0;
+        }
+
+        void beginField(u32 tag) {
+            writeVarint(tag);
+            m_fields.push_back(m_size);
+            allocate(4);
+        }
+        void endField() {
+            openvox_assert(m_fields.size(), "endField() without beginField()");
+            alignBits();
+            size_t offset = m_fields.back();
+            m_fields.pop_back();
+            SerialTraits<u32>::store(&m_buffer[offset], (u32)(m_size - offset - 4));
+        }
+
+        /*! @brief Pads pending bits and trims the buffer to the written data.
+        */
+        void finish() {
+            alignBits();
+            m_buffer.resize(m_size);
+        }
+
+        /*! @brief Bytes written, including data that was in the buffer before the writer.
+        */
+        size_t getSize() const {
+            return m_size + (m_bitCount + 7) / 8;
+        }
+
+    private:
+        /// Makes room for size bytes past the end of the data and returns them
+        u8* ensure(size_t size) {
+            if (m_size + size > m_buffer.size()) m_buffer.resize(openvoxm::max(m_size + size, m_buffer.size() * 2));
+            return &m_buffer[m_size];
+        }
+        /// Returns the next size bytes and moves past them
+        u8* allocate(size_t size) {
+            alignBits();
+            u8* p = ensure(size);
+            m_size += size;
+            return p;
+        }
+
+        std::vector<u8>& m_buffer;
+        size_t m_size; ///< Bytes written, the buffer may be larger
+        std::vector<size_t> m_fields; ///< Offsets of the lengths of open fields
+        u64 m_bits = 0;
+        u32 m_bitCount = 0;
+    };
+
+    /*! @brief Fixed size values read in place from a buffer, without copying it first.
+    */
+    template<typename T>
+    class BinaryArrayView {
+    public:
+        BinaryArrayView() : m_data(nullptr), m_count(0) {}
+        BinaryArrayView(const u8* data, size_t count) : m_data(data), m_count(count) {}
+
+        T operator[](size_t i) const {
+            return SerialTraits<T>::load(m_data + i * SerialTraits<T>::SIZE);
+        }
+        /*! @brief Decodes the whole array, a plain copy on little-endian hosts.
+        */
+        void copyTo(OUT T* out) const {
+            if (m_count) SerialTraits<T>::loadArray(m_data, out, m_count);
+        }
+
+        size_t size() const {
+            return m_count;
+        }
+        const u8* data() const {
+            return m_data;
+        }
+
+    private:
+        const u8* m_data;
+        size_t m_count;
+    };
+
+    /*! @brief Reads what a BinaryWriter wrote, directly from a buffer such as a mapped file or a
+    * received packet.
+    *
+    * Nothing is copied until a value is read: readBytes(), readBlob() and readArray() return
+    * pointers and views into the buffer, which must stay alive while they are used. Reading
+    * past the end or a malformed varint fails the reader, after which every read returns false
+    * and leaves its output unchanged, so a sequence of reads can be checked once at the end.
+    */
+    class BinaryReader {
+    public:
+        BinaryReader() : m_data(nullptr), m_size(0) {}
+        BinaryReader(const u8* data, size_t size) : m_data(data), m_size(size) {}
+
+        template<typename T>
+        bool read(OUT T& v) {
+            const u8* p = consume(SerialTraits<T>::SIZE);
+            if (!p) return false;
+            v = SerialTraits<T>::load(p);
+            return true;
+        }
+        template<typename T>
+        bool readArray(size_t count, OUT BinaryArrayView<T>& view) {
+            // Give back bytes loaded ahead by readBits() before checking what is left
+            alignBits();
+            // Checked before consume() so a huge count cannot overflow the size
+            if (m_failed || count > (m_size - m_position) / SerialTraits<T>::SIZE) return fail();
+            view = BinaryArrayView<T>(consume(count * SerialTraits<T>::SIZE), count);
+            return true;
+        }
+        bool readBytes(size_t size, OUT const u8*& data) {
+            const u8* p = consume(size);
+            if (!p) return false;
+            data = p;
+            return true;
+        }
+        bool readBlob(OUT const u8*& data, OUT size_t& size) {
+            u64 n;
+            if (!readVarint(n) || n > m_size - m_position) return fail();
+            size = (size_t)n;
+            data = consume(size);
+            return true;
+        }
+
+        /*! @brief Reads a varint into an unsigned integer, failing if it does not fit.
+        */
+        template<typename T>
+        bool readVarint(OUT T& v) {
+            static_assert(std::is_unsigned<T>::value, "Varints decode to unsigned integers");
+            alignBits();
+            u64 r = 0;
+            for (u32 shift = 0; shift < 64; shift += 7) {
+                if (m_failed || m_position >= m_size) return fail();
+                u8 b = m_data[m_position++];
+                // The tenth byte holds the top bit alone, anything more overflows 64 bits
+                if (shift == 63 && (b & 0x7E)) return fail();
+                r |= (u64)(b & 0x7F) << shift;
+                if (!(b & 0x80)) {
+                    if (r > (u64)(T)~(T)0) return fail();
+                    v = (T)r;
+                    return true;
+                }
+            }
+            return fail();
+        }
+        template<typename T>
+        bool readZigZag(OUT T& v) {
+            static_assert(std::is_signed<T>::value, "Zigzag decodes to signed integers");
+            u64 r;
+            if (!readVarint(r)) return false;
+            i64 s = zigZagDecode(r);
+            if (s < (i64)std::numeric_limits<T>::min() || s > (i64)std::numeric_limits<T>::max()) return fail();
+            v = (T)s;
+            return true;
+        }
+
+        /*! @param bits: Number of bits, 0 to 32.
+        */
+        bool readBits(u32 bits, OUT u32& v) {
+            if (m_bitCount < bits) {
+                // Whole words are loaded at once while there are enough bytes left
+                if (!m_failed && m_size - m_position >= 4) {
+                    m_bits |= (u64)SerialTraits<u32>::load(m_data + m_position) << m_bitCount;
+                    m_position += 4;
+                    m_bitCount += 32;
+                } else {
+                    while (m_bitCount < bits) {
+                        if (m_failed || m_position >= m_size) return fail();
+                        m_bits |= (u64)m_data[m_position++] << m_bitCount;
+                        m_bitCount += 8;
+                    }
+                }
+            }
+            v = bits ? (u32)m_bits & (0xFFFFFFFFu >> (32 - bits)) : 0;
+            m_bits >>= bits;
+            m_bitCount -= bits;
+            return true;
+        }
+        /*! @brief Skips the padding after packed bits. Byte level reads do this on their own.
+        */
+        void alignBits() {
+            // Whole bytes loaded ahead were not read yet
+            m_position -= m_bitCount / 8;
+            m_bits = 0;
+            m_bitCount = 0;
+        }
+
+        /*! @brief Reads the next field written by BinaryWriter::beginField().
+        *
+        * @param field: Receives a reader over the field's data alone.
+        * @return False at the end of the data or if the field is malformed.
+        */
+        bool readField(OUT u32& tag, OUT BinaryReader& field) {
+            if (isEnd()) return false;
+            u32 length;
+            if (!readVarint(tag) || !read(length)) return false;
+            const u8* p = consume(length);
+            if (!p) return false;
+            field = BinaryReader(p, length);
+            return true;
+        }
+
+        bool skip(size_t size) {
+            return consume(size) != nullptr;
+        }
+
+        bool hasFailed() const {
+            return m_failed;
+        }
+        bool isEnd() const {
+            return m_failed || (m_position >= m_size && m_bitCount < 8);
+        }
+        size_t getPosition() const {
+            return m_position - m_bitCount / 8;
+        }
+        size_t getRemaining() const {
+            return m_size - getPosition();
+        }
+
+    private:
+        /// Returns the next bytes and moves past them, or nullptr if there are not enough
+        const u8* consume(size_t size) {
+            alignBits();
+            if (m_failed || size > m_size - m_position) {
+                fail();
+                return nullptr;
+            }
+            const u8* p = m_data + m_position;
+            m_position += size;
+            return p;
+        }
+        bool fail() {
+            m_failed = true;
+            return false;
+        }
+
+        const u8* m_data;
+        size_t m_size;
+        size_t m_position = 0;
+        u64 m_bits = 0;
+        u32 m_bitCount = 0;
+        bool m_failed = false;
+    };
+}
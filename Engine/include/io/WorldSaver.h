@@ -0,0 +1,77 @@
+//
+// WorldSaver.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file WorldSaver.h
+* @brief Saves every loaded chunk in the background while the simulation keeps running.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <thread>
+
+#include "../voxel/WorldSnapshot.h"
+
+namespace openvox {
+    class ChunkMap;
+    class RegionStore;
+
+    struct WorldSaveStats {
+        f32 snapshotTime; ///< Seconds the caller was paused to capture the snapshot
+        f32 saveTime; ///< Seconds the background thread took to write and sync the chunks
+        size_t chunks;
+        bool succeeded;
+    };
+
+    /*! @brief Writes a consistent full-world save on a background thread.
+    *
+    * save() captures a WorldSnapshot, which is the only pause of the caller, and hands it to
+    * a thread that writes the chunks to a RegionStore and syncs it. Every chunk is released
+    * from the snapshot as soon as it is written, so only chunks modified before the saver
+    * reaches them are cloned.
+    */
+    class WorldSaver {
+    public:
+        WorldSaver();
+        /*! @brief Waits for a running save.
+        */
+        ~WorldSaver();
+
+        /*! @brief Starts saving every loaded chunk.
+        *
+        * Must be called on the thread that writes the chunks. The region store must not be
+        * used by anything else until isSaving() returns false.
+        *
+        * @return False if the previous save has not finished.
+        */
+        bool save(const ChunkMap& chunks, RegionStore& regions);
+        bool isSaving() const {
+            return m_saving.load(std::memory_order_acquire);
+        }
+        /*! @brief Blocks until the running save, if any, has finished.
+        *
+        * @return False if the last save failed.
+        */
+        bool wait();
+
+        /*! @brief Statistics of the last save, complete once it has finished.
+        */
+        const WorldSaveStats& getStats() const {
+            return m_stats;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(WorldSaver);
+
+        void run(RegionStore* regions);
+
+        WorldSnapshot m_snapshot;
+        std::thread m_thread;
+        std::atomic<bool> m_saving;
+        WorldSaveStats m_stats;
+    };
+}
@@ -0,0 +1,110 @@
+//
+// JobSystem.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file JobSystem.h
+* @brief Worker thread pool that runs engine jobs.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Decorators.h"
+#include "../Types.h"
+
+namespace openvox {
+    /*! @brief Counts unfinished jobs so a caller can wait on a group of them.
+    */
+    class JobCounter {
+    public:
+        JobCounter() : m_pending(0) {}
+
+        bool isDone() const {
+            return m_pending.load(std::memory_order_acquire) == 0;
+        }
+    private:
+        OPENVOX_NON_COPYABLE(JobCounter);
+        friend class JobSystem;
+
+        std::atomic<i32> m_pending; ///< Jobs scheduled against this counter that have not finished
+    };
+
+    /*! @brief A fixed pool of worker threads consuming a shared job queue.
+    *
+    * Threads that wait on a JobCounter execute queued jobs while they wait, so jobs may
+    * schedule and wait on other jobs without deadlocking the pool.
+    */
+    class JobSystem {
+    public:
+        typedef std::function<void()> Job; ///< A unit of work
+        typedef std::function<void(size_t begin, size_t end)> RangeJob; ///< Work over the index range [begin, end)
+
+        JobSystem() {}
+        ~JobSystem();
+
+        /*! @brief Starts the worker threads.
+        *
+        * @param threadCount: Number of workers, 0 uses one less than the hardware concurrency.
+        */
+        void init(u32 threadCount = 0);
+        /*! @brief Finishes all queued jobs and joins the workers.
+        */
+        void dispose();
+
+        /*! @brief Queues a job.
+        *
+        * @param job: Work to run on some thread.
+        * @param counter: Optional counter that is decremented when the job finishes.
+        */
+        void schedule(Job job, OPT JobCounter* counter = nullptr);
+        /*! @brief Blocks until every job scheduled against counter finished, running queued jobs meanwhile.
+        */
+        void wait(JobCounter& counter);
+
+        /*! @brief Splits [0, count) into ranges and runs f over them on all threads, including the caller.
+        *
+        * @param count: Size of the index range.
+        * @param grainSize: Minimum number of indices per job.
+        * @param f: Work for one range.
+        */
+        void parallelFor(size_t count, size_t grainSize, const RangeJob& f);
+
+        /*! @brief Number of threads that execute jobs during parallelFor, including the caller.
+        */
+        u32 getConcurrency() const {
+            return (u32)m_workers.size() + 1;
+        }
+        bool isInitialized() const {
+            return !m_workers.empty();
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(JobSystem);
+
+        struct QueuedJob {
+            Job job;
+            JobCounter* counter;
+        };
+
+        void workerMain();
+        /// Pops and runs one job if any is queued. @return False if the queue was empty.
+        bool runOne();
+        void execute(QueuedJob& j);
+
+        std::vector<std::thread> m_workers;
+        std::deque<QueuedJob> m_queue; ///< Pending jobs, guarded by m_lock
+        std::mutex m_lock;
+        std::condition_variable m_cond; ///< Signalled when jobs are queued or workers should quit
+        bool m_quit = false;
+    };
+}
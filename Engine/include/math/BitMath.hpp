@@ -0,0 +1,85 @@
+//
+// BitMath.hpp
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file BitMath.hpp
+* @brief Portable bit counting and scanning.
+*/
+
+#pragma once
+#ifndef OpenVox_BitMath_hpp__
+#define OpenVox_BitMath_hpp__
+
+#include "../Types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace openvox {
+    namespace math {
+        /*! @brief Counts the set bits in a word.
+        */
+        inline u32 popCount(u64 v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            return (u32)__popcnt64(v);
+#elif defined(__GNUC__) || defined(__clang__)
+            return (u32)__builtin_popcountll(v);
+#else
+            v = v - ((v >> 1) & 0x5555555555555555ull);
+            v = (v & 0x3333333333333333ull) + ((v >> 2) & 0x3333333333333333ull);
+            v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+            return (u32)((v * 0x0101010101010101ull) >> 56);
+#endif
+        }
+        /*! @brief Gets the index of the lowest set bit.
+        *
+        * @pre v != 0
+        */
+        inline u32 bitScanForward(u64 v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long i;
+            _BitScanForward64(&i, v);
+            return (u32)i;
+#elif defined(__GNUC__) || defined(__clang__)
+            return (u32)__builtin_ctzll(v);
+#else
+            u32 i = 0;
+            while (!(v & 1)) {
+                v >>= 1;
+                i++;
+            }
+            return i;
+#endif
+        }
+        /*! @brief Gets the index of the highest set bit.
+        *
+        * @pre v != 0
+        */
+        inline u32 bitScanReverse(u64 v) {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long i;
+            _BitScanReverse64(&i, v);
+            return (u32)i;
+#elif defined(__GNUC__) || defined(__clang__)
+            return 63u - (u32)__builtin_clzll(v);
+#else
+            u32 i = 0;
+            while (v >>= 1) i++;
+            return i;
+#endif
+        }
+        /*! @brief Gets a mask with bits [first, last] set.
+        *
+        * @pre first <= last < 64
+        */
+        inline u64 bitRange(u32 first, u32 last) {
+            return ((~0ull) >> (63 - last)) & ((~0ull) << first);
+        }
+    }
+}
+
+#endif // !OpenVox_BitMath_hpp__
@@ -11,4 +11,6 @@
 
 #pragma once
 
+#include "ScalarMath.hpp"
+#include "BitMath.hpp"
 #include "VectorMath.hpp"
\ No newline at end of file
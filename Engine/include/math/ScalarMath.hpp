@@ -0,0 +1,142 @@
+//
+// ScalarMath.hpp
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file ScalarMath.hpp
+* @brief Defines common scalar math operations used by the vector math functions.
+*/
+
+#pragma once
+#ifndef OpenVox_ScalarMath_hpp__
+#define OpenVox_ScalarMath_hpp__
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "../Types.h"
+
+namespace openvox {
+    namespace math {
+        /*! @brief Computes the square root of a value.
+        */
+        template <typename T>
+        inline T sqrt(T a) {
+            static_assert(std::numeric_limits<T>::is_iec559, "sqrt only accepts floating-point inputs.");
+            return std::sqrt(a);
+        }
+        /*! @brief Approximates 1 / sqrt(a) with a single newton iteration.
+        */
+        inline f32 fastInverseSqrt(f32 a) {
+            f32 half = 0.5f * a;
+            u32 i;
+            std::memcpy(&i, &a, sizeof(i));
+            i = 0x5f3759df - (i >> 1);
+            std::memcpy(&a, &i, sizeof(a));
+            return a * (1.5f - half * a * a);
+        }
+        inline f64 fastInverseSqrt(f64 a) {
+            return 1.0 / std::sqrt(a);
+        }
+
+        template <typename T>
+        inline T abs(T a) {
+            return a < 0 ? -a : a;
+        }
+        template <typename T>
+        inline T floor(T a) {
+            return std::floor(a);
+        }
+        template <typename T>
+        inline T ceil(T a) {
+            return std::ceil(a);
+        }
+        template <typename T>
+        inline T trunc(T a) {
+            return std::trunc(a);
+        }
+        template <typename T>
+        inline T round(T a) {
+            return std::round(a);
+        }
+        /*! @brief Gets the fractional part of a value, a - floor(a).
+        */
+        template <typename T>
+        inline T fract(T a) {
+            return a - std::floor(a);
+        }
+        /*! @brief Gets -1, 0 or 1 depending on the sign of a.
+        */
+        template <typename T>
+        inline T sign(T a) {
+            return (T)((T(0) < a) - (a < T(0)));
+        }
+        template <typename T>
+        inline T radians(T degrees) {
+            return degrees * (T)(3.14159265358979323846 / 180.0);
+        }
+        template <typename T>
+        inline T degrees(T radians) {
+            return radians * (T)(180.0 / 3.14159265358979323846);
+        }
+        template <typename T>
+        inline T exp(T a) {
+            return std::exp(a);
+        }
+        template <typename T>
+        inline T exp2(T a) {
+            return std::exp2(a);
+        }
+        template <typename T>
+        inline T log(T a) {
+            return std::log(a);
+        }
+        template <typename T>
+        inline T log2(T a) {
+            return std::log2(a);
+        }
+        /*! @brief GLSL-style modulus, a - b * floor(a / b).
+        */
+        template <typename T>
+        inline T mod(T a, T b) {
+            return a - b * std::floor(a / b);
+        }
+
+        template <typename T>
+        inline T min(T a, T b) {
+            return a < b ? a : b;
+        }
+        template <typename T>
+        inline T max(T a, T b) {
+            return a > b ? a : b;
+        }
+        template <typename T>
+        inline T clamp(T a, T minVal, T maxVal) {
+            return a < minVal ? minVal : (a > maxVal ? maxVal : a);
+        }
+        /*! @brief Linearly interpolates between a and b.
+        */
+        template <typename T>
+        inline T lerp(T a, T b, T t) {
+            return a + (b - a) * t;
+        }
+
+        /*! @brief Floors a floating point value to an integer.
+        *
+        * Faster than static_cast<i32>(std::floor(a)) and correct for negative values.
+        */
+        inline i32 fastFloor(f32 a) {
+            i32 i = static_cast<i32>(a);
+            return i - (a < static_cast<f32>(i));
+        }
+        inline i32 fastFloor(f64 a) {
+            i32 i = static_cast<i32>(a);
+            return i - (a < static_cast<f64>(i));
+        }
+    }
+}
+
+#endif // !OpenVox_ScalarMath_hpp__
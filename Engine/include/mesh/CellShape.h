@@ -0,0 +1,78 @@
+//
+// CellShape.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file CellShape.h
+* @brief Surface topology of the sign cases of a mesher cell.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "../Decorators.h"
+#include "../Types.h"
+
+namespace openvox {
+    /*! @brief Convex cell whose corners are sampled inside or outside a surface.
+    *
+    * The surface crosses every edge between an inside and an outside corner. Walking a face,
+    * each crossing into the inside is joined to the next crossing, which cuts the inside
+    * corners off. This resolves ambiguous faces the same way whichever side they are seen
+    * from, so cells sharing a face agree and the surfaces of neighboring cells close up. Every
+    * crossing edge is entered in one of its faces and left in the other, so the segments form
+    * closed loops, one per connected piece of surface in the cell.
+    */
+    class CellShape {
+    public:
+        void addPoint(const f32v3& point) {
+            m_points.push_back(point);
+        }
+        /*! @brief Adds a face, given by its points in order around it in either direction.
+        */
+        void addFace(const int* points, size_t count) {
+            m_faces.push_back(std::vector<int>(points, points + count));
+        }
+        /*! @brief Orients the faces counter clockwise seen from outside and collects the edges.
+        *
+        * Must be called once all faces are added.
+        */
+        void finish();
+
+        /*! @brief Gets the surface loops of a sign case.
+        *
+        * @param inside: Bit per point, set for points inside the surface.
+        * @param loops: Receives the edges each loop crosses, counter clockwise seen from outside
+        * the surface.
+        */
+        void getLoops(u32 inside, OUT std::vector<std::vector<int> >& loops) const;
+        /*! @brief Appends the loops of a sign case as fans of edge index triangles.
+        */
+        void triangulate(u32 inside, OUT std::vector<u8>& triangles) const;
+
+        /*! @return Index of the edge between two points, -1 if there is none.
+        */
+        int findEdge(int a, int b) const;
+        const std::vector<f32v3>& getPoints() const {
+            return m_points;
+        }
+        /*! @brief Point pairs, lower index first.
+        */
+        const std::vector<i32v2>& getEdges() const {
+            return m_edges;
+        }
+
+        /*! @brief Unit cube with point i at (i & 1, (i >> 1) & 1, (i >> 2) & 1).
+        */
+        static const CellShape& getCube();
+
+    private:
+        std::vector<f32v3> m_points;
+        std::vector<std::vector<int> > m_faces;
+        std::vector<i32v2> m_edges;
+        std::vector<u32> m_edgeFaces; ///< Bit per face each edge borders
+    };
+}
@@ -0,0 +1,131 @@
+//
+// DualContouringMesher.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file DualContouringMesher.h
+* @brief Terrain meshes that keep sharp edges and corners, with octree simplification.
+*/
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "../Decorators.h"
+#include "../Types.h"
+#include "../voxel/VoxelSpace.hpp"
+#include "PackedVertex.h"
+
+#define DEFAULT_DUAL_CONTOURING_MAX_ERROR 0.1f ///< QEF error, in squared cells, up to which cells merge
+
+namespace openvox {
+    /*! @brief Extracts the isosurface of a signed density field with dual contouring.
+    *
+    * Densities are stored as i8, negative inside. Every cell edge with a sign change yields
+    * Hermite data: the crossing point and the normal from the density gradient there. Each
+    * cell places its vertex at the point that best fits the planes of its crossings, found by
+    * minimizing their quadratic error function (QEF), so edges and corners of built shapes stay
+    * sharp where marching cubes would bevel them. QEFs are solved side by side once all cells of
+    * an octree level are known, several cells per batch, so the solver vectorizes across cells
+    * rather than within one 3x3 system. Every crossing edge becomes a quad joining the vertices
+    * of its four cells.
+    *
+    * Output is manifold: a cell holding separate pieces of surface gets one vertex per piece,
+    * split the same way as CellShape splits ambiguous faces. Where one piece passes through an
+    * ambiguous face twice on both sides of it, a tube, each of the two segments on the face gets
+    * a vertex so the quads around the tube keep their hole. An octree over the chunk then
+    * merges groups of 2x2x2 cells or nodes into one vertex when their combined QEF error stays
+    * under a limit and their signs pass the topology safety test of Ju et al., so flat areas
+    * take few triangles without changing the topology. Cells on the chunk border are never
+    * merged, which keeps the seams with neighboring chunks identical on both sides.
+    *
+    * A chunk emits the quads of the edges starting inside it, which reach one cell into its
+    * positive neighbors. All scratch memory lives in the mesher, so use one mesher per thread.
+    */
+    class DualContouringMesher {
+    public:
+        /*! @brief Returns the density at a voxel position.
+        */
+        typedef std::function<i8(UNIT_SPACE(VOXEL) const i32v3& voxelPos)> DensityFunc;
+
+        DualContouringMesher();
+
+        /*! @brief Meshes one chunk of a LOD.
+        *
+        * @param chunkPos: Position in chunks of this LOD, which are CHUNK_WIDTH << lod voxels wide.
+        * @param mesh: Cleared and filled with the surface.
+        * @param maxError: Limit for merging cells, 0 keeps every cell.
+        */
+        void mesh(UNIT_SPACE(CHUNK) const i32v3& chunkPos, u32 lod, const DensityFunc& density,
+                  OUT PackedMesh& mesh, f32 maxError = DEFAULT_DUAL_CONTOURING_MAX_ERROR);
+
+        /*! @brief Number of cell vertices before merging in the last mesh() call.
+        */
+        size_t getLeafVertexCount() const {
+            return m_leafVertexCount;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(DualContouringMesher);
+
+        /// Sums the planes of Hermite data for a least squares fit, relative to a cell or node corner
+        struct Qef {
+            void clear();
+            void add(const f32v3& point, const f32v3& normal);
+            /// Adds the planes of a child whose corner is offset from this one
+            void add(const Qef& other, const f32v3& offset);
+
+            f32 ata[6]; ///< Upper triangle of A^T A: xx, xy, xz, yy, yz, zz
+            f32v3 atb;
+            f32 btb;
+            f32v3 pointSum;
+            f32v3 normalSum;
+            u32 count;
+        };
+        struct CellVertex {
+            Qef qef;
+            f32v3 position; ///< Chunk local, in cells
+            u32 meshIndex;
+        };
+
+        /*! @brief Places the vertices at the points in a cube of the given size from their corner
+        * with the least QEF error.
+        *
+        * Cells are solved QEF_BATCH at a time, one per lane of flat loops over structure of
+        * arrays copies of their QEFs, so the Jacobi rotations vectorize across cells.
+        *
+        * @param vertices: Positions hold the corners and receive the points.
+        * @param errors: Optional, receives the error of each vertex.
+        */
+        static void solveVertices(CellVertex* vertices, size_t count, f32 size, OPT f32* errors);
+
+        void sampleChunk(const i32v3& origin, u32 lod, const DensityFunc& density);
+        void buildLeaves();
+        /// Merges the nodes of one octree level from the level below
+        bool buildLevel(u32 level, f32 maxError);
+        /// Checks that the signs inside a node do not change the topology when it is merged
+        bool isTopologySafe(const i32v3& min, int size) const;
+        void emitQuads(OUT PackedMesh& mesh);
+        /// Gets the vertex of a cell on the piece of surface crossing one of its edges
+        u32 getCellVertex(const i32v3& cell, int edge) const;
+        /// Gets the vertex of a tube segment on the face between two cells around an edge, or NO_VERTEX
+        u32 getFaceVertex(const i32v3& edgeStart, int axis, const i32v3& cellA, const i32v3& cellB, u32 vertexA, u32 vertexB);
+        u32 getMeshIndex(u32 vertex, OUT PackedMesh& mesh);
+
+        std::vector<i8> m_samples; ///< Samples 0 to CHUNK_WIDTH + 1 with a one sample border for gradients
+        std::vector<u8> m_cellCases; ///< Sign case of cells 0 to CHUNK_WIDTH
+        std::vector<u32> m_cellVertices; ///< First vertex of each cell
+        std::vector<u32> m_cellOwners; ///< Vertex of the largest merged node holding the cell
+        std::vector<u32> m_nodes[CHUNK_WIDTH_BITS + 1]; ///< Vertex or state of each node, per level
+        std::vector<CellVertex> m_vertices;
+        std::vector<CellVertex> m_candidates; ///< Nodes of a level that may merge, solved together
+        std::vector<u32> m_candidateNodes; ///< Index in the level of each candidate
+        std::vector<f32> m_candidateErrors;
+        std::unordered_map<u64, u32> m_faceVertices; ///< Tube segment vertices by face and cut off corner
+        size_t m_leafVertexCount = 0;
+    };
+}
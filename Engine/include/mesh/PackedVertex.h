@@ -0,0 +1,62 @@
+//
+// PackedVertex.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file PackedVertex.h
+* @brief Compact vertex format shared by the terrain meshers.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "../Types.h"
+#include "../math/OpenVoxMath.hpp"
+
+#define PACKED_POSITION_SCALE 1024 ///< Packed position units per cell
+
+namespace openvox {
+    /*! @brief Terrain vertex, 8 bytes.
+    *
+    * The position is local to the chunk in 1 / PACKED_POSITION_SCALE of a cell, where a cell is
+    * 1 << lod voxels wide, so the same format serves every LOD and the shader only needs the
+    * chunk origin and cell size. The normal is octahedral encoded.
+    */
+    struct PackedVertex {
+        u16v3 position;
+        i8v2 normal;
+    };
+    static_assert(sizeof(PackedVertex) == 8, "PackedVertex must stay packed");
+
+    struct PackedMesh {
+        std::vector<PackedVertex> vertices;
+        std::vector<u32> indices; ///< Counter clockwise triangles seen from outside the surface
+    };
+
+    /*! @brief Packs a chunk local position in cells and an unnormalized normal.
+    */
+    inline PackedVertex packVertex(const f32v3& position, const f32v3& normal) {
+        PackedVertex vertex;
+        for (int i = 0; i < 3; i++) {
+            vertex.position[i] = (u16)openvoxm::clamp(openvoxm::round(position[i] * PACKED_POSITION_SCALE), 0.0f, 65535.0f);
+        }
+
+        // Project onto the octahedron and fold the lower half over the upper one
+        f32 length = openvoxm::abs(normal.x) + openvoxm::abs(normal.y) + openvoxm::abs(normal.z);
+        f32v2 n(0.0f);
+        if (length > 0.0f) {
+            n = f32v2(normal.x, normal.y) / length;
+            if (normal.z < 0.0f) {
+                f32v2 folded(1.0f - openvoxm::abs(n.y), 1.0f - openvoxm::abs(n.x));
+                n.x = n.x >= 0.0f ? folded.x : -folded.x;
+                n.y = n.y >= 0.0f ? folded.y : -folded.y;
+            }
+        }
+        vertex.normal.x = (i8)openvoxm::round(n.x * 127.0f);
+        vertex.normal.y = (i8)openvoxm::round(n.y * 127.0f);
+        return vertex;
+    }
+}
@@ -0,0 +1,137 @@
+//
+// TerrainClipmap.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TerrainClipmap.h
+* @brief Nested rings of ever coarser terrain chunks around the camera, for far view distances.
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../jobs/JobSystem.h"
+#include "TransvoxelMesher.h"
+
+#define DEFAULT_CLIPMAP_LEVELS 9 ///< Enough for 24576 voxels of view with the default radius
+#define DEFAULT_CLIPMAP_RADIUS 4 ///< Chunks from the center to the edge of a level, horizontally
+#define DEFAULT_CLIPMAP_VERTICAL_RADIUS 2 ///< Chunks from the center to the edge of a level, vertically
+
+namespace openvox {
+    /*! @brief A meshed chunk of the clipmap to draw.
+    */
+    struct ClipmapChunk {
+        UNIT_SPACE(CHUNK) i32v3 chunkPos; ///< In chunks of its LOD
+        u32 lod;
+        const TransvoxelMesh* mesh;
+    };
+
+    /*! @brief Geometry clipmap of Transvoxel chunk meshes.
+    *
+    * Level L is a box of chunks at LOD L, 2 * radius chunks wide and 2 * verticalRadius tall,
+    * centered on the camera and snapped to even chunk positions. Each level covers the middle
+    * half of the next coarser one, so the coarser level leaves a hole there and draws a ring.
+    * Chunks next to the hole get Transvoxel transition faces toward it, so the levels stitch
+    * without cracks. With the defaults the coarsest level reaches at least 24576 voxels from the
+    * camera in every horizontal direction, with 2304 chunk slots in all.
+    *
+    * Every level keeps its chunks in a fixed array addressed toroidally by chunk position
+    * modulo the level size. When the camera moves, chunks that leave a level hand their slot
+    * to the chunks entering on the other side, so nothing is shifted and only entering chunks
+    * and chunks whose transition faces changed are meshed again.
+    *
+    * Coarse chunks are generated directly at their resolution: the mesher samples the
+    * density function every 1 << lod voxels. The density function is called from job threads
+    * and must be thread safe. Each job borrows a mesher from a pool, so meshing runs in
+    * parallel without sharing scratch memory. A chunk keeps drawing its previous mesh until
+    * its new one is ready.
+    */
+    class TerrainClipmap {
+    public:
+        /*! @param radius: Even number of chunks from the center to the edge of a level.
+        */
+        TerrainClipmap(const TransvoxelMesher::DensityFunc& density, u32 levels = DEFAULT_CLIPMAP_LEVELS,
+                       i32 radius = DEFAULT_CLIPMAP_RADIUS, i32 verticalRadius = DEFAULT_CLIPMAP_VERTICAL_RADIUS);
+        ~TerrainClipmap();
+
+        /*! @brief Collects finished meshes, moves the levels to follow the camera and schedules
+        * the chunks that need meshing.
+        *
+        * @param jobs: Optional job system. Without one, chunks are meshed on the calling thread.
+        * @return Number of chunks that still need meshing, including running ones.
+        */
+        size_t update(UNIT_SPACE(VOXEL) const f32v3& cameraPos, OPT JobSystem* jobs = nullptr);
+        /*! @brief Calls update() until every chunk around the camera is meshed.
+        */
+        void flush(UNIT_SPACE(VOXEL) const f32v3& cameraPos, OPT JobSystem* jobs = nullptr);
+
+        /*! @brief Gets the chunks with surface that are drawn from the current camera position.
+        */
+        void getVisibleChunks(OUT std::vector<ClipmapChunk>& chunks) const;
+
+        u32 getLevelCount() const {
+            return (u32)m_levels.size();
+        }
+        /*! @brief Distance from the camera to the nearest edge of the coarsest level, in voxels.
+        */
+        f32 getViewDistance() const;
+        /*! @brief Bytes used by the meshes and slots of every level.
+        */
+        size_t getMemoryUsage() const;
+        /*! @brief Number of chunks meshed since construction.
+        */
+        u64 getMeshedCount() const {
+            return m_meshedCount;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(TerrainClipmap);
+
+        /// Chunk of a level, reused by whichever chunk position maps to it
+        struct Slot {
+            i32v3 chunkPos;
+            u8 transitionFaces = 0;
+            bool valid = false; ///< True if mesh holds chunkPos with transitionFaces
+            bool running = false;
+            TransvoxelMesh mesh;
+        };
+        struct Level {
+            i32v3 min; ///< First chunk of the level, in chunks of its LOD
+            i32v3 holeMin; ///< First chunk covered by the finer level
+            i32v3 holeMax; ///< Exclusive
+            std::vector<Slot> slots;
+        };
+        struct MeshJob {
+            Slot* slot;
+            i32v3 chunkPos;
+            u32 lod;
+            u8 transitionFaces;
+            TransvoxelMesh mesh;
+        };
+
+        Slot& getSlot(Level& level, const i32v3& chunkPos);
+        const Slot* getSlot(const Level& level, const i32v3& chunkPos) const;
+        /// Meshes a chunk on any thread
+        void runJob(MeshJob* job);
+        /// Moves a finished mesh into its slot
+        void finishJob(MeshJob* job);
+
+        TransvoxelMesher::DensityFunc m_density;
+        i32v3 m_size; ///< Chunks per level along each axis
+        std::vector<Level> m_levels;
+        f32v3 m_cameraPos;
+
+        std::mutex m_lock; ///< Guards m_finished and m_freeMeshers
+        std::vector<MeshJob*> m_finished;
+        std::vector<std::unique_ptr<TransvoxelMesher> > m_meshers;
+        std::vector<TransvoxelMesher*> m_freeMeshers;
+        JobCounter m_counter;
+        size_t m_running = 0;
+        u64 m_meshedCount = 0;
+    };
+}
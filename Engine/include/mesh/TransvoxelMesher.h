@@ -0,0 +1,90 @@
+//
+// TransvoxelMesher.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TransvoxelMesher.h
+* @brief Smooth terrain meshes from density samples, with crack free seams between levels of detail.
+*/
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "../Decorators.h"
+#include "../Types.h"
+#include "../voxel/VoxelSpace.hpp"
+#include "PackedVertex.h"
+
+#define TRANSVOXEL_FACE_NEG_X 0x01 ///< Transition face flags, one per chunk face
+#define TRANSVOXEL_FACE_POS_X 0x02
+#define TRANSVOXEL_FACE_NEG_Y 0x04
+#define TRANSVOXEL_FACE_POS_Y 0x08
+#define TRANSVOXEL_FACE_NEG_Z 0x10
+#define TRANSVOXEL_FACE_POS_Z 0x20
+
+#define TRANSVOXEL_TRANSITION_WIDTH 0.5f ///< Depth of transition cells, in cells of the coarse chunk
+
+namespace openvox {
+    struct TransvoxelMesh : public PackedMesh {
+        size_t regularIndexCount = 0; ///< Indices before this come from regular cells, the rest from transition cells
+    };
+
+    /*! @brief Extracts the isosurface of a signed density field, one chunk at a time.
+    *
+    * Densities are stored as i8, negative inside the terrain. Regular cells are polygonized with
+    * marching cubes. A chunk face whose neighbor is one LOD finer gets a row of Transvoxel
+    * transition cells: their outer face holds the neighbor's 3x3 samples per coarse cell, so the
+    * vertices along the seam are the neighbor's own, and the regular cells next to the face are
+    * squeezed by TRANSVOXEL_TRANSITION_WIDTH to make room for them. Vertices on the faces shared
+    * with chunks of the same LOD are not squeezed, since those chunks may border the finer ones
+    * only along an edge, as around the corners of a clipmap level.
+    *
+    * The case tables are built once from the cell shapes. Faces are split by the same rule on
+    * both sides of every shared face, including the faces shared with the finer neighbors, so
+    * meshes of adjacent chunks close up without cracks.
+    *
+    * Vertices on cell edges are shared across cells through a reuse cache that lives in the
+    * mesher along with the sample grids, so a mesher holds all the scratch memory one thread
+    * needs and does not allocate once warm. Use one mesher per thread.
+    */
+    class TransvoxelMesher {
+    public:
+        /*! @brief Returns the density at a voxel position.
+        */
+        typedef std::function<i8(UNIT_SPACE(VOXEL) const i32v3& voxelPos)> DensityFunc;
+
+        TransvoxelMesher();
+
+        /*! @brief Meshes one chunk of a LOD.
+        *
+        * @param chunkPos: Position in chunks of this LOD, which are CHUNK_WIDTH << lod voxels wide.
+        * @param transitionFaces: TRANSVOXEL_FACE_ flags of faces whose neighbor is one LOD finer.
+        * Must be 0 at LOD 0. The chunk must be meshed again when they change.
+        * @param mesh: Cleared and filled with the surface.
+        */
+        void mesh(UNIT_SPACE(CHUNK) const i32v3& chunkPos, u32 lod, u8 transitionFaces,
+                  const DensityFunc& density, OUT TransvoxelMesh& mesh);
+
+    private:
+        OPENVOX_NON_COPYABLE(TransvoxelMesher);
+
+        void sampleChunk(const i32v3& origin, u32 lod, const DensityFunc& density);
+        void sampleFace(int face, const i32v3& origin, u32 lod, const DensityFunc& density);
+        void meshRegularCells(OUT TransvoxelMesh& mesh);
+        void meshTransitionCells(int face, OUT TransvoxelMesh& mesh);
+        /// Gets the vertex on the edge from a sample of the chunk grid along an axis
+        u32 getRegularVertex(const i32v3& sample, int axis, OUT TransvoxelMesh& mesh);
+        /// Gets the vertex on the edge from a sample of a face grid along its u or v axis
+        u32 getFaceVertex(int face, const i32v2& sample, int axis, OUT TransvoxelMesh& mesh);
+
+        u8 m_transitionFaces = 0;
+        std::vector<i8> m_samples; ///< Chunk grid with a one sample border for gradients
+        std::vector<i8> m_faceSamples; ///< Three layers of half spaced samples around a transition face
+        std::vector<u32> m_regularCache; ///< Vertex per sample and axis of the chunk grid
+        std::vector<u32> m_faceCache[6]; ///< Vertex per sample and axis of each face grid
+    };
+}
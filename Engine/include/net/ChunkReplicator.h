@@ -0,0 +1,158 @@
+//
+// ChunkReplicator.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file ChunkReplicator.h
+* @brief Replicates chunk changes to clients as bit-packed deltas.
+*/
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "../voxel/VoxelEditor.h"
+#include "LoopbackTransport.h"
+
+#define CHUNK_MESSAGE_FULL 1 ///< Message holding a whole chunk
+#define CHUNK_MESSAGE_DELTA 2 ///< Message holding the voxels that changed since the previous version
+
+namespace openvox {
+    /*! @brief Sends each client the chunks it subscribed to, then only what changed in them.
+    *
+    * Changes made during a tick are coalesced per chunk into a set of dirty voxels. flush(), at
+    * the end of the tick, bumps the version of every changed chunk and encodes it once for all
+    * subscribers. Clients holding the previous version get a delta, clients without a baseline
+    * get the full chunk.
+    *
+    * Both kinds of message start with a type byte, the chunk position as three i32 and the new
+    * version as a u32, little-endian, followed by a palette: a u16 count and that many BlockIDs.
+    * A full message then bit-packs the palette index of every voxel in storage order. A delta
+    * holds a u16 count and, per changed voxel, its 15-bit local position (the u8v3 local
+    * coordinates packed as the storage index) and palette index. Palette indices take as few
+    * bits as the palette needs, none for a single entry.
+    *
+    * A delta is replaced by the full chunk when it would not be smaller, and a chunk stops
+    * tracking individual voxels once more than the full chunk threshold changed in one tick.
+    */
+    class ChunkReplicator {
+    public:
+        typedef std::function<void(ClientID client, const u8* data, size_t size)> SendFunc;
+
+        ChunkReplicator(ChunkMap* chunkMap);
+        ~ChunkReplicator();
+
+        void addClient(ClientID client);
+        /*! @brief Drops a client and all of its subscriptions.
+        */
+        void removeClient(ClientID client);
+        /*! @brief Starts replicating a chunk to a client, beginning with the full chunk at the next flush.
+        */
+        void subscribe(ClientID client, UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        void unsubscribe(ClientID client, UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        /*! @brief Sends the full chunk at the next flush, e.g. when the client reports it is out of sync.
+        */
+        void resync(ClientID client, UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @brief Records a changed voxel. Changing it again before flush() costs nothing extra.
+        */
+        void onBlockChanged(UNIT_SPACE(VOXEL) const i32v3& voxelPos);
+        /*! @brief Records every voxel inside the bounds of a VoxelEditor commit.
+        */
+        void onEdit(const VoxelEditBatch& batch);
+
+        /*! @brief Encodes this tick's changes and new subscriptions and passes them to send.
+        */
+        void flush(SendFunc send);
+
+        /*! @brief Voxels changed in one tick beyond which a chunk is sent whole.
+        */
+        void setFullChunkThreshold(u32 voxels) {
+            m_fullThreshold = voxels;
+        }
+        u32 getVersion(UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+
+        u64 getBytesSent() const {
+            return m_bytesSent;
+        }
+        u64 getDeltasSent() const {
+            return m_deltasSent;
+        }
+        u64 getFullChunksSent() const {
+            return m_fullChunksSent;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(ChunkReplicator);
+
+        struct Subscriber {
+            ClientID client;
+            u32 version; ///< Version the client was last sent
+            bool needsFull;
+        };
+        struct ChunkState {
+            i32v3 position;
+            u32 version;
+            bool pending; ///< True if listed in m_pending
+            bool allDirty; ///< Too many voxels changed to track them one by one
+            std::vector<u16> dirty; ///< Changed voxel indices this tick
+            std::vector<u64> dirtyBits; ///< One bit per voxel, allocated on first change
+            std::vector<Subscriber> subscribers;
+        };
+
+        ChunkState* getState(const i32v3& chunkPos);
+        void markPending(ChunkState* state);
+        void markDirty(ChunkState* state, u16 voxelIndex);
+        void clearDirty(ChunkState* state);
+        /// Writes the message header and palette, returns the palette size
+        u32 writePalette(const ChunkState* state, const u16* ids, size_t count, u8 type, OUT std::vector<u8>& out);
+        void encodeFull(const ChunkState* state, const Chunk* chunk, OUT std::vector<u8>& out);
+        void encodeDelta(ChunkState* state, const Chunk* chunk, OUT std::vector<u8>& out);
+
+        ChunkMap* m_chunkMap;
+        std::unordered_map<i32v3, ChunkState*, PositionHash> m_chunks;
+        std::unordered_map<ClientID, std::vector<i32v3> > m_clientChunks;
+        std::vector<ChunkState*> m_pending; ///< Chunks with changes or subscribers waiting for a full chunk
+        std::vector<u16> m_paletteMap; ///< BlockID to palette index while encoding, 0xFFFF when unused
+        std::vector<u16> m_palette;
+        std::vector<u8> m_fullBuffer;
+        std::vector<u8> m_deltaBuffer;
+        u32 m_fullThreshold = CHUNK_SIZE / 8;
+        u64 m_bytesSent = 0;
+        u64 m_deltasSent = 0;
+        u64 m_fullChunksSent = 0;
+    };
+
+    /*! @brief Applies messages from a ChunkReplicator to a client's ChunkMap.
+    */
+    class ChunkReceiver {
+    public:
+        enum class Result {
+            APPLIED,
+            OUT_OF_SYNC, ///< Delta does not follow the held version, ask the server to resync
+            MALFORMED
+        };
+
+        ChunkReceiver(ChunkMap* chunkMap) : m_chunkMap(chunkMap) {}
+
+        /*! @param chunkPos: Receives the position of the chunk the message was for.
+        */
+        Result receive(const u8* data, size_t size, OPT OUT i32v3* chunkPos = nullptr);
+        /*! @brief Forgets a chunk, e.g. when the client unloads it.
+        */
+        void removeChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @return Version held for a chunk, or 0 if none.
+        */
+        u32 getVersion(UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+
+    private:
+        ChunkMap* m_chunkMap;
+        std::unordered_map<i32v3, u32, PositionHash> m_versions;
+        std::vector<u16> m_palette;
+    };
+}
@@ -0,0 +1,118 @@
+//
+// InterestManager.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file InterestManager.h
+* @brief Tracks which chunks and entities each client can see.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../physics/SpatialHash.h"
+#include "LoopbackTransport.h"
+
+namespace openvox {
+    class JobSystem;
+
+    /*! @brief What entered and left a client's view during the last update().
+    *
+    * Entered chunks and entities are sorted nearest first, so feeding them to replication in
+    * order sends what the client needs most first.
+    */
+    struct InterestDiff {
+        std::vector<i32v3> chunksEntered;
+        std::vector<i32v3> chunksLeft;
+        std::vector<SpatialHash::EntityID> entitiesEntered;
+        std::vector<SpatialHash::EntityID> entitiesLeft;
+
+        void clear() {
+            chunksEntered.clear();
+            chunksLeft.clear();
+            entitiesEntered.clear();
+            entitiesLeft.clear();
+        }
+    };
+
+    /*! @brief Maintains per-client chunk and entity visibility without scanning every pair.
+    *
+    * A client sees the chunks within a sphere of chunk radius around the chunk it is in. When it
+    * crosses into another chunk, only the rows of the sphere that differ between the old and new
+    * centers are walked, so a step costs O(radius^2) plus the chunks that actually changed.
+    *
+    * Entities live in a SpatialHash. Each update, every client queries the entities within its
+    * entity radius and diffs them against the previous set.
+    */
+    class InterestManager {
+    public:
+        typedef SpatialHash::EntityID EntityID;
+
+        /*! @param entityCellSize: Cell size of the entity grid, around the typical entity radius.
+        */
+        InterestManager(f32 entityCellSize = 32.0f);
+        ~InterestManager();
+
+        /*! @param chunkRadius: Radius of the visible chunk sphere, in chunks.
+        * @param entityRadius: Distance at which entities are visible, in voxels.
+        */
+        void addClient(ClientID client, i32 chunkRadius, f32 entityRadius);
+        /*! @brief Forgets a client. No leave diff is produced.
+        */
+        void removeClient(ClientID client);
+        void setClientPosition(ClientID client, UNIT_SPACE(VOXEL) const f32v3& position);
+
+        void setEntity(EntityID id, UNIT_SPACE(VOXEL) const f32v3& position);
+        void removeEntity(EntityID id);
+
+        /*! @brief Recomputes every client's diff.
+        *
+        * @param jobs: Optional job system that spreads clients over its threads.
+        */
+        void update(OPT JobSystem* jobs = nullptr);
+
+        /*! @return Changes from the last update(), or nullptr for an unknown client.
+        */
+        const InterestDiff* getDiff(ClientID client) const;
+        /*! @return Entities a client saw in the last update(), sorted by id.
+        */
+        const std::vector<EntityID>* getVisibleEntities(ClientID client) const;
+        bool isChunkVisible(ClientID client, UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+
+        size_t getClientCount() const {
+            return m_clients.size();
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(InterestManager);
+
+        struct Client {
+            ClientID id;
+            f32v3 position;
+            i32v3 center; ///< Chunk the visible sphere was last built around
+            bool hasCenter;
+            i32 chunkRadius;
+            f32 entityRadius;
+            std::vector<i16> rowWidths; ///< Half width in X of each (dy, dz) row of the sphere, -1 if empty
+            std::vector<EntityID> entities; ///< Visible entities, sorted
+            std::vector<EntityID> query; ///< Scratch for entity queries
+            InterestDiff diff;
+        };
+
+        Client* getClient(ClientID client) const;
+        void updateClient(Client& c);
+        i32 getRowWidth(const Client& c, i32 dy, i32 dz) const;
+        /// Appends chunks of the sphere around from that are not in the sphere around other
+        void appendDifference(const Client& c, const i32v3& from, bool hasOther, const i32v3& other,
+                              OUT std::vector<i32v3>& out) const;
+
+        SpatialHash m_entities;
+        std::vector<f32v3> m_entityPositions; ///< Indexed by EntityID
+        std::vector<Client*> m_clients;
+        std::unordered_map<ClientID, u32> m_clientIndices;
+    };
+}
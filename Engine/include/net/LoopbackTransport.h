@@ -0,0 +1,51 @@
+//
+// LoopbackTransport.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file LoopbackTransport.h
+* @brief Delivers messages between a server and clients in the same process.
+*/
+
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "../Types.h"
+
+namespace openvox {
+    typedef u32 ClientID;
+
+    /*! @brief In-process stand-in for a network connection, for tests and local play.
+    *
+    * Messages are delivered reliably and in order. Each message keeps its boundaries.
+    */
+    class LoopbackTransport {
+    public:
+        /*! @brief Queues a message for a client.
+        */
+        void send(ClientID client, const u8* data, size_t size);
+        /*! @brief Takes the oldest message queued for a client.
+        *
+        * @return False if no message is queued.
+        */
+        bool receive(ClientID client, OUT std::vector<u8>& message);
+
+        size_t getQueuedCount(ClientID client) const;
+        u64 getBytesSent() const {
+            return m_bytesSent;
+        }
+        u64 getMessagesSent() const {
+            return m_messagesSent;
+        }
+
+    private:
+        std::unordered_map<ClientID, std::deque<std::vector<u8> > > m_queues;
+        u64 m_bytesSent = 0;
+        u64 m_messagesSent = 0;
+    };
+}
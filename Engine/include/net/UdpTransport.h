@@ -0,0 +1,274 @@
+//
+// UdpTransport.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file UdpTransport.h
+* @brief Connection oriented messaging over UDP with reliable channels and congestion control.
+*/
+
+#pragma once
+
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "../Events.hpp"
+#include "LoopbackTransport.h"
+
+#define UDP_MAX_PACKET_SIZE 1200 ///< Largest datagram sent, small enough to avoid IP fragmentation
+#define UDP_FRAGMENT_SIZE 1024 ///< Payload of one fragment of a large reliable message
+#define UDP_RELIABLE_WINDOW 1024 ///< Reliable units that may be in flight per channel, a power of two
+#define UDP_MAX_MESSAGE_SIZE (UDP_FRAGMENT_SIZE * (UDP_RELIABLE_WINDOW / 2)) ///< Largest reliable message
+#define UDP_CHANNEL_COUNT 3
+
+namespace openvox {
+    /*! @brief How a message is delivered.
+    */
+    enum class UdpChannel {
+        UNRELIABLE, ///< May be lost, duplicated or reordered. Must fit in one packet.
+        RELIABLE_UNORDERED, ///< Delivered once, as soon as it arrives
+        RELIABLE_ORDERED ///< Delivered once, in the order it was sent
+    };
+
+    /*! @brief IPv4 address and port in host byte order.
+    */
+    struct NetAddress {
+        u32 ip;
+        u16 port;
+
+        bool operator==(const NetAddress& o) const {
+            return ip == o.ip && port == o.port;
+        }
+    };
+
+    struct UdpConnectionStats {
+        f32 rtt; ///< Smoothed round trip time in seconds
+        f32 congestionWindow; ///< Packets with reliable data allowed in flight
+        u64 packetsSent;
+        u64 packetsReceived;
+        u64 packetsAcked;
+        u64 unitsResent; ///< Reliable messages or fragments sent again after a timeout
+        u64 bytesSent;
+        u64 bytesReceived;
+    };
+
+    /*! @brief A UDP socket that both accepts and initiates connections.
+    *
+    * Connections start with a handshake: the client sends a request with a random salt, the
+    * server answers with a challenge holding its own salt, and the client proves it received
+    * the challenge by echoing the xor of both, which then tags every packet of the connection.
+    *
+    * Every data packet carries its sequence number, the newest sequence received from the peer
+    * and a bitfield acking the 32 before it, so acks survive lost packets without acking acks.
+    * Packets sent before anything was received from the peer are marked as carrying no acks.
+    * Reliable messages, or the fragments of messages larger than UDP_FRAGMENT_SIZE, are kept
+    * until a packet carrying them is acked and are resent after a timeout derived from the
+    * round trip time. Packets with reliable data are limited by a congestion window that grows
+    * by one packet per ack in slow start, then by one per window, and halves on loss.
+    *
+    * Outgoing packets are built in pooled buffers and handed to the kernel in batches with
+    * sendmmsg, and read with recvmmsg, on Linux. Other platforms send one datagram per call.
+    *
+    * All work happens in update(), which should be called at least every tick. A loss and
+    * latency simulator can be enabled on outgoing packets for testing on localhost.
+    */
+    class UdpTransport {
+    public:
+        UdpTransport();
+        ~UdpTransport();
+
+        /*! @brief Opens the socket.
+        *
+        * @param port: Local port, 0 picks any free port.
+        * @param acceptConnections: True to accept incoming connections, as a server.
+        * @return False if the socket could not be opened or bound.
+        */
+        bool open(u16 port, bool acceptConnections);
+        /*! @brief Disconnects everyone and closes the socket.
+        */
+        void close();
+
+        /*! @brief Starts connecting to a server. onConnect is sent once the handshake finishes.
+        *
+        * @param host: Dotted IPv4 address.
+        * @return Id of the connection, or 0 if host is invalid or the socket is not open.
+        */
+        ClientID connect(const char* host, u16 port);
+        /*! @brief Tells the peer and drops the connection. onDisconnect is not sent.
+        */
+        void disconnect(ClientID client);
+
+        /*! @brief Receives packets, resends lost data, sends queued messages and times out connections.
+        */
+        void update();
+
+        /*! @brief Queues a message. It is sent in the next update().
+        *
+        * @return False if the client is not connected or the message is too large for the channel.
+        */
+        bool send(ClientID client, const u8* data, size_t size, UdpChannel channel = UdpChannel::RELIABLE_ORDERED);
+        /*! @brief Takes the oldest message received from a client.
+        *
+        * @return False if none is waiting.
+        */
+        bool receive(ClientID client, OUT std::vector<u8>& message);
+
+        /*! @brief Drops and delays outgoing packets to test behavior on a bad network.
+        *
+        * @param lossRate: Chance in [0, 1] that a packet is dropped.
+        * @param latency: Seconds each packet is held back.
+        * @param jitter: Up to this many extra seconds, which also reorders packets.
+        */
+        void setSimulation(f32 lossRate, f32 latency, f32 jitter);
+        /*! @param timeout: Seconds without hearing from a peer before it is disconnected.
+        */
+        void setTimeout(f32 timeout) {
+            m_timeout = timeout;
+        }
+
+        bool isOpen() const {
+            return m_socket != INVALID_SOCKET_HANDLE;
+        }
+        bool isConnected(ClientID client) const;
+        u16 getLocalPort() const {
+            return m_localPort;
+        }
+        void getClients(OUT std::vector<ClientID>& clients) const;
+        /*! @return Statistics of a connection, or nullptr if it does not exist.
+        */
+        const UdpConnectionStats* getStats(ClientID client) const;
+
+        Event<ClientID> onConnect; ///< A connection finished its handshake, on either side
+        Event<ClientID> onDisconnect; ///< A connection timed out or the peer disconnected
+
+    private:
+        OPENVOX_NON_COPYABLE(UdpTransport);
+
+        static const intptr_t INVALID_SOCKET_HANDLE = -1;
+
+        struct Packet {
+            NetAddress address;
+            size_t size;
+            f64 releaseTime; ///< When the simulator lets the packet go
+            u8 data[UDP_MAX_PACKET_SIZE];
+        };
+        /// A reliable message, or one fragment of a large one
+        struct OutUnit {
+            u16 id;
+            u16 fragmentIndex;
+            u16 fragmentCount;
+            bool used;
+            bool acked;
+            f64 lastSent; ///< Negative until first sent
+            std::vector<u8> data;
+        };
+        struct InUnit {
+            u16 id;
+            u16 fragmentIndex;
+            u16 fragmentCount;
+            bool present;
+            bool delivered;
+            std::vector<u8> data;
+        };
+        struct ReliableChannel {
+            bool ordered;
+            u16 nextSendId = 0;
+            u16 oldestUnacked = 0;
+            u16 receiveBase = 0; ///< Units before this were delivered
+            std::vector<OutUnit> sent; ///< Ring of UDP_RELIABLE_WINDOW units by id
+            std::vector<InUnit> received; ///< Ring of UDP_RELIABLE_WINDOW units by id
+            std::deque<OutUnit> waiting; ///< Units that do not fit in the window yet
+        };
+        /// Reliable units carried by a sent packet, acked together with it
+        struct SentPacket {
+            u16 sequence;
+            bool used;
+            bool acked;
+            bool reliable;
+            bool lost; ///< Counted as lost and removed from the congestion window
+            f64 time;
+            std::vector<u32> units; ///< Channel in the top bits, unit id in the low 16
+        };
+        enum class ConnectionState {
+            REQUESTING, ///< Client waiting for a challenge
+            RESPONDING, ///< Client waiting to be accepted
+            CONNECTED
+        };
+        struct Connection {
+            ClientID id;
+            NetAddress address;
+            ConnectionState state;
+            u32 clientSalt;
+            u32 session;
+            f64 lastReceived;
+            f64 lastSent;
+            u16 nextSequence = 0;
+            u16 remoteSequence = 0; ///< Newest sequence received
+            u32 remoteAckBits = 0; ///< Bit i set if remoteSequence - 1 - i was received
+            bool receivedAny = false;
+            bool ackPending = false;
+            f32 rtt = 0.1f;
+            f32 congestionWindow = 4.0f;
+            f32 slowStartThreshold = 64.0f;
+            f64 lastLossTime = 0.0;
+            u32 reliableInFlight = 0;
+            u16 newestAcked = 0; ///< Newest of our sequences the peer acked
+            bool anyAcked = false;
+            std::vector<SentPacket> sentPackets; ///< Ring of recent packets by sequence
+            ReliableChannel channels[2]; ///< RELIABLE_UNORDERED and RELIABLE_ORDERED
+            std::deque<std::vector<u8> > unreliable; ///< Queued unreliable messages
+            std::deque<std::vector<u8> > inbox; ///< Received messages
+            UdpConnectionStats stats;
+        };
+        /// Server side of a handshake that has not been answered yet
+        struct PendingConnection {
+            u32 clientSalt;
+            u32 serverSalt;
+            f64 created;
+        };
+
+        Connection* createConnection(const NetAddress& address);
+        Connection* findConnection(const NetAddress& address) const;
+        Connection* getConnection(ClientID client) const;
+        void removeConnection(ClientID client, bool notify);
+
+        Packet* allocatePacket(const NetAddress& address);
+        void queuePacket(Packet* packet);
+        void flushPackets();
+        void receivePackets();
+        void handlePacket(const NetAddress& address, const u8* data, size_t size);
+        void handleData(Connection& c, const u8* data, size_t size);
+        void handleAcks(Connection& c, u16 ack, u32 ackBits);
+        void receiveUnit(Connection& c, UdpChannel channel, u16 id, u16 fragmentIndex, u16 fragmentCount,
+                         const u8* data, size_t size);
+        /// Gives up on a packet and schedules its reliable units to be sent again
+        void markLost(Connection& c, SentPacket& packet);
+        void sendHandshake(const NetAddress& address, u8 type, u32 a, u32 b);
+        void sendConnection(Connection& c);
+        /// Starts a data packet for c and returns it with the header written
+        Packet* beginDataPacket(Connection& c);
+        void endDataPacket(Connection& c, Packet* packet, SentPacket& record);
+
+        intptr_t m_socket = INVALID_SOCKET_HANDLE;
+        u16 m_localPort = 0;
+        bool m_accepting = false;
+        f64 m_time = 0.0;
+        f32 m_timeout = 5.0f;
+        ClientID m_nextClientID = 1;
+        std::vector<Connection*> m_connections;
+        std::unordered_map<ClientID, Connection*> m_connectionIDs;
+        std::unordered_map<u64, Connection*> m_connectionAddresses;
+        std::unordered_map<u64, PendingConnection> m_pending;
+        std::vector<Packet*> m_packetPool;
+        std::vector<Packet*> m_outgoing; ///< Packets ready for the socket
+        std::vector<Packet*> m_delayed; ///< Packets held back by the simulator
+        f32 m_lossRate = 0.0f;
+        f32 m_latency = 0.0f;
+        f32 m_jitter = 0.0f;
+        std::mt19937 m_random;
+    };
+}
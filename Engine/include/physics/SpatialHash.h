@@ -0,0 +1,145 @@
+//
+// SpatialHash.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file SpatialHash.h
+* @brief Broadphase grid for finding dynamic entities near a point, box or ray.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../voxel/VoxelSpace.hpp"
+
+#define DEFAULT_SPATIAL_CELL_SIZE 4.0f ///< Default width of a spatial hash cell in voxels
+#define SPATIAL_HASH_SHARDS 16 ///< Independent cell tables, also the parallelism of rebuild()
+
+namespace openvox {
+    class JobSystem;
+
+    /*! @brief Hashes entity positions into uniform cells keyed by i32v3.
+    *
+    * Each cell keeps the ids and positions of its entities in contiguous arrays, so a
+    * query scans memory linearly instead of chasing entity pointers. Cells are split
+    * between SPATIAL_HASH_SHARDS tables so a full rebuild can fill each table on its own thread.
+    *
+    * Entity ids index an internal table, so they should be small and dense.
+    *
+    * Queries are const and may run concurrently with each other, but not with updates.
+    */
+    class SpatialHash {
+    public:
+        typedef u32 EntityID;
+
+        SpatialHash(f32 cellSize = DEFAULT_SPATIAL_CELL_SIZE);
+
+        /*! @brief Adds an entity, or moves it if it was already added.
+        */
+        void insert(EntityID id, const f32v3& position);
+        /*! @brief Removes an entity.
+        *
+        * @return False if the entity was not in the hash.
+        */
+        bool remove(EntityID id);
+        /*! @brief Sets the position of an entity.
+        *
+        * Cell storage is only modified when the entity moves into a different cell.
+        */
+        void update(EntityID id, const f32v3& position);
+        /*! @brief Removes all entities.
+        */
+        void clear();
+        /*! @brief Replaces the contents with entities 0 to count - 1.
+        *
+        * Faster than inserting one at a time for large counts. Output does not depend on
+        * the number of threads used.
+        *
+        * @param positions: Position of each entity, indexed by id.
+        * @param count: Number of entities.
+        * @param jobs: Optional job system that builds the shards in parallel.
+        */
+        void rebuild(const f32v3* positions, size_t count, OPT JobSystem* jobs = nullptr);
+
+        /*! @brief Finds entities within a sphere.
+        *
+        * @param results: Caller buffer that receives entity ids.
+        * @param capacity: Size of results. The query stops once it is full.
+        * @return Number of ids written.
+        */
+        size_t queryRadius(const f32v3& center, f32 radius, OUT EntityID* results, size_t capacity) const;
+        /*! @brief Finds entities inside a box.
+        *
+        * @return Number of ids written to results.
+        */
+        size_t queryAABB(const f32v3& min, const f32v3& max, OUT EntityID* results, size_t capacity) const;
+        /*! @brief Finds entities within radius of a ray segment, roughly ordered by distance along it.
+        *
+        * Walks the cells the ray passes through, so cost grows with ray length rather than entity count.
+        *
+        * @param origin: Start of the ray.
+        * @param direction: Direction of the ray, need not be normalized.
+        * @param maxDistance: Length of the segment.
+        * @param radius: Entities closer than this to the segment are returned.
+        * @return Number of ids written to results.
+        */
+        size_t queryRay(const f32v3& origin, const f32v3& direction, f32 maxDistance, f32 radius,
+                        OUT EntityID* results, size_t capacity) const;
+
+        /*! @brief Gets the cell that contains a position.
+        */
+        i32v3 getCell(const f32v3& position) const;
+        bool contains(EntityID id) const {
+            return id < m_entities.size() && m_entities[id].cell != INVALID_CELL;
+        }
+        size_t getEntityCount() const {
+            return m_entityCount;
+        }
+        size_t getCellCount() const;
+        f32 getCellSize() const {
+            return m_cellSize;
+        }
+
+    private:
+        static const u32 INVALID_CELL = 0xFFFFFFFFu;
+
+        /// Contiguous storage for the entities in one cell
+        struct Cell {
+            i32v3 coord;
+            std::vector<EntityID> ids;
+            std::vector<f32> x, y, z;
+        };
+        struct Shard {
+            std::unordered_map<i32v3, u32, PositionHash> lookup; ///< Cell coord -> index into cells
+            std::vector<Cell> cells;
+            std::vector<u32> freeCells; ///< Empty cells kept for reuse so their arrays keep capacity
+        };
+        /// Where an entity is stored
+        struct EntityRecord {
+            u32 cell = INVALID_CELL; ///< Shard index in the top bits, cell index in the rest
+            u32 slot = 0; ///< Index inside the cell arrays
+        };
+
+        static u32 getShard(const i32v3& coord);
+        static u32 packCell(u32 shard, u32 cell) {
+            return (shard << 27) | cell;
+        }
+        const Cell* findCell(const i32v3& coord) const;
+        /// Appends an entity to a cell, creating it if needed
+        void addToCell(u32 shard, const i32v3& coord, EntityID id, const f32v3& position);
+        /// Swap removes an entity from its cell
+        void removeFromCell(const EntityRecord& record);
+        /// Checks the entities in one cell against a sphere
+        static size_t gatherSphere(const Cell& cell, const f32v3& center, f32 radiusSq, EntityID* results, size_t count, size_t capacity);
+
+        f32 m_cellSize;
+        f32 m_invCellSize;
+        Shard m_shards[SPATIAL_HASH_SHARDS];
+        std::vector<EntityRecord> m_entities; ///< Indexed by EntityID
+        size_t m_entityCount = 0;
+    };
+}
@@ -0,0 +1,185 @@
+//
+// VoxelCollider.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file VoxelCollider.h
+* @brief Swept AABB collision of entities against the voxel grid.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "../voxel/ChunkMap.h"
+
+#define DEFAULT_GRAVITY 32.0f ///< Downward acceleration in voxels per second squared
+#define COLLISION_EPSILON 1e-4f ///< Tolerance for touching faces
+
+namespace openvox {
+    /*! @brief Axis aligned bounding box.
+    */
+    struct AABB {
+    public:
+        AABB() {}
+        AABB(const f32v3& min, const f32v3& max) : min(min), max(max) {}
+
+        void translate(const f32v3& offset) {
+            min += offset;
+            max += offset;
+        }
+        bool intersects(const AABB& o) const {
+            return min.x < o.max.x && max.x > o.min.x &&
+                   min.y < o.max.y && max.y > o.min.y &&
+                   min.z < o.max.z && max.z > o.min.z;
+        }
+
+        f32v3 min; ///< Minimum corner
+        f32v3 max; ///< Maximum corner
+    };
+
+    /*! @brief Bit flags describing what happened during a move.
+    */
+    enum CollisionFlags : u8 {
+        COLLISION_NONE = 0,
+        COLLISION_X = 1 << 0, ///< Movement along X was blocked
+        COLLISION_Y = 1 << 1, ///< Movement along Y was blocked
+        COLLISION_Z = 1 << 2, ///< Movement along Z was blocked
+        COLLISION_ON_GROUND = 1 << 3, ///< Body is resting on top of a voxel
+        COLLISION_STEPPED = 1 << 4 ///< Body stepped up onto a ledge
+    };
+
+    /*! @brief Outcome of VoxelCollider::move.
+    */
+    struct MoveResult {
+    public:
+        f32v3 offset; ///< Movement that was actually applied
+        u8 flags = COLLISION_NONE; ///< Combination of CollisionFlags
+    };
+
+    /*! @brief Structure of arrays for many collision bodies.
+    *
+    * Each body is a box described by its center and half extents. Keeping each field
+    * in its own array lets the integration passes in VoxelCollider::step vectorize.
+    */
+    class CollisionBatch {
+    public:
+        /*! @brief Adds a body to the batch.
+        *
+        * @param position: Center of the body.
+        * @param halfExtents: Half the size of the body on each axis.
+        * @param stepHeight: Tallest ledge the body can walk up, 0 to disable.
+        * @return Index of the body.
+        */
+        size_t add(const f32v3& position, const f32v3& halfExtents, f32 stepHeight = 0.0f);
+        /*! @brief Removes a body by swapping the last body into its slot.
+        */
+        void remove(size_t i);
+        void clear();
+        void reserve(size_t n);
+
+        size_t size() const {
+            return posX.size();
+        }
+        f32v3 getPosition(size_t i) const {
+            return f32v3(posX[i], posY[i], posZ[i]);
+        }
+        f32v3 getVelocity(size_t i) const {
+            return f32v3(velX[i], velY[i], velZ[i]);
+        }
+        void setVelocity(size_t i, const f32v3& v) {
+            velX[i] = v.x;
+            velY[i] = v.y;
+            velZ[i] = v.z;
+        }
+        bool isOnGround(size_t i) const {
+            return (flags[i] & COLLISION_ON_GROUND) != 0;
+        }
+
+        std::vector<f32> posX, posY, posZ; ///< Body centers
+        std::vector<f32> velX, velY, velZ; ///< Velocities in voxels per second
+        std::vector<f32> halfX, halfY, halfZ; ///< Half extents
+        std::vector<f32> stepHeight; ///< Maximum step up height
+        std::vector<u8> flags; ///< CollisionFlags from the last step
+    };
+
+    /*! @brief Resolves movement of boxes against solid voxels in a ChunkMap.
+    *
+    * Movement is resolved one axis at a time (Y, then X, then Z) against the unit boxes of
+    * all solid voxels in the swept region. Candidate voxels are enumerated chunk by chunk
+    * so each chunk in the region is looked up in the map only once.
+    *
+    * A voxel is solid when it is not BLOCK_AIR.
+    *
+    * @warning Scratch buffers are reused between calls, so one collider must not be shared
+    * between threads. Create one per thread instead; they are cheap.
+    */
+    class VoxelCollider {
+    public:
+        VoxelCollider(const ChunkMap* chunkMap);
+
+        /*! @brief Moves a box, stopping it at solid voxels.
+        *
+        * @param box: Box to move, updated with the resolved position.
+        * @param offset: Desired movement.
+        * @param stepHeight: Tallest ledge the box may climb, 0 to disable stepping.
+        * @param onGround: True if the box was resting on the ground before the move.
+        * @return Movement that was applied and what was hit.
+        */
+        MoveResult move(OUT AABB& box, const f32v3& offset, f32 stepHeight = 0.0f, bool onGround = false);
+
+        /*! @brief Integrates and collides every body in a batch.
+        *
+        * Applies gravity, moves each body by velocity * dt, and zeroes velocity along blocked axes.
+        *
+        * @param batch: Bodies to simulate.
+        * @param dt: Time step in seconds.
+        */
+        void step(CollisionBatch& batch, f32 dt);
+
+        /*! @brief Enumerates the solid voxels that overlap a region.
+        *
+        * @param region: World space region to search.
+        * @param voxels: Receives the positions of solid voxels.
+        * @return Number of voxels appended.
+        */
+        size_t getSolidVoxels(const AABB& region, OUT std::vector<i32v3>& voxels) const;
+
+        /*! @brief Checks if a box overlaps any solid voxel.
+        */
+        bool isBoxObstructed(const AABB& box) const;
+
+        void setGravity(f32 gravity) {
+            m_gravity = gravity;
+        }
+        /*! @brief Sets whether voxels in unloaded chunks block movement.
+        *
+        * Defaults to true so bodies cannot fall out of the world while terrain streams in.
+        */
+        void setUnloadedSolid(bool solid) {
+            m_unloadedSolid = solid;
+        }
+        f32 getGravity() const {
+            return m_gravity;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(VoxelCollider);
+
+        /// Fills the candidate arrays with solid voxels overlapping region.
+        void gatherCandidates(const AABB& region);
+        /// Clips movement along one axis against the current candidates.
+        f32 clipAxis(const AABB& box, int axis, f32 delta) const;
+
+        const ChunkMap* m_chunkMap; ///< Voxel source
+        f32 m_gravity = DEFAULT_GRAVITY;
+        bool m_unloadedSolid = true;
+
+        // Minimum corners of candidate voxels, SoA so clipAxis can vectorize
+        std::vector<f32> m_candX;
+        std::vector<f32> m_candY;
+        std::vector<f32> m_candZ;
+    };
+}
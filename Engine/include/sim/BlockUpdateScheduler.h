@@ -0,0 +1,156 @@
+//
+// BlockUpdateScheduler.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file BlockUpdateScheduler.h
+* @brief Schedules delayed block updates on a hierarchical timing wheel.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../voxel/VoxelSpace.hpp"
+
+#define TIMING_WHEEL_LEVELS 4 ///< Levels of the wheel, covering 32 bits of fire tick
+#define TIMING_WHEEL_SLOT_BITS 8
+#define TIMING_WHEEL_SLOTS (1 << TIMING_WHEEL_SLOT_BITS) ///< Slots per level
+#define TIMING_WHEEL_SLOT_MASK (TIMING_WHEEL_SLOTS - 1)
+/// Longest delay, 2^32 - 2^24 ticks. Fire ticks are kept in 32 bits, so a longer delay could
+/// wrap into the current top level slot and fire early.
+#define BLOCK_UPDATE_MAX_DELAY 0xFF000000u
+
+namespace openvox {
+    typedef u16 BlockUpdateType; ///< Meaning is up to the game, e.g. crop growth or a falling block
+
+    struct BlockUpdate {
+        i32v3 position;
+        BlockUpdateType type;
+    };
+
+    /*! @brief Refers to a pending update. Stays safe to use after the update fired or was cancelled.
+    */
+    struct BlockUpdateHandle {
+        u32 index;
+        u32 generation;
+    };
+
+    /*! @brief Holds millions of delayed block updates with O(1) scheduling and cancelling.
+    *
+    * Updates sit in one of four wheels of 256 slots. The first wheel holds updates due within
+    * 256 ticks, one slot per tick. Each higher wheel covers 256 times the range of the one
+    * below it, up to BLOCK_UPDATE_MAX_DELAY. Slots of a higher wheel are moved down a level
+    * when the lower wheel wraps around, so an update is touched at most once per level
+    * before it fires.
+    *
+    * Every update is also linked into a list for its chunk, so unloading a chunk drops its
+    * updates without searching the wheels, and the updates of a chunk can be saved with it.
+    */
+    class BlockUpdateScheduler {
+    public:
+        BlockUpdateScheduler();
+
+        /*! @brief Schedules an update.
+        *
+        * @param voxelPos: World voxel position of the update.
+        * @param type: Kind of update.
+        * @param delay: Ticks until the update fires. A delay of 0 fires on the next tick, and
+        * delays above BLOCK_UPDATE_MAX_DELAY are clamped to it.
+        * @return Handle for cancel().
+        */
+        BlockUpdateHandle schedule(UNIT_SPACE(VOXEL) const i32v3& voxelPos, BlockUpdateType type, u32 delay);
+        /*! @brief Cancels a pending update.
+        *
+        * @return False if the update already fired or was cancelled.
+        */
+        bool cancel(BlockUpdateHandle handle);
+        bool isPending(BlockUpdateHandle handle) const;
+
+        /*! @brief Advances one tick and collects the updates that fire on it.
+        *
+        * @param fired: Receives the updates, appended in no particular order.
+        * @return Number of updates fired.
+        */
+        size_t tick(OUT std::vector<BlockUpdate>& fired);
+
+        /*! @brief Drops all pending updates in a chunk.
+        *
+        * @return Number of updates dropped.
+        */
+        size_t unloadChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        /*! @brief Appends the pending updates of a chunk to a buffer.
+        *
+        * Delays are stored relative to the current tick, so they resume correctly on load.
+        * @param out: Receives a little-endian u32 count followed by 8 bytes per update.
+        */
+        void saveChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos, OUT std::vector<u8>& out) const;
+        /*! @brief Schedules updates written by saveChunk().
+        *
+        * @param size: Bytes available in data.
+        * @return Bytes read, or 0 if the data is malformed or has a delay above
+        * BLOCK_UPDATE_MAX_DELAY, in which case nothing is scheduled.
+        */
+        size_t loadChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos, const u8* data, size_t size);
+
+        /*! @brief Drops every pending update. The current tick is kept.
+        */
+        void clear();
+        /*! @brief Preallocates storage for a number of pending updates.
+        */
+        void reserve(size_t updates);
+
+        u64 getCurrentTick() const {
+            return m_currentTick;
+        }
+        size_t getPendingCount() const {
+            return m_pendingCount;
+        }
+        u32 getPendingCount(UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+
+    private:
+        static const u32 NONE = 0xFFFFFFFFu;
+
+        /// One pending update, linked into a wheel slot and into its chunk's list
+        struct Timer {
+            u32 fireTick; ///< Low 32 bits of the tick it fires on
+            u32 next; ///< Next timer in the slot, or next free timer
+            u32 prev;
+            u32 chunkNext;
+            u32 chunkPrev;
+            u32 chunk; ///< Index into m_chunks
+            u16 voxelIndex; ///< Index of the voxel within its chunk
+            BlockUpdateType type;
+            u32 generation; ///< Incremented on every free, odd while pending
+        };
+        struct ChunkTimers {
+            i32v3 position;
+            u32 head;
+            u32 count;
+        };
+
+        u32 allocateTimer();
+        /// Unlinks a timer from its chunk and returns it to the free list
+        void freeTimer(u32 t);
+        /// Links a timer into the wheel slot for its fire tick
+        void insert(u32 t);
+        void unlinkSlot(u32 t);
+        /// Gets the head of the slot a fire tick belongs in, given the current tick
+        u32& getSlot(u32 fireTick);
+        /// Moves a higher level slot down to lower levels
+        void cascade(int level, u32 slot);
+        u32 getChunkIndex(const i32v3& chunkPos);
+
+        std::vector<Timer> m_timers;
+        u32 m_freeHead = NONE;
+        u32 m_slots[TIMING_WHEEL_LEVELS][TIMING_WHEEL_SLOTS];
+        std::vector<ChunkTimers> m_chunks;
+        std::vector<u32> m_freeChunks;
+        std::unordered_map<i32v3, u32, PositionHash> m_chunkIndices;
+        u64 m_currentTick = 0;
+        size_t m_pendingCount = 0;
+    };
+}
@@ -0,0 +1,192 @@
+//
+// FluidSimulator.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file FluidSimulator.h
+* @brief Cellular automaton for flowing water and lava that only simulates active cells.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../Events.hpp"
+#include "../voxel/ChunkMap.h"
+
+#define FLUID_LEVEL_MASK 0x0F ///< Bits of a fluid cell holding the level
+#define FLUID_TYPE_SHIFT 4
+#define FLUID_TYPE_MASK 0x70 ///< Bits of a fluid cell holding the FluidType
+#define FLUID_SOURCE_BIT 0x80 ///< Set on cells that never drain
+#define FLUID_MAX_LEVEL 15 ///< Level of a full cell
+#define FLUID_ACTIVE_WORDS (CHUNK_SIZE / 64) ///< u64 words in a per-chunk active set
+#define DEFAULT_FLUID_CELL_BUDGET 262144 ///< Cells processed per update() before yielding
+
+namespace openvox {
+    class JobSystem;
+
+    enum class FluidType : u8 {
+        NONE = 0,
+        WATER = 1,
+        LAVA = 2
+    };
+
+    /*! @brief Packs a fluid cell into a u8.
+    */
+    inline u8 packFluid(FluidType type, u8 level, bool source = false) {
+        if (level == 0 || type == FluidType::NONE) return 0;
+        return (u8)(((u8)type << FLUID_TYPE_SHIFT) | (level & FLUID_LEVEL_MASK) | (source ? FLUID_SOURCE_BIT : 0));
+    }
+    inline u8 getFluidLevel(u8 cell) {
+        return cell & FLUID_LEVEL_MASK;
+    }
+    inline FluidType getFluidType(u8 cell) {
+        return (FluidType)((cell & FLUID_TYPE_MASK) >> FLUID_TYPE_SHIFT);
+    }
+    inline bool isFluidSource(u8 cell) {
+        return (cell & FLUID_SOURCE_BIT) != 0;
+    }
+
+    /*! @brief Simulates fluid flow on a layer of packed u8 cells kept beside the ChunkMap.
+    *
+    * Fluid falls into the cell below first and only spreads sideways once it cannot fall.
+    * Each cell's next level is gathered from its neighbors' current levels, so a tick reads
+    * one buffer and writes the other, and no two chunks write to the same memory. Mass is
+    * conserved except at sources and where different fluids meet, which turns the meeting
+    * cell into the reaction block.
+    *
+    * Only cells in a chunk's active set are simulated. A cell stays active while it flows
+    * and wakes its surroundings when it changes. Wake-ups that cross into another chunk go
+    * into an outbox that is exchanged at the end of the tick.
+    *
+    * A tick may be spread over several update() calls to stay within a cell budget.
+    * Voxels that are not BLOCK_AIR, and voxels in unloaded chunks, block fluid.
+    */
+    class FluidSimulator {
+    public:
+        FluidSimulator(ChunkMap* chunkMap);
+        ~FluidSimulator();
+
+        /*! @brief Advances the simulation, processing up to the cell budget.
+        *
+        * @param jobs: Optional job system that processes chunks in parallel.
+        * @return True if a tick was completed during this call.
+        */
+        bool update(OPT JobSystem* jobs = nullptr);
+        /*! @brief Runs update() until a whole tick has completed.
+        */
+        void tick(OPT JobSystem* jobs = nullptr);
+
+        /*! @brief Places or removes fluid. Applied at the start of the next tick.
+        *
+        * @param voxelPos: World voxel position.
+        * @param cell: Packed fluid from packFluid(), 0 removes fluid.
+        */
+        void setFluid(UNIT_SPACE(VOXEL) const i32v3& voxelPos, u8 cell);
+        /*! @brief Wakes the cells around a voxel, e.g. after a block was placed or broken there.
+        */
+        void wake(UNIT_SPACE(VOXEL) const i32v3& voxelPos);
+        /*! @brief Gets the packed fluid at a voxel as of the last completed tick.
+        */
+        u8 getFluid(UNIT_SPACE(VOXEL) const i32v3& voxelPos) const;
+        /*! @brief Frees the fluid layer of a chunk, e.g. when the chunk unloads.
+        *
+        * @pre No tick is in progress. Chunks must not be removed from the ChunkMap mid-tick either.
+        */
+        void unloadChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @brief Sets the maximum cells simulated per update() call.
+        *
+        * Whole chunks are scheduled at once, so one call may exceed it by one chunk per thread.
+        */
+        void setCellBudget(size_t cells) {
+            m_cellBudget = cells;
+        }
+        /*! @brief Sets the block placed where different fluid types meet.
+        */
+        void setReactionBlock(BlockID id) {
+            m_reactionBlock = id;
+        }
+
+        u64 getTickCount() const {
+            return m_tickCount;
+        }
+        /*! @brief Number of cells simulated during the last completed tick.
+        */
+        size_t getLastTickCellCount() const {
+            return m_lastTickCells;
+        }
+        size_t getFluidChunkCount() const {
+            return m_chunks.size();
+        }
+        /*! @brief True while a tick has been started but not all of its chunks are processed.
+        */
+        bool isTickInProgress() const {
+            return m_tickInProgress;
+        }
+
+        Event<i32v3> onChunkChanged; ///< Sent with a chunk position when its fluid changed during a tick
+
+    private:
+        OPENVOX_NON_COPYABLE(FluidSimulator);
+
+        /// Wake-up that spills into a neighboring chunk
+        struct OutboxEntry {
+            u8 neighbor; ///< Index into FluidChunk::neighbors
+            u8 y;
+            u8 z;
+            u32 xMask; ///< Bit per x in the row
+        };
+        struct FluidChunk {
+            i32v3 position;
+            u8 cells[CHUNK_SIZE]; ///< Packed fluid as of the last completed tick
+            u8 next[CHUNK_SIZE]; ///< Packed fluid being computed for active cells
+            u64 active[FLUID_ACTIVE_WORDS]; ///< Cells simulated this tick
+            u64 nextActive[FLUID_ACTIVE_WORDS]; ///< Cells to simulate next tick
+            FluidChunk* neighbors[27]; ///< Fluid layers of the 3x3x3 surrounding chunks
+            const Chunk* blocks[27]; ///< Voxel data of the 3x3x3 surrounding chunks
+            std::vector<OutboxEntry> outbox;
+            std::vector<u16> reactions; ///< Cells where different fluids met
+            u32 fluidCells; ///< Cells holding any fluid
+            u32 activeCells; ///< Population of active
+            bool changed; ///< True if any cell changed this tick
+            bool touched; ///< True if listed in m_touched
+        };
+        struct PendingEdit {
+            i32v3 voxelPos;
+            u8 cell;
+            bool wakeOnly;
+        };
+
+        FluidChunk* getFluidChunk(const i32v3& chunkPos) const;
+        FluidChunk* createFluidChunk(const i32v3& chunkPos);
+        void resolveNeighbors(FluidChunk* c);
+        /// Starts a tick: applies edits and collects chunks with active cells
+        void beginTick();
+        /// Finishes a tick: exchanges outboxes, commits buffers and frees idle chunks
+        void endTick();
+        /// Simulates every active cell in one chunk
+        void processChunk(FluidChunk* c);
+        /// Marks a cube of cells with the given radius in next tick's active sets
+        static void markActive(FluidChunk* c, int x, int y, int z, int radius);
+        /// Delivers outbox wake-ups to neighboring chunks, creating their fluid layers if needed
+        void exchangeOutbox(FluidChunk* c);
+        void touch(FluidChunk* c);
+
+        ChunkMap* m_chunkMap;
+        std::unordered_map<i32v3, FluidChunk*, PositionHash> m_chunks;
+        std::vector<FluidChunk*> m_tickChunks; ///< Chunks scheduled in the current tick
+        std::vector<FluidChunk*> m_touched; ///< Chunks with bits in nextActive
+        size_t m_nextChunk = 0; ///< Next entry of m_tickChunks to process
+        std::vector<PendingEdit> m_edits;
+        size_t m_cellBudget = DEFAULT_FLUID_CELL_BUDGET;
+        BlockID m_reactionBlock = BLOCK_AIR;
+        bool m_tickInProgress = false;
+        u64 m_tickCount = 0;
+        size_t m_tickCells = 0;
+        size_t m_lastTickCells = 0;
+    };
+}
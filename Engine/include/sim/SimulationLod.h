@@ -0,0 +1,149 @@
+//
+// SimulationLod.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file SimulationLod.h
+* @brief Updates entities and random-ticks chunks less often the farther they are from players.
+*/
+
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "../voxel/VoxelSpace.hpp"
+
+#define SIMULATION_TIER_NONE 0xFF ///< Tier of things beyond the last tier, which are not simulated
+#define SIMULATION_TIER_CACHE_LIMIT 4096 ///< Chunk tiers cached between reclassifications before the cache starts over
+
+namespace openvox {
+    /*! @brief One distance band of the simulation.
+    */
+    struct SimulationTier {
+        f32 maxDistance; ///< Voxels from the nearest player at which the tier ends
+        u32 interval; ///< Simulated every this many ticks, at least 1
+    };
+
+    /*! @brief Decides which entities and chunks are simulated on each tick.
+    *
+    * Every loaded chunk is given the first tier whose distance covers the gap between its
+    * bounds and the nearest player, and entities take the tier of the chunk they are in.
+    * Tiers are only recomputed when a player crosses a chunk boundary or an entity enters
+    * another chunk, so a tick costs nothing for things that are not due.
+    *
+    * A tier with an interval of N splits its members into N time slices and runs one slice
+    * per tick, so far entities are spread evenly over ticks instead of all updating together.
+    * Members are assigned to the smallest slice when they join the tier.
+    *
+    * Callbacks receive the time since the member was last simulated, which is the tier
+    * interval times the tick length in steady state but also covers tier changes and the
+    * first update after joining. Integrators should use it instead of the fixed tick length.
+    */
+    class SimulationLod {
+    public:
+        typedef u32 EntityID;
+        /*! @param dt: Seconds since the entity was last updated.
+        */
+        typedef std::function<void(EntityID id, f32 dt)> EntityFunc;
+        /*! @param ticks: Ticks since the chunk was last random-ticked, to scale the number of random ticks.
+        */
+        typedef std::function<void(const i32v3& chunkPos, u32 ticks)> ChunkFunc;
+
+        /*! @param tickLength: Seconds per tick.
+        */
+        SimulationLod(f32 tickLength);
+
+        /*! @brief Replaces the tiers. Default tiers are 64, 128 and 256 voxels at intervals 1, 2
+        * and 4, then everything else at interval 8.
+        *
+        * @param tiers: Sorted by increasing distance, at most 254 of them.
+        */
+        void setTiers(const std::vector<SimulationTier>& tiers);
+        /*! @brief Sets the positions of all players.
+        */
+        void setPlayers(const std::vector<f32v3>& positions);
+
+        /*! @brief Adds or moves an entity.
+        */
+        void setEntity(EntityID id, UNIT_SPACE(VOXEL) const f32v3& position);
+        void removeEntity(EntityID id);
+        /*! @brief Starts random-ticking a chunk.
+        */
+        void addChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        void removeChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @brief Advances one tick and simulates the entities and chunks that are due.
+        *
+        * Entities and chunks must not be added or removed from within the callbacks.
+        */
+        void update(const EntityFunc& updateEntity, const ChunkFunc& tickChunk);
+
+        /*! @return Tier index of an entity, or SIMULATION_TIER_NONE.
+        */
+        u8 getEntityTier(EntityID id) const;
+        u8 getChunkTier(UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+        u64 getTick() const {
+            return m_tick;
+        }
+        /*! @brief Entities and chunks simulated during the last update().
+        */
+        size_t getLastUpdateCount() const {
+            return m_lastUpdateCount;
+        }
+        /*! @brief Chunks whose tier is cached for the current player positions.
+        */
+        size_t getCachedTierCount() const {
+            return m_tierCache.size();
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(SimulationLod);
+
+        /// Where one entity or chunk sits in the time slices
+        struct Member {
+            u8 tier;
+            u32 slice;
+            u32 slot; ///< Index within the slice
+            u64 nextTick; ///< First tick not yet simulated
+        };
+        /// Time slices of one kind of member, indexed by a dense key
+        struct Schedule {
+            std::vector<Member> members;
+            std::vector<std::vector<std::vector<u32> > > slices; ///< Per tier, per slice, keys
+
+            /// Empties the slices for a new set of tiers, leaving every member unassigned
+            void reset(const std::vector<SimulationTier>& tiers);
+            /// Adds a member that was not in the schedule, starting its time at tick
+            void add(u32 key, u64 tick);
+            /// Moves a member into a tier, into the slice with the fewest members
+            void assign(u32 key, u8 tier);
+            /// Takes a member out of its slice, it stays known but is not simulated
+            void unassign(u32 key);
+        };
+
+        /// Tier of a chunk given the current players
+        u8 computeTier(const i32v3& chunkPos) const;
+        u8 getCachedTier(const i32v3& chunkPos);
+        void reclassify();
+
+        f32 m_tickLength;
+        u64 m_tick = 0;
+        std::vector<SimulationTier> m_tiers;
+        std::vector<f32v3> m_players;
+        std::vector<i32v3> m_playerChunks;
+        bool m_playersMoved = false; ///< A player entered another chunk since the last update
+        std::unordered_map<i32v3, u8, PositionHash> m_tierCache; ///< Tier of chunks around entities
+        Schedule m_entities;
+        std::vector<i32v3> m_entityChunks; ///< Indexed by EntityID
+        std::vector<u8> m_entityPresent;
+        Schedule m_chunks;
+        std::unordered_map<i32v3, u32, PositionHash> m_chunkKeys;
+        std::vector<i32v3> m_chunkPositions; ///< Indexed by chunk key
+        std::vector<u32> m_freeChunkKeys;
+        size_t m_lastUpdateCount = 0;
+    };
+}
@@ -0,0 +1,163 @@
+//
+// TickDriver.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TickDriver.h
+* @brief Runs server subsystems at a fixed tick rate and sheds load when ticks run long.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../Events.hpp"
+#include "../Types.h"
+
+#define DEFAULT_TICK_RATE 20.0f
+#define TICK_MAX_CATCH_UP 5 ///< Late ticks run back to back before the driver drops the backlog
+
+namespace openvox {
+    class Window;
+
+    /*! @brief How much work subsystems should do this tick. Raised by the driver when ticks run long.
+    */
+    struct TickDegradation {
+        f32 chunkGenerationScale = 1.0f; ///< Fraction of the chunk generation budget to use, 0 defers it
+        f32 randomTickScale = 1.0f; ///< Fraction of random block ticks to run
+        u32 distantEntityInterval = 1; ///< Distant entities update every this many ticks
+    };
+
+    /*! @brief Passed to every subsystem each tick.
+    */
+    struct TickContext {
+        u64 tick; ///< Index of this tick, starting at 0
+        f32 dt; ///< Seconds per tick
+        u32 degradationLevel; ///< Index into the policy, 0 when not degraded
+        TickDegradation degradation;
+    };
+
+    struct TickSubsystemStats {
+        std::string name;
+        f32 budget; ///< Seconds this subsystem may take per tick
+        f32 lastTime; ///< Seconds taken by the last tick
+        f32 averageTime; ///< Exponential moving average of the time taken
+        f32 maxTime; ///< Longest time taken since resetStats()
+        u64 overBudgetTicks; ///< Ticks in which the subsystem exceeded its budget
+    };
+
+    struct TickStats {
+        u64 ticks; ///< Ticks run since resetStats()
+        u64 lateTicks; ///< Ticks that took longer than the tick interval
+        u64 droppedTicks; ///< Ticks skipped because the driver fell too far behind
+        f32 lastTickTime; ///< Seconds of work in the last tick
+        f32 averageTickTime; ///< Exponential moving average of the work per tick
+        f32 maxTickTime;
+        f32 ticksPerSecond; ///< Measured over the last second of run()
+        u32 degradationLevel;
+        u32 degradationChanges; ///< Times the level went up or down
+    };
+
+    /*! @brief Drives the dedicated server simulation at a fixed rate.
+    *
+    * Subsystems run in the order they were added, each timed against its own budget. The
+    * whole tick is compared against the load threshold of the tick interval: going over it
+    * steps the degradation policy up one level, and staying under the recovery threshold for
+    * a number of ticks steps it back down, so a load spike sheds work within a tick but
+    * recovery waits for the spike to pass. Subsystems read the current TickDegradation from
+    * their TickContext and scale their own work with it.
+    *
+    * The default policy first defers chunk generation, then halves random ticks, then
+    * updates distant entities every other tick, then every fourth tick with a quarter of the
+    * random ticks.
+    *
+    * run() sleeps between ticks and catches up at most TICK_MAX_CATCH_UP late ticks; ticks
+    * further behind are dropped rather than letting the server spiral. The loop can also be
+    * driven externally by calling tick() directly.
+    */
+    class TickDriver {
+    public:
+        typedef std::function<void(const TickContext& context)> TickFunc;
+
+        /*! @param tickRate: Ticks per second.
+        */
+        TickDriver(f32 tickRate = DEFAULT_TICK_RATE);
+
+        /*! @brief Adds a subsystem run every tick, after the ones already added.
+        *
+        * @param budget: Seconds the subsystem is expected to take. Only used for statistics.
+        * @return Index of the subsystem in getSubsystemStats().
+        */
+        size_t addSubsystem(const char* name, f32 budget, TickFunc func);
+
+        /*! @brief Replaces the degradation policy.
+        *
+        * @param levels: Degradation per level, level 0 being the first entry, usually no degradation.
+        */
+        void setPolicy(const std::vector<TickDegradation>& levels);
+        /*! @param overload: Fraction of the tick interval above which the policy steps up.
+        * @param recover: Fraction of the tick interval below which the policy may step down.
+        * @param recoverTicks: Consecutive ticks under recover needed to step down one level.
+        */
+        void setThresholds(f32 overload, f32 recover, u32 recoverTicks);
+        void setTickRate(f32 tickRate);
+
+        /*! @brief Runs one tick immediately.
+        */
+        void tick();
+        /*! @brief Runs ticks at the tick rate until stop() is called or the window wants to quit.
+        *
+        * @param window: Optional window, may be headless, whose quit signal ends the loop.
+        */
+        void run(OPT const Window* window = nullptr);
+        /*! @brief Ends run() after the current tick. Safe to call from any thread.
+        */
+        void stop() {
+            m_running = false;
+        }
+
+        const TickStats& getStats() const {
+            return m_stats;
+        }
+        const std::vector<TickSubsystemStats>& getSubsystemStats() const {
+            return m_subsystemStats;
+        }
+        void resetStats();
+        /*! @brief Appends the statistics in Prometheus text format, e.g. for a metrics endpoint.
+        */
+        void exportStats(OUT std::string& out) const;
+
+        f32 getTickRate() const {
+            return m_tickRate;
+        }
+        u64 getTickCount() const {
+            return m_tickCount;
+        }
+        u32 getDegradationLevel() const {
+            return m_level;
+        }
+
+        Event<const TickStats&> onTick; ///< Sent after every tick
+
+    private:
+        OPENVOX_NON_COPYABLE(TickDriver);
+
+        std::vector<TickFunc> m_subsystems;
+        std::vector<TickSubsystemStats> m_subsystemStats;
+        std::vector<TickDegradation> m_policy;
+        f32 m_tickRate;
+        f32 m_overload = 0.9f;
+        f32 m_recover = 0.6f;
+        u32 m_recoverTicks = 40;
+        u32 m_level = 0;
+        u32 m_ticksUnder = 0; ///< Consecutive ticks under the recovery threshold
+        u64 m_tickCount = 0;
+        TickStats m_stats;
+        std::atomic<bool> m_running;
+    };
+}
@@ -0,0 +1,149 @@
+//
+// BlockRegistry.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file BlockRegistry.h
+* @brief Block type definitions, baked into flat tables for per voxel lookups.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../Decorators.h"
+#include "VoxelSpace.hpp"
+
+#define BLOCK_FLAG_COUNT 3
+#define BLOCK_NONE 0xFFFF ///< BlockID returned for names that are not registered
+
+namespace openvox {
+    /*! @brief Boolean block properties, stored as one bitset each.
+    */
+    enum class BlockFlag {
+        OPAQUE, ///< Hides the faces of neighbors and stops light
+        SOLID, ///< Collides with entities
+        REPLACEABLE ///< Gives way to placed blocks and fluids, like tall grass
+    };
+
+    inline u8 getBlockFlagBit(BlockFlag flag) {
+        return (u8)(1 << (int)flag);
+    }
+
+    /*! @brief Mesh pass a block is drawn in.
+    */
+    enum class BlockRenderLayer : u8 {
+        NONE, ///< Not drawn
+        OPAQUE,
+        CUTOUT, ///< Alpha tested, like leaves
+        TRANSLUCENT ///< Blended, like glass and water
+    };
+
+    /*! @brief Properties of a block type, as written by content.
+    */
+    struct BlockDefinition {
+        std::string name;
+        u8 flags = getBlockFlagBit(BlockFlag::OPAQUE) | getBlockFlagBit(BlockFlag::SOLID); ///< getBlockFlagBit() of each BlockFlag ORed together
+        u8 lightEmission = 0; ///< 0 to 15
+        BlockRenderLayer renderLayer = BlockRenderLayer::OPAQUE;
+        u16 textures[VOXEL_FACE_COUNT] = {}; ///< Texture index of each face, in VoxelFace order
+    };
+
+    /*! @brief Registry of every block type, with properties baked into structure of arrays tables.
+    *
+    * Blocks are registered during startup, then freeze() bakes them: each BlockFlag becomes a
+    * bitset over BlockIDs, and light emission, render layer and face textures each become a
+    * dense array indexed by BlockID. Meshing, physics and lighting then read one bit or one
+    * array element per voxel, with no lookups through definitions.
+    *
+    * Registration is not thread safe and must finish before freeze(). A frozen registry never
+    * changes, so any number of threads can read it without locks.
+    *
+    * save() writes the baked tables to a blob that load() restores without re-registering,
+    * so startup can skip parsing block content when it has not changed.
+    *
+    * BLOCK_AIR is registered by the constructor as "air": not opaque, not solid, replaceable
+    * and not drawn.
+    */
+    class BlockRegistry {
+    public:
+        BlockRegistry();
+
+        /*! @brief Adds a block type.
+        *
+        * @return Its BlockID, in registration order, or the existing ID if the name is taken.
+        */
+        BlockID registerBlock(const BlockDefinition& definition);
+        /*! @brief Bakes the tables. Blocks can no longer be registered.
+        */
+        void freeze();
+        bool isFrozen() const {
+            return m_frozen.load(std::memory_order_acquire);
+        }
+
+        /*! @brief Gets a BlockID by name, or BLOCK_NONE if no block has it.
+        */
+        BlockID getID(const std::string& name) const;
+        /*! @pre id < getBlockCount()
+        */
+        const BlockDefinition& getDefinition(BlockID id) const {
+            return m_definitions[id];
+        }
+        size_t getBlockCount() const {
+            return m_definitions.size();
+        }
+
+        // Baked tables, valid once frozen. Every id must be below getBlockCount().
+        bool hasFlag(BlockID id, BlockFlag flag) const {
+            return (m_flags[(int)flag][id >> 6] >> (id & 63)) & 1;
+        }
+        bool isOpaque(BlockID id) const {
+            return hasFlag(id, BlockFlag::OPAQUE);
+        }
+        bool isSolid(BlockID id) const {
+            return hasFlag(id, BlockFlag::SOLID);
+        }
+        u8 getLightEmission(BlockID id) const {
+            return m_lightEmission[id];
+        }
+        BlockRenderLayer getRenderLayer(BlockID id) const {
+            return m_renderLayers[id];
+        }
+        u16 getTexture(BlockID id, VoxelFace face) const {
+            return m_textures[id * VOXEL_FACE_COUNT + (int)face];
+        }
+        /*! @brief Gets the bitset of a flag, bit id & 63 of word id >> 6, for bulk tests.
+        */
+        const u64* getFlagBits(BlockFlag flag) const {
+            return m_flags[(int)flag].data();
+        }
+
+        /*! @brief Appends the frozen registry to out.
+        */
+        void save(OUT std::vector<u8>& out) const;
+        /*! @brief Replaces the registered blocks with a blob from save() and freezes, instead of
+        * registering them one by one. Must be called before freeze().
+        *
+        * @return False if the blob is malformed or holds values out of range, such as a light
+        * emission above 15 or a first block other than air, leaving the registry unchanged.
+        */
+        bool load(const u8* data, size_t size);
+
+    private:
+        OPENVOX_NON_COPYABLE(BlockRegistry);
+
+        std::vector<BlockDefinition> m_definitions;
+        std::unordered_map<std::string, BlockID> m_ids;
+        std::atomic<bool> m_frozen;
+
+        std::vector<u64> m_flags[BLOCK_FLAG_COUNT]; ///< Bitset of each BlockFlag over BlockIDs
+        std::vector<u8> m_lightEmission;
+        std::vector<BlockRenderLayer> m_renderLayers;
+        std::vector<u16> m_textures; ///< VOXEL_FACE_COUNT per block
+    };
+}
@@ -0,0 +1,161 @@
+//
+// Chunk.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file Chunk.h
+* @brief A fixed size cube of voxels.
+*/
+
+#pragma once
+
+#include <atomic>
+
+#include "../Decorators.h"
+#include "ChunkOccupancy.h"
+#include "VoxelSpace.hpp"
+
+namespace openvox {
+    /*! @brief Voxels of a chunk, shared by the chunk and the snapshots taken of it.
+    *
+    * Reference counted. References other than the chunk's own are read only.
+    */
+    class ChunkData {
+    public:
+        BlockID blocks[CHUNK_SIZE];
+        ChunkOccupancy occupancy; ///< Solid bits of blocks
+
+        /*! @brief Adds a reference that keeps this version of the voxels unchanged.
+        */
+        const ChunkData* acquire() const {
+            m_refs.fetch_add(1, std::memory_order_relaxed);
+            return this;
+        }
+        /*! @brief Drops a reference, freeing the data after the last one.
+        */
+        void release() const {
+            if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+        }
+        bool isShared() const {
+            // Acquire so reads through a reference dropped on another thread are finished
+            return m_refs.load(std::memory_order_acquire) > 1;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(ChunkData);
+        friend class Chunk;
+
+        ChunkData() : m_refs(1) {}
+
+        mutable std::atomic<u32> m_refs;
+    };
+
+    /*! @brief Dense storage for CHUNK_SIZE voxels.
+    *
+    * Chunks are owned by a ChunkMap and addressed by their position in chunk space.
+    *
+    * The voxels are copy-on-write: while a snapshot holds a reference to them, the first
+    * write clones them so the snapshot keeps the old version. Writes to unshared chunks cost
+    * one extra load.
+    */
+    class Chunk {
+    public:
+        /*! @brief Creates a chunk filled with BLOCK_AIR.
+        *
+        * @param chunkPos: Position of the chunk in chunk space.
+        */
+        Chunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        ~Chunk();
+
+        /*! @brief Fills the whole chunk with one block type.
+        */
+        void fill(BlockID id);
+
+        BlockID getBlock(int index) const {
+            return m_data->blocks[index];
+        }
+        BlockID getBlock(int x, int y, int z) const {
+            return m_data->blocks[getVoxelIndex(x, y, z)];
+        }
+        BlockID getBlock(const i32v3& localPos) const {
+            return m_data->blocks[getVoxelIndex(localPos)];
+        }
+        void setBlock(int index, BlockID id) {
+            getMutableBlockData()[index] = id;
+            m_data->occupancy.set(index, id != BLOCK_AIR);
+        }
+        void setBlock(int x, int y, int z, BlockID id) {
+            setBlock(getVoxelIndex(x, y, z), id);
+        }
+        void setBlock(const i32v3& localPos, BlockID id) {
+            setBlock(getVoxelIndex(localPos), id);
+        }
+
+        /*! @brief Direct access to voxel storage, indexed with getVoxelIndex().
+        */
+        const BlockID* getBlockData() const {
+            return m_data->blocks;
+        }
+        /*! @brief Direct access to voxel storage for writing. Clones the voxels if a snapshot
+        * shares them, so only call it to write, and call updateOccupancy() after writing.
+        */
+        BlockID* getMutableBlockData() {
+            if (m_data->isShared()) unshare();
+            return m_data->blocks;
+        }
+        /*! @brief Rebuilds the occupancy of the whole chunk after writes through getMutableBlockData().
+        */
+        void updateOccupancy() {
+            m_data->occupancy.build(m_data->blocks);
+        }
+        /*! @brief Rebuilds the occupancy of a box after writes inside it through getMutableBlockData().
+        *
+        * @param max: Inclusive.
+        */
+        void updateOccupancy(const i32v3& min, const i32v3& max) {
+            m_data->occupancy.update(m_data->blocks, min, max);
+        }
+        /*! @brief Solid bits of the voxels, kept up to date with the blocks.
+        */
+        const ChunkOccupancy& getOccupancy() const {
+            return m_data->occupancy;
+        }
+        /*! @brief Current version of the voxels, to acquire() for a snapshot.
+        */
+        const ChunkData* getData() const {
+            return m_data;
+        }
+
+        /*! @brief Gets a loaded chunk of the 3x3x3 neighborhood, kept up to date by the ChunkMap.
+        *
+        * @param index: See getNeighborIndex(). CHUNK_NEIGHBOR_CENTER is this chunk.
+        * @return The chunk, or nullptr if it is not loaded.
+        */
+        Chunk* getNeighbor(int index) const {
+            return m_neighbors[index];
+        }
+        Chunk* getNeighbor(int dx, int dy, int dz) const {
+            return m_neighbors[getNeighborIndex(dx, dy, dz)];
+        }
+
+        UNIT_SPACE(CHUNK) const i32v3& getChunkPosition() const {
+            return m_chunkPosition;
+        }
+        UNIT_SPACE(VOXEL) i32v3 getVoxelPosition() const {
+            return toVoxelPosition(m_chunkPosition);
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(Chunk);
+        friend class ChunkMap;
+
+        /// Replaces shared voxels with a private copy
+        void unshare();
+
+        i32v3 m_chunkPosition; ///< Position in chunk space.
+        ChunkData* m_data; ///< Voxel data, see getVoxelIndex().
+        Chunk* m_neighbors[CHUNK_NEIGHBOR_COUNT]; ///< Loaded chunks around this one, see getNeighborIndex().
+    };
+}
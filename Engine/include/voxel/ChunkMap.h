@@ -0,0 +1,71 @@
+//
+// ChunkMap.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file ChunkMap.h
+* @brief Owns all loaded chunks and maps chunk positions to them.
+*/
+
+#pragma once
+
+#include <unordered_map>
+
+#include "Chunk.h"
+
+namespace openvox {
+    class ChunkMap {
+    public:
+        typedef std::unordered_map<i32v3, Chunk*, PositionHash> ChunkTable;
+
+        ChunkMap() {}
+        ~ChunkMap();
+
+        /*! @brief Gets a loaded chunk.
+        *
+        * @param chunkPos: Position of the chunk in chunk space.
+        * @return The chunk, or nullptr if it is not loaded.
+        */
+        Chunk* getChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos) const;
+        /*! @brief Creates an empty chunk at a position.
+        *
+        * @param chunkPos: Position of the chunk in chunk space.
+        * @return The new chunk, or the existing chunk if one is already loaded there.
+        */
+        Chunk* createChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        /*! @brief Frees a chunk.
+        *
+        * @return False if no chunk was loaded at chunkPos.
+        */
+        bool destroyChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+        /*! @brief Frees all chunks.
+        */
+        void dispose();
+
+        /*! @brief Gets a block by world position.
+        *
+        * @param voxelPos: Position of the voxel in world space.
+        * @param unloaded: Value returned when the containing chunk is not loaded.
+        */
+        BlockID getBlock(UNIT_SPACE(VOXEL) const i32v3& voxelPos, BlockID unloaded = BLOCK_AIR) const;
+        /*! @brief Sets a block by world position.
+        *
+        * @return False if the containing chunk is not loaded.
+        */
+        bool setBlock(UNIT_SPACE(VOXEL) const i32v3& voxelPos, BlockID id);
+
+        size_t getChunkCount() const {
+            return m_chunks.size();
+        }
+        const ChunkTable& getChunks() const {
+            return m_chunks;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(ChunkMap);
+
+        ChunkTable m_chunks; ///< All loaded chunks keyed by chunk position.
+    };
+}
@@ -0,0 +1,137 @@
+//
+// ChunkOccupancy.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file ChunkOccupancy.h
+* @brief One bit per voxel of a chunk telling if it is solid, for 64 voxel wide queries.
+*/
+
+#pragma once
+
+#include "../Decorators.h"
+#include "../math/BitMath.hpp"
+#include "VoxelSpace.hpp"
+
+#define OCCUPANCY_WORD_COUNT (CHUNK_SIZE / 64) ///< u64 words in the mask of a chunk
+#define OCCUPANCY_ROW_WORDS (CHUNK_WIDTH / 2) ///< Words per Z row, each holding two X columns
+#define OCCUPANCY_LANE_BOTTOM 0x0000000100000001ull ///< Y = 0 bit of both columns of a word
+#define OCCUPANCY_LANE_TOP 0x8000000080000000ull ///< Y = CHUNK_WIDTH - 1 bit of both columns of a word
+
+namespace openvox {
+    static_assert(CHUNK_WIDTH == 32, "ChunkOccupancy packs two 32 voxel columns per word");
+
+    /*! @brief Occupancy bitmask of a chunk, derived from its blocks.
+    *
+    * A voxel is solid when it is not BLOCK_AIR. The mask is column major: each u64 word holds
+    * the Y columns of two neighboring X positions, X even in the low 32 bits and X odd in the
+    * high 32 bits, with bit Y of each half for the voxel at height Y. Words run X fastest then
+    * Z, see getWordIndex(). A neighbor query is then one shift or one word load for 64 voxels,
+    * and counts and scans are popCount() and bitScanForward() on whole words.
+    */
+    class ChunkOccupancy {
+    public:
+        /*! @brief Creates an empty mask.
+        */
+        ChunkOccupancy() {
+            fill(false);
+        }
+
+        /*! @brief Rebuilds the whole mask from blocks indexed with getVoxelIndex().
+        */
+        void build(const BlockID* blocks);
+        /*! @brief Rebuilds the bits of a box after writes inside it.
+        *
+        * @param min: Minimum local corner.
+        * @param max: Inclusive maximum local corner.
+        */
+        void update(const BlockID* blocks, const i32v3& min, const i32v3& max);
+        void fill(bool solid);
+
+        bool isSolid(int index) const {
+            return (m_words[getWordIndex(index)] >> getBit(index)) & 1;
+        }
+        bool isSolid(int x, int y, int z) const {
+            return isSolid(getVoxelIndex(x, y, z));
+        }
+        void set(int index, bool solid) {
+            u64 bit = 1ull << getBit(index);
+            u64& word = m_words[getWordIndex(index)];
+            word = solid ? word | bit : word & ~bit;
+        }
+
+        /*! @brief Gets the Y column at a local X and Z, bit Y set for solid voxels.
+        */
+        u32 getColumn(int x, int z) const {
+            return (u32)(m_words[getWordIndex(x, z)] >> ((x & 1) * 32));
+        }
+        const u64* getWords() const {
+            return m_words;
+        }
+        /*! @brief Gets the solid bits of the voxels one step across a face from each bit of a word.
+        *
+        * @param neighbor: Occupancy of the chunk across that face, or nullptr to treat it as empty.
+        */
+        u64 getNeighborWord(int word, VoxelFace face, OPT const ChunkOccupancy* neighbor) const;
+        /*! @brief Finds the solid voxels whose neighbor across a face is empty, 64 at a time.
+        *
+        * @param neighbor: Occupancy of the chunk across that face, or nullptr to treat it as empty.
+        * @param faces: Receives OCCUPANCY_WORD_COUNT words laid out like the mask.
+        * @return Number of visible faces.
+        */
+        u32 getVisibleFaces(VoxelFace face, OPT const ChunkOccupancy* neighbor, OUT u64* faces) const;
+
+        /*! @brief Counts the solid voxels.
+        */
+        u32 getCount() const;
+        bool isEmpty() const;
+        bool isFull() const;
+        /*! @brief Gets the Y of the highest solid voxel in a column, or -1 if it has none.
+        */
+        int getHighest(int x, int z) const {
+            u32 column = getColumn(x, z);
+            return column ? (int)math::bitScanReverse(column) : -1;
+        }
+        /*! @brief Gets the Y of the lowest solid voxel at or above y in a column, or -1 if none.
+        */
+        int findSolidAbove(int x, int y, int z) const {
+            u32 column = getColumn(x, z) >> y << y;
+            return column ? (int)math::bitScanForward(column) : -1;
+        }
+
+        /*! @brief Calls f(index) with the getVoxelIndex() of every set bit of a mask, in word order.
+        */
+        template<typename F>
+        static void forEachVoxel(const u64* words, F f) {
+            for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) {
+                u64 bits = words[w];
+                // Both columns share Z and differ in X by the lane
+                int base = (w & ~(OCCUPANCY_ROW_WORDS - 1)) << 1 | (w & (OCCUPANCY_ROW_WORDS - 1)) << 1;
+                while (bits) {
+                    u32 bit = math::bitScanForward(bits);
+                    bits &= bits - 1;
+                    f((int)((bit & CHUNK_MASK) << (CHUNK_WIDTH_BITS * 2)) | base | (int)(bit >> CHUNK_WIDTH_BITS));
+                }
+            }
+        }
+
+        static int getWordIndex(int x, int z) {
+            return z * OCCUPANCY_ROW_WORDS + (x >> 1);
+        }
+        /*! @brief Gets the word holding a voxel from its getVoxelIndex().
+        */
+        static int getWordIndex(int index) {
+            return (index & (CHUNK_LAYER - 1)) >> 1;
+        }
+        /*! @brief Gets the bit of a voxel in its word from its getVoxelIndex().
+        */
+        static u32 getBit(int index) {
+            return (u32)((index & 1) << CHUNK_WIDTH_BITS | index >> (CHUNK_WIDTH_BITS * 2));
+        }
+
+    private:
+        u64 m_words[OCCUPANCY_WORD_COUNT];
+    };
+}
@@ -0,0 +1,139 @@
+//
+// EditHistory.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file EditHistory.h
+* @brief Undo and redo of editor operations, stored as compressed voxel diffs.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ChunkMap.h"
+
+#define DEFAULT_HISTORY_MEMORY_LIMIT (64 * 1024 * 1024) ///< Bytes of diffs kept in memory
+
+namespace openvox {
+    /*! @brief Voxels of one chunk changed by undo() or redo().
+    */
+    struct EditHistoryChange {
+        i32v3 chunkPos;
+        i32v3 min; ///< Minimum corner of the changed voxels, local to the chunk
+        i32v3 max; ///< Inclusive
+        size_t voxelCount;
+    };
+
+    /*! @brief Stack of reversible operations on a ChunkMap.
+    *
+    * An operation starts by taking a copy-on-write reference to the voxels of every chunk it
+    * touches, see WorldSnapshot, so recording costs nothing until the chunk is written. When
+    * the operation ends each chunk is compared with its old version and only the changed
+    * voxels are kept: runs of consecutive voxels that changed from the same old block to
+    * the same new block, each a gap, a length and an index into a palette of old and new
+    * pairs. A fill over uniform terrain takes a few bytes per chunk row instead of a chunk
+    * copy.
+    *
+    * Operations nest, so a tool can group many edits into one undo step. VoxelEditor records
+    * every edit it makes into its history as its own operation unless a group is open.
+    *
+    * Diffs are kept in memory up to a limit. Beyond it the oldest operations are spilled to a
+    * file when a spill directory is set, or forgotten otherwise. Voxels of chunks that are not
+    * loaded when an operation is undone or redone are skipped.
+    */
+    class EditHistory {
+    public:
+        /*! @param spillDirectory: Directory of the spill file, empty to drop the oldest
+        * operations instead.
+        */
+        EditHistory(ChunkMap* chunkMap, size_t memoryLimit = DEFAULT_HISTORY_MEMORY_LIMIT,
+                    const std::string& spillDirectory = "");
+        ~EditHistory();
+
+        /*! @brief Opens an operation, or a group inside the open one.
+        */
+        void beginOperation();
+        /*! @brief Closes the innermost operation. Closing the outermost one pushes it onto the
+        * undo stack if it changed anything, and clears the redo stack.
+        */
+        void endOperation();
+        /*! @brief Adds a chunk to the open operation. Must be called before the chunk is first
+        * written in the operation.
+        */
+        OPENVOX_INTERNAL void recordChunk(const Chunk& chunk);
+
+        /*! @brief Reverts the last operation.
+        *
+        * @param changes: Receives the changed voxels of every chunk written.
+        * @return Number of voxels changed, 0 if there is nothing to undo or an operation is open.
+        */
+        size_t undo(OUT std::vector<EditHistoryChange>& changes);
+        /*! @brief Applies the last undone operation again.
+        */
+        size_t redo(OUT std::vector<EditHistoryChange>& changes);
+        void clear();
+
+        void setMemoryLimit(size_t memoryLimit);
+        bool isRecording() const {
+            return m_depth > 0;
+        }
+        size_t getUndoCount() const {
+            return m_undo.size();
+        }
+        size_t getRedoCount() const {
+            return m_redo.size();
+        }
+        /*! @brief Bytes of diffs held in memory.
+        */
+        size_t getMemoryUsage() const {
+            return m_memoryUsage;
+        }
+        /*! @brief Bytes of diffs spilled to disk.
+        */
+        u64 getSpilledSize() const {
+            return m_spillEnd;
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(EditHistory);
+
+        struct Operation {
+            std::vector<u8> data; ///< Encoded chunk diffs, empty while spilled
+            u64 spillOffset;
+            u32 spillSize; ///< 0 if the operation is in memory
+            size_t voxelCount;
+        };
+
+        /// Diffs every recorded chunk against its current voxels into data
+        size_t encode(OUT std::vector<u8>& data);
+        /// Writes the old or new values of an operation
+        size_t apply(Operation& op, bool undo, OUT std::vector<EditHistoryChange>& changes);
+        /// Reads a spilled operation back into memory
+        bool load(Operation& op);
+        /// Spills or drops the oldest operations until the memory limit is met
+        void enforceLimit();
+        void discard(Operation& op);
+
+        ChunkMap* m_chunkMap;
+        size_t m_memoryLimit;
+        std::string m_spillPath;
+        FILE* m_spillFile = nullptr;
+        u64 m_spillEnd = 0; ///< Bytes of the spill file in use
+        size_t m_spilledCount = 0;
+
+        u32 m_depth = 0;
+        std::unordered_map<i32v3, const ChunkData*, PositionHash> m_recorded; ///< Old voxels of the open operation
+        std::deque<Operation> m_undo; ///< Oldest first
+        std::vector<Operation> m_redo; ///< Next to redo last
+        size_t m_memoryUsage = 0;
+        std::vector<u16> m_pairs; ///< Old and new value pairs of the chunk being encoded
+        std::unordered_map<u32, u32> m_pairIndex;
+    };
+}
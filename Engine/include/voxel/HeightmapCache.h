@@ -0,0 +1,143 @@
+//
+// HeightmapCache.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file HeightmapCache.h
+* @brief Keeps the highest block of each voxel column so it never has to be searched for.
+*/
+
+#pragma once
+
+#include <climits>
+#include <unordered_map>
+#include <vector>
+
+#include "ChunkMap.h"
+#include "VoxelEditor.h"
+
+#define HEIGHTMAP_KIND_COUNT 3
+#define HEIGHTMAP_MASK_ALL ((1 << HEIGHTMAP_KIND_COUNT) - 1) ///< Block counts for every kind of heightmap
+#define HEIGHTMAP_NONE INT_MIN ///< Height of a column that has no matching block in any loaded chunk
+
+namespace openvox {
+    /*! @brief Which blocks a heightmap tracks.
+    */
+    enum class HeightmapKind {
+        MOTION_BLOCKING, ///< Blocks that stop movement or hold fluid, used for spawning and weather
+        OPAQUE, ///< Blocks that stop light, used for sunlight seeding and sky exposure
+        SURFACE ///< Any block that is not air, used for AO and features
+    };
+
+    inline u8 getHeightmapBit(HeightmapKind kind) {
+        return (u8)(1 << (int)kind);
+    }
+
+    /*! @brief Per chunk column heightmaps of several kinds, stored as packed u16 arrays.
+    *
+    * A chunk column is every chunk with the same chunk X and Z. Each kind keeps CHUNK_LAYER
+    * heights per column, X fastest then Z, as world Y minus the minimum world Y plus one, so 0
+    * means no matching block. Heights cover the loaded chunks of a column: adding a chunk
+    * raises them, and edits or removing a chunk lower them by scanning down from the change
+    * through loaded chunks.
+    *
+    * Which kinds a block counts for is set per BlockID. By default every block other than
+    * BLOCK_AIR counts for all of them.
+    */
+    class HeightmapCache {
+    public:
+        /*! @param minY: Lowest world Y a block can have. Heights up to minY + 65534 fit.
+        */
+        HeightmapCache(ChunkMap* chunkMap, i32 minY = -32768);
+        ~HeightmapCache();
+
+        /*! @brief Sets which heightmaps a block counts for.
+        *
+        * Must be set before chunks are added, since existing heights are not rescanned.
+        * @param kindMask: getHeightmapBit() of each kind ORed together.
+        */
+        void setBlockKinds(BlockID id, u8 kindMask);
+
+        /*! @brief Merges a loaded chunk into its column.
+        *
+        * @param heightsKnown: True if the column was restored with loadColumn() and the chunk has
+        * not changed since it was saved, which skips scanning it.
+        */
+        void addChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos, bool heightsKnown = false);
+        /*! @brief Removes an unloading chunk. Call before the ChunkMap destroys it.
+        *
+        * Columns whose height was in the chunk are rescanned below it. The column is freed
+        * once its last chunk is removed.
+        */
+        void removeChunk(UNIT_SPACE(CHUNK) const i32v3& chunkPos);
+
+        /*! @brief Updates heights after a single block changed.
+        */
+        void onBlockChanged(UNIT_SPACE(VOXEL) const i32v3& voxelPos, BlockID oldID, BlockID newID);
+        /*! @brief Updates heights of every column in a box after arbitrary edits inside it.
+        */
+        void updateRegion(UNIT_SPACE(VOXEL) const i32v3& min, UNIT_SPACE(VOXEL) const i32v3& max);
+        /*! @brief Updates heights after a VoxelEditor commit, e.g. from VoxelEditor::onCommit.
+        */
+        void updateRegion(const VoxelEditBatch& batch) {
+            updateRegion(batch.min, batch.max);
+        }
+
+        /*! @brief Gets the world Y of the highest block of a kind in a voxel column.
+        *
+        * @param voxelXZ: World voxel X and Z.
+        * @return The height, or HEIGHTMAP_NONE if no loaded block matches or the column is unknown.
+        */
+        i32 getHeight(HeightmapKind kind, UNIT_SPACE(VOXEL) const i32v2& voxelXZ) const;
+        /*! @brief Checks if a voxel has no opaque block above it.
+        */
+        bool isSkyExposed(UNIT_SPACE(VOXEL) const i32v3& voxelPos) const {
+            return voxelPos.y > getHeight(HeightmapKind::OPAQUE, i32v2(voxelPos.x, voxelPos.z));
+        }
+        /*! @brief Gets the packed heights of a column for bulk reads.
+        *
+        * @return CHUNK_LAYER packed heights, see unpackHeight(), or nullptr if the column is unknown.
+        */
+        const u16* getColumnHeights(HeightmapKind kind, UNIT_SPACE(CHUNK) const i32v2& columnPos) const;
+        i32 unpackHeight(u16 packed) const {
+            return packed ? m_minY + packed - 1 : HEIGHTMAP_NONE;
+        }
+
+        /*! @brief Appends the heightmaps of a column to out, to be stored with its chunks.
+        */
+        void saveColumn(UNIT_SPACE(CHUNK) const i32v2& columnPos, OUT std::vector<u8>& out) const;
+        /*! @brief Restores heightmaps written by saveColumn(), replacing the column's heights.
+        *
+        * Data saved with another minimum Y is rebased. It is rejected if a height falls outside
+        * the range this cache can hold, leaving the column unchanged.
+        * @return Number of bytes read, or 0 if the data is malformed.
+        */
+        size_t loadColumn(UNIT_SPACE(CHUNK) const i32v2& columnPos, const u8* data, size_t size);
+
+        size_t getColumnCount() const {
+            return m_columns.size();
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(HeightmapCache);
+
+        struct Column {
+            u16 heights[HEIGHTMAP_KIND_COUNT][CHUNK_LAYER];
+            i32 minChunkY; ///< Lowest chunk Y added, chunks between may be missing
+            i32 maxChunkY;
+            u32 chunkCount;
+        };
+
+        Column* getColumn(const i32v2& columnPos) const;
+        u16 pack(i32 y) const;
+        /// Finds the highest block of each kind in kindMask at or below startY and writes it.
+        void scanDown(Column& column, const i32v2& columnPos, int layerIndex, i32 startY, u8 kindMask);
+
+        ChunkMap* m_chunkMap;
+        i32 m_minY;
+        std::vector<u8> m_blockKinds; ///< Kind mask of every BlockID
+        std::unordered_map<i32v2, Column*, PositionHash> m_columns;
+    };
+}
@@ -0,0 +1,117 @@
+//
+// VoxelCursor.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file VoxelCursor.h
+* @brief Walks voxel positions across chunks through neighbor links instead of map lookups.
+*/
+
+#pragma once
+
+#include "ChunkMap.h"
+
+#define VOXEL_FACE_NEIGHBORS 6 ///< The first VOXEL_NEIGHBOR_OFFSETS share a face
+#define VOXEL_EDGE_NEIGHBORS 18 ///< The first VOXEL_NEIGHBOR_OFFSETS share a face or an edge
+#define VOXEL_NEIGHBORS 26 ///< Every voxel touching another
+
+namespace openvox {
+    /*! @brief Offsets to the voxels around a voxel: faces in VoxelFace order, then edges, then corners.
+    */
+    constexpr i8 VOXEL_NEIGHBOR_OFFSETS[VOXEL_NEIGHBORS][3] = {
+        { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 },
+        { -1, -1, 0 }, { 1, -1, 0 }, { -1, 1, 0 }, { 1, 1, 0 }, { 0, -1, -1 }, { 0, 1, -1 },
+        { 0, -1, 1 }, { 0, 1, 1 }, { -1, 0, -1 }, { 1, 0, -1 }, { -1, 0, 1 }, { 1, 0, 1 },
+        { -1, -1, -1 }, { 1, -1, -1 }, { -1, 1, -1 }, { 1, 1, -1 },
+        { -1, -1, 1 }, { 1, -1, 1 }, { -1, 1, 1 }, { 1, 1, 1 }
+    };
+    /*! @brief Gets the getVoxelIndex() difference of a VOXEL_NEIGHBOR_OFFSETS entry within one chunk.
+    */
+    constexpr i32 getNeighborIndexOffset(int neighbor) {
+        return VOXEL_NEIGHBOR_OFFSETS[neighbor][1] * CHUNK_LAYER + VOXEL_NEIGHBOR_OFFSETS[neighbor][2] * CHUNK_WIDTH +
+               VOXEL_NEIGHBOR_OFFSETS[neighbor][0];
+    }
+    /*! @brief getNeighborIndexOffset() of every VOXEL_NEIGHBOR_OFFSETS entry.
+    */
+    constexpr i32 VOXEL_NEIGHBOR_INDEX_OFFSETS[VOXEL_NEIGHBORS] = {
+        getNeighborIndexOffset(0), getNeighborIndexOffset(1), getNeighborIndexOffset(2), getNeighborIndexOffset(3),
+        getNeighborIndexOffset(4), getNeighborIndexOffset(5), getNeighborIndexOffset(6), getNeighborIndexOffset(7),
+        getNeighborIndexOffset(8), getNeighborIndexOffset(9), getNeighborIndexOffset(10), getNeighborIndexOffset(11),
+        getNeighborIndexOffset(12), getNeighborIndexOffset(13), getNeighborIndexOffset(14), getNeighborIndexOffset(15),
+        getNeighborIndexOffset(16), getNeighborIndexOffset(17), getNeighborIndexOffset(18), getNeighborIndexOffset(19),
+        getNeighborIndexOffset(20), getNeighborIndexOffset(21), getNeighborIndexOffset(22), getNeighborIndexOffset(23),
+        getNeighborIndexOffset(24), getNeighborIndexOffset(25)
+    };
+
+    /*! @brief A position in the voxel world that remembers its chunk.
+    *
+    * Moving the cursor into an adjacent chunk follows the chunk's neighbor links, and reads
+    * at an offset reach through them too, so only jumps of more than one chunk look up the
+    * ChunkMap. Reads of the VOXEL_NEIGHBOR_OFFSETS of a voxel that is not on the chunk border
+    * are a single load at a constant index offset.
+    *
+    * A cursor caches chunk pointers, so it must not outlive a chunk being unloaded under it.
+    */
+    class VoxelCursor {
+    public:
+        VoxelCursor(const ChunkMap* chunkMap, UNIT_SPACE(VOXEL) const i32v3& voxelPos);
+
+        /*! @brief Moves to any position, through neighbor links when it is in an adjacent chunk.
+        */
+        void setPosition(UNIT_SPACE(VOXEL) const i32v3& voxelPos);
+        void move(const i32v3& offset) {
+            setPosition(m_position + offset);
+        }
+        /*! @brief Moves to one of the VOXEL_NEIGHBOR_OFFSETS.
+        */
+        void moveToNeighbor(int neighbor) {
+            const i8* o = VOXEL_NEIGHBOR_OFFSETS[neighbor];
+            setPosition(m_position + i32v3(o[0], o[1], o[2]));
+        }
+
+        /*! @brief Gets the block under the cursor.
+        *
+        * @param unloaded: Value returned when the chunk is not loaded.
+        */
+        BlockID getBlock(BlockID unloaded = BLOCK_AIR) const {
+            return m_chunk ? m_chunk->getBlock(m_index) : unloaded;
+        }
+        /*! @brief Gets the block at an offset from the cursor.
+        */
+        BlockID getBlock(const i32v3& offset, BlockID unloaded = BLOCK_AIR) const;
+        /*! @brief Gets the block at one of the VOXEL_NEIGHBOR_OFFSETS from the cursor.
+        */
+        BlockID getNeighborBlock(int neighbor, BlockID unloaded = BLOCK_AIR) const {
+            if (m_interior) return m_chunk->getBlock(m_index + VOXEL_NEIGHBOR_INDEX_OFFSETS[neighbor]);
+            const i8* o = VOXEL_NEIGHBOR_OFFSETS[neighbor];
+            return getBlock(i32v3(o[0], o[1], o[2]), unloaded);
+        }
+
+        UNIT_SPACE(VOXEL) const i32v3& getPosition() const {
+            return m_position;
+        }
+        /*! @brief Gets the chunk under the cursor, or nullptr if it is not loaded.
+        */
+        Chunk* getChunk() const {
+            return m_chunk;
+        }
+        /*! @brief Gets the getVoxelIndex() of the cursor in its chunk.
+        */
+        int getIndex() const {
+            return m_index;
+        }
+
+    private:
+        /// Gets a chunk, through the links of the current one when it is adjacent
+        Chunk* findChunk(const i32v3& chunkPos) const;
+
+        const ChunkMap* m_chunkMap;
+        i32v3 m_position;
+        i32v3 m_chunkPos;
+        Chunk* m_chunk;
+        int m_index;
+        bool m_interior; ///< Loaded and not on the chunk border, so every neighbor is in the chunk
+    };
+}
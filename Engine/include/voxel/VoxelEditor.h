@@ -0,0 +1,153 @@
+//
+// VoxelEditor.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file VoxelEditor.h
+* @brief Edits large numbers of voxels chunk by chunk with one change notification.
+*/
+
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include "../Events.hpp"
+#include "ChunkMap.h"
+#include "EditHistory.h"
+
+namespace openvox {
+    /*! @brief Decides which voxels an edit may overwrite.
+    */
+    enum class EditMode {
+        REPLACE, ///< Overwrite every voxel in the shape
+        FILL_AIR, ///< Only write into BLOCK_AIR voxels
+        REPLACE_SOLID ///< Only overwrite voxels that are not BLOCK_AIR
+    };
+
+    /*! @brief Everything that changed between two VoxelEditor::commit() calls.
+    */
+    struct VoxelEditBatch {
+        std::vector<i32v3> chunks; ///< Chunks with changed voxels
+        std::vector<i32v3> borderChunks; ///< Loaded, unchanged chunks touching a changed voxel across a face
+        i32v3 min; ///< Minimum corner of the changed voxels
+        i32v3 max; ///< Maximum corner of the changed voxels, inclusive
+        size_t voxelCount; ///< Number of voxels that changed
+    };
+
+    /*! @brief Applies shape edits to a ChunkMap and reports them in one batch.
+    *
+    * Every operation walks the chunks overlapping its bounds and writes contiguous rows of
+    * each chunk directly. Only voxels whose value actually changes are counted. Voxels in
+    * unloaded chunks are skipped.
+    *
+    * Voxels are written immediately, but listeners of onCommit are only told once, in
+    * commit(), so relighting and remeshing run once per chunk however many edits were made.
+    * All bounds are in world voxel space and inclusive.
+    *
+    * With an EditHistory set, every operation is recorded as one undo step, or as part of
+    * the group the history has open.
+    */
+    class VoxelEditor {
+    public:
+        VoxelEditor(ChunkMap* chunkMap);
+        /*! @brief Commits pending changes.
+        */
+        ~VoxelEditor();
+
+        /*! @return Number of voxels changed.
+        */
+        size_t fillBox(UNIT_SPACE(VOXEL) const i32v3& min, UNIT_SPACE(VOXEL) const i32v3& max, BlockID id,
+                       EditMode mode = EditMode::REPLACE);
+        /*! @brief Fills voxels whose position is within radius of center.
+        *
+        * @return Number of voxels changed.
+        */
+        size_t fillSphere(UNIT_SPACE(VOXEL) const i32v3& center, f32 radius, BlockID id, EditMode mode = EditMode::REPLACE);
+        /*! @brief Fills an upright cylinder.
+        *
+        * @param baseCenter: Center of the bottom layer.
+        * @param height: Number of layers, going up.
+        * @return Number of voxels changed.
+        */
+        size_t fillCylinder(UNIT_SPACE(VOXEL) const i32v3& baseCenter, f32 radius, i32 height, BlockID id,
+                            EditMode mode = EditMode::REPLACE);
+        /*! @brief Copies a box of voxels. Source and destination may overlap.
+        *
+        * @param dstMin: Minimum corner of the destination.
+        * @param skipAir: If true, air in the source leaves the destination unchanged.
+        * @return Number of voxels changed.
+        */
+        size_t copyRegion(UNIT_SPACE(VOXEL) const i32v3& srcMin, UNIT_SPACE(VOXEL) const i32v3& srcMax,
+                          UNIT_SPACE(VOXEL) const i32v3& dstMin, bool skipAir = false);
+        /*! @brief Writes a block wherever a mask is set.
+        *
+        * @param min: Minimum corner of the masked box.
+        * @param size: Size of the box.
+        * @param mask: size.x * size.y * size.z bytes, x fastest then z then y, nonzero where id is written.
+        * @return Number of voxels changed.
+        */
+        size_t applyMask(UNIT_SPACE(VOXEL) const i32v3& min, const i32v3& size, const u8* mask, BlockID id,
+                         EditMode mode = EditMode::REPLACE);
+        /*! @brief Reads a box of voxels, x fastest then z then y.
+        *
+        * @param unloaded: Value read from unloaded chunks.
+        */
+        void readRegion(UNIT_SPACE(VOXEL) const i32v3& min, UNIT_SPACE(VOXEL) const i32v3& max,
+                        OUT std::vector<BlockID>& blocks, BlockID unloaded = BLOCK_AIR) const;
+
+        /*! @brief Records further operations into a history, or stops recording if nullptr.
+        */
+        void setHistory(OPT EditHistory* history) {
+            m_history = history;
+        }
+        /*! @brief Reverts the last operation of the history. Listeners are told in commit().
+        *
+        * @return Number of voxels changed.
+        */
+        size_t undo();
+        /*! @brief Applies the last undone operation of the history again.
+        *
+        * @return Number of voxels changed.
+        */
+        size_t redo();
+
+        /*! @brief Sends onCommit for all changes since the last commit.
+        */
+        void commit();
+
+        bool hasPendingChanges() const {
+            return m_pendingVoxels != 0;
+        }
+
+        Event<const VoxelEditBatch&> onCommit; ///< Sent once per commit() that has changes
+
+    private:
+        OPENVOX_NON_COPYABLE(VoxelEditor);
+
+        /// Changed area of one chunk in local coordinates
+        struct DirtyBounds {
+            i32v3 min;
+            i32v3 max;
+        };
+
+        /*! Calls write(row, x, y, z, count) for every row of every loaded chunk inside [min, max].
+         * span(y, z, x0, x1) may narrow each row to [x0, x1] or return false to skip it. write
+         * returns the number of voxels it changed.
+         */
+        template<typename SpanFunc, typename WriteFunc>
+        size_t editRows(const i32v3& min, const i32v3& max, SpanFunc span, WriteFunc write);
+        void markChanged(const i32v3& chunkPos, const i32v3& localMin, const i32v3& localMax);
+        /// Marks the chunks undo() or redo() wrote
+        size_t markChanges(size_t count);
+
+        ChunkMap* m_chunkMap;
+        std::unordered_map<i32v3, DirtyBounds, PositionHash> m_dirty;
+        size_t m_pendingVoxels = 0;
+        std::vector<BlockID> m_copyBuffer;
+        EditHistory* m_history = nullptr;
+        std::vector<EditHistoryChange> m_historyChanges;
+    };
+}
@@ -0,0 +1,104 @@
+//
+// VoxelSpace.hpp
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file VoxelSpace.hpp
+* @brief Chunk dimensions and conversions between world, chunk and local voxel space.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "../Types.h"
+
+#define CHUNK_WIDTH_BITS 5 ///< log2 of CHUNK_WIDTH
+#define CHUNK_WIDTH 32 ///< Width of a chunk in voxels along every axis
+#define CHUNK_MASK (CHUNK_WIDTH - 1) ///< Mask for a world coordinate to get a local coordinate
+#define CHUNK_LAYER (CHUNK_WIDTH * CHUNK_WIDTH) ///< Number of voxels in one XZ layer of a chunk
+#define CHUNK_SIZE (CHUNK_LAYER * CHUNK_WIDTH) ///< Number of voxels in a chunk
+
+namespace openvox {
+    typedef u16 BlockID; ///< Identifier for a block type stored in a voxel.
+
+#define BLOCK_AIR 0 ///< BlockID that is always empty space
+
+#define VOXEL_FACE_COUNT 6
+
+    /*! @brief Faces of a voxel or chunk, in the order of the TRANSVOXEL_FACE_ flags.
+    */
+    enum class VoxelFace {
+        NEG_X,
+        POS_X,
+        NEG_Y,
+        POS_Y,
+        NEG_Z,
+        POS_Z
+    };
+
+    /*! @brief Gets the position of the chunk that contains a world voxel coordinate.
+    *
+    * Uses arithmetic shifts so negative coordinates floor correctly.
+    */
+    inline i32v3 toChunkPosition(UNIT_SPACE(VOXEL) const i32v3& voxelPos) {
+        return i32v3(voxelPos.x >> CHUNK_WIDTH_BITS, voxelPos.y >> CHUNK_WIDTH_BITS, voxelPos.z >> CHUNK_WIDTH_BITS);
+    }
+    /*! @brief Gets the position of a world voxel coordinate relative to the chunk that contains it.
+    */
+    inline i32v3 toLocalPosition(UNIT_SPACE(VOXEL) const i32v3& voxelPos) {
+        return i32v3(voxelPos.x & CHUNK_MASK, voxelPos.y & CHUNK_MASK, voxelPos.z & CHUNK_MASK);
+    }
+    /*! @brief Gets the world voxel coordinate of the minimum corner of a chunk.
+    */
+    inline i32v3 toVoxelPosition(UNIT_SPACE(CHUNK) const i32v3& chunkPos) {
+        return i32v3(chunkPos.x << CHUNK_WIDTH_BITS, chunkPos.y << CHUNK_WIDTH_BITS, chunkPos.z << CHUNK_WIDTH_BITS);
+    }
+
+    /*! @brief Gets the index of a local voxel in chunk storage.
+    *
+    * Voxels are stored X fastest, then Z, then Y, so an XZ layer is contiguous.
+    */
+    inline int getVoxelIndex(int x, int y, int z) {
+        return (y << (CHUNK_WIDTH_BITS * 2)) | (z << CHUNK_WIDTH_BITS) | x;
+    }
+    inline int getVoxelIndex(const i32v3& localPos) {
+        return getVoxelIndex(localPos.x, localPos.y, localPos.z);
+    }
+    /*! @brief Gets the local voxel position of a chunk storage index.
+    */
+    inline i32v3 getVoxelPosition(int index) {
+        return i32v3(index & CHUNK_MASK, index >> (CHUNK_WIDTH_BITS * 2), (index >> CHUNK_WIDTH_BITS) & CHUNK_MASK);
+    }
+
+#define CHUNK_NEIGHBOR_COUNT 27 ///< Chunks in a 3x3x3 neighborhood, the center included
+#define CHUNK_NEIGHBOR_CENTER 13 ///< getNeighborIndex(0, 0, 0)
+
+    /*! @brief Gets the index of a chunk in the 3x3x3 neighborhood of another.
+    *
+    * @param dx, dy, dz: Offset in chunks, each in [-1, 1]. The opposite offset has index
+    * CHUNK_NEIGHBOR_COUNT - 1 - index.
+    */
+    inline int getNeighborIndex(int dx, int dy, int dz) {
+        return (dy + 1) * 9 + (dz + 1) * 3 + (dx + 1);
+    }
+    inline int getNeighborIndex(const i32v3& offset) {
+        return getNeighborIndex(offset.x, offset.y, offset.z);
+    }
+
+    /*! @brief Hash functor for integer positions, for use in unordered containers.
+    */
+    struct PositionHash {
+        size_t operator()(const i32v3& p) const {
+            // Large primes spread neighboring positions across buckets
+            u64 h = (u64)(u32)p.x * 73856093ull ^ (u64)(u32)p.y * 19349663ull ^ (u64)(u32)p.z * 83492791ull;
+            return (size_t)(h ^ (h >> 32));
+        }
+        size_t operator()(const i32v2& p) const {
+            u64 h = (u64)(u32)p.x * 73856093ull ^ (u64)(u32)p.y * 83492791ull;
+            return (size_t)(h ^ (h >> 32));
+        }
+    };
+}
@@ -0,0 +1,69 @@
+//
+// WorldSnapshot.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file WorldSnapshot.h
+* @brief Consistent read-only view of every loaded chunk, taken without copying voxels.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "Chunk.h"
+
+namespace openvox {
+    class ChunkMap;
+
+    /*! @brief The voxels of all loaded chunks at one point in time.
+    *
+    * Capturing takes a reference to the current ChunkData of every chunk, so it costs a
+    * pointer per chunk and no voxel copies. Chunks written afterwards clone their voxels on
+    * the first write and the snapshot keeps the version it captured, so the extra memory is
+    * one chunk for every chunk modified while it is held. Releasing entries once they have
+    * been read, e.g. as a saver goes, stops their chunks from being cloned at all.
+    *
+    * The snapshot can be read and released from another thread while the chunks are
+    * written, but capture() must be called on the thread that writes them.
+    */
+    class WorldSnapshot {
+    public:
+        struct Entry {
+            i32v3 chunkPos;
+            const ChunkData* data; ///< nullptr once released
+        };
+
+        WorldSnapshot() {}
+        ~WorldSnapshot() {
+            clear();
+        }
+
+        /*! @brief Captures every loaded chunk, releasing the previous capture.
+        */
+        void capture(const ChunkMap& chunks);
+        /*! @brief Drops one chunk from the snapshot.
+        */
+        void release(size_t index) {
+            Entry& entry = m_entries[index];
+            if (!entry.data) return;
+            entry.data->release();
+            entry.data = nullptr;
+        }
+        void clear();
+
+        const std::vector<Entry>& getEntries() const {
+            return m_entries;
+        }
+        size_t size() const {
+            return m_entries.size();
+        }
+
+    private:
+        OPENVOX_NON_COPYABLE(WorldSnapshot);
+
+        std::vector<Entry> m_entries;
+    };
+}
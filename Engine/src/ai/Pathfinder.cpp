@@ -0,0 +1,688 @@
+#include "ai/Pathfinder.h"
+
+#include <algorithm>
+
+#include "jobs/JobSystem.h"
+#include "math/OpenVoxMath.hpp"
+
+#define ENTRANCE_SPLIT_SIZE 8 ///< Entrances with at least this many transitions get two nodes
+#define INVALIDATE_MARGIN_XZ 2 ///< Horizontal reach of a voxel change into neighboring clusters
+#define INVALIDATE_MARGIN_Y (PATH_MAX_DROP + 2) ///< Vertical reach of a voxel change into neighboring clusters
+
+namespace {
+    const u32 NONE = 0xFFFFFFFFu;
+    const u32 GOAL_COST_UNKNOWN = PATH_NO_COST - 1;
+    const int DIRECTIONS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+
+    inline bool isLocal(int x, int y, int z) {
+        return ((x | y | z) & ~CHUNK_MASK) == 0;
+    }
+
+    /// Lower bound on the cost between two cells, consistent with the move costs
+    inline u32 heuristic(const i32v3& a, const i32v3& b) {
+        i32 dy = b.y - a.y;
+        return (u32)(PATH_MOVE_COST * (openvoxm::abs(b.x - a.x) + openvoxm::abs(b.z - a.z)) +
+                     (dy > 0 ? PATH_CLIMB_COST * dy : -PATH_DROP_COST * dy));
+    }
+
+    struct Move {
+        i32v3 offset;
+        u32 cost;
+    };
+
+    // Reads voxels around a cluster through its 3x3x3 chunk neighborhood. Coordinates are
+    // relative to the cluster's minimum corner and may reach one chunk outside it.
+    struct ClusterReader {
+        const openvox::Chunk* blocks[27];
+
+        ClusterReader(const openvox::ChunkMap* map, const i32v3& chunkPos) {
+            // Only the center is looked up, it links its loaded neighbors
+            const openvox::Chunk* center = map->getChunk(chunkPos);
+            for (int i = 0; i < CHUNK_NEIGHBOR_COUNT; i++) {
+                blocks[i] = center ? center->getNeighbor(i) : nullptr;
+            }
+        }
+
+        bool isLoaded() const {
+            return blocks[CHUNK_NEIGHBOR_CENTER] != nullptr;
+        }
+        bool solid(int x, int y, int z) const {
+            const openvox::Chunk* b = blocks[openvox::getNeighborIndex(x >> CHUNK_WIDTH_BITS, y >> CHUNK_WIDTH_BITS, z >> CHUNK_WIDTH_BITS)];
+            return !b || b->getBlock(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK) != BLOCK_AIR;
+        }
+        bool walkable(int x, int y, int z) const {
+            return !solid(x, y, z) && !solid(x, y + 1, z) && solid(x, y - 1, z);
+        }
+        bool walkable(const i32v3& p) const {
+            return walkable(p.x, p.y, p.z);
+        }
+
+        /// Gets the moves out of a walkable cell, at most one per direction
+        int getMoves(const i32v3& p, OUT Move* moves) const {
+            int count = 0;
+            for (int d = 0; d < 4; d++) {
+                int nx = p.x + DIRECTIONS[d][0];
+                int nz = p.z + DIRECTIONS[d][1];
+                if (solid(nx, p.y, nz)) {
+                    // Climb onto the block if there is headroom on both sides
+                    if (!solid(p.x, p.y + 2, p.z) && walkable(nx, p.y + 1, nz)) {
+                        moves[count].offset = i32v3(nx - p.x, 1, nz - p.z);
+                        moves[count++].cost = PATH_MOVE_COST + PATH_CLIMB_COST;
+                    }
+                } else if (!solid(nx, p.y + 1, nz)) {
+                    // Walk, or step off and fall to the first floor below
+                    for (int k = 0; k <= PATH_MAX_DROP; k++) {
+                        if (solid(nx, p.y - 1 - k, nz)) {
+                            moves[count].offset = i32v3(nx - p.x, -k, nz - p.z);
+                            moves[count++].cost = PATH_MOVE_COST + PATH_DROP_COST * k;
+                            break;
+                        }
+                    }
+                }
+            }
+            return count;
+        }
+    };
+
+    struct HeapEntry {
+        u32 f;
+        u32 g;
+        u32 index;
+
+        bool operator<(const HeapEntry& o) const {
+            // Reversed so std::push_heap builds a min-heap
+            return f > o.f;
+        }
+    };
+
+    /// A move from one cluster into another
+    struct Transition {
+        u16 from; ///< Voxel index of the source cell in its cluster
+        i32v3 to; ///< Target cell relative to the source cluster
+        u32 cost;
+        u8 direction;
+    };
+
+    struct AbstractState {
+        const void* cluster; ///< nullptr for the start and goal states
+        u16 node;
+        u32 g;
+        u32 parent;
+        bool closed;
+    };
+
+    /// Offsets of the 26 cells around a cell
+    struct NeighborOffsets {
+        i32v3 offsets[26];
+        NeighborOffsets() {
+            int i = 0;
+            for (int y = -1; y <= 1; y++) {
+                for (int z = -1; z <= 1; z++) {
+                    for (int x = -1; x <= 1; x++) {
+                        if (x || y || z) offsets[i++] = i32v3(x, y, z);
+                    }
+                }
+            }
+        }
+    };
+    const NeighborOffsets ADJACENT;
+}
+
+struct openvox::PathContext {
+    PathContext() :
+        visited(CHUNK_SIZE, 0),
+        cost(CHUNK_SIZE),
+        parent(CHUNK_SIZE),
+        transitionStamps(CHUNK_SIZE * 4, 0),
+        transitionSlots(CHUNK_SIZE * 4) {
+        // Empty
+    }
+
+    /// Starts a new local search, invalidating the previous one's visited cells
+    void beginLocal() {
+        if (++stamp == 0) {
+            std::fill(visited.begin(), visited.end(), 0);
+            stamp = 1;
+        }
+        heap.clear();
+    }
+    void beginTransitions() {
+        if (++transitionStamp == 0) {
+            std::fill(transitionStamps.begin(), transitionStamps.end(), 0);
+            transitionStamp = 1;
+        }
+        transitions.clear();
+        entrances.clear();
+    }
+
+    // Local search over one cluster, indexed by voxel index
+    u32 stamp = 0;
+    std::vector<u32> visited;
+    std::vector<u32> cost;
+    std::vector<u16> parent;
+    std::vector<HeapEntry> heap;
+
+    // Grouping of transitions into entrances, indexed by voxel index * 4 + direction
+    u32 transitionStamp = 0;
+    std::vector<u32> transitionStamps;
+    std::vector<u32> transitionSlots;
+    std::vector<Transition> transitions;
+    std::vector<u32> component;
+    std::vector<u32> queue;
+    std::vector<Transition> entrances; ///< One representative transition per entrance
+
+    // Cluster building
+    std::vector<u16> nodeCells;
+    std::vector<Transition> outgoing;
+
+    // Abstract search
+    std::vector<AbstractState> states;
+    std::unordered_map<u64, u32> stateIndex;
+    std::vector<HeapEntry> abstractHeap;
+    std::vector<u32> startCosts;
+    std::vector<u32> goalCosts;
+    std::vector<u32> chain;
+};
+
+namespace {
+    /*! Searches inside one cluster from start. With a goal it is an A* search that returns the
+     * cost to the goal, without one it floods the whole cluster and returns 0. Costs of visited
+     * cells stay in the context until the next search.
+     */
+    u32 searchLocal(openvox::PathContext& ctx, const ClusterReader& r, int start, int goal) {
+        ctx.beginLocal();
+        i32v3 goalPos = goal >= 0 ? openvox::getVoxelPosition(goal) : i32v3(0);
+        ctx.visited[start] = ctx.stamp;
+        ctx.cost[start] = 0;
+        ctx.parent[start] = (u16)start;
+        HeapEntry first = { 0, 0, (u32)start };
+        ctx.heap.push_back(first);
+
+        Move moves[4];
+        while (ctx.heap.size()) {
+            std::pop_heap(ctx.heap.begin(), ctx.heap.end());
+            HeapEntry e = ctx.heap.back();
+            ctx.heap.pop_back();
+            if (e.g != ctx.cost[e.index]) continue;
+            if ((int)e.index == goal) return e.g;
+
+            i32v3 p = openvox::getVoxelPosition(e.index);
+            int n = r.getMoves(p, moves);
+            for (int i = 0; i < n; i++) {
+                i32v3 q = p + moves[i].offset;
+                if (!isLocal(q.x, q.y, q.z)) continue;
+                int qi = openvox::getVoxelIndex(q);
+                u32 g = e.g + moves[i].cost;
+                if (ctx.visited[qi] == ctx.stamp && ctx.cost[qi] <= g) continue;
+                ctx.visited[qi] = ctx.stamp;
+                ctx.cost[qi] = g;
+                ctx.parent[qi] = (u16)e.index;
+                HeapEntry ne = { g + (goal >= 0 ? heuristic(q, goalPos) : 0), g, (u32)qi };
+                ctx.heap.push_back(ne);
+                std::push_heap(ctx.heap.begin(), ctx.heap.end());
+            }
+        }
+        return goal >= 0 ? PATH_NO_COST : 0;
+    }
+
+    /// Appends the cells of the last local search's path to goal, excluding its start
+    void appendLocalPath(openvox::PathContext& ctx, const i32v3& origin, int goal, OUT std::vector<i32v3>& path) {
+        size_t first = path.size();
+        for (int i = goal; ctx.parent[i] != i; i = ctx.parent[i]) {
+            path.push_back(origin + openvox::getVoxelPosition(i));
+        }
+        std::reverse(path.begin() + first, path.end());
+    }
+
+    /// Gets the transition in the queued entrance nearest to, or farthest from, a point
+    u32 nearestTransition(openvox::PathContext& ctx, const f32v3& point, bool farthest) {
+        u32 best = ctx.queue[0];
+        f32 bestDist = farthest ? -1.0f : 1e30f;
+        for (u32 m : ctx.queue) {
+            i32v3 p = openvox::getVoxelPosition(ctx.transitions[m].from);
+            f32v3 d = f32v3((f32)p.x, (f32)p.y, (f32)p.z) - point;
+            f32 dist = d.x * d.x + d.y * d.y + d.z * d.z;
+            if (farthest ? dist > bestDist : dist < bestDist) {
+                bestDist = dist;
+                best = m;
+            }
+        }
+        return best;
+    }
+
+    /*! Finds the moves from walkable cells of a cluster into a neighbor at the given offset in
+     * voxels, groups them into connected entrances and keeps the transition nearest the middle
+     * of each, or both ends of wide ones. The result only depends on voxel data, so both clusters agree on it.
+     */
+    void findEntrances(openvox::PathContext& ctx, const ClusterReader& r, const i32v3& offset) {
+        ctx.beginTransitions();
+
+        // Cells whose moves can reach the neighbor
+        int x0 = openvoxm::max(0, offset.x - 1), x1 = openvoxm::min(CHUNK_WIDTH - 1, offset.x + CHUNK_WIDTH);
+        int y0 = openvoxm::max(0, offset.y - 1), y1 = openvoxm::min(CHUNK_WIDTH - 1, offset.y + CHUNK_WIDTH + PATH_MAX_DROP);
+        int z0 = openvoxm::max(0, offset.z - 1), z1 = openvoxm::min(CHUNK_WIDTH - 1, offset.z + CHUNK_WIDTH);
+        Move moves[4];
+        for (int y = y0; y <= y1; y++) {
+            for (int z = z0; z <= z1; z++) {
+                for (int x = x0; x <= x1; x++) {
+                    if (!r.walkable(x, y, z)) continue;
+                    i32v3 p(x, y, z);
+                    int n = r.getMoves(p, moves);
+                    for (int i = 0; i < n; i++) {
+                        i32v3 q = p + moves[i].offset;
+                        i32v3 l = q - offset;
+                        if (!isLocal(l.x, l.y, l.z)) continue;
+                        // Direction from the horizontal part of the move
+                        u8 d = moves[i].offset.x ? (moves[i].offset.x > 0 ? 0 : 1) : (moves[i].offset.z > 0 ? 2 : 3);
+                        Transition t = { (u16)openvox::getVoxelIndex(p), q, moves[i].cost, d };
+                        u32 key = t.from * 4 + d;
+                        ctx.transitionStamps[key] = ctx.transitionStamp;
+                        ctx.transitionSlots[key] = (u32)ctx.transitions.size();
+                        ctx.transitions.push_back(t);
+                    }
+                }
+            }
+        }
+
+        // Flood fill transitions of the same direction whose source cells touch
+        ctx.component.assign(ctx.transitions.size(), NONE);
+        for (size_t s = 0; s < ctx.transitions.size(); s++) {
+            if (ctx.component[s] != NONE) continue;
+            ctx.queue.clear();
+            ctx.queue.push_back((u32)s);
+            ctx.component[s] = (u32)s;
+            f32v3 sum(0.0f);
+            for (size_t qi = 0; qi < ctx.queue.size(); qi++) {
+                const Transition& t = ctx.transitions[ctx.queue[qi]];
+                i32v3 p = openvox::getVoxelPosition(t.from);
+                sum += f32v3((f32)p.x, (f32)p.y, (f32)p.z);
+                for (int a = 0; a < 26; a++) {
+                    i32v3 np = p + ADJACENT.offsets[a];
+                    if (!isLocal(np.x, np.y, np.z)) continue;
+                    u32 key = openvox::getVoxelIndex(np) * 4 + t.direction;
+                    if (ctx.transitionStamps[key] != ctx.transitionStamp) continue;
+                    u32 other = ctx.transitionSlots[key];
+                    if (ctx.component[other] != NONE) continue;
+                    ctx.component[other] = (u32)s;
+                    ctx.queue.push_back(other);
+                }
+            }
+
+            // Queue order only depends on scan order, so the choices are deterministic
+            f32v3 center = sum / (f32)ctx.queue.size();
+            u32 middle = nearestTransition(ctx, center, false);
+            if (ctx.queue.size() < ENTRANCE_SPLIT_SIZE) {
+                ctx.entrances.push_back(ctx.transitions[middle]);
+            } else {
+                // Wide entrances keep both ends so paths need not detour through the middle
+                i32v3 m = openvox::getVoxelPosition(ctx.transitions[middle].from);
+                u32 end0 = nearestTransition(ctx, f32v3((f32)m.x, (f32)m.y, (f32)m.z), true);
+                i32v3 e = openvox::getVoxelPosition(ctx.transitions[end0].from);
+                u32 end1 = nearestTransition(ctx, f32v3((f32)e.x, (f32)e.y, (f32)e.z), true);
+                ctx.entrances.push_back(ctx.transitions[end0]);
+                ctx.entrances.push_back(ctx.transitions[end1]);
+            }
+        }
+    }
+}
+
+openvox::Pathfinder::Pathfinder(const ChunkMap* chunkMap) :
+    onPathComplete(this),
+    m_chunkMap(chunkMap) {
+    // Empty
+}
+
+openvox::Pathfinder::~Pathfinder() {
+    for (auto& it : m_clusters) delete it.second;
+    for (PathContext* ctx : m_contexts) delete ctx;
+}
+
+void openvox::Pathfinder::addChunk(const i32v3& chunkPos) {
+    if (!getCluster(chunkPos)) {
+        Cluster* c = new Cluster;
+        c->position = chunkPos;
+        c->id = m_nextClusterID++;
+        c->dirty = false;
+        m_clusters[chunkPos] = c;
+    }
+    // Neighbors gain entrances into the new chunk
+    for (int y = -1; y <= 1; y++) {
+        for (int z = -1; z <= 1; z++) {
+            for (int x = -1; x <= 1; x++) {
+                markDirty(chunkPos + i32v3(x, y, z));
+            }
+        }
+    }
+}
+
+void openvox::Pathfinder::removeChunk(const i32v3& chunkPos) {
+    auto it = m_clusters.find(chunkPos);
+    if (it == m_clusters.end()) return;
+    Cluster* c = it->second;
+    if (c->dirty) m_dirty.erase(std::find(m_dirty.begin(), m_dirty.end(), c));
+    delete c;
+    m_clusters.erase(it);
+    for (int y = -1; y <= 1; y++) {
+        for (int z = -1; z <= 1; z++) {
+            for (int x = -1; x <= 1; x++) {
+                markDirty(chunkPos + i32v3(x, y, z));
+            }
+        }
+    }
+}
+
+void openvox::Pathfinder::invalidateVoxel(const i32v3& voxelPos) {
+    i32v3 margin(INVALIDATE_MARGIN_XZ, INVALIDATE_MARGIN_Y, INVALIDATE_MARGIN_XZ);
+    i32v3 lo = toChunkPosition(voxelPos - margin);
+    i32v3 hi = toChunkPosition(voxelPos + margin);
+    for (int y = lo.y; y <= hi.y; y++) {
+        for (int z = lo.z; z <= hi.z; z++) {
+            for (int x = lo.x; x <= hi.x; x++) {
+                markDirty(i32v3(x, y, z));
+            }
+        }
+    }
+}
+
+openvox::PathRequestID openvox::Pathfinder::requestPath(const i32v3& start, const i32v3& goal) {
+    Request r = { m_nextRequestID++, start, goal };
+    m_requests.push_back(r);
+    return r.id;
+}
+
+void openvox::Pathfinder::update(OPT JobSystem* jobs /*= nullptr*/) {
+    rebuildDirty(jobs);
+
+    size_t count = openvoxm::min(m_requestBudget, m_requests.size());
+    if (count == 0) return;
+    std::vector<PathResult> results(count);
+    auto work = [this, &results](size_t begin, size_t end) {
+        PathContext* ctx = acquireContext();
+        for (size_t i = begin; i < end; i++) {
+            results[i].id = m_requests[i].id;
+            solve(*ctx, m_requests[i].start, m_requests[i].goal, results[i]);
+        }
+        releaseContext(ctx);
+    };
+    if (jobs) {
+        jobs->parallelFor(count, 1, work);
+    } else {
+        work(0, count);
+    }
+    m_requests.erase(m_requests.begin(), m_requests.begin() + count);
+
+    for (const PathResult& r : results) onPathComplete(r);
+}
+
+openvox::PathStatus openvox::Pathfinder::findPath(const i32v3& start, const i32v3& goal,
+                                                  OUT std::vector<i32v3>& path, OPT u32* cost /*= nullptr*/) {
+    rebuildDirty(nullptr);
+    PathResult result;
+    PathContext* ctx = acquireContext();
+    solve(*ctx, start, goal, result);
+    releaseContext(ctx);
+    path.swap(result.path);
+    if (cost) *cost = result.cost;
+    return result.status;
+}
+
+bool openvox::Pathfinder::isWalkable(const i32v3& voxelPos) const {
+    ClusterReader r(m_chunkMap, toChunkPosition(voxelPos));
+    i32v3 l = toLocalPosition(voxelPos);
+    return r.walkable(l);
+}
+
+void openvox::Pathfinder::markDirty(const i32v3& chunkPos) {
+    Cluster* c = getCluster(chunkPos);
+    if (c && !c->dirty) {
+        c->dirty = true;
+        m_dirty.push_back(c);
+    }
+}
+
+void openvox::Pathfinder::rebuildDirty(OPT JobSystem* jobs) {
+    if (m_dirty.empty()) return;
+    // Builds only read voxels and write their own cluster
+    auto work = [this](size_t begin, size_t end) {
+        PathContext* ctx = acquireContext();
+        for (size_t i = begin; i < end; i++) {
+            buildCluster(*ctx, m_dirty[i]);
+            m_dirty[i]->dirty = false;
+        }
+        releaseContext(ctx);
+    };
+    if (jobs) {
+        jobs->parallelFor(m_dirty.size(), 1, work);
+    } else {
+        work(0, m_dirty.size());
+    }
+    m_dirty.clear();
+}
+
+void openvox::Pathfinder::buildCluster(PathContext& ctx, Cluster* c) const {
+    c->nodes.clear();
+    ClusterReader self(m_chunkMap, c->position);
+    if (!self.isLoaded()) return;
+
+    // Ends of the entrances into and out of every neighbor become nodes
+    ctx.nodeCells.clear();
+    ctx.outgoing.clear();
+    for (int y = -1; y <= 1; y++) {
+        for (int z = -1; z <= 1; z++) {
+            for (int x = -1; x <= 1; x++) {
+                if (!(x || y || z)) continue;
+                i32v3 neighborPos = c->position + i32v3(x, y, z);
+                if (!self.blocks[getNeighborIndex(x, y, z)]) continue;
+                i32v3 offset = i32v3(x, y, z) * CHUNK_WIDTH;
+
+                findEntrances(ctx, self, offset);
+                for (const Transition& t : ctx.entrances) {
+                    ctx.nodeCells.push_back(t.from);
+                    ctx.outgoing.push_back(t);
+                }
+
+                // The neighbor's entrances into this cluster, found the same way it finds them
+                ClusterReader neighbor(m_chunkMap, neighborPos);
+                findEntrances(ctx, neighbor, -offset);
+                for (const Transition& t : ctx.entrances) {
+                    ctx.nodeCells.push_back((u16)getVoxelIndex(t.to + offset));
+                }
+            }
+        }
+    }
+    std::sort(ctx.nodeCells.begin(), ctx.nodeCells.end());
+    ctx.nodeCells.erase(std::unique(ctx.nodeCells.begin(), ctx.nodeCells.end()), ctx.nodeCells.end());
+
+    i32v3 origin = toVoxelPosition(c->position);
+    c->nodes.resize(ctx.nodeCells.size());
+    for (size_t i = 0; i < ctx.nodeCells.size(); i++) {
+        Node& n = c->nodes[i];
+        n.voxelIndex = ctx.nodeCells[i];
+        n.position = origin + getVoxelPosition(n.voxelIndex);
+    }
+    for (const Transition& t : ctx.outgoing) {
+        InterEdge e = { origin + t.to, t.cost };
+        c->nodes[findNode(c, t.from)].inter.push_back(e);
+    }
+
+    // Shortest paths between nodes inside the cluster
+    for (size_t i = 0; i < c->nodes.size(); i++) {
+        searchLocal(ctx, self, c->nodes[i].voxelIndex, -1);
+        for (size_t j = 0; j < c->nodes.size(); j++) {
+            u16 v = c->nodes[j].voxelIndex;
+            if (i == j || ctx.visited[v] != ctx.stamp) continue;
+            IntraEdge e = { (u16)j, ctx.cost[v] };
+            c->nodes[i].intra.push_back(e);
+        }
+    }
+}
+
+void openvox::Pathfinder::solve(PathContext& ctx, const i32v3& start, const i32v3& goal, OUT PathResult& result) const {
+    result.path.clear();
+    result.cost = PATH_NO_COST;
+    result.status = PathStatus::INVALID_ENDPOINT;
+
+    const Cluster* startCluster = getCluster(toChunkPosition(start));
+    const Cluster* goalCluster = getCluster(toChunkPosition(goal));
+    if (!startCluster || !goalCluster) return;
+    ClusterReader startReader(m_chunkMap, startCluster->position);
+    ClusterReader goalReader(m_chunkMap, goalCluster->position);
+    int startIndex = getVoxelIndex(toLocalPosition(start));
+    int goalIndex = getVoxelIndex(toLocalPosition(goal));
+    if (!startReader.walkable(toLocalPosition(start)) || !goalReader.walkable(toLocalPosition(goal))) return;
+    result.status = PathStatus::NO_PATH;
+
+    // A path that stays in one cluster needs no abstract search
+    if (startCluster == goalCluster) {
+        u32 cost = searchLocal(ctx, startReader, startIndex, goalIndex);
+        if (cost != PATH_NO_COST) {
+            appendLocalPath(ctx, toVoxelPosition(startCluster->position), goalIndex, result.path);
+            result.cost = cost;
+            result.status = PathStatus::FOUND;
+            return;
+        }
+    }
+
+    // Connect the start to the nodes of its cluster. Goal nodes are connected when reached.
+    ctx.goalCosts.assign(goalCluster->nodes.size(), GOAL_COST_UNKNOWN);
+    searchLocal(ctx, startReader, startIndex, -1);
+    ctx.startCosts.resize(startCluster->nodes.size());
+    for (size_t i = 0; i < startCluster->nodes.size(); i++) {
+        u16 v = startCluster->nodes[i].voxelIndex;
+        ctx.startCosts[i] = ctx.visited[v] == ctx.stamp ? ctx.cost[v] : PATH_NO_COST;
+    }
+
+    // A* over the abstract graph. State 0 is the start and state 1 the goal.
+    ctx.states.clear();
+    ctx.stateIndex.clear();
+    ctx.abstractHeap.clear();
+    AbstractState s = { nullptr, 0, 0, NONE, true };
+    ctx.states.push_back(s);
+    s.g = PATH_NO_COST;
+    s.closed = false;
+    ctx.states.push_back(s);
+
+    auto relax = [&](const Cluster* c, u16 node, u32 g, u32 parent) {
+        u32 index;
+        if (c) {
+            u64 key = ((u64)c->id << 16) | node;
+            auto it = ctx.stateIndex.find(key);
+            if (it == ctx.stateIndex.end()) {
+                index = (u32)ctx.states.size();
+                AbstractState ns = { c, node, PATH_NO_COST, NONE, false };
+                ctx.states.push_back(ns);
+                ctx.stateIndex[key] = index;
+            } else {
+                index = it->second;
+            }
+        } else {
+            index = 1;
+        }
+        AbstractState& st = ctx.states[index];
+        if (st.closed || st.g <= g) return;
+        st.g = g;
+        st.parent = parent;
+        HeapEntry e = { g + (c ? heuristic(c->nodes[node].position, goal) : 0), g, index };
+        ctx.abstractHeap.push_back(e);
+        std::push_heap(ctx.abstractHeap.begin(), ctx.abstractHeap.end());
+    };
+
+    for (size_t i = 0; i < startCluster->nodes.size(); i++) {
+        if (ctx.startCosts[i] != PATH_NO_COST) relax(startCluster, (u16)i, ctx.startCosts[i], 0);
+    }
+    while (ctx.abstractHeap.size()) {
+        std::pop_heap(ctx.abstractHeap.begin(), ctx.abstractHeap.end());
+        HeapEntry e = ctx.abstractHeap.back();
+        ctx.abstractHeap.pop_back();
+        AbstractState& st = ctx.states[e.index];
+        if (st.closed || e.g != st.g) continue;
+        st.closed = true;
+        if (e.index == 1) break;
+
+        const Cluster* c = (const Cluster*)st.cluster;
+        const Node& n = c->nodes[st.node];
+        if (c == goalCluster) {
+            u32& goalCost = ctx.goalCosts[st.node];
+            if (goalCost == GOAL_COST_UNKNOWN) goalCost = searchLocal(ctx, goalReader, n.voxelIndex, goalIndex);
+            if (goalCost != PATH_NO_COST) relax(nullptr, 0, e.g + goalCost, e.index);
+        }
+        for (const IntraEdge& ie : n.intra) {
+            relax(c, ie.node, e.g + ie.cost, e.index);
+        }
+        for (const InterEdge& ie : n.inter) {
+            const Cluster* tc = getCluster(toChunkPosition(ie.target));
+            if (!tc || tc->dirty) continue;
+            int ti = findNode(tc, (u16)getVoxelIndex(toLocalPosition(ie.target)));
+            if (ti >= 0) relax(tc, (u16)ti, e.g + ie.cost, e.index);
+        }
+    }
+    if (!ctx.states[1].closed) return;
+
+    // Refine each abstract edge into cells
+    ctx.chain.clear();
+    for (u32 i = ctx.states[1].parent; i != 0; i = ctx.states[i].parent) ctx.chain.push_back(i);
+    std::reverse(ctx.chain.begin(), ctx.chain.end());
+
+    const AbstractState& first = ctx.states[ctx.chain.front()];
+    int firstIndex = startCluster->nodes[first.node].voxelIndex;
+    searchLocal(ctx, startReader, startIndex, firstIndex);
+    appendLocalPath(ctx, toVoxelPosition(startCluster->position), firstIndex, result.path);
+    for (size_t i = 1; i < ctx.chain.size(); i++) {
+        const AbstractState& a = ctx.states[ctx.chain[i - 1]];
+        const AbstractState& b = ctx.states[ctx.chain[i]];
+        const Cluster* bc = (const Cluster*)b.cluster;
+        if (a.cluster == b.cluster) {
+            ClusterReader r(m_chunkMap, bc->position);
+            int from = bc->nodes[a.node].voxelIndex;
+            int to = bc->nodes[b.node].voxelIndex;
+            searchLocal(ctx, r, from, to);
+            appendLocalPath(ctx, toVoxelPosition(bc->position), to, result.path);
+        } else {
+            result.path.push_back(bc->nodes[b.node].position);
+        }
+    }
+    const AbstractState& last = ctx.states[ctx.chain.back()];
+    int lastIndex = goalCluster->nodes[last.node].voxelIndex;
+    searchLocal(ctx, goalReader, lastIndex, goalIndex);
+    appendLocalPath(ctx, toVoxelPosition(goalCluster->position), goalIndex, result.path);
+
+    result.cost = ctx.states[1].g;
+    result.status = PathStatus::FOUND;
+}
+
+openvox::Pathfinder::Cluster* openvox::Pathfinder::getCluster(const i32v3& chunkPos) const {
+    auto it = m_clusters.find(chunkPos);
+    return it == m_clusters.end() ? nullptr : it->second;
+}
+
+int openvox::Pathfinder::findNode(const Cluster* c, u16 voxelIndex) {
+    int lo = 0, hi = (int)c->nodes.size() - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) >> 1;
+        u16 v = c->nodes[mid].voxelIndex;
+        if (v == voxelIndex) return mid;
+        if (v < voxelIndex) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return -1;
+}
+
+openvox::PathContext* openvox::Pathfinder::acquireContext() {
+    std::lock_guard<std::mutex> l(m_contextLock);
+    if (m_freeContexts.empty()) {
+        PathContext* ctx = new PathContext;
+        m_contexts.push_back(ctx);
+        return ctx;
+    }
+    PathContext* ctx = m_freeContexts.back();
+    m_freeContexts.pop_back();
+    return ctx;
+}
+
+void openvox::Pathfinder::releaseContext(PathContext* ctx) {
+    std::lock_guard<std::mutex> l(m_contextLock);
+    m_freeContexts.push_back(ctx);
+}
@@ -0,0 +1,100 @@
+#include "ecs/Archetype.h"
+
+#include <cstdlib>
+
+#include "OpenVoxAssert.hpp"
+
+namespace {
+    // Allocates ECS_CHUNK_BYTES aligned to ECS_COLUMN_ALIGNMENT. The offset to the
+    // real allocation is stored in the byte before the returned pointer.
+    u8* allocateChunk() {
+        u8* raw = (u8*)std::malloc(ECS_CHUNK_BYTES + ECS_COLUMN_ALIGNMENT);
+        if (!raw) throw std::bad_alloc();
+        size_t offset = ECS_COLUMN_ALIGNMENT - ((size_t)raw & (ECS_COLUMN_ALIGNMENT - 1));
+        u8* aligned = raw + offset;
+        aligned[-1] = (u8)offset;
+        return aligned;
+    }
+    void freeChunk(u8* aligned) {
+        std::free(aligned - aligned[-1]);
+    }
+
+    u32 alignUp(u32 v, u32 a) {
+        return (v + a - 1) & ~(a - 1);
+    }
+}
+
+openvox::Archetype::Archetype(ComponentMask mask) :
+    m_mask(mask) {
+    u32 bytesPerEntity = sizeof(Entity);
+    for (ComponentTypeID t = 0; t < MAX_COMPONENT_TYPES; t++) {
+        if (!hasComponent(t)) continue;
+        const ComponentInfo& info = getComponentInfo(t);
+        openvox_assert(info.alignment <= ECS_COLUMN_ALIGNMENT, "Component alignment exceeds chunk column alignment");
+        m_types.push_back(t);
+        m_columns[t].size = (u32)info.size;
+        bytesPerEntity += (u32)info.size;
+    }
+
+    // Every column may waste up to one alignment of padding
+    u32 usable = ECS_CHUNK_BYTES - ECS_COLUMN_ALIGNMENT * (u32)(m_types.size() + 1);
+    m_capacity = usable / bytesPerEntity;
+    openvox_assert(m_capacity > 0, "Components are too large for one archetype chunk");
+
+    u32 offset = alignUp(sizeof(Entity) * m_capacity, ECS_COLUMN_ALIGNMENT);
+    for (ComponentTypeID t : m_types) {
+        m_columns[t].offset = offset;
+        offset = alignUp(offset + m_columns[t].size * m_capacity, ECS_COLUMN_ALIGNMENT);
+    }
+}
+
+openvox::Archetype::~Archetype() {
+    for (u32 c = 0; c < m_chunks.size(); c++) {
+        for (ComponentTypeID t : m_types) {
+            const ComponentInfo& info = getComponentInfo(t);
+            for (u32 r = 0; r < m_chunks[c].count; r++) {
+                info.destroy(getComponent(c, r, t));
+            }
+        }
+        freeChunk(m_chunks[c].data);
+    }
+}
+
+void openvox::Archetype::allocateRow(Entity e, OUT u32& chunk, OUT u32& row) {
+    if (m_chunks.empty() || m_chunks.back().count == m_capacity) {
+        Chunk c = { allocateChunk(), 0 };
+        m_chunks.push_back(c);
+    }
+    chunk = (u32)m_chunks.size() - 1;
+    row = m_chunks[chunk].count++;
+    getEntities(chunk)[row] = e;
+    m_entityCount++;
+}
+
+openvox::Entity openvox::Archetype::removeRow(u32 chunk, u32 row) {
+    u32 lastChunk = (u32)m_chunks.size() - 1;
+    u32 lastRow = m_chunks[lastChunk].count - 1;
+
+    Entity moved = INVALID_ENTITY;
+    for (ComponentTypeID t : m_types) {
+        const ComponentInfo& info = getComponentInfo(t);
+        void* dst = getComponent(chunk, row, t);
+        info.destroy(dst);
+        if (chunk != lastChunk || row != lastRow) {
+            void* src = getComponent(lastChunk, lastRow, t);
+            info.moveConstruct(dst, src);
+            info.destroy(src);
+        }
+    }
+    if (chunk != lastChunk || row != lastRow) {
+        moved = getEntities(lastChunk)[lastRow];
+        getEntities(chunk)[row] = moved;
+    }
+
+    if (--m_chunks[lastChunk].count == 0) {
+        freeChunk(m_chunks[lastChunk].data);
+        m_chunks.pop_back();
+    }
+    m_entityCount--;
+    return moved;
+}
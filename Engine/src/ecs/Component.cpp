@@ -0,0 +1,38 @@
+#include "ecs/Component.hpp"
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+    // Function statics so registration works during static initialization of other files
+    std::mutex& registryLock() {
+        static std::mutex lock;
+        return lock;
+    }
+    std::vector<openvox::ComponentInfo>& registry() {
+        static std::vector<openvox::ComponentInfo> infos;
+        return infos;
+    }
+}
+
+openvox::ComponentTypeID openvox::registerComponentType(const ComponentInfo& info) {
+    std::lock_guard<std::mutex> l(registryLock());
+    std::vector<ComponentInfo>& infos = registry();
+    // Checked in release builds too, since a type past the limit would alias bits of other
+    // types' masks. Throwing leaves the type unregistered, so a later use throws again.
+    if (infos.size() >= MAX_COMPONENT_TYPES) throw std::length_error("Too many component types, raise MAX_COMPONENT_TYPES");
+    // Reserve up front so references returned by getComponentInfo stay valid
+    if (infos.capacity() < MAX_COMPONENT_TYPES) infos.reserve(MAX_COMPONENT_TYPES);
+    infos.push_back(info);
+    return (ComponentTypeID)infos.size() - 1;
+}
+
+const openvox::ComponentInfo& openvox::getComponentInfo(ComponentTypeID id) {
+    return registry()[id];
+}
+
+u32 openvox::getComponentTypeCount() {
+    std::lock_guard<std::mutex> l(registryLock());
+    return (u32)registry().size();
+}
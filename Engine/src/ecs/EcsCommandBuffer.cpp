@@ -0,0 +1,122 @@
+#include "ecs/EcsCommandBuffer.h"
+
+#include <cstdlib>
+
+namespace {
+    // Blocks are aligned like archetype columns, since new[] only guarantees fundamental
+    // alignment. The offset to the real allocation is stored in the byte before the block.
+    u8* allocateBlock() {
+        u8* raw = (u8*)std::malloc(ECS_COMMAND_BLOCK_BYTES + ECS_COLUMN_ALIGNMENT);
+        if (!raw) throw std::bad_alloc();
+        size_t offset = ECS_COLUMN_ALIGNMENT - ((size_t)raw & (ECS_COLUMN_ALIGNMENT - 1));
+        u8* aligned = raw + offset;
+        aligned[-1] = (u8)offset;
+        return aligned;
+    }
+    void freeBlock(u8* aligned) {
+        if (aligned) std::free(aligned - aligned[-1]);
+    }
+}
+
+openvox::EcsCommandBuffer::~EcsCommandBuffer() {
+    clear();
+    for (u8* b : m_blocks) freeBlock(b);
+}
+
+openvox::Entity openvox::EcsCommandBuffer::create() {
+    std::lock_guard<std::mutex> l(m_lock);
+    Entity e = { m_pendingCount++, PENDING_GENERATION };
+    Command c = { Command::CREATE, e, 0, nullptr };
+    m_commands.push_back(c);
+    return e;
+}
+
+void openvox::EcsCommandBuffer::destroy(Entity e) {
+    record(Command::DESTROY, e, 0, nullptr);
+}
+
+void openvox::EcsCommandBuffer::playback(EcsWorld& world, OPT std::vector<Entity>* created /*= nullptr*/) {
+    // Take the commands and their data out under the lock, then replay without it, so
+    // world event handlers may record into this buffer
+    std::vector<Command> commands;
+    std::vector<u8*> blocks;
+    u32 pendingCount;
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        commands.swap(m_commands);
+        blocks.swap(m_blocks);
+        pendingCount = m_pendingCount;
+        m_blockUsed = ECS_COMMAND_BLOCK_BYTES;
+        m_pendingCount = 0;
+    }
+    std::vector<Entity> resolved(pendingCount, INVALID_ENTITY);
+
+    for (Command& c : commands) {
+        Entity e = c.entity;
+        if (e.generation == PENDING_GENERATION && c.type != Command::CREATE) e = resolved[e.index];
+
+        switch (c.type) {
+            case Command::CREATE:
+                resolved[e.index] = world.create();
+                break;
+            case Command::DESTROY:
+                world.destroy(e);
+                break;
+            case Command::ADD: {
+                // Placed before onComponentAdded fires, so listeners see the recorded value
+                if (world.isAlive(e)) world.addComponent(e, c.component, c.data);
+                getComponentInfo(c.component).destroy(c.data);
+                c.data = nullptr;
+                break;
+            }
+            case Command::REMOVE:
+                world.removeComponent(e, c.component);
+                break;
+        }
+    }
+    if (created) created->insert(created->end(), resolved.begin(), resolved.end());
+
+    std::lock_guard<std::mutex> l(m_lock);
+    // Keep the first block and the command storage for the next frame, unless handlers
+    // already recorded new commands
+    if (m_blocks.empty() && !blocks.empty()) {
+        m_blocks.push_back(blocks[0]);
+        m_blockUsed = 0;
+        blocks[0] = nullptr;
+    }
+    for (u8* b : blocks) freeBlock(b);
+    if (m_commands.empty()) {
+        commands.clear();
+        m_commands.swap(commands);
+    }
+}
+
+void openvox::EcsCommandBuffer::clear() {
+    std::lock_guard<std::mutex> l(m_lock);
+    for (Command& c : m_commands) {
+        if (c.data) getComponentInfo(c.component).destroy(c.data);
+    }
+    m_commands.clear();
+    m_blockUsed = m_blocks.empty() ? ECS_COMMAND_BLOCK_BYTES : 0;
+    for (size_t i = 1; i < m_blocks.size(); i++) freeBlock(m_blocks[i]);
+    if (m_blocks.size() > 1) m_blocks.resize(1);
+    m_pendingCount = 0;
+}
+
+void openvox::EcsCommandBuffer::record(Command::Type type, Entity e, ComponentTypeID t, void* data) {
+    std::lock_guard<std::mutex> l(m_lock);
+    Command c = { type, e, t, data };
+    m_commands.push_back(c);
+}
+
+void* openvox::EcsCommandBuffer::allocate(size_t size, size_t alignment) {
+    openvox_assert(size + alignment <= ECS_COMMAND_BLOCK_BYTES, "Component too large for a command buffer");
+    openvox_assert(alignment <= ECS_COLUMN_ALIGNMENT, "Component alignment exceeds command block alignment");
+    size_t offset = (m_blockUsed + alignment - 1) & ~(alignment - 1);
+    if (offset + size > ECS_COMMAND_BLOCK_BYTES) {
+        m_blocks.push_back(allocateBlock());
+        offset = 0;
+    }
+    m_blockUsed = offset + size;
+    return m_blocks.back() + offset;
+}
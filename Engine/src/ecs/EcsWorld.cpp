@@ -0,0 +1,137 @@
+#include "ecs/EcsWorld.h"
+
+openvox::EcsWorld::EcsWorld() :
+    onEntityCreated(this),
+    onEntityDestroyed(this),
+    onComponentAdded(this),
+    onComponentRemoved(this) {
+    // Empty
+}
+
+openvox::EcsWorld::~EcsWorld() {
+    for (Archetype* a : m_archetypeList) delete a;
+}
+
+openvox::Entity openvox::EcsWorld::create() {
+    Entity e = allocateEntity(getArchetype(0));
+    onEntityCreated(e);
+    return e;
+}
+
+bool openvox::EcsWorld::destroy(Entity e) {
+    if (!isAlive(e)) return false;
+    onEntityDestroyed(e);
+
+    EntityRecord& r = m_records[e.index];
+    Entity moved = r.archetype->removeRow(r.chunk, r.row);
+    relocated(moved, r.chunk, r.row);
+
+    r.archetype = nullptr;
+    r.generation++;
+    m_freeIndices.push_back(e.index);
+    m_entityCount--;
+    return true;
+}
+
+void* openvox::EcsWorld::addComponent(Entity e, ComponentTypeID t) {
+    openvox_assert(isAlive(e), "Adding a component to a dead entity");
+    Archetype* from = m_records[e.index].archetype;
+    if (from->hasComponent(t)) {
+        return from->getComponent(m_records[e.index].chunk, m_records[e.index].row, t);
+    }
+
+    moveEntity(e, getArchetype(from->getMask() | ((ComponentMask)1 << t)));
+    const EntityRecord& r = m_records[e.index];
+    void* stored = r.archetype->getComponent(r.chunk, r.row, t);
+    getComponentInfo(t).construct(stored);
+    onComponentAdded(e, t);
+    return stored;
+}
+
+void* openvox::EcsWorld::addComponent(Entity e, ComponentTypeID t, void* value) {
+    openvox_assert(isAlive(e), "Adding a component to a dead entity");
+    const ComponentInfo& info = getComponentInfo(t);
+    Archetype* from = m_records[e.index].archetype;
+    if (from->hasComponent(t)) {
+        void* existing = from->getComponent(m_records[e.index].chunk, m_records[e.index].row, t);
+        info.destroy(existing);
+        info.moveConstruct(existing, value);
+        return existing;
+    }
+
+    moveEntity(e, getArchetype(from->getMask() | ((ComponentMask)1 << t)));
+    const EntityRecord& r = m_records[e.index];
+    void* stored = r.archetype->getComponent(r.chunk, r.row, t);
+    info.moveConstruct(stored, value);
+    onComponentAdded(e, t);
+    return stored;
+}
+
+bool openvox::EcsWorld::removeComponent(Entity e, ComponentTypeID t) {
+    if (!isAlive(e)) return false;
+    Archetype* from = m_records[e.index].archetype;
+    if (!from->hasComponent(t)) return false;
+
+    onComponentRemoved(e, t);
+    moveEntity(e, getArchetype(from->getMask() & ~((ComponentMask)1 << t)));
+    return true;
+}
+
+void* openvox::EcsWorld::getComponent(Entity e, ComponentTypeID t) const {
+    if (!isAlive(e)) return nullptr;
+    const EntityRecord& r = m_records[e.index];
+    if (!r.archetype->hasComponent(t)) return nullptr;
+    return r.archetype->getComponent(r.chunk, r.row, t);
+}
+
+openvox::Archetype* openvox::EcsWorld::getArchetype(ComponentMask mask) {
+    auto it = m_archetypes.find(mask);
+    if (it != m_archetypes.end()) return it->second;
+
+    Archetype* a = new Archetype(mask);
+    m_archetypes[mask] = a;
+    m_archetypeList.push_back(a);
+    return a;
+}
+
+openvox::Entity openvox::EcsWorld::allocateEntity(Archetype* archetype) {
+    Entity e;
+    if (!m_freeIndices.empty()) {
+        e.index = m_freeIndices.back();
+        m_freeIndices.pop_back();
+    } else {
+        e.index = (u32)m_records.size();
+        m_records.emplace_back();
+    }
+    EntityRecord& r = m_records[e.index];
+    e.generation = r.generation;
+    r.archetype = archetype;
+    archetype->allocateRow(e, r.chunk, r.row);
+    m_entityCount++;
+    return e;
+}
+
+void openvox::EcsWorld::moveEntity(Entity e, Archetype* to) {
+    EntityRecord& r = m_records[e.index];
+    Archetype* from = r.archetype;
+    u32 chunk, row;
+    to->allocateRow(e, chunk, row);
+
+    // Move shared components, removeRow then destroys the moved-from husks
+    for (ComponentTypeID t : from->getTypes()) {
+        if (!to->hasComponent(t)) continue;
+        getComponentInfo(t).moveConstruct(to->getComponent(chunk, row, t), from->getComponent(r.chunk, r.row, t));
+    }
+    Entity moved = from->removeRow(r.chunk, r.row);
+    relocated(moved, r.chunk, r.row);
+
+    r.archetype = to;
+    r.chunk = chunk;
+    r.row = row;
+}
+
+void openvox::EcsWorld::relocated(Entity moved, u32 chunk, u32 row) {
+    if (moved == INVALID_ENTITY) return;
+    m_records[moved.index].chunk = chunk;
+    m_records[moved.index].row = row;
+}
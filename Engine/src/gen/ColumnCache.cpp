@@ -0,0 +1,80 @@
+#include "gen/ColumnCache.h"
+
+#include <vector>
+
+openvox::ColumnCache::ColumnCache(ColumnFunc func, u32 stride /*= 4*/) :
+    m_func(func),
+    m_lattice(stride),
+    m_columnsComputed(0) {
+    // Empty
+}
+
+openvox::ColumnCache::~ColumnCache() {
+    clear();
+}
+
+const openvox::ColumnData& openvox::ColumnCache::get(const i32v2& columnPos) {
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        auto it = m_columns.find(columnPos);
+        if (it != m_columns.end()) return *it->second;
+    }
+
+    // Computing outside the lock lets other columns be computed in parallel
+    ColumnData* data = new ColumnData;
+    compute(columnPos, *data);
+
+    std::lock_guard<std::mutex> l(m_lock);
+    m_columnsComputed++;
+    auto it = m_columns.find(columnPos);
+    if (it != m_columns.end()) {
+        delete data;
+        return *it->second;
+    }
+    m_columns[columnPos] = data;
+    return *data;
+}
+
+void openvox::ColumnCache::removeColumn(const i32v2& columnPos) {
+    std::lock_guard<std::mutex> l(m_lock);
+    auto it = m_columns.find(columnPos);
+    if (it == m_columns.end()) return;
+    delete it->second;
+    m_columns.erase(it);
+}
+
+void openvox::ColumnCache::clear() {
+    std::lock_guard<std::mutex> l(m_lock);
+    for (auto& it : m_columns) delete it.second;
+    m_columns.clear();
+}
+
+size_t openvox::ColumnCache::getColumnCount() const {
+    std::lock_guard<std::mutex> l(m_lock);
+    return m_columns.size();
+}
+
+void openvox::ColumnCache::compute(const i32v2& columnPos, OUT ColumnData& data) const {
+    const u32 p = m_lattice.getPointsPerAxis();
+    const u32 stride = m_lattice.getStride();
+    const i32 x0 = columnPos.x * CHUNK_WIDTH;
+    const i32 z0 = columnPos.y * CHUNK_WIDTH;
+    std::vector<f32> heights((size_t)p * p);
+    std::vector<u16> biomes((size_t)p * p);
+    for (u32 z = 0; z < p; z++) {
+        for (u32 x = 0; x < p; x++) {
+            ColumnSample s = m_func((f32)(x0 + (i32)(x * stride)), (f32)(z0 + (i32)(z * stride)));
+            heights[z * p + x] = s.height;
+            biomes[z * p + x] = s.biome;
+        }
+    }
+    m_lattice.upsampleLayer(heights.data(), data.height);
+
+    // Nearest lattice point, rounding half way up
+    for (u32 z = 0; z < CHUNK_WIDTH; z++) {
+        const u16* row = &biomes[((z + stride / 2) / stride) * p];
+        for (u32 x = 0; x < CHUNK_WIDTH; x++) {
+            data.biome[z * CHUNK_WIDTH + x] = row[(x + stride / 2) / stride];
+        }
+    }
+}
@@ -0,0 +1,81 @@
+#include "gen/NoiseLattice.h"
+
+#include <vector>
+
+#include "OpenVoxAssert.hpp"
+#include "math/OpenVoxMath.hpp"
+
+openvox::NoiseLattice::NoiseLattice(u32 stride /*= 4*/) :
+    m_stride(stride) {
+    openvox_assert(stride && stride <= CHUNK_WIDTH && (stride & (stride - 1)) == 0, "Lattice stride must be a power of two up to CHUNK_WIDTH");
+    m_strideBits = openvoxm::bitScanForward(stride);
+    m_points = CHUNK_WIDTH / stride + 1;
+    for (u32 i = 0; i < CHUNK_WIDTH; i++) {
+        m_weights[i] = (f32)(i & (stride - 1)) / (f32)stride;
+    }
+}
+
+void openvox::NoiseLattice::sampleChunk(const i32v3& chunkPos, const NoiseFunc& noise, OUT f32* values) const {
+    const u32 p = m_points;
+    const i32v3 origin = toVoxelPosition(chunkPos);
+    std::vector<f32> lattice((size_t)p * p * p);
+    for (u32 y = 0; y < p; y++) {
+        for (u32 z = 0; z < p; z++) {
+            for (u32 x = 0; x < p; x++) {
+                f32v3 pos((f32)(origin.x + (i32)(x << m_strideBits)),
+                          (f32)(origin.y + (i32)(y << m_strideBits)),
+                          (f32)(origin.z + (i32)(z << m_strideBits)));
+                lattice[((size_t)y * p + z) * p + x] = noise(pos);
+            }
+        }
+    }
+
+    // Lattice layers land on voxel layers that are multiples of the stride. The last one is the
+    // first layer of the chunk above, so it is kept aside.
+    f32 top[CHUNK_LAYER];
+    for (u32 y = 0; y < p; y++) {
+        u32 vy = y << m_strideBits;
+        upsampleLayer(&lattice[(size_t)y * p * p], vy < CHUNK_WIDTH ? values + vy * CHUNK_LAYER : top);
+    }
+    if (m_stride == 1) return;
+
+    for (u32 vy = 0; vy < CHUNK_WIDTH; vy++) {
+        f32 t = m_weights[vy];
+        if (t == 0.0f) continue;
+        u32 y0 = vy & ~(m_stride - 1);
+        u32 y1 = y0 + m_stride;
+        const f32* a = values + y0 * CHUNK_LAYER;
+        const f32* b = y1 < CHUNK_WIDTH ? values + y1 * CHUNK_LAYER : top;
+        f32* out = values + vy * CHUNK_LAYER;
+        for (u32 i = 0; i < CHUNK_LAYER; i++) {
+            out[i] = a[i] + (b[i] - a[i]) * t;
+        }
+    }
+}
+
+void openvox::NoiseLattice::upsampleLayer(const f32* lattice, OUT f32* layer) const {
+    const u32 p = m_points;
+    // Upsample every lattice row along X, then interpolate whole rows along Z. The rows live on
+    // the stack rather than in the lattice, which threads share.
+    f32 rows[(CHUNK_WIDTH + 1) * CHUNK_WIDTH];
+    for (u32 z = 0; z < p; z++) {
+        const f32* src = lattice + (size_t)z * p;
+        f32* row = &rows[(size_t)z * CHUNK_WIDTH];
+        for (u32 x = 0; x < CHUNK_WIDTH; x++) {
+            u32 cell = x >> m_strideBits;
+            f32 a = src[cell];
+            f32 b = src[cell + 1 < p ? cell + 1 : cell];
+            row[x] = a + (b - a) * m_weights[x];
+        }
+    }
+    for (u32 z = 0; z < CHUNK_WIDTH; z++) {
+        u32 cell = z >> m_strideBits;
+        const f32* a = &rows[(size_t)cell * CHUNK_WIDTH];
+        const f32* b = &rows[(size_t)(cell + 1 < p ? cell + 1 : cell) * CHUNK_WIDTH];
+        f32 t = m_weights[z];
+        f32* out = layer + z * CHUNK_WIDTH;
+        for (u32 x = 0; x < CHUNK_WIDTH; x++) {
+            out[x] = a[x] + (b[x] - a[x]) * t;
+        }
+    }
+}
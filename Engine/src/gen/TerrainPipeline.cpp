@@ -0,0 +1,234 @@
+#include "gen/TerrainPipeline.h"
+
+#include <algorithm>
+
+#include "OpenVoxAssert.hpp"
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    inline int neighborIndex(const i32v3& offset) {
+        return (offset.y + 1) * 9 + (offset.z + 1) * 3 + (offset.x + 1);
+    }
+
+    inline void writeBlock(openvox::Chunk* chunk, int index, openvox::BlockID id, openvox::EditMode mode) {
+        openvox::BlockID current = chunk->getBlock(index);
+        if (mode == openvox::EditMode::FILL_AIR && current != BLOCK_AIR) return;
+        if (mode == openvox::EditMode::REPLACE_SOLID && current == BLOCK_AIR) return;
+        chunk->setBlock(index, id);
+    }
+}
+
+void openvox::GenContext::setBlock(const i32v3& voxelPos, BlockID id, EditMode mode /*= EditMode::REPLACE*/) {
+    i32v3 chunkPos = toChunkPosition(voxelPos);
+    u16 index = (u16)getVoxelIndex(toLocalPosition(voxelPos));
+    if (chunkPos == m_chunkPos) {
+        writeBlock(m_chunk, index, id, mode);
+        return;
+    }
+    i32v3 d = chunkPos - m_chunkPos;
+    openvox_assert(d.x >= -m_writeRadius && d.x <= m_writeRadius && d.y >= -m_writeRadius && d.y <= m_writeRadius &&
+                   d.z >= -m_writeRadius && d.z <= m_writeRadius, "Stage wrote outside its write radius");
+    DeferredEdit e = { m_chunkPos, chunkPos, index, id, mode };
+    m_deferred.push_back(e);
+}
+
+openvox::TerrainPipeline::TerrainPipeline(ChunkMap* chunkMap, u64 seed) :
+    onChunkComplete(this),
+    m_chunkMap(chunkMap),
+    m_seed(seed) {
+    // Empty
+}
+
+openvox::TerrainPipeline::~TerrainPipeline() {
+    for (auto& it : m_chunks) delete it.second;
+}
+
+u32 openvox::TerrainPipeline::addStage(const char* name, StageFunc func, i32 writeRadius /*= 0*/) {
+    openvox_assert(m_chunks.empty(), "Stages must be added before generation starts");
+    openvox_assert(writeRadius >= 0 && writeRadius <= MAX_STAGE_WRITE_RADIUS, "Stage write radius out of range");
+    Stage s = { name, func, writeRadius };
+    m_stages.push_back(s);
+    return (u32)m_stages.size() - 1;
+}
+
+void openvox::TerrainPipeline::requestChunk(const i32v3& chunkPos) {
+    GenChunk* c = getGenChunk(chunkPos);
+    if (c->requested) return;
+    c->requested = true;
+    if (c->level < getCompleteLevel()) m_incomplete++;
+    raiseTarget(chunkPos, getCompleteLevel());
+}
+
+size_t openvox::TerrainPipeline::update(OPT JobSystem* jobs /*= nullptr*/) {
+    std::vector<GenChunk*> finished;
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        finished.swap(m_finished);
+    }
+    std::vector<i32v3> completed;
+    for (GenChunk* c : finished) {
+        c->running = false;
+        c->level++;
+        m_running--;
+        if (c->requested && c->level == getCompleteLevel()) {
+            m_incomplete--;
+            completed.push_back(c->position);
+        }
+    }
+
+    // Schedule every chunk whose dependencies are met, dropping chunks that reached their target
+    size_t kept = 0;
+    for (size_t i = 0; i < m_active.size(); i++) {
+        GenChunk* c = m_active[i];
+        if (c->level >= c->target && !c->running) {
+            c->active = false;
+            continue;
+        }
+        m_active[kept++] = c;
+        if (!isReady(c)) continue;
+
+        u32 step = c->level;
+        if (!c->chunk) c->chunk = m_chunkMap->createChunk(c->position);
+        // Chunks this step may spill into need somewhere to keep the blocks
+        GenChunk* neighbors[27] = {};
+        i32 radius = step < m_stages.size() ? m_stages[step].writeRadius : 0;
+        for (i32 y = -radius; y <= radius; y++) {
+            for (i32 z = -radius; z <= radius; z++) {
+                for (i32 x = -radius; x <= radius; x++) {
+                    i32v3 offset(x, y, z);
+                    neighbors[neighborIndex(offset)] = getGenChunk(c->position + offset);
+                }
+            }
+        }
+
+        c->running = true;
+        m_running++;
+        m_stagesRun++;
+        if (jobs) {
+            std::vector<GenChunk*> table(neighbors, neighbors + 27);
+            jobs->schedule([this, c, step, table]() { runStep(c, step, table.data()); }, &m_counter);
+        } else {
+            runStep(c, step, neighbors);
+        }
+    }
+    m_active.resize(kept);
+
+    for (const i32v3& p : completed) onChunkComplete(p);
+    return m_incomplete;
+}
+
+void openvox::TerrainPipeline::flush(OPT JobSystem* jobs /*= nullptr*/) {
+    for (;;) {
+        u64 stagesRun = m_stagesRun;
+        if (update(jobs) == 0 && m_running == 0) return;
+        openvox_assert(m_running || m_stagesRun != stagesRun, "TerrainPipeline stalled");
+        if (jobs) jobs->wait(m_counter);
+    }
+}
+
+bool openvox::TerrainPipeline::isComplete(const i32v3& chunkPos) const {
+    auto it = m_chunks.find(chunkPos);
+    return it != m_chunks.end() && it->second->level == getCompleteLevel();
+}
+
+void openvox::TerrainPipeline::removeChunk(const i32v3& chunkPos) {
+    openvox_assert(m_running == 0, "Chunks cannot be removed while stages are running");
+    auto it = m_chunks.find(chunkPos);
+    if (it == m_chunks.end()) return;
+    GenChunk* c = it->second;
+    if (c->active) m_active.erase(std::find(m_active.begin(), m_active.end(), c));
+    if (c->requested && c->level < getCompleteLevel()) m_incomplete--;
+    delete c;
+    m_chunks.erase(it);
+}
+
+openvox::TerrainPipeline::GenChunk* openvox::TerrainPipeline::getGenChunk(const i32v3& chunkPos) {
+    auto it = m_chunks.find(chunkPos);
+    if (it != m_chunks.end()) return it->second;
+    GenChunk* c = new GenChunk;
+    c->position = chunkPos;
+    c->chunk = nullptr;
+    c->level = 0;
+    c->target = 0;
+    c->requested = false;
+    c->running = false;
+    c->active = false;
+    c->inbox.resize(m_stages.size());
+    m_chunks[chunkPos] = c;
+    return c;
+}
+
+void openvox::TerrainPipeline::raiseTarget(const i32v3& chunkPos, u32 target) {
+    GenChunk* c = getGenChunk(chunkPos);
+    if (c->target >= target) return;
+    u32 oldTarget = c->target;
+    c->target = target;
+    if (!c->active && c->level < target) {
+        c->active = true;
+        m_active.push_back(c);
+    }
+
+    // Step k needs every chunk within the write radius of stage k - 1 to have finished it
+    for (u32 k = openvoxm::max(oldTarget, 1u); k < target; k++) {
+        i32 radius = m_stages[k - 1].writeRadius;
+        for (i32 y = -radius; y <= radius; y++) {
+            for (i32 z = -radius; z <= radius; z++) {
+                for (i32 x = -radius; x <= radius; x++) {
+                    if (x || y || z) raiseTarget(chunkPos + i32v3(x, y, z), k);
+                }
+            }
+        }
+    }
+}
+
+bool openvox::TerrainPipeline::isReady(const GenChunk* c) const {
+    if (c->running || c->level >= c->target) return false;
+    u32 step = c->level;
+    if (step == 0) return true;
+    i32 radius = m_stages[step - 1].writeRadius;
+    for (i32 y = -radius; y <= radius; y++) {
+        for (i32 z = -radius; z <= radius; z++) {
+            for (i32 x = -radius; x <= radius; x++) {
+                if (!(x || y || z)) continue;
+                auto it = m_chunks.find(c->position + i32v3(x, y, z));
+                if (it == m_chunks.end() || it->second->level < step) return false;
+            }
+        }
+    }
+    return true;
+}
+
+void openvox::TerrainPipeline::runStep(GenChunk* c, u32 step, GenChunk* const* neighbors) {
+    // Every chunk that could spill into this one has finished, so its inbox is final
+    if (step > 0) {
+        std::vector<GenContext::DeferredEdit>& edits = c->inbox[step - 1];
+        // Order by the chunk that wrote them so the result does not depend on which job finished first
+        std::stable_sort(edits.begin(), edits.end(), [](const GenContext::DeferredEdit& a, const GenContext::DeferredEdit& b) {
+            if (a.source.y != b.source.y) return a.source.y < b.source.y;
+            if (a.source.z != b.source.z) return a.source.z < b.source.z;
+            return a.source.x < b.source.x;
+        });
+        for (const GenContext::DeferredEdit& e : edits) writeBlock(c->chunk, e.voxelIndex, e.id, e.mode);
+        std::vector<GenContext::DeferredEdit>().swap(edits);
+    }
+
+    if (step < m_stages.size()) {
+        GenContext context;
+        context.m_chunk = c->chunk;
+        context.m_chunkPos = c->position;
+        context.m_stage = step;
+        context.m_writeRadius = m_stages[step].writeRadius;
+        context.m_seed = m_seed;
+        m_stages[step].func(context);
+
+        if (context.m_deferred.size()) {
+            std::lock_guard<std::mutex> l(m_lock);
+            for (const GenContext::DeferredEdit& e : context.m_deferred) {
+                neighbors[neighborIndex(e.target - c->position)]->inbox[step].push_back(e);
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> l(m_lock);
+    m_finished.push_back(c);
+}
@@ -0,0 +1,290 @@
+#include "io/EditJournal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#include "io/FileSystem.h"
+#include "io/RegionStore.h"
+#include "io/Serialization.hpp"
+#include "math/OpenVoxMath.hpp"
+#include "voxel/ChunkMap.h"
+
+#define JOURNAL_FRAME_HEADER_SIZE 8 ///< CRC of the rest of the frame, then the record count
+#define JOURNAL_RECORD_SIZE 14
+#define JOURNAL_RETRY_DELAY 100 ///< Milliseconds the writer waits after a failed write
+
+namespace {
+    /// Chunk position no voxel maps to, for skipping runs of edits to the same chunk
+    const i32v3 NO_CHUNK(std::numeric_limits<i32>::max());
+}
+
+openvox::EditJournal::EditJournal() :
+    m_durable(0) {
+    std::memset(&m_stats, 0, sizeof(m_stats));
+}
+
+openvox::EditJournal::~EditJournal() {
+    close();
+}
+
+bool openvox::EditJournal::open(const std::string& directory, const ReplayFunc& replay) {
+    close();
+    if (!makeDirectory(directory)) return false;
+    m_directory = directory;
+    std::memset(&m_stats, 0, sizeof(m_stats));
+
+    std::vector<std::string> names;
+    listDirectory(directory, names);
+    std::vector<u32> indices;
+    for (const std::string& name : names) {
+        unsigned index;
+        if (sscanf(name.c_str(), "journal.%u.", &index) == 1 && m_directory + "/" + name == getSegmentPath(index)) indices.push_back(index);
+    }
+    std::sort(indices.begin(), indices.end());
+    for (u32 index : indices) {
+        m_segments.emplace_back();
+        Segment& segment = m_segments.back();
+        segment.index = index;
+        segment.path = getSegmentPath(index);
+        replaySegment(segment, replay);
+    }
+
+    if (!startSegment()) {
+        close();
+        return false;
+    }
+    m_stopping = false;
+    m_appended = 0;
+    m_durable.store(0, std::memory_order_release);
+    m_writer = std::thread(&EditJournal::writerLoop, this);
+    return true;
+}
+
+void openvox::EditJournal::close() {
+    if (m_writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_writer.join();
+    }
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    m_segments.clear();
+    m_pending.clear();
+}
+
+u64 openvox::EditJournal::append(const i32v3& voxelPos, BlockID id) {
+    Record r;
+    r.voxelPos = voxelPos;
+    r.id = id;
+    u64 sequence;
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        wasEmpty = m_pending.empty();
+        m_pending.push_back(r);
+        sequence = ++m_appended;
+    }
+    // The writer only sleeps while nothing is pending
+    if (wasEmpty) m_wake.notify_one();
+    return sequence;
+}
+
+void openvox::EditJournal::waitDurable(u64 sequence) {
+    if (getDurableSequence() >= sequence) return;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_durableChanged.wait(lock, [this, sequence]() { return getDurableSequence() >= sequence; });
+}
+
+bool openvox::EditJournal::checkpoint(const ChunkMap& chunks, RegionStore& regions) {
+    // Edits appended from here on go to the new segment, so the old ones stop growing
+    std::unordered_set<i32v3, PositionHash> edited;
+    size_t oldCount;
+    {
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        if (!flush() || !startSegment()) return false;
+        oldCount = m_segments.size() - 1;
+        for (size_t i = 0; i < oldCount; i++) edited.insert(m_segments[i].chunks.begin(), m_segments[i].chunks.end());
+    }
+
+    // The writer keeps committing while chunks are saved
+    bool ok = true;
+    std::vector<i32v3> saved;
+    for (const i32v3& chunkPos : edited) {
+        const Chunk* chunk = chunks.getChunk(chunkPos);
+        if (!chunk) continue;
+        if (regions.saveChunk(*chunk)) {
+            saved.push_back(chunkPos);
+        } else {
+            ok = false;
+        }
+    }
+    if (!regions.sync()) return false;
+
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    size_t kept = 0;
+    for (size_t i = 0; i < m_segments.size(); i++) {
+        Segment& segment = m_segments[i];
+        if (i < oldCount) {
+            for (const i32v3& chunkPos : saved) segment.chunks.erase(chunkPos);
+            if (segment.chunks.empty()) {
+                remove(segment.path.c_str());
+                continue;
+            }
+        }
+        if (kept != i) m_segments[kept] = std::move(segment);
+        kept++;
+    }
+    m_segments.resize(kept);
+    return ok;
+}
+
+void openvox::EditJournal::markChunkSaved(const i32v3& chunkPos) {
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    for (Segment& segment : m_segments) segment.chunks.erase(chunkPos);
+}
+
+size_t openvox::EditJournal::getSegmentCount() {
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    return m_segments.size();
+}
+
+openvox::EditJournalStats openvox::EditJournal::getStats() {
+    std::lock_guard<std::mutex> writeLock(m_writeMutex);
+    return m_stats;
+}
+
+void openvox::EditJournal::writerLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_wake.wait(lock, [this]() { return m_pending.size() || m_stopping; });
+        if (m_pending.empty()) break;
+        lock.unlock();
+        bool ok;
+        {
+            std::lock_guard<std::mutex> writeLock(m_writeMutex);
+            ok = flush();
+        }
+        if (!ok) std::this_thread::sleep_for(std::chrono::milliseconds(JOURNAL_RETRY_DELAY));
+        lock.lock();
+        // Gives up on the buffered records rather than blocking close() forever
+        if (!ok && m_stopping) break;
+    }
+}
+
+bool openvox::EditJournal::flush() {
+    u64 sequence;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_writing.swap(m_pending);
+        sequence = m_appended;
+    }
+    if (m_writing.empty()) return true;
+
+    bool ok = m_file != nullptr;
+    for (size_t start = 0; ok && start < m_writing.size(); start += JOURNAL_MAX_FRAME_RECORDS) {
+        size_t count = openvoxm::min(m_writing.size() - start, (size_t)JOURNAL_MAX_FRAME_RECORDS);
+        m_frame.clear();
+        {
+            BinaryWriter w(m_frame);
+            w.write((u32)0);
+            w.write((u32)count);
+            for (size_t i = start; i < start + count; i++) {
+                w.write(m_writing[i].voxelPos);
+                w.write(m_writing[i].id);
+            }
+        }
+        SerialTraits<u32>::store(&m_frame[0], crc32(&m_frame[4], m_frame.size() - 4));
+        ok = fwrite(m_frame.data(), 1, m_frame.size(), m_file) == m_frame.size();
+        m_stats.frames++;
+        m_stats.bytes += m_frame.size();
+    }
+    // One sync commits every record of the batch
+    ok = ok && syncFile(m_file);
+
+    if (!ok) {
+        // A partly written frame ends its segment, so the records are retried in a new one
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_writing.insert(m_writing.end(), m_pending.begin(), m_pending.end());
+            m_pending.swap(m_writing);
+        }
+        m_writing.clear();
+        startSegment();
+        return false;
+    }
+
+    m_stats.records += m_writing.size();
+    m_stats.syncs++;
+    i32v3 last = NO_CHUNK;
+    for (const Record& r : m_writing) {
+        i32v3 chunkPos = toChunkPosition(r.voxelPos);
+        if (chunkPos != last) m_segments.back().chunks.insert(chunkPos);
+        last = chunkPos;
+    }
+    m_writing.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_durable.store(sequence, std::memory_order_release);
+    }
+    m_durableChanged.notify_all();
+    return true;
+}
+
+bool openvox::EditJournal::startSegment() {
+    if (m_file) {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+    Segment segment;
+    segment.index = m_segments.empty() ? 1 : m_segments.back().index + 1;
+    segment.path = getSegmentPath(segment.index);
+    m_file = fopen(segment.path.c_str(), "wb");
+    if (!m_file) return false;
+    m_segments.push_back(std::move(segment));
+    return syncDirectory(m_directory);
+}
+
+void openvox::EditJournal::replaySegment(Segment& segment, const ReplayFunc& replay) {
+    FILE* file = fopen(segment.path.c_str(), "rb");
+    if (!file) return;
+
+    u8 header[JOURNAL_FRAME_HEADER_SIZE];
+    i32v3 last = NO_CHUNK;
+    while (fread(header, 1, JOURNAL_FRAME_HEADER_SIZE, file) == JOURNAL_FRAME_HEADER_SIZE) {
+        u32 crc = SerialTraits<u32>::load(header);
+        u32 count = SerialTraits<u32>::load(header + 4);
+        if (!count || count > JOURNAL_MAX_FRAME_RECORDS) break;
+        // The count is kept in front of the records since the checksum covers both
+        size_t size = count * JOURNAL_RECORD_SIZE;
+        m_frame.resize(4 + size);
+        std::memcpy(&m_frame[0], header + 4, 4);
+        if (fread(&m_frame[4], 1, size, file) != size || crc32(m_frame.data(), m_frame.size()) != crc) break;
+
+        BinaryReader r(&m_frame[4], size);
+        i32v3 voxelPos;
+        BlockID id = BLOCK_AIR;
+        for (u32 i = 0; i < count; i++) {
+            r.read(voxelPos);
+            r.read(id);
+            replay(voxelPos, id);
+            i32v3 chunkPos = toChunkPosition(voxelPos);
+            if (chunkPos != last) segment.chunks.insert(chunkPos);
+            last = chunkPos;
+        }
+        m_stats.replayed += count;
+    }
+    fclose(file);
+}
+
+std::string openvox::EditJournal::getSegmentPath(u32 index) const {
+    char name[32];
+    snprintf(name, sizeof(name), "/journal.%06u.ovj", index);
+    return m_directory + name;
+}
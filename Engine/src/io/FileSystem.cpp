@@ -0,0 +1,96 @@
+#include "io/FileSystem.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <direct.h>
+#include <io.h>
+#else
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+bool openvox::syncFile(FILE* file) {
+    if (fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(__linux__)
+    return fdatasync(fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+bool openvox::seekFile(FILE* file, u64 offset) {
+#if defined(_WIN32)
+    return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+u64 openvox::getFileSize(FILE* file) {
+#if defined(_WIN32)
+    _fseeki64(file, 0, SEEK_END);
+    return (u64)_ftelli64(file);
+#else
+    fseeko(file, 0, SEEK_END);
+    return (u64)ftello(file);
+#endif
+}
+
+bool openvox::syncDirectory(const std::string& path) {
+#if defined(_WIN32)
+    // NTFS journals directory changes itself
+    (void)path;
+    return true;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool ok = fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+bool openvox::makeDirectory(const std::string& path) {
+#if defined(_WIN32)
+    if (_mkdir(path.c_str()) == 0) return true;
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#else
+    if (mkdir(path.c_str(), 0755) == 0) return true;
+    struct stat s;
+    return errno == EEXIST && stat(path.c_str(), &s) == 0 && S_ISDIR(s.st_mode);
+#endif
+}
+
+bool openvox::listDirectory(const std::string& path, OUT std::vector<std::string>& names) {
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE) return false;
+    do {
+        if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)) names.push_back(data.cFileName);
+    } while (FindNextFileA(find, &data));
+    FindClose(find);
+#else
+    DIR* dir = opendir(path.c_str());
+    if (!dir) return false;
+    while (dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+    }
+    closedir(dir);
+#endif
+    return true;
+}
+
+bool openvox::replaceFile(const std::string& from, const std::string& to) {
+#if defined(_WIN32)
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
@@ -0,0 +1,280 @@
+#include "io/RegionStore.h"
+
+#include <cstring>
+
+#include "OpenVoxAssert.hpp"
+#include "io/FileSystem.h"
+#include "io/Serialization.hpp"
+
+#define REGION_MAGIC 0x5256584F ///< "OXVR"
+#define REGION_VERSION 1
+#define REGION_ENTRY_SIZE 16
+// Entries start 16 bytes in so none of them straddles a disk sector and tears
+#define REGION_HEADER_SIZE (16 + REGION_SIZE * REGION_ENTRY_SIZE)
+#define PALETTE_NONE 0xFFFF
+
+namespace {
+    inline u32 getEntryIndex(const i32v3& chunkPos) {
+        const i32 m = REGION_WIDTH - 1;
+        return (u32)((chunkPos.y & m) << (REGION_WIDTH_BITS * 2) | (chunkPos.z & m) << REGION_WIDTH_BITS | (chunkPos.x & m));
+    }
+
+    inline u32 getPaletteBits(size_t paletteSize) {
+        u32 bits = 0;
+        while (((size_t)1 << bits) < paletteSize) bits++;
+        return bits;
+    }
+}
+
+openvox::RegionStore::RegionStore() :
+    m_paletteIndex(65536, PALETTE_NONE),
+    m_blocks(CHUNK_SIZE) {
+    // Empty
+}
+
+openvox::RegionStore::~RegionStore() {
+    close();
+}
+
+bool openvox::RegionStore::open(const std::string& directory) {
+    close();
+    if (!makeDirectory(directory)) return false;
+    m_directory = directory;
+    return true;
+}
+
+void openvox::RegionStore::close() {
+    sync();
+    for (auto& it : m_regions) {
+        fclose(it.second->file);
+        delete it.second;
+    }
+    m_regions.clear();
+}
+
+bool openvox::RegionStore::saveChunk(const i32v3& chunkPos, const BlockID* blocks) {
+    Region* region = getRegion(toRegionPosition(chunkPos), true);
+    if (!region) return false;
+
+    encodeChunk(chunkPos, blocks, m_buffer);
+    if (!seekFile(region->file, region->end) || fwrite(m_buffer.data(), 1, m_buffer.size(), region->file) != m_buffer.size()) return false;
+
+    u32 index = getEntryIndex(chunkPos);
+    Entry& entry = region->stagedEntries[index];
+    if (!entry.offset) region->staged.push_back(index);
+    entry.offset = region->end;
+    entry.size = (u32)m_buffer.size();
+    entry.crc = crc32(m_buffer.data(), m_buffer.size());
+    region->end += m_buffer.size();
+    return true;
+}
+
+bool openvox::RegionStore::loadChunk(OUT Chunk& chunk) {
+    Region* region = getRegion(toRegionPosition(chunk.getChunkPosition()), false);
+    if (!region) return false;
+
+    // Chunks saved since the last sync are read back before the table points at them
+    u32 index = getEntryIndex(chunk.getChunkPosition());
+    const Entry& entry = region->stagedEntries[index].offset ? region->stagedEntries[index] : region->entries[index];
+    if (!entry.offset) return false;
+
+    m_buffer.resize(entry.size);
+    if (!seekFile(region->file, entry.offset) || fread(m_buffer.data(), 1, entry.size, region->file) != entry.size) return false;
+    if (crc32(m_buffer.data(), entry.size) != entry.crc) return false;
+    return decodeChunk(m_buffer.data(), entry.size, chunk);
+}
+
+bool openvox::RegionStore::sync() {
+    bool ok = true;
+    for (auto& it : m_regions) {
+        if (!syncRegion(*it.second)) ok = false;
+    }
+    return ok;
+}
+
+bool openvox::RegionStore::compact() {
+    bool ok = sync();
+    for (auto& it : m_regions) {
+        Region& region = *it.second;
+        if (region.end - REGION_HEADER_SIZE > region.liveSize * 2 && !compactRegion(region)) ok = false;
+    }
+    return ok;
+}
+
+openvox::RegionStore::Region* openvox::RegionStore::getRegion(const i32v3& regionPos, bool create) {
+    auto it = m_regions.find(regionPos);
+    if (it != m_regions.end()) return it->second;
+    if (m_directory.empty()) return nullptr;
+
+    char name[64];
+    snprintf(name, sizeof(name), "/r.%d.%d.%d.ovr", regionPos.x, regionPos.y, regionPos.z);
+    std::string path = m_directory + name;
+
+    u8 header[REGION_HEADER_SIZE];
+    FILE* file = fopen(path.c_str(), "r+b");
+    if (file) {
+        if (fread(header, 1, REGION_HEADER_SIZE, file) != REGION_HEADER_SIZE ||
+            SerialTraits<u32>::load(header) != REGION_MAGIC ||
+            SerialTraits<u32>::load(header + 4) != REGION_VERSION) {
+            fclose(file);
+            return nullptr;
+        }
+    } else {
+        if (!create) return nullptr;
+        file = fopen(path.c_str(), "w+b");
+        if (!file) return nullptr;
+        std::memset(header, 0, REGION_HEADER_SIZE);
+        SerialTraits<u32>::store(header, REGION_MAGIC);
+        SerialTraits<u32>::store(header + 4, REGION_VERSION);
+        if (fwrite(header, 1, REGION_HEADER_SIZE, file) != REGION_HEADER_SIZE || !syncFile(file) || !syncDirectory(m_directory)) {
+            fclose(file);
+            return nullptr;
+        }
+    }
+
+    Region* region = new Region;
+    region->file = file;
+    region->path = path;
+    region->end = getFileSize(file);
+    region->liveSize = 0;
+    std::memset(region->stagedEntries, 0, sizeof(region->stagedEntries));
+    for (u32 i = 0; i < REGION_SIZE; i++) {
+        const u8* p = header + 16 + i * REGION_ENTRY_SIZE;
+        Entry& entry = region->entries[i];
+        entry.offset = SerialTraits<u64>::load(p);
+        entry.size = SerialTraits<u32>::load(p + 8);
+        entry.crc = SerialTraits<u32>::load(p + 12);
+        // Points past the end of a truncated file
+        if (entry.offset < REGION_HEADER_SIZE || entry.offset + entry.size > region->end) entry.offset = 0;
+        if (entry.offset) region->liveSize += entry.size;
+    }
+    m_regions[regionPos] = region;
+    return region;
+}
+
+bool openvox::RegionStore::syncRegion(Region& region) {
+    if (region.staged.empty()) return true;
+    // The data must be durable before any entry points at it
+    if (!syncFile(region.file)) return false;
+
+    u8 p[REGION_ENTRY_SIZE];
+    for (u32 index : region.staged) {
+        const Entry& staged = region.stagedEntries[index];
+        SerialTraits<u64>::store(p, staged.offset);
+        SerialTraits<u32>::store(p + 8, staged.size);
+        SerialTraits<u32>::store(p + 12, staged.crc);
+        if (!seekFile(region.file, 16 + index * REGION_ENTRY_SIZE) || fwrite(p, 1, REGION_ENTRY_SIZE, region.file) != REGION_ENTRY_SIZE) return false;
+    }
+    if (!syncFile(region.file)) return false;
+
+    for (u32 index : region.staged) {
+        Entry& entry = region.entries[index];
+        Entry& staged = region.stagedEntries[index];
+        if (entry.offset) region.liveSize -= entry.size;
+        region.liveSize += staged.size;
+        entry = staged;
+        staged.offset = 0;
+    }
+    region.staged.clear();
+    return true;
+}
+
+bool openvox::RegionStore::compactRegion(Region& region) {
+    std::string tempPath = region.path + ".tmp";
+    FILE* file = fopen(tempPath.c_str(), "w+b");
+    if (!file) return false;
+
+    // Live chunks are copied back to back after a header pointing at their new offsets
+    std::vector<u8> data(REGION_HEADER_SIZE, 0);
+    SerialTraits<u32>::store(&data[0], REGION_MAGIC);
+    SerialTraits<u32>::store(&data[4], REGION_VERSION);
+    Entry entries[REGION_SIZE];
+    bool ok = true;
+    for (u32 i = 0; i < REGION_SIZE && ok; i++) {
+        entries[i] = region.entries[i];
+        if (!entries[i].offset) continue;
+        size_t offset = data.size();
+        data.resize(offset + entries[i].size);
+        ok = seekFile(region.file, entries[i].offset) && fread(&data[offset], 1, entries[i].size, region.file) == entries[i].size;
+        entries[i].offset = offset;
+
+        u8* p = &data[16 + i * REGION_ENTRY_SIZE];
+        SerialTraits<u64>::store(p, entries[i].offset);
+        SerialTraits<u32>::store(p + 8, entries[i].size);
+        SerialTraits<u32>::store(p + 12, entries[i].crc);
+    }
+    ok = ok && fwrite(data.data(), 1, data.size(), file) == data.size() && syncFile(file);
+    fclose(file);
+    if (!ok) {
+        remove(tempPath.c_str());
+        return false;
+    }
+
+    // The old file stays in place if the rename fails, and its entries with it
+    fclose(region.file);
+    ok = replaceFile(tempPath, region.path);
+    if (ok) {
+        std::memcpy(region.entries, entries, sizeof(entries));
+        ok = syncDirectory(m_directory);
+    } else {
+        remove(tempPath.c_str());
+    }
+    region.file = fopen(region.path.c_str(), "r+b");
+    openvox_assert(region.file, "Region file could not be reopened after compaction");
+    region.end = getFileSize(region.file);
+    return ok;
+}
+
+void openvox::RegionStore::encodeChunk(const i32v3& chunkPos, const BlockID* blocks, OUT std::vector<u8>& data) {
+    m_palette.clear();
+    BlockID last = blocks[0];
+    m_paletteIndex[last] = 0;
+    m_palette.push_back(last);
+    for (int i = 1; i < CHUNK_SIZE; i++) {
+        if (blocks[i] == last) continue;
+        last = blocks[i];
+        if (m_paletteIndex[last] == PALETTE_NONE) {
+            m_paletteIndex[last] = (u16)m_palette.size();
+            m_palette.push_back(last);
+        }
+    }
+
+    data.clear();
+    {
+        BinaryWriter w(data);
+        w.write(chunkPos);
+        w.writeVarint(m_palette.size());
+        w.writeArray(m_palette.data(), m_palette.size());
+        u32 bits = getPaletteBits(m_palette.size());
+        if (bits) {
+            for (int i = 0; i < CHUNK_SIZE; i++) w.writeBits(m_paletteIndex[blocks[i]], bits);
+        }
+    }
+    for (BlockID id : m_palette) m_paletteIndex[id] = PALETTE_NONE;
+}
+
+bool openvox::RegionStore::decodeChunk(const u8* data, size_t size, OUT Chunk& chunk) {
+    BinaryReader r(data, size);
+    i32v3 chunkPos;
+    size_t paletteSize;
+    BinaryArrayView<u16> palette;
+    if (!r.read(chunkPos) || chunkPos != chunk.getChunkPosition()) return false;
+    if (!r.readVarint(paletteSize) || !paletteSize || paletteSize > CHUNK_SIZE) return false;
+    if (!r.readArray(paletteSize, palette)) return false;
+    m_palette.resize(paletteSize);
+    palette.copyTo(m_palette.data());
+
+    u32 bits = getPaletteBits(paletteSize);
+    if (!bits) {
+        chunk.fill(m_palette[0]);
+        return true;
+    }
+    u32 index;
+    for (int i = 0; i < CHUNK_SIZE; i++) {
+        if (!r.readBits(bits, index) || index >= paletteSize) return false;
+        m_blocks[i] = m_palette[index];
+    }
+    std::memcpy(chunk.getMutableBlockData(), m_blocks.data(), sizeof(BlockID) * CHUNK_SIZE);
+    chunk.updateOccupancy();
+    return true;
+}
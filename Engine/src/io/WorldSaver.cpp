@@ -0,0 +1,64 @@
+#include "io/WorldSaver.h"
+
+#include <chrono>
+
+#include "io/RegionStore.h"
+#include "voxel/ChunkMap.h"
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    inline f32 secondsSince(const Clock::time_point& start) {
+        return std::chrono::duration<f32>(Clock::now() - start).count();
+    }
+}
+
+openvox::WorldSaver::WorldSaver() :
+    m_saving(false) {
+    m_stats.snapshotTime = 0.0f;
+    m_stats.saveTime = 0.0f;
+    m_stats.chunks = 0;
+    m_stats.succeeded = true;
+}
+
+openvox::WorldSaver::~WorldSaver() {
+    wait();
+}
+
+bool openvox::WorldSaver::save(const ChunkMap& chunks, RegionStore& regions) {
+    if (isSaving()) return false;
+    if (m_thread.joinable()) m_thread.join();
+
+    Clock::time_point start = Clock::now();
+    m_snapshot.capture(chunks);
+    m_stats.snapshotTime = secondsSince(start);
+    m_stats.saveTime = 0.0f;
+    m_stats.chunks = m_snapshot.size();
+    m_stats.succeeded = false;
+
+    m_saving.store(true, std::memory_order_release);
+    m_thread = std::thread(&WorldSaver::run, this, &regions);
+    return true;
+}
+
+bool openvox::WorldSaver::wait() {
+    if (m_thread.joinable()) m_thread.join();
+    return m_stats.succeeded;
+}
+
+void openvox::WorldSaver::run(RegionStore* regions) {
+    Clock::time_point start = Clock::now();
+    bool ok = true;
+    const std::vector<WorldSnapshot::Entry>& entries = m_snapshot.getEntries();
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (!regions->saveChunk(entries[i].chunkPos, entries[i].data->blocks)) ok = false;
+        // Writes to the chunk no longer need to clone it
+        m_snapshot.release(i);
+    }
+    if (!regions->sync()) ok = false;
+    m_snapshot.clear();
+
+    m_stats.saveTime = secondsSince(start);
+    m_stats.succeeded = ok;
+    m_saving.store(false, std::memory_order_release);
+}
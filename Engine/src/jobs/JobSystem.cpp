@@ -0,0 +1,105 @@
+#include "jobs/JobSystem.h"
+
+openvox::JobSystem::~JobSystem() {
+    dispose();
+}
+
+void openvox::JobSystem::init(u32 threadCount /*= 0*/) {
+    if (isInitialized()) return;
+    if (threadCount == 0) {
+        u32 hw = std::thread::hardware_concurrency();
+        threadCount = hw > 1 ? hw - 1 : 1;
+    }
+    m_quit = false;
+    for (u32 i = 0; i < threadCount; i++) {
+        m_workers.emplace_back(&JobSystem::workerMain, this);
+    }
+}
+
+void openvox::JobSystem::dispose() {
+    if (!isInitialized()) return;
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        m_quit = true;
+    }
+    m_cond.notify_all();
+    for (auto& t : m_workers) t.join();
+    std::vector<std::thread>().swap(m_workers);
+
+    // Anything still queued runs on the disposing thread so no counter is left pending
+    while (runOne()) continue;
+}
+
+void openvox::JobSystem::schedule(Job job, OPT JobCounter* counter /*= nullptr*/) {
+    if (counter) counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    if (!isInitialized()) {
+        // No workers, run inline
+        QueuedJob j = { std::move(job), counter };
+        execute(j);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        m_queue.push_back({ std::move(job), counter });
+    }
+    m_cond.notify_one();
+}
+
+void openvox::JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        if (!runOne()) std::this_thread::yield();
+    }
+}
+
+void openvox::JobSystem::parallelFor(size_t count, size_t grainSize, const RangeJob& f) {
+    if (count == 0) return;
+    if (grainSize == 0) grainSize = 1;
+
+    // Aim for a few ranges per thread so uneven ranges balance out
+    size_t ranges = (size_t)getConcurrency() * 4;
+    size_t rangeSize = (count + ranges - 1) / ranges;
+    if (rangeSize < grainSize) rangeSize = grainSize;
+    if (rangeSize >= count) {
+        f(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (size_t begin = rangeSize; begin < count; begin += rangeSize) {
+        size_t end = begin + rangeSize < count ? begin + rangeSize : count;
+        schedule([&f, begin, end]() { f(begin, end); }, &counter);
+    }
+    f(0, rangeSize);
+    wait(counter);
+}
+
+void openvox::JobSystem::workerMain() {
+    for (;;) {
+        QueuedJob j;
+        {
+            std::unique_lock<std::mutex> l(m_lock);
+            m_cond.wait(l, [this]() { return m_quit || !m_queue.empty(); });
+            if (m_queue.empty()) return;
+            j = std::move(m_queue.front());
+            m_queue.pop_front();
+        }
+        execute(j);
+    }
+}
+
+bool openvox::JobSystem::runOne() {
+    QueuedJob j;
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        if (m_queue.empty()) return false;
+        j = std::move(m_queue.front());
+        m_queue.pop_front();
+    }
+    execute(j);
+    return true;
+}
+
+void openvox::JobSystem::execute(QueuedJob& j) {
+    j.job();
+    if (j.counter) j.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,138 @@
+#include "mesh/CellShape.h"
+
+#include <algorithm>
+
+#include "OpenVoxAssert.hpp"
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    openvox::CellShape makeCube() {
+        openvox::CellShape cube;
+        for (int i = 0; i < 8; i++) cube.addPoint(f32v3((f32)(i & 1), (f32)((i >> 1) & 1), (f32)((i >> 2) & 1)));
+        const int faces[6][4] = { { 0, 2, 6, 4 }, { 1, 3, 7, 5 }, { 0, 1, 5, 4 },
+                                  { 2, 3, 7, 6 }, { 0, 1, 3, 2 }, { 4, 5, 7, 6 } };
+        for (int f = 0; f < 6; f++) cube.addFace(faces[f], 4);
+        cube.finish();
+        return cube;
+    }
+}
+
+void openvox::CellShape::finish() {
+    f32v3 center(0.0f);
+    for (const f32v3& p : m_points) center += p;
+    center /= (f32)m_points.size();
+    for (std::vector<int>& face : m_faces) {
+        // Newell's method gives the normal of the winding
+        f32v3 normal(0.0f);
+        f32v3 faceCenter(0.0f);
+        for (size_t k = 0; k < face.size(); k++) {
+            const f32v3& p = m_points[face[k]];
+            const f32v3& q = m_points[face[(k + 1) % face.size()]];
+            normal.x += (p.y - q.y) * (p.z + q.z);
+            normal.y += (p.z - q.z) * (p.x + q.x);
+            normal.z += (p.x - q.x) * (p.y + q.y);
+            faceCenter += p;
+        }
+        faceCenter /= (f32)face.size();
+        if (openvoxm::dot(normal, faceCenter - center) < 0.0f) std::reverse(face.begin(), face.end());
+        for (size_t k = 0; k < face.size(); k++) {
+            int a = face[k];
+            int b = face[(k + 1) % face.size()];
+            if (findEdge(a, b) < 0) {
+                m_edges.push_back(i32v2(std::min(a, b), std::max(a, b)));
+                m_edgeFaces.push_back(0);
+            }
+            m_edgeFaces[findEdge(a, b)] |= 1u << (&face - m_faces.data());
+        }
+    }
+    openvox_assert(m_points.size() <= 32 && m_faces.size() <= 32 && m_edges.size() <= 256, "Cell shape too large");
+}
+
+void openvox::CellShape::getLoops(u32 inside, OUT std::vector<std::vector<int> >& loops) const {
+    loops.clear();
+    std::vector<int> next(m_edges.size(), -1);
+    std::vector<int> crossings;
+    std::vector<bool> entering;
+    for (const std::vector<int>& face : m_faces) {
+        crossings.clear();
+        entering.clear();
+        for (size_t k = 0; k < face.size(); k++) {
+            int a = face[k];
+            int b = face[(k + 1) % face.size()];
+            bool insideA = (inside >> a) & 1;
+            bool insideB = (inside >> b) & 1;
+            if (insideA == insideB) continue;
+            crossings.push_back(findEdge(a, b));
+            entering.push_back(insideB);
+        }
+        for (size_t j = 0; j < crossings.size(); j++) {
+            if (entering[j]) next[crossings[j]] = crossings[(j + 1) % crossings.size()];
+        }
+    }
+
+    std::vector<bool> visited(m_edges.size(), false);
+    for (size_t e = 0; e < next.size(); e++) {
+        if (next[e] < 0 || visited[e]) continue;
+        loops.push_back(std::vector<int>());
+        for (int i = (int)e; !visited[i]; i = next[i]) {
+            visited[i] = true;
+            loops.back().push_back(i);
+        }
+    }
+}
+
+void openvox::CellShape::triangulate(u32 inside, OUT std::vector<u8>& triangles) const {
+    std::vector<std::vector<int> > loops;
+    getLoops(inside, loops);
+    std::vector<f32v3> midpoints;
+    for (const std::vector<int>& loop : loops) {
+        size_t n = loop.size();
+        midpoints.resize(n);
+        f32v3 loopNormal(0.0f);
+        for (size_t k = 0; k < n; k++) {
+            const i32v2& edge = m_edges[loop[k]];
+            midpoints[k] = (m_points[edge.x] + m_points[edge.y]) * 0.5f;
+        }
+        for (size_t k = 0; k < n; k++) loopNormal += openvoxm::cross(midpoints[k], midpoints[(k + 1) % n]);
+        loopNormal /= openvoxm::max(openvoxm::length(loopNormal), 1e-6f);
+
+        // Fan from the corner whose triangles all face most the way the loop does, so fans
+        // of bent loops do not fold over themselves. Diagonals along a face of the cell would
+        // meet the neighboring cell's surface there, so corners without them come first.
+        size_t apex = 0;
+        f32 bestScore = -4.0f;
+        for (size_t a = 0; a < n && n > 3; a++) {
+            f32 minDot = 1.0f;
+            bool alongFace = false;
+            for (size_t k = 1; k + 1 < n; k++) {
+                f32v3 normal = openvoxm::cross(midpoints[(a + k) % n] - midpoints[a], midpoints[(a + k + 1) % n] - midpoints[a]);
+                f32 length = openvoxm::length(normal);
+                minDot = openvoxm::min(minDot, length > 0.0f ? openvoxm::dot(normal, loopNormal) / length : 0.0f);
+                if (k > 1 && (m_edgeFaces[loop[a]] & m_edgeFaces[loop[(a + k) % n]])) alongFace = true;
+            }
+            f32 score = alongFace ? minDot - 2.0f : minDot;
+            if (score > bestScore + 1e-4f) {
+                bestScore = score;
+                apex = a;
+            }
+        }
+        for (size_t k = 1; k + 1 < n; k++) {
+            triangles.push_back((u8)loop[apex]);
+            triangles.push_back((u8)loop[(apex + k) % n]);
+            triangles.push_back((u8)loop[(apex + k + 1) % n]);
+        }
+    }
+}
+
+int openvox::CellShape::findEdge(int a, int b) const {
+    i32v2 edge(std::min(a, b), std::max(a, b));
+    for (size_t i = 0; i < m_edges.size(); i++) {
+        if (m_edges[i] == edge) return (int)i;
+    }
+    return -1;
+}
+
+const openvox::CellShape& openvox::CellShape::getCube() {
+    static const CellShape cube = makeCube();
+    return cube;
+}
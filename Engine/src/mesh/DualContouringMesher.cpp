@@ -0,0 +1,581 @@
+#include "mesh/DualContouringMesher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mesh/CellShape.h"
+
+#define NO_VERTEX 0xFFFFFFFFu ///< Cell or node without surface
+#define COMPLEX_NODE 0xFFFFFFFEu ///< Node with surface that cannot be merged
+#define QEF_EIGEN_THRESHOLD 0.1f ///< Eigenvalues below this fraction of the largest are treated as 0
+#define QEF_JACOBI_SWEEPS 5
+#define QEF_BATCH 8 ///< Cells solved together, one per lane
+
+namespace {
+    const int GRID_WIDTH = CHUNK_WIDTH + 4; ///< Samples from -1 to CHUNK_WIDTH + 2
+    const int CELL_WIDTH = CHUNK_WIDTH + 1; ///< Cells from 0 to CHUNK_WIDTH
+
+    /// Surface pieces of every sign case of a cube
+    struct CubeTables {
+        CubeTables();
+
+        u8 componentCount[256];
+        i8 edgeComponent[256][12]; ///< Piece crossing each edge, -1 if none
+        i32v3 edgeStart[12];
+        int edgeAxis[12];
+        int edgeIndex[8][3]; ///< Edge leaving a corner along an axis, -1 if it leaves the cube
+    };
+
+    CubeTables::CubeTables() {
+        const openvox::CellShape& cube = openvox::CellShape::getCube();
+        const std::vector<i32v2>& edges = cube.getEdges();
+        for (int i = 0; i < 8; i++) {
+            for (int a = 0; a < 3; a++) edgeIndex[i][a] = -1;
+        }
+        for (int e = 0; e < 12; e++) {
+            int start = edges[e].x;
+            int step = edges[e].y - start;
+            edgeStart[e] = i32v3(start & 1, (start >> 1) & 1, (start >> 2) & 1);
+            edgeAxis[e] = step == 1 ? 0 : (step == 2 ? 1 : 2);
+            edgeIndex[start][edgeAxis[e]] = e;
+        }
+
+        std::vector<std::vector<int> > loops;
+        for (u32 i = 0; i < 256; i++) {
+            cube.getLoops(i, loops);
+            componentCount[i] = (u8)loops.size();
+            for (int e = 0; e < 12; e++) edgeComponent[i][e] = -1;
+            for (size_t j = 0; j < loops.size(); j++) {
+                for (int e : loops[j]) edgeComponent[i][e] = (i8)j;
+            }
+        }
+    }
+
+    const CubeTables& getTables() {
+        static const CubeTables tables;
+        return tables;
+    }
+
+    inline int gridIndex(int x, int y, int z) {
+        return ((z + 1) * GRID_WIDTH + (y + 1)) * GRID_WIDTH + (x + 1);
+    }
+
+    inline int cellIndex(const i32v3& cell) {
+        return (cell.z * CELL_WIDTH + cell.y) * CELL_WIDTH + cell.x;
+    }
+
+    /// Crossing of the edge from s0 one sample along axis, with the unit gradient interpolated there
+    f32 getCrossing(const i8* s0, const int* steps, int axis, OUT f32v3& normal) {
+        const i8* s1 = s0 + steps[axis];
+        f32 t = (f32)*s0 / (f32)(*s0 - *s1);
+        for (int i = 0; i < 3; i++) {
+            f32 g0 = (f32)(s0[steps[i]] - s0[-steps[i]]);
+            f32 g1 = (f32)(s1[steps[i]] - s1[-steps[i]]);
+            normal[i] = g0 + (g1 - g0) * t;
+        }
+        f32 length = openvoxm::length(normal);
+        if (length > 0.0f) normal /= length;
+        return t;
+    }
+
+    /// Multiplies a vector by the symmetric matrix stored as its upper triangle
+    inline f32v3 multiplySymmetric(const f32* m, const f32v3& v) {
+        return f32v3(m[0] * v.x + m[1] * v.y + m[2] * v.z,
+                     m[1] * v.x + m[3] * v.y + m[4] * v.z,
+                     m[2] * v.x + m[4] * v.y + m[5] * v.z);
+    }
+}
+
+openvox::DualContouringMesher::DualContouringMesher() :
+    m_samples(GRID_WIDTH * GRID_WIDTH * GRID_WIDTH),
+    m_cellCases(CELL_WIDTH * CELL_WIDTH * CELL_WIDTH),
+    m_cellVertices(CELL_WIDTH * CELL_WIDTH * CELL_WIDTH),
+    m_cellOwners(CHUNK_SIZE) {
+    for (u32 level = 0; level <= CHUNK_WIDTH_BITS; level++) {
+        u32 width = CHUNK_WIDTH >> level;
+        m_nodes[level].resize(width * width * width);
+    }
+    getTables();
+}
+
+void openvox::DualContouringMesher::mesh(const i32v3& chunkPos, u32 lod, const DensityFunc& density,
+                                         OUT PackedMesh& mesh, f32 maxError /*= DEFAULT_DUAL_CONTOURING_MAX_ERROR*/) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    m_vertices.clear();
+    sampleChunk(chunkPos * (CHUNK_WIDTH << lod), lod, density);
+    buildLeaves();
+    m_leafVertexCount = m_vertices.size();
+
+    std::fill(m_cellOwners.begin(), m_cellOwners.end(), NO_VERTEX);
+    u32 levels = 1;
+    if (maxError > 0.0f) {
+        while (levels <= CHUNK_WIDTH_BITS && buildLevel(levels, maxError)) levels++;
+    }
+    // Cells belong to the largest merged node holding them
+    for (u32 level = levels - 1; level > 0; level--) {
+        int width = CHUNK_WIDTH >> level;
+        int size = 1 << level;
+        for (int i = 0; i < width * width * width; i++) {
+            u32 vertex = m_nodes[level][i];
+            if (vertex >= COMPLEX_NODE) continue;
+            i32v3 min = i32v3(i % width, (i / width) % width, i / (width * width)) * size;
+            if (m_cellOwners[getVoxelIndex(min.x, min.y, min.z)] != NO_VERTEX) continue;
+            for (int z = 0; z < size; z++) {
+                for (int y = 0; y < size; y++) {
+                    u32* owners = &m_cellOwners[getVoxelIndex(min.x, min.y + y, min.z + z)];
+                    std::fill(owners, owners + size, vertex);
+                }
+            }
+        }
+    }
+
+    emitQuads(mesh);
+}
+
+void openvox::DualContouringMesher::sampleChunk(const i32v3& origin, u32 lod, const DensityFunc& density) {
+    i8* samples = m_samples.data();
+    // Multiplied rather than shifted, since the border starts at -1 and shifting negatives is undefined
+    int step = 1 << lod;
+    i32v3 pos;
+    for (int z = -1; z <= CHUNK_WIDTH + 2; z++) {
+        pos.z = origin.z + z * step;
+        for (int y = -1; y <= CHUNK_WIDTH + 2; y++) {
+            pos.y = origin.y + y * step;
+            for (int x = -1; x <= CHUNK_WIDTH + 2; x++) {
+                pos.x = origin.x + x * step;
+                *samples++ = density(pos);
+            }
+        }
+    }
+}
+
+void openvox::DualContouringMesher::buildLeaves() {
+    const CubeTables& tables = getTables();
+    const int steps[3] = { 1, GRID_WIDTH, GRID_WIDTH * GRID_WIDTH };
+    int corners[8];
+    for (int i = 0; i < 8; i++) corners[i] = gridIndex(i & 1, (i >> 1) & 1, (i >> 2) & 1) - gridIndex(0, 0, 0);
+    std::vector<u32>& leaves = m_nodes[0];
+    Qef qefs[4];
+
+    for (int z = 0; z < CELL_WIDTH; z++) {
+        for (int y = 0; y < CELL_WIDTH; y++) {
+            for (int x = 0; x < CELL_WIDTH; x++) {
+                const i8* cell = m_samples.data() + gridIndex(x, y, z);
+                u32 index = 0;
+                for (int i = 0; i < 8; i++) index |= (u32)(cell[corners[i]] < 0) << i;
+                i32v3 cellPos(x, y, z);
+                int ci = cellIndex(cellPos);
+                m_cellCases[ci] = (u8)index;
+                bool inChunk = x < CHUNK_WIDTH && y < CHUNK_WIDTH && z < CHUNK_WIDTH;
+                u32& leaf = leaves[inChunk ? (z * CHUNK_WIDTH + y) * CHUNK_WIDTH + x : 0];
+                if (index == 0 || index == 255) {
+                    m_cellVertices[ci] = NO_VERTEX;
+                    if (inChunk) leaf = NO_VERTEX;
+                    continue;
+                }
+
+                // Hermite data of the crossing edges, relative to the cell corner
+                u32 count = tables.componentCount[index];
+                for (u32 j = 0; j < count; j++) qefs[j].clear();
+                for (int e = 0; e < 12; e++) {
+                    int component = tables.edgeComponent[index][e];
+                    if (component < 0) continue;
+                    int axis = tables.edgeAxis[e];
+                    const i8* s0 = cell + corners[tables.edgeStart[e].x | tables.edgeStart[e].y << 1 | tables.edgeStart[e].z << 2];
+                    f32v3 point(tables.edgeStart[e]);
+                    f32v3 normal;
+                    point[axis] += getCrossing(s0, steps, axis, normal);
+                    qefs[component].add(point, normal);
+                }
+
+                // Placed after the loop, when all cells can be solved in batches
+                m_cellVertices[ci] = (u32)m_vertices.size();
+                for (u32 j = 0; j < count; j++) {
+                    CellVertex vertex;
+                    vertex.qef = qefs[j];
+                    vertex.position = f32v3(cellPos);
+                    vertex.meshIndex = NO_VERTEX;
+                    m_vertices.push_back(vertex);
+                }
+                if (!inChunk) continue;
+                bool border = x == 0 || y == 0 || z == 0 || x == CHUNK_WIDTH - 1 || y == CHUNK_WIDTH - 1 || z == CHUNK_WIDTH - 1;
+                leaf = count == 1 && !border ? m_cellVertices[ci] : COMPLEX_NODE;
+            }
+        }
+    }
+    solveVertices(m_vertices.data(), m_vertices.size(), 1.0f, nullptr);
+}
+
+bool openvox::DualContouringMesher::buildLevel(u32 level, f32 maxError) {
+    const CubeTables& tables = getTables();
+    const std::vector<u32>& children = m_nodes[level - 1];
+    std::vector<u32>& nodes = m_nodes[level];
+    int width = CHUNK_WIDTH >> level;
+    int childWidth = width * 2;
+    int size = 1 << level;
+    int half = size / 2;
+    m_candidates.clear();
+    m_candidateNodes.clear();
+
+    for (int z = 0; z < width; z++) {
+        for (int y = 0; y < width; y++) {
+            for (int x = 0; x < width; x++) {
+                u32& node = nodes[(z * width + y) * width + x];
+                i32v3 min = i32v3(x, y, z) * size;
+                Qef qef;
+                qef.clear();
+                bool complex = false;
+                for (int i = 0; i < 8 && !complex; i++) {
+                    i32v3 child(x * 2 + (i & 1), y * 2 + ((i >> 1) & 1), z * 2 + ((i >> 2) & 1));
+                    u32 vertex = children[(child.z * childWidth + child.y) * childWidth + child.x];
+                    complex = vertex == COMPLEX_NODE;
+                    if (vertex < COMPLEX_NODE) qef.add(m_vertices[vertex].qef, f32v3(child * half - min));
+                }
+                node = complex ? COMPLEX_NODE : NO_VERTEX;
+                if (complex || !qef.count) continue;
+
+                node = COMPLEX_NODE;
+                u32 index = 0;
+                for (int i = 0; i < 8; i++) {
+                    index |= (u32)(m_samples[gridIndex(min.x + (i & 1) * size, min.y + ((i >> 1) & 1) * size, min.z + (i >> 2) * size)] < 0) << i;
+                }
+                if (tables.componentCount[index] != 1 || !isTopologySafe(min, size)) continue;
+
+                CellVertex vertex;
+                vertex.qef = qef;
+                vertex.position = f32v3(min);
+                vertex.meshIndex = NO_VERTEX;
+                m_candidates.push_back(vertex);
+                m_candidateNodes.push_back((u32)(&node - nodes.data()));
+            }
+        }
+    }
+
+    // Nodes of a level only depend on the level below, so candidates are solved together
+    m_candidateErrors.resize(m_candidates.size());
+    solveVertices(m_candidates.data(), m_candidates.size(), (f32)size, m_candidateErrors.data());
+    bool merged = false;
+    for (size_t i = 0; i < m_candidates.size(); i++) {
+        if (m_candidateErrors[i] > maxError) continue;
+        nodes[m_candidateNodes[i]] = (u32)m_vertices.size();
+        m_vertices.push_back(m_candidates[i]);
+        merged = true;
+    }
+    return merged;
+}
+
+bool openvox::DualContouringMesher::isTopologySafe(const i32v3& min, int size) const {
+    // The sign at the middle of every edge, face and the node must match one of the corners
+    // around it, otherwise merging would lose a tunnel or a pocket
+    int half = size / 2;
+    bool inside[27];
+    for (int i = 0; i < 27; i++) {
+        inside[i] = m_samples[gridIndex(min.x + (i % 3) * half, min.y + ((i / 3) % 3) * half, min.z + (i / 9) * half)] < 0;
+    }
+    for (int i = 0; i < 27; i++) {
+        int c[3] = { i % 3, (i / 3) % 3, i / 9 };
+        int middle = (c[0] == 1) + (c[1] == 1) + (c[2] == 1);
+        if (middle == 0) continue;
+        bool matched = false;
+        for (int k = 0; k < (1 << middle) && !matched; k++) {
+            int corner[3];
+            int bit = 0;
+            for (int a = 0; a < 3; a++) corner[a] = c[a] == 1 ? ((k >> bit++) & 1) * 2 : c[a];
+            matched = inside[corner[0] + corner[1] * 3 + corner[2] * 9] == inside[i];
+        }
+        if (!matched) return false;
+    }
+    return true;
+}
+
+void openvox::DualContouringMesher::emitQuads(OUT PackedMesh& mesh) {
+    const CubeTables& tables = getTables();
+    const int steps[3] = { 1, GRID_WIDTH, GRID_WIDTH * GRID_WIDTH };
+    m_faceVertices.clear();
+    u32 firstFaceVertex = (u32)m_vertices.size();
+    for (int z = 0; z <= CHUNK_WIDTH; z++) {
+        for (int y = 0; y <= CHUNK_WIDTH; y++) {
+            for (int x = 0; x <= CHUNK_WIDTH; x++) {
+                i32v3 p(x, y, z);
+                const i8* s = m_samples.data() + gridIndex(x, y, z);
+                for (int axis = 0; axis < 3; axis++) {
+                    // This chunk owns the edges that start in it, which touch cells 0 to CHUNK_WIDTH
+                    int b = (axis + 1) % 3;
+                    int c = (axis + 2) % 3;
+                    if (p[axis] == CHUNK_WIDTH || p[b] == 0 || p[c] == 0) continue;
+                    bool inside = *s < 0;
+                    if (inside == (s[steps[axis]] < 0)) continue;
+
+                    // Cells around the edge, counter clockwise seen from its end
+                    i32v3 cells[4] = { p, p, p, p };
+                    cells[0][b]--;
+                    cells[0][c]--;
+                    cells[1][c]--;
+                    cells[3][b]--;
+                    u32 v[4];
+                    for (int k = 0; k < 4; k++) {
+                        i32v3 corner = p - cells[k];
+                        v[k] = getCellVertex(cells[k], tables.edgeIndex[corner.x | corner.y << 1 | corner.z << 2][axis]);
+                    }
+                    // Tubes through a face between two cells get a vertex on the face between them
+                    u32 polygon[8];
+                    int count = 0;
+                    for (int k = 0; k < 4; k++) {
+                        polygon[count++] = v[k];
+                        u32 face = getFaceVertex(p, axis, cells[k], cells[(k + 1) % 4], v[k], v[(k + 1) % 4]);
+                        if (face != NO_VERTEX) polygon[count++] = face;
+                    }
+                    if (!inside) std::reverse(polygon + 1, polygon + count);
+
+                    // Merged nodes repeat vertices, leaving a triangle or nothing
+                    u32 unique[8];
+                    int uniqueCount = 0;
+                    int fan = -1;
+                    for (int k = 0; k < count; k++) {
+                        if (polygon[k] == polygon[(k + count - 1) % count]) continue;
+                        if (polygon[k] >= firstFaceVertex && fan < 0) fan = uniqueCount;
+                        unique[uniqueCount++] = polygon[k];
+                    }
+                    if (uniqueCount == 3) {
+                        for (int k = 0; k < 3; k++) mesh.indices.push_back(getMeshIndex(unique[k], mesh));
+                    } else if (uniqueCount == 4 && fan < 0) {
+                        // Split along the shorter diagonal
+                        const f32v3& p0 = m_vertices[unique[0]].position;
+                        const f32v3& p1 = m_vertices[unique[1]].position;
+                        const f32v3& p2 = m_vertices[unique[2]].position;
+                        const f32v3& p3 = m_vertices[unique[3]].position;
+                        int first = openvoxm::lengthSquared(p2 - p0) <= openvoxm::lengthSquared(p3 - p1) ? 0 : 1;
+                        u32 indices[4];
+                        for (int k = 0; k < 4; k++) indices[k] = getMeshIndex(unique[(first + k) % 4], mesh);
+                        const u32 triangles[6] = { indices[0], indices[1], indices[2], indices[0], indices[2], indices[3] };
+                        mesh.indices.insert(mesh.indices.end(), triangles, triangles + 6);
+                    } else if (uniqueCount > 3) {
+                        // Fan from the face vertex, which sits between the cell vertices
+                        u32 center = getMeshIndex(unique[fan], mesh);
+                        for (int k = 1; k + 1 < uniqueCount; k++) {
+                            mesh.indices.push_back(center);
+                            mesh.indices.push_back(getMeshIndex(unique[(fan + k) % uniqueCount], mesh));
+                            mesh.indices.push_back(getMeshIndex(unique[(fan + k + 1) % uniqueCount], mesh));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+u32 openvox::DualContouringMesher::getFaceVertex(const i32v3& edgeStart, int axis, const i32v3& cellA, const i32v3& cellB,
+                                                 u32 vertexA, u32 vertexB) {
+    if (vertexA == vertexB) return NO_VERTEX;
+    const CubeTables& tables = getTables();
+    const int steps[3] = { 1, GRID_WIDTH, GRID_WIDTH * GRID_WIDTH };
+    int normalAxis = cellA.x != cellB.x ? 0 : (cellA.y != cellB.y ? 1 : 2);
+    int side = 3 - axis - normalAxis;
+    int direction = cellA[side] == edgeStart[side] ? 1 : -1;
+
+    // Only an ambiguous face, with its inside corners on a diagonal, has two segments
+    const i8* s = m_samples.data() + gridIndex(edgeStart.x, edgeStart.y, edgeStart.z);
+    const i8* across = s + direction * steps[side];
+    bool inside = *s < 0;
+    if ((*across < 0) == inside || (across[steps[axis]] < 0) != inside) return NO_VERTEX;
+    // It is a tube when both cells join the two segments into one piece
+    i32v3 parallel = edgeStart;
+    parallel[side] += direction;
+    i32v3 cornerA = parallel - cellA, cornerB = parallel - cellB;
+    if (getCellVertex(cellA, tables.edgeIndex[cornerA.x | cornerA.y << 1 | cornerA.z << 2][axis]) != vertexA ||
+        getCellVertex(cellB, tables.edgeIndex[cornerB.x | cornerB.y << 1 | cornerB.z << 2][axis]) != vertexB) {
+        return NO_VERTEX;
+    }
+
+    // Each segment cuts off an inside corner and joins the two crossings next to it
+    i32v3 faceMin = edgeStart;
+    faceMin[side] = openvoxm::min(edgeStart[side], edgeStart[side] + direction);
+    i32v3 corner = edgeStart;
+    if (!inside) corner[axis]++;
+    u64 key = (((u64)gridIndex(faceMin.x, faceMin.y, faceMin.z) * 3 + normalAxis) * 4) |
+              (u64)((corner[axis] - faceMin[axis]) | (corner[side] - faceMin[side]) << 1);
+    auto it = m_faceVertices.find(key);
+    if (it != m_faceVertices.end()) return it->second;
+
+    f32v3 normal;
+    f32v3 point(edgeStart - faceMin);
+    point[axis] += getCrossing(s, steps, axis, normal);
+    i32v3 otherStart = corner;
+    if (direction < 0) otherStart[side]--;
+    f32v3 otherNormal;
+    f32v3 otherPoint(otherStart - faceMin);
+    otherPoint[side] += getCrossing(m_samples.data() + gridIndex(otherStart.x, otherStart.y, otherStart.z), steps, side, otherNormal);
+
+    CellVertex vertex;
+    vertex.qef.clear();
+    vertex.qef.add(point, normal);
+    vertex.qef.add(otherPoint, otherNormal);
+    // Snapped like cell vertices, so the chunks on both sides of a seam agree
+    vertex.position = openvoxm::round((point + otherPoint) * (0.5f * PACKED_POSITION_SCALE)) / (f32)PACKED_POSITION_SCALE + f32v3(faceMin);
+    vertex.meshIndex = NO_VERTEX;
+    u32 index = (u32)m_vertices.size();
+    m_vertices.push_back(vertex);
+    m_faceVertices[key] = index;
+    return index;
+}
+
+u32 openvox::DualContouringMesher::getCellVertex(const i32v3& cell, int edge) const {
+    if (cell.x < CHUNK_WIDTH && cell.y < CHUNK_WIDTH && cell.z < CHUNK_WIDTH) {
+        u32 owner = m_cellOwners[getVoxelIndex(cell.x, cell.y, cell.z)];
+        if (owner != NO_VERTEX) return owner;
+    }
+    int ci = cellIndex(cell);
+    return m_cellVertices[ci] + getTables().edgeComponent[m_cellCases[ci]][edge];
+}
+
+u32 openvox::DualContouringMesher::getMeshIndex(u32 vertex, OUT PackedMesh& mesh) {
+    CellVertex& v = m_vertices[vertex];
+    if (v.meshIndex == NO_VERTEX) {
+        v.meshIndex = (u32)mesh.vertices.size();
+        mesh.vertices.push_back(packVertex(v.position, v.qef.normalSum));
+    }
+    return v.meshIndex;
+}
+
+void openvox::DualContouringMesher::Qef::clear() {
+    for (int i = 0; i < 6; i++) ata[i] = 0.0f;
+    atb = f32v3(0.0f);
+    btb = 0.0f;
+    pointSum = f32v3(0.0f);
+    normalSum = f32v3(0.0f);
+    count = 0;
+}
+
+void openvox::DualContouringMesher::Qef::add(const f32v3& point, const f32v3& normal) {
+    ata[0] += normal.x * normal.x;
+    ata[1] += normal.x * normal.y;
+    ata[2] += normal.x * normal.z;
+    ata[3] += normal.y * normal.y;
+    ata[4] += normal.y * normal.z;
+    ata[5] += normal.z * normal.z;
+    f32 b = openvoxm::dot(normal, point);
+    atb += normal * b;
+    btb += b * b;
+    pointSum += point;
+    normalSum += normal;
+    count++;
+}
+
+void openvox::DualContouringMesher::Qef::add(const Qef& other, const f32v3& offset) {
+    // Moving the planes by offset adds n.offset to each b
+    f32v3 ataOffset = multiplySymmetric(other.ata, offset);
+    for (int i = 0; i < 6; i++) ata[i] += other.ata[i];
+    atb += other.atb + ataOffset;
+    btb += other.btb + 2.0f * openvoxm::dot(offset, other.atb) + openvoxm::dot(offset, ataOffset);
+    pointSum += other.pointSum + offset * (f32)other.count;
+    normalSum += other.normalSum;
+    count += other.count;
+}
+
+void openvox::DualContouringMesher::solveVertices(CellVertex* vertices, size_t count, f32 size, OPT f32* errors) {
+    const int symmetric[3][3] = { { 0, 1, 2 }, { 1, 3, 4 }, { 2, 4, 5 } }; ///< Upper triangle index of each entry
+    const int pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+    // Lane l of every array belongs to one cell. Each step is a flat, branch free loop over
+    // the lanes, so the compiler vectorizes across cells.
+    f32 ata[6][QEF_BATCH], atb[3][QEF_BATCH], btb[QEF_BATCH], mass[3][QEF_BATCH], rhs[3][QEF_BATCH];
+    f32 a[3][3][QEF_BATCH], v[3][3][QEF_BATCH], c[QEF_BATCH], s[QEF_BATCH];
+    f32 position[3][QEF_BATCH], error[QEF_BATCH];
+
+    for (size_t first = 0; first < count; first += QEF_BATCH) {
+        size_t n = std::min((size_t)QEF_BATCH, count - first);
+        // Spare lanes repeat the last cell
+        for (int l = 0; l < QEF_BATCH; l++) {
+            const Qef& q = vertices[first + std::min((size_t)l, n - 1)].qef;
+            for (int i = 0; i < 6; i++) ata[i][l] = q.ata[i];
+            for (int i = 0; i < 3; i++) {
+                atb[i][l] = q.atb[i];
+                mass[i][l] = q.pointSum[i] / (f32)q.count;
+            }
+            btb[l] = q.btb;
+        }
+        for (int i = 0; i < 3; i++) {
+            // Solving around the mass point makes directions without planes fall back to it
+            for (int l = 0; l < QEF_BATCH; l++) {
+                rhs[i][l] = atb[i][l] - (ata[symmetric[i][0]][l] * mass[0][l] + ata[symmetric[i][1]][l] * mass[1][l] +
+                                         ata[symmetric[i][2]][l] * mass[2][l]);
+            }
+            for (int j = 0; j < 3; j++) {
+                for (int l = 0; l < QEF_BATCH; l++) {
+                    a[i][j][l] = ata[symmetric[i][j]][l];
+                    v[i][j][l] = i == j ? 1.0f : 0.0f;
+                }
+            }
+        }
+
+        // Jacobi rotations leave the eigenvalues on the diagonal of a and the eigenvectors in the columns of v
+        for (int sweep = 0; sweep < QEF_JACOBI_SWEEPS; sweep++) {
+            for (int k = 0; k < 3; k++) {
+                int p = pairs[k][0];
+                int q = pairs[k][1];
+                for (int l = 0; l < QEF_BATCH; l++) {
+                    // Already diagonal pairs rotate by 0 instead of branching
+                    bool skip = std::fabs(a[p][q][l]) < 1e-9f;
+                    f32 theta = (a[q][q][l] - a[p][p][l]) / (2.0f * (skip ? 1.0f : a[p][q][l]));
+                    f32 t = (theta >= 0.0f ? 1.0f : -1.0f) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0f));
+                    f32 cl = 1.0f / std::sqrt(t * t + 1.0f);
+                    c[l] = skip ? 1.0f : cl;
+                    s[l] = skip ? 0.0f : t * cl;
+                }
+                for (int i = 0; i < 3; i++) {
+                    for (int l = 0; l < QEF_BATCH; l++) {
+                        f32 ip = a[i][p][l], iq = a[i][q][l];
+                        a[i][p][l] = c[l] * ip - s[l] * iq;
+                        a[i][q][l] = s[l] * ip + c[l] * iq;
+                    }
+                }
+                for (int i = 0; i < 3; i++) {
+                    for (int l = 0; l < QEF_BATCH; l++) {
+                        f32 pi = a[p][i][l], qi = a[q][i][l];
+                        a[p][i][l] = c[l] * pi - s[l] * qi;
+                        a[q][i][l] = s[l] * pi + c[l] * qi;
+                    }
+                }
+                for (int i = 0; i < 3; i++) {
+                    for (int l = 0; l < QEF_BATCH; l++) {
+                        f32 ip = v[i][p][l], iq = v[i][q][l];
+                        v[i][p][l] = c[l] * ip - s[l] * iq;
+                        v[i][q][l] = s[l] * ip + c[l] * iq;
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < 3; i++) {
+            for (int l = 0; l < QEF_BATCH; l++) position[i][l] = mass[i][l];
+        }
+        for (int e = 0; e < 3; e++) {
+            for (int l = 0; l < QEF_BATCH; l++) {
+                f32 largest = std::max(a[0][0][l], std::max(a[1][1][l], a[2][2][l]));
+                f32 eigenvalue = a[e][e][l];
+                f32 along = v[0][e][l] * rhs[0][l] + v[1][e][l] * rhs[1][l] + v[2][e][l] * rhs[2][l];
+                f32 w = eigenvalue > QEF_EIGEN_THRESHOLD * largest ? along / eigenvalue : 0.0f;
+                for (int i = 0; i < 3; i++) position[i][l] += v[i][e][l] * w;
+            }
+        }
+        for (int i = 0; i < 3; i++) {
+            // Snapped to the packed precision, so a border cell meshed by both of its chunks packs the same
+            for (int l = 0; l < QEF_BATCH; l++) {
+                f32 p = std::min(std::max(position[i][l], 0.0f), size);
+                position[i][l] = std::round(p * (f32)PACKED_POSITION_SCALE) / (f32)PACKED_POSITION_SCALE;
+            }
+        }
+        for (int l = 0; l < QEF_BATCH; l++) {
+            f32 x = position[0][l], y = position[1][l], z = position[2][l];
+            f32 ax = ata[0][l] * x + ata[1][l] * y + ata[2][l] * z;
+            f32 ay = ata[1][l] * x + ata[3][l] * y + ata[4][l] * z;
+            f32 az = ata[2][l] * x + ata[4][l] * y + ata[5][l] * z;
+            error[l] = x * ax + y * ay + z * az - 2.0f * (x * atb[0][l] + y * atb[1][l] + z * atb[2][l]) + btb[l];
+        }
+
+        for (size_t l = 0; l < n; l++) {
+            vertices[first + l].position += f32v3(position[0][l], position[1][l], position[2][l]);
+            if (errors) errors[first + l] = error[l];
+        }
+    }
+}
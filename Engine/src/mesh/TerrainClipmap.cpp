@@ -0,0 +1,198 @@
+#include "mesh/TerrainClipmap.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include "OpenVoxAssert.hpp"
+
+namespace {
+    const i32v3 FACE_DIRECTIONS[6] = { i32v3(-1, 0, 0), i32v3(1, 0, 0), i32v3(0, -1, 0),
+                                       i32v3(0, 1, 0), i32v3(0, 0, -1), i32v3(0, 0, 1) };
+
+    inline i32 wrap(i32 a, i32 size) {
+        i32 r = a % size;
+        return r < 0 ? r + size : r;
+    }
+
+    inline bool isInside(const i32v3& p, const i32v3& min, const i32v3& max) {
+        return p.x >= min.x && p.y >= min.y && p.z >= min.z && p.x < max.x && p.y < max.y && p.z < max.z;
+    }
+}
+
+openvox::TerrainClipmap::TerrainClipmap(const TransvoxelMesher::DensityFunc& density, u32 levels /*= DEFAULT_CLIPMAP_LEVELS*/,
+                                        i32 radius /*= DEFAULT_CLIPMAP_RADIUS*/,
+                                        i32 verticalRadius /*= DEFAULT_CLIPMAP_VERTICAL_RADIUS*/) :
+    m_density(density),
+    m_size(radius * 2, verticalRadius * 2, radius * 2),
+    m_levels(levels),
+    m_cameraPos(0.0f) {
+    // Even radii keep every level on even chunks, so a level covers whole chunks of the next
+    openvox_assert(levels > 0 && radius >= 2 && verticalRadius >= 2 && !(radius & 1) && !(verticalRadius & 1),
+                   "Clipmap radii must be even and at least 2");
+    for (Level& level : m_levels) level.slots.resize(m_size.x * m_size.y * m_size.z);
+}
+
+openvox::TerrainClipmap::~TerrainClipmap() {
+    while (!m_counter.isDone()) std::this_thread::yield();
+    for (MeshJob* job : m_finished) delete job;
+}
+
+size_t openvox::TerrainClipmap::update(const f32v3& cameraPos, OPT JobSystem* jobs /*= nullptr*/) {
+    std::vector<MeshJob*> finished;
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        finished.swap(m_finished);
+    }
+    for (MeshJob* job : finished) finishJob(job);
+
+    // Center every level on the camera, snapped to even chunks
+    m_cameraPos = cameraPos;
+    for (u32 lod = 0; lod < m_levels.size(); lod++) {
+        Level& level = m_levels[lod];
+        f32 chunkWidth = (f32)(CHUNK_WIDTH << lod);
+        for (int i = 0; i < 3; i++) {
+            level.min[i] = 2 * (i32)std::floor((cameraPos[i] / chunkWidth + 1.0f) * 0.5f) - m_size[i] / 2;
+        }
+        if (lod == 0) {
+            level.holeMin = level.holeMax = level.min;
+        } else {
+            level.holeMin = m_levels[lod - 1].min / 2;
+            level.holeMax = level.holeMin + m_size / 2;
+        }
+    }
+
+    // Schedule the chunks whose slot does not hold their current mesh, finest first
+    size_t waiting = 0;
+    for (u32 lod = 0; lod < m_levels.size(); lod++) {
+        Level& level = m_levels[lod];
+        i32v3 max = level.min + m_size;
+        i32v3 p;
+        for (p.y = level.min.y; p.y < max.y; p.y++) {
+            for (p.z = level.min.z; p.z < max.z; p.z++) {
+                for (p.x = level.min.x; p.x < max.x; p.x++) {
+                    if (isInside(p, level.holeMin, level.holeMax)) continue;
+                    u8 faces = 0;
+                    for (int f = 0; f < 6; f++) {
+                        if (isInside(p + FACE_DIRECTIONS[f], level.holeMin, level.holeMax)) faces |= 1 << f;
+                    }
+                    Slot& slot = getSlot(level, p);
+                    if (slot.valid && slot.chunkPos == p && slot.transitionFaces == faces) continue;
+                    if (slot.running) {
+                        waiting++;
+                        continue;
+                    }
+
+                    MeshJob* job = new MeshJob;
+                    job->slot = &slot;
+                    job->chunkPos = p;
+                    job->lod = lod;
+                    job->transitionFaces = faces;
+                    slot.running = true;
+                    m_running++;
+                    m_meshedCount++;
+                    if (jobs) {
+                        jobs->schedule([this, job]() {
+                            runJob(job);
+                            std::lock_guard<std::mutex> l(m_lock);
+                            m_finished.push_back(job);
+                        }, &m_counter);
+                    } else {
+                        runJob(job);
+                        finishJob(job);
+                    }
+                }
+            }
+        }
+    }
+    return m_running + waiting;
+}
+
+void openvox::TerrainClipmap::flush(const f32v3& cameraPos, OPT JobSystem* jobs /*= nullptr*/) {
+    while (update(cameraPos, jobs)) {
+        if (jobs) jobs->wait(m_counter);
+    }
+}
+
+void openvox::TerrainClipmap::getVisibleChunks(OUT std::vector<ClipmapChunk>& chunks) const {
+    chunks.clear();
+    for (u32 lod = 0; lod < m_levels.size(); lod++) {
+        const Level& level = m_levels[lod];
+        i32v3 max = level.min + m_size;
+        i32v3 p;
+        for (p.y = level.min.y; p.y < max.y; p.y++) {
+            for (p.z = level.min.z; p.z < max.z; p.z++) {
+                for (p.x = level.min.x; p.x < max.x; p.x++) {
+                    if (isInside(p, level.holeMin, level.holeMax)) continue;
+                    const Slot* slot = getSlot(level, p);
+                    if (!slot->valid || slot->chunkPos != p || slot->mesh.indices.empty()) continue;
+                    ClipmapChunk chunk;
+                    chunk.chunkPos = p;
+                    chunk.lod = lod;
+                    chunk.mesh = &slot->mesh;
+                    chunks.push_back(chunk);
+                }
+            }
+        }
+    }
+}
+
+f32 openvox::TerrainClipmap::getViewDistance() const {
+    const Level& level = m_levels.back();
+    f32 chunkWidth = (f32)(CHUNK_WIDTH << (m_levels.size() - 1));
+    f32 distance = HUGE_VALF;
+    for (int i = 0; i < 3; i += 2) {
+        distance = std::min(distance, m_cameraPos[i] - level.min[i] * chunkWidth);
+        distance = std::min(distance, (level.min[i] + m_size[i]) * chunkWidth - m_cameraPos[i]);
+    }
+    return distance;
+}
+
+size_t openvox::TerrainClipmap::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const Level& level : m_levels) {
+        bytes += level.slots.size() * sizeof(Slot);
+        for (const Slot& slot : level.slots) {
+            bytes += slot.mesh.vertices.capacity() * sizeof(PackedVertex) + slot.mesh.indices.capacity() * sizeof(u32);
+        }
+    }
+    return bytes;
+}
+
+openvox::TerrainClipmap::Slot& openvox::TerrainClipmap::getSlot(Level& level, const i32v3& chunkPos) {
+    return level.slots[(wrap(chunkPos.y, m_size.y) * m_size.z + wrap(chunkPos.z, m_size.z)) * m_size.x + wrap(chunkPos.x, m_size.x)];
+}
+
+const openvox::TerrainClipmap::Slot* openvox::TerrainClipmap::getSlot(const Level& level, const i32v3& chunkPos) const {
+    return &level.slots[(wrap(chunkPos.y, m_size.y) * m_size.z + wrap(chunkPos.z, m_size.z)) * m_size.x + wrap(chunkPos.x, m_size.x)];
+}
+
+void openvox::TerrainClipmap::runJob(MeshJob* job) {
+    TransvoxelMesher* mesher;
+    {
+        std::lock_guard<std::mutex> l(m_lock);
+        if (m_freeMeshers.empty()) {
+            m_meshers.emplace_back(new TransvoxelMesher);
+            m_freeMeshers.push_back(m_meshers.back().get());
+        }
+        mesher = m_freeMeshers.back();
+        m_freeMeshers.pop_back();
+    }
+    mesher->mesh(job->chunkPos, job->lod, job->transitionFaces, m_density, job->mesh);
+    // Meshes stay in slots for a long time, so they should not carry scratch capacity
+    job->mesh.vertices.shrink_to_fit();
+    job->mesh.indices.shrink_to_fit();
+    std::lock_guard<std::mutex> l(m_lock);
+    m_freeMeshers.push_back(mesher);
+}
+
+void openvox::TerrainClipmap::finishJob(MeshJob* job) {
+    Slot& slot = *job->slot;
+    slot.chunkPos = job->chunkPos;
+    slot.transitionFaces = job->transitionFaces;
+    slot.valid = true;
+    slot.running = false;
+    std::swap(slot.mesh, job->mesh);
+    m_running--;
+    delete job;
+}
@@ -0,0 +1,305 @@
+#include "mesh/TransvoxelMesher.h"
+
+#include <algorithm>
+
+#include "OpenVoxAssert.hpp"
+#include "mesh/CellShape.h"
+
+#define NO_VERTEX 0xFFFFFFFFu ///< Empty reuse cache slot
+
+namespace {
+    const int GRID_WIDTH = CHUNK_WIDTH + 3; ///< Chunk samples from -1 to CHUNK_WIDTH + 1
+    const int FACE_WIDTH = CHUNK_WIDTH * 2 + 3; ///< Face samples from -1 to CHUNK_WIDTH * 2 + 1
+    const int REGULAR_CACHE_WIDTH = CHUNK_WIDTH + 1;
+    const int FACE_CACHE_WIDTH = CHUNK_WIDTH * 2 + 1;
+
+    /// Triangles of every sign case of the regular and transition cells, as cell edge indices
+    struct CellTables {
+        CellTables();
+
+        openvox::CellShape transition;
+        std::vector<u8> regularCases[256];
+        std::vector<u8> transitionCases[512];
+        i32v3 regularEdgeStart[12];
+        int regularEdgeAxis[12];
+        /// Per transition edge: 0 on the fine face, 1 on the coarse face, 2 between them
+        int transitionEdgeKind[20];
+        i32v2 transitionEdgeStart[20]; ///< In half cells on the fine face, cells on the coarse one
+        int transitionEdgeAxis[20]; ///< 0 along u, 1 along v
+    };
+
+    CellTables::CellTables() {
+        // Points 0 to 8 are the 3x3 fine samples at depth 0, 9 to 12 the coarse corners at depth 1
+        for (int i = 0; i < 9; i++) transition.addPoint(f32v3((i % 3) * 0.5f, (i / 3) * 0.5f, 0.0f));
+        for (int i = 0; i < 4; i++) transition.addPoint(f32v3((f32)(i & 1), (f32)(i >> 1), 1.0f));
+        const int fineQuads[4] = { 0, 1, 3, 4 };
+        for (int q : fineQuads) {
+            const int face[4] = { q, q + 1, q + 4, q + 3 };
+            transition.addFace(face, 4);
+        }
+        const int coarseFace[4] = { 9, 10, 12, 11 };
+        const int sideFaces[4][5] = { { 0, 1, 2, 10, 9 }, { 2, 5, 8, 12, 10 }, { 8, 7, 6, 11, 12 }, { 6, 3, 0, 9, 11 } };
+        transition.addFace(coarseFace, 4);
+        for (int f = 0; f < 4; f++) transition.addFace(sideFaces[f], 5);
+        transition.finish();
+
+        const openvox::CellShape& regular = openvox::CellShape::getCube();
+        for (u32 i = 1; i < 255; i++) regular.triangulate(i, regularCases[i]);
+        for (u32 i = 1; i < 511; i++) {
+            // Coarse corners copy the fine samples they sit over
+            u32 inside = i | ((i & 1) << 9) | (((i >> 2) & 1) << 10) | (((i >> 6) & 1) << 11) | (((i >> 8) & 1) << 12);
+            transition.triangulate(inside, transitionCases[i]);
+        }
+
+        for (int e = 0; e < 12; e++) {
+            int start = regular.getEdges()[e].x;
+            regularEdgeStart[e] = i32v3(start & 1, (start >> 1) & 1, (start >> 2) & 1);
+            int step = regular.getEdges()[e].y - start;
+            regularEdgeAxis[e] = step == 1 ? 0 : (step == 2 ? 1 : 2);
+        }
+        for (int e = 0; e < 20; e++) {
+            int start = transition.getEdges()[e].x;
+            int end = transition.getEdges()[e].y;
+            if (end < 9) {
+                transitionEdgeKind[e] = 0;
+                transitionEdgeStart[e] = i32v2(start % 3, start / 3);
+                transitionEdgeAxis[e] = end - start == 1 ? 0 : 1;
+            } else if (start >= 9) {
+                transitionEdgeKind[e] = 1;
+                transitionEdgeStart[e] = i32v2((start - 9) & 1, (start - 9) >> 1);
+                transitionEdgeAxis[e] = end - start == 1 ? 0 : 1;
+            } else {
+                transitionEdgeKind[e] = 2;
+                transitionEdgeStart[e] = i32v2(0);
+                transitionEdgeAxis[e] = 0;
+            }
+        }
+    }
+
+    const CellTables& getTables() {
+        static const CellTables tables;
+        return tables;
+    }
+
+    inline int gridIndex(int x, int y, int z) {
+        return ((z + 1) * GRID_WIDTH + (y + 1)) * GRID_WIDTH + (x + 1);
+    }
+
+    /// Layer 0 is outside the chunk, 1 on the face and 2 inside
+    inline int faceIndex(int layer, int u, int v) {
+        return (layer * FACE_WIDTH + (v + 1)) * FACE_WIDTH + (u + 1);
+    }
+}
+
+openvox::TransvoxelMesher::TransvoxelMesher() :
+    m_samples(GRID_WIDTH * GRID_WIDTH * GRID_WIDTH),
+    m_faceSamples(FACE_WIDTH * FACE_WIDTH * 3),
+    m_regularCache(REGULAR_CACHE_WIDTH * REGULAR_CACHE_WIDTH * REGULAR_CACHE_WIDTH * 3) {
+    getTables();
+}
+
+void openvox::TransvoxelMesher::mesh(const i32v3& chunkPos, u32 lod, u8 transitionFaces,
+                                     const DensityFunc& density, OUT TransvoxelMesh& mesh) {
+    openvox_assert(lod > 0 || !transitionFaces, "LOD 0 has no finer neighbors");
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    m_transitionFaces = transitionFaces;
+    i32v3 origin = chunkPos * (CHUNK_WIDTH << lod);
+
+    sampleChunk(origin, lod, density);
+    std::fill(m_regularCache.begin(), m_regularCache.end(), NO_VERTEX);
+    meshRegularCells(mesh);
+    mesh.regularIndexCount = mesh.indices.size();
+
+    for (int face = 0; face < 6; face++) {
+        if (!(transitionFaces & (1 << face))) continue;
+        sampleFace(face, origin, lod, density);
+        m_faceCache[face].assign(FACE_CACHE_WIDTH * FACE_CACHE_WIDTH * 2, NO_VERTEX);
+        meshTransitionCells(face, mesh);
+    }
+}
+
+void openvox::TransvoxelMesher::sampleChunk(const i32v3& origin, u32 lod, const DensityFunc& density) {
+    i8* samples = m_samples.data();
+    // Multiplied rather than shifted, since the apron starts at -1 and shifting negatives is undefined
+    int step = 1 << lod;
+    i32v3 pos;
+    for (int z = -1; z <= CHUNK_WIDTH + 1; z++) {
+        pos.z = origin.z + z * step;
+        for (int y = -1; y <= CHUNK_WIDTH + 1; y++) {
+            pos.y = origin.y + y * step;
+            for (int x = -1; x <= CHUNK_WIDTH + 1; x++) {
+                pos.x = origin.x + x * step;
+                *samples++ = density(pos);
+            }
+        }
+    }
+}
+
+void openvox::TransvoxelMesher::sampleFace(int face, const i32v3& origin, u32 lod, const DensityFunc& density) {
+    int axis = face >> 1;
+    int uAxis = (axis + 1) % 3;
+    int vAxis = (axis + 2) % 3;
+    bool positive = face & 1;
+    int halfStep = 1 << (lod - 1);
+    i32v3 pos;
+    for (int layer = 0; layer < 3; layer++) {
+        // Steps of half a cell into the chunk
+        int depth = layer - 1;
+        pos[axis] = origin[axis] + (positive ? (CHUNK_WIDTH << lod) - depth * halfStep : depth * halfStep);
+        for (int v = -1; v <= CHUNK_WIDTH * 2 + 1; v++) {
+            pos[vAxis] = origin[vAxis] + v * halfStep;
+            for (int u = -1; u <= CHUNK_WIDTH * 2 + 1; u++) {
+                pos[uAxis] = origin[uAxis] + u * halfStep;
+                m_faceSamples[faceIndex(layer, u, v)] = density(pos);
+            }
+        }
+    }
+}
+
+void openvox::TransvoxelMesher::meshRegularCells(OUT TransvoxelMesh& mesh) {
+    const CellTables& tables = getTables();
+    const i8* samples = m_samples.data();
+    int corners[8];
+    for (int i = 0; i < 8; i++) corners[i] = gridIndex(i & 1, (i >> 1) & 1, (i >> 2) & 1) - gridIndex(0, 0, 0);
+
+    for (int z = 0; z < CHUNK_WIDTH; z++) {
+        for (int y = 0; y < CHUNK_WIDTH; y++) {
+            const i8* cell = samples + gridIndex(0, y, z);
+            for (int x = 0; x < CHUNK_WIDTH; x++, cell++) {
+                u32 index = 0;
+                for (int i = 0; i < 8; i++) index |= (u32)(cell[corners[i]] < 0) << i;
+                if (index == 0 || index == 255) continue;
+
+                const std::vector<u8>& triangles = tables.regularCases[index];
+                i32v3 cellPos(x, y, z);
+                for (u8 edge : triangles) {
+                    mesh.indices.push_back(getRegularVertex(cellPos + tables.regularEdgeStart[edge], tables.regularEdgeAxis[edge], mesh));
+                }
+            }
+        }
+    }
+}
+
+void openvox::TransvoxelMesher::meshTransitionCells(int face, OUT TransvoxelMesh& mesh) {
+    const CellTables& tables = getTables();
+    int axis = face >> 1;
+    int uAxis = (axis + 1) % 3;
+    int vAxis = (axis + 2) % 3;
+    // Cell space maps onto chunk space mirrored on positive faces
+    bool flip = face & 1;
+    u32 vertices[20];
+
+    for (int v = 0; v < CHUNK_WIDTH; v++) {
+        for (int u = 0; u < CHUNK_WIDTH; u++) {
+            u32 index = 0;
+            for (int i = 0; i < 9; i++) {
+                index |= (u32)(m_faceSamples[faceIndex(1, u * 2 + i % 3, v * 2 + i / 3)] < 0) << i;
+            }
+            if (index == 0 || index == 511) continue;
+
+            const std::vector<u8>& triangles = tables.transitionCases[index];
+            for (size_t t = 0; t < triangles.size(); t++) {
+                int edge = triangles[t];
+                const i32v2& start = tables.transitionEdgeStart[edge];
+                if (tables.transitionEdgeKind[edge] == 0) {
+                    vertices[t % 3] = getFaceVertex(face, i32v2(u * 2, v * 2) + start, tables.transitionEdgeAxis[edge], mesh);
+                } else {
+                    // The coarse face is the outer face of the regular cells, so it shares their vertices
+                    i32v3 sample;
+                    sample[axis] = (face & 1) ? CHUNK_WIDTH : 0;
+                    sample[uAxis] = u + start.x;
+                    sample[vAxis] = v + start.y;
+                    vertices[t % 3] = getRegularVertex(sample, tables.transitionEdgeAxis[edge] ? vAxis : uAxis, mesh);
+                }
+                if (t % 3 != 2) continue;
+                // Unsqueezed vertices on faces shared with the same LOD can meet the finer ones
+                const PackedVertex* v = mesh.vertices.data();
+                if (v[vertices[0]].position == v[vertices[1]].position || v[vertices[1]].position == v[vertices[2]].position ||
+                    v[vertices[2]].position == v[vertices[0]].position) {
+                    continue;
+                }
+                mesh.indices.push_back(vertices[0]);
+                mesh.indices.push_back(vertices[flip ? 2 : 1]);
+                mesh.indices.push_back(vertices[flip ? 1 : 2]);
+            }
+        }
+    }
+}
+
+u32 openvox::TransvoxelMesher::getRegularVertex(const i32v3& sample, int axis, OUT TransvoxelMesh& mesh) {
+    u32& cached = m_regularCache[((sample.z * REGULAR_CACHE_WIDTH + sample.y) * REGULAR_CACHE_WIDTH + sample.x) * 3 + axis];
+    if (cached != NO_VERTEX) return cached;
+
+    const int steps[3] = { 1, GRID_WIDTH, GRID_WIDTH * GRID_WIDTH };
+    const i8* s0 = m_samples.data() + gridIndex(sample.x, sample.y, sample.z);
+    const i8* s1 = s0 + steps[axis];
+    f32 t = (f32)*s0 / (f32)(*s0 - *s1);
+    f32v3 position(sample);
+    position[axis] += t;
+
+    f32v3 gradient;
+    for (int i = 0; i < 3; i++) {
+        f32 g0 = (f32)(s0[steps[i]] - s0[-steps[i]]);
+        f32 g1 = (f32)(s1[steps[i]] - s1[-steps[i]]);
+        gradient[i] = g0 + (g1 - g0) * t;
+    }
+
+    // Squeeze the cells next to transition faces into the space the transition cells leave them.
+    // Vertices on a face shared with a chunk of the same LOD stay put, since that chunk may have
+    // no transition face there to squeeze them by.
+    bool onSharedFace = false;
+    for (int i = 0; i < 3; i++) {
+        if (i == axis) continue;
+        if (sample[i] == 0 && !(m_transitionFaces & (1 << (i * 2)))) onSharedFace = true;
+        if (sample[i] == CHUNK_WIDTH && !(m_transitionFaces & (2 << (i * 2)))) onSharedFace = true;
+    }
+    for (int i = 0; i < 3 && !onSharedFace; i++) {
+        if ((m_transitionFaces & (1 << (i * 2))) && position[i] < 1.0f) {
+            position[i] = TRANSVOXEL_TRANSITION_WIDTH + position[i] * (1.0f - TRANSVOXEL_TRANSITION_WIDTH);
+        }
+        if ((m_transitionFaces & (2 << (i * 2))) && position[i] > CHUNK_WIDTH - 1.0f) {
+            position[i] = CHUNK_WIDTH - TRANSVOXEL_TRANSITION_WIDTH - (CHUNK_WIDTH - position[i]) * (1.0f - TRANSVOXEL_TRANSITION_WIDTH);
+        }
+    }
+
+    cached = (u32)mesh.vertices.size();
+    mesh.vertices.push_back(packVertex(position, gradient));
+    return cached;
+}
+
+u32 openvox::TransvoxelMesher::getFaceVertex(int face, const i32v2& sample, int axis, OUT TransvoxelMesh& mesh) {
+    u32& cached = m_faceCache[face][(sample.y * FACE_CACHE_WIDTH + sample.x) * 2 + axis];
+    if (cached != NO_VERTEX) return cached;
+
+    int normalAxis = face >> 1;
+    int uAxis = (normalAxis + 1) % 3;
+    int vAxis = (normalAxis + 2) % 3;
+    i32v2 step(axis == 0, axis == 1);
+    const i8* s = m_faceSamples.data();
+    int i0 = faceIndex(1, sample.x, sample.y);
+    int i1 = faceIndex(1, sample.x + step.x, sample.y + step.y);
+    f32 t = (f32)s[i0] / (f32)(s[i0] - s[i1]);
+
+    f32v3 position;
+    position[normalAxis] = (face & 1) ? (f32)CHUNK_WIDTH : 0.0f;
+    position[uAxis] = (sample.x + t * step.x) * 0.5f;
+    position[vAxis] = (sample.y + t * step.y) * 0.5f;
+
+    // Layer 0 is outside the chunk, so it is on the negative side of negative faces
+    const int layers = FACE_WIDTH * FACE_WIDTH;
+    f32 sign = (face & 1) ? -1.0f : 1.0f;
+    f32v3 gradient;
+    f32v3 g0, g1;
+    g0[uAxis] = (f32)(s[i0 + 1] - s[i0 - 1]);
+    g0[vAxis] = (f32)(s[i0 + FACE_WIDTH] - s[i0 - FACE_WIDTH]);
+    g0[normalAxis] = sign * (f32)(s[i0 + layers] - s[i0 - layers]);
+    g1[uAxis] = (f32)(s[i1 + 1] - s[i1 - 1]);
+    g1[vAxis] = (f32)(s[i1 + FACE_WIDTH] - s[i1 - FACE_WIDTH]);
+    g1[normalAxis] = sign * (f32)(s[i1 + layers] - s[i1 - layers]);
+    gradient = g0 + (g1 - g0) * t;
+
+    cached = (u32)mesh.vertices.size();
+    mesh.vertices.push_back(packVertex(position, gradient));
+    return cached;
+}
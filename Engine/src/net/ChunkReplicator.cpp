@@ -0,0 +1,398 @@
+#include "net/ChunkReplicator.h"
+
+#include <algorithm>
+
+#include "math/OpenVoxMath.hpp"
+
+#define CHUNK_MESSAGE_HEADER_BYTES 17
+#define CHUNK_DELTA_COMPARE_BYTES 512 ///< Deltas bigger than this are compared against the full chunk
+#define NO_PALETTE_INDEX 0xFFFF
+
+namespace {
+    inline void writeU16(std::vector<u8>& out, u16 v) {
+        out.push_back((u8)v);
+        out.push_back((u8)(v >> 8));
+    }
+    inline void writeU32(std::vector<u8>& out, u32 v) {
+        out.push_back((u8)v);
+        out.push_back((u8)(v >> 8));
+        out.push_back((u8)(v >> 16));
+        out.push_back((u8)(v >> 24));
+    }
+    inline u16 readU16(const u8* p) {
+        return (u16)(p[0] | (p[1] << 8));
+    }
+    inline u32 readU32(const u8* p) {
+        return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+    }
+
+    /// Bits needed to tell count values apart
+    inline u32 getIndexBits(u32 count) {
+        return count <= 1 ? 0 : openvoxm::bitScanReverse(count - 1) + 1;
+    }
+
+    /// Appends values of up to 32 bits, least significant bit first
+    class BitWriter {
+    public:
+        BitWriter(std::vector<u8>& out) : m_out(out) {}
+        ~BitWriter() {
+            if (m_count) m_out.push_back((u8)m_bits);
+        }
+        void write(u32 value, u32 bits) {
+            m_bits |= (u64)value << m_count;
+            m_count += bits;
+            while (m_count >= 8) {
+                m_out.push_back((u8)m_bits);
+                m_bits >>= 8;
+                m_count -= 8;
+            }
+        }
+    private:
+        std::vector<u8>& m_out;
+        u64 m_bits = 0;
+        u32 m_count = 0;
+    };
+
+    class BitReader {
+    public:
+        BitReader(const u8* data, size_t size) : m_data(data), m_end(data + size) {}
+        /// Returns false when reading past the end
+        bool read(u32 bits, OUT u32& value) {
+            while (m_count < bits) {
+                if (m_data == m_end) return false;
+                m_bits |= (u64)*m_data++ << m_count;
+                m_count += 8;
+            }
+            value = (u32)(m_bits & ((1ull << bits) - 1));
+            m_bits >>= bits;
+            m_count -= bits;
+            return true;
+        }
+    private:
+        const u8* m_data;
+        const u8* m_end;
+        u64 m_bits = 0;
+        u32 m_count = 0;
+    };
+}
+
+openvox::ChunkReplicator::ChunkReplicator(ChunkMap* chunkMap) :
+    m_chunkMap(chunkMap),
+    m_paletteMap(1 << 16, NO_PALETTE_INDEX) {
+    // Empty
+}
+
+openvox::ChunkReplicator::~ChunkReplicator() {
+    for (auto& it : m_chunks) delete it.second;
+}
+
+void openvox::ChunkReplicator::addClient(ClientID client) {
+    m_clientChunks[client];
+}
+
+void openvox::ChunkReplicator::removeClient(ClientID client) {
+    auto it = m_clientChunks.find(client);
+    if (it == m_clientChunks.end()) return;
+    std::vector<i32v3> chunks;
+    chunks.swap(it->second);
+    for (const i32v3& p : chunks) unsubscribe(client, p);
+    m_clientChunks.erase(client);
+}
+
+void openvox::ChunkReplicator::subscribe(ClientID client, const i32v3& chunkPos) {
+    ChunkState* state = getState(chunkPos);
+    if (!state) {
+        state = new ChunkState;
+        state->position = chunkPos;
+        state->version = 1;
+        state->pending = false;
+        state->allDirty = false;
+        m_chunks[chunkPos] = state;
+    }
+    for (const Subscriber& s : state->subscribers) {
+        if (s.client == client) return;
+    }
+    Subscriber s = { client, 0, true };
+    state->subscribers.push_back(s);
+    m_clientChunks[client].push_back(chunkPos);
+    markPending(state);
+}
+
+void openvox::ChunkReplicator::unsubscribe(ClientID client, const i32v3& chunkPos) {
+    auto cit = m_clientChunks.find(client);
+    if (cit != m_clientChunks.end()) {
+        std::vector<i32v3>& chunks = cit->second;
+        auto p = std::find(chunks.begin(), chunks.end(), chunkPos);
+        if (p != chunks.end()) {
+            *p = chunks.back();
+            chunks.pop_back();
+        }
+    }
+
+    ChunkState* state = getState(chunkPos);
+    if (!state) return;
+    std::vector<Subscriber>& subs = state->subscribers;
+    for (size_t i = 0; i < subs.size(); i++) {
+        if (subs[i].client == client) {
+            subs[i] = subs.back();
+            subs.pop_back();
+            break;
+        }
+    }
+    // Nobody watches the chunk, so its changes need not be tracked
+    if (subs.empty() && !state->pending) {
+        delete state;
+        m_chunks.erase(chunkPos);
+    }
+}
+
+void openvox::ChunkReplicator::resync(ClientID client, const i32v3& chunkPos) {
+    ChunkState* state = getState(chunkPos);
+    if (!state) return;
+    for (Subscriber& s : state->subscribers) {
+        if (s.client == client) {
+            s.needsFull = true;
+            markPending(state);
+        }
+    }
+}
+
+void openvox::ChunkReplicator::onBlockChanged(const i32v3& voxelPos) {
+    ChunkState* state = getState(toChunkPosition(voxelPos));
+    if (!state) return;
+    markDirty(state, (u16)getVoxelIndex(toLocalPosition(voxelPos)));
+}
+
+void openvox::ChunkReplicator::onEdit(const VoxelEditBatch& batch) {
+    for (const i32v3& chunkPos : batch.chunks) {
+        ChunkState* state = getState(chunkPos);
+        if (!state) continue;
+        i32v3 origin = toVoxelPosition(chunkPos);
+        i32v3 lo = openvoxm::max(batch.min - origin, i32v3(0));
+        i32v3 hi = openvoxm::min(batch.max - origin, i32v3(CHUNK_WIDTH - 1));
+        for (i32 y = lo.y; y <= hi.y && !state->allDirty; y++) {
+            for (i32 z = lo.z; z <= hi.z; z++) {
+                for (i32 x = lo.x; x <= hi.x; x++) {
+                    markDirty(state, (u16)getVoxelIndex(x, y, z));
+                }
+            }
+        }
+    }
+}
+
+void openvox::ChunkReplicator::flush(SendFunc send) {
+    std::vector<ChunkState*> pending;
+    pending.swap(m_pending);
+    for (ChunkState* state : pending) {
+        state->pending = false;
+        if (state->subscribers.empty()) {
+            m_chunks.erase(state->position);
+            delete state;
+            continue;
+        }
+        const Chunk* chunk = m_chunkMap->getChunk(state->position);
+        if (!chunk) {
+            // Subscribers get the full chunk once it loads
+            clearDirty(state);
+            for (Subscriber& s : state->subscribers) s.needsFull = true;
+            markPending(state);
+            continue;
+        }
+
+        bool changed = state->allDirty || state->dirty.size();
+        if (changed) state->version++;
+
+        // Encode each form at most once and share it between subscribers
+        m_fullBuffer.clear();
+        m_deltaBuffer.clear();
+        bool deltaIsFull = state->allDirty;
+        if (changed && !deltaIsFull) {
+            encodeDelta(state, chunk, m_deltaBuffer);
+            if (m_deltaBuffer.size() > CHUNK_DELTA_COMPARE_BYTES) {
+                encodeFull(state, chunk, m_fullBuffer);
+                deltaIsFull = m_fullBuffer.size() <= m_deltaBuffer.size();
+            }
+        }
+
+        for (Subscriber& s : state->subscribers) {
+            bool full = s.needsFull || (changed && (deltaIsFull || s.version + 1 != state->version));
+            if (!full && !changed) continue;
+            if (full) {
+                if (m_fullBuffer.empty()) encodeFull(state, chunk, m_fullBuffer);
+                send(s.client, m_fullBuffer.data(), m_fullBuffer.size());
+                m_bytesSent += m_fullBuffer.size();
+                m_fullChunksSent++;
+            } else {
+                send(s.client, m_deltaBuffer.data(), m_deltaBuffer.size());
+                m_bytesSent += m_deltaBuffer.size();
+                m_deltasSent++;
+            }
+            s.version = state->version;
+            s.needsFull = false;
+        }
+        clearDirty(state);
+    }
+}
+
+u32 openvox::ChunkReplicator::getVersion(const i32v3& chunkPos) const {
+    auto it = m_chunks.find(chunkPos);
+    return it != m_chunks.end() ? it->second->version : 0;
+}
+
+openvox::ChunkReplicator::ChunkState* openvox::ChunkReplicator::getState(const i32v3& chunkPos) {
+    auto it = m_chunks.find(chunkPos);
+    return it != m_chunks.end() ? it->second : nullptr;
+}
+
+void openvox::ChunkReplicator::markPending(ChunkState* state) {
+    if (state->pending) return;
+    state->pending = true;
+    m_pending.push_back(state);
+}
+
+void openvox::ChunkReplicator::markDirty(ChunkState* state, u16 voxelIndex) {
+    if (state->allDirty) return;
+    markPending(state);
+    if (state->dirtyBits.empty()) state->dirtyBits.resize(CHUNK_SIZE / 64, 0);
+    u64& word = state->dirtyBits[voxelIndex >> 6];
+    u64 bit = 1ull << (voxelIndex & 63);
+    if (word & bit) return;
+    word |= bit;
+    state->dirty.push_back(voxelIndex);
+    if (state->dirty.size() > m_fullThreshold) {
+        state->allDirty = true;
+        std::vector<u16>().swap(state->dirty);
+    }
+}
+
+void openvox::ChunkReplicator::clearDirty(ChunkState* state) {
+    state->allDirty = false;
+    if (state->dirtyBits.empty()) return;
+    // Only touch the words that have bits set, unless there are too many to be worth it
+    if (state->dirty.size() < CHUNK_SIZE / 64 && state->dirty.size()) {
+        for (u16 i : state->dirty) state->dirtyBits[i >> 6] = 0;
+    } else {
+        std::fill(state->dirtyBits.begin(), state->dirtyBits.end(), 0);
+    }
+    state->dirty.clear();
+}
+
+u32 openvox::ChunkReplicator::writePalette(const ChunkState* state, const u16* ids, size_t count, u8 type,
+                                            OUT std::vector<u8>& out) {
+    m_palette.clear();
+    for (size_t i = 0; i < count; i++) {
+        u16& index = m_paletteMap[ids[i]];
+        if (index != NO_PALETTE_INDEX) continue;
+        index = (u16)m_palette.size();
+        m_palette.push_back(ids[i]);
+    }
+
+    out.push_back(type);
+    writeU32(out, (u32)state->position.x);
+    writeU32(out, (u32)state->position.y);
+    writeU32(out, (u32)state->position.z);
+    writeU32(out, state->version);
+    writeU16(out, (u16)m_palette.size());
+    for (u16 id : m_palette) writeU16(out, id);
+    return (u32)m_palette.size();
+}
+
+void openvox::ChunkReplicator::encodeFull(const ChunkState* state, const Chunk* chunk, OUT std::vector<u8>& out) {
+    const BlockID* blocks = chunk->getBlockData();
+    u32 bits = getIndexBits(writePalette(state, blocks, CHUNK_SIZE, CHUNK_MESSAGE_FULL, out));
+    out.reserve(out.size() + (CHUNK_SIZE * bits + 7) / 8);
+    if (bits) {
+        BitWriter writer(out);
+        for (int i = 0; i < CHUNK_SIZE; i++) writer.write(m_paletteMap[blocks[i]], bits);
+    }
+    for (u16 id : m_palette) m_paletteMap[id] = NO_PALETTE_INDEX;
+}
+
+void openvox::ChunkReplicator::encodeDelta(ChunkState* state, const Chunk* chunk, OUT std::vector<u8>& out) {
+    // Sorted positions keep the encoding independent of the order edits were made in
+    std::vector<u16>& dirty = state->dirty;
+    std::sort(dirty.begin(), dirty.end());
+    std::vector<u16> ids(dirty.size());
+    for (size_t i = 0; i < dirty.size(); i++) ids[i] = chunk->getBlock(dirty[i]);
+
+    u32 bits = getIndexBits(writePalette(state, ids.data(), ids.size(), CHUNK_MESSAGE_DELTA, out));
+    writeU16(out, (u16)dirty.size());
+    {
+        BitWriter writer(out);
+        for (size_t i = 0; i < dirty.size(); i++) {
+            writer.write(dirty[i], CHUNK_WIDTH_BITS * 3);
+            if (bits) writer.write(m_paletteMap[ids[i]], bits);
+        }
+    }
+    for (u16 id : m_palette) m_paletteMap[id] = NO_PALETTE_INDEX;
+}
+
+openvox::ChunkReceiver::Result openvox::ChunkReceiver::receive(const u8* data, size_t size, OPT OUT i32v3* chunkPos /*= nullptr*/) {
+    if (size < CHUNK_MESSAGE_HEADER_BYTES + 2) return Result::MALFORMED;
+    u8 type = data[0];
+    i32v3 pos((i32)readU32(data + 1), (i32)readU32(data + 5), (i32)readU32(data + 9));
+    u32 version = readU32(data + 13);
+    if (chunkPos) *chunkPos = pos;
+    if (type != CHUNK_MESSAGE_FULL && type != CHUNK_MESSAGE_DELTA) return Result::MALFORMED;
+
+    const u8* p = data + CHUNK_MESSAGE_HEADER_BYTES;
+    const u8* end = data + size;
+    u32 paletteSize = readU16(p);
+    p += 2;
+    if ((size_t)(end - p) < paletteSize * 2) return Result::MALFORMED;
+    m_palette.resize(paletteSize);
+    for (u32 i = 0; i < paletteSize; i++, p += 2) m_palette[i] = readU16(p);
+    u32 bits = getIndexBits(paletteSize);
+
+    if (type == CHUNK_MESSAGE_FULL) {
+        if (paletteSize == 0) return Result::MALFORMED;
+        // Decode before touching the chunk so a truncated message leaves it unchanged
+        std::vector<BlockID> blocks(CHUNK_SIZE, m_palette[0]);
+        if (bits) {
+            BitReader reader(p, end - p);
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                u32 index;
+                if (!reader.read(bits, index) || index >= paletteSize) return Result::MALFORMED;
+                blocks[i] = m_palette[index];
+            }
+        }
+        Chunk* chunk = m_chunkMap->createChunk(pos);
+        std::copy(blocks.begin(), blocks.end(), chunk->getMutableBlockData());
+        chunk->updateOccupancy();
+        m_versions[pos] = version;
+        return Result::APPLIED;
+    }
+
+    auto it = m_versions.find(pos);
+    Chunk* chunk = m_chunkMap->getChunk(pos);
+    if (it == m_versions.end() || !chunk || it->second + 1 != version) return Result::OUT_OF_SYNC;
+    if (end - p < 2) return Result::MALFORMED;
+    u32 count = readU16(p);
+    p += 2;
+    if ((u64)(end - p) * 8 < (u64)count * (CHUNK_WIDTH_BITS * 3 + bits) || (count && !paletteSize)) return Result::MALFORMED;
+    // Validate every palette index first so a bad message leaves the chunk unchanged
+    for (int pass = 0; pass < 2; pass++) {
+        BitReader reader(p, end - p);
+        for (u32 i = 0; i < count; i++) {
+            u32 index = 0, paletteIndex = 0;
+            reader.read(CHUNK_WIDTH_BITS * 3, index);
+            if (bits) reader.read(bits, paletteIndex);
+            if (pass == 0) {
+                if (paletteIndex >= paletteSize) return Result::MALFORMED;
+            } else {
+                chunk->setBlock((int)index, m_palette[paletteIndex]);
+            }
+        }
+    }
+    it->second = version;
+    return Result::APPLIED;
+}
+
+void openvox::ChunkReceiver::removeChunk(const i32v3& chunkPos) {
+    m_versions.erase(chunkPos);
+}
+
+u32 openvox::ChunkReceiver::getVersion(const i32v3& chunkPos) const {
+    auto it = m_versions.find(chunkPos);
+    return it != m_versions.end() ? it->second : 0;
+}
@@ -0,0 +1,188 @@
+#include "net/InterestManager.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "OpenVoxAssert.hpp"
+#include "jobs/JobSystem.h"
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    inline i32 distanceSq(const i32v3& a, const i32v3& b) {
+        i32v3 d = a - b;
+        return d.x * d.x + d.y * d.y + d.z * d.z;
+    }
+}
+
+openvox::InterestManager::InterestManager(f32 entityCellSize /*= 32.0f*/) :
+    m_entities(entityCellSize) {
+    // Empty
+}
+
+openvox::InterestManager::~InterestManager() {
+    for (Client* c : m_clients) delete c;
+}
+
+void openvox::InterestManager::addClient(ClientID client, i32 chunkRadius, f32 entityRadius) {
+    openvox_assert(chunkRadius >= 0 && chunkRadius < 0x7FFF, "Chunk radius out of range");
+    openvox_assert(!getClient(client), "Client added twice");
+    Client* c = new Client;
+    c->id = client;
+    c->position = f32v3(0.0f);
+    c->center = i32v3(0);
+    c->hasCenter = false;
+    c->chunkRadius = chunkRadius;
+    c->entityRadius = entityRadius;
+
+    i32 size = chunkRadius * 2 + 1;
+    c->rowWidths.resize((size_t)size * size);
+    i32 r2 = chunkRadius * chunkRadius;
+    for (i32 dy = -chunkRadius; dy <= chunkRadius; dy++) {
+        for (i32 dz = -chunkRadius; dz <= chunkRadius; dz++) {
+            i32 rem = r2 - dy * dy - dz * dz;
+            i32 w = -1;
+            if (rem >= 0) {
+                w = (i32)openvoxm::sqrt((f32)rem);
+                // Correct float rounding so the row holds exactly the chunks with distance <= radius
+                while ((w + 1) * (w + 1) <= rem) w++;
+                while (w * w > rem) w--;
+            }
+            c->rowWidths[(dy + chunkRadius) * size + dz + chunkRadius] = (i16)w;
+        }
+    }
+
+    m_clientIndices[client] = (u32)m_clients.size();
+    m_clients.push_back(c);
+}
+
+void openvox::InterestManager::removeClient(ClientID client) {
+    auto it = m_clientIndices.find(client);
+    if (it == m_clientIndices.end()) return;
+    u32 index = it->second;
+    delete m_clients[index];
+    m_clients[index] = m_clients.back();
+    m_clientIndices[m_clients[index]->id] = index;
+    m_clients.pop_back();
+    m_clientIndices.erase(client);
+}
+
+void openvox::InterestManager::setClientPosition(ClientID client, const f32v3& position) {
+    Client* c = getClient(client);
+    if (c) c->position = position;
+}
+
+void openvox::InterestManager::setEntity(EntityID id, const f32v3& position) {
+    if (id >= m_entityPositions.size()) m_entityPositions.resize(id + 1);
+    m_entityPositions[id] = position;
+    if (m_entities.contains(id)) {
+        m_entities.update(id, position);
+    } else {
+        m_entities.insert(id, position);
+    }
+}
+
+void openvox::InterestManager::removeEntity(EntityID id) {
+    m_entities.remove(id);
+}
+
+void openvox::InterestManager::update(OPT JobSystem* jobs /*= nullptr*/) {
+    // Clients only read shared state, so they can be updated in any order on any thread
+    if (jobs) {
+        jobs->parallelFor(m_clients.size(), 16, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) updateClient(*m_clients[i]);
+        });
+    } else {
+        for (Client* c : m_clients) updateClient(*c);
+    }
+}
+
+const openvox::InterestDiff* openvox::InterestManager::getDiff(ClientID client) const {
+    const Client* c = getClient(client);
+    return c ? &c->diff : nullptr;
+}
+
+const std::vector<openvox::InterestManager::EntityID>* openvox::InterestManager::getVisibleEntities(ClientID client) const {
+    const Client* c = getClient(client);
+    return c ? &c->entities : nullptr;
+}
+
+bool openvox::InterestManager::isChunkVisible(ClientID client, const i32v3& chunkPos) const {
+    const Client* c = getClient(client);
+    if (!c || !c->hasCenter) return false;
+    i32v3 d = chunkPos - c->center;
+    return openvoxm::abs(d.x) <= getRowWidth(*c, d.y, d.z);
+}
+
+openvox::InterestManager::Client* openvox::InterestManager::getClient(ClientID client) const {
+    auto it = m_clientIndices.find(client);
+    return it != m_clientIndices.end() ? m_clients[it->second] : nullptr;
+}
+
+void openvox::InterestManager::updateClient(Client& c) {
+    c.diff.clear();
+
+    i32v3 center = toChunkPosition(i32v3((i32)openvoxm::floor(c.position.x),
+                                         (i32)openvoxm::floor(c.position.y),
+                                         (i32)openvoxm::floor(c.position.z)));
+    if (!c.hasCenter || center != c.center) {
+        appendDifference(c, center, c.hasCenter, c.center, c.diff.chunksEntered);
+        if (c.hasCenter) appendDifference(c, c.center, true, center, c.diff.chunksLeft);
+        c.center = center;
+        c.hasCenter = true;
+        std::sort(c.diff.chunksEntered.begin(), c.diff.chunksEntered.end(), [&center](const i32v3& a, const i32v3& b) {
+            return distanceSq(a, center) < distanceSq(b, center);
+        });
+    }
+
+    // Grow the query buffer until the whole radius fits
+    if (c.query.empty()) c.query.resize(64);
+    size_t count;
+    while ((count = m_entities.queryRadius(c.position, c.entityRadius, c.query.data(), c.query.size())) == c.query.size()) {
+        c.query.resize(c.query.size() * 2);
+    }
+    std::sort(c.query.begin(), c.query.begin() + count);
+    std::set_difference(c.query.begin(), c.query.begin() + count, c.entities.begin(), c.entities.end(),
+                        std::back_inserter(c.diff.entitiesEntered));
+    std::set_difference(c.entities.begin(), c.entities.end(), c.query.begin(), c.query.begin() + count,
+                        std::back_inserter(c.diff.entitiesLeft));
+    c.entities.assign(c.query.begin(), c.query.begin() + count);
+
+    const f32v3 position = c.position;
+    const std::vector<f32v3>& positions = m_entityPositions;
+    std::sort(c.diff.entitiesEntered.begin(), c.diff.entitiesEntered.end(), [&](EntityID a, EntityID b) {
+        f32v3 da = positions[a] - position;
+        f32v3 db = positions[b] - position;
+        return da.x * da.x + da.y * da.y + da.z * da.z < db.x * db.x + db.y * db.y + db.z * db.z;
+    });
+}
+
+i32 openvox::InterestManager::getRowWidth(const Client& c, i32 dy, i32 dz) const {
+    i32 r = c.chunkRadius;
+    if (dy < -r || dy > r || dz < -r || dz > r) return -1;
+    return c.rowWidths[(dy + r) * (r * 2 + 1) + dz + r];
+}
+
+void openvox::InterestManager::appendDifference(const Client& c, const i32v3& from, bool hasOther, const i32v3& other,
+                                                OUT std::vector<i32v3>& out) const {
+    i32 r = c.chunkRadius;
+    for (i32 dy = -r; dy <= r; dy++) {
+        for (i32 dz = -r; dz <= r; dz++) {
+            i32 w = getRowWidth(c, dy, dz);
+            if (w < 0) continue;
+            i32 y = from.y + dy;
+            i32 z = from.z + dz;
+            i32 x0 = from.x - w;
+            i32 x1 = from.x + w;
+            // The same row in the other sphere is also one X interval, possibly empty
+            i32 ow = hasOther ? getRowWidth(c, y - other.y, z - other.z) : -1;
+            if (ow < 0) {
+                for (i32 x = x0; x <= x1; x++) out.push_back(i32v3(x, y, z));
+                continue;
+            }
+            i32 ox0 = other.x - ow;
+            i32 ox1 = other.x + ow;
+            for (i32 x = x0; x <= openvoxm::min(x1, ox0 - 1); x++) out.push_back(i32v3(x, y, z));
+            for (i32 x = openvoxm::max(x0, ox1 + 1); x <= x1; x++) out.push_back(i32v3(x, y, z));
+        }
+    }
+}
@@ -0,0 +1,20 @@
+#include "net/LoopbackTransport.h"
+
+void openvox::LoopbackTransport::send(ClientID client, const u8* data, size_t size) {
+    m_queues[client].push_back(std::vector<u8>(data, data + size));
+    m_bytesSent += size;
+    m_messagesSent++;
+}
+
+bool openvox::LoopbackTransport::receive(ClientID client, OUT std::vector<u8>& message) {
+    auto it = m_queues.find(client);
+    if (it == m_queues.end() || it->second.empty()) return false;
+    message.swap(it->second.front());
+    it->second.pop_front();
+    return true;
+}
+
+size_t openvox::LoopbackTransport::getQueuedCount(ClientID client) const {
+    auto it = m_queues.find(client);
+    return it != m_queues.end() ? it->second.size() : 0;
+}
@@ -0,0 +1,813 @@
+#include "net/UdpTransport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef int socklen_t;
+#define closeSocket closesocket
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define closeSocket ::close
+#endif
+
+#include "math/OpenVoxMath.hpp"
+
+#if defined(__linux__)
+#define UDP_BATCH_SIZE 64 ///< Datagrams per sendmmsg or recvmmsg call
+#endif
+
+#define UDP_PROTOCOL_ID 0x4F565831 ///< Tags handshake packets so stray traffic is ignored
+#define UDP_SENT_PACKET_RING 256
+#define UDP_DATA_HEADER_SIZE 13
+#define UDP_HANDSHAKE_RESEND 0.1 ///< Seconds between handshake retries
+#define UDP_KEEPALIVE 0.1 ///< Seconds of silence before an empty packet is sent
+#define UDP_MIN_RESEND_TIME 0.03
+#define UDP_MAX_CONGESTION_WINDOW 1024.0f
+#define UDP_MIN_CONGESTION_WINDOW 4.0f
+
+#define PACKET_CONNECT_REQUEST 1
+#define PACKET_CHALLENGE 2
+#define PACKET_RESPONSE 3
+#define PACKET_ACCEPT 4
+#define PACKET_DISCONNECT 5
+#define PACKET_DATA 6 ///< Data from a peer that has received nothing yet, so its ack fields mean nothing
+#define PACKET_ACKED_DATA 7 ///< Data whose ack fields are valid
+
+#define MESSAGE_FRAGMENTED 0x4
+
+namespace {
+    inline void put16(u8* p, u16 v) {
+        p[0] = (u8)v;
+        p[1] = (u8)(v >> 8);
+    }
+    inline void put32(u8* p, u32 v) {
+        p[0] = (u8)v;
+        p[1] = (u8)(v >> 8);
+        p[2] = (u8)(v >> 16);
+        p[3] = (u8)(v >> 24);
+    }
+    inline u16 get16(const u8* p) {
+        return (u16)(p[0] | (p[1] << 8));
+    }
+    inline u32 get32(const u8* p) {
+        return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+    }
+
+    /// True if sequence a is newer than b, allowing for wrap around
+    inline bool sequenceGreater(u16 a, u16 b) {
+        return a != b && (u16)(a - b) < 0x8000;
+    }
+
+    inline u64 getAddressKey(const openvox::NetAddress& a) {
+        return ((u64)a.ip << 16) | a.port;
+    }
+
+    inline f64 getTime() {
+        return std::chrono::duration<f64>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    inline sockaddr_in toSockAddr(const openvox::NetAddress& a) {
+        sockaddr_in s;
+        std::memset(&s, 0, sizeof(s));
+        s.sin_family = AF_INET;
+        s.sin_addr.s_addr = htonl(a.ip);
+        s.sin_port = htons(a.port);
+        return s;
+    }
+    inline openvox::NetAddress fromSockAddr(const sockaddr_in& s) {
+        openvox::NetAddress a = { ntohl(s.sin_addr.s_addr), ntohs(s.sin_port) };
+        return a;
+    }
+
+    /// Size of the message header for a channel
+    inline size_t getMessageHeaderSize(openvox::UdpChannel channel, bool fragmented) {
+        return 3 + (channel != openvox::UdpChannel::UNRELIABLE ? 2 : 0) + (fragmented ? 4 : 0);
+    }
+}
+
+openvox::UdpTransport::UdpTransport() :
+    onConnect(this),
+    onDisconnect(this),
+    m_random(std::random_device()()) {
+    // Empty
+}
+
+openvox::UdpTransport::~UdpTransport() {
+    close();
+    for (Packet* p : m_packetPool) delete p;
+}
+
+bool openvox::UdpTransport::open(u16 port, bool acceptConnections) {
+    if (isOpen()) close();
+#if defined(_WIN32)
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return false;
+#endif
+    intptr_t s = (intptr_t)socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s < 0) return false;
+
+    // Large kernel buffers absorb bursts of chunk data between updates
+    int bufferSize = 4 << 20;
+    setsockopt(s, SOL_SOCKET, SO_SNDBUF, (const char*)&bufferSize, sizeof(bufferSize));
+    setsockopt(s, SOL_SOCKET, SO_RCVBUF, (const char*)&bufferSize, sizeof(bufferSize));
+
+    NetAddress local = { 0, port };
+    sockaddr_in addr = toSockAddr(local);
+    if (bind(s, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        closeSocket(s);
+        return false;
+    }
+    socklen_t length = sizeof(addr);
+    getsockname(s, (sockaddr*)&addr, &length);
+    m_localPort = ntohs(addr.sin_port);
+
+#if defined(_WIN32)
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    fcntl((int)s, F_SETFL, fcntl((int)s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    m_socket = s;
+    m_accepting = acceptConnections;
+    m_time = getTime();
+    return true;
+}
+
+void openvox::UdpTransport::close() {
+    if (!isOpen()) return;
+    while (m_connections.size()) disconnect(m_connections.back()->id);
+    m_pending.clear();
+    // Whatever the simulator still holds is lost, like on a real network
+    for (Packet* p : m_delayed) m_packetPool.push_back(p);
+    m_delayed.clear();
+    closeSocket(m_socket);
+    m_socket = INVALID_SOCKET_HANDLE;
+#if defined(_WIN32)
+    WSACleanup();
+#endif
+}
+
+openvox::ClientID openvox::UdpTransport::connect(const char* host, u16 port) {
+    in_addr ip;
+    if (!isOpen() || inet_pton(AF_INET, host, &ip) != 1) return 0;
+    NetAddress address = { ntohl(ip.s_addr), port };
+    if (findConnection(address)) return 0;
+
+    Connection* c = createConnection(address);
+    c->state = ConnectionState::REQUESTING;
+    do {
+        c->clientSalt = m_random();
+    } while (!c->clientSalt);
+    c->lastSent = m_time - UDP_HANDSHAKE_RESEND;
+    return c->id;
+}
+
+void openvox::UdpTransport::disconnect(ClientID client) {
+    Connection* c = getConnection(client);
+    if (!c) return;
+    // Sent a few times since nothing acks it
+    if (c->state == ConnectionState::CONNECTED) {
+        for (int i = 0; i < 3; i++) sendHandshake(c->address, PACKET_DISCONNECT, c->session, 0);
+        flushPackets();
+    }
+    removeConnection(client, false);
+}
+
+void openvox::UdpTransport::update() {
+    if (!isOpen()) return;
+    m_time = getTime();
+    receivePackets();
+
+    for (size_t i = 0; i < m_connections.size();) {
+        Connection* c = m_connections[i];
+        if (m_time - c->lastReceived > m_timeout) {
+            removeConnection(c->id, true);
+            continue;
+        }
+        sendConnection(*c);
+        i++;
+    }
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        if (m_time - it->second.created > m_timeout) {
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    flushPackets();
+}
+
+bool openvox::UdpTransport::send(ClientID client, const u8* data, size_t size, UdpChannel channel /*= UdpChannel::RELIABLE_ORDERED*/) {
+    Connection* c = getConnection(client);
+    if (!c || c->state != ConnectionState::CONNECTED) return false;
+
+    if (channel == UdpChannel::UNRELIABLE) {
+        if (UDP_DATA_HEADER_SIZE + getMessageHeaderSize(channel, false) + size > UDP_MAX_PACKET_SIZE) return false;
+        c->unreliable.push_back(std::vector<u8>(data, data + size));
+        return true;
+    }
+    if (size > UDP_MAX_MESSAGE_SIZE) return false;
+
+    ReliableChannel& ch = c->channels[(int)channel - 1];
+    u16 fragmentCount = (u16)openvoxm::max((size + UDP_FRAGMENT_SIZE - 1) / UDP_FRAGMENT_SIZE, (size_t)1);
+    for (u16 f = 0; f < fragmentCount; f++) {
+        size_t begin = (size_t)f * UDP_FRAGMENT_SIZE;
+        size_t end = openvoxm::min(begin + UDP_FRAGMENT_SIZE, size);
+        OutUnit unit;
+        unit.id = ch.nextSendId++;
+        unit.fragmentIndex = f;
+        unit.fragmentCount = fragmentCount;
+        unit.used = true;
+        unit.acked = false;
+        unit.lastSent = -1.0;
+        unit.data.assign(data + begin, data + end);
+        // Units wait their turn once the window is full so ids enter it in order
+        if (ch.waiting.empty() && (u16)(unit.id - ch.oldestUnacked) < UDP_RELIABLE_WINDOW) {
+            ch.sent[unit.id & (UDP_RELIABLE_WINDOW - 1)] = std::move(unit);
+        } else {
+            ch.waiting.push_back(std::move(unit));
+        }
+    }
+    return true;
+}
+
+bool openvox::UdpTransport::receive(ClientID client, OUT std::vector<u8>& message) {
+    Connection* c = getConnection(client);
+    if (!c || c->inbox.empty()) return false;
+    message.swap(c->inbox.front());
+    c->inbox.pop_front();
+    return true;
+}
+
+void openvox::UdpTransport::setSimulation(f32 lossRate, f32 latency, f32 jitter) {
+    m_lossRate = lossRate;
+    m_latency = latency;
+    m_jitter = jitter;
+}
+
+bool openvox::UdpTransport::isConnected(ClientID client) const {
+    Connection* c = getConnection(client);
+    return c && c->state == ConnectionState::CONNECTED;
+}
+
+void openvox::UdpTransport::getClients(OUT std::vector<ClientID>& clients) const {
+    clients.clear();
+    for (const Connection* c : m_connections) {
+        if (c->state == ConnectionState::CONNECTED) clients.push_back(c->id);
+    }
+}
+
+const openvox::UdpConnectionStats* openvox::UdpTransport::getStats(ClientID client) const {
+    Connection* c = getConnection(client);
+    if (!c) return nullptr;
+    c->stats.rtt = c->rtt;
+    c->stats.congestionWindow = c->congestionWindow;
+    return &c->stats;
+}
+
+openvox::UdpTransport::Connection* openvox::UdpTransport::createConnection(const NetAddress& address) {
+    Connection* c = new Connection;
+    c->id = m_nextClientID++;
+    c->address = address;
+    c->state = ConnectionState::CONNECTED;
+    c->clientSalt = 0;
+    c->session = 0;
+    c->lastReceived = m_time;
+    c->lastSent = m_time;
+    c->sentPackets.resize(UDP_SENT_PACKET_RING);
+    for (SentPacket& p : c->sentPackets) p.used = false;
+    for (int i = 0; i < 2; i++) {
+        ReliableChannel& ch = c->channels[i];
+        ch.ordered = i == 1;
+        ch.sent.resize(UDP_RELIABLE_WINDOW);
+        ch.received.resize(UDP_RELIABLE_WINDOW);
+        for (OutUnit& u : ch.sent) u.used = false;
+        for (InUnit& u : ch.received) u.present = false;
+    }
+    std::memset(&c->stats, 0, sizeof(c->stats));
+
+    m_connections.push_back(c);
+    m_connectionIDs[c->id] = c;
+    m_connectionAddresses[getAddressKey(address)] = c;
+    return c;
+}
+
+openvox::UdpTransport::Connection* openvox::UdpTransport::findConnection(const NetAddress& address) const {
+    auto it = m_connectionAddresses.find(getAddressKey(address));
+    return it != m_connectionAddresses.end() ? it->second : nullptr;
+}
+
+openvox::UdpTransport::Connection* openvox::UdpTransport::getConnection(ClientID client) const {
+    auto it = m_connectionIDs.find(client);
+    return it != m_connectionIDs.end() ? it->second : nullptr;
+}
+
+void openvox::UdpTransport::removeConnection(ClientID client, bool notify) {
+    Connection* c = getConnection(client);
+    if (!c) return;
+    m_connectionIDs.erase(client);
+    m_connectionAddresses.erase(getAddressKey(c->address));
+    m_connections.erase(std::find(m_connections.begin(), m_connections.end(), c));
+    bool wasConnected = c->state == ConnectionState::CONNECTED;
+    delete c;
+    if (notify && wasConnected) onDisconnect(client);
+}
+
+openvox::UdpTransport::Packet* openvox::UdpTransport::allocatePacket(const NetAddress& address) {
+    Packet* p;
+    if (m_packetPool.size()) {
+        p = m_packetPool.back();
+        m_packetPool.pop_back();
+    } else {
+        p = new Packet;
+    }
+    p->address = address;
+    p->size = 0;
+    return p;
+}
+
+void openvox::UdpTransport::queuePacket(Packet* packet) {
+    if (m_lossRate > 0.0f || m_latency > 0.0f || m_jitter > 0.0f) {
+        std::uniform_real_distribution<f32> dist(0.0f, 1.0f);
+        if (dist(m_random) < m_lossRate) {
+            m_packetPool.push_back(packet);
+            return;
+        }
+        packet->releaseTime = m_time + m_latency + dist(m_random) * m_jitter;
+        m_delayed.push_back(packet);
+        return;
+    }
+    m_outgoing.push_back(packet);
+}
+
+void openvox::UdpTransport::flushPackets() {
+    if (m_delayed.size()) {
+        // Stable so packets released in the same update keep their order unless jitter reordered them
+        std::stable_sort(m_delayed.begin(), m_delayed.end(), [](const Packet* a, const Packet* b) {
+            return a->releaseTime < b->releaseTime;
+        });
+        f64 now = getTime();
+        size_t due = 0;
+        while (due < m_delayed.size() && m_delayed[due]->releaseTime <= now) due++;
+        m_outgoing.insert(m_outgoing.end(), m_delayed.begin(), m_delayed.begin() + due);
+        m_delayed.erase(m_delayed.begin(), m_delayed.begin() + due);
+    }
+    if (m_outgoing.empty()) return;
+
+#if defined(UDP_BATCH_SIZE)
+    mmsghdr messages[UDP_BATCH_SIZE];
+    iovec vectors[UDP_BATCH_SIZE];
+    sockaddr_in addresses[UDP_BATCH_SIZE];
+    for (size_t begin = 0; begin < m_outgoing.size(); begin += UDP_BATCH_SIZE) {
+        u32 count = (u32)openvoxm::min(m_outgoing.size() - begin, (size_t)UDP_BATCH_SIZE);
+        for (u32 i = 0; i < count; i++) {
+            Packet* p = m_outgoing[begin + i];
+            addresses[i] = toSockAddr(p->address);
+            vectors[i].iov_base = p->data;
+            vectors[i].iov_len = p->size;
+            std::memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        u32 sent = 0;
+        while (sent < count) {
+            int n = sendmmsg((int)m_socket, messages + sent, count - sent, 0);
+            // A full send buffer drops the rest, which reliability recovers like any loss
+            if (n <= 0) break;
+            sent += (u32)n;
+        }
+    }
+#else
+    for (Packet* p : m_outgoing) {
+        sockaddr_in addr = toSockAddr(p->address);
+        sendto(m_socket, (const char*)p->data, (int)p->size, 0, (const sockaddr*)&addr, sizeof(addr));
+    }
+#endif
+    m_packetPool.insert(m_packetPool.end(), m_outgoing.begin(), m_outgoing.end());
+    m_outgoing.clear();
+}
+
+void openvox::UdpTransport::receivePackets() {
+#if defined(UDP_BATCH_SIZE)
+    Packet* packets[UDP_BATCH_SIZE];
+    mmsghdr messages[UDP_BATCH_SIZE];
+    iovec vectors[UDP_BATCH_SIZE];
+    sockaddr_in addresses[UDP_BATCH_SIZE];
+    NetAddress none = { 0, 0 };
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) packets[i] = allocatePacket(none);
+    for (;;) {
+        for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+            vectors[i].iov_base = packets[i]->data;
+            vectors[i].iov_len = UDP_MAX_PACKET_SIZE;
+            std::memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &vectors[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int n = recvmmsg((int)m_socket, messages, UDP_BATCH_SIZE, 0, nullptr);
+        if (n <= 0) break;
+        for (int i = 0; i < n; i++) {
+            handlePacket(fromSockAddr(addresses[i]), packets[i]->data, messages[i].msg_len);
+        }
+        if (n < UDP_BATCH_SIZE) break;
+    }
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) m_packetPool.push_back(packets[i]);
+#else
+    u8 buffer[UDP_MAX_PACKET_SIZE];
+    for (;;) {
+        sockaddr_in addr;
+        socklen_t length = sizeof(addr);
+        int n = (int)recvfrom(m_socket, (char*)buffer, sizeof(buffer), 0, (sockaddr*)&addr, &length);
+        if (n < 0) break;
+        handlePacket(fromSockAddr(addr), buffer, (size_t)n);
+    }
+#endif
+}
+
+void openvox::UdpTransport::handlePacket(const NetAddress& address, const u8* data, size_t size) {
+    if (size < 1) return;
+    u8 type = data[0];
+    Connection* c = findConnection(address);
+
+    if (type == PACKET_DATA || type == PACKET_ACKED_DATA) {
+        if (!c || size < UDP_DATA_HEADER_SIZE || get32(data + 1) != c->session || c->state == ConnectionState::REQUESTING) return;
+        if (c->state == ConnectionState::RESPONDING) {
+            // The accept was lost but the server is already sending data
+            c->state = ConnectionState::CONNECTED;
+            onConnect(c->id);
+        }
+        handleData(*c, data, size);
+        return;
+    }
+
+    if (size < 13 || get32(data + 1) != UDP_PROTOCOL_ID) return;
+    u32 a = get32(data + 5);
+    u32 b = get32(data + 9);
+    switch (type) {
+        case PACKET_CONNECT_REQUEST: {
+            if (!m_accepting || c || !a) return;
+            PendingConnection& p = m_pending[getAddressKey(address)];
+            if (p.clientSalt != a) {
+                p.clientSalt = a;
+                do {
+                    p.serverSalt = m_random();
+                } while (!p.serverSalt || p.serverSalt == a);
+                p.created = m_time;
+            }
+            sendHandshake(address, PACKET_CHALLENGE, a, p.serverSalt);
+            break;
+        }
+        case PACKET_CHALLENGE:
+            if (!c || c->state != ConnectionState::REQUESTING || a != c->clientSalt) return;
+            c->session = a ^ b;
+            c->state = ConnectionState::RESPONDING;
+            c->lastReceived = m_time;
+            c->lastSent = m_time;
+            sendHandshake(address, PACKET_RESPONSE, c->session, c->clientSalt);
+            break;
+        case PACKET_RESPONSE: {
+            if (c) {
+                // Our accept was lost, send it again
+                if (c->session == a) sendHandshake(address, PACKET_ACCEPT, a, 0);
+                return;
+            }
+            auto it = m_pending.find(getAddressKey(address));
+            if (it == m_pending.end() || it->second.clientSalt != b || (b ^ it->second.serverSalt) != a) return;
+            m_pending.erase(it);
+            c = createConnection(address);
+            c->session = a;
+            sendHandshake(address, PACKET_ACCEPT, a, 0);
+            onConnect(c->id);
+            break;
+        }
+        case PACKET_ACCEPT:
+            if (!c || c->state != ConnectionState::RESPONDING || a != c->session) return;
+            c->state = ConnectionState::CONNECTED;
+            c->lastReceived = m_time;
+            onConnect(c->id);
+            break;
+        case PACKET_DISCONNECT:
+            if (c && c->state == ConnectionState::CONNECTED && a == c->session) removeConnection(c->id, true);
+            break;
+    }
+}
+
+void openvox::UdpTransport::handleData(Connection& c, const u8* data, size_t size) {
+    c.lastReceived = m_time;
+    c.stats.packetsReceived++;
+    c.stats.bytesReceived += size;
+
+    u16 sequence = get16(data + 5);
+    if (!c.receivedAny) {
+        c.receivedAny = true;
+        c.remoteSequence = sequence;
+        c.remoteAckBits = 0;
+    } else if (sequenceGreater(sequence, c.remoteSequence)) {
+        u32 shift = (u16)(sequence - c.remoteSequence);
+        if (shift > 32) {
+            c.remoteAckBits = 0;
+        } else if (shift == 32) {
+            c.remoteAckBits = 1u << 31;
+        } else {
+            c.remoteAckBits = (c.remoteAckBits << shift) | (1u << (shift - 1));
+        }
+        c.remoteSequence = sequence;
+    } else {
+        u32 behind = (u16)(c.remoteSequence - sequence);
+        if (behind >= 1 && behind <= 32) c.remoteAckBits |= 1u << (behind - 1);
+    }
+    c.ackPending = true;
+    if (data[0] == PACKET_ACKED_DATA) handleAcks(c, get16(data + 7), get32(data + 9));
+
+    const u8* p = data + UDP_DATA_HEADER_SIZE;
+    const u8* end = data + size;
+    while (end - p >= 3) {
+        u8 flags = p[0];
+        u16 length = get16(p + 1);
+        UdpChannel channel = (UdpChannel)(flags & 3);
+        if ((int)channel >= UDP_CHANNEL_COUNT) return;
+        bool fragmented = (flags & MESSAGE_FRAGMENTED) != 0;
+        size_t header = getMessageHeaderSize(channel, fragmented);
+        if ((size_t)(end - p) < header + length) return;
+
+        if (channel == UdpChannel::UNRELIABLE) {
+            c.inbox.push_back(std::vector<u8>(p + header, p + header + length));
+        } else {
+            u16 id = get16(p + 3);
+            u16 fragmentIndex = fragmented ? get16(p + 5) : 0;
+            u16 fragmentCount = fragmented ? get16(p + 7) : 1;
+            receiveUnit(c, channel, id, fragmentIndex, fragmentCount, p + header, length);
+        }
+        p += header + length;
+    }
+}
+
+void openvox::UdpTransport::handleAcks(Connection& c, u16 ack, u32 ackBits) {
+    if (!c.anyAcked || sequenceGreater(ack, c.newestAcked)) {
+        c.anyAcked = true;
+        c.newestAcked = ack;
+    }
+    for (u32 i = 0; i <= 32; i++) {
+        if (i > 0 && !(ackBits & (1u << (i - 1)))) continue;
+        u16 sequence = (u16)(ack - i);
+        SentPacket& sp = c.sentPackets[sequence & (UDP_SENT_PACKET_RING - 1)];
+        if (!sp.used || sp.sequence != sequence || sp.acked) continue;
+        sp.acked = true;
+        c.stats.packetsAcked++;
+        c.rtt += ((f32)(m_time - sp.time) - c.rtt) * 0.125f;
+        if (!sp.reliable) continue;
+        if (!sp.lost) c.reliableInFlight--;
+        // Slow start doubles the window every round trip, congestion avoidance adds one packet
+        if (c.congestionWindow < c.slowStartThreshold) {
+            c.congestionWindow += 1.0f;
+        } else {
+            c.congestionWindow += 1.0f / c.congestionWindow;
+        }
+        c.congestionWindow = openvoxm::min(c.congestionWindow, UDP_MAX_CONGESTION_WINDOW);
+
+        for (u32 unit : sp.units) {
+            ReliableChannel& ch = c.channels[unit >> 16];
+            OutUnit& u = ch.sent[unit & (UDP_RELIABLE_WINDOW - 1)];
+            if (!u.used || u.id != (u16)unit || u.acked) continue;
+            u.acked = true;
+            std::vector<u8>().swap(u.data);
+        }
+        std::vector<u32>().swap(sp.units);
+    }
+
+    // A packet still unacked a round trip after it was sent, while several newer ones were
+    // acked, is most likely lost rather than reordered, so it is resent before the timeout
+    f64 reorderTime = c.rtt * 1.25;
+    for (SentPacket& sp : c.sentPackets) {
+        if (sp.used && sp.reliable && !sp.acked && !sp.lost && sequenceGreater(c.newestAcked, (u16)(sp.sequence + 2)) &&
+            m_time - sp.time > reorderTime) {
+            markLost(c, sp);
+        }
+    }
+
+    // Slide each window past acked units and let waiting units in
+    for (int i = 0; i < 2; i++) {
+        ReliableChannel& ch = c.channels[i];
+        while (ch.oldestUnacked != ch.nextSendId) {
+            OutUnit& u = ch.sent[ch.oldestUnacked & (UDP_RELIABLE_WINDOW - 1)];
+            if (u.used && !u.acked) break;
+            u.used = false;
+            ch.oldestUnacked++;
+        }
+        while (ch.waiting.size() && (u16)(ch.waiting.front().id - ch.oldestUnacked) < UDP_RELIABLE_WINDOW) {
+            ch.sent[ch.waiting.front().id & (UDP_RELIABLE_WINDOW - 1)] = std::move(ch.waiting.front());
+            ch.waiting.pop_front();
+        }
+    }
+}
+
+void openvox::UdpTransport::receiveUnit(Connection& c, UdpChannel channel, u16 id, u16 fragmentIndex, u16 fragmentCount,
+                                        const u8* data, size_t size) {
+    if (fragmentCount == 0 || fragmentIndex >= fragmentCount || fragmentCount > UDP_RELIABLE_WINDOW / 2) return;
+    ReliableChannel& ch = c.channels[(int)channel - 1];
+    // Units outside the window were already delivered
+    if ((u16)(id - ch.receiveBase) >= UDP_RELIABLE_WINDOW) return;
+    InUnit& slot = ch.received[id & (UDP_RELIABLE_WINDOW - 1)];
+    if (slot.present && slot.id == id) return;
+    slot.id = id;
+    slot.fragmentIndex = fragmentIndex;
+    slot.fragmentCount = fragmentCount;
+    slot.present = true;
+    slot.delivered = false;
+    slot.data.assign(data, data + size);
+
+    // Checks that all fragments of the message starting at first arrived
+    auto isComplete = [&ch](u16 first, u16 count) {
+        for (u16 k = 0; k < count; k++) {
+            const InUnit& u = ch.received[(u16)(first + k) & (UDP_RELIABLE_WINDOW - 1)];
+            if (!u.present || u.id != (u16)(first + k) || u.fragmentIndex != k || u.fragmentCount != count) return false;
+        }
+        return true;
+    };
+    auto deliver = [&c, &ch](u16 first, u16 count) {
+        std::vector<u8> message;
+        for (u16 k = 0; k < count; k++) {
+            InUnit& u = ch.received[(u16)(first + k) & (UDP_RELIABLE_WINDOW - 1)];
+            message.insert(message.end(), u.data.begin(), u.data.end());
+            std::vector<u8>().swap(u.data);
+            u.delivered = true;
+        }
+        c.inbox.push_back(std::vector<u8>());
+        c.inbox.back().swap(message);
+    };
+
+    if (ch.ordered) {
+        for (;;) {
+            InUnit& base = ch.received[ch.receiveBase & (UDP_RELIABLE_WINDOW - 1)];
+            if (!base.present || base.id != ch.receiveBase || base.fragmentIndex != 0) break;
+            u16 count = base.fragmentCount;
+            if (!isComplete(ch.receiveBase, count)) break;
+            deliver(ch.receiveBase, count);
+            for (u16 k = 0; k < count; k++) ch.received[(u16)(ch.receiveBase + k) & (UDP_RELIABLE_WINDOW - 1)].present = false;
+            ch.receiveBase += count;
+        }
+        return;
+    }
+
+    u16 first = (u16)(id - fragmentIndex);
+    if (isComplete(first, fragmentCount)) deliver(first, fragmentCount);
+    for (;;) {
+        InUnit& base = ch.received[ch.receiveBase & (UDP_RELIABLE_WINDOW - 1)];
+        if (!base.present || base.id != ch.receiveBase || !base.delivered) break;
+        base.present = false;
+        ch.receiveBase++;
+    }
+}
+
+void openvox::UdpTransport::markLost(Connection& c, SentPacket& packet) {
+    packet.lost = true;
+    c.reliableInFlight--;
+    for (u32 unit : packet.units) {
+        OutUnit& u = c.channels[unit >> 16].sent[unit & (UDP_RELIABLE_WINDOW - 1)];
+        // Units sent again in a newer packet wait for that one
+        if (u.used && u.id == (u16)unit && !u.acked && u.lastSent <= packet.time) u.lastSent = 0.0;
+    }
+}
+
+void openvox::UdpTransport::sendHandshake(const NetAddress& address, u8 type, u32 a, u32 b) {
+    Packet* p = allocatePacket(address);
+    p->data[0] = type;
+    put32(p->data + 1, UDP_PROTOCOL_ID);
+    put32(p->data + 5, a);
+    put32(p->data + 9, b);
+    p->size = 13;
+    queuePacket(p);
+}
+
+void openvox::UdpTransport::sendConnection(Connection& c) {
+    if (c.state != ConnectionState::CONNECTED) {
+        if (m_time - c.lastSent < UDP_HANDSHAKE_RESEND) return;
+        c.lastSent = m_time;
+        if (c.state == ConnectionState::REQUESTING) {
+            sendHandshake(c.address, PACKET_CONNECT_REQUEST, c.clientSalt, 0);
+        } else {
+            sendHandshake(c.address, PACKET_RESPONSE, c.session, c.clientSalt);
+        }
+        return;
+    }
+
+    f64 resendTime = openvoxm::max((f64)c.rtt * 2.0, UDP_MIN_RESEND_TIME);
+    // Packets that went unacked for too long no longer count against the window
+    for (SentPacket& sp : c.sentPackets) {
+        if (sp.used && sp.reliable && !sp.acked && !sp.lost && m_time - sp.time > resendTime) markLost(c, sp);
+    }
+
+    Packet* packet = nullptr;
+    SentPacket* record = nullptr;
+    bool sentAny = false;
+    auto finish = [&]() {
+        if (!packet) return;
+        endDataPacket(c, packet, *record);
+        packet = nullptr;
+        sentAny = true;
+    };
+    auto writeMessage = [&](UdpChannel channel, const OutUnit* unit, const std::vector<u8>& data) {
+        bool fragmented = unit && unit->fragmentCount > 1;
+        size_t header = getMessageHeaderSize(channel, fragmented);
+        if (packet && packet->size + header + data.size() > UDP_MAX_PACKET_SIZE) finish();
+        if (!packet) {
+            packet = beginDataPacket(c);
+            record = &c.sentPackets[c.nextSequence & (UDP_SENT_PACKET_RING - 1)];
+        }
+        u8* p = packet->data + packet->size;
+        p[0] = (u8)((int)channel | (fragmented ? MESSAGE_FRAGMENTED : 0));
+        put16(p + 1, (u16)data.size());
+        if (unit) {
+            put16(p + 3, unit->id);
+            if (fragmented) {
+                put16(p + 5, unit->fragmentIndex);
+                put16(p + 7, unit->fragmentCount);
+            }
+            record->reliable = true;
+            record->units.push_back(((u32)((int)channel - 1) << 16) | unit->id);
+        }
+        if (data.size()) std::memcpy(p + header, data.data(), data.size());
+        packet->size += header + data.size();
+    };
+
+    while (c.unreliable.size()) {
+        writeMessage(UdpChannel::UNRELIABLE, nullptr, c.unreliable.front());
+        c.unreliable.pop_front();
+    }
+
+    for (int i = 0; i < 2; i++) {
+        ReliableChannel& ch = c.channels[i];
+        UdpChannel channel = (UdpChannel)(i + 1);
+        for (u16 id = ch.oldestUnacked; id != ch.nextSendId; id++) {
+            OutUnit& u = ch.sent[id & (UDP_RELIABLE_WINDOW - 1)];
+            if (!u.used || u.id != id) break;
+            if (u.acked || (u.lastSent >= 0.0 && m_time - u.lastSent < resendTime)) continue;
+            // Starting another packet with reliable data must fit in the congestion window
+            bool needsPacket = !packet || !record->reliable ||
+                packet->size + getMessageHeaderSize(channel, u.fragmentCount > 1) + u.data.size() > UDP_MAX_PACKET_SIZE;
+            if (needsPacket && c.reliableInFlight + (packet && record->reliable ? 1 : 0) >= (u32)c.congestionWindow) break;
+            if (u.lastSent >= 0.0) {
+                c.stats.unitsResent++;
+                if (m_time - c.lastLossTime > c.rtt) {
+                    c.lastLossTime = m_time;
+                    c.slowStartThreshold = openvoxm::max(c.congestionWindow * 0.5f, UDP_MIN_CONGESTION_WINDOW);
+                    c.congestionWindow = c.slowStartThreshold;
+                }
+            }
+            u.lastSent = m_time;
+            writeMessage(channel, &u, u.data);
+        }
+    }
+    finish();
+
+    if (!sentAny && (c.ackPending || m_time - c.lastSent > UDP_KEEPALIVE)) {
+        packet = beginDataPacket(c);
+        record = &c.sentPackets[c.nextSequence & (UDP_SENT_PACKET_RING - 1)];
+        finish();
+    }
+}
+
+openvox::UdpTransport::Packet* openvox::UdpTransport::beginDataPacket(Connection& c) {
+    SentPacket& record = c.sentPackets[c.nextSequence & (UDP_SENT_PACKET_RING - 1)];
+    // An old packet still in flight is given up on when its slot is reused
+    if (record.used && record.reliable && !record.acked && !record.lost) c.reliableInFlight--;
+    record.used = true;
+    record.sequence = c.nextSequence;
+    record.acked = false;
+    record.reliable = false;
+    record.lost = false;
+    record.time = m_time;
+    record.units.clear();
+
+    Packet* p = allocatePacket(c.address);
+    // Until something arrives remoteSequence is not a real sequence and must not ack one
+    p->data[0] = c.receivedAny ? PACKET_ACKED_DATA : PACKET_DATA;
+    put32(p->data + 1, c.session);
+    put16(p->data + 5, c.nextSequence);
+    put16(p->data + 7, c.remoteSequence);
+    put32(p->data + 9, c.remoteAckBits);
+    p->size = UDP_DATA_HEADER_SIZE;
+    return p;
+}
+
+void openvox::UdpTransport::endDataPacket(Connection& c, Packet* packet, SentPacket& record) {
+    if (record.reliable) c.reliableInFlight++;
+    c.nextSequence++;
+    c.lastSent = m_time;
+    c.ackPending = false;
+    c.stats.packetsSent++;
+    c.stats.bytesSent += packet->size;
+    queuePacket(packet);
+}
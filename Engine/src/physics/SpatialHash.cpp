@@ -0,0 +1,316 @@
+#include "physics/SpatialHash.h"
+
+#include <limits>
+
+#include "jobs/JobSystem.h"
+#include "math/OpenVoxMath.hpp"
+
+#define CELL_INDEX_MASK ((1u << 27) - 1)
+
+openvox::SpatialHash::SpatialHash(f32 cellSize /*= DEFAULT_SPATIAL_CELL_SIZE*/) :
+    m_cellSize(cellSize),
+    m_invCellSize(1.0f / cellSize) {
+    // Empty
+}
+
+void openvox::SpatialHash::insert(EntityID id, const f32v3& position) {
+    if (contains(id)) {
+        update(id, position);
+        return;
+    }
+    if (id >= m_entities.size()) m_entities.resize(id + 1);
+    i32v3 coord = getCell(position);
+    addToCell(getShard(coord), coord, id, position);
+    m_entityCount++;
+}
+
+bool openvox::SpatialHash::remove(EntityID id) {
+    if (!contains(id)) return false;
+    removeFromCell(m_entities[id]);
+    m_entities[id].cell = INVALID_CELL;
+    m_entityCount--;
+    return true;
+}
+
+void openvox::SpatialHash::update(EntityID id, const f32v3& position) {
+    openvox_assert(contains(id), "Entity " << id << " is not in the spatial hash");
+    EntityRecord& record = m_entities[id];
+    Cell& cell = m_shards[record.cell >> 27].cells[record.cell & CELL_INDEX_MASK];
+
+    i32v3 coord = getCell(position);
+    if (coord == cell.coord) {
+        // Same cell, just refresh the stored position
+        cell.x[record.slot] = position.x;
+        cell.y[record.slot] = position.y;
+        cell.z[record.slot] = position.z;
+        return;
+    }
+    removeFromCell(record);
+    addToCell(getShard(coord), coord, id, position);
+}
+
+void openvox::SpatialHash::clear() {
+    for (auto& shard : m_shards) {
+        shard.lookup.clear();
+        shard.freeCells.clear();
+        for (size_t i = 0; i < shard.cells.size(); i++) {
+            Cell& c = shard.cells[i];
+            c.ids.clear();
+            c.x.clear();
+            c.y.clear();
+            c.z.clear();
+            shard.freeCells.push_back((u32)i);
+        }
+    }
+    m_entities.clear();
+    m_entityCount = 0;
+}
+
+void openvox::SpatialHash::rebuild(const f32v3* positions, size_t count, OPT JobSystem* jobs /*= nullptr*/) {
+    clear();
+    m_entities.resize(count);
+    m_entityCount = count;
+    if (count == 0) return;
+
+    // Phase 1: bin entities by shard. Blocks are fixed size so the
+    // insertion order, and therefore the result, is the same for any thread count.
+    const size_t BLOCK_SIZE = 4096;
+    size_t numBlocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::vector<std::vector<EntityID> > bins(numBlocks * SPATIAL_HASH_SHARDS);
+    std::vector<i32v3> coords(count);
+    auto binBlocks = [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; b++) {
+            size_t last = openvoxm::min((b + 1) * BLOCK_SIZE, count);
+            for (size_t i = b * BLOCK_SIZE; i < last; i++) {
+                coords[i] = getCell(positions[i]);
+                bins[b * SPATIAL_HASH_SHARDS + getShard(coords[i])].push_back((EntityID)i);
+            }
+        }
+    };
+
+    // Phase 2: each shard is filled by exactly one thread
+    auto fillShards = [&](size_t begin, size_t end) {
+        for (size_t s = begin; s < end; s++) {
+            for (size_t b = 0; b < numBlocks; b++) {
+                for (EntityID id : bins[b * SPATIAL_HASH_SHARDS + s]) {
+                    addToCell((u32)s, coords[id], id, positions[id]);
+                }
+            }
+        }
+    };
+
+    if (jobs) {
+        jobs->parallelFor(numBlocks, 1, binBlocks);
+        jobs->parallelFor(SPATIAL_HASH_SHARDS, 1, fillShards);
+    } else {
+        binBlocks(0, numBlocks);
+        fillShards(0, SPATIAL_HASH_SHARDS);
+    }
+}
+
+size_t openvox::SpatialHash::queryRadius(const f32v3& center, f32 radius, OUT EntityID* results, size_t capacity) const {
+    if (capacity == 0) return 0;
+    i32v3 cMin = getCell(center - f32v3(radius));
+    i32v3 cMax = getCell(center + f32v3(radius));
+    f32 radiusSq = radius * radius;
+    size_t count = 0;
+    for (i32 y = cMin.y; y <= cMax.y; y++) {
+        for (i32 z = cMin.z; z <= cMax.z; z++) {
+            for (i32 x = cMin.x; x <= cMax.x; x++) {
+                const Cell* cell = findCell(i32v3(x, y, z));
+                if (!cell) continue;
+                count = gatherSphere(*cell, center, radiusSq, results, count, capacity);
+                if (count == capacity) return count;
+            }
+        }
+    }
+    return count;
+}
+
+size_t openvox::SpatialHash::queryAABB(const f32v3& min, const f32v3& max, OUT EntityID* results, size_t capacity) const {
+    if (capacity == 0) return 0;
+    i32v3 cMin = getCell(min);
+    i32v3 cMax = getCell(max);
+    size_t count = 0;
+    for (i32 y = cMin.y; y <= cMax.y; y++) {
+        for (i32 z = cMin.z; z <= cMax.z; z++) {
+            for (i32 x = cMin.x; x <= cMax.x; x++) {
+                const Cell* cell = findCell(i32v3(x, y, z));
+                if (!cell) continue;
+                const size_t n = cell->ids.size();
+                for (size_t i = 0; i < n; i++) {
+                    if (cell->x[i] >= min.x && cell->x[i] <= max.x &&
+                        cell->y[i] >= min.y && cell->y[i] <= max.y &&
+                        cell->z[i] >= min.z && cell->z[i] <= max.z) {
+                        results[count++] = cell->ids[i];
+                        if (count == capacity) return count;
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+size_t openvox::SpatialHash::queryRay(const f32v3& origin, const f32v3& direction, f32 maxDistance, f32 radius,
+                                      OUT EntityID* results, size_t capacity) const {
+    if (capacity == 0) return 0;
+    f32v3 dir = openvoxm::normalize(direction);
+    f32 radiusSq = radius * radius;
+    i32 reach = (i32)std::ceil(radius * m_invCellSize);
+
+    // Amanatides & Woo traversal over the cells the ray passes through
+    i32v3 cell = getCell(origin);
+    i32v3 step;
+    f32v3 tMax, tDelta;
+    for (int a = 0; a < 3; a++) {
+        f32 d = dir.data[a];
+        if (d > 0.0f) {
+            step.data[a] = 1;
+            tMax.data[a] = ((f32)(cell.data[a] + 1) * m_cellSize - origin.data[a]) / d;
+            tDelta.data[a] = m_cellSize / d;
+        } else if (d < 0.0f) {
+            step.data[a] = -1;
+            tMax.data[a] = ((f32)cell.data[a] * m_cellSize - origin.data[a]) / d;
+            tDelta.data[a] = -m_cellSize / d;
+        } else {
+            step.data[a] = 0;
+            tMax.data[a] = std::numeric_limits<f32>::infinity();
+            tDelta.data[a] = std::numeric_limits<f32>::infinity();
+        }
+    }
+
+    size_t count = 0;
+    bool hasPrev = false;
+    i32v3 prev;
+    f32 t = 0.0f;
+    while (t <= maxDistance) {
+        // Visit the neighborhood of this cell, skipping cells the previous neighborhood covered.
+        // Traversal is monotonic on every axis, so only the previous neighborhood can overlap.
+        for (i32 y = cell.y - reach; y <= cell.y + reach; y++) {
+            for (i32 z = cell.z - reach; z <= cell.z + reach; z++) {
+                for (i32 x = cell.x - reach; x <= cell.x + reach; x++) {
+                    if (hasPrev && openvoxm::abs(x - prev.x) <= reach && openvoxm::abs(y - prev.y) <= reach &&
+                        openvoxm::abs(z - prev.z) <= reach) continue;
+                    const Cell* c = findCell(i32v3(x, y, z));
+                    if (!c) continue;
+                    const size_t n = c->ids.size();
+                    for (size_t i = 0; i < n; i++) {
+                        f32v3 rel(c->x[i] - origin.x, c->y[i] - origin.y, c->z[i] - origin.z);
+                        f32 along = openvoxm::clamp(openvoxm::dot(rel, dir), 0.0f, maxDistance);
+                        f32v3 off = rel - dir * along;
+                        if (openvoxm::lengthSquared(off) <= radiusSq) {
+                            results[count++] = c->ids[i];
+                            if (count == capacity) return count;
+                        }
+                    }
+                }
+            }
+        }
+        prev = cell;
+        hasPrev = true;
+
+        // Advance to the next cell boundary
+        int axis = tMax.x < tMax.y ? (tMax.x < tMax.z ? 0 : 2) : (tMax.y < tMax.z ? 1 : 2);
+        t = tMax.data[axis];
+        cell.data[axis] += step.data[axis];
+        tMax.data[axis] += tDelta.data[axis];
+    }
+    return count;
+}
+
+i32v3 openvox::SpatialHash::getCell(const f32v3& position) const {
+    return i32v3(openvoxm::fastFloor(position.x * m_invCellSize),
+                 openvoxm::fastFloor(position.y * m_invCellSize),
+                 openvoxm::fastFloor(position.z * m_invCellSize));
+}
+
+size_t openvox::SpatialHash::getCellCount() const {
+    size_t n = 0;
+    for (auto& shard : m_shards) n += shard.lookup.size();
+    return n;
+}
+
+u32 openvox::SpatialHash::getShard(const i32v3& coord) {
+    // Use high bits of a multiplicative hash so shards do not correlate with table buckets
+    u32 h = (u32)PositionHash()(coord) * 2654435761u;
+    return h >> 28;
+}
+
+const openvox::SpatialHash::Cell* openvox::SpatialHash::findCell(const i32v3& coord) const {
+    const Shard& shard = m_shards[getShard(coord)];
+    auto it = shard.lookup.find(coord);
+    if (it == shard.lookup.end()) return nullptr;
+    return &shard.cells[it->second];
+}
+
+void openvox::SpatialHash::addToCell(u32 shardIndex, const i32v3& coord, EntityID id, const f32v3& position) {
+    Shard& shard = m_shards[shardIndex];
+    u32 index;
+    auto it = shard.lookup.find(coord);
+    if (it != shard.lookup.end()) {
+        index = it->second;
+    } else {
+        if (!shard.freeCells.empty()) {
+            index = shard.freeCells.back();
+            shard.freeCells.pop_back();
+        } else {
+            index = (u32)shard.cells.size();
+            shard.cells.emplace_back();
+        }
+        shard.cells[index].coord = coord;
+        shard.lookup[coord] = index;
+    }
+
+    Cell& cell = shard.cells[index];
+    EntityRecord& record = m_entities[id];
+    record.cell = packCell(shardIndex, index);
+    record.slot = (u32)cell.ids.size();
+    cell.ids.push_back(id);
+    cell.x.push_back(position.x);
+    cell.y.push_back(position.y);
+    cell.z.push_back(position.z);
+}
+
+void openvox::SpatialHash::removeFromCell(const EntityRecord& record) {
+    Shard& shard = m_shards[record.cell >> 27];
+    u32 index = record.cell & CELL_INDEX_MASK;
+    Cell& cell = shard.cells[index];
+    u32 slot = record.slot;
+
+    // Swap the last entity into the hole
+    EntityID moved = cell.ids.back();
+    cell.ids[slot] = moved;
+    cell.x[slot] = cell.x.back();
+    cell.y[slot] = cell.y.back();
+    cell.z[slot] = cell.z.back();
+    m_entities[moved].slot = slot;
+    cell.ids.pop_back();
+    cell.x.pop_back();
+    cell.y.pop_back();
+    cell.z.pop_back();
+
+    if (cell.ids.empty()) {
+        shard.lookup.erase(cell.coord);
+        shard.freeCells.push_back(index);
+    }
+}
+
+size_t openvox::SpatialHash::gatherSphere(const Cell& cell, const f32v3& center, f32 radiusSq,
+                                          EntityID* results, size_t count, size_t capacity) {
+    if (count >= capacity) return count;
+    const size_t n = cell.ids.size();
+    const f32* xs = cell.x.data();
+    const f32* ys = cell.y.data();
+    const f32* zs = cell.z.data();
+    for (size_t i = 0; i < n; i++) {
+        f32 dx = xs[i] - center.x;
+        f32 dy = ys[i] - center.y;
+        f32 dz = zs[i] - center.z;
+        if (dx * dx + dy * dy + dz * dz <= radiusSq) {
+            results[count++] = cell.ids[i];
+            if (count == capacity) break;
+        }
+    }
+    return count;
+}
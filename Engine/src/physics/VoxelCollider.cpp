@@ -0,0 +1,271 @@
+#include "physics/VoxelCollider.h"
+
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    // Visits the voxel range [vMin, vMax] one chunk at a time so each chunk is fetched once.
+    // F is called with (chunk or nullptr, chunk voxel origin, local min, local max).
+    template<typename F>
+    void forEachChunkInRange(const openvox::ChunkMap* map, const i32v3& vMin, const i32v3& vMax, F f) {
+        i32v3 cMin = openvox::toChunkPosition(vMin);
+        i32v3 cMax = openvox::toChunkPosition(vMax);
+        for (i32 cy = cMin.y; cy <= cMax.y; cy++) {
+            for (i32 cz = cMin.z; cz <= cMax.z; cz++) {
+                for (i32 cx = cMin.x; cx <= cMax.x; cx++) {
+                    i32v3 chunkPos(cx, cy, cz);
+                    i32v3 origin = openvox::toVoxelPosition(chunkPos);
+                    i32v3 lMin(openvoxm::max(vMin.x - origin.x, 0), openvoxm::max(vMin.y - origin.y, 0), openvoxm::max(vMin.z - origin.z, 0));
+                    i32v3 lMax(openvoxm::min(vMax.x - origin.x, CHUNK_MASK), openvoxm::min(vMax.y - origin.y, CHUNK_MASK), openvoxm::min(vMax.z - origin.z, CHUNK_MASK));
+                    f(map->getChunk(chunkPos), origin, lMin, lMax);
+                }
+            }
+        }
+    }
+
+    i32v3 floorToVoxel(const f32v3& v) {
+        return i32v3(openvoxm::fastFloor(v.x), openvoxm::fastFloor(v.y), openvoxm::fastFloor(v.z));
+    }
+}
+
+size_t openvox::CollisionBatch::add(const f32v3& position, const f32v3& halfExtents, f32 stepHeight /*= 0.0f*/) {
+    posX.push_back(position.x);
+    posY.push_back(position.y);
+    posZ.push_back(position.z);
+    velX.push_back(0.0f);
+    velY.push_back(0.0f);
+    velZ.push_back(0.0f);
+    halfX.push_back(halfExtents.x);
+    halfY.push_back(halfExtents.y);
+    halfZ.push_back(halfExtents.z);
+    this->stepHeight.push_back(stepHeight);
+    flags.push_back(COLLISION_NONE);
+    return posX.size() - 1;
+}
+
+void openvox::CollisionBatch::remove(size_t i) {
+#define SWAP_POP(V) V[i] = V.back(); V.pop_back()
+    SWAP_POP(posX); SWAP_POP(posY); SWAP_POP(posZ);
+    SWAP_POP(velX); SWAP_POP(velY); SWAP_POP(velZ);
+    SWAP_POP(halfX); SWAP_POP(halfY); SWAP_POP(halfZ);
+    SWAP_POP(stepHeight);
+    SWAP_POP(flags);
+#undef SWAP_POP
+}
+
+void openvox::CollisionBatch::clear() {
+    posX.clear(); posY.clear(); posZ.clear();
+    velX.clear(); velY.clear(); velZ.clear();
+    halfX.clear(); halfY.clear(); halfZ.clear();
+    stepHeight.clear();
+    flags.clear();
+}
+
+void openvox::CollisionBatch::reserve(size_t n) {
+    posX.reserve(n); posY.reserve(n); posZ.reserve(n);
+    velX.reserve(n); velY.reserve(n); velZ.reserve(n);
+    halfX.reserve(n); halfY.reserve(n); halfZ.reserve(n);
+    stepHeight.reserve(n);
+    flags.reserve(n);
+}
+
+openvox::VoxelCollider::VoxelCollider(const ChunkMap* chunkMap) :
+    m_chunkMap(chunkMap) {
+    // Empty
+}
+
+openvox::MoveResult openvox::VoxelCollider::move(OUT AABB& box, const f32v3& offset, f32 stepHeight /*= 0.0f*/, bool onGround /*= false*/) {
+    MoveResult result;
+
+    // Broadphase: every solid voxel the box could touch, including the step up region
+    AABB region(openvoxm::min(box.min, box.min + offset), openvoxm::max(box.max, box.max + offset));
+    if (stepHeight > 0.0f) region.max.y += stepHeight;
+    gatherCandidates(region);
+
+    // Axis separated resolution. Y goes first so horizontal movement slides along the ground.
+    AABB moved = box;
+    f32v3 d;
+    d.y = clipAxis(moved, 1, offset.y);
+    moved.translate(f32v3(0.0f, d.y, 0.0f));
+    d.x = clipAxis(moved, 0, offset.x);
+    moved.translate(f32v3(d.x, 0.0f, 0.0f));
+    d.z = clipAxis(moved, 2, offset.z);
+    moved.translate(f32v3(0.0f, 0.0f, d.z));
+
+    bool landed = offset.y < 0.0f && d.y != offset.y;
+    bool blockedHorizontal = d.x != offset.x || d.z != offset.z;
+
+    // Step up: retry from stepHeight higher, then settle back down onto the ledge
+    if (stepHeight > 0.0f && blockedHorizontal && (onGround || landed)) {
+        AABB stepped = box;
+        f32v3 s;
+        f32 up = clipAxis(stepped, 1, stepHeight);
+        stepped.translate(f32v3(0.0f, up, 0.0f));
+        s.x = clipAxis(stepped, 0, offset.x);
+        stepped.translate(f32v3(s.x, 0.0f, 0.0f));
+        s.z = clipAxis(stepped, 2, offset.z);
+        stepped.translate(f32v3(0.0f, 0.0f, s.z));
+        f32 down = clipAxis(stepped, 1, -up + openvoxm::min(offset.y, 0.0f));
+        stepped.translate(f32v3(0.0f, down, 0.0f));
+        s.y = up + down;
+
+        if (s.x * s.x + s.z * s.z > d.x * d.x + d.z * d.z) {
+            d = s;
+            moved = stepped;
+            landed = true;
+            result.flags |= COLLISION_STEPPED;
+        }
+    }
+
+    if (d.x != offset.x) result.flags |= COLLISION_X;
+    if (d.y != offset.y) result.flags |= COLLISION_Y;
+    if (d.z != offset.z) result.flags |= COLLISION_Z;
+    if (landed) result.flags |= COLLISION_ON_GROUND;
+
+    box = moved;
+    result.offset = d;
+    return result;
+}
+
+void openvox::VoxelCollider::step(CollisionBatch& batch, f32 dt) {
+    const size_t n = batch.size();
+    f32* px = batch.posX.data();
+    f32* py = batch.posY.data();
+    f32* pz = batch.posZ.data();
+    f32* vx = batch.velX.data();
+    f32* vy = batch.velY.data();
+    f32* vz = batch.velZ.data();
+    const f32* hx = batch.halfX.data();
+    const f32* hy = batch.halfY.data();
+    const f32* hz = batch.halfZ.data();
+
+    // Integrate gravity in a flat loop so it vectorizes
+    const f32 dv = m_gravity * dt;
+    for (size_t i = 0; i < n; i++) {
+        vy[i] -= dv;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        f32v3 offset(vx[i] * dt, vy[i] * dt, vz[i] * dt);
+        AABB box(f32v3(px[i] - hx[i], py[i] - hy[i], pz[i] - hz[i]),
+                 f32v3(px[i] + hx[i], py[i] + hy[i], pz[i] + hz[i]));
+        MoveResult r = move(box, offset, batch.stepHeight[i], (batch.flags[i] & COLLISION_ON_GROUND) != 0);
+
+        px[i] += r.offset.x;
+        py[i] += r.offset.y;
+        pz[i] += r.offset.z;
+        if (r.flags & COLLISION_X) vx[i] = 0.0f;
+        if (r.flags & COLLISION_Y) vy[i] = 0.0f;
+        if (r.flags & COLLISION_Z) vz[i] = 0.0f;
+        batch.flags[i] = r.flags;
+    }
+}
+
+size_t openvox::VoxelCollider::getSolidVoxels(const AABB& region, OUT std::vector<i32v3>& voxels) const {
+    size_t start = voxels.size();
+    const bool unloadedSolid = m_unloadedSolid;
+    forEachChunkInRange(m_chunkMap, floorToVoxel(region.min), floorToVoxel(region.max),
+                        [&](const Chunk* chunk, const i32v3& origin, const i32v3& lMin, const i32v3& lMax) {
+        if (!chunk && !unloadedSolid) return;
+        u32 yMask = (u32)openvox::math::bitRange(lMin.y, lMax.y);
+        for (i32 z = lMin.z; z <= lMax.z; z++) {
+            for (i32 x = lMin.x; x <= lMax.x; x++) {
+                u32 column = chunk ? chunk->getOccupancy().getColumn(x, z) & yMask : yMask;
+                while (column) {
+                    i32 y = (i32)openvox::math::bitScanForward(column);
+                    column &= column - 1;
+                    voxels.push_back(origin + i32v3(x, y, z));
+                }
+            }
+        }
+    });
+    return voxels.size() - start;
+}
+
+bool openvox::VoxelCollider::isBoxObstructed(const AABB& box) const {
+    bool obstructed = false;
+    const bool unloadedSolid = m_unloadedSolid;
+    // Shrink slightly so boxes resting exactly on a face are not obstructed
+    f32v3 eps(COLLISION_EPSILON);
+    forEachChunkInRange(m_chunkMap, floorToVoxel(box.min + eps), floorToVoxel(box.max - eps),
+                        [&](const Chunk* chunk, const i32v3&, const i32v3& lMin, const i32v3& lMax) {
+        if (obstructed) return;
+        if (!chunk) {
+            obstructed = unloadedSolid;
+            return;
+        }
+        // One test covers the whole height of the box in a column
+        u32 yMask = (u32)openvox::math::bitRange(lMin.y, lMax.y);
+        const openvox::ChunkOccupancy& occupancy = chunk->getOccupancy();
+        for (i32 z = lMin.z; z <= lMax.z; z++) {
+            for (i32 x = lMin.x; x <= lMax.x; x++) {
+                if (occupancy.getColumn(x, z) & yMask) {
+                    obstructed = true;
+                    return;
+                }
+            }
+        }
+    });
+    return obstructed;
+}
+
+void openvox::VoxelCollider::gatherCandidates(const AABB& region) {
+    m_candX.clear();
+    m_candY.clear();
+    m_candZ.clear();
+    const bool unloadedSolid = m_unloadedSolid;
+    forEachChunkInRange(m_chunkMap, floorToVoxel(region.min), floorToVoxel(region.max),
+                        [&](const Chunk* chunk, const i32v3& origin, const i32v3& lMin, const i32v3& lMax) {
+        if (!chunk && !unloadedSolid) return;
+        u32 yMask = (u32)openvox::math::bitRange(lMin.y, lMax.y);
+        for (i32 z = lMin.z; z <= lMax.z; z++) {
+            for (i32 x = lMin.x; x <= lMax.x; x++) {
+                u32 column = chunk ? chunk->getOccupancy().getColumn(x, z) & yMask : yMask;
+                while (column) {
+                    i32 y = (i32)openvox::math::bitScanForward(column);
+                    column &= column - 1;
+                    m_candX.push_back((f32)(origin.x + x));
+                    m_candY.push_back((f32)(origin.y + y));
+                    m_candZ.push_back((f32)(origin.z + z));
+                }
+            }
+        }
+    });
+}
+
+f32 openvox::VoxelCollider::clipAxis(const AABB& box, int axis, f32 delta) const {
+    if (delta == 0.0f) return 0.0f;
+
+    const f32* cand[3] = { m_candX.data(), m_candY.data(), m_candZ.data() };
+    const int u = (axis + 1) % 3;
+    const int w = (axis + 2) % 3;
+    const f32* ca = cand[axis];
+    const f32* cu = cand[u];
+    const f32* cw = cand[w];
+    const f32 uMin = box.min.data[u] + COLLISION_EPSILON;
+    const f32 uMax = box.max.data[u] - COLLISION_EPSILON;
+    const f32 wMin = box.min.data[w] + COLLISION_EPSILON;
+    const f32 wMax = box.max.data[w] - COLLISION_EPSILON;
+    const size_t n = m_candX.size();
+
+    // Branch free so the compiler can vectorize over candidates
+    if (delta > 0.0f) {
+        const f32 edge = box.max.data[axis];
+        for (size_t i = 0; i < n; i++) {
+            bool overlaps = (uMin < cu[i] + 1.0f) & (uMax > cu[i]) & (wMin < cw[i] + 1.0f) & (wMax > cw[i]);
+            f32 gap = ca[i] - edge;
+            bool ahead = gap >= -COLLISION_EPSILON;
+            f32 limit = gap > 0.0f ? gap : 0.0f;
+            delta = (overlaps & ahead & (limit < delta)) ? limit : delta;
+        }
+    } else {
+        const f32 edge = box.min.data[axis];
+        for (size_t i = 0; i < n; i++) {
+            bool overlaps = (uMin < cu[i] + 1.0f) & (uMax > cu[i]) & (wMin < cw[i] + 1.0f) & (wMax > cw[i]);
+            f32 gap = ca[i] + 1.0f - edge;
+            bool ahead = gap <= COLLISION_EPSILON;
+            f32 limit = gap < 0.0f ? gap : 0.0f;
+            delta = (overlaps & ahead & (limit > delta)) ? limit : delta;
+        }
+    }
+    return delta;
+}
@@ -0,0 +1,263 @@
+#include "sim/BlockUpdateScheduler.h"
+
+#include <cstring>
+
+namespace {
+    const size_t SAVED_UPDATE_BYTES = 8;
+
+    inline void writeU16(std::vector<u8>& out, u16 v) {
+        out.push_back((u8)v);
+        out.push_back((u8)(v >> 8));
+    }
+    inline void writeU32(std::vector<u8>& out, u32 v) {
+        out.push_back((u8)v);
+        out.push_back((u8)(v >> 8));
+        out.push_back((u8)(v >> 16));
+        out.push_back((u8)(v >> 24));
+    }
+    inline u16 readU16(const u8* p) {
+        return (u16)(p[0] | (p[1] << 8));
+    }
+    inline u32 readU32(const u8* p) {
+        return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+    }
+}
+
+openvox::BlockUpdateScheduler::BlockUpdateScheduler() {
+    std::memset(m_slots, 0xFF, sizeof(m_slots));
+}
+
+openvox::BlockUpdateHandle openvox::BlockUpdateScheduler::schedule(const i32v3& voxelPos, BlockUpdateType type, u32 delay) {
+    if (delay == 0) delay = 1;
+    if (delay > BLOCK_UPDATE_MAX_DELAY) delay = BLOCK_UPDATE_MAX_DELAY;
+    u32 t = allocateTimer();
+    u32 c = getChunkIndex(toChunkPosition(voxelPos));
+
+    Timer& timer = m_timers[t];
+    timer.fireTick = (u32)m_currentTick + delay;
+    timer.chunk = c;
+    timer.voxelIndex = (u16)getVoxelIndex(toLocalPosition(voxelPos));
+    timer.type = type;
+
+    // Push onto the chunk's list
+    ChunkTimers& ct = m_chunks[c];
+    timer.chunkPrev = NONE;
+    timer.chunkNext = ct.head;
+    if (ct.head != NONE) m_timers[ct.head].chunkPrev = t;
+    ct.head = t;
+    ct.count++;
+
+    insert(t);
+    m_pendingCount++;
+    BlockUpdateHandle h = { t, timer.generation };
+    return h;
+}
+
+bool openvox::BlockUpdateScheduler::cancel(BlockUpdateHandle handle) {
+    if (!isPending(handle)) return false;
+    unlinkSlot(handle.index);
+    freeTimer(handle.index);
+    return true;
+}
+
+bool openvox::BlockUpdateScheduler::isPending(BlockUpdateHandle handle) const {
+    return handle.index < m_timers.size() && m_timers[handle.index].generation == handle.generation &&
+        (handle.generation & 1);
+}
+
+size_t openvox::BlockUpdateScheduler::tick(OUT std::vector<BlockUpdate>& fired) {
+    m_currentTick++;
+    u32 now = (u32)m_currentTick;
+
+    // When a level wraps, bring the matching slot of the level above down. Higher levels go first
+    // so their timers can continue down through the lower ones on the same tick.
+    for (int level = TIMING_WHEEL_LEVELS - 1; level > 0; level--) {
+        u32 lowMask = (1u << (level * TIMING_WHEEL_SLOT_BITS)) - 1;
+        if ((now & lowMask) == 0) {
+            cascade(level, (now >> (level * TIMING_WHEEL_SLOT_BITS)) & TIMING_WHEEL_SLOT_MASK);
+        }
+    }
+
+    u32& head = m_slots[0][now & TIMING_WHEEL_SLOT_MASK];
+    size_t count = 0;
+    u32 t = head;
+    head = NONE;
+    while (t != NONE) {
+        Timer& timer = m_timers[t];
+        u32 next = timer.next;
+        BlockUpdate u;
+        u.position = toVoxelPosition(m_chunks[timer.chunk].position) + getVoxelPosition(timer.voxelIndex);
+        u.type = timer.type;
+        fired.push_back(u);
+        freeTimer(t);
+        count++;
+        t = next;
+    }
+    return count;
+}
+
+size_t openvox::BlockUpdateScheduler::unloadChunk(const i32v3& chunkPos) {
+    auto it = m_chunkIndices.find(chunkPos);
+    if (it == m_chunkIndices.end()) return 0;
+    u32 c = it->second;
+    size_t count = m_chunks[c].count;
+    // freeTimer() releases the chunk record along with its last timer
+    while (m_chunks[c].count) {
+        u32 t = m_chunks[c].head;
+        unlinkSlot(t);
+        freeTimer(t);
+    }
+    return count;
+}
+
+void openvox::BlockUpdateScheduler::saveChunk(const i32v3& chunkPos, OUT std::vector<u8>& out) const {
+    auto it = m_chunkIndices.find(chunkPos);
+    if (it == m_chunkIndices.end()) {
+        writeU32(out, 0);
+        return;
+    }
+    const ChunkTimers& ct = m_chunks[it->second];
+    out.reserve(out.size() + 4 + ct.count * SAVED_UPDATE_BYTES);
+    writeU32(out, ct.count);
+    u32 now = (u32)m_currentTick;
+    for (u32 t = ct.head; t != NONE; t = m_timers[t].chunkNext) {
+        const Timer& timer = m_timers[t];
+        writeU16(out, timer.voxelIndex);
+        writeU16(out, timer.type);
+        writeU32(out, timer.fireTick - now);
+    }
+}
+
+size_t openvox::BlockUpdateScheduler::loadChunk(const i32v3& chunkPos, const u8* data, size_t size) {
+    if (size < 4) return 0;
+    u32 count = readU32(data);
+    if ((size - 4) / SAVED_UPDATE_BYTES < count) return 0;
+    const u8* p = data + 4;
+    for (u32 i = 0; i < count; i++, p += SAVED_UPDATE_BYTES) {
+        if (readU16(p) >= CHUNK_SIZE || readU32(p + 4) > BLOCK_UPDATE_MAX_DELAY) return 0;
+    }
+
+    i32v3 origin = toVoxelPosition(chunkPos);
+    p = data + 4;
+    reserve(m_pendingCount + count);
+    for (u32 i = 0; i < count; i++, p += SAVED_UPDATE_BYTES) {
+        schedule(origin + getVoxelPosition(readU16(p)), readU16(p + 2), readU32(p + 4));
+    }
+    return 4 + count * SAVED_UPDATE_BYTES;
+}
+
+void openvox::BlockUpdateScheduler::clear() {
+    // Keep the timers so outstanding handles stay invalid instead of matching new updates
+    m_freeHead = NONE;
+    for (size_t i = m_timers.size(); i-- > 0;) {
+        Timer& timer = m_timers[i];
+        if (timer.generation & 1) timer.generation++;
+        timer.next = m_freeHead;
+        m_freeHead = (u32)i;
+    }
+    std::memset(m_slots, 0xFF, sizeof(m_slots));
+    m_chunks.clear();
+    m_freeChunks.clear();
+    m_chunkIndices.clear();
+    m_pendingCount = 0;
+}
+
+void openvox::BlockUpdateScheduler::reserve(size_t updates) {
+    m_timers.reserve(updates);
+}
+
+u32 openvox::BlockUpdateScheduler::getPendingCount(const i32v3& chunkPos) const {
+    auto it = m_chunkIndices.find(chunkPos);
+    return it == m_chunkIndices.end() ? 0 : m_chunks[it->second].count;
+}
+
+u32 openvox::BlockUpdateScheduler::allocateTimer() {
+    u32 t;
+    if (m_freeHead != NONE) {
+        t = m_freeHead;
+        m_freeHead = m_timers[t].next;
+    } else {
+        t = (u32)m_timers.size();
+        m_timers.emplace_back();
+        m_timers[t].generation = 0;
+    }
+    m_timers[t].generation++;
+    return t;
+}
+
+void openvox::BlockUpdateScheduler::freeTimer(u32 t) {
+    Timer& timer = m_timers[t];
+    ChunkTimers& ct = m_chunks[timer.chunk];
+    if (timer.chunkPrev != NONE) {
+        m_timers[timer.chunkPrev].chunkNext = timer.chunkNext;
+    } else {
+        ct.head = timer.chunkNext;
+    }
+    if (timer.chunkNext != NONE) m_timers[timer.chunkNext].chunkPrev = timer.chunkPrev;
+    if (--ct.count == 0) {
+        m_chunkIndices.erase(ct.position);
+        m_freeChunks.push_back(timer.chunk);
+    }
+
+    timer.generation++;
+    timer.next = m_freeHead;
+    m_freeHead = t;
+    m_pendingCount--;
+}
+
+void openvox::BlockUpdateScheduler::insert(u32 t) {
+    Timer& timer = m_timers[t];
+    u32& head = getSlot(timer.fireTick);
+    timer.prev = NONE;
+    timer.next = head;
+    if (head != NONE) m_timers[head].prev = t;
+    head = t;
+}
+
+void openvox::BlockUpdateScheduler::unlinkSlot(u32 t) {
+    Timer& timer = m_timers[t];
+    if (timer.prev != NONE) {
+        m_timers[timer.prev].next = timer.next;
+    } else {
+        getSlot(timer.fireTick) = timer.next;
+    }
+    if (timer.next != NONE) m_timers[timer.next].prev = timer.prev;
+}
+
+u32& openvox::BlockUpdateScheduler::getSlot(u32 fireTick) {
+    // The highest bit that differs from the current tick picks the level
+    u32 diff = fireTick ^ (u32)m_currentTick;
+    int level = 0;
+    while (level < TIMING_WHEEL_LEVELS - 1 && (diff >> ((level + 1) * TIMING_WHEEL_SLOT_BITS)) != 0) level++;
+    return m_slots[level][(fireTick >> (level * TIMING_WHEEL_SLOT_BITS)) & TIMING_WHEEL_SLOT_MASK];
+}
+
+void openvox::BlockUpdateScheduler::cascade(int level, u32 slot) {
+    u32 t = m_slots[level][slot];
+    m_slots[level][slot] = NONE;
+    while (t != NONE) {
+        u32 next = m_timers[t].next;
+        insert(t);
+        t = next;
+    }
+}
+
+u32 openvox::BlockUpdateScheduler::getChunkIndex(const i32v3& chunkPos) {
+    auto it = m_chunkIndices.find(chunkPos);
+    if (it != m_chunkIndices.end()) return it->second;
+
+    u32 c;
+    if (m_freeChunks.size()) {
+        c = m_freeChunks.back();
+        m_freeChunks.pop_back();
+    } else {
+        c = (u32)m_chunks.size();
+        m_chunks.emplace_back();
+    }
+    ChunkTimers& ct = m_chunks[c];
+    ct.position = chunkPos;
+    ct.head = NONE;
+    ct.count = 0;
+    m_chunkIndices[chunkPos] = c;
+    return c;
+}
@@ -0,0 +1,390 @@
+#include "sim/FluidSimulator.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "jobs/JobSystem.h"
+#include "math/OpenVoxMath.hpp"
+
+#define SIDE_FLOW_DIVISOR 5 ///< Keeps inflow from four sides below the free space of a cell
+
+namespace {
+    // Reads cells around a chunk through its 3x3x3 neighbor tables. Coordinates may be
+    // one or two voxels outside the chunk.
+    template<typename FluidChunk>
+    struct Sampler {
+        const FluidChunk* c;
+
+        u8 fluid(int x, int y, int z) const {
+            const FluidChunk* n = c->neighbors[openvox::getNeighborIndex(x >> CHUNK_WIDTH_BITS, y >> CHUNK_WIDTH_BITS, z >> CHUNK_WIDTH_BITS)];
+            return n ? n->cells[openvox::getVoxelIndex(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK)] : 0;
+        }
+        bool solid(int x, int y, int z) const {
+            const openvox::Chunk* b = c->blocks[openvox::getNeighborIndex(x >> CHUNK_WIDTH_BITS, y >> CHUNK_WIDTH_BITS, z >> CHUNK_WIDTH_BITS)];
+            return !b || b->getBlock(x & CHUNK_MASK, y & CHUNK_MASK, z & CHUNK_MASK) != BLOCK_AIR;
+        }
+        /// True if the cell can take fluid of a type
+        bool canHold(int x, int y, int z, openvox::FluidType type) const {
+            if (solid(x, y, z)) return false;
+            u8 f = fluid(x, y, z);
+            return f == 0 || openvox::getFluidType(f) == type;
+        }
+        /// Fluid moving from a cell into the cell below it
+        u8 downFlow(int x, int y, int z, u8 f) const {
+            u8 level = openvox::getFluidLevel(f);
+            if (level == 0 || solid(x, y, z) || !canHold(x, y - 1, z, openvox::getFluidType(f))) return 0;
+            return openvoxm::min<u8>(level, FLUID_MAX_LEVEL - openvox::getFluidLevel(fluid(x, y - 1, z)));
+        }
+        /// Fluid moving sideways from (x, y, z) into (nx, y, nz). Only happens when the source cannot fall.
+        u8 sideFlow(int x, int y, int z, u8 f, int nx, int nz) const {
+            u8 level = openvox::getFluidLevel(f);
+            if (level == 0) return 0;
+            u8 n = fluid(nx, y, nz);
+            u8 nLevel = openvox::getFluidLevel(n);
+            if (level <= nLevel || solid(x, y, z)) return 0;
+            if (!canHold(nx, y, nz, openvox::getFluidType(f))) return 0;
+            if (fluid(nx, y + 1, nz) != 0) return 0;
+            if (downFlow(x, y, z, f) != 0) return 0;
+            return (u8)((level - nLevel) / SIDE_FLOW_DIVISOR);
+        }
+    };
+
+    const int SIDE_OFFSETS[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+}
+
+openvox::FluidSimulator::FluidSimulator(ChunkMap* chunkMap) :
+    onChunkChanged(this),
+    m_chunkMap(chunkMap) {
+    // Empty
+}
+
+openvox::FluidSimulator::~FluidSimulator() {
+    for (auto& it : m_chunks) delete it.second;
+}
+
+bool openvox::FluidSimulator::update(OPT JobSystem* jobs /*= nullptr*/) {
+    if (!m_tickInProgress) beginTick();
+
+    // Take whole chunks until the budget is spent
+    size_t first = m_nextChunk;
+    size_t cells = 0;
+    while (m_nextChunk < m_tickChunks.size() && (cells < m_cellBudget || m_nextChunk == first)) {
+        cells += m_tickChunks[m_nextChunk]->activeCells;
+        m_nextChunk++;
+    }
+    m_tickCells += cells;
+
+    // Chunks only write their own buffers, so any set of them can run at once
+    auto process = [this, first](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) processChunk(m_tickChunks[first + i]);
+    };
+    if (jobs) {
+        jobs->parallelFor(m_nextChunk - first, 1, process);
+    } else {
+        process(0, m_nextChunk - first);
+    }
+
+    if (m_nextChunk < m_tickChunks.size()) return false;
+    endTick();
+    return true;
+}
+
+void openvox::FluidSimulator::tick(OPT JobSystem* jobs /*= nullptr*/) {
+    while (!update(jobs)) continue;
+}
+
+void openvox::FluidSimulator::setFluid(const i32v3& voxelPos, u8 cell) {
+    PendingEdit e = { voxelPos, cell, false };
+    m_edits.push_back(e);
+}
+
+void openvox::FluidSimulator::wake(const i32v3& voxelPos) {
+    PendingEdit e = { voxelPos, 0, true };
+    m_edits.push_back(e);
+}
+
+u8 openvox::FluidSimulator::getFluid(const i32v3& voxelPos) const {
+    FluidChunk* c = getFluidChunk(toChunkPosition(voxelPos));
+    if (!c) return 0;
+    return c->cells[getVoxelIndex(toLocalPosition(voxelPos))];
+}
+
+void openvox::FluidSimulator::unloadChunk(const i32v3& chunkPos) {
+    openvox_assert(!m_tickInProgress, "Fluid chunks cannot unload during a tick");
+    auto it = m_chunks.find(chunkPos);
+    if (it == m_chunks.end()) return;
+    // Neighbor tables are resolved again before every use, so no other chunk needs fixing up
+    FluidChunk* c = it->second;
+    if (c->touched) {
+        m_touched.erase(std::find(m_touched.begin(), m_touched.end(), c));
+    }
+    delete c;
+    m_chunks.erase(it);
+}
+
+openvox::FluidSimulator::FluidChunk* openvox::FluidSimulator::getFluidChunk(const i32v3& chunkPos) const {
+    auto it = m_chunks.find(chunkPos);
+    return it == m_chunks.end() ? nullptr : it->second;
+}
+
+openvox::FluidSimulator::FluidChunk* openvox::FluidSimulator::createFluidChunk(const i32v3& chunkPos) {
+    FluidChunk* c = new FluidChunk;
+    c->position = chunkPos;
+    std::memset(c->cells, 0, sizeof(c->cells));
+    std::memset(c->next, 0, sizeof(c->next));
+    std::memset(c->active, 0, sizeof(c->active));
+    std::memset(c->nextActive, 0, sizeof(c->nextActive));
+    std::memset(c->neighbors, 0, sizeof(c->neighbors));
+    std::memset(c->blocks, 0, sizeof(c->blocks));
+    c->fluidCells = 0;
+    c->activeCells = 0;
+    c->changed = false;
+    c->touched = false;
+    m_chunks[chunkPos] = c;
+    return c;
+}
+
+void openvox::FluidSimulator::resolveNeighbors(FluidChunk* c) {
+    // A loaded chunk already links its block neighbors
+    const Chunk* center = m_chunkMap->getChunk(c->position);
+    for (int y = -1; y <= 1; y++) {
+        for (int z = -1; z <= 1; z++) {
+            for (int x = -1; x <= 1; x++) {
+                i32v3 p = c->position + i32v3(x, y, z);
+                int i = getNeighborIndex(x, y, z);
+                c->neighbors[i] = getFluidChunk(p);
+                c->blocks[i] = center ? center->getNeighbor(i) : m_chunkMap->getChunk(p);
+            }
+        }
+    }
+}
+
+void openvox::FluidSimulator::beginTick() {
+    // Apply edits made since the last tick
+    for (const PendingEdit& e : m_edits) {
+        i32v3 chunkPos = toChunkPosition(e.voxelPos);
+        FluidChunk* c = getFluidChunk(chunkPos);
+        if (!c) {
+            if (e.wakeOnly || e.cell == 0 || !m_chunkMap->getChunk(chunkPos)) continue;
+            c = createFluidChunk(chunkPos);
+        }
+        i32v3 l = toLocalPosition(e.voxelPos);
+        if (!e.wakeOnly) {
+            u8& cell = c->cells[getVoxelIndex(l)];
+            if (cell != 0) c->fluidCells--;
+            cell = e.cell;
+            if (cell != 0) c->fluidCells++;
+        }
+        resolveNeighbors(c);
+        markActive(c, l.x, l.y, l.z, 2);
+        touch(c);
+        exchangeOutbox(c);
+    }
+    m_edits.clear();
+
+    // Promote next active sets
+    m_tickChunks.clear();
+    for (FluidChunk* c : m_touched) {
+        c->touched = false;
+        u32 count = 0;
+        for (int w = 0; w < FLUID_ACTIVE_WORDS; w++) {
+            c->active[w] = c->nextActive[w];
+            c->nextActive[w] = 0;
+            count += openvoxm::popCount(c->active[w]);
+        }
+        c->activeCells = count;
+        if (count) m_tickChunks.push_back(c);
+    }
+    m_touched.clear();
+    for (FluidChunk* c : m_tickChunks) resolveNeighbors(c);
+
+    m_nextChunk = 0;
+    m_tickCells = 0;
+    m_tickInProgress = true;
+}
+
+void openvox::FluidSimulator::endTick() {
+    for (FluidChunk* c : m_tickChunks) {
+        touch(c);
+        exchangeOutbox(c);
+    }
+
+    // Commit computed cells
+    for (FluidChunk* c : m_tickChunks) {
+        for (int w = 0; w < FLUID_ACTIVE_WORDS; w++) {
+            u64 bits = c->active[w];
+            while (bits) {
+                int i = (w << 6) | (int)openvoxm::bitScanForward(bits);
+                bits &= bits - 1;
+                u8 before = c->cells[i];
+                u8 after = c->next[i];
+                c->fluidCells += (after != 0) - (before != 0);
+                c->cells[i] = after;
+            }
+        }
+        if (m_reactionBlock != BLOCK_AIR) {
+            for (u16 i : c->reactions) {
+                m_chunkMap->setBlock(toVoxelPosition(c->position) + getVoxelPosition(i), m_reactionBlock);
+            }
+        }
+        c->reactions.clear();
+        if (c->changed) {
+            c->changed = false;
+            onChunkChanged(c->position);
+        }
+    }
+
+    // Free layers that hold no fluid and have nothing left to simulate
+    for (FluidChunk* c : m_tickChunks) {
+        if (c->fluidCells != 0) continue;
+        bool idle = true;
+        for (int w = 0; w < FLUID_ACTIVE_WORDS && idle; w++) idle = c->nextActive[w] == 0;
+        if (!idle) continue;
+        m_touched.erase(std::find(m_touched.begin(), m_touched.end(), c));
+        m_chunks.erase(c->position);
+        delete c;
+    }
+
+    m_tickChunks.clear();
+    m_lastTickCells = m_tickCells;
+    m_tickCount++;
+    m_tickInProgress = false;
+}
+
+void openvox::FluidSimulator::processChunk(FluidChunk* c) {
+    Sampler<FluidChunk> s = { c };
+    for (int w = 0; w < FLUID_ACTIVE_WORDS; w++) {
+        u64 bits = c->active[w];
+        while (bits) {
+            int i = (w << 6) | (int)openvoxm::bitScanForward(bits);
+            bits &= bits - 1;
+            int x = i & CHUNK_MASK;
+            int z = (i >> CHUNK_WIDTH_BITS) & CHUNK_MASK;
+            int y = i >> (CHUNK_WIDTH_BITS * 2);
+
+            u8 f = c->cells[i];
+            u8 result;
+            u32 flow = 0;
+            if (s.solid(x, y, z)) {
+                // A block was placed into this cell, the fluid is displaced
+                result = 0;
+            } else {
+                u8 level = getFluidLevel(f);
+                FluidType type = getFluidType(f);
+
+                // Outflow: down first, sideways only if it could not fall
+                u32 out = s.downFlow(x, y, z, f);
+                if (out == 0 && level > 0) {
+                    for (int n = 0; n < 4; n++) {
+                        out += s.sideFlow(x, y, z, f, x + SIDE_OFFSETS[n][0], z + SIDE_OFFSETS[n][1]);
+                    }
+                }
+
+                // Inflow from above, or from the sides when nothing is above
+                u32 in = 0;
+                bool reaction = false;
+                u8 above = s.fluid(x, y + 1, z);
+                if (above != 0) {
+                    in = s.downFlow(x, y + 1, z, above);
+                    if (in && level == 0) type = getFluidType(above);
+                } else {
+                    for (int n = 0; n < 4; n++) {
+                        int nx = x + SIDE_OFFSETS[n][0];
+                        int nz = z + SIDE_OFFSETS[n][1];
+                        u8 nf = s.fluid(nx, y, nz);
+                        u32 amount = s.sideFlow(nx, y, nz, nf, x, z);
+                        if (amount == 0) continue;
+                        in += amount;
+                        if (level == 0) {
+                            if (type == FluidType::NONE) {
+                                type = getFluidType(nf);
+                            } else if (type != getFluidType(nf)) {
+                                reaction = true;
+                            }
+                        }
+                    }
+                }
+
+                flow = out + in;
+                if (reaction) {
+                    result = 0;
+                    c->reactions.push_back((u16)i);
+                } else if (isFluidSource(f)) {
+                    result = f;
+                } else {
+                    result = packFluid(type, (u8)(level - out + in));
+                }
+            }
+
+            c->next[i] = result;
+            if (result != f) {
+                c->changed = true;
+                markActive(c, x, y, z, 2);
+            } else if (flow) {
+                markActive(c, x, y, z, 1);
+            }
+        }
+    }
+}
+
+void openvox::FluidSimulator::markActive(FluidChunk* c, int x, int y, int z, int radius) {
+    for (int ly = y - radius; ly <= y + radius; ly++) {
+        for (int lz = z - radius; lz <= z + radius; lz++) {
+            int cy = ly >> CHUNK_WIDTH_BITS;
+            int cz = lz >> CHUNK_WIDTH_BITS;
+            // Split the x span at chunk borders, radius is small so there are at most two pieces
+            int x0 = x - radius;
+            int x1 = x + radius;
+            int segStart[2], segEnd[2], segChunk[2];
+            int segs = 0;
+            if (x0 < 0) {
+                segStart[segs] = x0 & CHUNK_MASK; segEnd[segs] = CHUNK_MASK; segChunk[segs++] = -1;
+                x0 = 0;
+            }
+            if (x1 > CHUNK_MASK) {
+                segStart[segs] = 0; segEnd[segs] = x1 & CHUNK_MASK; segChunk[segs++] = 1;
+                x1 = CHUNK_MASK;
+            }
+            int total = segs;
+            segStart[total] = x0; segEnd[total] = x1; segChunk[total] = 0;
+            for (int sgi = 0; sgi <= total; sgi++) {
+                u32 mask = (u32)openvoxm::bitRange((u32)segStart[sgi], (u32)segEnd[sgi]);
+                int n = getNeighborIndex(segChunk[sgi], cy, cz);
+                if (n == CHUNK_NEIGHBOR_CENTER) {
+                    int i = getVoxelIndex(0, ly, lz);
+                    c->nextActive[i >> 6] |= (u64)mask << (i & 63);
+                } else {
+                    OutboxEntry e = { (u8)n, (u8)(ly & CHUNK_MASK), (u8)(lz & CHUNK_MASK), mask };
+                    c->outbox.push_back(e);
+                }
+            }
+        }
+    }
+}
+
+void openvox::FluidSimulator::exchangeOutbox(FluidChunk* c) {
+    for (const OutboxEntry& e : c->outbox) {
+        FluidChunk* target = c->neighbors[e.neighbor];
+        if (!target) {
+            i32v3 offset((e.neighbor % 3) - 1, (e.neighbor / 9) - 1, ((e.neighbor / 3) % 3) - 1);
+            i32v3 p = c->position + offset;
+            target = getFluidChunk(p);
+            if (!target) {
+                // Fluid can never enter an unloaded chunk, so there is nothing to wake
+                if (!m_chunkMap->getChunk(p)) continue;
+                target = createFluidChunk(p);
+            }
+            c->neighbors[e.neighbor] = target;
+        }
+        int i = getVoxelIndex(0, e.y, e.z);
+        target->nextActive[i >> 6] |= (u64)e.xMask << (i & 63);
+        touch(target);
+    }
+    c->outbox.clear();
+}
+
+void openvox::FluidSimulator::touch(FluidChunk* c) {
+    if (c->touched) return;
+    c->touched = true;
+    m_touched.push_back(c);
+}
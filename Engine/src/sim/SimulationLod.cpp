@@ -0,0 +1,214 @@
+#include "sim/SimulationLod.h"
+
+#include <limits>
+
+#include "OpenVoxAssert.hpp"
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    inline i32v3 getChunkOf(const f32v3& position) {
+        return openvox::toChunkPosition(i32v3((i32)openvoxm::floor(position.x),
+                                              (i32)openvoxm::floor(position.y),
+                                              (i32)openvoxm::floor(position.z)));
+    }
+
+    inline openvox::SimulationTier makeTier(f32 maxDistance, u32 interval) {
+        openvox::SimulationTier t = { maxDistance, interval };
+        return t;
+    }
+}
+
+void openvox::SimulationLod::Schedule::reset(const std::vector<SimulationTier>& tiers) {
+    slices.assign(tiers.size(), std::vector<std::vector<u32> >());
+    for (size_t t = 0; t < tiers.size(); t++) slices[t].resize(tiers[t].interval);
+    for (Member& m : members) m.tier = SIMULATION_TIER_NONE;
+}
+
+void openvox::SimulationLod::Schedule::add(u32 key, u64 tick) {
+    if (key >= members.size()) {
+        Member m;
+        m.tier = SIMULATION_TIER_NONE;
+        members.resize(key + 1, m);
+    }
+    members[key].nextTick = tick;
+}
+
+void openvox::SimulationLod::Schedule::assign(u32 key, u8 tier) {
+    Member& m = members[key];
+    if (m.tier == tier) return;
+    unassign(key);
+    if (tier == SIMULATION_TIER_NONE) return;
+
+    std::vector<std::vector<u32> >& tierSlices = slices[tier];
+    u32 slice = 0;
+    for (u32 s = 1; s < tierSlices.size(); s++) {
+        if (tierSlices[s].size() < tierSlices[slice].size()) slice = s;
+    }
+    m.tier = tier;
+    m.slice = slice;
+    m.slot = (u32)tierSlices[slice].size();
+    tierSlices[slice].push_back(key);
+}
+
+void openvox::SimulationLod::Schedule::unassign(u32 key) {
+    Member& m = members[key];
+    if (m.tier == SIMULATION_TIER_NONE) return;
+    std::vector<u32>& slice = slices[m.tier][m.slice];
+    slice[m.slot] = slice.back();
+    members[slice[m.slot]].slot = m.slot;
+    slice.pop_back();
+    m.tier = SIMULATION_TIER_NONE;
+}
+
+openvox::SimulationLod::SimulationLod(f32 tickLength) :
+    m_tickLength(tickLength) {
+    std::vector<SimulationTier> tiers;
+    tiers.push_back(makeTier(64.0f, 1));
+    tiers.push_back(makeTier(128.0f, 2));
+    tiers.push_back(makeTier(256.0f, 4));
+    tiers.push_back(makeTier(std::numeric_limits<f32>::infinity(), 8));
+    setTiers(tiers);
+}
+
+void openvox::SimulationLod::setTiers(const std::vector<SimulationTier>& tiers) {
+    openvox_assert(tiers.size() < SIMULATION_TIER_NONE, "Too many simulation tiers");
+    for (size_t i = 0; i < tiers.size(); i++) {
+        openvox_assert(tiers[i].interval >= 1, "Simulation tier interval must be at least 1");
+        openvox_assert(i == 0 || tiers[i].maxDistance >= tiers[i - 1].maxDistance, "Simulation tiers must be sorted by distance");
+    }
+    m_tiers = tiers;
+    m_entities.reset(m_tiers);
+    m_chunks.reset(m_tiers);
+    reclassify();
+}
+
+void openvox::SimulationLod::setPlayers(const std::vector<f32v3>& positions) {
+    bool moved = positions.size() != m_playerChunks.size();
+    m_playerChunks.resize(positions.size());
+    for (size_t i = 0; i < positions.size(); i++) {
+        i32v3 chunk = getChunkOf(positions[i]);
+        if (chunk != m_playerChunks[i]) moved = true;
+        m_playerChunks[i] = chunk;
+    }
+    // Positions within the same chunks are ignored so every cached tier comes from the same
+    // player positions, including tiers of chunks first seen before the next reclassify
+    if (moved) {
+        m_players = positions;
+        m_playersMoved = true;
+    }
+}
+
+void openvox::SimulationLod::setEntity(EntityID id, const f32v3& position) {
+    i32v3 chunk = getChunkOf(position);
+    if (id >= m_entityPresent.size()) {
+        m_entityPresent.resize(id + 1, 0);
+        m_entityChunks.resize(id + 1);
+    }
+    if (!m_entityPresent[id]) {
+        m_entityPresent[id] = 1;
+        m_entities.add(id, m_tick);
+    } else if (chunk == m_entityChunks[id]) {
+        return;
+    }
+    m_entityChunks[id] = chunk;
+    m_entities.assign(id, getCachedTier(chunk));
+}
+
+void openvox::SimulationLod::removeEntity(EntityID id) {
+    if (id >= m_entityPresent.size() || !m_entityPresent[id]) return;
+    m_entityPresent[id] = 0;
+    m_entities.unassign(id);
+}
+
+void openvox::SimulationLod::addChunk(const i32v3& chunkPos) {
+    if (m_chunkKeys.count(chunkPos)) return;
+    u32 key;
+    if (m_freeChunkKeys.size()) {
+        key = m_freeChunkKeys.back();
+        m_freeChunkKeys.pop_back();
+        m_chunkPositions[key] = chunkPos;
+    } else {
+        key = (u32)m_chunkPositions.size();
+        m_chunkPositions.push_back(chunkPos);
+    }
+    m_chunkKeys[chunkPos] = key;
+    m_chunks.add(key, m_tick);
+    m_chunks.assign(key, getCachedTier(chunkPos));
+}
+
+void openvox::SimulationLod::removeChunk(const i32v3& chunkPos) {
+    auto it = m_chunkKeys.find(chunkPos);
+    if (it == m_chunkKeys.end()) return;
+    m_chunks.unassign(it->second);
+    m_freeChunkKeys.push_back(it->second);
+    m_chunkKeys.erase(it);
+}
+
+void openvox::SimulationLod::update(const EntityFunc& updateEntity, const ChunkFunc& tickChunk) {
+    if (m_playersMoved) {
+        reclassify();
+        m_playersMoved = false;
+    }
+
+    size_t count = 0;
+    for (size_t t = 0; t < m_tiers.size(); t++) {
+        u32 slice = (u32)(m_tick % m_tiers[t].interval);
+        for (u32 id : m_entities.slices[t][slice]) {
+            Member& m = m_entities.members[id];
+            updateEntity(id, (f32)(m_tick + 1 - m.nextTick) * m_tickLength);
+            m.nextTick = m_tick + 1;
+        }
+        for (u32 key : m_chunks.slices[t][slice]) {
+            Member& m = m_chunks.members[key];
+            tickChunk(m_chunkPositions[key], (u32)(m_tick + 1 - m.nextTick));
+            m.nextTick = m_tick + 1;
+        }
+        count += m_entities.slices[t][slice].size() + m_chunks.slices[t][slice].size();
+    }
+    m_lastUpdateCount = count;
+    m_tick++;
+}
+
+u8 openvox::SimulationLod::getEntityTier(EntityID id) const {
+    if (id >= m_entityPresent.size() || !m_entityPresent[id]) return SIMULATION_TIER_NONE;
+    return m_entities.members[id].tier;
+}
+
+u8 openvox::SimulationLod::getChunkTier(const i32v3& chunkPos) const {
+    auto it = m_chunkKeys.find(chunkPos);
+    return it != m_chunkKeys.end() ? m_chunks.members[it->second].tier : computeTier(chunkPos);
+}
+
+u8 openvox::SimulationLod::computeTier(const i32v3& chunkPos) const {
+    f32v3 lo(toVoxelPosition(chunkPos));
+    f32v3 hi = lo + (f32)CHUNK_WIDTH;
+    f32 nearest = std::numeric_limits<f32>::infinity();
+    for (const f32v3& p : m_players) {
+        // Distance from the player to the closest point of the chunk
+        f32v3 d = openvoxm::max(openvoxm::max(lo - p, p - hi), f32v3(0.0f));
+        nearest = openvoxm::min(nearest, d.x * d.x + d.y * d.y + d.z * d.z);
+    }
+    for (size_t t = 0; t < m_tiers.size(); t++) {
+        if (nearest <= m_tiers[t].maxDistance * m_tiers[t].maxDistance) return (u8)t;
+    }
+    return SIMULATION_TIER_NONE;
+}
+
+u8 openvox::SimulationLod::getCachedTier(const i32v3& chunkPos) {
+    auto it = m_tierCache.find(chunkPos);
+    if (it != m_tierCache.end()) return it->second;
+    u8 tier = computeTier(chunkPos);
+    // Entities roaming while players stand still would grow the cache without bound. Every
+    // entry comes from the same players, so starting over changes no tier.
+    if (m_tierCache.size() >= SIMULATION_TIER_CACHE_LIMIT) m_tierCache.clear();
+    m_tierCache[chunkPos] = tier;
+    return tier;
+}
+
+void openvox::SimulationLod::reclassify() {
+    m_tierCache.clear();
+    for (EntityID id = 0; id < m_entityPresent.size(); id++) {
+        if (m_entityPresent[id]) m_entities.assign(id, getCachedTier(m_entityChunks[id]));
+    }
+    for (auto& it : m_chunkKeys) m_chunks.assign(it.second, getCachedTier(it.first));
+}
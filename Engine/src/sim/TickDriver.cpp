@@ -0,0 +1,201 @@
+#include "sim/TickDriver.h"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "OpenVoxAssert.hpp"
+#include "Window.h"
+#include "math/OpenVoxMath.hpp"
+
+#define TICK_STATS_SMOOTHING 0.1f ///< Weight of the newest sample in the moving averages
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    inline f32 secondsSince(const Clock::time_point& start) {
+        return std::chrono::duration<f32>(Clock::now() - start).count();
+    }
+
+    inline openvox::TickDegradation makeDegradation(f32 chunkGenerationScale, f32 randomTickScale, u32 distantEntityInterval) {
+        openvox::TickDegradation d;
+        d.chunkGenerationScale = chunkGenerationScale;
+        d.randomTickScale = randomTickScale;
+        d.distantEntityInterval = distantEntityInterval;
+        return d;
+    }
+
+    inline void appendMetric(OUT std::string& out, const char* name, const char* labels, f64 value) {
+        char line[256];
+        snprintf(line, sizeof(line), "%s%s %.9g\n", name, labels, value);
+        out += line;
+    }
+}
+
+openvox::TickDriver::TickDriver(f32 tickRate /*= DEFAULT_TICK_RATE*/) :
+    onTick(this),
+    m_running(false) {
+    setTickRate(tickRate);
+    m_policy.push_back(makeDegradation(1.0f, 1.0f, 1));
+    m_policy.push_back(makeDegradation(0.0f, 1.0f, 1));
+    m_policy.push_back(makeDegradation(0.0f, 0.5f, 1));
+    m_policy.push_back(makeDegradation(0.0f, 0.5f, 2));
+    m_policy.push_back(makeDegradation(0.0f, 0.25f, 4));
+    resetStats();
+}
+
+size_t openvox::TickDriver::addSubsystem(const char* name, f32 budget, TickFunc func) {
+    m_subsystems.push_back(func);
+    TickSubsystemStats s;
+    s.name = name;
+    s.budget = budget;
+    s.lastTime = 0.0f;
+    s.averageTime = 0.0f;
+    s.maxTime = 0.0f;
+    s.overBudgetTicks = 0;
+    m_subsystemStats.push_back(s);
+    return m_subsystems.size() - 1;
+}
+
+void openvox::TickDriver::setPolicy(const std::vector<TickDegradation>& levels) {
+    openvox_assert(levels.size(), "Degradation policy needs at least one level");
+    m_policy = levels;
+    m_level = openvoxm::min(m_level, (u32)m_policy.size() - 1);
+    m_stats.degradationLevel = m_level;
+}
+
+void openvox::TickDriver::setThresholds(f32 overload, f32 recover, u32 recoverTicks) {
+    openvox_assert(recover <= overload, "Recovery threshold must not be above the overload threshold");
+    m_overload = overload;
+    m_recover = recover;
+    m_recoverTicks = recoverTicks;
+}
+
+void openvox::TickDriver::setTickRate(f32 tickRate) {
+    openvox_assert(tickRate > 0.0f, "Tick rate must be positive");
+    m_tickRate = tickRate;
+}
+
+void openvox::TickDriver::tick() {
+    TickContext context;
+    context.tick = m_tickCount;
+    context.dt = 1.0f / m_tickRate;
+    context.degradationLevel = m_level;
+    context.degradation = m_policy[m_level];
+
+    bool first = m_stats.ticks == 0;
+    Clock::time_point tickStart = Clock::now();
+    for (size_t i = 0; i < m_subsystems.size(); i++) {
+        Clock::time_point start = Clock::now();
+        m_subsystems[i](context);
+        f32 time = secondsSince(start);
+
+        TickSubsystemStats& s = m_subsystemStats[i];
+        s.lastTime = time;
+        s.averageTime = first ? time : s.averageTime + (time - s.averageTime) * TICK_STATS_SMOOTHING;
+        s.maxTime = openvoxm::max(s.maxTime, time);
+        if (time > s.budget) s.overBudgetTicks++;
+    }
+    f32 time = secondsSince(tickStart);
+
+    m_stats.lastTickTime = time;
+    m_stats.averageTickTime = first ? time : m_stats.averageTickTime + (time - m_stats.averageTickTime) * TICK_STATS_SMOOTHING;
+    m_stats.maxTickTime = openvoxm::max(m_stats.maxTickTime, time);
+    if (time > context.dt) m_stats.lateTicks++;
+
+    // Shed load as soon as a tick runs long, but only recover after a stretch of light ticks
+    if (time > m_overload * context.dt) {
+        m_ticksUnder = 0;
+        if (m_level + 1 < m_policy.size()) {
+            m_level++;
+            m_stats.degradationChanges++;
+        }
+    } else if (time < m_recover * context.dt) {
+        if (++m_ticksUnder >= m_recoverTicks && m_level > 0) {
+            m_level--;
+            m_stats.degradationChanges++;
+            m_ticksUnder = 0;
+        }
+    } else {
+        m_ticksUnder = 0;
+    }
+    m_stats.degradationLevel = m_level;
+
+    m_tickCount++;
+    m_stats.ticks++;
+    onTick(m_stats);
+}
+
+void openvox::TickDriver::run(OPT const Window* window /*= nullptr*/) {
+    m_running = true;
+    Clock::time_point next = Clock::now();
+    Clock::time_point rateStart = next;
+    u64 rateTicks = 0;
+    while (m_running && !(window && window->shouldQuit())) {
+        Clock::duration interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(1.0 / m_tickRate));
+        std::this_thread::sleep_until(next);
+        tick();
+        next += interval;
+        rateTicks++;
+
+        // Too far behind to catch up, give up on the backlog
+        Clock::time_point now = Clock::now();
+        if (now - next > interval * TICK_MAX_CATCH_UP) {
+            u64 behind = (u64)((now - next) / interval);
+            m_stats.droppedTicks += behind;
+            next += interval * (Clock::rep)behind;
+        }
+
+        f32 elapsed = std::chrono::duration<f32>(now - rateStart).count();
+        if (elapsed >= 1.0f) {
+            m_stats.ticksPerSecond = rateTicks / elapsed;
+            rateStart = now;
+            rateTicks = 0;
+        }
+    }
+    m_running = false;
+}
+
+void openvox::TickDriver::resetStats() {
+    m_stats.ticks = 0;
+    m_stats.lateTicks = 0;
+    m_stats.droppedTicks = 0;
+    m_stats.lastTickTime = 0.0f;
+    m_stats.averageTickTime = 0.0f;
+    m_stats.maxTickTime = 0.0f;
+    m_stats.ticksPerSecond = 0.0f;
+    m_stats.degradationLevel = m_level;
+    m_stats.degradationChanges = 0;
+    for (TickSubsystemStats& s : m_subsystemStats) {
+        s.lastTime = 0.0f;
+        s.averageTime = 0.0f;
+        s.maxTime = 0.0f;
+        s.overBudgetTicks = 0;
+    }
+}
+
+void openvox::TickDriver::exportStats(OUT std::string& out) const {
+    appendMetric(out, "openvox_ticks_total", "", (f64)m_stats.ticks);
+    appendMetric(out, "openvox_ticks_late_total", "", (f64)m_stats.lateTicks);
+    appendMetric(out, "openvox_ticks_dropped_total", "", (f64)m_stats.droppedTicks);
+    appendMetric(out, "openvox_tick_rate", "", m_stats.ticksPerSecond);
+    appendMetric(out, "openvox_tick_target_rate", "", m_tickRate);
+    appendMetric(out, "openvox_tick_seconds", "{stat=\"last\"}", m_stats.lastTickTime);
+    appendMetric(out, "openvox_tick_seconds", "{stat=\"average\"}", m_stats.averageTickTime);
+    appendMetric(out, "openvox_tick_seconds", "{stat=\"max\"}", m_stats.maxTickTime);
+    appendMetric(out, "openvox_tick_degradation_level", "", m_stats.degradationLevel);
+    appendMetric(out, "openvox_tick_degradation_changes_total", "", m_stats.degradationChanges);
+
+    char labels[160];
+    for (const TickSubsystemStats& s : m_subsystemStats) {
+        snprintf(labels, sizeof(labels), "{subsystem=\"%s\",stat=\"last\"}", s.name.c_str());
+        appendMetric(out, "openvox_subsystem_seconds", labels, s.lastTime);
+        snprintf(labels, sizeof(labels), "{subsystem=\"%s\",stat=\"average\"}", s.name.c_str());
+        appendMetric(out, "openvox_subsystem_seconds", labels, s.averageTime);
+        snprintf(labels, sizeof(labels), "{subsystem=\"%s\",stat=\"max\"}", s.name.c_str());
+        appendMetric(out, "openvox_subsystem_seconds", labels, s.maxTime);
+        snprintf(labels, sizeof(labels), "{subsystem=\"%s\"}", s.name.c_str());
+        appendMetric(out, "openvox_subsystem_budget_seconds", labels, s.budget);
+        appendMetric(out, "openvox_subsystem_over_budget_total", labels, (f64)s.overBudgetTicks);
+    }
+}
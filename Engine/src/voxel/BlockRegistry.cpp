@@ -0,0 +1,135 @@
+#include "voxel/BlockRegistry.h"
+
+#include "OpenVoxAssert.hpp"
+#include "io/Serialization.hpp"
+
+#define BLOCK_REGISTRY_MAGIC 0x5242584F ///< "OXBR"
+#define BLOCK_REGISTRY_VERSION 1
+
+openvox::BlockRegistry::BlockRegistry() : m_frozen(false) {
+    BlockDefinition air;
+    air.name = "air";
+    air.flags = getBlockFlagBit(BlockFlag::REPLACEABLE);
+    air.renderLayer = BlockRenderLayer::NONE;
+    registerBlock(air);
+}
+
+openvox::BlockID openvox::BlockRegistry::registerBlock(const BlockDefinition& definition) {
+    openvox_assert(!isFrozen(), "Blocks must be registered before the registry is frozen");
+    auto it = m_ids.find(definition.name);
+    if (it != m_ids.end()) return it->second;
+    openvox_assert(m_definitions.size() < BLOCK_NONE, "Too many block types");
+
+    BlockID id = (BlockID)m_definitions.size();
+    m_definitions.push_back(definition);
+    m_ids[definition.name] = id;
+    return id;
+}
+
+void openvox::BlockRegistry::freeze() {
+    if (isFrozen()) return;
+    size_t count = m_definitions.size();
+    for (int f = 0; f < BLOCK_FLAG_COUNT; f++) m_flags[f].assign((count + 63) / 64, 0);
+    m_lightEmission.resize(count);
+    m_renderLayers.resize(count);
+    m_textures.resize(count * VOXEL_FACE_COUNT);
+    for (size_t id = 0; id < count; id++) {
+        const BlockDefinition& d = m_definitions[id];
+        for (int f = 0; f < BLOCK_FLAG_COUNT; f++) {
+            if (d.flags & (1 << f)) m_flags[f][id >> 6] |= 1ull << (id & 63);
+        }
+        m_lightEmission[id] = d.lightEmission;
+        m_renderLayers[id] = d.renderLayer;
+        std::copy(d.textures, d.textures + VOXEL_FACE_COUNT, &m_textures[id * VOXEL_FACE_COUNT]);
+    }
+    // Release so threads that see the flag also see the tables
+    m_frozen.store(true, std::memory_order_release);
+}
+
+openvox::BlockID openvox::BlockRegistry::getID(const std::string& name) const {
+    auto it = m_ids.find(name);
+    return it != m_ids.end() ? it->second : (BlockID)BLOCK_NONE;
+}
+
+void openvox::BlockRegistry::save(OUT std::vector<u8>& out) const {
+    openvox_assert(isFrozen(), "Only a frozen registry can be saved");
+    size_t start = out.size();
+    {
+        BinaryWriter w(out);
+        w.write((u32)BLOCK_REGISTRY_MAGIC);
+        w.write((u32)BLOCK_REGISTRY_VERSION);
+        w.writeVarint(m_definitions.size());
+        for (const BlockDefinition& d : m_definitions) w.writeBlob(d.name.data(), d.name.size());
+        // The tables as baked, so loading is a copy
+        for (int f = 0; f < BLOCK_FLAG_COUNT; f++) w.writeArray(m_flags[f].data(), m_flags[f].size());
+        w.writeArray(m_lightEmission.data(), m_lightEmission.size());
+        w.writeArray(m_renderLayers.data(), m_renderLayers.size());
+        w.writeArray(m_textures.data(), m_textures.size());
+    }
+    u32 crc = crc32(&out[start], out.size() - start);
+    BinaryWriter(out).write(crc);
+}
+
+bool openvox::BlockRegistry::load(const u8* data, size_t size) {
+    openvox_assert(!isFrozen(), "A frozen registry cannot be replaced");
+    if (size < 4 || crc32(data, size - 4) != SerialTraits<u32>::load(data + size - 4)) return false;
+    BinaryReader r(data, size - 4);
+    u32 magic = 0, version = 0;
+    size_t count = 0;
+    r.read(magic);
+    r.read(version);
+    if (!r.readVarint(count) || magic != BLOCK_REGISTRY_MAGIC || version != BLOCK_REGISTRY_VERSION ||
+        count == 0 || count > BLOCK_NONE) {
+        return false;
+    }
+
+    std::vector<BlockDefinition> definitions(count);
+    std::unordered_map<std::string, BlockID> ids;
+    for (size_t id = 0; id < count; id++) {
+        const u8* name;
+        size_t length;
+        if (!r.readBlob(name, length)) return false;
+        definitions[id].name.assign((const char*)name, length);
+        ids[definitions[id].name] = (BlockID)id;
+    }
+    BinaryArrayView<u64> flags[BLOCK_FLAG_COUNT];
+    BinaryArrayView<u8> lightEmission;
+    BinaryArrayView<BlockRenderLayer> renderLayers;
+    BinaryArrayView<u16> textures;
+    for (int f = 0; f < BLOCK_FLAG_COUNT; f++) r.readArray((count + 63) / 64, flags[f]);
+    r.readArray(count, lightEmission);
+    r.readArray(count, renderLayers);
+    r.readArray(count * VOXEL_FACE_COUNT, textures);
+    if (r.hasFailed() || !r.isEnd() || ids.size() != count || definitions[BLOCK_AIR].name != "air") return false;
+    // The checksum only proves the blob is intact, not that a writer put sane values in it
+    for (size_t id = 0; id < count; id++) {
+        if (lightEmission[id] > 15 || (u8)renderLayers[id] > (u8)BlockRenderLayer::TRANSLUCENT) return false;
+    }
+
+    m_definitions.swap(definitions);
+    m_ids.swap(ids);
+    for (int f = 0; f < BLOCK_FLAG_COUNT; f++) {
+        m_flags[f].resize(flags[f].size());
+        flags[f].copyTo(m_flags[f].data());
+    }
+    m_lightEmission.resize(count);
+    lightEmission.copyTo(m_lightEmission.data());
+    m_renderLayers.resize(count);
+    renderLayers.copyTo(m_renderLayers.data());
+    m_textures.resize(count * VOXEL_FACE_COUNT);
+    textures.copyTo(m_textures.data());
+
+    // Definitions come back from the tables for getDefinition()
+    for (size_t id = 0; id < count; id++) {
+        BlockDefinition& d = m_definitions[id];
+        d.flags = 0;
+        for (int f = 0; f < BLOCK_FLAG_COUNT; f++) {
+            if ((m_flags[f][id >> 6] >> (id & 63)) & 1) d.flags |= 1 << f;
+        }
+        d.lightEmission = m_lightEmission[id];
+        d.renderLayer = m_renderLayers[id];
+        std::copy(&m_textures[id * VOXEL_FACE_COUNT], &m_textures[id * VOXEL_FACE_COUNT] + VOXEL_FACE_COUNT, d.textures);
+    }
+    m_frozen.store(true, std::memory_order_release);
+    return true;
+}
@@ -0,0 +1,34 @@
+#include "voxel/Chunk.h"
+
+#include <algorithm>
+#include <cstring>
+
+openvox::Chunk::Chunk(const i32v3& chunkPos) :
+    m_chunkPosition(chunkPos),
+    m_data(new ChunkData) {
+    std::fill(m_neighbors, m_neighbors + CHUNK_NEIGHBOR_COUNT, nullptr);
+    m_neighbors[CHUNK_NEIGHBOR_CENTER] = this;
+    fill(BLOCK_AIR);
+}
+
+openvox::Chunk::~Chunk() {
+    m_data->release();
+}
+
+void openvox::Chunk::fill(BlockID id) {
+    // Everything is overwritten, so shared voxels are not worth copying
+    if (m_data->isShared()) {
+        m_data->release();
+        m_data = new ChunkData;
+    }
+    std::fill(m_data->blocks, m_data->blocks + CHUNK_SIZE, id);
+    m_data->occupancy.fill(id != BLOCK_AIR);
+}
+
+void openvox::Chunk::unshare() {
+    ChunkData* data = new ChunkData;
+    std::memcpy(data->blocks, m_data->blocks, sizeof(data->blocks));
+    data->occupancy = m_data->occupancy;
+    m_data->release();
+    m_data = data;
+}
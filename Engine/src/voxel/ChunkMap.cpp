@@ -0,0 +1,63 @@
+#include "voxel/ChunkMap.h"
+
+openvox::ChunkMap::~ChunkMap() {
+    dispose();
+}
+
+openvox::Chunk* openvox::ChunkMap::getChunk(const i32v3& chunkPos) const {
+    auto it = m_chunks.find(chunkPos);
+    if (it == m_chunks.end()) return nullptr;
+    return it->second;
+}
+
+openvox::Chunk* openvox::ChunkMap::createChunk(const i32v3& chunkPos) {
+    auto it = m_chunks.find(chunkPos);
+    if (it != m_chunks.end()) return it->second;
+
+    Chunk* chunk = new Chunk(chunkPos);
+    m_chunks[chunkPos] = chunk;
+    // Link both ways, so chunks near the border need no lookups later
+    for (int i = 0; i < CHUNK_NEIGHBOR_COUNT; i++) {
+        if (i == CHUNK_NEIGHBOR_CENTER) continue;
+        i32v3 offset(i % 3 - 1, i / 9 - 1, i / 3 % 3 - 1);
+        Chunk* neighbor = getChunk(chunkPos + offset);
+        if (!neighbor) continue;
+        chunk->m_neighbors[i] = neighbor;
+        neighbor->m_neighbors[CHUNK_NEIGHBOR_COUNT - 1 - i] = chunk;
+    }
+    return chunk;
+}
+
+bool openvox::ChunkMap::destroyChunk(const i32v3& chunkPos) {
+    auto it = m_chunks.find(chunkPos);
+    if (it == m_chunks.end()) return false;
+
+    Chunk* chunk = it->second;
+    for (int i = 0; i < CHUNK_NEIGHBOR_COUNT; i++) {
+        Chunk* neighbor = chunk->m_neighbors[i];
+        if (neighbor && neighbor != chunk) neighbor->m_neighbors[CHUNK_NEIGHBOR_COUNT - 1 - i] = nullptr;
+    }
+    delete chunk;
+    m_chunks.erase(it);
+    return true;
+}
+
+void openvox::ChunkMap::dispose() {
+    for (auto& it : m_chunks) {
+        delete it.second;
+    }
+    ChunkTable().swap(m_chunks);
+}
+
+openvox::BlockID openvox::ChunkMap::getBlock(const i32v3& voxelPos, BlockID unloaded /*= BLOCK_AIR*/) const {
+    Chunk* chunk = getChunk(toChunkPosition(voxelPos));
+    if (!chunk) return unloaded;
+    return chunk->getBlock(toLocalPosition(voxelPos));
+}
+
+bool openvox::ChunkMap::setBlock(const i32v3& voxelPos, BlockID id) {
+    Chunk* chunk = getChunk(toChunkPosition(voxelPos));
+    if (!chunk) return false;
+    chunk->setBlock(toLocalPosition(voxelPos), id);
+    return true;
+}
@@ -0,0 +1,131 @@
+#include "voxel/ChunkOccupancy.h"
+
+#include <algorithm>
+
+namespace {
+    const int ROW_WORDS = OCCUPANCY_ROW_WORDS;
+    const int LAST_ROW = OCCUPANCY_WORD_COUNT - OCCUPANCY_ROW_WORDS; ///< First word of the last Z row
+    const u64 EMPTY_WORDS[OCCUPANCY_WORD_COUNT] = {}; ///< Stands in for missing neighbors
+}
+
+void openvox::ChunkOccupancy::build(const BlockID* blocks) {
+    for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) {
+        // The two columns of a word are neighbors in a layer
+        const BlockID* column = blocks + w * 2;
+        u64 word = 0;
+        for (int y = 0; y < CHUNK_WIDTH; y++) {
+            word |= (u64)(column[0] != BLOCK_AIR) << y | (u64)(column[1] != BLOCK_AIR) << (y + 32);
+            column += CHUNK_LAYER;
+        }
+        m_words[w] = word;
+    }
+}
+
+void openvox::ChunkOccupancy::update(const BlockID* blocks, const i32v3& min, const i32v3& max) {
+    u64 yMask = math::bitRange(min.y, max.y);
+    for (int z = min.z; z <= max.z; z++) {
+        for (int x = min.x; x <= max.x; x++) {
+            u64 column = 0;
+            const BlockID* b = blocks + getVoxelIndex(x, min.y, z);
+            for (int y = min.y; y <= max.y; y++) {
+                column |= (u64)(*b != BLOCK_AIR) << y;
+                b += CHUNK_LAYER;
+            }
+            int shift = (x & 1) * 32;
+            u64& word = m_words[getWordIndex(x, z)];
+            word = (word & ~(yMask << shift)) | column << shift;
+        }
+    }
+}
+
+void openvox::ChunkOccupancy::fill(bool solid) {
+    std::fill(m_words, m_words + OCCUPANCY_WORD_COUNT, solid ? ~0ull : 0ull);
+}
+
+u64 openvox::ChunkOccupancy::getNeighborWord(int word, VoxelFace face, OPT const ChunkOccupancy* neighbor) const {
+    const u64* n = neighbor ? neighbor->m_words : EMPTY_WORDS;
+    u64 w = m_words[word];
+    switch (face) {
+        case VoxelFace::NEG_X: {
+            // Column X - 1 of the even lane is the odd lane of the previous word
+            u64 prev = (word & (ROW_WORDS - 1)) ? m_words[word - 1] : n[word + ROW_WORDS - 1];
+            return w << 32 | prev >> 32;
+        }
+        case VoxelFace::POS_X: {
+            u64 next = (word & (ROW_WORDS - 1)) != ROW_WORDS - 1 ? m_words[word + 1] : n[word - ROW_WORDS + 1];
+            return w >> 32 | next << 32;
+        }
+        case VoxelFace::NEG_Y:
+            return ((w << 1) & ~OCCUPANCY_LANE_BOTTOM) | ((n[word] >> 31) & OCCUPANCY_LANE_BOTTOM);
+        case VoxelFace::POS_Y:
+            return ((w >> 1) & ~OCCUPANCY_LANE_TOP) | ((n[word] << 31) & OCCUPANCY_LANE_TOP);
+        case VoxelFace::NEG_Z:
+            return word >= ROW_WORDS ? m_words[word - ROW_WORDS] : n[word + LAST_ROW];
+        case VoxelFace::POS_Z:
+            return word < LAST_ROW ? m_words[word + ROW_WORDS] : n[word - LAST_ROW];
+    }
+    return 0;
+}
+
+u32 openvox::ChunkOccupancy::getVisibleFaces(VoxelFace face, OPT const ChunkOccupancy* neighbor, OUT u64* faces) const {
+    const u64* m = m_words;
+    const u64* n = neighbor ? neighbor->m_words : EMPTY_WORDS;
+    // One loop per face so each compiles to straight shifts and masks
+    switch (face) {
+        case VoxelFace::NEG_X:
+            for (int row = 0; row < OCCUPANCY_WORD_COUNT; row += ROW_WORDS) {
+                u64 prev = n[row + ROW_WORDS - 1];
+                for (int w = row; w < row + ROW_WORDS; w++) {
+                    faces[w] = m[w] & ~(m[w] << 32 | prev >> 32);
+                    prev = m[w];
+                }
+            }
+            break;
+        case VoxelFace::POS_X:
+            for (int row = 0; row < OCCUPANCY_WORD_COUNT; row += ROW_WORDS) {
+                for (int w = row; w < row + ROW_WORDS - 1; w++) faces[w] = m[w] & ~(m[w] >> 32 | m[w + 1] << 32);
+                int w = row + ROW_WORDS - 1;
+                faces[w] = m[w] & ~(m[w] >> 32 | n[row] << 32);
+            }
+            break;
+        case VoxelFace::NEG_Y:
+            for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) {
+                faces[w] = m[w] & ~(((m[w] << 1) & ~OCCUPANCY_LANE_BOTTOM) | ((n[w] >> 31) & OCCUPANCY_LANE_BOTTOM));
+            }
+            break;
+        case VoxelFace::POS_Y:
+            for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) {
+                faces[w] = m[w] & ~(((m[w] >> 1) & ~OCCUPANCY_LANE_TOP) | ((n[w] << 31) & OCCUPANCY_LANE_TOP));
+            }
+            break;
+        case VoxelFace::NEG_Z:
+            for (int w = 0; w < ROW_WORDS; w++) faces[w] = m[w] & ~n[w + LAST_ROW];
+            for (int w = ROW_WORDS; w < OCCUPANCY_WORD_COUNT; w++) faces[w] = m[w] & ~m[w - ROW_WORDS];
+            break;
+        case VoxelFace::POS_Z:
+            for (int w = 0; w < LAST_ROW; w++) faces[w] = m[w] & ~m[w + ROW_WORDS];
+            for (int w = LAST_ROW; w < OCCUPANCY_WORD_COUNT; w++) faces[w] = m[w] & ~n[w - LAST_ROW];
+            break;
+    }
+    u32 count = 0;
+    for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) count += math::popCount(faces[w]);
+    return count;
+}
+
+u32 openvox::ChunkOccupancy::getCount() const {
+    u32 count = 0;
+    for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) count += math::popCount(m_words[w]);
+    return count;
+}
+
+bool openvox::ChunkOccupancy::isEmpty() const {
+    u64 any = 0;
+    for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) any |= m_words[w];
+    return !any;
+}
+
+bool openvox::ChunkOccupancy::isFull() const {
+    u64 all = ~0ull;
+    for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) all &= m_words[w];
+    return !~all;
+}
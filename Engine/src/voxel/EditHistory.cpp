@@ -0,0 +1,272 @@
+#include "voxel/EditHistory.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "OpenVoxAssert.hpp"
+#include "io/FileSystem.h"
+#include "io/Serialization.hpp"
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    /// One run of consecutive voxels that changed from the same block to the same block
+    struct Run {
+        u32 start;
+        u32 length;
+        u32 pair;
+    };
+
+    /// Finds the first voxel at or after i that differs, comparing four at a time
+    inline u32 skipEqual(const openvox::BlockID* a, const openvox::BlockID* b, u32 i) {
+        while (i + 4 <= CHUNK_SIZE) {
+            u64 va, vb;
+            std::memcpy(&va, a + i, sizeof(va));
+            std::memcpy(&vb, b + i, sizeof(vb));
+            if (va != vb) break;
+            i += 4;
+        }
+        while (i < CHUNK_SIZE && a[i] == b[i]) i++;
+        return i;
+    }
+}
+
+openvox::EditHistory::EditHistory(ChunkMap* chunkMap, size_t memoryLimit /*= DEFAULT_HISTORY_MEMORY_LIMIT*/,
+                                  const std::string& spillDirectory /*= ""*/) :
+    m_chunkMap(chunkMap),
+    m_memoryLimit(memoryLimit) {
+    if (spillDirectory.size() && makeDirectory(spillDirectory)) m_spillPath = spillDirectory + "/history.ovh";
+}
+
+openvox::EditHistory::~EditHistory() {
+    for (auto& it : m_recorded) it.second->release();
+    m_recorded.clear();
+    clear();
+    if (m_spillFile) {
+        fclose(m_spillFile);
+        remove(m_spillPath.c_str());
+    }
+}
+
+void openvox::EditHistory::beginOperation() {
+    m_depth++;
+}
+
+void openvox::EditHistory::endOperation() {
+    openvox_assert(m_depth, "endOperation() without beginOperation()");
+    if (--m_depth) return;
+
+    Operation op;
+    op.spillOffset = 0;
+    op.spillSize = 0;
+    op.voxelCount = encode(op.data);
+    for (auto& it : m_recorded) it.second->release();
+    m_recorded.clear();
+    if (!op.voxelCount) return;
+
+    for (Operation& r : m_redo) discard(r);
+    m_redo.clear();
+    op.data.shrink_to_fit();
+    m_memoryUsage += op.data.size();
+    m_undo.push_back(std::move(op));
+    enforceLimit();
+}
+
+void openvox::EditHistory::recordChunk(const Chunk& chunk) {
+    if (!m_depth) return;
+    const ChunkData*& data = m_recorded[chunk.getChunkPosition()];
+    if (!data) data = chunk.getData()->acquire();
+}
+
+size_t openvox::EditHistory::undo(OUT std::vector<EditHistoryChange>& changes) {
+    changes.clear();
+    if (m_depth || m_undo.empty()) return 0;
+    Operation op = std::move(m_undo.back());
+    m_undo.pop_back();
+    if (op.spillSize && !load(op)) {
+        discard(op);
+        return 0;
+    }
+    size_t count = apply(op, true, changes);
+    m_redo.push_back(std::move(op));
+    return count;
+}
+
+size_t openvox::EditHistory::redo(OUT std::vector<EditHistoryChange>& changes) {
+    changes.clear();
+    if (m_depth || m_redo.empty()) return 0;
+    Operation op = std::move(m_redo.back());
+    m_redo.pop_back();
+    size_t count = apply(op, false, changes);
+    m_undo.push_back(std::move(op));
+    enforceLimit();
+    return count;
+}
+
+void openvox::EditHistory::clear() {
+    for (Operation& op : m_undo) discard(op);
+    for (Operation& op : m_redo) discard(op);
+    m_undo.clear();
+    m_redo.clear();
+}
+
+void openvox::EditHistory::setMemoryLimit(size_t memoryLimit) {
+    m_memoryLimit = memoryLimit;
+    enforceLimit();
+}
+
+size_t openvox::EditHistory::encode(OUT std::vector<u8>& data) {
+    size_t total = 0;
+    size_t chunkCount = 0;
+    std::vector<Run> runs;
+    std::vector<u8> chunkData;
+    for (auto& it : m_recorded) {
+        const Chunk* chunk = m_chunkMap->getChunk(it.first);
+        // Unloaded during the operation, its changes are lost with it
+        if (!chunk || chunk->getData() == it.second) continue;
+        const BlockID* a = it.second->blocks;
+        const BlockID* b = chunk->getBlockData();
+
+        runs.clear();
+        m_pairs.clear();
+        m_pairIndex.clear();
+        i32v3 min(CHUNK_WIDTH);
+        i32v3 max(-1);
+        u32 i = skipEqual(a, b, 0);
+        while (i < CHUNK_SIZE) {
+            BlockID oldId = a[i];
+            BlockID newId = b[i];
+            u32 key = (u32)oldId << 16 | newId;
+            auto pit = m_pairIndex.find(key);
+            if (pit == m_pairIndex.end()) {
+                pit = m_pairIndex.insert(std::make_pair(key, (u32)(m_pairs.size() / 2))).first;
+                m_pairs.push_back(oldId);
+                m_pairs.push_back(newId);
+            }
+            Run run;
+            run.start = i;
+            run.pair = pit->second;
+            while (i < CHUNK_SIZE && a[i] == oldId && b[i] == newId) i++;
+            run.length = i - run.start;
+            runs.push_back(run);
+            min = openvoxm::min(min, getVoxelPosition(run.start));
+            max = openvoxm::max(max, getVoxelPosition(i - 1));
+            // A run crossing rows or layers covers their whole width
+            if ((run.start >> CHUNK_WIDTH_BITS) != ((i - 1) >> CHUNK_WIDTH_BITS)) {
+                min.x = 0;
+                max.x = CHUNK_WIDTH - 1;
+            }
+            if ((run.start >> (CHUNK_WIDTH_BITS * 2)) != ((i - 1) >> (CHUNK_WIDTH_BITS * 2))) {
+                min.z = 0;
+                max.z = CHUNK_WIDTH - 1;
+            }
+            total += run.length;
+            i = skipEqual(a, b, i);
+        }
+        if (runs.empty()) continue;
+
+        BinaryWriter w(chunkData);
+        w.writeZigZag(it.first.x);
+        w.writeZigZag(it.first.y);
+        w.writeZigZag(it.first.z);
+        w.write(u8v3(min));
+        w.write(u8v3(max));
+        w.writeVarint(m_pairs.size() / 2);
+        w.writeArray(m_pairs.data(), m_pairs.size());
+        w.writeVarint(runs.size());
+        u32 end = 0;
+        for (const Run& run : runs) {
+            w.writeVarint(run.start - end);
+            w.writeVarint(run.length - 1);
+            w.writeVarint(run.pair);
+            end = run.start + run.length;
+        }
+        chunkCount++;
+    }
+
+    data.clear();
+    BinaryWriter w(data);
+    w.writeVarint(chunkCount);
+    w.writeBytes(chunkData.data(), chunkData.size());
+    return total;
+}
+
+size_t openvox::EditHistory::apply(Operation& op, bool undo, OUT std::vector<EditHistoryChange>& changes) {
+    BinaryReader r(op.data.data(), op.data.size());
+    u32 chunkCount = 0;
+    r.readVarint(chunkCount);
+    size_t total = 0;
+    for (u32 c = 0; c < chunkCount; c++) {
+        EditHistoryChange change;
+        u8v3 min, max;
+        u32 pairCount = 0, runCount = 0;
+        BinaryArrayView<u16> pairs;
+        r.readZigZag(change.chunkPos.x);
+        r.readZigZag(change.chunkPos.y);
+        r.readZigZag(change.chunkPos.z);
+        r.read(min);
+        r.read(max);
+        if (!r.readVarint(pairCount) || !r.readArray(pairCount * 2, pairs) || !r.readVarint(runCount)) break;
+
+        // Chunks that are not loaded are still read past
+        Chunk* chunk = m_chunkMap->getChunk(change.chunkPos);
+        BlockID* blocks = chunk ? chunk->getMutableBlockData() : nullptr;
+        u32 end = 0;
+        size_t count = 0;
+        for (u32 i = 0; i < runCount; i++) {
+            u32 gap = 0, length = 0, pair = 0;
+            if (!r.readVarint(gap) || !r.readVarint(length) || !r.readVarint(pair)) break;
+            if (gap >= CHUNK_SIZE - end || length >= CHUNK_SIZE - end - gap || pair >= pairCount) break;
+            u32 start = end + gap;
+            end = start + length + 1;
+            if (blocks) std::fill(blocks + start, blocks + end, pairs[pair * 2 + (undo ? 0 : 1)]);
+            count += length + 1;
+        }
+        if (!blocks) continue;
+        change.min = i32v3(min);
+        change.max = i32v3(max);
+        chunk->updateOccupancy(change.min, change.max);
+        change.voxelCount = count;
+        changes.push_back(change);
+        total += count;
+    }
+    return total;
+}
+
+bool openvox::EditHistory::load(Operation& op) {
+    op.data.resize(op.spillSize);
+    bool ok = seekFile(m_spillFile, op.spillOffset) && fread(op.data.data(), 1, op.spillSize, m_spillFile) == op.spillSize;
+    // Spilled operations are loaded newest first, so the file shrinks like a stack
+    m_spillEnd = op.spillOffset;
+    m_spilledCount--;
+    op.spillSize = 0;
+    m_memoryUsage += op.data.size();
+    return ok;
+}
+
+void openvox::EditHistory::enforceLimit() {
+    while (m_memoryUsage > m_memoryLimit && m_spilledCount < m_undo.size()) {
+        Operation& op = m_undo[m_spilledCount];
+        if (m_spillPath.size() && !m_spillFile) m_spillFile = fopen(m_spillPath.c_str(), "w+b");
+        if (m_spillFile && seekFile(m_spillFile, m_spillEnd) && fwrite(op.data.data(), 1, op.data.size(), m_spillFile) == op.data.size()) {
+            op.spillOffset = m_spillEnd;
+            op.spillSize = (u32)op.data.size();
+            m_spillEnd += op.spillSize;
+            m_memoryUsage -= op.data.size();
+            std::vector<u8>().swap(op.data);
+            m_spilledCount++;
+        } else {
+            discard(m_undo.front());
+            m_undo.pop_front();
+        }
+    }
+}
+
+void openvox::EditHistory::discard(Operation& op) {
+    if (op.spillSize) {
+        op.spillSize = 0;
+        if (--m_spilledCount == 0) m_spillEnd = 0;
+    } else {
+        m_memoryUsage -= op.data.size();
+    }
+    std::vector<u8>().swap(op.data);
+}
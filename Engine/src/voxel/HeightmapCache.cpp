@@ -0,0 +1,264 @@
+#include "voxel/HeightmapCache.h"
+
+#include <cstring>
+
+#include "OpenVoxAssert.hpp"
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    inline void writeU16(std::vector<u8>& out, u16 v) {
+        out.push_back((u8)v);
+        out.push_back((u8)(v >> 8));
+    }
+    inline void writeU32(std::vector<u8>& out, u32 v) {
+        out.push_back((u8)v);
+        out.push_back((u8)(v >> 8));
+        out.push_back((u8)(v >> 16));
+        out.push_back((u8)(v >> 24));
+    }
+    inline u16 readU16(const u8* p) {
+        return (u16)(p[0] | (p[1] << 8));
+    }
+    inline u32 readU32(const u8* p) {
+        return (u32)p[0] | ((u32)p[1] << 8) | ((u32)p[2] << 16) | ((u32)p[3] << 24);
+    }
+
+    inline i32v2 toColumnPosition(i32 voxelX, i32 voxelZ) {
+        return i32v2(voxelX >> CHUNK_WIDTH_BITS, voxelZ >> CHUNK_WIDTH_BITS);
+    }
+    inline int getLayerIndex(i32 voxelX, i32 voxelZ) {
+        return ((voxelZ & CHUNK_MASK) << CHUNK_WIDTH_BITS) | (voxelX & CHUNK_MASK);
+    }
+}
+
+openvox::HeightmapCache::HeightmapCache(ChunkMap* chunkMap, i32 minY /*= -32768*/) :
+    m_chunkMap(chunkMap),
+    m_minY(minY),
+    m_blockKinds(1 << 16, HEIGHTMAP_MASK_ALL) {
+    m_blockKinds[BLOCK_AIR] = 0;
+}
+
+openvox::HeightmapCache::~HeightmapCache() {
+    for (auto& it : m_columns) delete it.second;
+}
+
+void openvox::HeightmapCache::setBlockKinds(BlockID id, u8 kindMask) {
+    m_blockKinds[id] = kindMask & HEIGHTMAP_MASK_ALL;
+}
+
+void openvox::HeightmapCache::addChunk(const i32v3& chunkPos, bool heightsKnown /*= false*/) {
+    i32v2 columnPos(chunkPos.x, chunkPos.z);
+    Column* column = getColumn(columnPos);
+    if (!column) {
+        column = new Column;
+        std::memset(column->heights, 0, sizeof(column->heights));
+        column->minChunkY = chunkPos.y;
+        column->maxChunkY = chunkPos.y;
+        column->chunkCount = 0;
+        m_columns[columnPos] = column;
+    }
+    column->minChunkY = openvoxm::min(column->minChunkY, chunkPos.y);
+    column->maxChunkY = openvoxm::max(column->maxChunkY, chunkPos.y);
+    column->chunkCount++;
+    if (heightsKnown) return;
+
+    const Chunk* chunk = m_chunkMap->getChunk(chunkPos);
+    if (!chunk) return;
+    const BlockID* blocks = chunk->getBlockData();
+    const i32 originY = chunkPos.y << CHUNK_WIDTH_BITS;
+
+    // Kinds whose height is already at or above the chunk top cannot change
+    u8 found[CHUNK_LAYER];
+    u16 top = pack(originY + CHUNK_WIDTH - 1);
+    int remaining = CHUNK_LAYER;
+    for (int i = 0; i < CHUNK_LAYER; i++) {
+        u8 f = 0;
+        for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+            if (column->heights[k][i] >= top) f |= (u8)(1 << k);
+        }
+        found[i] = f;
+        if (f == HEIGHTMAP_MASK_ALL) remaining--;
+    }
+
+    // Walk down whole layers, which are contiguous, until every column found every kind
+    for (i32 y = CHUNK_WIDTH - 1; y >= 0 && remaining; y--) {
+        const BlockID* layer = blocks + y * CHUNK_LAYER;
+        u16 packed = pack(originY + y);
+        for (int i = 0; i < CHUNK_LAYER; i++) {
+            u8 m = m_blockKinds[layer[i]] & ~found[i];
+            if (!m) continue;
+            for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+                if ((m & (1 << k)) && column->heights[k][i] < packed) column->heights[k][i] = packed;
+            }
+            found[i] |= m;
+            if (found[i] == HEIGHTMAP_MASK_ALL) remaining--;
+        }
+    }
+}
+
+void openvox::HeightmapCache::removeChunk(const i32v3& chunkPos) {
+    i32v2 columnPos(chunkPos.x, chunkPos.z);
+    auto it = m_columns.find(columnPos);
+    if (it == m_columns.end()) return;
+    Column* column = it->second;
+    if (column->chunkCount <= 1) {
+        delete column;
+        m_columns.erase(it);
+        return;
+    }
+    column->chunkCount--;
+
+    const i32 originY = chunkPos.y << CHUNK_WIDTH_BITS;
+    u16 bottom = pack(originY);
+    u16 top = pack(originY + CHUNK_WIDTH - 1);
+    for (int i = 0; i < CHUNK_LAYER; i++) {
+        u8 mask = 0;
+        for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+            u16 h = column->heights[k][i];
+            if (h >= bottom && h <= top) mask |= (u8)(1 << k);
+        }
+        if (mask) scanDown(*column, columnPos, i, originY - 1, mask);
+    }
+}
+
+void openvox::HeightmapCache::onBlockChanged(const i32v3& voxelPos, BlockID oldID, BlockID newID) {
+    i32v2 columnPos = toColumnPosition(voxelPos.x, voxelPos.z);
+    Column* column = getColumn(columnPos);
+    if (!column) return;
+    int i = getLayerIndex(voxelPos.x, voxelPos.z);
+    u16 packed = pack(voxelPos.y);
+    u8 oldKinds = m_blockKinds[oldID];
+    u8 newKinds = m_blockKinds[newID];
+    u8 rescan = 0;
+    for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+        u16& h = column->heights[k][i];
+        if (newKinds & (1 << k)) {
+            if (packed > h) h = packed;
+        } else if ((oldKinds & (1 << k)) && h == packed) {
+            rescan |= (u8)(1 << k);
+        }
+    }
+    if (rescan) scanDown(*column, columnPos, i, voxelPos.y - 1, rescan);
+}
+
+void openvox::HeightmapCache::updateRegion(const i32v3& min, const i32v3& max) {
+    if (min.x > max.x || min.y > max.y || min.z > max.z) return;
+    for (i32 cz = min.z >> CHUNK_WIDTH_BITS; cz <= max.z >> CHUNK_WIDTH_BITS; cz++) {
+        for (i32 cx = min.x >> CHUNK_WIDTH_BITS; cx <= max.x >> CHUNK_WIDTH_BITS; cx++) {
+            i32v2 columnPos(cx, cz);
+            Column* column = getColumn(columnPos);
+            if (!column) continue;
+            i32 x0 = openvoxm::max(min.x, cx << CHUNK_WIDTH_BITS);
+            i32 x1 = openvoxm::min(max.x, (cx << CHUNK_WIDTH_BITS) + CHUNK_WIDTH - 1);
+            i32 z0 = openvoxm::max(min.z, cz << CHUNK_WIDTH_BITS);
+            i32 z1 = openvoxm::min(max.z, (cz << CHUNK_WIDTH_BITS) + CHUNK_WIDTH - 1);
+            for (i32 z = z0; z <= z1; z++) {
+                for (i32 x = x0; x <= x1; x++) {
+                    // Heights above the box cannot have changed
+                    int i = getLayerIndex(x, z);
+                    u8 mask = 0;
+                    for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+                        if (unpackHeight(column->heights[k][i]) <= max.y) mask |= (u8)(1 << k);
+                    }
+                    if (mask) scanDown(*column, columnPos, i, max.y, mask);
+                }
+            }
+        }
+    }
+}
+
+i32 openvox::HeightmapCache::getHeight(HeightmapKind kind, const i32v2& voxelXZ) const {
+    const Column* column = getColumn(toColumnPosition(voxelXZ.x, voxelXZ.y));
+    if (!column) return HEIGHTMAP_NONE;
+    return unpackHeight(column->heights[(int)kind][getLayerIndex(voxelXZ.x, voxelXZ.y)]);
+}
+
+const u16* openvox::HeightmapCache::getColumnHeights(HeightmapKind kind, const i32v2& columnPos) const {
+    const Column* column = getColumn(columnPos);
+    return column ? column->heights[(int)kind] : nullptr;
+}
+
+void openvox::HeightmapCache::saveColumn(const i32v2& columnPos, OUT std::vector<u8>& out) const {
+    const Column* column = getColumn(columnPos);
+    writeU32(out, (u32)m_minY);
+    if (!column) {
+        out.push_back(0);
+        return;
+    }
+    out.reserve(out.size() + 1 + HEIGHTMAP_KIND_COUNT * CHUNK_LAYER * 2);
+    out.push_back(HEIGHTMAP_KIND_COUNT);
+    for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+        for (int i = 0; i < CHUNK_LAYER; i++) writeU16(out, column->heights[k][i]);
+    }
+}
+
+size_t openvox::HeightmapCache::loadColumn(const i32v2& columnPos, const u8* data, size_t size) {
+    if (size < 5) return 0;
+    i32 savedMinY = (i32)readU32(data);
+    u32 kindCount = data[4];
+    size_t bytes = 5 + (size_t)kindCount * CHUNK_LAYER * 2;
+    if (size < bytes) return 0;
+    if (kindCount == 0) return bytes;
+
+    // Heights saved with another minimum Y must still fit this cache's range
+    const u8* p = data + 5;
+    if (savedMinY != m_minY) {
+        for (size_t i = 0; i < (size_t)openvoxm::min(kindCount, (u32)HEIGHTMAP_KIND_COUNT) * CHUNK_LAYER; i++) {
+            u16 h = readU16(p + i * 2);
+            i64 y = (i64)savedMinY + h - 1;
+            if (h && (y < m_minY || y > (i64)m_minY + 0xFFFE)) return 0;
+        }
+    }
+
+    Column* column = getColumn(columnPos);
+    if (!column) {
+        column = new Column;
+        column->minChunkY = INT_MAX;
+        column->maxChunkY = INT_MIN;
+        column->chunkCount = 0;
+        m_columns[columnPos] = column;
+    }
+    std::memset(column->heights, 0, sizeof(column->heights));
+    // Kinds added since the data was saved stay empty, kinds that no longer exist are skipped
+    for (u32 k = 0; k < kindCount && k < HEIGHTMAP_KIND_COUNT; k++) {
+        for (int i = 0; i < CHUNK_LAYER; i++, p += 2) {
+            u16 h = readU16(p);
+            column->heights[k][i] = (h && savedMinY != m_minY) ? pack(savedMinY + h - 1) : h;
+        }
+    }
+    return bytes;
+}
+
+openvox::HeightmapCache::Column* openvox::HeightmapCache::getColumn(const i32v2& columnPos) const {
+    auto it = m_columns.find(columnPos);
+    return it != m_columns.end() ? it->second : nullptr;
+}
+
+u16 openvox::HeightmapCache::pack(i32 y) const {
+    openvox_assert(y >= m_minY && (i64)y - m_minY < 65535, "Height out of the range of the heightmap");
+    return (u16)(y - m_minY + 1);
+}
+
+void openvox::HeightmapCache::scanDown(Column& column, const i32v2& columnPos, int layerIndex, i32 startY, u8 kindMask) {
+    for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+        if (kindMask & (1 << k)) column.heights[k][layerIndex] = 0;
+    }
+    i32 startChunkY = startY >> CHUNK_WIDTH_BITS;
+    i32 cy = openvoxm::min(startChunkY, column.maxChunkY);
+    for (; cy >= column.minChunkY; cy--) {
+        const Chunk* chunk = m_chunkMap->getChunk(i32v3(columnPos.x, cy, columnPos.y));
+        if (!chunk) continue;
+        const BlockID* blocks = chunk->getBlockData() + layerIndex;
+        i32 y = cy == startChunkY ? (startY & CHUNK_MASK) : CHUNK_WIDTH - 1;
+        for (; y >= 0; y--) {
+            u8 m = m_blockKinds[blocks[y * CHUNK_LAYER]] & kindMask;
+            if (!m) continue;
+            u16 packed = pack((cy << CHUNK_WIDTH_BITS) + y);
+            for (int k = 0; k < HEIGHTMAP_KIND_COUNT; k++) {
+                if (m & (1 << k)) column.heights[k][layerIndex] = packed;
+            }
+            kindMask &= ~m;
+            if (!kindMask) return;
+        }
+    }
+}
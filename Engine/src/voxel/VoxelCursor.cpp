@@ -0,0 +1,38 @@
+#include "voxel/VoxelCursor.h"
+
+openvox::VoxelCursor::VoxelCursor(const ChunkMap* chunkMap, const i32v3& voxelPos) :
+    m_chunkMap(chunkMap),
+    m_position(voxelPos),
+    m_chunkPos(toChunkPosition(voxelPos)),
+    m_chunk(chunkMap->getChunk(m_chunkPos)) {
+    setPosition(voxelPos);
+}
+
+void openvox::VoxelCursor::setPosition(const i32v3& voxelPos) {
+    i32v3 chunkPos = toChunkPosition(voxelPos);
+    if (chunkPos != m_chunkPos) {
+        m_chunk = findChunk(chunkPos);
+        m_chunkPos = chunkPos;
+    }
+    m_position = voxelPos;
+    i32v3 l = toLocalPosition(voxelPos);
+    m_index = getVoxelIndex(l);
+    // Unsigned compare checks both ends of [1, CHUNK_WIDTH - 2]
+    m_interior = m_chunk && (u32)(l.x - 1) < CHUNK_WIDTH - 2 && (u32)(l.y - 1) < CHUNK_WIDTH - 2 &&
+                 (u32)(l.z - 1) < CHUNK_WIDTH - 2;
+}
+
+openvox::BlockID openvox::VoxelCursor::getBlock(const i32v3& offset, BlockID unloaded /*= BLOCK_AIR*/) const {
+    i32v3 l = toLocalPosition(m_position) + offset;
+    if (((l.x | l.y | l.z) & ~CHUNK_MASK) == 0) return m_chunk ? m_chunk->getBlock(l) : unloaded;
+    Chunk* chunk = findChunk(m_chunkPos + i32v3(l.x >> CHUNK_WIDTH_BITS, l.y >> CHUNK_WIDTH_BITS, l.z >> CHUNK_WIDTH_BITS));
+    return chunk ? chunk->getBlock(l.x & CHUNK_MASK, l.y & CHUNK_MASK, l.z & CHUNK_MASK) : unloaded;
+}
+
+openvox::Chunk* openvox::VoxelCursor::findChunk(const i32v3& chunkPos) const {
+    i32v3 d = chunkPos - m_chunkPos;
+    if (m_chunk && (u32)(d.x + 1) <= 2 && (u32)(d.y + 1) <= 2 && (u32)(d.z + 1) <= 2) {
+        return m_chunk->getNeighbor(getNeighborIndex(d));
+    }
+    return m_chunkMap->getChunk(chunkPos);
+}
@@ -0,0 +1,294 @@
+#include "voxel/VoxelEditor.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "math/OpenVoxMath.hpp"
+
+namespace {
+    inline bool canWrite(openvox::BlockID current, openvox::EditMode mode) {
+        switch (mode) {
+            case openvox::EditMode::FILL_AIR:
+                return current == BLOCK_AIR;
+            case openvox::EditMode::REPLACE_SOLID:
+                return current != BLOCK_AIR;
+            default:
+                return true;
+        }
+    }
+
+    /// Writes one block over a row. Kept branch-free per voxel so the loops vectorize.
+    size_t writeSpan(openvox::BlockID* row, int count, openvox::BlockID id, openvox::EditMode mode) {
+        size_t changed = 0;
+        switch (mode) {
+            case openvox::EditMode::REPLACE:
+                for (int i = 0; i < count; i++) {
+                    changed += row[i] != id;
+                    row[i] = id;
+                }
+                break;
+            case openvox::EditMode::FILL_AIR:
+                for (int i = 0; i < count; i++) {
+                    openvox::BlockID v = row[i];
+                    openvox::BlockID n = v == BLOCK_AIR ? id : v;
+                    changed += n != v;
+                    row[i] = n;
+                }
+                break;
+            case openvox::EditMode::REPLACE_SOLID:
+                for (int i = 0; i < count; i++) {
+                    openvox::BlockID v = row[i];
+                    openvox::BlockID n = v != BLOCK_AIR ? id : v;
+                    changed += n != v;
+                    row[i] = n;
+                }
+                break;
+        }
+        return changed;
+    }
+
+    inline bool isEmptyBox(const i32v3& min, const i32v3& max) {
+        return min.x > max.x || min.y > max.y || min.z > max.z;
+    }
+}
+
+openvox::VoxelEditor::VoxelEditor(ChunkMap* chunkMap) :
+    onCommit(this),
+    m_chunkMap(chunkMap) {
+    // Empty
+}
+
+openvox::VoxelEditor::~VoxelEditor() {
+    commit();
+}
+
+template<typename SpanFunc, typename WriteFunc>
+size_t openvox::VoxelEditor::editRows(const i32v3& min, const i32v3& max, SpanFunc span, WriteFunc write) {
+    if (isEmptyBox(min, max)) return 0;
+    i32v3 c0 = toChunkPosition(min);
+    i32v3 c1 = toChunkPosition(max);
+    size_t total = 0;
+    if (m_history) m_history->beginOperation();
+    for (i32 cy = c0.y; cy <= c1.y; cy++) {
+        for (i32 cz = c0.z; cz <= c1.z; cz++) {
+            for (i32 cx = c0.x; cx <= c1.x; cx++) {
+                i32v3 chunkPos(cx, cy, cz);
+                Chunk* chunk = m_chunkMap->getChunk(chunkPos);
+                if (!chunk) continue;
+                i32v3 origin = toVoxelPosition(chunkPos);
+                i32v3 lo = openvoxm::max(min - origin, i32v3(0));
+                i32v3 hi = openvoxm::min(max - origin, i32v3(CHUNK_WIDTH - 1));
+                // Rows are tried on a copy until one changes, so untouched chunks are not
+                // recorded or cloned away from a snapshot that shares them
+                const BlockID* data = chunk->getBlockData();
+                BlockID* blocks = nullptr;
+                BlockID scratch[CHUNK_WIDTH];
+
+                size_t changed = 0;
+                i32v3 dirtyMin(CHUNK_WIDTH);
+                i32v3 dirtyMax(-1);
+                for (i32 y = lo.y; y <= hi.y; y++) {
+                    for (i32 z = lo.z; z <= hi.z; z++) {
+                        i32 x0 = min.x, x1 = max.x;
+                        if (!span(origin.y + y, origin.z + z, x0, x1)) continue;
+                        x0 = openvoxm::max(x0 - origin.x, lo.x);
+                        x1 = openvoxm::min(x1 - origin.x, hi.x);
+                        if (x0 > x1) continue;
+                        if (!blocks) {
+                            std::memcpy(scratch, data + getVoxelIndex(x0, y, z), (x1 - x0 + 1) * sizeof(BlockID));
+                            if (write(scratch, origin.x + x0, origin.y + y, origin.z + z, x1 - x0 + 1) == 0) continue;
+                            if (m_history) m_history->recordChunk(*chunk);
+                            blocks = chunk->getMutableBlockData();
+                        }
+                        size_t n = write(blocks + getVoxelIndex(x0, y, z), origin.x + x0, origin.y + y, origin.z + z, x1 - x0 + 1);
+                        if (n == 0) continue;
+                        changed += n;
+                        dirtyMin = openvoxm::min(dirtyMin, i32v3(x0, y, z));
+                        dirtyMax = openvoxm::max(dirtyMax, i32v3(x1, y, z));
+                    }
+                }
+                if (changed) {
+                    chunk->updateOccupancy(dirtyMin, dirtyMax);
+                    markChanged(chunkPos, dirtyMin, dirtyMax);
+                    total += changed;
+                }
+            }
+        }
+    }
+    if (m_history) m_history->endOperation();
+    m_pendingVoxels += total;
+    return total;
+}
+
+void openvox::VoxelEditor::markChanged(const i32v3& chunkPos, const i32v3& localMin, const i32v3& localMax) {
+    auto it = m_dirty.find(chunkPos);
+    if (it == m_dirty.end()) {
+        DirtyBounds b = { localMin, localMax };
+        m_dirty[chunkPos] = b;
+    } else {
+        it->second.min = openvoxm::min(it->second.min, localMin);
+        it->second.max = openvoxm::max(it->second.max, localMax);
+    }
+}
+
+size_t openvox::VoxelEditor::fillBox(const i32v3& min, const i32v3& max, BlockID id, EditMode mode /*= EditMode::REPLACE*/) {
+    return editRows(min, max,
+                    [](i32, i32, i32&, i32&) { return true; },
+                    [id, mode](BlockID* row, i32, i32, i32, i32 count) { return writeSpan(row, count, id, mode); });
+}
+
+size_t openvox::VoxelEditor::fillSphere(const i32v3& center, f32 radius, BlockID id, EditMode mode /*= EditMode::REPLACE*/) {
+    if (radius < 0.0f) return 0;
+    i32 r = (i32)radius;
+    f32 r2 = radius * radius;
+    return editRows(center - i32v3(r), center + i32v3(r),
+                    [center, r2](i32 y, i32 z, i32& x0, i32& x1) {
+                        f32 dy = (f32)(y - center.y);
+                        f32 dz = (f32)(z - center.z);
+                        f32 rem = r2 - dy * dy - dz * dz;
+                        if (rem < 0.0f) return false;
+                        i32 dx = (i32)openvoxm::sqrt(rem);
+                        x0 = center.x - dx;
+                        x1 = center.x + dx;
+                        return true;
+                    },
+                    [id, mode](BlockID* row, i32, i32, i32, i32 count) { return writeSpan(row, count, id, mode); });
+}
+
+size_t openvox::VoxelEditor::fillCylinder(const i32v3& baseCenter, f32 radius, i32 height, BlockID id,
+                                          EditMode mode /*= EditMode::REPLACE*/) {
+    if (radius < 0.0f || height <= 0) return 0;
+    i32 r = (i32)radius;
+    f32 r2 = radius * radius;
+    return editRows(baseCenter - i32v3(r, 0, r), baseCenter + i32v3(r, height - 1, r),
+                    [baseCenter, r2](i32, i32 z, i32& x0, i32& x1) {
+                        f32 dz = (f32)(z - baseCenter.z);
+                        f32 rem = r2 - dz * dz;
+                        if (rem < 0.0f) return false;
+                        i32 dx = (i32)openvoxm::sqrt(rem);
+                        x0 = baseCenter.x - dx;
+                        x1 = baseCenter.x + dx;
+                        return true;
+                    },
+                    [id, mode](BlockID* row, i32, i32, i32, i32 count) { return writeSpan(row, count, id, mode); });
+}
+
+size_t openvox::VoxelEditor::copyRegion(const i32v3& srcMin, const i32v3& srcMax, const i32v3& dstMin, bool skipAir /*= false*/) {
+    if (isEmptyBox(srcMin, srcMax)) return 0;
+    // Reading everything first makes overlapping copies safe
+    readRegion(srcMin, srcMax, m_copyBuffer);
+    i32v3 size = srcMax - srcMin + i32v3(1);
+    const BlockID* src = m_copyBuffer.data();
+    return editRows(dstMin, dstMin + size - i32v3(1),
+                    [](i32, i32, i32&, i32&) { return true; },
+                    [src, size, dstMin, skipAir](BlockID* row, i32 x, i32 y, i32 z, i32 count) {
+                        const BlockID* s = src + ((size_t)(y - dstMin.y) * size.z + (z - dstMin.z)) * size.x + (x - dstMin.x);
+                        size_t changed = 0;
+                        for (i32 i = 0; i < count; i++) {
+                            BlockID v = row[i];
+                            BlockID n = (skipAir && s[i] == BLOCK_AIR) ? v : s[i];
+                            changed += n != v;
+                            row[i] = n;
+                        }
+                        return changed;
+                    });
+}
+
+size_t openvox::VoxelEditor::applyMask(const i32v3& min, const i32v3& size, const u8* mask, BlockID id,
+                                       EditMode mode /*= EditMode::REPLACE*/) {
+    return editRows(min, min + size - i32v3(1),
+                    [](i32, i32, i32&, i32&) { return true; },
+                    [mask, min, size, id, mode](BlockID* row, i32 x, i32 y, i32 z, i32 count) {
+                        const u8* m = mask + ((size_t)(y - min.y) * size.z + (z - min.z)) * size.x + (x - min.x);
+                        size_t changed = 0;
+                        for (i32 i = 0; i < count; i++) {
+                            BlockID v = row[i];
+                            BlockID n = (m[i] && canWrite(v, mode)) ? id : v;
+                            changed += n != v;
+                            row[i] = n;
+                        }
+                        return changed;
+                    });
+}
+
+void openvox::VoxelEditor::readRegion(const i32v3& min, const i32v3& max, OUT std::vector<BlockID>& blocks,
+                                      BlockID unloaded /*= BLOCK_AIR*/) const {
+    blocks.clear();
+    if (isEmptyBox(min, max)) return;
+    i32v3 size = max - min + i32v3(1);
+    blocks.assign((size_t)size.x * size.y * size.z, unloaded);
+
+    i32v3 c0 = toChunkPosition(min);
+    i32v3 c1 = toChunkPosition(max);
+    for (i32 cy = c0.y; cy <= c1.y; cy++) {
+        for (i32 cz = c0.z; cz <= c1.z; cz++) {
+            for (i32 cx = c0.x; cx <= c1.x; cx++) {
+                const Chunk* chunk = m_chunkMap->getChunk(i32v3(cx, cy, cz));
+                if (!chunk) continue;
+                i32v3 origin = toVoxelPosition(i32v3(cx, cy, cz));
+                i32v3 lo = openvoxm::max(min - origin, i32v3(0));
+                i32v3 hi = openvoxm::min(max - origin, i32v3(CHUNK_WIDTH - 1));
+                const BlockID* data = chunk->getBlockData();
+                for (i32 y = lo.y; y <= hi.y; y++) {
+                    for (i32 z = lo.z; z <= hi.z; z++) {
+                        size_t dst = ((size_t)(origin.y + y - min.y) * size.z + (origin.z + z - min.z)) * size.x + (origin.x + lo.x - min.x);
+                        std::memcpy(&blocks[dst], data + getVoxelIndex(lo.x, y, z), (hi.x - lo.x + 1) * sizeof(BlockID));
+                    }
+                }
+            }
+        }
+    }
+}
+
+size_t openvox::VoxelEditor::undo() {
+    if (!m_history) return 0;
+    return markChanges(m_history->undo(m_historyChanges));
+}
+
+size_t openvox::VoxelEditor::redo() {
+    if (!m_history) return 0;
+    return markChanges(m_history->redo(m_historyChanges));
+}
+
+size_t openvox::VoxelEditor::markChanges(size_t count) {
+    for (const EditHistoryChange& c : m_historyChanges) markChanged(c.chunkPos, c.min, c.max);
+    m_pendingVoxels += count;
+    return count;
+}
+
+void openvox::VoxelEditor::commit() {
+    if (m_pendingVoxels == 0) return;
+
+    VoxelEditBatch batch;
+    batch.voxelCount = m_pendingVoxels;
+    batch.min = i32v3(INT_MAX);
+    batch.max = i32v3(INT_MIN);
+    batch.chunks.reserve(m_dirty.size());
+    for (auto& it : m_dirty) {
+        const i32v3& pos = it.first;
+        const DirtyBounds& b = it.second;
+        i32v3 origin = toVoxelPosition(pos);
+        batch.chunks.push_back(pos);
+        batch.min = openvoxm::min(batch.min, origin + b.min);
+        batch.max = openvoxm::max(batch.max, origin + b.max);
+
+        // Neighbors across faces the change touches may need their meshes or light updated
+        for (int axis = 0; axis < 3; axis++) {
+            for (int side = 0; side < 2; side++) {
+                i32 edge = side ? b.max.data[axis] : b.min.data[axis];
+                if (edge != (side ? CHUNK_WIDTH - 1 : 0)) continue;
+                i32v3 n = pos;
+                n.data[axis] += side ? 1 : -1;
+                if (m_dirty.count(n) || !m_chunkMap->getChunk(n)) continue;
+                if (std::find(batch.borderChunks.begin(), batch.borderChunks.end(), n) == batch.borderChunks.end()) {
+                    batch.borderChunks.push_back(n);
+                }
+            }
+        }
+    }
+    m_dirty.clear();
+    m_pendingVoxels = 0;
+
+    onCommit(batch);
+}
@@ -0,0 +1,19 @@
+#include "voxel/WorldSnapshot.h"
+
+#include "voxel/ChunkMap.h"
+
+void openvox::WorldSnapshot::capture(const ChunkMap& chunks) {
+    clear();
+    m_entries.resize(chunks.getChunkCount());
+    size_t i = 0;
+    for (auto& it : chunks.getChunks()) {
+        m_entries[i].chunkPos = it.first;
+        m_entries[i].data = it.second->getData()->acquire();
+        i++;
+    }
+}
+
+void openvox::WorldSnapshot::clear() {
+    for (size_t i = 0; i < m_entries.size(); i++) release(i);
+    m_entries.clear();
+}
@@ -0,0 +1,75 @@
+//
+// BenchHarness.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file BenchHarness.h
+* @brief Timing helpers shared by the benchmark executables.
+*
+* Benchmarks print one line per measurement. Build them with optimizations
+* (CMAKE_BUILD_TYPE=Release); debug builds also enable openvox_assert.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace openvox {
+    namespace bench {
+        /*! @brief Wall clock stopwatch.
+        */
+        class Timer {
+        public:
+            Timer() {
+                reset();
+            }
+            void reset() {
+                m_start = std::chrono::steady_clock::now();
+            }
+            double getSeconds() const {
+                return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+            }
+            double getMilliseconds() const {
+                return getSeconds() * 1000.0;
+            }
+            double getMicroseconds() const {
+                return getSeconds() * 1000000.0;
+            }
+
+        private:
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        /*! @brief Runs f once to warm up, then repeats it and returns the best time per call.
+        *
+        * The minimum is reported because it is the least disturbed by other processes.
+        *
+        * @param repeats: Number of timed calls.
+        * @return Milliseconds of the fastest call.
+        */
+        template<typename F>
+        double bestOf(int repeats, F f) {
+            f();
+            double best = 1e300;
+            for (int i = 0; i < repeats; i++) {
+                Timer t;
+                f();
+                double ms = t.getMilliseconds();
+                if (ms < best) best = ms;
+            }
+            return best;
+        }
+
+        /*! @brief Keeps a computed value alive so the optimizer cannot drop the work behind it.
+        */
+        template<typename T>
+        void keep(const T& value) {
+            static volatile unsigned char sink;
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(&value);
+            for (unsigned i = 0; i < sizeof(T); i++) sink = sink ^ p[i];
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/BlockRegistry.h"
+
+using namespace openvox;
+
+namespace {
+    const int BLOCKS = 300;
+    const int REPEATS = 20;
+
+    /// Stand-in for block classes with virtual properties, which the tree does not have
+    class Block {
+    public:
+        virtual ~Block() {}
+        virtual bool isOpaque() const = 0;
+        virtual BlockRenderLayer getRenderLayer() const = 0;
+        virtual u16 getTexture(VoxelFace face) const = 0;
+    };
+    class AirBlock : public Block {
+    public:
+        bool isOpaque() const override { return false; }
+        BlockRenderLayer getRenderLayer() const override { return BlockRenderLayer::NONE; }
+        u16 getTexture(VoxelFace) const override { return 0; }
+    };
+    /// Same texture on the sides, others on top and bottom
+    class CubeBlock : public Block {
+    public:
+        CubeBlock(u16 side, u16 top, u16 bottom) : m_side(side), m_top(top), m_bottom(bottom) {}
+        bool isOpaque() const override { return true; }
+        BlockRenderLayer getRenderLayer() const override { return BlockRenderLayer::OPAQUE; }
+        u16 getTexture(VoxelFace face) const override {
+            return face == VoxelFace::POS_Y ? m_top : face == VoxelFace::NEG_Y ? m_bottom : m_side;
+        }
+
+    private:
+        u16 m_side, m_top, m_bottom;
+    };
+    class SeeThroughBlock : public Block {
+    public:
+        SeeThroughBlock(u16 texture, BlockRenderLayer layer) : m_texture(texture), m_layer(layer) {}
+        bool isOpaque() const override { return false; }
+        BlockRenderLayer getRenderLayer() const override { return m_layer; }
+        u16 getTexture(VoxelFace) const override { return m_texture; }
+
+    private:
+        u16 m_texture;
+        BlockRenderLayer m_layer;
+    };
+
+    /// Builds the same block types as objects and as registered definitions
+    void buildBlocks(test::Random& random, OUT std::vector<std::unique_ptr<Block> >& objects, OUT BlockRegistry& registry) {
+        objects.emplace_back(new AirBlock);
+        for (int i = 1; i < BLOCKS; i++) {
+            BlockDefinition d;
+            d.name = "block_" + std::to_string(i);
+            u16 side = (u16)random.range(0, 4095), top = (u16)random.range(0, 4095), bottom = (u16)random.range(0, 4095);
+            // One in five is glass or foliage
+            if (random.range(0, 4) == 0) {
+                BlockRenderLayer layer = random.range(0, 1) ? BlockRenderLayer::CUTOUT : BlockRenderLayer::TRANSLUCENT;
+                objects.emplace_back(new SeeThroughBlock(side, layer));
+                d.flags = getBlockFlagBit(BlockFlag::SOLID);
+                d.renderLayer = layer;
+                top = bottom = side;
+            } else {
+                objects.emplace_back(new CubeBlock(side, top, bottom));
+            }
+            for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+                d.textures[f] = f == (int)VoxelFace::POS_Y ? top : f == (int)VoxelFace::NEG_Y ? bottom : side;
+            }
+            registry.registerBlock(d);
+        }
+        registry.freeze();
+    }
+
+    /*! @brief Stand-in for the face culling of a block mesher: for every drawn voxel, tests the
+    * six neighbors for opacity and fetches the texture of each visible face.
+    *
+    * @return Sum of the fetched textures, so both versions can be compared.
+    */
+    template<typename IsOpaque, typename GetLayer, typename GetTexture>
+    u64 cullFaces(const std::vector<BlockID>& blocks, IsOpaque isOpaque, GetLayer getLayer, GetTexture getTexture) {
+        static const i32 OFFSETS[VOXEL_FACE_COUNT][3] = { { -1, 0, 0 }, { 1, 0, 0 }, { 0, -1, 0 }, { 0, 1, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+        u64 sum = 0;
+        for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+            for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                    BlockID id = blocks[getVoxelIndex(x, y, z)];
+                    if (getLayer(id) == BlockRenderLayer::NONE) continue;
+                    for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+                        i32v3 n(x + OFFSETS[f][0], y + OFFSETS[f][1], z + OFFSETS[f][2]);
+                        bool inside = (u32)n.x < CHUNK_WIDTH && (u32)n.y < CHUNK_WIDTH && (u32)n.z < CHUNK_WIDTH;
+                        if (inside && isOpaque(blocks[getVoxelIndex(n)])) continue;
+                        sum += getTexture(id, (VoxelFace)f) + 1;
+                    }
+                }
+            }
+        }
+        return sum;
+    }
+}
+
+// A chunk of the rolling test terrain whose solid voxels are random types out of 300, on one
+// core. The face culling stand-in runs once with virtual block objects and once with the
+// baked registry tables. Then the registry is saved and loaded from its blob.
+int main() {
+    test::Random random(75);
+    std::vector<std::unique_ptr<Block> > objects;
+    BlockRegistry registry;
+    buildBlocks(random, objects, registry);
+
+    std::vector<BlockID> blocks(CHUNK_SIZE);
+    u32 solid = 0;
+    for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+        for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+            i32 height = test::getTerrainHeight(x, z);
+            for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+                bool isSolid = y <= height;
+                blocks[getVoxelIndex(x, y, z)] = isSolid ? (BlockID)random.range(1, BLOCKS - 1) : (BlockID)BLOCK_AIR;
+                solid += isSolid;
+            }
+        }
+    }
+
+    u64 virtualSum = 0, bakedSum = 0;
+    double virtualMs = bench::bestOf(REPEATS, [&] {
+        virtualSum = cullFaces(blocks, [&](BlockID id) { return objects[id]->isOpaque(); },
+                               [&](BlockID id) { return objects[id]->getRenderLayer(); },
+                               [&](BlockID id, VoxelFace face) { return objects[id]->getTexture(face); });
+        bench::keep(virtualSum);
+    });
+    double bakedMs = bench::bestOf(REPEATS, [&] {
+        bakedSum = cullFaces(blocks, [&](BlockID id) { return registry.isOpaque(id); },
+                             [&](BlockID id) { return registry.getRenderLayer(id); },
+                             [&](BlockID id, VoxelFace face) { return registry.getTexture(id, face); });
+        bench::keep(bakedSum);
+    });
+    std::printf("face culling, %u solid voxels  %.3f ms virtual objects  %.3f ms baked tables  %.2fx\n", solid, virtualMs, bakedMs,
+                virtualMs / bakedMs);
+
+    std::vector<u8> blob;
+    registry.save(blob);
+    bool loaded = true;
+    double loadMs = bench::bestOf(REPEATS, [&] {
+        BlockRegistry target;
+        loaded &= target.load(blob.data(), blob.size());
+    });
+    std::printf("load a %d block blob of %zu bytes  %.1f us\n", BLOCKS, blob.size(), loadMs * 1e3);
+
+    if (virtualSum != bakedSum || !loaded) {
+        std::printf("MISMATCH: texture sums %llu vs %llu, loaded %d\n", (unsigned long long)virtualSum, (unsigned long long)bakedSum, loaded);
+        return 1;
+    }
+    return 0;
+}
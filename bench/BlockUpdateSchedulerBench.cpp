@@ -0,0 +1,46 @@
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "sim/BlockUpdateScheduler.h"
+
+using namespace openvox;
+
+// Schedules N updates (default 10M) at random voxels of a 72x25x72 chunk area, about
+// 130k chunks, with delays up to 2^16 ticks, then ticks until all have fired.
+int main(int argc, char** argv) {
+    const size_t count = argc > 1 ? (size_t)std::atoll(argv[1]) : 10000000;
+    const i32 extent = 72 * CHUNK_WIDTH / 2;
+    const i32 height = 25 * CHUNK_WIDTH / 2;
+
+    BlockUpdateScheduler scheduler;
+    scheduler.reserve(count);
+    test::Random random(55);
+    std::vector<i32v3> positions(count);
+    std::vector<u32> delays(count);
+    for (size_t i = 0; i < count; i++) {
+        positions[i] = i32v3(random.range(-extent, extent - 1), random.range(-height, height - 1), random.range(-extent, extent - 1));
+        delays[i] = (u32)random.range(1, 65536);
+    }
+
+    bench::Timer timer;
+    for (size_t i = 0; i < count; i++) scheduler.schedule(positions[i], (BlockUpdateType)(i & 7), delays[i]);
+    double scheduleSeconds = timer.getSeconds();
+    std::printf("schedule  %zu updates in %.2f s: %.2f M/s\n", count, scheduleSeconds, count / scheduleSeconds / 1e6);
+
+    std::vector<BlockUpdate> fired;
+    fired.reserve(4096);
+    size_t total = 0;
+    timer.reset();
+    while (scheduler.getPendingCount()) {
+        fired.clear();
+        total += scheduler.tick(fired);
+    }
+    double fireSeconds = timer.getSeconds();
+    std::printf("fire      %zu updates over %llu ticks in %.2f s: %.2f M/s\n",
+                total, (unsigned long long)scheduler.getCurrentTick(), fireSeconds, total / fireSeconds / 1e6);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/Chunk.h"
+
+using namespace openvox;
+
+namespace {
+    const int REPEATS = 200;
+    const int SET_BLOCKS = 1 << 20;
+
+    const i32v3 FACE_OFFSETS[VOXEL_FACE_COUNT] = { i32v3(-1, 0, 0), i32v3(1, 0, 0), i32v3(0, -1, 0),
+                                                   i32v3(0, 1, 0),  i32v3(0, 0, -1), i32v3(0, 0, 1) };
+
+    const int FACE_INDEX_OFFSETS[VOXEL_FACE_COUNT] = { -1, 1, -CHUNK_LAYER, CHUNK_LAYER, -CHUNK_WIDTH, CHUNK_WIDTH };
+
+    /// Per-voxel lookup one step across a face, reading the neighbor chunk at the border
+    bool isSolidAcross(const Chunk& chunk, int x, int y, int z, int index, VoxelFace face) {
+        const i32v3& d = FACE_OFFSETS[(int)face];
+        i32v3 q(x + d.x, y + d.y, z + d.z);
+        if ((u32)q.x < CHUNK_WIDTH && (u32)q.y < CHUNK_WIDTH && (u32)q.z < CHUNK_WIDTH) {
+            return chunk.getBlock(index + FACE_INDEX_OFFSETS[(int)face]) != BLOCK_AIR;
+        }
+        const Chunk* owner = chunk.getNeighbor(d.x, d.y, d.z);
+        return owner && owner->getBlock(toLocalPosition(q)) != BLOCK_AIR;
+    }
+
+    const ChunkOccupancy* getNeighborOccupancy(const Chunk& chunk, VoxelFace face) {
+        const i32v3& d = FACE_OFFSETS[(int)face];
+        const Chunk* n = chunk.getNeighbor(d.x, d.y, d.z);
+        return n ? &n->getOccupancy() : nullptr;
+    }
+
+    void report(const char* name, double kernelMs, double voxelMs) {
+        std::printf("%-28s %8.2f us vs %8.2f us per voxel  %5.1fx\n", name, kernelMs * 1e3, voxelMs * 1e3, voxelMs / kernelMs);
+    }
+}
+
+// The chunk at the origin of 3x3x3 chunks of the rolling test terrain with its surface inside
+// it, on one core. Each kernel is timed against the same result computed from BlockID
+// lookups, and the results are compared.
+int main() {
+    ChunkMap map;
+    test::buildTerrain(map, i32v3(-1), i32v3(1), 1, 4, 8.0f);
+    Chunk& chunk = *map.getChunk(i32v3(0));
+    const ChunkOccupancy& occupancy = chunk.getOccupancy();
+    std::printf("%u solid voxels\n", occupancy.getCount());
+
+    u64 faces[OCCUPANCY_WORD_COUNT];
+    u32 kernelFaces = 0, voxelFaces = 0;
+    double kernelMs = bench::bestOf(REPEATS, [&] {
+        kernelFaces = 0;
+        for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+            kernelFaces += occupancy.getVisibleFaces((VoxelFace)f, getNeighborOccupancy(chunk, (VoxelFace)f), faces);
+        }
+        bench::keep(faces[0]);
+    });
+    u64 voxelMasks[VOXEL_FACE_COUNT][OCCUPANCY_WORD_COUNT];
+    double voxelMs = bench::bestOf(REPEATS, [&] {
+        voxelFaces = 0;
+        for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+            for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) voxelMasks[f][w] = 0;
+        }
+        // One pass over the voxels, six lookups for each solid one
+        for (int y = 0; y < CHUNK_WIDTH; y++) {
+            for (int z = 0; z < CHUNK_WIDTH; z++) {
+                for (int x = 0; x < CHUNK_WIDTH; x++) {
+                    int i = getVoxelIndex(x, y, z);
+                    if (chunk.getBlock(i) == BLOCK_AIR) continue;
+                    for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+                        if (isSolidAcross(chunk, x, y, z, i, (VoxelFace)f)) continue;
+                        voxelMasks[f][ChunkOccupancy::getWordIndex(i)] |= 1ull << ChunkOccupancy::getBit(i);
+                        voxelFaces++;
+                    }
+                }
+            }
+        }
+        bench::keep(voxelMasks[0][0]);
+    });
+    report("all 6 face masks with counts", kernelMs, voxelMs);
+
+    u32 kernelCount = 0, voxelCount = 0;
+    kernelMs = bench::bestOf(REPEATS, [&] { bench::keep(kernelCount = occupancy.getCount()); });
+    voxelMs = bench::bestOf(REPEATS, [&] {
+        voxelCount = 0;
+        for (int i = 0; i < CHUNK_SIZE; i++) voxelCount += chunk.getBlock(i) != BLOCK_AIR;
+        bench::keep(voxelCount);
+    });
+    report("solid count", kernelMs, voxelMs);
+
+    int kernelTop = 0, voxelTop = 0;
+    kernelMs = bench::bestOf(REPEATS, [&] {
+        kernelTop = 0;
+        for (int z = 0; z < CHUNK_WIDTH; z++) {
+            for (int x = 0; x < CHUNK_WIDTH; x++) kernelTop += occupancy.getHighest(x, z);
+        }
+        bench::keep(kernelTop);
+    });
+    voxelMs = bench::bestOf(REPEATS, [&] {
+        voxelTop = 0;
+        for (int z = 0; z < CHUNK_WIDTH; z++) {
+            for (int x = 0; x < CHUNK_WIDTH; x++) {
+                int y = CHUNK_WIDTH - 1;
+                while (y >= 0 && chunk.getBlock(x, y, z) == BLOCK_AIR) y--;
+                voxelTop += y;
+            }
+        }
+        bench::keep(voxelTop);
+    });
+    report("top solid of 1024 columns", kernelMs, voxelMs);
+
+    ChunkOccupancy rebuilt;
+    double buildMs = bench::bestOf(REPEATS, [&] {
+        rebuilt.build(chunk.getBlockData());
+        bench::keep(rebuilt.getWords()[0]);
+    });
+    std::printf("%-28s %8.2f us\n", "full rebuild from blocks", buildMs * 1e3);
+
+    // Random indices drawn up front so the timing is the write and the bit update
+    test::Random random(73);
+    std::vector<int> indices(SET_BLOCKS);
+    for (int& i : indices) i = random.range(0, CHUNK_SIZE - 1);
+    Chunk scratch(i32v3(0));
+    double setMs = bench::bestOf(3, [&] {
+        for (int i = 0; i < SET_BLOCKS; i++) scratch.setBlock(indices[i], (BlockID)(i & 1));
+    });
+    std::printf("%-28s %8.2f ns\n", "setBlock", setMs * 1e6 / SET_BLOCKS);
+
+    if (kernelFaces != voxelFaces || kernelCount != voxelCount || kernelTop != voxelTop) {
+        std::printf("MISMATCH: faces %u vs %u, count %u vs %u, tops %d vs %d\n", kernelFaces, voxelFaces, kernelCount, voxelCount,
+                    kernelTop, voxelTop);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "net/ChunkReplicator.h"
+
+using namespace openvox;
+
+// Edit storm over 4x2x4 = 32 chunks replicated to 8 clients for 200 ticks. Every tick makes
+// 300 random edits, a third of them rewriting voxels already changed that tick, and every
+// 20 ticks a VoxelEditor carves a sphere.
+int main() {
+    const u32 clients = 8;
+    const int ticks = 200;
+    const i32v3 worldMax(3, 1, 3);
+    ChunkMap server;
+    test::buildTerrain(server, i32v3(0), worldMax, 1, 30, 10.0f);
+    ChunkReplicator replicator(&server);
+    LoopbackTransport transport;
+    std::vector<std::unique_ptr<ChunkMap> > maps;
+    std::vector<std::unique_ptr<ChunkReceiver> > receivers;
+    for (ClientID c = 0; c < clients; c++) {
+        maps.emplace_back(new ChunkMap);
+        receivers.emplace_back(new ChunkReceiver(maps.back().get()));
+        replicator.addClient(c);
+        for (auto& it : server.getChunks()) replicator.subscribe(c, it.first);
+    }
+    auto send = [&transport](ClientID c, const u8* data, size_t size) { transport.send(c, data, size); };
+    std::vector<u8> message;
+    auto deliver = [&]() {
+        for (ClientID c = 0; c < clients; c++) {
+            while (transport.receive(c, message)) receivers[c]->receive(message.data(), message.size());
+        }
+    };
+
+    replicator.flush(send);
+    deliver();
+    u64 initialBytes = transport.getBytesSent();
+    std::printf("initial sync      %.1f KB per chunk (raw %.0f KB)\n", initialBytes / 1024.0 / (clients * server.getChunkCount()),
+                CHUNK_SIZE * sizeof(BlockID) / 1024.0);
+
+    VoxelEditor editor(&server);
+    auto* listener = editor.onCommit.addFunctor([&replicator](Sender, const VoxelEditBatch& b) { replicator.onEdit(b); });
+    test::Random random(61);
+    std::vector<i32v3> recent;
+    double encodeSeconds = 0.0, decodeSeconds = 0.0;
+    i32v3 extent = (worldMax + i32v3(1)) * CHUNK_WIDTH - i32v3(1);
+    for (int tick = 0; tick < ticks; tick++) {
+        recent.clear();
+        for (int i = 0; i < 300; i++) {
+            i32v3 p = (i % 3 == 2) ? recent[random.range(0, (i32)recent.size() - 1)]
+                                   : i32v3(random.range(0, extent.x), random.range(0, extent.y), random.range(0, extent.z));
+            recent.push_back(p);
+            if (server.setBlock(p, (BlockID)random.range(0, 6))) replicator.onBlockChanged(p);
+        }
+        if (tick % 20 == 10) {
+            editor.fillSphere(i32v3(random.range(0, extent.x), random.range(0, extent.y), random.range(0, extent.z)), 10.0f, BLOCK_AIR);
+            editor.commit();
+        }
+        bench::Timer timer;
+        replicator.flush(send);
+        encodeSeconds += timer.getSeconds();
+        timer.reset();
+        deliver();
+        decodeSeconds += timer.getSeconds();
+    }
+    editor.onCommit -= *listener;
+    delete listener;
+
+    // Every chunk changes every tick, so resending whole chunks costs the initial sync each tick
+    double perTick = (transport.getBytesSent() - initialBytes) / (double)ticks;
+    std::printf("storm             %.1f KB/tick total, %.1f KB/tick per client; resending whole chunks would be ~%.1f MB/tick\n",
+                perTick / 1024.0, perTick / 1024.0 / clients, initialBytes / (1024.0 * 1024.0));
+    std::printf("messages          %llu deltas, %llu full chunks\n", (unsigned long long)replicator.getDeltasSent(),
+                (unsigned long long)replicator.getFullChunksSent());
+    std::printf("encode / decode   %.0f us / %.0f us per tick for all clients\n", encodeSeconds * 1e6 / ticks, decodeSeconds * 1e6 / ticks);
+    return 0;
+}
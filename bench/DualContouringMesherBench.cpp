@@ -0,0 +1,129 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestMeshes.h"
+
+#include "mesh/DualContouringMesher.h"
+#include "mesh/TransvoxelMesher.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 CHUNKS(7, 4, 7); ///< 196 chunks
+    const int BOXES = 12;
+    const int REPEATS = 3;
+
+    struct Box {
+        f32v3 center;
+        f32v3 halfSize;
+        f32 yaw;
+        f32 pitch;
+    };
+    std::vector<Box> boxes;
+
+    /// Low hills with rotated boxes standing in them
+    f32 getSceneDistance(const f32v3& p) {
+        f32 d = test::getHillDistance(p);
+        for (const Box& b : boxes) d = openvoxm::min(d, test::getBoxDistance(p, b.center, b.halfSize, b.yaw, b.pitch));
+        return d;
+    }
+
+    struct Result {
+        f64 msPerChunk;
+        size_t triangles;
+        f64 squareSum;
+        size_t samples;
+        f32 maxError;
+    };
+
+    /// Adds the distance of the surface from the true one at triangle centroids and edge midpoints
+    void addError(const i32v3& chunkPos, const PackedMesh& mesh, Result& result) {
+        f32v3 offset(chunkPos * CHUNK_WIDTH);
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            f32v3 p[3];
+            for (int k = 0; k < 3; k++) p[k] = offset + f32v3(mesh.vertices[mesh.indices[i + k]].position) / (f32)PACKED_POSITION_SCALE;
+            f32v3 samples[4] = { (p[0] + p[1] + p[2]) / 3.0f, (p[0] + p[1]) * 0.5f, (p[1] + p[2]) * 0.5f, (p[2] + p[0]) * 0.5f };
+            for (const f32v3& s : samples) {
+                f32 d = getSceneDistance(s);
+                result.squareSum += d * d;
+                result.maxError = openvoxm::max(result.maxError, openvoxm::abs(d));
+                result.samples++;
+            }
+        }
+    }
+
+    /// Times meshing every chunk, then measures the surface error outside the timing
+    template<typename MeshFunc>
+    Result measure(const char* name, const MeshFunc& meshChunk) {
+        Result result = {};
+        result.msPerChunk = bench::bestOf(REPEATS, [&] {
+            result.triangles = 0;
+            for (i32 z = 0; z < CHUNKS.z; z++) {
+                for (i32 y = 0; y < CHUNKS.y; y++) {
+                    for (i32 x = 0; x < CHUNKS.x; x++) result.triangles += meshChunk(i32v3(x, y, z)).indices.size() / 3;
+                }
+            }
+        }) / (CHUNKS.x * CHUNKS.y * CHUNKS.z);
+        for (i32 z = 0; z < CHUNKS.z; z++) {
+            for (i32 y = 0; y < CHUNKS.y; y++) {
+                for (i32 x = 0; x < CHUNKS.x; x++) addError(i32v3(x, y, z), meshChunk(i32v3(x, y, z)), result);
+            }
+        }
+        size_t chunks = CHUNKS.x * CHUNKS.y * CHUNKS.z;
+        std::printf("%-20s %.2f ms/chunk  %3.0f Mcells/s  %4zu tris/chunk  error rms %.3f max %.3f voxels\n", name,
+                    result.msPerChunk, CHUNK_SIZE / (result.msPerChunk * 1e3), result.triangles / chunks,
+                    std::sqrt(result.squareSum / openvoxm::max(result.samples, (size_t)1)), result.maxError);
+        return result;
+    }
+}
+
+// 7x4x7 chunks at LOD 0 of hills with 12 rotated boxes, read from an i8 volume sampled
+// beforehand and meshed on one core by marching cubes and by dual contouring at three merge
+// limits. The error is the true distance at triangle centroids and edge midpoints.
+int main() {
+    test::Random random(71);
+    for (int i = 0; i < BOXES; i++) {
+        Box b;
+        b.center = f32v3(random.range(16.0f, CHUNKS.x * CHUNK_WIDTH - 16.0f), random.range(30.0f, 56.0f),
+                         random.range(16.0f, CHUNKS.z * CHUNK_WIDTH - 16.0f));
+        b.halfSize = f32v3(random.range(4.0f, 16.0f), random.range(4.0f, 16.0f), random.range(4.0f, 16.0f));
+        b.yaw = random.range(0.0f, 3.14f);
+        b.pitch = random.range(-0.5f, 0.5f);
+        boxes.push_back(b);
+    }
+
+    // Samples -1 to CHUNK_WIDTH + 2 of every chunk
+    i32v3 min(-1), size = CHUNKS * CHUNK_WIDTH + i32v3(4);
+    std::vector<i8> volume((size_t)size.x * size.y * size.z);
+    for (i32 y = 0; y < size.y; y++) {
+        for (i32 z = 0; z < size.z; z++) {
+            for (i32 x = 0; x < size.x; x++) {
+                volume[((size_t)y * size.z + z) * size.x + x] = test::getDistanceDensity(getSceneDistance(f32v3(min + i32v3(x, y, z))));
+            }
+        }
+    }
+    auto density = [&](const i32v3& p) {
+        i32v3 l = p - min;
+        return volume[((size_t)l.y * size.z + l.z) * size.x + l.x];
+    };
+
+    TransvoxelMesher transvoxel;
+    TransvoxelMesh transvoxelMesh;
+    measure("marching cubes", [&](const i32v3& c) -> const PackedMesh& {
+        transvoxel.mesh(c, 0, 0, density, transvoxelMesh);
+        return transvoxelMesh;
+    });
+    DualContouringMesher mesher;
+    PackedMesh mesh;
+    const f32 limits[3] = { 0.0f, DEFAULT_DUAL_CONTOURING_MAX_ERROR, 0.2f };
+    const char* names[3] = { "DC, no merging", "DC, default merging", "DC, maxError 0.2" };
+    for (int i = 0; i < 3; i++) {
+        measure(names[i], [&](const i32v3& c) -> const PackedMesh& {
+            mesher.mesh(c, 0, density, mesh, limits[i]);
+            return mesh;
+        });
+    }
+    return 0;
+}
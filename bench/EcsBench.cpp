@@ -0,0 +1,69 @@
+#include <cstdio>
+
+#include "BenchHarness.h"
+
+#include "ecs/EcsCommandBuffer.h"
+#include "ecs/EcsWorld.h"
+
+using namespace openvox;
+
+namespace {
+    OPENVOX_VECTOR_COMPONENT(Position, f32v3);
+    OPENVOX_VECTOR_COMPONENT(Velocity, f32v3);
+    struct Health {
+        i32 value = 100;
+    };
+}
+
+// 1M entities split over four archetypes, integrating Position += Velocity * dt.
+int main() {
+    const size_t COUNT = 1000000;
+    EcsWorld world;
+    bench::Timer timer;
+    for (size_t i = 0; i < COUNT; i++) {
+        Entity e = world.create(Position(f32v3((f32)i, 0.0f, 0.0f)), Velocity(f32v3(1.0f, 0.5f, 0.25f)));
+        if (i % 4 == 1) world.add(e, Health());
+        if (i % 4 == 2) world.create(Position(f32v3(0.0f)));
+    }
+    std::printf("create + add         %.1f ms for %zu entities, %zu archetypes\n",
+                timer.getMilliseconds(), world.getEntityCount(), world.getArchetypeCount());
+
+    const f32 dt = 1.0f / 60.0f;
+    double ms = bench::bestOf(20, [&] {
+        world.forEachChunk<Position, const Velocity>([dt](size_t n, const Entity*, Position* p, const Velocity* v) {
+            for (size_t i = 0; i < n; i++) p[i] += static_cast<const f32v3&>(v[i]) * dt;
+        });
+    });
+    std::printf("forEachChunk         %.2f ms per pass over %zu entities with 2 components\n", ms, COUNT);
+
+    ms = bench::bestOf(20, [&] {
+        world.each<Position, const Velocity>([dt](Entity, Position& p, const Velocity& v) { p += static_cast<const f32v3&>(v) * dt; });
+    });
+    std::printf("each                 %.2f ms\n", ms);
+
+    JobSystem jobs;
+    jobs.init();
+    ms = bench::bestOf(20, [&] {
+        world.forEachChunkParallel<Position, const Velocity>(jobs, [dt](size_t n, const Entity*, Position* p, const Velocity* v) {
+            for (size_t i = 0; i < n; i++) p[i] += static_cast<const f32v3&>(v[i]) * dt;
+        });
+    });
+    std::printf("forEachChunkParallel %.2f ms on %u threads\n", ms, jobs.getConcurrency());
+    jobs.dispose();
+
+    EcsCommandBuffer buffer;
+    timer.reset();
+    world.forEachChunk<const Velocity>([&](size_t n, const Entity* entities, const Velocity*) {
+        for (size_t i = 0; i < n; i += 10) buffer.add(entities[i], Health());
+    });
+    double recordMs = timer.getMilliseconds();
+    size_t commands = buffer.getCommandCount();
+    timer.reset();
+    buffer.playback(world);
+    std::printf("command buffer       %zu adds, record %.1f ms, playback %.1f ms\n", commands, recordMs, timer.getMilliseconds());
+
+    f32 sum = 0.0f;
+    world.each<const Position>([&](Entity, const Position& p) { sum += p.x; });
+    bench::keep(sum);
+    return 0;
+}
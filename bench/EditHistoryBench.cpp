@@ -0,0 +1,131 @@
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestFiles.h"
+#include "TestWorld.h"
+
+#include "voxel/EditHistory.h"
+#include "voxel/VoxelEditor.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 WORLD_CHUNKS(12, 6, 12);
+
+    /// Terrain with 10% of the voxels replaced by random blocks
+    void buildWorld(ChunkMap& map) {
+        test::buildTerrain(map, i32v3(0), WORLD_CHUNKS - 1, 1, 96, 24.0f);
+        test::Random random(69);
+        for (auto& it : map.getChunks()) {
+            BlockID* blocks = it.second->getMutableBlockData();
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                if (random.range(0, 9) == 0) blocks[i] = (BlockID)random.range(0, 4);
+            }
+            it.second->updateOccupancy();
+        }
+    }
+
+    std::vector<u8> makeMask(const i32v3& size, test::Random& random) {
+        std::vector<u8> mask((size_t)size.x * size.y * size.z);
+        for (u8& m : mask) m = random.range(0, 1) != 0;
+        return mask;
+    }
+
+    /// Runs one operation, then times undoing and redoing it
+    void measure(const char* name, EditHistory& history, VoxelEditor& editor, const std::function<size_t()>& op) {
+        u64 stored = history.getMemoryUsage() + history.getSpilledSize();
+        size_t count = op();
+        editor.commit();
+        stored = history.getMemoryUsage() + history.getSpilledSize() - stored;
+
+        std::vector<EditHistoryChange> changes;
+        bench::Timer t;
+        history.undo(changes);
+        f64 undoMs = t.getMilliseconds();
+        size_t chunks = changes.size();
+        t.reset();
+        history.redo(changes);
+        f64 redoMs = t.getMilliseconds();
+        std::printf("%-18s %7zu voxels, %4.0f KB diff (%.2f B/voxel) vs %.1f MB of chunk copies; undo %.1f ms, redo %.1f ms\n", name,
+                    count, stored / 1e3, (f64)stored / count, chunks * sizeof(BlockID) * CHUNK_SIZE / 1e6, undoMs, redoMs);
+    }
+}
+
+// Undo and redo on a 12x6x12 chunk terrain world with 10% noise: the diff size and undo and
+// redo time of each kind of operation, then ten operations under a 1 MB cap with spilling.
+int main() {
+    ChunkMap map;
+    buildWorld(map);
+    EditHistory history(&map);
+    VoxelEditor editor(&map);
+    editor.setHistory(&history);
+    test::Random random(690);
+
+    measure("fillBox 100^3", history, editor, [&] { return editor.fillBox(i32v3(100, 40, 100), i32v3(199, 139, 199), 5); });
+    measure("fillSphere r62", history, editor, [&] { return editor.fillSphere(i32v3(250, 100, 120), 62.0f, BLOCK_AIR); });
+    std::vector<u8> mask = makeMask(i32v3(100), random);
+    measure("50% noise mask", history, editor, [&] { return editor.applyMask(i32v3(40, 50, 250), i32v3(100), mask.data(), 6); });
+    measure("copyRegion 100^3", history, editor, [&] {
+        return editor.copyRegion(i32v3(20, 30, 20), i32v3(119, 129, 119), i32v3(230, 50, 230));
+    });
+    measure("group of 200", history, editor, [&] {
+        size_t count = 0;
+        history.beginOperation();
+        for (int i = 0; i < 200; i++) {
+            i32v3 c(random.range(20, 360), random.range(60, 130), random.range(20, 360));
+            count += i % 2 ? editor.fillSphere(c, (f32)random.range(4, 10), BLOCK_AIR)
+                           : editor.fillBox(c, c + i32v3(random.range(4, 16)), (BlockID)random.range(1, 4));
+        }
+        history.endOperation();
+        return count;
+    });
+
+    // Ten operations under a 1 MB cap, undone and redone in full
+    test::TempDirectory dir("edit_history_bench");
+    ChunkMap capped;
+    buildWorld(capped);
+    std::vector<const Chunk*> chunks;
+    std::vector<std::vector<BlockID>> before;
+    for (auto& it : capped.getChunks()) {
+        chunks.push_back(it.second);
+        before.emplace_back(it.second->getBlockData(), it.second->getBlockData() + CHUNK_SIZE);
+    }
+    EditHistory cappedHistory(&capped, 1024 * 1024, dir.getPath());
+    VoxelEditor cappedEditor(&capped);
+    cappedEditor.setHistory(&cappedHistory);
+    size_t total = 0;
+    for (int i = 0; i < 10; i++) {
+        i32v3 a(random.range(0, 280), random.range(20, 90), random.range(0, 280));
+        switch (i % 4) {
+            case 0: total += cappedEditor.fillBox(a, a + i32v3(99), (BlockID)random.range(1, 9)); break;
+            case 1: total += cappedEditor.fillSphere(a + i32v3(50), 50.0f, BLOCK_AIR); break;
+            case 2: total += cappedEditor.applyMask(a, i32v3(100), mask.data(), (BlockID)random.range(1, 9)); break;
+            default: total += cappedEditor.copyRegion(a, a + i32v3(99), i32v3(random.range(0, 280), random.range(20, 90), random.range(0, 280)));
+        }
+    }
+    cappedEditor.commit();
+    u64 spilled = cappedHistory.getSpilledSize();
+    size_t memory = cappedHistory.getMemoryUsage();
+
+    bench::Timer t;
+    size_t undone = 0;
+    while (size_t n = cappedEditor.undo()) undone += n;
+    cappedEditor.commit();
+    f64 undoMs = t.getMilliseconds();
+    int differences = 0;
+    for (size_t i = 0; i < chunks.size(); i++) {
+        differences += std::memcmp(chunks[i]->getBlockData(), before[i].data(), sizeof(BlockID) * CHUNK_SIZE) ? 1 : 0;
+    }
+    t.reset();
+    size_t redone = 0;
+    while (size_t n = cappedEditor.redo()) redone += n;
+    cappedEditor.commit();
+    f64 redoMs = t.getMilliseconds();
+    std::printf("1 MB cap           %.2f MB spilled, %.2f MB in memory; undo all 10 (%zu of %zu voxels) %.0f ms, %d chunks differ "
+                "from before; redo all (%zu voxels) %.0f ms\n", spilled / 1e6, memory / 1e6, undone, total, undoMs, differences,
+                redone, redoMs);
+    return 0;
+}
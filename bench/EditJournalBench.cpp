@@ -0,0 +1,106 @@
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestFiles.h"
+#include "TestWorld.h"
+
+#include "io/EditJournal.h"
+#include "io/RegionStore.h"
+#include "math/OpenVoxMath.hpp"
+#include "voxel/ChunkMap.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 WORLD_CHUNKS(16, 4, 16); ///< 1024 chunks
+    const int EDITS = 10000000;
+    const int WALKERS = 64;
+
+    EditJournal::ReplayFunc makeRecovery(ChunkMap& map, RegionStore& regions) {
+        return [&map, &regions](const i32v3& voxelPos, BlockID id) {
+            i32v3 chunkPos = toChunkPosition(voxelPos);
+            if (!map.getChunk(chunkPos)) regions.loadChunk(*map.createChunk(chunkPos));
+            map.setBlock(voxelPos, id);
+        };
+    }
+}
+
+// A 1024 chunk terrain world saved to regions, then 10M edits by 64 players random walking
+// through it: ingest rate and time until all are durable, the latency of one acknowledged edit,
+// replay alone, recovery of the world from the regions plus the journal, and a checkpoint.
+int main() {
+    test::TempDirectory dir("journal_bench");
+    ChunkMap live;
+    test::buildTerrain(live, i32v3(0), WORLD_CHUNKS - 1, 1, 48, 16.0f);
+    {
+        RegionStore regions;
+        regions.open(dir.getPath());
+        for (auto& it : live.getChunks()) regions.saveChunk(*it.second);
+        regions.sync();
+    }
+
+    test::Random random(67);
+    std::vector<i32v3> walkers(WALKERS);
+    i32v3 extent = WORLD_CHUNKS * CHUNK_WIDTH;
+    for (i32v3& w : walkers) w = i32v3(random.range(0, extent.x - 1), random.range(0, extent.y - 1), random.range(0, extent.z - 1));
+    std::vector<i32v3> positions(EDITS);
+    std::vector<BlockID> ids(EDITS);
+    for (int i = 0; i < EDITS; i++) {
+        i32v3& w = walkers[i % WALKERS];
+        int axis = random.range(0, 2);
+        w[axis] = openvoxm::min(openvoxm::max(w[axis] + (random.range(0, 1) ? 1 : -1), 0), extent[axis] - 1);
+        positions[i] = w;
+        ids[i] = (BlockID)random.range(0, 20);
+    }
+
+    EditJournal journal;
+    journal.open(dir.getPath(), [](const i32v3&, BlockID) {});
+    bench::Timer t;
+    for (int i = 0; i < EDITS; i++) {
+        live.setBlock(positions[i], ids[i]);
+        journal.append(positions[i], ids[i]);
+    }
+    f64 appended = t.getSeconds();
+    journal.waitDurable(EDITS);
+    f64 durable = t.getSeconds();
+    EditJournalStats stats = journal.getStats();
+    std::printf("ingest          %.1fM edits/s appended, all durable after %.2f s (%.1fM edits/s, %llu syncs, %.0f MB)\n",
+                EDITS / appended * 1e-6, durable, EDITS / durable * 1e-6, (unsigned long long)stats.syncs, stats.bytes / 1e6);
+
+    const int singles = 200;
+    t.reset();
+    // Writes the block already there, so the world stays as it was
+    for (int i = 0; i < singles; i++) journal.waitDurable(journal.append(positions[i], live.getBlock(positions[i])));
+    std::printf("single edit     %.0f us append to durable\n", t.getMicroseconds() / singles);
+    journal.close();
+
+    t.reset();
+    u64 replayed = 0;
+    journal.open(dir.getPath(), [&replayed](const i32v3&, BlockID) { replayed++; });
+    std::printf("replay only     %llu edits in %.2f s\n", (unsigned long long)replayed, t.getSeconds());
+    journal.close();
+
+    ChunkMap recovered;
+    RegionStore regions;
+    t.reset();
+    regions.open(dir.getPath());
+    journal.open(dir.getPath(), makeRecovery(recovered, regions));
+    f64 recoverSeconds = t.getSeconds();
+    int differences = 0;
+    for (auto& it : live.getChunks()) {
+        const Chunk* c = recovered.getChunk(it.first);
+        if (!c || std::memcmp(c->getBlockData(), it.second->getBlockData(), sizeof(BlockID) * CHUNK_SIZE)) differences++;
+    }
+    std::printf("full recovery   %.2f s with region loads, %zu chunks, %d differ from before the restart\n", recoverSeconds,
+                recovered.getChunkCount(), differences);
+
+    size_t segments = journal.getSegmentCount();
+    t.reset();
+    journal.checkpoint(recovered, regions);
+    std::printf("checkpoint      %.2f s for %zu chunks, journal from %zu segments down to %zu\n", t.getSeconds(),
+                recovered.getChunkCount(), segments, journal.getSegmentCount());
+    journal.close();
+    return 0;
+}
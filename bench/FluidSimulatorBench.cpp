@@ -0,0 +1,50 @@
+#include <cstdio>
+
+#include "BenchHarness.h"
+
+#include "jobs/JobSystem.h"
+#include "sim/FluidSimulator.h"
+
+using namespace openvox;
+
+// Dam break: a 3x2x3 chunk basin with a stone floor, a 24x40x24 block of water
+// released in one corner and simulated until the flow has mostly settled.
+int main() {
+    ChunkMap map;
+    for (i32 cy = 0; cy < 2; cy++) {
+        for (i32 cz = 0; cz < 3; cz++) {
+            for (i32 cx = 0; cx < 3; cx++) {
+                Chunk* chunk = map.createChunk(i32v3(cx, cy, cz));
+                if (cy) continue;
+                for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                    for (i32 x = 0; x < CHUNK_WIDTH; x++) chunk->setBlock(x, 0, z, 1);
+                }
+            }
+        }
+    }
+
+    for (int threads = 0; threads < 2; threads++) {
+        JobSystem jobs;
+        if (threads) jobs.init();
+        FluidSimulator fluids(&map);
+        for (i32 y = 1; y <= 40; y++) {
+            for (i32 z = 4; z < 28; z++) {
+                for (i32 x = 4; x < 28; x++) fluids.setFluid(i32v3(x, y, z), packFluid(FluidType::WATER, FLUID_MAX_LEVEL));
+            }
+        }
+        size_t cells = 0;
+        int ticks = 0;
+        bench::Timer timer;
+        while (ticks < 600) {
+            fluids.tick(threads ? &jobs : nullptr);
+            ticks++;
+            cells += fluids.getLastTickCellCount();
+            if (fluids.getLastTickCellCount() == 0) break;
+        }
+        double s = timer.getSeconds();
+        std::printf("%-10s %d ticks, %.1f M cell updates in %.2f s: %.1f M cells/s, %zu fluid chunks\n",
+                    threads ? "parallel" : "serial", ticks, cells / 1e6, s, cells / s / 1e6, fluids.getFluidChunkCount());
+        if (threads) jobs.dispose();
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/HeightmapCache.h"
+
+using namespace openvox;
+
+// Heightmaps of a 4x4 column, 4 chunk tall terrain world: building, height queries against
+// scanning down with getBlock, and single block edits with and without removing the top.
+int main() {
+    const i32 columns = 4, chunksUp = 4, width = columns * CHUNK_WIDTH;
+    ChunkMap map;
+    test::buildTerrain(map, i32v3(0), i32v3(columns - 1, chunksUp - 1, columns - 1), 1, 60, 12.0f);
+
+    double buildMs = bench::bestOf(5, [&] {
+        HeightmapCache cache(&map);
+        for (auto& it : map.getChunks()) cache.addChunk(it.first);
+        bench::keep(cache.getColumnCount());
+    });
+    std::printf("build           %.1f us/chunk\n", buildMs * 1000.0 / map.getChunkCount());
+
+    HeightmapCache cache(&map);
+    for (auto& it : map.getChunks()) cache.addChunk(it.first);
+    test::Random random(60);
+    const int queries = 1000000;
+    std::vector<i32v2> xz(queries);
+    for (i32v2& p : xz) p = i32v2(random.range(0, width - 1), random.range(0, width - 1));
+
+    i64 sum = 0;
+    double cachedMs = bench::bestOf(3, [&] {
+        for (const i32v2& p : xz) sum += cache.getHeight(HeightmapKind::SURFACE, p);
+    });
+    double scanMs = bench::bestOf(1, [&] {
+        for (int i = 0; i < queries / 100; i++) {
+            i32 y = chunksUp * CHUNK_WIDTH - 1;
+            while (y >= 0 && map.getBlock(i32v3(xz[i].x, y, xz[i].y)) == BLOCK_AIR) y--;
+            sum += y;
+        }
+    });
+    bench::keep(sum);
+    std::printf("getHeight       %.0f ns vs %.2f us scanning down with getBlock\n", cachedMs * 1e6 / queries,
+                scanMs * 1e3 / (queries / 100));
+
+    // Blocks placed above the terrain raise heights; removing the top block scans down
+    const int edits = 200000;
+    std::vector<i32v3> positions(edits);
+    for (i32v3& p : positions) p = i32v3(random.range(0, width - 1), random.range(80, chunksUp * CHUNK_WIDTH - 1), random.range(0, width - 1));
+    bench::Timer timer;
+    for (const i32v3& p : positions) {
+        BlockID old = map.getBlock(p);
+        map.setBlock(p, 5);
+        cache.onBlockChanged(p, old, 5);
+    }
+    double placeNs = timer.getSeconds() * 1e9 / edits;
+    int removed = 0;
+    timer.reset();
+    for (int i = 0; i < edits; i++) {
+        i32v2 p = xz[i];
+        i32 h = cache.getHeight(HeightmapKind::SURFACE, p);
+        i32v3 top(p.x, h, p.y);
+        BlockID old = map.getBlock(top);
+        map.setBlock(top, BLOCK_AIR);
+        cache.onBlockChanged(top, old, BLOCK_AIR);
+        removed++;
+    }
+    double removeNs = timer.getSeconds() * 1e9 / removed;
+    std::printf("onBlockChanged  %.0f ns/edit incl. setBlock, %.0f ns when the top is removed\n", placeNs, removeNs);
+    return 0;
+}
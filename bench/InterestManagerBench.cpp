@@ -0,0 +1,76 @@
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "net/InterestManager.h"
+
+using namespace openvox;
+
+// Clients walk 4 voxels per tick through a 4096 x 256 x 4096 voxel area holding 20k
+// entities that move every tick. Chunk radius 8, entity radius 64 with a matching grid cell.
+int main() {
+    const int ticks = 100;
+    const i32 chunkRadius = 8;
+    const f32 entityRadius = 64.0f;
+    const u32 clientCounts[] = { 100, 500, 1000 };
+    for (u32 clientCount : clientCounts) {
+        test::Random random(62);
+        InterestManager manager(entityRadius);
+        std::vector<f32v3> entities(20000);
+        for (size_t i = 0; i < entities.size(); i++) {
+            entities[i] = f32v3(random.range(0.0f, 4096.0f), random.range(0.0f, 256.0f), random.range(0.0f, 4096.0f));
+            manager.setEntity((InterestManager::EntityID)i, entities[i]);
+        }
+        std::vector<f32v3> clients(clientCount);
+        std::vector<f32v3> headings(clientCount);
+        for (u32 c = 0; c < clientCount; c++) {
+            clients[c] = f32v3(random.range(0.0f, 4096.0f), random.range(0.0f, 256.0f), random.range(0.0f, 4096.0f));
+            f32 angle = random.range(0.0f, 6.2831853f);
+            headings[c] = f32v3(std::cos(angle) * 4.0f, 0.0f, std::sin(angle) * 4.0f);
+            manager.addClient(c, chunkRadius, entityRadius);
+            manager.setClientPosition(c, clients[c]);
+        }
+        manager.update();
+
+        double updateMs = 0.0;
+        size_t entered = 0;
+        for (int t = 0; t < ticks; t++) {
+            for (size_t i = 0; i < entities.size(); i++) {
+                entities[i] += f32v3(random.range(-1.0f, 1.0f), 0.0f, random.range(-1.0f, 1.0f));
+                manager.setEntity((InterestManager::EntityID)i, entities[i]);
+            }
+            for (u32 c = 0; c < clientCount; c++) {
+                clients[c] += headings[c];
+                manager.setClientPosition(c, clients[c]);
+            }
+            bench::Timer timer;
+            manager.update();
+            updateMs += timer.getMilliseconds();
+            for (u32 c = 0; c < clientCount; c++) entered += manager.getDiff(c)->chunksEntered.size();
+        }
+        std::printf("%5u clients  %.2f ms/tick, %.1f entered chunks per client per tick\n", clientCount, updateMs / ticks,
+                    (double)entered / ticks / clientCount);
+    }
+
+    // What a brute-force pass costs: testing every chunk of the bounding cube of the sphere
+    const int clients = 100;
+    i64 visible = 0;
+    double bruteMs = bench::bestOf(3, [&] {
+        for (int c = 0; c < clients; c++) {
+            for (i32 dy = -chunkRadius; dy <= chunkRadius; dy++) {
+                for (i32 dz = -chunkRadius; dz <= chunkRadius; dz++) {
+                    for (i32 dx = -chunkRadius; dx <= chunkRadius; dx++) {
+                        visible += dx * dx + dy * dy + dz * dz <= chunkRadius * chunkRadius ? c & 1 : 0;
+                    }
+                }
+            }
+        }
+    });
+    bench::keep(visible);
+    std::printf("brute force    %d chunks per client per tick, %.2f ms/tick for %d clients before any diffing\n",
+                (2 * chunkRadius + 1) * (2 * chunkRadius + 1) * (2 * chunkRadius + 1), bruteMs, clients);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "gen/ColumnCache.h"
+#include "gen/NoiseLattice.h"
+
+using namespace openvox;
+
+// 4-octave value noise (wavelengths 64 to 8 voxels) over 16 chunks, per voxel and on
+// lattices with strides 2, 4 and 8. Errors are against per-voxel evaluation.
+int main() {
+    const int chunkCount = 16;
+    std::vector<i32v3> chunks;
+    for (int i = 0; i < chunkCount; i++) chunks.push_back(i32v3(i % 4, (i / 4) % 2 - 1, i / 8));
+    // Base wavelength of 64 voxels, so the finest octave spans 8
+    NoiseLattice::NoiseFunc noise = [](const f32v3& p) { return test::getValueNoise(p, 4, 1.0f / 64.0f); };
+
+    std::vector<f32> exact((size_t)chunkCount * CHUNK_SIZE);
+    double exactMs = bench::bestOf(2, [&] {
+        for (int c = 0; c < chunkCount; c++) {
+            i32v3 origin = toVoxelPosition(chunks[c]);
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                i32v3 p = origin + getVoxelPosition(i);
+                exact[(size_t)c * CHUNK_SIZE + i] = noise(f32v3((f32)p.x, (f32)p.y, (f32)p.z));
+            }
+        }
+    }) / chunkCount;
+    std::printf("per-voxel  %.2f ms/chunk\n", exactMs);
+
+    const u32 strides[] = { 2, 4, 8 };
+    std::vector<f32> values((size_t)chunkCount * CHUNK_SIZE);
+    for (u32 stride : strides) {
+        NoiseLattice lattice(stride);
+        double ms = bench::bestOf(5, [&] {
+            for (int c = 0; c < chunkCount; c++) lattice.sampleChunk(chunks[c], noise, &values[(size_t)c * CHUNK_SIZE]);
+        }) / chunkCount;
+        double sum = 0.0, worst = 0.0;
+        for (size_t i = 0; i < values.size(); i++) {
+            double e = std::abs(values[i] - exact[i]);
+            sum += e;
+            worst = std::max(worst, e);
+        }
+        std::printf("stride %u   %.3f ms/chunk %6.1fx, mean err %.4f, max %.3f\n", stride, ms, exactMs / ms,
+                    sum / values.size(), worst);
+    }
+
+    ColumnCache cache([](f32 x, f32 z) {
+        ColumnSample s = { 64.0f + 20.0f * test::getValueNoise(f32v3(x, 0.0f, z), 3), 0 };
+        return s;
+    });
+    bench::Timer timer;
+    for (i32 y = 0; y < 8; y++) {
+        for (i32 z = 0; z < 8; z++) {
+            for (i32 x = 0; x < 8; x++) bench::keep(cache.get(i32v2(x, z)).height[0]);
+        }
+    }
+    std::printf("column cache  512 stacked chunk lookups computed %llu columns in %.2f ms\n",
+                (unsigned long long)cache.getColumnsComputed(), timer.getMilliseconds());
+    return 0;
+}
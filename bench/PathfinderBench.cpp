@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "ai/Pathfinder.h"
+
+using namespace openvox;
+
+namespace {
+    const i32 WORLD_CHUNKS = 36;
+    const i32 WORLD_WIDTH = WORLD_CHUNKS * CHUNK_WIDTH;
+
+    bool solid(const ChunkMap& map, const i32v3& p) {
+        return map.getBlock(p, 1) != BLOCK_AIR;
+    }
+    bool walkable(const ChunkMap& map, const i32v3& p) {
+        return !solid(map, p) && !solid(map, p + i32v3(0, 1, 0)) && solid(map, p - i32v3(0, 1, 0));
+    }
+
+    /// Plain A* over every cell with the pathfinder's move rules, for comparison
+    u32 plainAStar(const ChunkMap& map, const i32v3& start, const i32v3& goal) {
+        struct Entry {
+            u32 f;
+            u32 g;
+            i32v3 p;
+            bool operator<(const Entry& o) const { return f > o.f; }
+        };
+        auto h = [&goal](const i32v3& p) {
+            return (u32)(std::abs(goal.x - p.x) + std::abs(goal.z - p.z)) * PATH_MOVE_COST;
+        };
+        std::priority_queue<Entry> open;
+        std::unordered_map<i32v3, u32, PositionHash> best;
+        Entry s = { h(start), 0, start };
+        open.push(s);
+        best[start] = 0;
+        const i32 dirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+        while (!open.empty()) {
+            Entry e = open.top();
+            open.pop();
+            if (e.p == goal) return e.g;
+            if (best[e.p] < e.g) continue;
+            for (int d = 0; d < 4; d++) {
+                i32v3 n(e.p.x + dirs[d][0], e.p.y, e.p.z + dirs[d][1]);
+                u32 c;
+                if (solid(map, n)) {
+                    n.y++;
+                    if (solid(map, e.p + i32v3(0, 2, 0)) || !walkable(map, n)) continue;
+                    c = PATH_MOVE_COST + PATH_CLIMB_COST;
+                } else {
+                    if (solid(map, n + i32v3(0, 1, 0))) continue;
+                    int k = 0;
+                    while (k <= PATH_MAX_DROP && !walkable(map, n)) {
+                        if (solid(map, n)) break;
+                        n.y--;
+                        k++;
+                    }
+                    if (k > PATH_MAX_DROP || !walkable(map, n)) continue;
+                    c = PATH_MOVE_COST + PATH_DROP_COST * (u32)k;
+                }
+                u32 g = e.g + c;
+                auto it = best.find(n);
+                if (it != best.end() && it->second <= g) continue;
+                best[n] = g;
+                Entry next = { g + h(n), g, n };
+                open.push(next);
+            }
+        }
+        return PATH_NO_COST;
+    }
+
+    i32v3 surface(i32 x, i32 z) {
+        return i32v3(x, test::getTerrainHeight(x, z) + 1, z);
+    }
+
+    /// Random surface routes whose endpoints are `length` blocks apart
+    std::vector<std::pair<i32v3, i32v3> > makeRoutes(test::Random& random, i32 length, int count) {
+        std::vector<std::pair<i32v3, i32v3> > routes;
+        while ((int)routes.size() < count) {
+            i32 x = random.range(0, WORLD_WIDTH - 1), z = random.range(0, WORLD_WIDTH - 1);
+            i32 dx = random.range(0, length), dz = length - dx;
+            if (random.range(0, 1)) dx = -dx;
+            if (random.range(0, 1)) dz = -dz;
+            if (x + dx < 0 || x + dx >= WORLD_WIDTH || z + dz < 0 || z + dz >= WORLD_WIDTH) continue;
+            routes.push_back(std::make_pair(surface(x, z), surface(x + dx, z + dz)));
+        }
+        return routes;
+    }
+}
+
+// Paths between surface points 50, 200 and 1000 blocks apart on a 36x36x2 chunk
+// heightmap world, on one thread, compared against plain A* for cost and time.
+int main() {
+    ChunkMap map;
+    test::buildTerrain(map, i32v3(0, 0, 0), i32v3(WORLD_CHUNKS - 1, 1, WORLD_CHUNKS - 1));
+    Pathfinder pathfinder(&map);
+    for (i32 y = 0; y <= 1; y++) {
+        for (i32 z = 0; z < WORLD_CHUNKS; z++) {
+            for (i32 x = 0; x < WORLD_CHUNKS; x++) pathfinder.addChunk(i32v3(x, y, z));
+        }
+    }
+    bench::Timer timer;
+    pathfinder.update();
+    std::printf("build     %zu clusters in %.0f ms\n", pathfinder.getClusterCount(), timer.getMilliseconds());
+
+    test::Random random(56);
+    const i32 lengths[] = { 50, 200, 1000 };
+    for (i32 length : lengths) {
+        std::vector<std::pair<i32v3, i32v3> > routes = makeRoutes(random, length, length >= 1000 ? 50 : 200);
+        std::vector<i32v3> path;
+        std::vector<u32> costs(routes.size(), PATH_NO_COST);
+        int found = 0;
+        timer.reset();
+        for (size_t i = 0; i < routes.size(); i++) {
+            found += pathfinder.findPath(routes[i].first, routes[i].second, path, &costs[i]) == PathStatus::FOUND ? 1 : 0;
+        }
+        double ms = timer.getMilliseconds();
+        std::printf("hpa       %4d blocks: %d/%zu found, %.0f paths/s, %.2f ms average\n",
+                    length, found, routes.size(), routes.size() / ms * 1000.0, ms / routes.size());
+
+        // Plain A* is slow on long routes, so it only runs on a few of them
+        size_t plainCount = std::min<size_t>(routes.size(), length >= 1000 ? 10 : 50);
+        double ratioSum = 0.0, worst = 1.0;
+        size_t compared = 0;
+        timer.reset();
+        for (size_t i = 0; i < plainCount; i++) {
+            u32 optimal = plainAStar(map, routes[i].first, routes[i].second);
+            if (optimal == PATH_NO_COST || optimal == 0 || costs[i] == PATH_NO_COST) continue;
+            double ratio = (double)costs[i] / optimal;
+            ratioSum += ratio;
+            worst = std::max(worst, ratio);
+            compared++;
+        }
+        ms = timer.getMilliseconds();
+        std::printf("plain a*  %4d blocks: %.2f ms average, hpa cost %.3fx optimal on average, %.3fx worst\n",
+                    length, ms / plainCount, compared ? ratioSum / compared : 1.0, worst);
+    }
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "io/Serialization.hpp"
+
+using namespace openvox;
+
+namespace {
+    struct Entity {
+        u32 id;
+        f32v3 position;
+        f32v3 velocity;
+        u16 type;
+        i32 health;
+    };
+
+    enum EntityField : u32 { ENTITY_FIELD_ID = 1, ENTITY_FIELD_MOTION, ENTITY_FIELD_STATE };
+
+    void writeFlat(BinaryWriter& w, const Entity& e) {
+        w.writeVarint(e.id);
+        w.write(e.position);
+        w.write(e.velocity);
+        w.writeVarint(e.type);
+        w.writeZigZag(e.health);
+    }
+    bool readFlat(BinaryReader& r, Entity& e) {
+        r.readVarint(e.id);
+        r.read(e.position);
+        r.read(e.velocity);
+        r.readVarint(e.type);
+        return r.readZigZag(e.health);
+    }
+
+    void writeFields(BinaryWriter& w, const Entity& e) {
+        w.beginField(ENTITY_FIELD_ID);
+        w.writeVarint(e.id);
+        w.endField();
+        w.beginField(ENTITY_FIELD_MOTION);
+        w.write(e.position);
+        w.write(e.velocity);
+        w.endField();
+        w.beginField(ENTITY_FIELD_STATE);
+        w.writeVarint(e.type);
+        w.writeZigZag(e.health);
+        w.endField();
+    }
+    void readFields(BinaryReader& r, Entity& e) {
+        u32 tag;
+        BinaryReader field;
+        while (r.readField(tag, field)) {
+            switch (tag) {
+                case ENTITY_FIELD_ID: field.readVarint(e.id); break;
+                case ENTITY_FIELD_MOTION: field.read(e.position); field.read(e.velocity); break;
+                case ENTITY_FIELD_STATE: field.readVarint(e.type); field.readZigZag(e.health); break;
+                default: break;
+            }
+        }
+    }
+
+    double toGBs(size_t bytes, double ms) {
+        return bytes / (ms * 1e6);
+    }
+}
+
+// Throughput of the shapes of data the engine saves: a chunk's block ids as one array, the same
+// chunk as 4-bit palette indices, and 10k small entities written flat or each field tagged.
+int main() {
+    test::Random random(64);
+
+    // A chunk of ids from a 16 block palette
+    std::vector<u16> ids(CHUNK_SIZE), idsOut(CHUNK_SIZE);
+    for (u16& id : ids) id = (u16)random.range(0, 15);
+    std::vector<u8> buffer;
+    const int chunks = 64;
+    double writeMs = bench::bestOf(20, [&] {
+        buffer.clear();
+        BinaryWriter w(buffer);
+        for (int i = 0; i < chunks; i++) w.writeArray(ids.data(), ids.size());
+    });
+    double readMs = bench::bestOf(20, [&] {
+        BinaryReader r(buffer.data(), buffer.size());
+        BinaryArrayView<u16> view;
+        for (int i = 0; i < chunks; i++) {
+            r.readArray(ids.size(), view);
+            view.copyTo(idsOut.data());
+        }
+        bench::keep(idsOut[CHUNK_SIZE - 1]);
+    });
+    std::printf("chunk u16 array     write %.1f GB/s, read+copy %.1f GB/s\n", toGBs(buffer.size(), writeMs),
+                toGBs(buffer.size(), readMs));
+
+    double paletteWriteMs = bench::bestOf(20, [&] {
+        buffer.clear();
+        BinaryWriter w(buffer);
+        for (int i = 0; i < chunks; i++) {
+            for (u16 id : ids) w.writeBits(id, 4);
+        }
+    });
+    double paletteReadMs = bench::bestOf(20, [&] {
+        BinaryReader r(buffer.data(), buffer.size());
+        for (int i = 0; i < chunks; i++) {
+            for (u16& id : idsOut) {
+                u32 v = 0;
+                r.readBits(4, v);
+                id = (u16)v;
+            }
+        }
+        bench::keep(idsOut[CHUNK_SIZE - 1]);
+    });
+    std::printf("chunk 4-bit         write %.2f ns/voxel, read %.2f ns/voxel (%zu B/chunk)\n",
+                paletteWriteMs * 1e6 / (chunks * CHUNK_SIZE), paletteReadMs * 1e6 / (chunks * CHUNK_SIZE),
+                buffer.size() / chunks);
+
+    // Entities
+    const int count = 10000;
+    std::vector<Entity> entities(count), entitiesOut(count);
+    for (int i = 0; i < count; i++) {
+        Entity& e = entities[i];
+        e.id = (u32)i * 7 + 1000;
+        e.position = f32v3(random.range(-500.0f, 500.0f), random.range(0.0f, 128.0f), random.range(-500.0f, 500.0f));
+        e.velocity = f32v3(random.range(-1.0f, 1.0f), random.range(-1.0f, 1.0f), random.range(-1.0f, 1.0f));
+        e.type = (u16)random.range(0, 200);
+        e.health = random.range(-20, 100);
+    }
+
+    double flatWriteMs = bench::bestOf(20, [&] {
+        buffer.clear();
+        BinaryWriter w(buffer);
+        for (const Entity& e : entities) writeFlat(w, e);
+    });
+    size_t flatSize = buffer.size();
+    double flatReadMs = bench::bestOf(20, [&] {
+        BinaryReader r(buffer.data(), buffer.size());
+        for (Entity& e : entitiesOut) readFlat(r, e);
+        bench::keep(entitiesOut[count - 1].health);
+    });
+    std::printf("entities flat       %.1f B/entity, write %.1f GB/s, read %.1f GB/s\n", (double)flatSize / count,
+                toGBs(flatSize, flatWriteMs), toGBs(flatSize, flatReadMs));
+
+    double fieldWriteMs = bench::bestOf(20, [&] {
+        buffer.clear();
+        BinaryWriter w(buffer);
+        for (const Entity& e : entities) writeFields(w, e);
+    });
+    size_t fieldSize = buffer.size();
+    // Each entity is read back as its own record, as a loader walking a list would
+    std::vector<size_t> offsets;
+    {
+        BinaryReader r(buffer.data(), buffer.size());
+        for (int i = 0; i < count; i++) {
+            offsets.push_back(r.getPosition());
+            u32 tag;
+            BinaryReader field;
+            for (int f = 0; f < 3; f++) r.readField(tag, field);
+        }
+        offsets.push_back(buffer.size());
+    }
+    double fieldReadMs = bench::bestOf(20, [&] {
+        for (int i = 0; i < count; i++) {
+            BinaryReader r(buffer.data() + offsets[i], offsets[i + 1] - offsets[i]);
+            readFields(r, entitiesOut[i]);
+        }
+        bench::keep(entitiesOut[count - 1].health);
+    });
+    std::printf("entities in fields  %.1f B/entity, write %.1f GB/s, read %.1f GB/s\n", (double)fieldSize / count,
+                toGBs(fieldSize, fieldWriteMs), toGBs(fieldSize, fieldReadMs));
+    return 0;
+}
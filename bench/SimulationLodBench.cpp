@@ -0,0 +1,120 @@
+#include <cstdio>
+#include <limits>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "sim/SimulationLod.h"
+
+using namespace openvox;
+
+namespace {
+    const f32 TICK = 0.05f;
+    const i32 HEIGHT = 4;
+    const u32 ENTITIES_PER_CHUNK = 4;
+    const u32 RANDOM_TICKS = 3; ///< Per chunk per tick
+    const int TICKS = 160;
+
+    struct Entity {
+        f32v3 position;
+        f32v3 velocity;
+    };
+
+    struct Result {
+        f64 averageMs;
+        f64 maxMs;
+        f64 maxUpdates; ///< Members simulated in the busiest tick over the average
+        u64 work;
+    };
+
+    /// One player walking across a square of loaded chunks
+    Result simulate(i32 radius, bool lod) {
+        SimulationLod sim(TICK);
+        if (!lod) {
+            std::vector<SimulationTier> tiers(1);
+            tiers[0].maxDistance = std::numeric_limits<f32>::infinity();
+            tiers[0].interval = 1;
+            sim.setTiers(tiers);
+        }
+        test::Random random(66);
+        i32 width = 2 * radius + 1;
+        std::vector<u32> blocks((size_t)width * width * HEIGHT, 0);
+        for (i32 y = 0; y < HEIGHT; y++) {
+            for (i32 z = -radius; z <= radius; z++) {
+                for (i32 x = -radius; x <= radius; x++) sim.addChunk(i32v3(x, y, z));
+            }
+        }
+        std::vector<Entity> entities(blocks.size() * ENTITIES_PER_CHUNK);
+        f32 extent = (f32)(radius * CHUNK_WIDTH);
+        for (size_t i = 0; i < entities.size(); i++) {
+            entities[i].position = f32v3(random.range(-extent, extent), random.range(0.0f, (f32)(HEIGHT * CHUNK_WIDTH)), random.range(-extent, extent));
+            entities[i].velocity = f32v3(random.range(-1.0f, 1.0f), 0.0f, random.range(-1.0f, 1.0f));
+            sim.setEntity((SimulationLod::EntityID)i, entities[i].position);
+        }
+
+        u64 work = 0;
+        u32 seed = 1;
+        auto updateEntity = [&](SimulationLod::EntityID id, f32 dt) {
+            Entity& e = entities[id];
+            // Wanders along a noise field, standing in for AI and pathing
+            f32v3 p = e.position * 0.25f;
+            e.velocity.x += (test::getValueNoise(p) - 0.5f) * dt;
+            e.velocity.z += (test::getValueNoise(p + f32v3(97.0f)) - 0.5f) * dt;
+            e.velocity.y -= 9.8f * dt;
+            e.velocity *= 0.98f;
+            e.position += e.velocity * dt;
+            if (e.position.y < 0.0f) {
+                e.position.y = 0.0f;
+                e.velocity.y = 0.0f;
+            }
+            work++;
+        };
+        auto tickChunk = [&](const i32v3& c, u32 ticks) {
+            u32& block = blocks[((size_t)c.y * width + (c.z + radius)) * width + (c.x + radius)];
+            for (u32 i = 0; i < RANDOM_TICKS * ticks; i++) {
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                // A random block grows if the noise at it allows
+                f32v3 p(toVoxelPosition(c) + i32v3(seed & 31, (seed >> 5) & 31, (seed >> 10) & 31));
+                block += test::getValueNoise(p) > 0.6f;
+            }
+            work++;
+        };
+
+        std::vector<f32v3> players(1, f32v3(-extent * 0.5f, 40.0f, 0.5f));
+        f64 total = 0.0, worst = 0.0;
+        size_t busiest = 0;
+        for (int tick = 0; tick < TICKS; tick++) {
+            // Walking at 5 blocks/s, entities are moved back in so the tier changes are exercised
+            players[0].x += 5.0f * TICK;
+            bench::Timer t;
+            sim.setPlayers(players);
+            for (size_t i = tick % 16; i < entities.size(); i += 16) sim.setEntity((SimulationLod::EntityID)i, entities[i].position);
+            sim.update(updateEntity, tickChunk);
+            f64 ms = t.getMilliseconds();
+            total += ms;
+            worst = ms > worst ? ms : worst;
+            busiest = sim.getLastUpdateCount() > busiest ? sim.getLastUpdateCount() : busiest;
+        }
+        bench::keep(blocks[0]);
+        Result r = { total / TICKS, worst, (f64)busiest * TICKS / work, work };
+        return r;
+    }
+}
+
+// Ticks of a world 4 chunks tall with 4 entities and 3 random ticks per chunk, around one walking
+// player, all at full rate and with the default simulation tiers.
+int main() {
+    std::printf("loaded chunks   full rate ms/tick   LOD ms/tick   LOD busiest tick / average: updates, time\n");
+    const i32 radii[] = { 2, 4, 8, 16 };
+    for (i32 radius : radii) {
+        i32 width = 2 * radius + 1;
+        Result full = simulate(radius, false);
+        Result lod = simulate(radius, true);
+        std::printf("%8d        %8.2f            %6.2f        %.3f, %.2f (%.0f%% of the updates)\n", width * width * HEIGHT,
+                    full.averageMs, lod.averageMs, lod.maxUpdates, lod.maxMs / lod.averageMs, 100.0 * lod.work / full.work);
+    }
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "jobs/JobSystem.h"
+#include "physics/SpatialHash.h"
+
+using namespace openvox;
+
+// Random walkers in a world sized so density stays constant: updates, radius
+// queries of 8 voxels and a full rebuild, at 1k, 10k and 100k entities.
+int main() {
+    JobSystem jobs;
+    jobs.init();
+    const size_t counts[] = { 1000, 10000, 100000 };
+    for (size_t count : counts) {
+        f32 extent = 20.0f * std::sqrt((f32)count);
+        test::Random random(52);
+        std::vector<f32v3> pos(count);
+        for (auto& p : pos) p = f32v3(random.range(-extent, extent), random.range(0.0f, 64.0f), random.range(-extent, extent));
+        std::vector<f32v3> vel(count);
+        for (auto& v : vel) v = f32v3(random.range(-0.5f, 0.5f), 0.0f, random.range(-0.5f, 0.5f));
+
+        SpatialHash hash;
+        hash.rebuild(pos.data(), count);
+
+        const int ticks = 20;
+        bench::Timer timer;
+        for (int t = 0; t < ticks; t++) {
+            for (size_t i = 0; i < count; i++) {
+                pos[i] += vel[i];
+                hash.update((SpatialHash::EntityID)i, pos[i]);
+            }
+        }
+        double updateRate = count * (double)ticks / timer.getSeconds();
+
+        std::vector<SpatialHash::EntityID> results(4096);
+        const size_t queries = 100000;
+        size_t found = 0;
+        timer.reset();
+        for (size_t q = 0; q < queries; q++) {
+            found += hash.queryRadius(pos[q % count], 8.0f, results.data(), results.size());
+        }
+        double queryRate = queries / timer.getSeconds();
+        bench::keep(found);
+
+        double serialMs = bench::bestOf(5, [&] { hash.rebuild(pos.data(), count); });
+        double parallelMs = bench::bestOf(5, [&] { hash.rebuild(pos.data(), count, &jobs); });
+
+        std::printf("%7zu entities  %6.1f M updates/s  %5.2f M radius queries/s (%.1f hits)  rebuild %.2f ms, %.2f ms on %u threads\n",
+                    count, updateRate / 1e6, queryRate / 1e6, (double)found / queries, serialMs, parallelMs, jobs.getConcurrency());
+    }
+    jobs.dispose();
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestMeshes.h"
+
+#include "mesh/TerrainClipmap.h"
+
+using namespace openvox;
+
+namespace {
+    const int STEPS = 32; ///< Camera moves of one chunk along x
+
+    void printFill(const char* name, TerrainClipmap& clipmap, double ms) {
+        std::vector<ClipmapChunk> chunks;
+        clipmap.getVisibleChunks(chunks);
+        size_t triangles = 0;
+        for (const ClipmapChunk& c : chunks) triangles += c.mesh->indices.size() / 3;
+        std::printf("fill %-8s %5llu chunks in %6.0f ms  %4zu with surface  %.2f M triangles  %.1f MB  view %.0f voxels\n", name,
+                    (unsigned long long)clipmap.getMeshedCount(), ms, chunks.size(), triangles / 1e6,
+                    clipmap.getMemoryUsage() / (1024.0 * 1024.0), clipmap.getViewDistance());
+    }
+}
+
+// The default clipmap of 9 levels, radius 4 and vertical radius 2 on the smooth test terrain,
+// filled once inline and once on a JobSystem with a worker per hardware thread. Then the camera
+// walks 32 steps of one chunk along x and every step is flushed inline.
+int main() {
+    f32v3 camera(100.0f, 100.0f, 100.0f);
+    {
+        TerrainClipmap clipmap(test::getTerrainDensity);
+        bench::Timer t;
+        clipmap.flush(camera);
+        printFill("inline", clipmap, t.getMilliseconds());
+    }
+
+    JobSystem jobs;
+    jobs.init();
+    TerrainClipmap clipmap(test::getTerrainDensity);
+    bench::Timer t;
+    clipmap.flush(camera, &jobs);
+    printFill("jobs", clipmap, t.getMilliseconds());
+    jobs.dispose();
+
+    u64 chunkSum = 0, chunkWorst = 0;
+    double msSum = 0.0, msWorst = 0.0;
+    int moves = 0;
+    for (int step = 0; step < STEPS; step++) {
+        camera.x += CHUNK_WIDTH;
+        u64 before = clipmap.getMeshedCount();
+        t.reset();
+        clipmap.flush(camera);
+        double ms = t.getMilliseconds();
+        u64 meshed = clipmap.getMeshedCount() - before;
+        if (meshed == 0) continue;
+        moves++;
+        chunkSum += meshed;
+        msSum += ms;
+        chunkWorst = std::max(chunkWorst, meshed);
+        msWorst = std::max(msWorst, ms);
+    }
+    std::printf("crossing  %d of %d steps meshed, %.0f chunks avg / %llu worst, %.0f ms avg / %.0f ms worst\n", moves, STEPS,
+                (double)chunkSum / std::max(moves, 1), (unsigned long long)chunkWorst, msSum / std::max(moves, 1), msWorst);
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include <cstdio>
+
+#include "BenchHarness.h"
+#include "TestGenStages.h"
+
+using namespace openvox;
+
+namespace {
+    u64 checksum(const ChunkMap& map, i32 width, i32 height) {
+        u64 h = 1469598103934665603ull;
+        for (i32 y = 0; y < height; y++) {
+            for (i32 z = 0; z < width; z++) {
+                for (i32 x = 0; x < width; x++) {
+                    const BlockID* data = map.getChunk(i32v3(x, y, z))->getBlockData();
+                    for (int i = 0; i < CHUNK_SIZE; i++) h = (h ^ data[i]) * 1099511628211ull;
+                }
+            }
+        }
+        return h;
+    }
+}
+
+// Generates 12x2x12 = 288 requested chunks through the four test stages, with trees
+// spilling into neighbors, inline and with 1, 2 and 4 workers.
+int main() {
+    const i32 width = 12, height = 2;
+    const u32 workers[] = { 0, 1, 2, 4 };
+    for (u32 w : workers) {
+        ChunkMap map;
+        TerrainPipeline pipeline(&map, 58);
+        test::addTestStages(pipeline);
+        JobSystem jobs;
+        if (w) jobs.init(w);
+
+        bench::Timer timer;
+        for (i32 y = 0; y < height; y++) {
+            for (i32 z = 0; z < width; z++) {
+                for (i32 x = 0; x < width; x++) pipeline.requestChunk(i32v3(x, y, z));
+            }
+        }
+        pipeline.flush(w ? &jobs : nullptr);
+        double seconds = timer.getSeconds();
+        if (w) jobs.dispose();
+
+        i32 count = width * width * height;
+        std::printf("%u workers  %d chunks (%zu generated, %llu steps) in %.0f ms: %.0f chunks/s, checksum %016llx\n", w,
+                    count, map.getChunkCount(), (unsigned long long)pipeline.getStagesRun(), seconds * 1000.0,
+                    count / seconds, (unsigned long long)checksum(map, width, height));
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+
+#include "sim/TickDriver.h"
+
+using namespace openvox;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    const int TICKS = 200;
+    const f64 SPIKE_START = 3.0; ///< Seconds into the run
+    const f64 SPIKE_END = 6.0;
+
+    void spin(f64 seconds) {
+        Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(seconds));
+        while (Clock::now() < end) {}
+    }
+
+    struct Result {
+        f64 seconds;
+        std::vector<f32> perSecond; ///< Ticks per second over each second of the run
+        TickStats stats;
+    };
+
+    /// 42 ms of work per 50 ms tick, split over subsystems that scale with the degradation,
+    /// plus a 25 ms spike that no level sheds
+    Result runLoad(bool shed) {
+        TickDriver driver(20.0f);
+        if (!shed) driver.setPolicy(std::vector<TickDegradation>(1));
+        Clock::time_point start;
+        auto seconds = [&start]() { return std::chrono::duration<f64>(Clock::now() - start).count(); };
+
+        driver.addSubsystem("chunk generation", 0.016f, [](const TickContext& c) { spin(0.016 * c.degradation.chunkGenerationScale); });
+        driver.addSubsystem("random ticks", 0.010f, [](const TickContext& c) { spin(0.010 * c.degradation.randomTickScale); });
+        driver.addSubsystem("near entities", 0.006f, [](const TickContext&) { spin(0.006); });
+        driver.addSubsystem("distant entities", 0.010f, [](const TickContext& c) {
+            if (c.tick % c.degradation.distantEntityInterval == 0) spin(0.010);
+        });
+        driver.addSubsystem("spike", 0.0f, [&](const TickContext& c) {
+            f64 t = seconds();
+            if (t >= SPIKE_START && t < SPIKE_END) spin(0.025);
+            if (c.tick + 1 == TICKS) driver.stop();
+        });
+
+        Result result;
+        std::vector<u64> ticksBySecond;
+        auto* listener = driver.onTick.addFunctor([&](Sender, const TickStats&) {
+            size_t second = (size_t)seconds();
+            if (second >= ticksBySecond.size()) ticksBySecond.resize(second + 1, 0);
+            ticksBySecond[second]++;
+        });
+        start = Clock::now();
+        driver.run();
+        result.seconds = seconds();
+        result.stats = driver.getStats();
+        // The last second is partial
+        for (size_t i = 0; i + 1 < ticksBySecond.size(); i++) result.perSecond.push_back((f32)ticksBySecond[i]);
+        driver.onTick -= *listener;
+        delete listener;
+        return result;
+    }
+
+    void print(const char* name, const Result& r) {
+        f32 lo = 1e9f, hi = 0.0f, spikeLo = 1e9f;
+        for (size_t i = 0; i < r.perSecond.size(); i++) {
+            lo = r.perSecond[i] < lo ? r.perSecond[i] : lo;
+            hi = r.perSecond[i] > hi ? r.perSecond[i] : hi;
+            if (i >= SPIKE_START && i < SPIKE_END && r.perSecond[i] < spikeLo) spikeLo = r.perSecond[i];
+        }
+        std::printf("%-18s %.1f tps overall, %.0f-%.0f tps per second (%.0f in the spike), %llu late, %llu dropped, "
+                    "average tick %.1f ms, %u level changes\n",
+                    name, r.stats.ticks / r.seconds, lo, hi, spikeLo, (unsigned long long)r.stats.lateTicks,
+                    (unsigned long long)r.stats.droppedTicks, r.stats.averageTickTime * 1000.0f, r.stats.degradationChanges);
+    }
+}
+
+// Synthetic server load at 20 ticks/s: 42 ms of work in each 50 ms tick and a 25 ms spike from
+// 3 s to 6 s, over 200 ticks, with the default degradation policy and with a single level.
+int main() {
+    print("without shedding", runLoad(false));
+    print("with shedding", runLoad(true));
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestMeshes.h"
+
+#include "mesh/TransvoxelMesher.h"
+
+using namespace openvox;
+
+namespace {
+    const int COLUMNS = 8; ///< Chunks along x and z, two per column
+    const int REPEATS = 3;
+
+    /// Two chunks per column around the terrain surface at the column center
+    std::vector<i32v3> getSurfaceChunks(u32 lod) {
+        std::vector<i32v3> chunks;
+        i32 width = CHUNK_WIDTH << lod;
+        for (i32 z = 0; z < COLUMNS; z++) {
+            for (i32 x = 0; x < COLUMNS; x++) {
+                i32v3 center(x * width + width / 2, 0, z * width + width / 2);
+                while (test::getTerrainDensity(center) < 0) center.y += 1 << lod;
+                i32 y = center.y / width;
+                chunks.push_back(i32v3(x, y, z));
+                chunks.push_back(i32v3(x, center.y % width < width / 2 ? y - 1 : y + 1, z));
+            }
+        }
+        return chunks;
+    }
+
+    struct Result {
+        f64 msPerChunk;
+        size_t triangles;
+        size_t vertices;
+        size_t surfaceChunks;
+    };
+
+    Result meshChunks(TransvoxelMesher& mesher, const std::vector<i32v3>& chunks, u32 lod, const TransvoxelMesher::DensityFunc& density) {
+        TransvoxelMesh mesh;
+        Result result = {};
+        result.msPerChunk = bench::bestOf(REPEATS, [&] {
+            result.triangles = result.vertices = result.surfaceChunks = 0;
+            for (const i32v3& c : chunks) {
+                mesher.mesh(c, lod, 0, density, mesh);
+                result.triangles += mesh.indices.size() / 3;
+                result.vertices += mesh.vertices.size();
+                result.surfaceChunks += mesh.indices.empty() ? 0 : 1;
+            }
+        }) / chunks.size();
+        return result;
+    }
+}
+
+// 128 chunks per LOD around the smooth test terrain, meshed on one core with the density
+// sampled through the terrain function, then LOD 0 again from a stored i8 volume.
+int main() {
+    TransvoxelMesher mesher;
+    for (u32 lod = 0; lod <= 4; lod++) {
+        Result r = meshChunks(mesher, getSurfaceChunks(lod), lod, test::getTerrainDensity);
+        std::printf("LOD %u  %.2f ms/chunk  %4zu tris per surface chunk  %.2f Mtri/s  %.2f vertices per triangle\n", lod, r.msPerChunk,
+                    r.triangles / openvoxm::max(r.surfaceChunks, (size_t)1), r.triangles / (r.msPerChunk * 128 * 1e3),
+                    (f64)r.vertices / r.triangles);
+    }
+
+    // The same LOD 0 chunks read from a volume sampled beforehand
+    std::vector<i32v3> chunks = getSurfaceChunks(0);
+    i32v3 min(-1, 1 << 30, -1), max(COLUMNS * CHUNK_WIDTH + 1, 0, COLUMNS * CHUNK_WIDTH + 1);
+    for (const i32v3& c : chunks) {
+        min.y = openvoxm::min(min.y, c.y * CHUNK_WIDTH - 1);
+        max.y = openvoxm::max(max.y, c.y * CHUNK_WIDTH + CHUNK_WIDTH + 1);
+    }
+    i32v3 size = max - min + i32v3(1);
+    std::vector<i8> volume((size_t)size.x * size.y * size.z);
+    for (i32 y = 0; y < size.y; y++) {
+        for (i32 z = 0; z < size.z; z++) {
+            for (i32 x = 0; x < size.x; x++) volume[((size_t)y * size.z + z) * size.x + x] = test::getTerrainDensity(min + i32v3(x, y, z));
+        }
+    }
+    Result r = meshChunks(mesher, chunks, 0, [&](const i32v3& p) {
+        i32v3 l = p - min;
+        return volume[((size_t)l.y * size.z + l.z) * size.x + l.x];
+    });
+    std::printf("LOD 0 from a stored i8 volume  %.3f ms/chunk  %.2f Mtri/s\n", r.msPerChunk, r.triangles / (r.msPerChunk * 128 * 1e3));
+    return 0;
+}
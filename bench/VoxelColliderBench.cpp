@@ -0,0 +1,44 @@
+#include <cstdio>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "physics/VoxelCollider.h"
+
+using namespace openvox;
+
+// Walking bodies over rolling terrain, stepped at 20 Hz through VoxelCollider::step.
+int main() {
+    ChunkMap map;
+    test::buildTerrain(map, i32v3(-4, -1, -4), i32v3(3, 1, 3));
+    VoxelCollider collider(&map);
+
+    const int counts[] = { 1000, 10000 };
+    const int ticks = 100;
+    for (int count : counts) {
+        CollisionBatch batch;
+        batch.reserve(count);
+        test::Random random(51);
+        for (int i = 0; i < count; i++) {
+            f32 x = random.range(-120.0f, 120.0f);
+            f32 z = random.range(-120.0f, 120.0f);
+            size_t b = batch.add(f32v3(x, (f32)test::getTerrainHeight((i32)x, (i32)z) + 2.0f, z), f32v3(0.3f, 0.9f, 0.3f), 0.6f);
+            batch.setVelocity(b, f32v3(random.range(-4.0f, 4.0f), 0.0f, random.range(-4.0f, 4.0f)));
+        }
+        // Settle onto the ground first so the timed ticks are steady state walking
+        for (int i = 0; i < 20; i++) collider.step(batch, 1.0f / 20.0f);
+
+        bench::Timer timer;
+        for (int i = 0; i < ticks; i++) {
+            // Keep walking after bumping into slopes
+            for (size_t b = 0; b < batch.size(); b++) {
+                if (batch.velX[b] == 0.0f) batch.velX[b] = (b & 1) ? 3.0f : -3.0f;
+                if (batch.velZ[b] == 0.0f) batch.velZ[b] = (b & 2) ? 3.0f : -3.0f;
+            }
+            collider.step(batch, 1.0f / 20.0f);
+        }
+        double s = timer.getSeconds();
+        std::printf("%6d bodies  %.3f ms/tick  %.2f M entity-steps/s\n", count, s * 1000.0 / ticks, count * (double)ticks / s / 1e6);
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <cstdio>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/VoxelCursor.h"
+
+using namespace openvox;
+
+namespace {
+    const int REPEATS = 5;
+    const i32 REGION = 3 * CHUNK_WIDTH; ///< Voxels along each axis of the loaded chunks
+    const i32v3 REGION_MIN(-CHUNK_WIDTH);
+    const u8 SKY_LIGHT = 15;
+
+    size_t getLightIndex(const i32v3& p) {
+        i32v3 l = p - REGION_MIN;
+        return ((size_t)l.y * REGION + l.z) * REGION + l.x;
+    }
+    bool isInRegion(const i32v3& p) {
+        i32v3 l = p - REGION_MIN;
+        return (u32)l.x < (u32)REGION && (u32)l.y < (u32)REGION && (u32)l.z < (u32)REGION;
+    }
+
+    /*! @brief Stand-in for light propagation: sky light enters the top layer of the region and
+    * floods down and sideways through air, one level less per step.
+    *
+    * @param getFaceBlock: Gets the block across a face of a voxel, treating unloaded as solid.
+    * @return Number of voxels lit.
+    */
+    template<typename F>
+    size_t floodLight(OUT std::vector<u8>& light, F getFaceBlock) {
+        light.assign((size_t)REGION * REGION * REGION, 0);
+        std::vector<i32v3> queue;
+        for (i32 z = 0; z < REGION; z++) {
+            for (i32 x = 0; x < REGION; x++) {
+                i32v3 p = REGION_MIN + i32v3(x, REGION - 1, z);
+                light[getLightIndex(p)] = SKY_LIGHT;
+                queue.push_back(p);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); head++) {
+            i32v3 p = queue[head];
+            u8 level = light[getLightIndex(p)];
+            if (level <= 1) continue;
+            for (int f = 0; f < VOXEL_FACE_NEIGHBORS; f++) {
+                i32v3 q = p + i32v3(VOXEL_NEIGHBOR_OFFSETS[f][0], VOXEL_NEIGHBOR_OFFSETS[f][1], VOXEL_NEIGHBOR_OFFSETS[f][2]);
+                if (!isInRegion(q) || getFaceBlock(p, f) != BLOCK_AIR) continue;
+                u8& l = light[getLightIndex(q)];
+                if (l >= level - 1) continue;
+                l = level - 1;
+                queue.push_back(q);
+            }
+        }
+        return queue.size();
+    }
+}
+
+// 3x3x3 loaded chunks of the rolling test terrain on one core. Stand-ins for a block mesher
+// and for light propagation, each with ChunkMap::getBlock and with a VoxelCursor.
+int main() {
+    ChunkMap map;
+    test::buildTerrain(map, i32v3(-1), i32v3(1));
+
+    // 26 neighbors of every solid voxel of the center chunk, as a mesher with smooth lighting reads them
+    u32 mapSolid = 0, cursorSolid = 0;
+    double mapMs = bench::bestOf(REPEATS, [&] {
+        mapSolid = 0;
+        for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+            for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                    i32v3 p(x, y, z);
+                    if (map.getBlock(p) == BLOCK_AIR) continue;
+                    for (int n = 0; n < VOXEL_NEIGHBORS; n++) {
+                        mapSolid += map.getBlock(p + i32v3(VOXEL_NEIGHBOR_OFFSETS[n][0], VOXEL_NEIGHBOR_OFFSETS[n][1],
+                                                           VOXEL_NEIGHBOR_OFFSETS[n][2])) != BLOCK_AIR;
+                    }
+                }
+            }
+        }
+        bench::keep(mapSolid);
+    });
+    double cursorMs = bench::bestOf(REPEATS, [&] {
+        cursorSolid = 0;
+        VoxelCursor cursor(&map, i32v3(0));
+        for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+            for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                    cursor.setPosition(i32v3(x, y, z));
+                    if (cursor.getBlock() == BLOCK_AIR) continue;
+                    for (int n = 0; n < VOXEL_NEIGHBORS; n++) cursorSolid += cursor.getNeighborBlock(n) != BLOCK_AIR;
+                }
+            }
+        }
+        bench::keep(cursorSolid);
+    });
+    std::printf("26-neighbor reads of %u solid voxels  %6.2f ms getBlock  %6.2f ms cursor  %.1fx\n",
+                map.getChunk(i32v3(0))->getOccupancy().getCount(), mapMs, cursorMs, mapMs / cursorMs);
+
+    std::vector<u8> mapLight, cursorLight;
+    size_t lit = 0;
+    mapMs = bench::bestOf(REPEATS, [&] {
+        lit = floodLight(mapLight, [&](const i32v3& p, int f) {
+            return map.getBlock(p + i32v3(VOXEL_NEIGHBOR_OFFSETS[f][0], VOXEL_NEIGHBOR_OFFSETS[f][1], VOXEL_NEIGHBOR_OFFSETS[f][2]), 1);
+        });
+    });
+    VoxelCursor cursor(&map, REGION_MIN);
+    cursorMs = bench::bestOf(REPEATS, [&] {
+        floodLight(cursorLight, [&](const i32v3& p, int f) {
+            // Consecutive faces share p, so the cursor only moves once per voxel
+            if (cursor.getPosition() != p) cursor.setPosition(p);
+            return cursor.getNeighborBlock(f, 1);
+        });
+    });
+    std::printf("6-neighbor light flood of %zu voxels  %6.2f ms getBlock  %6.2f ms cursor  %.1fx\n", lit, mapMs, cursorMs,
+                mapMs / cursorMs);
+
+    if (mapSolid != cursorSolid || mapLight != cursorLight) {
+        std::printf("MISMATCH between getBlock and cursor results\n");
+        return 1;
+    }
+    return 0;
+}
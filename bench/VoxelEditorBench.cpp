@@ -0,0 +1,67 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "BenchHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/VoxelEditor.h"
+
+using namespace openvox;
+
+// A 100^3 box fill and a radius-50 sphere carve over 4x4x4 loaded chunks, each
+// followed by one commit, compared with the same edits through ChunkMap::setBlock.
+int main() {
+    ChunkMap map;
+    for (i32 y = 0; y < 4; y++) {
+        for (i32 z = 0; z < 4; z++) {
+            for (i32 x = 0; x < 4; x++) map.createChunk(i32v3(x, y, z));
+        }
+    }
+    VoxelEditor editor(&map);
+    size_t events = 0, chunks = 0;
+    auto* listener = editor.onCommit.addFunctor([&](Sender, const VoxelEditBatch& b) {
+        events++;
+        chunks = b.chunks.size();
+    });
+
+    size_t filled = 0, carved = 0;
+    BlockID id = 1;
+    double fillMs = bench::bestOf(10, [&] {
+        filled = editor.fillBox(i32v3(0), i32v3(99), id);
+        editor.commit();
+        id = id == 1 ? 2 : 1;
+    });
+    std::printf("fill box      %zu voxels, %zu chunks, %zu events for 11 commits: %.2f ms\n", filled, chunks, events, fillMs);
+
+    // The box is refilled before every carve, outside the timed part
+    double carveMs = 1e300;
+    for (int i = 0; i < 10; i++) {
+        editor.fillBox(i32v3(0), i32v3(100), 1);
+        editor.commit();
+        bench::Timer t;
+        carved = editor.fillSphere(i32v3(50), 50.0f, BLOCK_AIR);
+        editor.commit();
+        carveMs = std::min(carveMs, t.getMilliseconds());
+    }
+    size_t expected = 0;
+    for (i32 z = -50; z <= 50; z++) {
+        for (i32 y = -50; y <= 50; y++) {
+            for (i32 x = -50; x <= 50; x++) expected += x * x + y * y + z * z <= 2500 ? 1 : 0;
+        }
+    }
+    std::printf("carve sphere  %zu voxels (brute force %zu), %zu chunks: %.2f ms\n", carved, expected, chunks, carveMs);
+
+    double setBlockMs = bench::bestOf(3, [&] {
+        for (i32 y = 0; y < 100; y++) {
+            for (i32 z = 0; z < 100; z++) {
+                for (i32 x = 0; x < 100; x++) map.setBlock(i32v3(x, y, z), id);
+            }
+        }
+        id = id == 1 ? 2 : 1;
+    });
+    std::printf("setBlock box  1000000 voxels: %.2f ms\n", setBlockMs);
+
+    editor.onCommit -= *listener;
+    delete listener;
+    return 0;
+}
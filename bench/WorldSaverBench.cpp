@@ -0,0 +1,105 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "BenchHarness.h"
+#include "TestFiles.h"
+#include "TestWorld.h"
+
+#include "io/RegionStore.h"
+#include "io/WorldSaver.h"
+#include "voxel/ChunkMap.h"
+
+using namespace openvox;
+
+namespace {
+    const i32 HEIGHT = 4;
+    const i32 EDIT_AREA = 12; ///< Width in chunks of the area players edit, 576 chunks with the height
+    const int EDITS_PER_TICK = 2000;
+    const f64 TICK = 0.05;
+}
+
+// A terrain world, 50k chunks unless another count is given (it takes ~3.5 GB), saved in the
+// background while ticks at 20/s make 2000 edits each in a 576 chunk area: how long the
+// snapshot pauses the caller, the save itself, the clones it costs and the ticks around it.
+int main(int argc, char** argv) {
+    int target = argc > 1 ? std::atoi(argv[1]) : 50000;
+    i32 width = 1;
+    while ((width + 1) * (width + 1) * HEIGHT <= target) width++;
+
+    test::TempDirectory dir("world_saver_bench");
+    ChunkMap map;
+    test::buildTerrain(map, i32v3(0), i32v3(width - 1, HEIGHT - 1, width - 1), 1, 56, 24.0f);
+    std::printf("world           %zu chunks\n", map.getChunkCount());
+
+    u64 sum = 0;
+    bench::Timer t;
+    for (auto& it : map.getChunks()) {
+        const BlockID* b = it.second->getBlockData();
+        for (int i = 0; i < CHUNK_SIZE; i++) sum += b[i];
+    }
+    f64 readMs = t.getMilliseconds();
+    bench::keep(sum);
+
+    test::Random random(68);
+    i32 areaVoxels = EDIT_AREA * CHUNK_WIDTH;
+    auto tick = [&]() {
+        for (int i = 0; i < EDITS_PER_TICK; i++) {
+            i32v3 p(random.range(0, areaVoxels - 1), random.range(0, HEIGHT * CHUNK_WIDTH - 1), random.range(0, areaVoxels - 1));
+            map.setBlock(p, (BlockID)random.range(0, 9));
+        }
+    };
+    // Ticks run at the tick rate, timing the work of each
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    auto runTick = [&]() {
+        std::this_thread::sleep_until(next);
+        next += std::chrono::milliseconds((int)(TICK * 1000));
+        bench::Timer tt;
+        tick();
+        return tt.getMilliseconds();
+    };
+    f64 before = 0.0;
+    for (int i = 0; i < 40; i++) before += runTick();
+    before /= 40;
+
+    std::unordered_map<i32v3, const ChunkData*, PositionHash> data;
+    for (auto& it : map.getChunks()) data[it.first] = it.second->getData();
+    RegionStore regions;
+    regions.open(dir.getPath());
+    WorldSaver saver;
+    saver.save(map, regions);
+    f64 first = runTick();
+    f64 during = 0.0;
+    int ticks = 0;
+    while (saver.isSaving()) {
+        during += runTick();
+        ticks++;
+    }
+    saver.wait();
+    const WorldSaveStats& stats = saver.getStats();
+    size_t clones = 0;
+    for (auto& it : map.getChunks()) clones += it.second->getData() != data[it.first] ? 1 : 0;
+    u64 bytes = 0;
+    for (const std::string& name : dir.list()) bytes += test::readFile(dir.getPath(name)).size();
+    regions.close();
+
+    // Every chunk loads back
+    size_t loaded = 0;
+    regions.open(dir.getPath());
+    for (auto& it : map.getChunks()) {
+        Chunk c(it.first);
+        loaded += regions.loadChunk(c) ? 1 : 0;
+    }
+
+    std::printf("snapshot        %.1f ms for %zu chunks (reading every voxel once takes %.0f ms)\n", stats.snapshotTime * 1000.0f,
+                stats.chunks, readMs);
+    std::printf("background save %.1f s, %.0f MB of region files, %zu of %zu chunks load back\n", stats.saveTime, bytes / 1e6,
+                loaded, map.getChunkCount());
+    std::printf("extra memory    %zu clones = %.1f MB\n", clones, clones * sizeof(ChunkData) / 1e6);
+    std::printf("ticks           %.2f ms before the save, %.1f ms the first tick after the snapshot, %.2f ms average over "
+                "the %d ticks during the save\n", before, first, ticks ? during / ticks : 0.0, ticks);
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <string>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "io/Serialization.hpp"
+#include "voxel/BlockRegistry.h"
+
+using namespace openvox;
+
+namespace {
+    const int BLOCKS = 300;
+
+    /// Definitions with every property drawn at random
+    std::vector<BlockDefinition> makeDefinitions(test::Random& random) {
+        std::vector<BlockDefinition> definitions(BLOCKS);
+        for (int i = 0; i < BLOCKS; i++) {
+            BlockDefinition& d = definitions[i];
+            d.name = "block_" + std::to_string(i);
+            d.flags = (u8)random.range(0, (1 << BLOCK_FLAG_COUNT) - 1);
+            d.lightEmission = (u8)random.range(0, 15);
+            d.renderLayer = (BlockRenderLayer)random.range(0, (int)BlockRenderLayer::TRANSLUCENT);
+            for (int f = 0; f < VOXEL_FACE_COUNT; f++) d.textures[f] = (u16)random.range(0, 4095);
+        }
+        return definitions;
+    }
+
+    void registerAll(BlockRegistry& registry, const std::vector<BlockDefinition>& definitions) {
+        for (const BlockDefinition& d : definitions) registry.registerBlock(d);
+    }
+
+    /// Checks the baked tables and the definitions of a registry against what was registered
+    bool matches(const BlockRegistry& registry, const std::vector<BlockDefinition>& definitions) {
+        if (registry.getBlockCount() != definitions.size() + 1) return false;
+        for (size_t i = 0; i < definitions.size(); i++) {
+            const BlockDefinition& d = definitions[i];
+            BlockID id = (BlockID)(i + 1);
+            if (registry.getID(d.name) != id || registry.getDefinition(id).name != d.name) return false;
+            for (int f = 0; f < BLOCK_FLAG_COUNT; f++) {
+                bool set = (d.flags & getBlockFlagBit((BlockFlag)f)) != 0;
+                if (registry.hasFlag(id, (BlockFlag)f) != set) return false;
+                if ((((registry.getFlagBits((BlockFlag)f)[id >> 6] >> (id & 63)) & 1) != 0) != set) return false;
+            }
+            if (registry.getDefinition(id).flags != d.flags) return false;
+            if (registry.getLightEmission(id) != d.lightEmission || registry.getDefinition(id).lightEmission != d.lightEmission) return false;
+            if (registry.getRenderLayer(id) != d.renderLayer || registry.getDefinition(id).renderLayer != d.renderLayer) return false;
+            for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+                if (registry.getTexture(id, (VoxelFace)f) != d.textures[f] || registry.getDefinition(id).textures[f] != d.textures[f]) return false;
+            }
+        }
+        return registry.isOpaque(BLOCK_AIR) == false && registry.isSolid(BLOCK_AIR) == false &&
+               registry.getRenderLayer(BLOCK_AIR) == BlockRenderLayer::NONE;
+    }
+
+    /// Checks that a failed load left the registry as it was built: air alone and open
+    bool isUntouched(BlockRegistry& registry) {
+        return !registry.isFrozen() && registry.getBlockCount() == 1 && registry.getID("air") == BLOCK_AIR &&
+               registry.getID("block_0") == BLOCK_NONE;
+    }
+
+    /// Rewrites the trailing CRC so a change gets past the checksum
+    void resign(std::vector<u8>& blob) {
+        u32 crc = crc32(blob.data(), blob.size() - 4);
+        SerialTraits<u32>::store(&blob[blob.size() - 4], crc);
+    }
+}
+
+int main() {
+    test::run("registration keeps air at 0 and hands out IDs in order", [] {
+        BlockRegistry registry;
+        OPENVOX_CHECK(registry.getBlockCount() == 1 && registry.getID("air") == BLOCK_AIR);
+        OPENVOX_CHECK(registry.getDefinition(BLOCK_AIR).flags == getBlockFlagBit(BlockFlag::REPLACEABLE));
+        BlockDefinition stone;
+        stone.name = "stone";
+        OPENVOX_CHECK(registry.registerBlock(stone) == 1);
+        BlockDefinition glass;
+        glass.name = "glass";
+        glass.flags = getBlockFlagBit(BlockFlag::SOLID);
+        glass.renderLayer = BlockRenderLayer::TRANSLUCENT;
+        OPENVOX_CHECK(registry.registerBlock(glass) == 2);
+        // A taken name returns the first ID and keeps its definition
+        OPENVOX_CHECK(registry.registerBlock(glass) == 2 && registry.registerBlock(stone) == 1);
+        OPENVOX_CHECK(registry.getBlockCount() == 3 && registry.getID("dirt") == BLOCK_NONE);
+
+        registry.freeze();
+        OPENVOX_CHECK(registry.isFrozen());
+        OPENVOX_CHECK(registry.isOpaque(1) && registry.isSolid(1) && !registry.isOpaque(2) && registry.isSolid(2));
+        OPENVOX_CHECK(registry.hasFlag(BLOCK_AIR, BlockFlag::REPLACEABLE) && !registry.isSolid(BLOCK_AIR));
+        OPENVOX_CHECK(registry.getRenderLayer(2) == BlockRenderLayer::TRANSLUCENT);
+    });
+
+    test::run("frozen tables match the definitions of 300 random blocks", [] {
+        test::Random random(75);
+        std::vector<BlockDefinition> definitions = makeDefinitions(random);
+        BlockRegistry registry;
+        registerAll(registry, definitions);
+        registry.freeze();
+        OPENVOX_CHECK(matches(registry, definitions));
+    });
+
+    test::run("a saved blob loads back into the same tables and definitions", [] {
+        test::Random random(750);
+        std::vector<BlockDefinition> definitions = makeDefinitions(random);
+        BlockRegistry registry;
+        registerAll(registry, definitions);
+        registry.freeze();
+        std::vector<u8> blob;
+        registry.save(blob);
+
+        BlockRegistry loaded;
+        OPENVOX_CHECK(loaded.load(blob.data(), blob.size()));
+        OPENVOX_CHECK(loaded.isFrozen() && matches(loaded, definitions));
+        std::vector<u8> again;
+        loaded.save(again);
+        OPENVOX_CHECK(again == blob);
+    });
+
+    test::run("truncated, corrupted and out of range blobs are rejected without changes", [] {
+        test::Random random(751);
+        std::vector<BlockDefinition> definitions = makeDefinitions(random);
+        BlockRegistry registry;
+        registerAll(registry, definitions);
+        registry.freeze();
+        std::vector<u8> blob;
+        registry.save(blob);
+
+        size_t accepted = 0;
+        for (size_t size = 0; size < blob.size(); size++) {
+            BlockRegistry target;
+            if (target.load(blob.data(), size) || !isUntouched(target)) accepted++;
+        }
+        for (int i = 0; i < 2000; i++) {
+            std::vector<u8> bad = blob;
+            bad[random.range(0, (i32)bad.size() - 1)] ^= (u8)random.range(1, 255);
+            BlockRegistry target;
+            if (target.load(bad.data(), bad.size()) || !isUntouched(target)) accepted++;
+        }
+        OPENVOX_CHECK(accepted == 0);
+
+        // Values past the checksum still have to make sense. Tables sit at the end of the blob:
+        // light emission, then render layers, then VOXEL_FACE_COUNT textures per block, then the CRC.
+        size_t count = BLOCKS + 1;
+        size_t texturesStart = blob.size() - 4 - count * VOXEL_FACE_COUNT * 2;
+        size_t layersStart = texturesStart - count;
+        size_t lightStart = layersStart - count;
+        std::vector<u8> bad = blob;
+        bad[layersStart + 17] = (u8)BlockRenderLayer::TRANSLUCENT + 1;
+        resign(bad);
+        BlockRegistry layer;
+        OPENVOX_CHECK(!layer.load(bad.data(), bad.size()) && isUntouched(layer));
+        bad = blob;
+        bad[lightStart + 42] = 16;
+        resign(bad);
+        BlockRegistry light;
+        OPENVOX_CHECK(!light.load(bad.data(), bad.size()) && isUntouched(light));
+        // The first block has to stay air, which BLOCK_AIR stands for
+        bad = blob;
+        bad[4 + 4 + 2 + 1] = 'b';
+        resign(bad);
+        BlockRegistry air;
+        OPENVOX_CHECK(!air.load(bad.data(), bad.size()) && isUntouched(air));
+
+        // Untouched, a resigned blob still loads
+        bad = blob;
+        resign(bad);
+        BlockRegistry good;
+        OPENVOX_CHECK(good.load(bad.data(), bad.size()) && matches(good, definitions));
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,132 @@
+#include <map>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "sim/BlockUpdateScheduler.h"
+
+using namespace openvox;
+
+namespace {
+    struct Expected {
+        i32v3 position;
+        BlockUpdateType type;
+        BlockUpdateHandle handle;
+    };
+
+    bool samePosition(const BlockUpdate& a, const Expected& b) {
+        return a.position == b.position && a.type == b.type;
+    }
+}
+
+int main() {
+    test::run("random schedule and cancel match a reference", [] {
+        BlockUpdateScheduler scheduler;
+        // Fire tick -> updates due on it
+        std::multimap<u64, Expected> reference;
+        test::Random random(55);
+        std::vector<BlockUpdate> fired;
+        bool matched = true;
+        for (int t = 0; t < 70000; t++) {
+            for (int i = 0; i < 8; i++) {
+                // Mix of short delays and delays that cross every wheel level
+                u32 delay = (u32)random.range(0, 3) == 0 ? (u32)random.range(0, 70000) : (u32)random.range(0, 300);
+                Expected e;
+                e.position = i32v3(random.range(-200, 200), random.range(-64, 64), random.range(-200, 200));
+                e.type = (BlockUpdateType)random.range(0, 9);
+                e.handle = scheduler.schedule(e.position, e.type, delay);
+                reference.insert(std::make_pair(scheduler.getCurrentTick() + (delay ? delay : 1), e));
+            }
+            if (!reference.empty() && random.range(0, 1) == 0) {
+                auto it = reference.lower_bound(scheduler.getCurrentTick() + (u64)random.range(1, 70000));
+                if (it != reference.end()) {
+                    matched &= scheduler.cancel(it->second.handle);
+                    matched &= !scheduler.cancel(it->second.handle);
+                    reference.erase(it);
+                }
+            }
+
+            fired.clear();
+            scheduler.tick(fired);
+            auto range = reference.equal_range(scheduler.getCurrentTick());
+            size_t expected = 0;
+            for (auto it = range.first; it != range.second; ++it) {
+                expected++;
+                bool found = false;
+                for (const BlockUpdate& u : fired) found |= samePosition(u, it->second);
+                matched &= found && !scheduler.isPending(it->second.handle);
+            }
+            matched &= fired.size() == expected;
+            reference.erase(range.first, range.second);
+        }
+        OPENVOX_CHECK(matched);
+        OPENVOX_CHECK(scheduler.getPendingCount() == reference.size());
+    });
+
+    test::run("save and load resume relative delays", [] {
+        BlockUpdateScheduler a;
+        std::vector<BlockUpdate> fired;
+        for (int t = 0; t < 1000; t++) a.tick(fired);
+        a.schedule(i32v3(1, 2, 3), 4, 10);
+        a.schedule(i32v3(31, 31, 31), 5, 70000);
+        a.schedule(i32v3(40, 0, 0), 6, 20); // Other chunk
+        std::vector<u8> saved;
+        a.saveChunk(i32v3(0, 0, 0), saved);
+        OPENVOX_CHECK(a.unloadChunk(i32v3(0, 0, 0)) == 2);
+        OPENVOX_CHECK(a.getPendingCount() == 1);
+
+        BlockUpdateScheduler b;
+        OPENVOX_CHECK(b.loadChunk(i32v3(0, 0, 0), saved.data(), saved.size()) == saved.size());
+        OPENVOX_CHECK(b.getPendingCount(i32v3(0, 0, 0)) == 2);
+        fired.clear();
+        for (int t = 0; t < 9; t++) b.tick(fired);
+        OPENVOX_CHECK(fired.empty());
+        b.tick(fired);
+        OPENVOX_CHECK(fired.size() == 1 && fired[0].position == i32v3(1, 2, 3) && fired[0].type == 4);
+
+        // Truncated and out of range data is rejected without scheduling anything
+        BlockUpdateScheduler c;
+        OPENVOX_CHECK(c.loadChunk(i32v3(0, 0, 0), saved.data(), saved.size() - 1) == 0);
+        std::vector<u8> tooLong = saved;
+        tooLong[8] = tooLong[9] = tooLong[10] = tooLong[11] = 0xFF;
+        OPENVOX_CHECK(c.loadChunk(i32v3(0, 0, 0), tooLong.data(), tooLong.size()) == 0);
+        OPENVOX_CHECK(c.getPendingCount() == 0);
+    });
+
+    test::run("longest delays do not fire early", [] {
+        BlockUpdateScheduler scheduler;
+        std::vector<BlockUpdate> fired;
+        // Put the low 24 bits of the current tick at their maximum, the worst case for wrapping
+        while ((scheduler.getCurrentTick() & 0xFFFFFF) != 0xFFFFFF) scheduler.tick(fired);
+        BlockUpdateHandle atMax = scheduler.schedule(i32v3(0), 1, BLOCK_UPDATE_MAX_DELAY);
+        BlockUpdateHandle clamped = scheduler.schedule(i32v3(0), 2, 0xFFFFFFFFu);
+        // A wrapped fire tick would land in a lower wheel and fire within 2^24 ticks
+        for (u32 t = 0; t < (1u << 25); t++) scheduler.tick(fired);
+        OPENVOX_CHECK(fired.empty());
+        OPENVOX_CHECK(scheduler.isPending(atMax) && scheduler.isPending(clamped));
+
+        std::vector<u8> saved;
+        scheduler.saveChunk(i32v3(0), saved);
+        BlockUpdateScheduler reloaded;
+        OPENVOX_CHECK(reloaded.loadChunk(i32v3(0), saved.data(), saved.size()) == saved.size());
+    });
+
+    test::run("stale handles are harmless", [] {
+        BlockUpdateScheduler scheduler;
+        std::vector<BlockUpdate> fired;
+        BlockUpdateHandle h = scheduler.schedule(i32v3(5), 1, 1);
+        scheduler.tick(fired);
+        OPENVOX_CHECK(fired.size() == 1);
+        OPENVOX_CHECK(!scheduler.isPending(h));
+        // The freed timer is reused, the old handle must not cancel the new update
+        BlockUpdateHandle reused = scheduler.schedule(i32v3(6), 2, 5);
+        OPENVOX_CHECK(!scheduler.cancel(h));
+        OPENVOX_CHECK(scheduler.isPending(reused));
+        scheduler.clear();
+        OPENVOX_CHECK(!scheduler.isPending(reused));
+        OPENVOX_CHECK(scheduler.getPendingCount() == 0);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/Chunk.h"
+
+using namespace openvox;
+
+namespace {
+    typedef std::vector<BlockID> Blocks;
+
+    const i32v3 FACE_OFFSETS[VOXEL_FACE_COUNT] = { i32v3(-1, 0, 0), i32v3(1, 0, 0), i32v3(0, -1, 0),
+                                                   i32v3(0, 1, 0),  i32v3(0, 0, -1), i32v3(0, 0, 1) };
+
+    /// Blocks that are solid with a chance of density, in clumps of noise when clumped
+    Blocks makeBlocks(test::Random& random, f32 density, bool clumped) {
+        Blocks blocks(CHUNK_SIZE);
+        f32v3 offset(random.range(0.0f, 1000.0f), random.range(0.0f, 1000.0f), random.range(0.0f, 1000.0f));
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            bool solid;
+            if (clumped) {
+                i32v3 p = getVoxelPosition(i);
+                solid = test::getValueNoise(f32v3(p) + offset, 2, 1.0f / 8.0f) < density * 2.0f - 1.0f;
+            } else {
+                solid = random.unit() < density;
+            }
+            blocks[i] = solid ? (BlockID)random.range(1, 7) : (BlockID)BLOCK_AIR;
+        }
+        return blocks;
+    }
+
+    /// A few densities from empty to full, scattered and clumped
+    std::vector<Blocks> makeChunks(test::Random& random) {
+        std::vector<Blocks> chunks;
+        for (f32 density : { 0.0f, 0.02f, 0.5f, 0.98f, 1.0f }) chunks.push_back(makeBlocks(random, density, false));
+        for (f32 density : { 0.3f, 0.5f, 0.7f }) chunks.push_back(makeBlocks(random, density, true));
+        return chunks;
+    }
+
+    /// Local position of bit b of word w, from the layout documented on ChunkOccupancy
+    i32v3 getBitPosition(int w, int b) {
+        return i32v3((w % OCCUPANCY_ROW_WORDS) * 2 + (b >> 5), b & 31, w / OCCUPANCY_ROW_WORDS);
+    }
+
+    /// Per-voxel lookup one step across a face, wrapping into the neighbor chunk or air
+    bool isSolidAcross(const Blocks& blocks, const Blocks* neighbor, const i32v3& p, VoxelFace face) {
+        i32v3 q = p + FACE_OFFSETS[(int)face];
+        for (int i = 0; i < 3; i++) {
+            if (q[i] < 0 || q[i] >= CHUNK_WIDTH) {
+                return neighbor && (*neighbor)[getVoxelIndex(toLocalPosition(q))] != BLOCK_AIR;
+            }
+        }
+        return blocks[getVoxelIndex(q)] != BLOCK_AIR;
+    }
+
+    bool matches(const ChunkOccupancy& occupancy, const Blocks& blocks) {
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            if (occupancy.isSolid(i) != (blocks[i] != BLOCK_AIR)) return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    test::run("the mask and its column queries match the blocks voxel by voxel", [] {
+        test::Random random(73);
+        for (const Blocks& blocks : makeChunks(random)) {
+            ChunkOccupancy occupancy;
+            occupancy.build(blocks.data());
+            OPENVOX_CHECK(matches(occupancy, blocks));
+
+            u32 count = 0;
+            bool columnsMatch = true;
+            for (int z = 0; z < CHUNK_WIDTH; z++) {
+                for (int x = 0; x < CHUNK_WIDTH; x++) {
+                    u32 column = 0;
+                    int highest = -1;
+                    for (int y = 0; y < CHUNK_WIDTH; y++) {
+                        if (blocks[getVoxelIndex(x, y, z)] == BLOCK_AIR) continue;
+                        column |= 1u << y;
+                        highest = y;
+                        count++;
+                    }
+                    columnsMatch &= occupancy.getColumn(x, z) == column && occupancy.getHighest(x, z) == highest;
+                    for (int y = 0; y < CHUNK_WIDTH; y++) {
+                        int above = -1;
+                        for (int s = y; s < CHUNK_WIDTH && above < 0; s++) {
+                            if (blocks[getVoxelIndex(x, s, z)] != BLOCK_AIR) above = s;
+                        }
+                        columnsMatch &= occupancy.findSolidAbove(x, y, z) == above;
+                    }
+                }
+            }
+            OPENVOX_CHECK(columnsMatch);
+            OPENVOX_CHECK(occupancy.getCount() == count);
+            OPENVOX_CHECK(occupancy.isEmpty() == (count == 0) && occupancy.isFull() == (count == CHUNK_SIZE));
+        }
+    });
+
+    test::run("face kernels match per-voxel neighbor lookups, with and without a neighbor", [] {
+        test::Random random(730);
+        std::vector<Blocks> chunks = makeChunks(random);
+        for (size_t c = 0; c < chunks.size(); c++) {
+            const Blocks& blocks = chunks[c];
+            const Blocks& neighborBlocks = chunks[(c + 3) % chunks.size()];
+            ChunkOccupancy occupancy, neighborOccupancy;
+            occupancy.build(blocks.data());
+            neighborOccupancy.build(neighborBlocks.data());
+            for (int f = 0; f < VOXEL_FACE_COUNT; f++) {
+                VoxelFace face = (VoxelFace)f;
+                for (bool hasNeighbor : { false, true }) {
+                    const ChunkOccupancy* n = hasNeighbor ? &neighborOccupancy : nullptr;
+                    u64 faces[OCCUPANCY_WORD_COUNT];
+                    u32 visible = occupancy.getVisibleFaces(face, n, faces);
+                    u32 expectedVisible = 0;
+                    bool wordsMatch = true;
+                    for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) {
+                        u64 across = 0, expectedFaces = 0;
+                        for (int b = 0; b < 64; b++) {
+                            i32v3 p = getBitPosition(w, b);
+                            bool solidAcross = isSolidAcross(blocks, hasNeighbor ? &neighborBlocks : nullptr, p, face);
+                            across |= (u64)solidAcross << b;
+                            if (blocks[getVoxelIndex(p)] != BLOCK_AIR && !solidAcross) {
+                                expectedFaces |= 1ull << b;
+                                expectedVisible++;
+                            }
+                        }
+                        wordsMatch &= occupancy.getNeighborWord(w, face, n) == across && faces[w] == expectedFaces;
+                    }
+                    OPENVOX_CHECK(wordsMatch);
+                    OPENVOX_CHECK(visible == expectedVisible);
+                }
+            }
+        }
+    });
+
+    test::run("box updates and single bits match a full rebuild", [] {
+        test::Random random(731);
+        Blocks blocks = makeBlocks(random, 0.5f, true);
+        ChunkOccupancy occupancy;
+        occupancy.build(blocks.data());
+        for (int i = 0; i < 200; i++) {
+            i32v3 min, max;
+            for (int k = 0; k < 3; k++) {
+                min[k] = random.range(0, CHUNK_WIDTH - 1);
+                max[k] = random.range(min[k], std::min(min[k] + 12, CHUNK_WIDTH - 1));
+            }
+            BlockID id = random.range(0, 2) == 0 ? (BlockID)BLOCK_AIR : (BlockID)random.range(1, 7);
+            for (int y = min.y; y <= max.y; y++) {
+                for (int z = min.z; z <= max.z; z++) {
+                    for (int x = min.x; x <= max.x; x++) blocks[getVoxelIndex(x, y, z)] = id;
+                }
+            }
+            occupancy.update(blocks.data(), min, max);
+            int index = random.range(0, CHUNK_SIZE - 1);
+            blocks[index] = blocks[index] == BLOCK_AIR ? 1 : BLOCK_AIR;
+            occupancy.set(index, blocks[index] != BLOCK_AIR);
+        }
+        ChunkOccupancy rebuilt;
+        rebuilt.build(blocks.data());
+        OPENVOX_CHECK(matches(occupancy, blocks));
+        bool same = true;
+        for (int w = 0; w < OCCUPANCY_WORD_COUNT; w++) same &= occupancy.getWords()[w] == rebuilt.getWords()[w];
+        OPENVOX_CHECK(same);
+    });
+
+    test::run("forEachVoxel visits every solid voxel once in word order", [] {
+        test::Random random(732);
+        for (const Blocks& blocks : makeChunks(random)) {
+            ChunkOccupancy occupancy;
+            occupancy.build(blocks.data());
+            std::vector<int> visits(CHUNK_SIZE, 0);
+            int lastWord = -1;
+            bool ordered = true;
+            ChunkOccupancy::forEachVoxel(occupancy.getWords(), [&](int index) {
+                visits[index]++;
+                ordered &= ChunkOccupancy::getWordIndex(index) >= lastWord;
+                lastWord = ChunkOccupancy::getWordIndex(index);
+            });
+            bool once = true;
+            for (int i = 0; i < CHUNK_SIZE; i++) once &= visits[i] == (blocks[i] != BLOCK_AIR ? 1 : 0);
+            OPENVOX_CHECK(once && ordered);
+        }
+    });
+
+    test::run("chunks keep the mask current through setBlock, fill and copy-on-write", [] {
+        test::Random random(733);
+        Chunk chunk(i32v3(0));
+        OPENVOX_CHECK(chunk.getOccupancy().isEmpty());
+        chunk.fill(3);
+        OPENVOX_CHECK(chunk.getOccupancy().isFull());
+        Blocks blocks(chunk.getBlockData(), chunk.getBlockData() + CHUNK_SIZE);
+        for (int i = 0; i < 5000; i++) {
+            int index = random.range(0, CHUNK_SIZE - 1);
+            BlockID id = random.range(0, 1) ? (BlockID)BLOCK_AIR : (BlockID)random.range(1, 7);
+            chunk.setBlock(index, id);
+            blocks[index] = id;
+        }
+        OPENVOX_CHECK(matches(chunk.getOccupancy(), blocks));
+
+        // A snapshot keeps the mask of its version while the chunk moves on
+        const ChunkData* snapshot = chunk.getData()->acquire();
+        Blocks before = blocks;
+        BlockID* data = chunk.getMutableBlockData();
+        for (int y = 4; y <= 9; y++) {
+            for (int z = 2; z <= 20; z++) {
+                for (int x = 7; x <= 30; x++) data[getVoxelIndex(x, y, z)] = blocks[getVoxelIndex(x, y, z)] = BLOCK_AIR;
+            }
+        }
+        chunk.updateOccupancy(i32v3(7, 4, 2), i32v3(30, 9, 20));
+        OPENVOX_CHECK(snapshot != chunk.getData());
+        OPENVOX_CHECK(matches(chunk.getOccupancy(), blocks) && matches(snapshot->occupancy, before));
+        snapshot->release();
+    });
+
+    return test::finish();
+}
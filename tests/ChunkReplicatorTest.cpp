@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "net/ChunkReplicator.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 WORLD_MAX(3, 1, 3);
+
+    /// A server world replicated to clients over a loopback transport
+    struct Session {
+        ChunkMap server;
+        ChunkReplicator replicator;
+        LoopbackTransport transport;
+        std::vector<std::unique_ptr<ChunkMap> > clientMaps;
+        std::vector<std::unique_ptr<ChunkReceiver> > receivers;
+        int outOfSync = 0;
+        int malformed = 0;
+
+        Session(u32 clients) : replicator(&server) {
+            test::buildTerrain(server, i32v3(0), WORLD_MAX, 1, 30, 10.0f);
+            for (ClientID c = 0; c < clients; c++) {
+                clientMaps.emplace_back(new ChunkMap);
+                receivers.emplace_back(new ChunkReceiver(clientMaps.back().get()));
+                replicator.addClient(c);
+                for (auto& it : server.getChunks()) replicator.subscribe(c, it.first);
+            }
+        }
+
+        void flush() {
+            replicator.flush([this](ClientID c, const u8* data, size_t size) { transport.send(c, data, size); });
+        }
+        /// Delivers queued messages, asking for a resync when a client falls out of sync
+        void deliver(int dropFrom = -1) {
+            std::vector<u8> message;
+            for (ClientID c = 0; c < receivers.size(); c++) {
+                bool dropped = false;
+                while (transport.receive(c, message)) {
+                    if ((int)c == dropFrom && !dropped && message[0] == CHUNK_MESSAGE_DELTA) {
+                        dropped = true;
+                        continue;
+                    }
+                    i32v3 pos;
+                    ChunkReceiver::Result r = receivers[c]->receive(message.data(), message.size(), &pos);
+                    if (r == ChunkReceiver::Result::OUT_OF_SYNC) {
+                        outOfSync++;
+                        replicator.resync(c, pos);
+                    }
+                    malformed += r == ChunkReceiver::Result::MALFORMED ? 1 : 0;
+                }
+            }
+        }
+        bool clientMatches(ClientID c) const {
+            for (auto& it : server.getChunks()) {
+                const Chunk* chunk = clientMaps[c]->getChunk(it.first);
+                if (!chunk || !std::equal(chunk->getBlockData(), chunk->getBlockData() + CHUNK_SIZE, it.second->getBlockData())) {
+                    return false;
+                }
+                if (receivers[c]->getVersion(it.first) != replicator.getVersion(it.first)) return false;
+            }
+            return true;
+        }
+    };
+
+    void setBlock(Session& s, const i32v3& p, BlockID id) {
+        if (s.server.setBlock(p, id)) s.replicator.onBlockChanged(p);
+    }
+    i32v3 randomVoxel(test::Random& random) {
+        return i32v3(random.range(0, (WORLD_MAX.x + 1) * CHUNK_WIDTH - 1), random.range(0, (WORLD_MAX.y + 1) * CHUNK_WIDTH - 1),
+                     random.range(0, (WORLD_MAX.z + 1) * CHUNK_WIDTH - 1));
+    }
+}
+
+int main() {
+    test::run("edit storm keeps every client in sync", [] {
+        Session s(8);
+        s.flush();
+        s.deliver();
+        OPENVOX_CHECK(s.replicator.getFullChunksSent() == 8 * s.server.getChunkCount());
+        bool synced = true;
+        for (ClientID c = 0; c < 8; c++) synced &= s.clientMatches(c);
+        OPENVOX_CHECK(synced);
+
+        VoxelEditor editor(&s.server);
+        auto* listener = editor.onCommit.addFunctor([&s](Sender, const VoxelEditBatch& b) { s.replicator.onEdit(b); });
+        test::Random random(61);
+        std::vector<i32v3> recent;
+        for (int tick = 0; tick < 80; tick++) {
+            recent.clear();
+            for (int i = 0; i < 300; i++) {
+                // A third rewrite voxels already changed this tick
+                i32v3 p = (i % 3 == 2 && !recent.empty()) ? recent[random.range(0, (i32)recent.size() - 1)] : randomVoxel(random);
+                recent.push_back(p);
+                setBlock(s, p, (BlockID)random.range(0, 6));
+            }
+            if (tick % 20 == 10) {
+                editor.fillSphere(randomVoxel(random), 10.0f, BLOCK_AIR);
+                editor.commit();
+            }
+            s.flush();
+            // Client 3 loses a delta once and has to resync
+            s.deliver(tick == 30 ? 3 : -1);
+        }
+        // Resyncs requested by the last delivery go out with one more flush
+        s.flush();
+        s.deliver();
+        editor.onCommit -= *listener;
+        delete listener;
+
+        synced = true;
+        for (ClientID c = 0; c < 8; c++) synced &= s.clientMatches(c);
+        OPENVOX_CHECK(synced);
+        OPENVOX_CHECK(s.outOfSync > 0);
+        OPENVOX_CHECK(s.malformed == 0);
+        OPENVOX_CHECK(s.replicator.getDeltasSent() > s.replicator.getFullChunksSent());
+    });
+
+    test::run("large changes send the whole chunk", [] {
+        Session s(1);
+        s.flush();
+        s.deliver();
+        u64 fullBefore = s.replicator.getFullChunksSent();
+        u64 bytesBefore = s.transport.getBytesSent();
+        // One voxel costs a small delta
+        setBlock(s, i32v3(5, 40, 5), 7);
+        s.flush();
+        OPENVOX_CHECK(s.transport.getBytesSent() - bytesBefore < 32);
+        OPENVOX_CHECK(s.replicator.getFullChunksSent() == fullBefore);
+        s.deliver();
+
+        // Past the threshold the chunk is sent whole, and the client still matches
+        s.replicator.setFullChunkThreshold(100);
+        test::Random random(610);
+        for (int i = 0; i < 150; i++) setBlock(s, i32v3(random.range(32, 63), random.range(0, 31), random.range(0, 31)), (BlockID)random.range(1, 9));
+        s.flush();
+        OPENVOX_CHECK(s.replicator.getFullChunksSent() == fullBefore + 1);
+        s.deliver();
+        OPENVOX_CHECK(s.clientMatches(0));
+    });
+
+    test::run("subscriptions control what is sent", [] {
+        Session s(2);
+        s.flush();
+        s.deliver();
+        s.replicator.unsubscribe(1, i32v3(0));
+        setBlock(s, i32v3(1, 1, 1), 9);
+        s.flush();
+        OPENVOX_CHECK(s.transport.getQueuedCount(0) == 1);
+        OPENVOX_CHECK(s.transport.getQueuedCount(1) == 0);
+        s.deliver();
+        OPENVOX_CHECK(s.clientMaps[1]->getBlock(i32v3(1, 1, 1)) != 9);
+
+        // Subscribing again starts with the full chunk
+        u64 fullBefore = s.replicator.getFullChunksSent();
+        s.replicator.subscribe(1, i32v3(0));
+        s.flush();
+        s.deliver();
+        OPENVOX_CHECK(s.replicator.getFullChunksSent() == fullBefore + 1);
+        OPENVOX_CHECK(s.clientMatches(1));
+
+        s.replicator.removeClient(1);
+        setBlock(s, i32v3(2, 1, 1), 9);
+        s.flush();
+        OPENVOX_CHECK(s.transport.getQueuedCount(1) == 0);
+    });
+
+    test::run("malformed messages leave chunks unchanged", [] {
+        Session s(1);
+        s.flush();
+        std::vector<std::vector<u8> > messages;
+        std::vector<u8> m;
+        while (s.transport.receive(0, m)) messages.push_back(m);
+        for (const std::vector<u8>& msg : messages) s.receivers[0]->receive(msg.data(), msg.size());
+
+        test::Random random(611);
+        for (int i = 0; i < 40; i++) setBlock(s, randomVoxel(random), (BlockID)random.range(0, 6));
+        s.flush();
+        std::vector<u8> delta;
+        while (s.transport.receive(0, m)) {
+            if (m[0] == CHUNK_MESSAGE_DELTA) delta = m;
+        }
+        OPENVOX_CHECK(!delta.empty());
+        i32v3 pos((i32)(delta[1] | delta[2] << 8), (i32)(delta[5] | delta[6] << 8), (i32)(delta[9] | delta[10] << 8));
+        const Chunk* chunk = s.clientMaps[0]->getChunk(pos);
+        std::vector<BlockID> before(chunk->getBlockData(), chunk->getBlockData() + CHUNK_SIZE);
+
+        // Every truncation of a delta and of a full chunk is rejected without side effects
+        int accepted = 0;
+        for (size_t n = 0; n + 1 < delta.size(); n++) {
+            accepted += s.receivers[0]->receive(delta.data(), n) != ChunkReceiver::Result::MALFORMED ? 1 : 0;
+        }
+        const std::vector<u8>& full = messages[0];
+        for (size_t n = 0; n + 1 < full.size(); n += 7) {
+            accepted += s.receivers[0]->receive(full.data(), n) == ChunkReceiver::Result::APPLIED ? 1 : 0;
+        }
+        std::vector<u8> badType = delta;
+        badType[0] = 9;
+        accepted += s.receivers[0]->receive(badType.data(), badType.size()) != ChunkReceiver::Result::MALFORMED ? 1 : 0;
+        OPENVOX_CHECK(accepted == 0);
+        OPENVOX_CHECK(std::equal(before.begin(), before.end(), chunk->getBlockData()));
+
+        // Flipped bits may decode to other blocks but never crash or touch other chunks
+        for (int i = 0; i < 2000; i++) {
+            std::vector<u8> bad = messages[(size_t)random.range(0, (i32)messages.size() - 1)];
+            bad[(size_t)random.range(17, (i32)bad.size() - 1)] ^= (u8)(1 << random.range(0, 7));
+            ChunkMap scratch;
+            ChunkReceiver receiver(&scratch);
+            receiver.receive(bad.data(), bad.size());
+            OPENVOX_CHECK(scratch.getChunkCount() <= 1);
+        }
+        OPENVOX_CHECK(s.receivers[0]->receive(delta.data(), delta.size()) == ChunkReceiver::Result::APPLIED);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,207 @@
+#include <cstdio>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestMeshes.h"
+
+#include "mesh/DualContouringMesher.h"
+#include "mesh/TransvoxelMesher.h"
+
+using namespace openvox;
+
+namespace {
+    const f32v3 BOX_CENTER(50.0f, 46.0f, 47.0f);
+    const f32v3 BOX_HALF_SIZE(16.0f, 12.0f, 20.0f);
+    const f32 BOX_YAW = 0.6f;
+    const f32 BOX_PITCH = 0.35f;
+
+    f32 getBoxDistance(const f32v3& p) {
+        return test::getBoxDistance(p, BOX_CENTER, BOX_HALF_SIZE, BOX_YAW, BOX_PITCH);
+    }
+    /// The box half buried in the hills
+    f32 getSceneDistance(const f32v3& p) {
+        return openvoxm::min(getBoxDistance(p), test::getHillDistance(p));
+    }
+
+    i8 getBoxDensity(const i32v3& p) {
+        return test::getDistanceDensity(getBoxDistance(f32v3(p)));
+    }
+    i8 getSceneDensity(const i32v3& p) {
+        return test::getDistanceDensity(getSceneDistance(f32v3(p)));
+    }
+
+    /// Distance of the surface from the true one at triangle centroids and edge midpoints
+    struct SurfaceError {
+        f64 squareSum = 0.0;
+        f32 max = 0.0f;
+        size_t samples = 0;
+        size_t triangles = 0;
+
+        void add(const i32v3& chunkPos, const PackedMesh& mesh, f32 (*distance)(const f32v3&)) {
+            f32v3 offset(chunkPos * CHUNK_WIDTH);
+            for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+                f32v3 p[3];
+                for (int k = 0; k < 3; k++) p[k] = offset + f32v3(mesh.vertices[mesh.indices[i + k]].position) / (f32)PACKED_POSITION_SCALE;
+                addSample(distance((p[0] + p[1] + p[2]) / 3.0f));
+                for (int k = 0; k < 3; k++) addSample(distance((p[k] + p[(k + 1) % 3]) * 0.5f));
+                triangles++;
+            }
+        }
+        void addSample(f32 d) {
+            squareSum += d * d;
+            max = openvoxm::max(max, openvoxm::abs(d));
+            samples++;
+        }
+        f32 getRms() const {
+            return (f32)std::sqrt(squareSum / openvoxm::max(samples, (size_t)1));
+        }
+    };
+
+    /// Meshes chunks 0 to 2 on every axis with dual contouring and welds them
+    test::MeshCheck meshScene(DualContouringMesher::DensityFunc density, f32 maxError, OUT SurfaceError& error,
+                              f32 (*distance)(const f32v3&)) {
+        DualContouringMesher mesher;
+        PackedMesh mesh;
+        // Seam vertices come out identical from both chunks. Chunks leave out the edges on their
+        // negative faces and take those a cell into their positive neighbors, so the open edges
+        // of the box lie within a cell of it.
+        test::MeshWelder welder(i32v3(0), i32v3(3 * CHUNK_WIDTH), 0, PACKED_POSITION_SCALE);
+        for (i32 z = 0; z < 3; z++) {
+            for (i32 y = 0; y < 3; y++) {
+                for (i32 x = 0; x < 3; x++) {
+                    mesher.mesh(i32v3(x, y, z), 0, density, mesh, maxError);
+                    OPENVOX_CHECK(mesh.indices.size() % 3 == 0 && mesh.vertices.size() <= mesher.getLeafVertexCount());
+                    welder.add(i32v3(x, y, z), 0, mesh);
+                    error.add(i32v3(x, y, z), mesh, distance);
+                }
+            }
+        }
+        return welder.check();
+    }
+
+    SurfaceError getMarchingCubesError() {
+        TransvoxelMesher mesher;
+        TransvoxelMesh mesh;
+        SurfaceError error;
+        for (i32 z = 0; z < 3; z++) {
+            for (i32 y = 0; y < 3; y++) {
+                for (i32 x = 0; x < 3; x++) {
+                    mesher.mesh(i32v3(x, y, z), 0, 0, getBoxDensity, mesh);
+                    error.add(i32v3(x, y, z), mesh, getBoxDistance);
+                }
+            }
+        }
+        return error;
+    }
+
+    void addVertices(const i32v3& chunkPos, const PackedMesh& mesh, OUT std::vector<f32v3>& vertices) {
+        for (const PackedVertex& v : mesh.vertices) vertices.push_back(f32v3(chunkPos * CHUNK_WIDTH) + f32v3(v.position) / (f32)PACKED_POSITION_SCALE);
+    }
+
+    /// Distance from the worst corner of the box to the closest vertex, in voxels
+    f32 getWorstCornerDistance(const std::vector<f32v3>& vertices) {
+        f32 worst = 0.0f;
+        for (int i = 0; i < 8; i++) {
+            f32v3 corner(i & 1 ? 1.0f : -1.0f, i & 2 ? 1.0f : -1.0f, i & 4 ? 1.0f : -1.0f);
+            corner *= BOX_HALF_SIZE;
+            // Inverse of the box rotation, pitch first
+            f32v3 r(corner.x, std::cos(BOX_PITCH) * corner.y + std::sin(BOX_PITCH) * corner.z,
+                    -std::sin(BOX_PITCH) * corner.y + std::cos(BOX_PITCH) * corner.z);
+            f32v3 world = BOX_CENTER + f32v3(std::cos(BOX_YAW) * r.x + std::sin(BOX_YAW) * r.z, r.y,
+                                             -std::sin(BOX_YAW) * r.x + std::cos(BOX_YAW) * r.z);
+            f32 closest = 1e9f;
+            for (const f32v3& v : vertices) closest = openvoxm::min(closest, openvoxm::length(v - world));
+            worst = openvoxm::max(worst, closest);
+        }
+        return worst;
+    }
+}
+
+int main() {
+    test::run("chunks weld into a closed manifold surface at every merge limit", [] {
+        const f32 limits[3] = { 0.0f, DEFAULT_DUAL_CONTOURING_MAX_ERROR, 0.2f };
+        size_t triangles[3];
+        for (int i = 0; i < 3; i++) {
+            SurfaceError error;
+            test::MeshCheck check = meshScene(getSceneDensity, limits[i], error, getSceneDistance);
+            std::printf("    maxError %.1f  %6zu triangles, %zu open, %zu non-manifold, %zu degenerate, %zu bad winding, "
+                        "error rms %.3f max %.3f\n", limits[i], check.triangles, check.openEdges, check.nonManifoldEdges,
+                        check.degenerate, check.badWinding, error.getRms(), error.max);
+            OPENVOX_CHECK(check.triangles > 1000 && check.boundaryEdges > 0);
+            OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.degenerate == 0);
+            // Slivers along the crease where the box meets the hills can face against their normals
+            OPENVOX_CHECK(check.badWinding * 500 < check.triangles);
+            OPENVOX_CHECK(error.max < 0.5f);
+            triangles[i] = check.triangles;
+        }
+        OPENVOX_CHECK(triangles[1] < triangles[0] && triangles[2] <= triangles[1]);
+    });
+
+    test::run("noise caves stay manifold at LOD 0 and 1 and with heavy merging", [] {
+        DualContouringMesher mesher;
+        PackedMesh mesh;
+        for (u32 lod = 0; lod <= 1; lod++) {
+            for (f32 maxError : { 0.0f, 1.0f }) {
+                i32 width = CHUNK_WIDTH << lod;
+                test::MeshWelder welder(i32v3(0, 64, 0), i32v3(3 * width, 64 + 3 * width, 3 * width), 0, PACKED_POSITION_SCALE << lod);
+                for (i32 z = 0; z < 3; z++) {
+                    for (i32 y = 0; y < 3; y++) {
+                        for (i32 x = 0; x < 3; x++) {
+                            i32v3 chunkPos(x, y + 64 / width, z);
+                            mesher.mesh(chunkPos, lod, test::getTestDensity, mesh, maxError);
+                            welder.add(chunkPos, lod, mesh);
+                        }
+                    }
+                }
+                test::MeshCheck check = welder.check();
+                OPENVOX_CHECK(check.triangles > 10000 && check.boundaryEdges > 0);
+                OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.degenerate == 0);
+                OPENVOX_CHECK(check.badWinding * 1000 < check.triangles);
+            }
+        }
+    });
+
+    test::run("cells keep the sharp edges and corners that marching cubes bevels", [] {
+        SurfaceError dc;
+        test::MeshCheck check = meshScene(getBoxDensity, DEFAULT_DUAL_CONTOURING_MAX_ERROR, dc, getBoxDistance);
+        OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.boundaryEdges == 0);
+        SurfaceError mc = getMarchingCubesError();
+        std::printf("    dual contouring rms %.3f max %.3f, %zu triangles; marching cubes rms %.3f max %.3f, %zu triangles\n",
+                    dc.getRms(), dc.max, dc.triangles, mc.getRms(), mc.max, mc.triangles);
+        OPENVOX_CHECK(dc.getRms() < mc.getRms() && dc.max < mc.max);
+
+        DualContouringMesher dcMesher;
+        TransvoxelMesher mcMesher;
+        PackedMesh dcMesh;
+        TransvoxelMesh mcMesh;
+        std::vector<f32v3> dcVertices, mcVertices;
+        for (i32 z = 0; z < 3; z++) {
+            for (i32 y = 0; y < 3; y++) {
+                for (i32 x = 0; x < 3; x++) {
+                    dcMesher.mesh(i32v3(x, y, z), 0, getBoxDensity, dcMesh);
+                    mcMesher.mesh(i32v3(x, y, z), 0, 0, getBoxDensity, mcMesh);
+                    addVertices(i32v3(x, y, z), dcMesh, dcVertices);
+                    addVertices(i32v3(x, y, z), mcMesh, mcVertices);
+                }
+            }
+        }
+        f32 dcCorner = getWorstCornerDistance(dcVertices), mcCorner = getWorstCornerDistance(mcVertices);
+        std::printf("    box corners to the closest vertex: dual contouring %.3f, marching cubes %.3f voxels\n", dcCorner, mcCorner);
+        OPENVOX_CHECK(dcCorner < 0.5f && dcCorner * 2.0f < mcCorner);
+    });
+
+    test::run("merging takes fewer vertices than the cells", [] {
+        DualContouringMesher mesher;
+        PackedMesh mesh;
+        mesher.mesh(i32v3(1, 1, 1), 0, getBoxDensity, mesh, 0.0f);
+        size_t leaves = mesher.getLeafVertexCount();
+        OPENVOX_CHECK(leaves > 100 && mesh.vertices.size() <= leaves);
+        size_t unmerged = mesh.indices.size();
+        mesher.mesh(i32v3(1, 1, 1), 0, getBoxDensity, mesh);
+        OPENVOX_CHECK(mesher.getLeafVertexCount() == leaves && mesh.indices.size() < unmerged);
+        mesher.mesh(i32v3(1, 1, 1), 0, getBoxDensity, mesh, 1e6f);
+        OPENVOX_CHECK(mesh.indices.size() > 0);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,203 @@
+#include <stdexcept>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "ecs/EcsCommandBuffer.h"
+#include "ecs/EcsWorld.h"
+
+using namespace openvox;
+
+namespace {
+    OPENVOX_VECTOR_COMPONENT(Position, f32v3);
+    OPENVOX_VECTOR_COMPONENT(Velocity, f32v3);
+    struct Health {
+        i32 value = 100;
+    };
+    /// Counts copies made at addresses that break its alignment
+    struct alignas(ECS_COLUMN_ALIGNMENT) CacheLine {
+        static int misaligned;
+        u32 value;
+        CacheLine(u32 v = 0) : value(v) {}
+        CacheLine(const CacheLine& o) : value(o.value) {
+            misaligned += ((size_t)this & (ECS_COLUMN_ALIGNMENT - 1)) != 0 ? 1 : 0;
+        }
+    };
+    int CacheLine::misaligned = 0;
+}
+
+int main() {
+    test::run("components survive archetype moves", [] {
+        EcsWorld world;
+        std::vector<Entity> entities;
+        for (int i = 0; i < 5000; i++) {
+            entities.push_back(world.create(Position(f32v3((f32)i, 0.0f, 0.0f))));
+        }
+        for (int i = 0; i < 5000; i += 2) world.add(entities[i], Velocity(f32v3(1.0f, 0.0f, 0.0f)));
+        for (int i = 0; i < 5000; i += 3) world.add(entities[i], Health());
+        for (int i = 0; i < 5000; i += 5) world.destroy(entities[i]);
+        for (int i = 0; i < 5000; i += 7) world.remove<Velocity>(entities[i]);
+
+        bool ok = true;
+        for (int i = 0; i < 5000; i++) {
+            Entity e = entities[i];
+            if (i % 5 == 0) {
+                ok &= !world.isAlive(e) && !world.get<Position>(e);
+                continue;
+            }
+            ok &= world.get<Position>(e) && world.get<Position>(e)->x == (f32)i;
+            ok &= world.has<Velocity>(e) == (i % 2 == 0 && i % 7 != 0);
+            ok &= world.has<Health>(e) == (i % 3 == 0);
+        }
+        OPENVOX_CHECK(ok);
+        OPENVOX_CHECK(world.getEntityCount() == 4000);
+    });
+
+    test::run("queries visit every matching entity once", [] {
+        EcsWorld world;
+        for (int i = 0; i < 10000; i++) {
+            Entity e = world.create(Position(f32v3(0.0f)), Velocity(f32v3(1.0f, 2.0f, 3.0f)));
+            if (i & 1) world.add(e, Health());
+        }
+        for (int i = 0; i < 100; i++) world.create(Position(f32v3(0.0f)));
+
+        size_t visited = 0;
+        world.forEachChunk<Position, const Velocity>([&](size_t n, const Entity*, Position* p, const Velocity* v) {
+            OPENVOX_CHECK(((size_t)p & (ECS_COLUMN_ALIGNMENT - 1)) == 0);
+            for (size_t i = 0; i < n; i++) p[i] += static_cast<const f32v3&>(v[i]);
+            visited += n;
+        });
+        OPENVOX_CHECK(visited == 10000);
+        OPENVOX_CHECK(world.count<Position>() == 10100);
+        OPENVOX_CHECK(world.count<Position, Health>() == 5000);
+
+        JobSystem jobs;
+        jobs.init(3);
+        world.forEachChunkParallel<Position, const Velocity>(jobs, [](size_t n, const Entity*, Position* p, const Velocity* v) {
+            for (size_t i = 0; i < n; i++) p[i] += static_cast<const f32v3&>(v[i]);
+        });
+        jobs.dispose();
+        bool ok = true;
+        world.each<const Position, const Velocity>([&](Entity, const Position& p, const Velocity&) {
+            ok &= p.x == 2.0f && p.y == 4.0f && p.z == 6.0f;
+        });
+        OPENVOX_CHECK(ok);
+    });
+
+    test::run("command buffer applies commands in order", [] {
+        EcsWorld world;
+        Entity existing = world.create(Position(f32v3(0.0f)));
+        EcsCommandBuffer buffer;
+        Entity pending = buffer.create();
+        buffer.add(pending, Health());
+        buffer.add(pending, Position(f32v3(5.0f)));
+        buffer.remove<Health>(pending);
+        buffer.add(existing, Position(f32v3(7.0f)));
+        buffer.destroy(world.create());
+
+        std::vector<Entity> created;
+        buffer.playback(world, &created);
+        OPENVOX_CHECK(buffer.isEmpty());
+        OPENVOX_CHECK(created.size() == 1);
+        OPENVOX_CHECK(world.isAlive(created[0]));
+        OPENVOX_CHECK(!world.has<Health>(created[0]));
+        OPENVOX_CHECK(world.get<Position>(created[0]) && world.get<Position>(created[0])->x == 5.0f);
+        OPENVOX_CHECK(world.get<Position>(existing)->x == 7.0f);
+        OPENVOX_CHECK(world.getEntityCount() == 2);
+    });
+
+    test::run("command buffer keeps over-aligned components aligned", [] {
+        EcsWorld world;
+        EcsCommandBuffer buffer;
+        std::vector<Entity> entities;
+        for (u32 i = 0; i < 3000; i++) {
+            entities.push_back(world.create());
+            // A 4 byte component in between puts every other one off alignment unless padded
+            buffer.add(entities.back(), Health());
+            buffer.add(entities.back(), CacheLine(i));
+        }
+        buffer.playback(world);
+        u32 wrong = 0;
+        for (u32 i = 0; i < entities.size(); i++) wrong += world.get<CacheLine>(entities[i])->value != i ? 1 : 0;
+        OPENVOX_CHECK(wrong == 0 && CacheLine::misaligned == 0);
+    });
+
+    test::run("onComponentAdded sees the recorded value", [] {
+        EcsWorld world;
+        Entity e = world.create();
+        std::vector<i32> seen;
+        auto* listener = world.onComponentAdded.addFunctor([&](Sender, Entity added, ComponentTypeID t) {
+            if (t == getComponentTypeID<Health>()) seen.push_back(world.get<Health>(added)->value);
+        });
+
+        EcsCommandBuffer buffer;
+        Health h;
+        h.value = 42;
+        buffer.add(e, h);
+        Entity pending = buffer.create();
+        h.value = 7;
+        buffer.add(pending, h);
+        buffer.playback(world);
+
+        OPENVOX_CHECK(seen.size() == 2);
+        OPENVOX_CHECK(seen.size() == 2 && seen[0] == 42 && seen[1] == 7);
+        world.onComponentAdded -= *listener;
+        delete listener;
+    });
+
+    test::run("event handlers may record into the playing buffer", [] {
+        EcsWorld world;
+        EcsCommandBuffer buffer;
+        // Every entity created gets a Health component on the next playback
+        auto* listener = world.onEntityCreated.addFunctor([&](Sender, Entity e) {
+            buffer.add(e, Health());
+        });
+
+        for (int i = 0; i < 100; i++) buffer.create();
+        std::vector<Entity> created;
+        buffer.playback(world, &created);
+        OPENVOX_CHECK(created.size() == 100);
+        OPENVOX_CHECK(buffer.getCommandCount() == 100);
+        OPENVOX_CHECK(world.count<Health>() == 0);
+
+        buffer.playback(world);
+        OPENVOX_CHECK(buffer.isEmpty());
+        OPENVOX_CHECK(world.count<Health>() == 100);
+        world.onEntityCreated -= *listener;
+        delete listener;
+    });
+
+    test::run("recording from parallel iteration", [] {
+        EcsWorld world;
+        for (int i = 0; i < 20000; i++) world.create(Health());
+        EcsCommandBuffer buffer;
+        JobSystem jobs;
+        jobs.init(3);
+        world.forEachChunkParallel<const Health>(jobs, [&](size_t n, const Entity* entities, const Health*) {
+            for (size_t i = 0; i < n; i++) {
+                if (entities[i].index % 4 == 0) buffer.destroy(entities[i]);
+                else buffer.add(entities[i], Velocity(f32v3(1.0f)));
+            }
+        });
+        jobs.dispose();
+        buffer.playback(world);
+        OPENVOX_CHECK(world.getEntityCount() == 15000);
+        OPENVOX_CHECK(world.count<Health, Velocity>() == 15000);
+    });
+
+    // Runs last, since it uses up every remaining component type ID
+    test::run("registration fails past the component type limit", [] {
+        ComponentInfo info = getComponentInfo(getComponentTypeID<Health>());
+        while (getComponentTypeCount() < MAX_COMPONENT_TYPES) registerComponentType(info);
+        bool threw = false;
+        try {
+            registerComponentType(info);
+        } catch (const std::length_error&) {
+            threw = true;
+        }
+        OPENVOX_CHECK(threw && getComponentTypeCount() == MAX_COMPONENT_TYPES);
+    });
+
+    return test::finish();
+}
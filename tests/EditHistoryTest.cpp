@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "TestFiles.h"
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "math/OpenVoxMath.hpp"
+#include "voxel/EditHistory.h"
+#include "voxel/VoxelEditor.h"
+
+using namespace openvox;
+
+namespace {
+    typedef std::unordered_map<i32v3, std::vector<BlockID>, PositionHash> Copy;
+
+    const i32v3 WORLD_MIN(-1, 0, -1);
+    const i32v3 WORLD_MAX(2, 2, 2);
+
+    void buildWorld(ChunkMap& map) {
+        test::buildTerrain(map, WORLD_MIN, WORLD_MAX, 1, 40, 10.0f);
+        test::Random random(69);
+        for (int i = 0; i < 20000; i++) {
+            i32v3 p(random.range(-32, 95), random.range(0, 95), random.range(-32, 95));
+            map.setBlock(p, (BlockID)random.range(0, 4));
+        }
+    }
+
+    Copy copyWorld(const ChunkMap& map) {
+        Copy copy;
+        for (auto& it : map.getChunks()) copy[it.first].assign(it.second->getBlockData(), it.second->getBlockData() + CHUNK_SIZE);
+        return copy;
+    }
+
+    /// Number of chunks whose voxels differ from the copy
+    int countDifferences(const ChunkMap& map, const Copy& copy) {
+        int differences = 0;
+        for (auto& it : copy) {
+            const Chunk* c = map.getChunk(it.first);
+            if (!c || std::memcmp(c->getBlockData(), it.second.data(), sizeof(BlockID) * CHUNK_SIZE)) differences++;
+        }
+        return differences + (int)(map.getChunkCount() - copy.size());
+    }
+
+    bool occupancyMatches(const ChunkMap& map) {
+        for (auto& it : map.getChunks()) {
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                if (it.second->getOccupancy().isSolid(i) != (it.second->getBlock(i) != BLOCK_AIR)) return false;
+            }
+        }
+        return true;
+    }
+
+    /// One random shape edit inside the world, which may change nothing
+    size_t randomEdit(VoxelEditor& editor, test::Random& random) {
+        i32v3 a(random.range(-40, 90), random.range(-8, 90), random.range(-40, 90));
+        i32v3 b = a + i32v3(random.range(0, 30), random.range(0, 30), random.range(0, 30));
+        BlockID id = (BlockID)random.range(0, 5);
+        switch (random.range(0, 4)) {
+            case 0: return editor.fillBox(a, b, id);
+            case 1: return editor.fillSphere(a, random.range(0, 40) * 0.5f, id, EditMode::REPLACE_SOLID);
+            case 2: return editor.fillCylinder(a, random.range(0, 30) * 0.5f, random.range(1, 40), id, EditMode::FILL_AIR);
+            case 3: return editor.copyRegion(a, b, a + i32v3(random.range(-12, 12), random.range(-12, 12), random.range(-12, 12)),
+                                             random.range(0, 1) != 0);
+            default: {
+                i32v3 size = b - a + i32v3(1);
+                std::vector<u8> mask((size_t)size.x * size.y * size.z);
+                for (u8& m : mask) m = random.range(0, 2) == 0;
+                return editor.applyMask(a, size, mask.data(), id);
+            }
+        }
+    }
+}
+
+int main() {
+    test::run("undo and redo walk back and forth through every operation", [] {
+        ChunkMap map;
+        buildWorld(map);
+        EditHistory history(&map);
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        test::Random random(690);
+
+        std::vector<Copy> states(1, copyWorld(map));
+        std::vector<size_t> counts;
+        while (counts.size() < 40) {
+            size_t changed = randomEdit(editor, random);
+            if (!changed) continue;
+            counts.push_back(changed);
+            states.push_back(copyWorld(map));
+        }
+        OPENVOX_CHECK(history.getUndoCount() == counts.size() && history.getRedoCount() == 0);
+
+        int differences = 0, badCounts = 0;
+        for (size_t i = counts.size(); i-- > 0;) {
+            badCounts += editor.undo() != counts[i] ? 1 : 0;
+            differences += countDifferences(map, states[i]);
+        }
+        OPENVOX_CHECK(differences == 0 && badCounts == 0);
+        OPENVOX_CHECK(history.getUndoCount() == 0 && history.getRedoCount() == counts.size() && editor.undo() == 0);
+        OPENVOX_CHECK(occupancyMatches(map));
+
+        for (size_t i = 0; i < counts.size(); i++) {
+            badCounts += editor.redo() != counts[i] ? 1 : 0;
+            differences += countDifferences(map, states[i + 1]);
+        }
+        OPENVOX_CHECK(differences == 0 && badCounts == 0);
+        OPENVOX_CHECK(history.getRedoCount() == 0 && editor.redo() == 0);
+        OPENVOX_CHECK(occupancyMatches(map));
+
+        // A new operation after an undo drops the redo stack
+        editor.undo();
+        editor.undo();
+        OPENVOX_CHECK(history.getRedoCount() == 2);
+        OPENVOX_CHECK(editor.fillBox(i32v3(0), i32v3(10), 7) > 0);
+        OPENVOX_CHECK(history.getRedoCount() == 0 && history.getUndoCount() == counts.size() - 1);
+        OPENVOX_CHECK(editor.undo() > 0 && countDifferences(map, states[counts.size() - 2]) == 0);
+    });
+
+    test::run("groups are one undo step and operations without changes are not kept", [] {
+        ChunkMap map;
+        buildWorld(map);
+        EditHistory history(&map);
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        Copy before = copyWorld(map);
+
+        editor.fillBox(i32v3(0), i32v3(40), 3);
+        OPENVOX_CHECK(editor.fillBox(i32v3(0), i32v3(40), 3) == 0);
+        OPENVOX_CHECK(history.getUndoCount() == 1);
+
+        test::Random random(691);
+        history.beginOperation();
+        size_t total = 0;
+        for (int i = 0; i < 50; i++) {
+            history.beginOperation();
+            total += randomEdit(editor, random);
+            total += randomEdit(editor, random);
+            history.endOperation();
+        }
+        OPENVOX_CHECK(history.isRecording() && editor.undo() == 0);
+        history.endOperation();
+        OPENVOX_CHECK(!history.isRecording() && history.getUndoCount() == 2);
+
+        // Voxels written several times in the group count once
+        Copy grouped = copyWorld(map);
+        size_t undone = editor.undo();
+        OPENVOX_CHECK(undone > 0 && undone <= total);
+        editor.undo();
+        OPENVOX_CHECK(countDifferences(map, before) == 0);
+        editor.redo();
+        OPENVOX_CHECK(editor.redo() == undone && countDifferences(map, grouped) == 0);
+
+        // A group whose edits cancel out is not kept and leaves the redo stack alone
+        editor.undo();
+        const i32v3 min(10), max(50);
+        std::vector<BlockID> old;
+        editor.readRegion(min, max, old);
+        history.beginOperation();
+        OPENVOX_CHECK(editor.fillBox(min, max, 5) > 0);
+        size_t i = 0;
+        for (i32 y = min.y; y <= max.y; y++) {
+            for (i32 z = min.z; z <= max.z; z++) {
+                for (i32 x = min.x; x <= max.x; x++) map.setBlock(i32v3(x, y, z), old[i++]);
+            }
+        }
+        history.endOperation();
+        history.beginOperation();
+        history.endOperation();
+        OPENVOX_CHECK(history.getUndoCount() == 1 && history.getRedoCount() == 1);
+    });
+
+    test::run("undo reports the changed chunks through commit", [] {
+        ChunkMap map;
+        buildWorld(map);
+        EditHistory history(&map);
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        std::vector<VoxelEditBatch> batches;
+        auto* listener = editor.onCommit.addFunctor([&](Sender, const VoxelEditBatch& b) { batches.push_back(b); });
+
+        // Spans the +x face of chunks at x = 0 and the +y face of those at y = 0
+        size_t count = editor.fillBox(i32v3(20, 25, 4), i32v3(40, 35, 9), 9);
+        editor.commit();
+        std::vector<i32v3> chunks = batches[0].chunks;
+        OPENVOX_CHECK(chunks.size() == 4);
+
+        OPENVOX_CHECK(editor.undo() == count);
+        OPENVOX_CHECK(batches.size() == 1);
+        editor.commit();
+        OPENVOX_CHECK(batches.size() == 2);
+        if (batches.size() == 2) {
+            const VoxelEditBatch& b = batches[1];
+            OPENVOX_CHECK(b.voxelCount == count && b.chunks.size() == chunks.size());
+            for (const i32v3& c : chunks) OPENVOX_CHECK(std::find(b.chunks.begin(), b.chunks.end(), c) != b.chunks.end());
+            // Bounds of a change cover its voxels, whole rows where a run wraps
+            OPENVOX_CHECK(b.min.x <= 20 && b.min.y <= 25 && b.min.z <= 4 && b.max.x >= 40 && b.max.y >= 35 && b.max.z >= 9);
+            OPENVOX_CHECK(b.min.y >= 0 && b.max.y < 2 * CHUNK_WIDTH && b.min.x >= 0 && b.max.x < 2 * CHUNK_WIDTH);
+        }
+
+        std::vector<EditHistoryChange> changes;
+        size_t redone = history.redo(changes);
+        size_t sum = 0;
+        for (const EditHistoryChange& c : changes) {
+            sum += c.voxelCount;
+            OPENVOX_CHECK(c.min.x <= c.max.x && c.min.y <= c.max.y && c.min.z <= c.max.z && c.max.x < CHUNK_WIDTH);
+        }
+        OPENVOX_CHECK(redone == count && sum == count && changes.size() == chunks.size());
+
+        editor.onCommit -= *listener;
+        delete listener;
+    });
+
+    test::run("voxels of unloaded chunks are skipped and the rest still undone", [] {
+        ChunkMap map;
+        buildWorld(map);
+        EditHistory history(&map);
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        Copy before = copyWorld(map);
+        const i32v3 unloaded(1, 0, 0);
+
+        size_t count = editor.fillBox(i32v3(0), i32v3(63, 20, 20), 6);
+        size_t lost = 0;
+        for (int i = 0; i < CHUNK_SIZE; i++) lost += map.getChunk(unloaded)->getBlock(i) != before[unloaded][i] ? 1 : 0;
+        map.destroyChunk(unloaded);
+        before.erase(unloaded);
+        OPENVOX_CHECK(lost > 0 && editor.undo() == count - lost);
+        OPENVOX_CHECK(countDifferences(map, before) == 0);
+    });
+
+    test::run("the oldest operations spill past the memory limit and load back", [] {
+        test::TempDirectory dir("edit_history");
+        ChunkMap map;
+        buildWorld(map);
+        const size_t limit = 16 * 1024;
+        EditHistory history(&map, limit, dir.getPath());
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        test::Random random(692);
+
+        std::vector<Copy> states(1, copyWorld(map));
+        size_t maxMemory = 0;
+        while (states.size() <= 30) {
+            if (!randomEdit(editor, random)) continue;
+            states.push_back(copyWorld(map));
+            maxMemory = openvoxm::max(maxMemory, history.getMemoryUsage());
+        }
+        OPENVOX_CHECK(history.getUndoCount() == 30 && history.getSpilledSize() > 0 && maxMemory <= limit);
+        OPENVOX_CHECK(dir.list().size() == 1);
+
+        int differences = 0;
+        for (size_t i = states.size() - 1; i-- > 0;) {
+            OPENVOX_CHECK(editor.undo() > 0);
+            differences += countDifferences(map, states[i]);
+        }
+        OPENVOX_CHECK(differences == 0 && history.getSpilledSize() == 0 && history.getUndoCount() == 0);
+
+        // Redo pushes them back out
+        for (size_t i = 1; i < states.size(); i++) {
+            editor.redo();
+            differences += countDifferences(map, states[i]);
+        }
+        OPENVOX_CHECK(differences == 0 && history.getSpilledSize() > 0 && history.getMemoryUsage() <= limit);
+
+        // Undoing half then editing again reuses the file from where the stack ends
+        for (int i = 0; i < 15; i++) editor.undo();
+        while (!editor.fillBox(i32v3(random.range(0, 60)), i32v3(70), 8)) {}
+        OPENVOX_CHECK(history.getUndoCount() == 16 && history.getRedoCount() == 0);
+        editor.undo();
+        for (size_t i = 15; i-- > 0;) {
+            editor.undo();
+            differences += countDifferences(map, states[i]);
+        }
+        OPENVOX_CHECK(differences == 0);
+
+        history.clear();
+        OPENVOX_CHECK(history.getSpilledSize() == 0 && history.getMemoryUsage() == 0);
+    });
+
+    test::run("without a spill directory the oldest operations are dropped", [] {
+        ChunkMap map;
+        buildWorld(map);
+        EditHistory history(&map);
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        test::Random random(693);
+
+        std::vector<Copy> states(1, copyWorld(map));
+        std::vector<size_t> sizes;
+        while (states.size() <= 20) {
+            size_t memory = history.getMemoryUsage();
+            if (!randomEdit(editor, random)) continue;
+            states.push_back(copyWorld(map));
+            sizes.push_back(history.getMemoryUsage() - memory);
+        }
+        // Keeps the newest operations that fit
+        size_t limit = 0, kept = 0;
+        while (kept < 8) limit += sizes[sizes.size() - 1 - kept++];
+        history.setMemoryLimit(limit);
+        OPENVOX_CHECK(history.getUndoCount() == kept && history.getMemoryUsage() == limit && history.getSpilledSize() == 0);
+
+        while (editor.undo()) {}
+        OPENVOX_CHECK(countDifferences(map, states[states.size() - 1 - kept]) == 0);
+        while (editor.redo()) {}
+        OPENVOX_CHECK(countDifferences(map, states.back()) == 0);
+
+        // An operation larger than the limit is not kept at all
+        history.setMemoryLimit(0);
+        OPENVOX_CHECK(history.getUndoCount() == 0 && history.getMemoryUsage() == 0);
+        OPENVOX_CHECK(editor.fillBox(i32v3(0), i32v3(50), 9) > 0 && history.getUndoCount() == 0 && editor.undo() == 0);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,350 @@
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "TestFiles.h"
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "io/EditJournal.h"
+#include "io/RegionStore.h"
+#include "io/Serialization.hpp"
+#include "voxel/ChunkMap.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 WORLD_MIN(-2, 0, -2); ///< Chunks edited by the tests
+    const i32v3 WORLD_MAX(1, 1, 1);
+
+    /// Edits wandering through the world one voxel at a time, the way players build
+    class EditWalk {
+    public:
+        explicit EditWalk(u64 seed) : m_random(seed), m_pos(0, 16, 0) {}
+
+        void next(OUT i32v3& pos, OUT BlockID& id) {
+            int axis = m_random.range(0, 2);
+            m_pos[axis] += m_random.range(0, 1) ? 1 : -1;
+            i32 lo = WORLD_MIN[axis] * CHUNK_WIDTH, hi = (WORLD_MAX[axis] + 1) * CHUNK_WIDTH - 1;
+            m_pos[axis] = m_pos[axis] < lo ? lo : (m_pos[axis] > hi ? hi : m_pos[axis]);
+            pos = m_pos;
+            id = (BlockID)m_random.range(0, 40);
+        }
+
+    private:
+        test::Random m_random;
+        i32v3 m_pos;
+    };
+
+    void createWorld(ChunkMap& map) {
+        for (i32 y = WORLD_MIN.y; y <= WORLD_MAX.y; y++) {
+            for (i32 z = WORLD_MIN.z; z <= WORLD_MAX.z; z++) {
+                for (i32 x = WORLD_MIN.x; x <= WORLD_MAX.x; x++) map.createChunk(i32v3(x, y, z));
+            }
+        }
+    }
+
+    /// Applies edits to the world and journals them
+    void edit(ChunkMap& map, EditJournal& journal, EditWalk& walk, int count) {
+        for (int i = 0; i < count; i++) {
+            i32v3 pos;
+            BlockID id;
+            walk.next(pos, id);
+            map.setBlock(pos, id);
+            journal.append(pos, id);
+        }
+    }
+
+    /// Rebuilds a world the way a server starts: chunks come from the regions, edits from the journal
+    EditJournal::ReplayFunc makeRecovery(ChunkMap& map, RegionStore& regions) {
+        return [&map, &regions](const i32v3& voxelPos, BlockID id) {
+            i32v3 chunkPos = toChunkPosition(voxelPos);
+            if (!map.getChunk(chunkPos)) regions.loadChunk(*map.createChunk(chunkPos));
+            map.setBlock(voxelPos, id);
+        };
+    }
+
+    /// Loads every chunk of the world that is not loaded yet from the regions
+    void loadRest(ChunkMap& map, RegionStore& regions) {
+        for (i32 y = WORLD_MIN.y; y <= WORLD_MAX.y; y++) {
+            for (i32 z = WORLD_MIN.z; z <= WORLD_MAX.z; z++) {
+                for (i32 x = WORLD_MIN.x; x <= WORLD_MAX.x; x++) {
+                    i32v3 c(x, y, z);
+                    if (!map.getChunk(c)) regions.loadChunk(*map.createChunk(c));
+                }
+            }
+        }
+    }
+
+    /// Chunks that are missing or differ, all-air chunks and missing ones being the same
+    int countDifferences(const ChunkMap& a, const ChunkMap& b) {
+        static const std::vector<BlockID> air(CHUNK_SIZE, BLOCK_AIR);
+        int differences = 0;
+        for (i32 y = WORLD_MIN.y; y <= WORLD_MAX.y; y++) {
+            for (i32 z = WORLD_MIN.z; z <= WORLD_MAX.z; z++) {
+                for (i32 x = WORLD_MIN.x; x <= WORLD_MAX.x; x++) {
+                    const Chunk* ca = a.getChunk(i32v3(x, y, z));
+                    const Chunk* cb = b.getChunk(i32v3(x, y, z));
+                    const BlockID* da = ca ? ca->getBlockData() : air.data();
+                    const BlockID* db = cb ? cb->getBlockData() : air.data();
+                    if (std::memcmp(da, db, sizeof(BlockID) * CHUNK_SIZE)) differences++;
+                }
+            }
+        }
+        return differences;
+    }
+
+    std::vector<std::string> listSegments(const test::TempDirectory& dir) {
+        std::vector<std::string> segments;
+        for (const std::string& name : dir.list()) {
+            if (name.compare(0, 8, "journal.") == 0) segments.push_back(name);
+        }
+        return segments;
+    }
+
+    /// Fills a chunk with a given number of distinct block types
+    void fillWithTypes(Chunk& chunk, u32 types, test::Random& random) {
+        for (int i = 0; i < CHUNK_SIZE; i++) chunk.setBlock(i, (BlockID)(i < (int)types ? i : random.range(0, (i32)types - 1)));
+    }
+}
+
+int main() {
+    test::run("edits survive close and reopen", [] {
+        test::TempDirectory dir("journal_reopen");
+        ChunkMap live;
+        createWorld(live);
+        EditWalk walk(67);
+        EditJournal journal;
+        OPENVOX_CHECK(journal.open(dir.getPath(), [](const i32v3&, BlockID) {}));
+        edit(live, journal, walk, 50000);
+        journal.waitDurable(50000);
+        EditJournalStats stats = journal.getStats();
+        journal.close();
+        OPENVOX_CHECK(stats.records == 50000 && stats.bytes == stats.records * 14 + stats.frames * 8);
+        OPENVOX_CHECK(stats.syncs >= 1 && stats.frames >= stats.syncs);
+
+        ChunkMap recovered;
+        RegionStore regions;
+        regions.open(dir.getPath());
+        OPENVOX_CHECK(journal.open(dir.getPath(), makeRecovery(recovered, regions)));
+        OPENVOX_CHECK(journal.getStats().replayed == 50000 && journal.getSegmentCount() == 2);
+        OPENVOX_CHECK(countDifferences(live, recovered) == 0);
+    });
+
+    test::run("concurrent appends share syncs", [] {
+        test::TempDirectory dir("journal_group");
+        EditJournal journal;
+        OPENVOX_CHECK(journal.open(dir.getPath(), [](const i32v3&, BlockID) {}));
+        const int threads = 4, perThread = 20000;
+        std::vector<std::thread> workers;
+        std::vector<int> undurable(threads, 0);
+        for (int t = 0; t < threads; t++) {
+            workers.emplace_back([&journal, &undurable, t] {
+                for (int i = 0; i < perThread; i++) {
+                    u64 sequence = journal.append(i32v3(t, i, 0), (BlockID)t);
+                    // Every so often a client waits for its edit to be acknowledged
+                    if (i % 1000 == 999) {
+                        journal.waitDurable(sequence);
+                        if (journal.getDurableSequence() < sequence) undurable[t]++;
+                    }
+                }
+            });
+        }
+        for (std::thread& w : workers) w.join();
+        journal.waitDurable(threads * perThread);
+        EditJournalStats stats = journal.getStats();
+        OPENVOX_CHECK(undurable == std::vector<int>(threads, 0));
+        OPENVOX_CHECK(journal.getDurableSequence() == (u64)threads * perThread && stats.records == (u64)threads * perThread);
+        OPENVOX_CHECK(stats.syncs < stats.records / 10);
+        journal.close();
+
+        // Each thread's edits replay in the order it made them
+        std::vector<i32> nextY(threads, 0);
+        int outOfOrder = 0;
+        OPENVOX_CHECK(journal.open(dir.getPath(), [&](const i32v3& p, BlockID id) {
+            if (p.x != (i32)id || p.y != nextY[p.x]++) outOfOrder++;
+        }));
+        OPENVOX_CHECK(outOfOrder == 0 && nextY == std::vector<i32>(threads, perThread));
+    });
+
+    test::run("checkpoints save chunks and drop segments", [] {
+        test::TempDirectory dir("journal_checkpoint");
+        ChunkMap live;
+        createWorld(live);
+        EditWalk walk(68);
+        RegionStore regions;
+        EditJournal journal;
+        OPENVOX_CHECK(regions.open(dir.getPath()) && journal.open(dir.getPath(), [](const i32v3&, BlockID) {}));
+        edit(live, journal, walk, 20000);
+        OPENVOX_CHECK(journal.checkpoint(live, regions));
+        OPENVOX_CHECK(journal.getSegmentCount() == 1 && listSegments(dir).size() == 1);
+
+        // Edits after the checkpoint, and to a chunk unloaded without being saved
+        edit(live, journal, walk, 5000);
+        const i32v3 dropped(-2, 0, -2);
+        live.setBlock(toVoxelPosition(dropped), 77);
+        journal.append(toVoxelPosition(dropped), 77);
+        journal.waitDurable(25001);
+        ChunkMap expected;
+        createWorld(expected);
+        for (auto& it : live.getChunks()) {
+            std::memcpy(expected.getChunk(it.first)->getMutableBlockData(), it.second->getBlockData(), sizeof(BlockID) * CHUNK_SIZE);
+        }
+        live.destroyChunk(dropped);
+        OPENVOX_CHECK(journal.checkpoint(live, regions));
+        OPENVOX_CHECK(journal.getSegmentCount() == 2);
+
+        // Reopening replays only the segment the unloaded chunk keeps alive, over the saved chunks
+        journal.close();
+        regions.close();
+        ChunkMap recovered;
+        OPENVOX_CHECK(regions.open(dir.getPath()));
+        OPENVOX_CHECK(journal.open(dir.getPath(), makeRecovery(recovered, regions)));
+        OPENVOX_CHECK(journal.getStats().replayed == 5001);
+        loadRest(recovered, regions);
+        OPENVOX_CHECK(countDifferences(expected, recovered) == 0);
+
+        // Once the chunk is saved the segment goes
+        OPENVOX_CHECK(regions.saveChunk(*recovered.getChunk(dropped)) && regions.sync());
+        journal.markChunkSaved(dropped);
+        OPENVOX_CHECK(journal.checkpoint(recovered, regions));
+        OPENVOX_CHECK(journal.getSegmentCount() == 1 && listSegments(dir).size() == 1);
+    });
+
+    test::run("a torn or corrupt frame ends replay", [] {
+        test::TempDirectory dir("journal_torn");
+        EditWalk walk(69);
+        std::vector<std::pair<i32v3, BlockID> > edits(3000);
+        for (auto& e : edits) walk.next(e.first, e.second);
+        EditJournal journal;
+        OPENVOX_CHECK(journal.open(dir.getPath(), [](const i32v3&, BlockID) {}));
+        for (size_t i = 0; i < edits.size(); i++) {
+            journal.append(edits[i].first, edits[i].second);
+            // Some batches end at a sync so the segment has several frames
+            if (i % 1000 == 999) journal.waitDurable(i + 1);
+        }
+        journal.close();
+
+        std::vector<std::string> segments = listSegments(dir);
+        OPENVOX_CHECK(segments.size() == 1);
+        std::string path = dir.getPath(segments[0]);
+        std::vector<u8> data = test::readFile(path);
+        // Record counts of the frames, from their headers
+        std::vector<u32> frames;
+        for (size_t offset = 0; offset + 8 <= data.size(); offset += 8 + frames.back() * 14) frames.push_back(SerialTraits<u32>::load(&data[offset + 4]));
+        OPENVOX_CHECK(frames.size() >= 3 && data.size() == frames.size() * 8 + edits.size() * 14);
+
+        // State after the first count edits
+        auto expect = [&edits](size_t count, OUT ChunkMap& map) {
+            createWorld(map);
+            for (size_t i = 0; i < count; i++) map.setBlock(edits[i].first, edits[i].second);
+        };
+        RegionStore unused;
+
+        // The crash cut the last frame short
+        std::vector<u8> torn(data.begin(), data.end() - 5);
+        test::writeFile(path, torn);
+        ChunkMap recovered, afterTorn;
+        OPENVOX_CHECK(journal.open(dir.getPath(), makeRecovery(recovered, unused)));
+        size_t kept = edits.size() - frames.back();
+        expect(kept, afterTorn);
+        OPENVOX_CHECK(journal.getStats().replayed == kept && countDifferences(afterTorn, recovered) == 0);
+
+        // New edits go to a new segment and replay after the torn one
+        for (int i = 0; i < 500; i++) {
+            journal.append(edits[i].first, 1000);
+            afterTorn.setBlock(edits[i].first, 1000);
+        }
+        journal.waitDurable(500);
+        journal.close();
+        ChunkMap again;
+        OPENVOX_CHECK(journal.open(dir.getPath(), makeRecovery(again, unused)));
+        OPENVOX_CHECK(journal.getStats().replayed == kept + 500 && countDifferences(afterTorn, again) == 0);
+        journal.close();
+        for (const std::string& name : listSegments(dir)) {
+            if (name != segments[0]) std::remove(dir.getPath(name).c_str());
+        }
+
+        // A flipped bit in the second frame drops it and everything after it in the segment
+        data[8 + frames[0] * 14 + 8 + 3] ^= 0x10;
+        test::writeFile(path, data);
+        ChunkMap corrupt, afterFirst;
+        expect(frames[0], afterFirst);
+        OPENVOX_CHECK(journal.open(dir.getPath(), makeRecovery(corrupt, unused)));
+        OPENVOX_CHECK(journal.getStats().replayed == frames[0] && countDifferences(afterFirst, corrupt) == 0);
+        journal.close();
+    });
+
+    test::run("regions round trip every palette size", [] {
+        test::TempDirectory dir("regions");
+        test::Random random(70);
+        const u32 types[] = { 1, 2, 3, 17, 300, 4096, CHUNK_SIZE };
+        std::vector<i32v3> positions;
+        ChunkMap saved;
+        {
+            RegionStore regions;
+            OPENVOX_CHECK(regions.open(dir.getPath()));
+            for (u32 i = 0; i < sizeof(types) / sizeof(types[0]); i++) {
+                // Spread over regions on both sides of the origin
+                i32v3 chunkPos((i32)i * 5 - 16, -(i32)i, (i32)i * 3);
+                Chunk* chunk = saved.createChunk(chunkPos);
+                fillWithTypes(*chunk, types[i], random);
+                positions.push_back(chunkPos);
+                OPENVOX_CHECK(regions.saveChunk(*chunk));
+                // Readable before the sync points the table at it
+                Chunk copy(chunkPos);
+                OPENVOX_CHECK(regions.loadChunk(copy) && std::memcmp(copy.getBlockData(), chunk->getBlockData(), sizeof(BlockID) * CHUNK_SIZE) == 0);
+            }
+            Chunk missing(i32v3(100, 100, 100));
+            OPENVOX_CHECK(!regions.loadChunk(missing));
+        }
+
+        RegionStore regions;
+        OPENVOX_CHECK(regions.open(dir.getPath()));
+        int differences = 0;
+        for (const i32v3& p : positions) {
+            Chunk chunk(p);
+            if (!regions.loadChunk(chunk) || std::memcmp(chunk.getBlockData(), saved.getChunk(p)->getBlockData(), sizeof(BlockID) * CHUNK_SIZE)) differences++;
+        }
+        OPENVOX_CHECK(differences == 0);
+    });
+
+    test::run("damaged chunks fail to load and compaction keeps live data", [] {
+        test::TempDirectory dir("regions_damage");
+        test::Random random(71);
+        Chunk a(i32v3(0, 0, 0)), b(i32v3(1, 0, 0));
+        fillWithTypes(a, 5, random);
+        {
+            RegionStore regions;
+            OPENVOX_CHECK(regions.open(dir.getPath()));
+            // Old versions of b pile up at the end of the file
+            for (int i = 0; i < 6; i++) {
+                fillWithTypes(b, 200, random);
+                OPENVOX_CHECK(regions.saveChunk(b) && regions.sync());
+            }
+            OPENVOX_CHECK(regions.saveChunk(a) && regions.sync());
+            std::string path = dir.getPath("r.0.0.0.ovr");
+            size_t before = test::readFile(path).size();
+            OPENVOX_CHECK(regions.compact());
+            std::vector<u8> data = test::readFile(path);
+            OPENVOX_CHECK(data.size() < before / 3);
+            Chunk loaded(i32v3(1, 0, 0));
+            OPENVOX_CHECK(regions.loadChunk(loaded) && std::memcmp(loaded.getBlockData(), b.getBlockData(), sizeof(BlockID) * CHUNK_SIZE) == 0);
+        }
+
+        // Flip a byte in the last chunk's data, compaction wrote them in table order so it is b
+        std::string path = dir.getPath("r.0.0.0.ovr");
+        std::vector<u8> data = test::readFile(path);
+        data[data.size() - 10] ^= 0x01;
+        test::writeFile(path, data);
+        RegionStore regions;
+        OPENVOX_CHECK(regions.open(dir.getPath()));
+        Chunk damaged(i32v3(1, 0, 0));
+        damaged.setBlock(0, 999);
+        Chunk other(i32v3(0, 0, 0));
+        OPENVOX_CHECK(!regions.loadChunk(damaged) && damaged.getBlockData()[0] == 999);
+        OPENVOX_CHECK(regions.loadChunk(other) && std::memcmp(other.getBlockData(), a.getBlockData(), sizeof(BlockID) * CHUNK_SIZE) == 0);
+    });
+
+    return test::finish();
+}
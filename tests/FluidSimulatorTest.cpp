@@ -0,0 +1,181 @@
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "jobs/JobSystem.h"
+#include "math/BitMath.hpp"
+#include "sim/FluidSimulator.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 BASIN_MIN(0, 0, 0);
+    const i32v3 BASIN_MAX(1, 0, 1);
+
+    // Chunks in the basin with a stone floor at y = 0 and a wall across the middle
+    void buildBasin(ChunkMap& map) {
+        for (i32 cz = BASIN_MIN.z; cz <= BASIN_MAX.z; cz++) {
+            for (i32 cx = BASIN_MIN.x; cx <= BASIN_MAX.x; cx++) {
+                Chunk* chunk = map.createChunk(i32v3(cx, 0, cz));
+                for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                    for (i32 x = 0; x < CHUNK_WIDTH; x++) chunk->setBlock(x, 0, z, 1);
+                }
+            }
+        }
+        for (i32 z = 0; z < 40; z++) {
+            for (i32 y = 1; y < 6; y++) map.setBlock(i32v3(30, y, z), 1);
+        }
+    }
+
+    void pourColumn(FluidSimulator& fluids, const i32v3& min, const i32v3& max) {
+        for (i32 y = min.y; y <= max.y; y++) {
+            for (i32 z = min.z; z <= max.z; z++) {
+                for (i32 x = min.x; x <= max.x; x++) fluids.setFluid(i32v3(x, y, z), packFluid(FluidType::WATER, FLUID_MAX_LEVEL));
+            }
+        }
+    }
+
+    std::vector<u8> readCells(const FluidSimulator& fluids) {
+        std::vector<u8> cells;
+        cells.reserve(4 * CHUNK_SIZE);
+        for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+            for (i32 z = 0; z < 2 * CHUNK_WIDTH; z++) {
+                for (i32 x = 0; x < 2 * CHUNK_WIDTH; x++) cells.push_back(fluids.getFluid(i32v3(x, y, z)));
+            }
+        }
+        return cells;
+    }
+
+    u64 getMass(const std::vector<u8>& cells) {
+        u64 mass = 0;
+        for (u8 c : cells) mass += getFluidLevel(c);
+        return mass;
+    }
+}
+
+int main() {
+    test::run("bit math matches naive loops", [] {
+        test::Random random(54);
+        bool ok = true;
+        for (int i = 0; i < 10000; i++) {
+            u64 v = random.next() >> random.range(0, 63);
+            if (!v) continue;
+            u32 count = 0, low = 64, high = 0;
+            for (u32 b = 0; b < 64; b++) {
+                if (!(v >> b & 1)) continue;
+                count++;
+                if (low == 64) low = b;
+                high = b;
+            }
+            ok &= math::popCount(v) == count && math::bitScanForward(v) == low && math::bitScanReverse(v) == high;
+        }
+        OPENVOX_CHECK(ok);
+        OPENVOX_CHECK(math::bitRange(0, 63) == ~0ull);
+        OPENVOX_CHECK(math::bitRange(3, 5) == 0x38ull);
+    });
+
+    test::run("dam break conserves mass and settles", [] {
+        ChunkMap map;
+        buildBasin(map);
+        FluidSimulator fluids(&map);
+        pourColumn(fluids, i32v3(4, 1, 4), i32v3(11, 20, 11));
+        const u64 poured = 8 * 8 * 20 * FLUID_MAX_LEVEL;
+
+        bool conserved = true;
+        int ticks = 0;
+        do {
+            fluids.tick();
+            conserved &= getMass(readCells(fluids)) == poured;
+        } while (fluids.getLastTickCellCount() > 0 && ++ticks < 2000);
+        OPENVOX_CHECK(conserved);
+        OPENVOX_CHECK(ticks < 2000);
+        // Nothing flowed through the floor or the wall
+        OPENVOX_CHECK(fluids.getFluid(i32v3(8, 0, 8)) == 0);
+        OPENVOX_CHECK(fluids.getFluid(i32v3(30, 1, 8)) == 0);
+        // The pool spread away from where it was poured, and the column fell
+        OPENVOX_CHECK(getFluidLevel(fluids.getFluid(i32v3(16, 1, 8))) > 0);
+        OPENVOX_CHECK(fluids.getFluid(i32v3(8, 20, 8)) == 0);
+    });
+
+    test::run("parallel and budgeted ticks match serial ticks", [] {
+        ChunkMap map;
+        buildBasin(map);
+        FluidSimulator serial(&map), parallel(&map), budgeted(&map);
+        pourColumn(serial, i32v3(20, 1, 28), i32v3(40, 12, 36));
+        pourColumn(parallel, i32v3(20, 1, 28), i32v3(40, 12, 36));
+        pourColumn(budgeted, i32v3(20, 1, 28), i32v3(40, 12, 36));
+        budgeted.setCellBudget(2000);
+
+        JobSystem jobs;
+        jobs.init(3);
+        int splitTicks = 0;
+        for (int t = 0; t < 60; t++) {
+            serial.tick();
+            parallel.tick(&jobs);
+            int calls = 1;
+            while (!budgeted.update()) calls++;
+            if (calls > 1) splitTicks++;
+        }
+        jobs.dispose();
+        std::vector<u8> expected = readCells(serial);
+        OPENVOX_CHECK(readCells(parallel) == expected);
+        OPENVOX_CHECK(readCells(budgeted) == expected);
+        OPENVOX_CHECK(splitTicks > 0);
+    });
+
+    test::run("sources refill and removals drain", [] {
+        ChunkMap map;
+        buildBasin(map);
+        FluidSimulator fluids(&map);
+        fluids.setFluid(i32v3(8, 1, 8), packFluid(FluidType::WATER, FLUID_MAX_LEVEL, true));
+        u64 previous = 0;
+        bool growing = true;
+        for (int t = 0; t < 20; t++) {
+            fluids.tick();
+            u64 mass = getMass(readCells(fluids));
+            growing &= mass >= previous;
+            previous = mass;
+        }
+        OPENVOX_CHECK(growing && previous > FLUID_MAX_LEVEL);
+        OPENVOX_CHECK(isFluidSource(fluids.getFluid(i32v3(8, 1, 8))));
+
+        fluids.setFluid(i32v3(8, 1, 8), 0);
+        fluids.tick();
+        OPENVOX_CHECK(fluids.getFluid(i32v3(8, 1, 8)) == 0 || !isFluidSource(fluids.getFluid(i32v3(8, 1, 8))));
+    });
+
+    test::run("different fluids react", [] {
+        ChunkMap map;
+        buildBasin(map);
+        FluidSimulator fluids(&map);
+        fluids.setReactionBlock(9);
+        for (i32 z = 2; z < 10; z++) {
+            fluids.setFluid(i32v3(4, 1, z), packFluid(FluidType::WATER, FLUID_MAX_LEVEL, true));
+            fluids.setFluid(i32v3(6, 1, z), packFluid(FluidType::LAVA, FLUID_MAX_LEVEL, true));
+        }
+        for (int t = 0; t < 40; t++) fluids.tick();
+        int reacted = 0;
+        for (i32 z = 0; z < 16; z++) {
+            for (i32 x = 0; x < 16; x++) reacted += map.getBlock(i32v3(x, 1, z)) == 9 ? 1 : 0;
+        }
+        OPENVOX_CHECK(reacted > 0);
+    });
+
+    test::run("idle chunks are freed", [] {
+        ChunkMap map;
+        buildBasin(map);
+        FluidSimulator fluids(&map);
+        // Too shallow to spread, so it stays in its cell on the floor
+        fluids.setFluid(i32v3(40, 1, 40), packFluid(FluidType::WATER, 3));
+        fluids.tick();
+        OPENVOX_CHECK(fluids.getFluid(i32v3(40, 1, 40)) == packFluid(FluidType::WATER, 3));
+        OPENVOX_CHECK(fluids.getFluidChunkCount() > 0);
+        fluids.setFluid(i32v3(40, 1, 40), 0);
+        for (int t = 0; t < 10; t++) fluids.tick();
+        OPENVOX_CHECK(getMass(readCells(fluids)) == 0);
+        OPENVOX_CHECK(fluids.getFluidChunkCount() == 0);
+    });
+
+    return test::finish();
+}
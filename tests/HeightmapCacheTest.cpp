@@ -0,0 +1,165 @@
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/HeightmapCache.h"
+
+using namespace openvox;
+
+namespace {
+    const i32 COLUMNS = 4;
+    const i32 CHUNKS_UP = 4;
+    const BlockID GLASS = 2; ///< Surface only
+    const BlockID LEAVES = 3; ///< Motion blocking and surface, lets light through
+    const HeightmapKind KINDS[] = { HeightmapKind::MOTION_BLOCKING, HeightmapKind::OPAQUE, HeightmapKind::SURFACE };
+
+    u8 getKinds(BlockID id) {
+        if (id == BLOCK_AIR) return 0;
+        if (id == GLASS) return getHeightmapBit(HeightmapKind::SURFACE);
+        if (id == LEAVES) return getHeightmapBit(HeightmapKind::MOTION_BLOCKING) | getHeightmapBit(HeightmapKind::SURFACE);
+        return HEIGHTMAP_MASK_ALL;
+    }
+
+    void setKinds(HeightmapCache& cache) {
+        cache.setBlockKinds(GLASS, getKinds(GLASS));
+        cache.setBlockKinds(LEAVES, getKinds(LEAVES));
+    }
+
+    /// Highest loaded block of a kind found by scanning down with getBlock
+    i32 bruteHeight(const ChunkMap& map, HeightmapKind kind, i32 x, i32 z) {
+        for (i32 y = CHUNKS_UP * CHUNK_WIDTH - 1; y >= 0; y--) {
+            if (!map.getChunk(toChunkPosition(i32v3(x, y, z)))) continue;
+            if (getKinds(map.getBlock(i32v3(x, y, z))) & getHeightmapBit(kind)) return y;
+        }
+        return HEIGHTMAP_NONE;
+    }
+
+    int countMismatches(const ChunkMap& map, const HeightmapCache& cache) {
+        int mismatches = 0;
+        for (i32 z = 0; z < COLUMNS * CHUNK_WIDTH; z++) {
+            for (i32 x = 0; x < COLUMNS * CHUNK_WIDTH; x++) {
+                for (HeightmapKind k : KINDS) mismatches += cache.getHeight(k, i32v2(x, z)) != bruteHeight(map, k, x, z) ? 1 : 0;
+            }
+        }
+        return mismatches;
+    }
+
+    void buildWorld(ChunkMap& map, HeightmapCache& cache) {
+        test::buildTerrain(map, i32v3(0), i32v3(COLUMNS - 1, CHUNKS_UP - 1, COLUMNS - 1), 1, 60, 12.0f);
+        for (auto& it : map.getChunks()) cache.addChunk(it.first);
+    }
+}
+
+int main() {
+    test::run("random edits match brute force", [] {
+        ChunkMap map;
+        HeightmapCache cache(&map);
+        setKinds(cache);
+        buildWorld(map, cache);
+        OPENVOX_CHECK(cache.getColumnCount() == COLUMNS * COLUMNS);
+        OPENVOX_CHECK(countMismatches(map, cache) == 0);
+
+        test::Random random(60);
+        VoxelEditor editor(&map);
+        auto* listener = editor.onCommit.addFunctor([&](Sender, const VoxelEditBatch& b) { cache.updateRegion(b); });
+        int mismatches = 0;
+        for (int round = 0; round < 12; round++) {
+            for (int i = 0; i < 2000; i++) {
+                i32 x = random.range(0, COLUMNS * CHUNK_WIDTH - 1), z = random.range(0, COLUMNS * CHUNK_WIDTH - 1);
+                i32v3 p;
+                if (random.range(0, 2) == 0) {
+                    // Dig the top block of some kind, which forces a scan down
+                    i32 h = cache.getHeight(KINDS[random.range(0, 2)], i32v2(x, z));
+                    if (h == HEIGHTMAP_NONE) continue;
+                    p = i32v3(x, h, z);
+                } else {
+                    p = i32v3(x, random.range(30, CHUNKS_UP * CHUNK_WIDTH - 1), z);
+                }
+                BlockID oldID = map.getBlock(p);
+                BlockID newID = (BlockID)random.range(0, 3);
+                if (!map.setBlock(p, newID)) continue;
+                cache.onBlockChanged(p, oldID, newID);
+            }
+            i32v3 a(random.range(0, 120), random.range(20, 120), random.range(0, 120));
+            editor.fillBox(a, a + i32v3(random.range(0, 20), random.range(0, 20), random.range(0, 20)), (BlockID)random.range(0, 3));
+            editor.fillSphere(i32v3(random.range(0, 127), random.range(40, 100), random.range(0, 127)), 8.0f, BLOCK_AIR);
+            editor.commit();
+            mismatches += countMismatches(map, cache);
+
+            // Unload and reload a chunk
+            i32v3 c(random.range(0, COLUMNS - 1), random.range(0, CHUNKS_UP - 1), random.range(0, COLUMNS - 1));
+            cache.removeChunk(c);
+            map.destroyChunk(c);
+            mismatches += countMismatches(map, cache);
+            if (round % 2 == 0) {
+                map.createChunk(c)->fill(round % 4 ? LEAVES : (BlockID)1);
+                cache.addChunk(c);
+            }
+        }
+        editor.onCommit -= *listener;
+        delete listener;
+        OPENVOX_CHECK(mismatches == 0);
+    });
+
+    test::run("saved columns restore and rebase", [] {
+        ChunkMap map;
+        HeightmapCache cache(&map);
+        setKinds(cache);
+        buildWorld(map, cache);
+        std::vector<u8> data;
+        cache.saveColumn(i32v2(1, 2), data);
+
+        // Same minimum Y: heights come back unchanged and the scan is skipped
+        HeightmapCache same(&map);
+        OPENVOX_CHECK(same.loadColumn(i32v2(1, 2), data.data(), data.size()) == data.size());
+        for (i32 y = 0; y < CHUNKS_UP; y++) same.addChunk(i32v3(1, y, 2), true);
+        // Another minimum Y that still holds the heights
+        HeightmapCache rebased(&map, 0);
+        OPENVOX_CHECK(rebased.loadColumn(i32v2(1, 2), data.data(), data.size()) == data.size());
+        int mismatches = 0;
+        for (int i = 0; i < CHUNK_LAYER; i++) {
+            i32v2 xz(CHUNK_WIDTH + i % CHUNK_WIDTH, 2 * CHUNK_WIDTH + i / CHUNK_WIDTH);
+            for (HeightmapKind k : KINDS) {
+                mismatches += same.getHeight(k, xz) != cache.getHeight(k, xz) ? 1 : 0;
+                mismatches += rebased.getHeight(k, xz) != cache.getHeight(k, xz) ? 1 : 0;
+            }
+        }
+        OPENVOX_CHECK(mismatches == 0);
+
+        // Truncated data is rejected
+        OPENVOX_CHECK(rebased.loadColumn(i32v2(0, 0), data.data(), data.size() - 1) == 0);
+        OPENVOX_CHECK(rebased.getColumnCount() == 1);
+    });
+
+    test::run("heights outside the range are rejected", [] {
+        ChunkMap map;
+        HeightmapCache cache(&map);
+        buildWorld(map, cache);
+        std::vector<u8> data;
+        cache.saveColumn(i32v2(0, 0), data);
+
+        // Terrain is around y = 60, below this cache's minimum
+        HeightmapCache high(&map, 100);
+        OPENVOX_CHECK(high.loadColumn(i32v2(0, 0), data.data(), data.size()) == 0);
+        OPENVOX_CHECK(high.getColumnCount() == 0);
+        OPENVOX_CHECK(high.getHeight(HeightmapKind::SURFACE, i32v2(0, 0)) == HEIGHTMAP_NONE);
+
+        // And far above the top of one whose minimum is 0xFFFF below the saved one
+        HeightmapCache low(&map, -32768 - 0xFFFF + 100);
+        OPENVOX_CHECK(low.loadColumn(i32v2(0, 0), data.data(), data.size()) == 0);
+        OPENVOX_CHECK(low.getColumnCount() == 0);
+
+        // A column loaded earlier is left as it was
+        HeightmapCache kept(&map, 0);
+        OPENVOX_CHECK(kept.loadColumn(i32v2(0, 0), data.data(), data.size()) == data.size());
+        std::vector<u8> bad = data;
+        // Packed height 1 is the saved minimum, far below this cache's
+        bad[5] = 1;
+        bad[6] = 0;
+        OPENVOX_CHECK(kept.loadColumn(i32v2(0, 0), bad.data(), bad.size()) == 0);
+        OPENVOX_CHECK(kept.getHeight(HeightmapKind::SURFACE, i32v2(0, 0)) == cache.getHeight(HeightmapKind::SURFACE, i32v2(0, 0)));
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <set>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "jobs/JobSystem.h"
+#include "net/InterestManager.h"
+
+using namespace openvox;
+
+namespace {
+    typedef InterestManager::EntityID EntityID;
+
+    struct PositionLess {
+        bool operator()(const i32v3& a, const i32v3& b) const {
+            return a.x != b.x ? a.x < b.x : a.y != b.y ? a.y < b.y : a.z < b.z;
+        }
+    };
+    typedef std::set<i32v3, PositionLess> ChunkSet;
+
+    ChunkSet bruteChunks(const f32v3& position, i32 radius) {
+        i32v3 c = toChunkPosition(i32v3((i32)std::floor(position.x), (i32)std::floor(position.y), (i32)std::floor(position.z)));
+        ChunkSet s;
+        for (i32 dy = -radius; dy <= radius; dy++) {
+            for (i32 dz = -radius; dz <= radius; dz++) {
+                for (i32 dx = -radius; dx <= radius; dx++) {
+                    if (dx * dx + dy * dy + dz * dz <= radius * radius) s.insert(c + i32v3(dx, dy, dz));
+                }
+            }
+        }
+        return s;
+    }
+
+    i32 distanceSq(const i32v3& a, const i32v3& b) {
+        i32v3 d = a - b;
+        return d.x * d.x + d.y * d.y + d.z * d.z;
+    }
+    f32 distanceSq(const f32v3& a, const f32v3& b) {
+        f32v3 d = a - b;
+        return d.x * d.x + d.y * d.y + d.z * d.z;
+    }
+
+    /// Entities and clients wandering around a 512 voxel box
+    struct Scene {
+        InterestManager manager;
+        std::vector<f32v3> entities;
+        std::vector<bool> alive;
+        std::vector<f32v3> clients;
+        test::Random random;
+
+        Scene(u64 seed, size_t entityCount, size_t clientCount, i32 chunkRadius, f32 entityRadius) :
+            manager(entityRadius), random(seed) {
+            for (size_t i = 0; i < entityCount; i++) {
+                entities.push_back(randomPosition());
+                alive.push_back(true);
+                manager.setEntity((EntityID)i, entities.back());
+            }
+            for (size_t i = 0; i < clientCount; i++) {
+                clients.push_back(randomPosition());
+                manager.addClient((ClientID)i, chunkRadius, entityRadius);
+                manager.setClientPosition((ClientID)i, clients.back());
+            }
+        }
+        f32v3 randomPosition() {
+            return f32v3(random.range(-256.0f, 256.0f), random.range(-64.0f, 64.0f), random.range(-256.0f, 256.0f));
+        }
+        void step(int tick) {
+            for (size_t i = 0; i < entities.size(); i++) {
+                if (!alive[i]) continue;
+                entities[i] += f32v3(random.range(-3.0f, 3.0f), random.range(-1.0f, 1.0f), random.range(-3.0f, 3.0f));
+                manager.setEntity((EntityID)i, entities[i]);
+                if (random.range(0, 999) == 0) {
+                    alive[i] = false;
+                    manager.removeEntity((EntityID)i);
+                }
+            }
+            for (size_t i = 0; i < clients.size(); i++) {
+                // Mostly walking, sometimes teleporting
+                if (tick % 97 == 96) {
+                    clients[i] = randomPosition();
+                } else {
+                    clients[i] += f32v3(random.range(-6.0f, 6.0f), random.range(-2.0f, 2.0f), random.range(-6.0f, 6.0f));
+                }
+                manager.setClientPosition((ClientID)i, clients[i]);
+            }
+        }
+    };
+}
+
+int main() {
+    test::run("random walk matches brute force", [] {
+        const i32 radius = 5;
+        const f32 entityRadius = 48.0f;
+        Scene scene(62, 3000, 4, radius, entityRadius);
+        std::vector<ChunkSet> visible(scene.clients.size());
+        std::vector<std::set<EntityID> > seen(scene.clients.size());
+        int chunkMismatches = 0, entityMismatches = 0, orderErrors = 0, visibleErrors = 0;
+        for (int tick = 0; tick < 500; tick++) {
+            if (tick) scene.step(tick);
+            scene.manager.update();
+            for (ClientID c = 0; c < scene.clients.size(); c++) {
+                const InterestDiff* diff = scene.manager.getDiff(c);
+                for (const i32v3& p : diff->chunksLeft) chunkMismatches += visible[c].erase(p) == 1 ? 0 : 1;
+                for (const i32v3& p : diff->chunksEntered) chunkMismatches += visible[c].insert(p).second ? 0 : 1;
+                for (EntityID e : diff->entitiesLeft) entityMismatches += seen[c].erase(e) == 1 ? 0 : 1;
+                for (EntityID e : diff->entitiesEntered) entityMismatches += seen[c].insert(e).second ? 0 : 1;
+
+                ChunkSet expected = bruteChunks(scene.clients[c], radius);
+                chunkMismatches += visible[c] != expected ? 1 : 0;
+                std::set<EntityID> expectedEntities;
+                for (size_t e = 0; e < scene.entities.size(); e++) {
+                    if (scene.alive[e] && distanceSq(scene.entities[e], scene.clients[c]) <= entityRadius * entityRadius) {
+                        expectedEntities.insert((EntityID)e);
+                    }
+                }
+                entityMismatches += seen[c] != expectedEntities ? 1 : 0;
+                const std::vector<EntityID>* list = scene.manager.getVisibleEntities(c);
+                entityMismatches += std::set<EntityID>(list->begin(), list->end()) != expectedEntities ? 1 : 0;
+
+                // Nearest first
+                i32v3 center = toChunkPosition(i32v3((i32)std::floor(scene.clients[c].x), (i32)std::floor(scene.clients[c].y),
+                                                     (i32)std::floor(scene.clients[c].z)));
+                for (size_t i = 1; i < diff->chunksEntered.size(); i++) {
+                    orderErrors += distanceSq(diff->chunksEntered[i - 1], center) > distanceSq(diff->chunksEntered[i], center) ? 1 : 0;
+                }
+                for (size_t i = 1; i < diff->entitiesEntered.size(); i++) {
+                    orderErrors += distanceSq(scene.entities[diff->entitiesEntered[i - 1]], scene.clients[c]) >
+                                   distanceSq(scene.entities[diff->entitiesEntered[i]], scene.clients[c]) ? 1 : 0;
+                }
+                if (tick % 50 == 0) {
+                    for (i32 dy = -radius - 1; dy <= radius + 1; dy++) {
+                        for (i32 dz = -radius - 1; dz <= radius + 1; dz++) {
+                            for (i32 dx = -radius - 1; dx <= radius + 1; dx++) {
+                                i32v3 p = center + i32v3(dx, dy, dz);
+                                visibleErrors += scene.manager.isChunkVisible(c, p) != (expected.count(p) == 1) ? 1 : 0;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        OPENVOX_CHECK(chunkMismatches == 0);
+        OPENVOX_CHECK(entityMismatches == 0);
+        OPENVOX_CHECK(orderErrors == 0);
+        OPENVOX_CHECK(visibleErrors == 0);
+    });
+
+    test::run("threaded updates match inline updates", [] {
+        Scene inlineScene(620, 2000, 40, 4, 40.0f);
+        Scene threadedScene(620, 2000, 40, 4, 40.0f);
+        JobSystem jobs;
+        jobs.init(3);
+        int mismatches = 0;
+        for (int tick = 0; tick < 60; tick++) {
+            inlineScene.step(tick);
+            threadedScene.step(tick);
+            inlineScene.manager.update();
+            threadedScene.manager.update(&jobs);
+            for (ClientID c = 0; c < 40; c++) {
+                const InterestDiff* a = inlineScene.manager.getDiff(c);
+                const InterestDiff* b = threadedScene.manager.getDiff(c);
+                mismatches += a->chunksEntered != b->chunksEntered || a->chunksLeft != b->chunksLeft ||
+                              a->entitiesEntered != b->entitiesEntered || a->entitiesLeft != b->entitiesLeft ? 1 : 0;
+            }
+        }
+        jobs.dispose();
+        OPENVOX_CHECK(mismatches == 0);
+    });
+
+    test::run("clients can be removed", [] {
+        InterestManager manager;
+        manager.addClient(1, 2, 16.0f);
+        manager.addClient(2, 3, 16.0f);
+        manager.addClient(3, 1, 16.0f);
+        manager.removeClient(1);
+        OPENVOX_CHECK(manager.getClientCount() == 2);
+        OPENVOX_CHECK(manager.getDiff(1) == nullptr);
+        manager.update();
+        // A radius 3 sphere holds 123 chunks and a radius 1 sphere 7
+        OPENVOX_CHECK(manager.getDiff(2)->chunksEntered.size() == 123);
+        OPENVOX_CHECK(manager.getDiff(3)->chunksEntered.size() == 7);
+        OPENVOX_CHECK(!manager.isChunkVisible(1, i32v3(0)));
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,165 @@
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "gen/ColumnCache.h"
+#include "gen/NoiseLattice.h"
+
+using namespace openvox;
+
+namespace {
+    f32 lerp(f32 a, f32 b, f32 t) {
+        return a + (b - a) * t;
+    }
+
+    /// Trilinear interpolation of noise sampled at world multiples of the stride
+    f32 referenceTrilinear(const NoiseLattice::NoiseFunc& noise, const i32v3& p, i32 stride) {
+        i32v3 c(p.x & ~(stride - 1), p.y & ~(stride - 1), p.z & ~(stride - 1));
+        f32v3 t((f32)(p.x - c.x) / stride, (f32)(p.y - c.y) / stride, (f32)(p.z - c.z) / stride);
+        f32 v[2][2][2];
+        for (int y = 0; y < 2; y++) {
+            for (int z = 0; z < 2; z++) {
+                for (int x = 0; x < 2; x++) {
+                    v[y][z][x] = noise(f32v3((f32)(c.x + x * stride), (f32)(c.y + y * stride), (f32)(c.z + z * stride)));
+                }
+            }
+        }
+        f32 l0 = lerp(lerp(v[0][0][0], v[0][0][1], t.x), lerp(v[0][1][0], v[0][1][1], t.x), t.z);
+        f32 l1 = lerp(lerp(v[1][0][0], v[1][0][1], t.x), lerp(v[1][1][0], v[1][1][1], t.x), t.z);
+        return lerp(l0, l1, t.y);
+    }
+
+    NoiseLattice::NoiseFunc getNoise() {
+        return [](const f32v3& p) { return test::getValueNoise(p); };
+    }
+}
+
+int main() {
+    const i32v3 chunks[] = { i32v3(0, 0, 0), i32v3(1, 0, 0), i32v3(-1, 2, -3), i32v3(5, -2, 7) };
+
+    test::run("stride 1 samples every voxel", [&] {
+        NoiseLattice lattice(1);
+        std::vector<f32> values(CHUNK_SIZE);
+        lattice.sampleChunk(chunks[2], getNoise(), values.data());
+        i32v3 origin = toVoxelPosition(chunks[2]);
+        int mismatches = 0;
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            i32v3 p = origin + getVoxelPosition(i);
+            mismatches += values[i] != test::getValueNoise(f32v3((f32)p.x, (f32)p.y, (f32)p.z)) ? 1 : 0;
+        }
+        OPENVOX_CHECK(mismatches == 0);
+        OPENVOX_CHECK(lattice.getSamplesPerChunk() == 33 * 33 * 33);
+    });
+
+    test::run("strides interpolate in world space", [&] {
+        const u32 strides[] = { 2, 4, 8, 16, 32 };
+        NoiseLattice::NoiseFunc noise = getNoise();
+        std::vector<f32> values(CHUNK_SIZE);
+        for (u32 stride : strides) {
+            NoiseLattice lattice(stride);
+            OPENVOX_CHECK(lattice.getPointsPerAxis() == CHUNK_WIDTH / stride + 1);
+            f32 worst = 0.0f;
+            int latticeMismatches = 0;
+            for (const i32v3& c : chunks) {
+                lattice.sampleChunk(c, noise, values.data());
+                i32v3 origin = toVoxelPosition(c);
+                for (int i = 0; i < CHUNK_SIZE; i++) {
+                    i32v3 l = getVoxelPosition(i);
+                    i32v3 p = origin + l;
+                    worst = std::max(worst, std::abs(values[i] - referenceTrilinear(noise, p, (i32)stride)));
+                    // Lattice points are the noise itself
+                    if (l.x % stride == 0 && l.y % stride == 0 && l.z % stride == 0) {
+                        latticeMismatches += values[i] != noise(f32v3((f32)p.x, (f32)p.y, (f32)p.z)) ? 1 : 0;
+                    }
+                }
+            }
+            // Interpolation only depends on the world position, so neighboring chunks meet without seams
+            OPENVOX_CHECK(worst < 1e-5f);
+            OPENVOX_CHECK(latticeMismatches == 0);
+        }
+    });
+
+    test::run("linear functions are reproduced exactly", [] {
+        NoiseLattice::NoiseFunc linear = [](const f32v3& p) { return p.x * 0.25f - p.y * 0.5f + p.z * 0.125f + 3.0f; };
+        NoiseLattice lattice(8);
+        std::vector<f32> values(CHUNK_SIZE);
+        lattice.sampleChunk(i32v3(2, 1, -1), linear, values.data());
+        i32v3 origin = toVoxelPosition(i32v3(2, 1, -1));
+        f32 worst = 0.0f;
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            i32v3 p = origin + getVoxelPosition(i);
+            worst = std::max(worst, std::abs(values[i] - linear(f32v3((f32)p.x, (f32)p.y, (f32)p.z))));
+        }
+        OPENVOX_CHECK(worst < 1e-4f);
+    });
+
+    test::run("column cache computes each column once", [] {
+        u32 stride = 4;
+        auto func = [](f32 x, f32 z) {
+            ColumnSample s;
+            s.height = 64.0f + 20.0f * test::getValueNoise(f32v3(x, 0.0f, z), 3);
+            s.biome = (u16)(((i32)std::floor(x / 4.0f) * 7 + (i32)std::floor(z / 4.0f) * 13) & 15);
+            return s;
+        };
+        ColumnCache cache(func, stride);
+        // 8x8 columns of 8 stacked chunks each
+        for (i32 y = 0; y < 8; y++) {
+            for (i32 z = 0; z < 8; z++) {
+                for (i32 x = 0; x < 8; x++) cache.get(i32v2(x, z));
+            }
+        }
+        OPENVOX_CHECK(cache.getColumnsComputed() == 64);
+        OPENVOX_CHECK(cache.getColumnCount() == 64);
+
+        const ColumnData& data = cache.get(i32v2(-2, 3));
+        f32 worst = 0.0f;
+        int biomeMismatches = 0;
+        for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+            for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                i32 wx = -2 * CHUNK_WIDTH + x, wz = 3 * CHUNK_WIDTH + z;
+                i32 cx = wx & ~3, cz = wz & ~3;
+                f32 tx = (wx - cx) / 4.0f, tz = (wz - cz) / 4.0f;
+                f32 h = lerp(lerp(func((f32)cx, (f32)cz).height, func((f32)cx + 4, (f32)cz).height, tx),
+                             lerp(func((f32)cx, (f32)cz + 4).height, func((f32)cx + 4, (f32)cz + 4).height, tx), tz);
+                worst = std::max(worst, std::abs(data.height[z * CHUNK_WIDTH + x] - h));
+                // Nearest lattice point, half way rounds up
+                i32 nx = (wx + 2) & ~3, nz = (wz + 2) & ~3;
+                biomeMismatches += data.biome[z * CHUNK_WIDTH + x] != func((f32)nx, (f32)nz).biome ? 1 : 0;
+            }
+        }
+        OPENVOX_CHECK(worst < 1e-3f);
+        OPENVOX_CHECK(biomeMismatches == 0);
+
+        cache.removeColumn(i32v2(-2, 3));
+        OPENVOX_CHECK(cache.getColumnCount() == 64);
+        cache.clear();
+        OPENVOX_CHECK(cache.getColumnCount() == 0);
+    });
+
+    test::run("column cache is shared between threads", [] {
+        ColumnCache cache([](f32 x, f32 z) {
+            ColumnSample s = { x * 0.5f + z, 1 };
+            return s;
+        });
+        std::vector<std::thread> threads;
+        std::vector<int> bad(4, 0);
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([&cache, &bad, t]() {
+                for (int i = 0; i < 2000; i++) {
+                    i32v2 c(i % 10, (i / 10 + t) % 10);
+                    const ColumnData& d = cache.get(c);
+                    bad[t] += d.height[0] != c.x * CHUNK_WIDTH * 0.5f + c.y * CHUNK_WIDTH ? 1 : 0;
+                }
+            });
+        }
+        for (std::thread& t : threads) t.join();
+        OPENVOX_CHECK(bad[0] + bad[1] + bad[2] + bad[3] == 0);
+        OPENVOX_CHECK(cache.getColumnCount() == 100);
+        OPENVOX_CHECK(cache.getColumnsComputed() >= 100);
+    });
+
+    return test::finish();
+}
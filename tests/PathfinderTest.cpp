@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "ai/Pathfinder.h"
+#include "jobs/JobSystem.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 WORLD_MIN(0, 0, 0);
+    const i32v3 WORLD_MAX(5, 1, 5);
+
+    bool solid(const ChunkMap& map, const i32v3& p) {
+        // Unloaded chunks block walkers, like they do in the pathfinder
+        return map.getBlock(p, 1) != BLOCK_AIR;
+    }
+    bool walkable(const ChunkMap& map, const i32v3& p) {
+        return !solid(map, p) && !solid(map, p + i32v3(0, 1, 0)) && solid(map, p - i32v3(0, 1, 0));
+    }
+
+    /// Cost of a legal single move from a to b, or PATH_NO_COST
+    u32 getMoveCost(const ChunkMap& map, const i32v3& a, const i32v3& b) {
+        i32 dx = b.x - a.x, dz = b.z - a.z, dy = b.y - a.y;
+        if (std::abs(dx) + std::abs(dz) != 1 || !walkable(map, b)) return PATH_NO_COST;
+        if (dy == 1) {
+            if (!solid(map, i32v3(b.x, a.y, b.z)) || solid(map, a + i32v3(0, 2, 0))) return PATH_NO_COST;
+            return PATH_MOVE_COST + PATH_CLIMB_COST;
+        }
+        if (dy > 0 || dy < -PATH_MAX_DROP) return PATH_NO_COST;
+        for (i32 y = b.y; y <= a.y + 1; y++) {
+            if (solid(map, i32v3(b.x, y, b.z))) return PATH_NO_COST;
+        }
+        return PATH_MOVE_COST + PATH_DROP_COST * (u32)(-dy);
+    }
+
+    /// Exact shortest path cost with Dijkstra over every walkable cell
+    u32 referenceCost(const ChunkMap& map, const i32v3& start, const i32v3& goal) {
+        typedef std::pair<u32, i32v3> Entry;
+        auto cmp = [](const Entry& a, const Entry& b) { return a.first > b.first; };
+        std::priority_queue<Entry, std::vector<Entry>, decltype(cmp)> open(cmp);
+        std::unordered_map<i32v3, u32, PositionHash> best;
+        open.push(Entry(0, start));
+        best[start] = 0;
+        while (!open.empty()) {
+            Entry e = open.top();
+            open.pop();
+            if (e.second == goal) return e.first;
+            if (best[e.second] < e.first) continue;
+            const i32 dirs[4][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
+            for (int d = 0; d < 4; d++) {
+                for (i32 dy = -PATH_MAX_DROP; dy <= 1; dy++) {
+                    i32v3 n = e.second + i32v3(dirs[d][0], dy, dirs[d][1]);
+                    u32 c = getMoveCost(map, e.second, n);
+                    if (c == PATH_NO_COST) continue;
+                    auto it = best.find(n);
+                    if (it == best.end() || e.first + c < it->second) {
+                        best[n] = e.first + c;
+                        open.push(Entry(e.first + c, n));
+                    }
+                }
+            }
+        }
+        return PATH_NO_COST;
+    }
+
+    void buildWorld(ChunkMap& map, test::Random& random, bool obstacles) {
+        test::buildTerrain(map, WORLD_MIN, WORLD_MAX, 1, 16, 6.0f);
+        if (!obstacles) return;
+        // Walls with gaps and a few deep pits, so paths have to detour
+        for (int i = 0; i < 60; i++) {
+            i32 x = random.range(4, 188), z = random.range(4, 188);
+            bool alongX = random.range(0, 1) == 0;
+            i32 length = random.range(6, 30);
+            for (i32 k = 0; k < length; k++) {
+                i32v3 column = alongX ? i32v3(x + k, 0, z) : i32v3(x, 0, z + k);
+                if (column.x >= 192 || column.z >= 192) break;
+                i32 h = test::getTerrainHeight(column.x, column.z, 16, 6.0f);
+                for (i32 y = 1; y <= 4; y++) map.setBlock(i32v3(column.x, h + y, column.z), 1);
+            }
+        }
+        for (int i = 0; i < 20; i++) {
+            i32 x = random.range(4, 180), z = random.range(4, 180);
+            for (i32 dz = 0; dz < 6; dz++) {
+                for (i32 dx = 0; dx < 6; dx++) {
+                    for (i32 y = 2; y <= 24; y++) map.setBlock(i32v3(x + dx, y, z + dz), BLOCK_AIR);
+                }
+            }
+        }
+    }
+
+    i32v3 randomWalkable(const ChunkMap& map, test::Random& random) {
+        for (;;) {
+            i32 x = random.range(0, 191), z = random.range(0, 191);
+            for (i32 y = 62; y > 0; y--) {
+                if (walkable(map, i32v3(x, y, z))) return i32v3(x, y, z);
+            }
+        }
+    }
+
+    void addAll(Pathfinder& pathfinder) {
+        for (i32 y = WORLD_MIN.y; y <= WORLD_MAX.y; y++) {
+            for (i32 z = WORLD_MIN.z; z <= WORLD_MAX.z; z++) {
+                for (i32 x = WORLD_MIN.x; x <= WORLD_MAX.x; x++) pathfinder.addChunk(i32v3(x, y, z));
+            }
+        }
+    }
+
+    /// Checks that a path is a chain of legal moves from start to goal and returns its cost
+    u32 walkPath(const ChunkMap& map, const i32v3& start, const i32v3& goal, const std::vector<i32v3>& path) {
+        if (path.empty() || path.back() != goal) return PATH_NO_COST;
+        u32 cost = 0;
+        i32v3 at = start;
+        for (const i32v3& p : path) {
+            u32 c = getMoveCost(map, at, p);
+            if (c == PATH_NO_COST) return PATH_NO_COST;
+            cost += c;
+            at = p;
+        }
+        return cost;
+    }
+    void checkQueries(const char* name, bool obstacles, f64 maxWorst, f64 maxMean) {
+        test::run(name, [=] {
+            ChunkMap map;
+            test::Random random(56);
+            buildWorld(map, random, obstacles);
+            Pathfinder pathfinder(&map);
+            addAll(pathfinder);
+
+            int found = 0, legal = 0, agreed = 0, measured = 0, queries = 60;
+            f64 worstRatio = 1.0, ratioSum = 0.0;
+            for (int q = 0; q < queries; q++) {
+                i32v3 start = randomWalkable(map, random);
+                i32v3 goal = randomWalkable(map, random);
+                if (start == goal) goal = randomWalkable(map, random);
+                std::vector<i32v3> path;
+                u32 cost = 0;
+                PathStatus status = pathfinder.findPath(start, goal, path, &cost);
+                u32 optimal = referenceCost(map, start, goal);
+                agreed += (status == PathStatus::FOUND) == (optimal != PATH_NO_COST) ? 1 : 0;
+                if (status != PathStatus::FOUND) continue;
+                found++;
+                if (walkPath(map, start, goal, path) == cost) legal++;
+                if (optimal == PATH_NO_COST || optimal == 0) continue;
+                f64 ratio = (f64)cost / optimal;
+                worstRatio = std::max(worstRatio, ratio);
+                ratioSum += ratio;
+                measured++;
+            }
+            f64 meanRatio = measured ? ratioSum / measured : 1.0;
+            OPENVOX_CHECK(agreed == queries);
+            OPENVOX_CHECK(found > queries / 2);
+            OPENVOX_CHECK(legal == found);
+            OPENVOX_CHECK(worstRatio <= maxWorst);
+            OPENVOX_CHECK(meanRatio <= maxMean);
+            std::printf("  %d/%d found, cost %.3fx optimal on average, %.3fx worst\n", found, queries, meanRatio, worstRatio);
+        });
+    }
+}
+
+int main() {
+    // Routes that cross one or two clusters pay the most for entrance placement,
+    // and walls and pits force detours through entrances.
+    checkQueries("heightmap paths are legal and near optimal", false, 1.7, 1.1);
+    checkQueries("obstacle paths are legal and near optimal", true, 1.6, 1.1);
+
+    test::run("edits invalidate clusters", [] {
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(0, 0, 0), i32v3(2, 0, 0), 1, 8, 0.0f);
+        Pathfinder pathfinder(&map);
+        for (i32 x = 0; x <= 2; x++) pathfinder.addChunk(i32v3(x, 0, 0));
+        i32v3 start(2, 9, 16), goal(90, 9, 16);
+        std::vector<i32v3> path;
+        u32 before = 0;
+        OPENVOX_CHECK(pathfinder.findPath(start, goal, path, &before) == PathStatus::FOUND);
+
+        // Wall across the whole world at x = 40, three blocks tall
+        for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+            for (i32 y = 9; y <= 11; y++) {
+                map.setBlock(i32v3(40, y, z), 1);
+                pathfinder.invalidateVoxel(i32v3(40, y, z));
+            }
+        }
+        OPENVOX_CHECK(pathfinder.getDirtyClusterCount() > 0);
+        OPENVOX_CHECK(pathfinder.findPath(start, goal, path) == PathStatus::NO_PATH);
+
+        // Lower one column to a single step, which can be climbed
+        for (i32 y = 10; y <= 11; y++) {
+            map.setBlock(i32v3(40, y, 20), BLOCK_AIR);
+            pathfinder.invalidateVoxel(i32v3(40, y, 20));
+        }
+        u32 after = 0;
+        OPENVOX_CHECK(pathfinder.findPath(start, goal, path, &after) == PathStatus::FOUND);
+        OPENVOX_CHECK(after > before);
+        OPENVOX_CHECK(std::find(path.begin(), path.end(), i32v3(40, 10, 20)) != path.end());
+
+        OPENVOX_CHECK(pathfinder.findPath(start, i32v3(90, 30, 16), path) == PathStatus::INVALID_ENDPOINT);
+        pathfinder.removeChunk(i32v3(2, 0, 0));
+        OPENVOX_CHECK(pathfinder.findPath(start, goal, path) == PathStatus::INVALID_ENDPOINT);
+    });
+
+    test::run("batched requests match immediate queries", [] {
+        ChunkMap map;
+        test::Random random(560);
+        buildWorld(map, random, true);
+        Pathfinder pathfinder(&map);
+        addAll(pathfinder);
+        JobSystem jobs;
+        jobs.init(3);
+
+        std::vector<std::pair<i32v3, i32v3> > queries;
+        std::unordered_map<PathRequestID, size_t> ids;
+        for (int q = 0; q < 40; q++) {
+            queries.push_back(std::make_pair(randomWalkable(map, random), randomWalkable(map, random)));
+            ids[pathfinder.requestPath(queries.back().first, queries.back().second)] = queries.size() - 1;
+        }
+        std::vector<PathResult> results;
+        auto* listener = pathfinder.onPathComplete.addFunctor([&](Sender, const PathResult& r) { results.push_back(r); });
+        pathfinder.update(&jobs);
+        pathfinder.onPathComplete -= *listener;
+        delete listener;
+        jobs.dispose();
+
+        OPENVOX_CHECK(results.size() == queries.size());
+        OPENVOX_CHECK(pathfinder.getPendingRequestCount() == 0);
+        bool same = true;
+        for (const PathResult& r : results) {
+            const std::pair<i32v3, i32v3>& q = queries[ids[r.id]];
+            std::vector<i32v3> path;
+            u32 cost = 0;
+            PathStatus status = pathfinder.findPath(q.first, q.second, path, &cost);
+            same &= status == r.status && (status != PathStatus::FOUND || (cost == r.cost && path == r.path));
+        }
+        OPENVOX_CHECK(same);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,290 @@
+#include <cstring>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "io/Serialization.hpp"
+
+using namespace openvox;
+
+namespace {
+    enum class Shape : u8 { CUBE, SLAB, STAIRS };
+
+    const u32 TAG_OUTER = 1;
+    const u32 TAG_INNER = 2;
+    const u32 TAG_MISSING = 3; ///< Known to the reader, never written
+    const u32 TAG_UNKNOWN = 99;
+
+    /// Writes one of everything, in an order that leaves the bit packer unaligned between values
+    void writeAll(BinaryWriter& w) {
+        w.write((u8)0xAB);
+        w.write((i16)-12345);
+        w.writeBits(5, 3);
+        w.write((u32)0xDEADBEEF);
+        w.write((i64)-1234567890123LL);
+        w.write(3.5f);
+        w.write(-0.125);
+        w.write(Shape::STAIRS);
+        w.write(i32v3(-1, 2, -3));
+        w.write(f32v2(0.5f, -2.0f));
+        w.write(u8v4(1, 2, 3, 255));
+        w.writeVarint(0);
+        w.writeVarint(127);
+        w.writeVarint(128);
+        w.writeVarint(~(u64)0);
+        w.writeZigZag(-1);
+        w.writeZigZag(INT64_MIN);
+        w.writeZigZag(INT64_MAX);
+        const u16 ids[] = { 1, 2, 0xFFFF };
+        w.writeArray(ids, 3);
+        w.writeBlob("hello", 5);
+        w.writeBlob(nullptr, 0);
+    }
+
+    bool readAll(BinaryReader& r) {
+        u8 a = 0; i16 b = 0; u32 bits = 0, c = 0; i64 d = 0; f32 e = 0; f64 f = 0; Shape g = Shape::CUBE;
+        i32v3 h; f32v2 i; u8v4 j;
+        u64 v0 = 1, v1 = 0, v2 = 0, v3 = 0;
+        i64 z0 = 0, z1 = 0, z2 = 0;
+        BinaryArrayView<u16> ids;
+        const u8* blob = nullptr; size_t blobSize = 0;
+        const u8* empty = nullptr; size_t emptySize = 1;
+        r.read(a); r.read(b); r.readBits(3, bits); r.read(c); r.read(d); r.read(e); r.read(f); r.read(g);
+        r.read(h); r.read(i); r.read(j);
+        r.readVarint(v0); r.readVarint(v1); r.readVarint(v2); r.readVarint(v3);
+        r.readZigZag(z0); r.readZigZag(z1); r.readZigZag(z2);
+        r.readArray(3, ids);
+        r.readBlob(blob, blobSize);
+        if (!r.readBlob(empty, emptySize) || r.hasFailed()) return false;
+        u16 copy[3];
+        ids.copyTo(copy);
+        return a == 0xAB && b == -12345 && bits == 5 && c == 0xDEADBEEF && d == -1234567890123LL && e == 3.5f &&
+               f == -0.125 && g == Shape::STAIRS && h == i32v3(-1, 2, -3) && i == f32v2(0.5f, -2.0f) &&
+               j == u8v4(1, 2, 3, 255) && v0 == 0 && v1 == 127 && v2 == 128 && v3 == ~(u64)0 && z0 == -1 &&
+               z1 == INT64_MIN && z2 == INT64_MAX && ids.size() == 3 && ids[2] == 0xFFFF && copy[0] == 1 &&
+               copy[1] == 2 && blobSize == 5 && std::memcmp(blob, "hello", 5) == 0 && emptySize == 0 && r.isEnd();
+    }
+
+    bool readsVarint(const std::vector<u8>& bytes, u64& v) {
+        BinaryReader r(bytes.data(), bytes.size());
+        return r.readVarint(v) && !r.hasFailed();
+    }
+}
+
+int main() {
+    test::run("every encoding round trips", [] {
+        std::vector<u8> buffer;
+        {
+            BinaryWriter w(buffer);
+            writeAll(w);
+        }
+        BinaryReader r(buffer.data(), buffer.size());
+        OPENVOX_CHECK(readAll(r));
+    });
+
+    test::run("varints take the fewest bytes", [] {
+        const u64 values[] = { 0, 1, 127, 128, 16383, 16384, (u64)1 << 63, ~(u64)0 };
+        const size_t sizes[] = { 1, 1, 1, 2, 2, 3, VARINT_MAX_SIZE, VARINT_MAX_SIZE };
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+            std::vector<u8> buffer;
+            BinaryWriter w(buffer);
+            w.writeVarint(values[i]);
+            w.finish();
+            u64 v = 0;
+            OPENVOX_CHECK(buffer.size() == sizes[i]);
+            OPENVOX_CHECK(readsVarint(buffer, v) && v == values[i]);
+        }
+    });
+
+    test::run("random bit packing round trips", [] {
+        test::Random random(64);
+        std::vector<u32> values, widths;
+        std::vector<u8> buffer;
+        BinaryWriter w(buffer);
+        for (int i = 0; i < 10000; i++) {
+            u32 bits = (u32)random.range(0, 32);
+            u32 v = (u32)random.next() & (bits ? 0xFFFFFFFFu >> (32 - bits) : 0);
+            values.push_back(v);
+            widths.push_back(bits);
+            w.writeBits(v, bits);
+        }
+        w.write((u8)0x5A);
+        w.finish();
+        BinaryReader r(buffer.data(), buffer.size());
+        int mismatches = 0;
+        for (size_t i = 0; i < values.size(); i++) {
+            u32 v = ~0u;
+            if (!r.readBits(widths[i], v) || v != values[i]) mismatches++;
+        }
+        u8 tail = 0;
+        OPENVOX_CHECK(mismatches == 0);
+        OPENVOX_CHECK(r.read(tail) && tail == 0x5A && r.isEnd());
+    });
+
+    test::run("an array right after packed bits round trips", [] {
+        const u8 items[4] = { 1, 2, 3, 4 };
+        std::vector<u8> buffer;
+        BinaryWriter w(buffer);
+        w.writeBits(5, 4);
+        w.writeArray(items, 4);
+        w.finish();
+        OPENVOX_CHECK(buffer.size() == 5);
+        // readBits() loads whole words ahead, so the array must be checked against what is left after aligning
+        BinaryReader r(buffer.data(), buffer.size());
+        u32 bits = 0;
+        BinaryArrayView<u8> view;
+        OPENVOX_CHECK(r.readBits(4, bits) && bits == 5);
+        OPENVOX_CHECK(r.readArray(4, view) && view.size() == 4 && r.isEnd());
+        OPENVOX_CHECK(view[0] == 1 && view[1] == 2 && view[2] == 3 && view[3] == 4);
+        // One more item than was written still fails
+        BinaryReader over(buffer.data(), buffer.size());
+        OPENVOX_CHECK(over.readBits(4, bits) && !over.readArray(5, view) && over.hasFailed());
+    });
+
+    test::run("nested fields skip unknown tags and keep defaults", [] {
+        std::vector<u8> buffer;
+        {
+            BinaryWriter w(buffer);
+            w.beginField(TAG_UNKNOWN);
+            w.writeBlob("future data", 11);
+            w.writeBits(3, 2);
+            w.endField();
+            w.beginField(TAG_OUTER);
+            w.write((u32)7);
+            w.beginField(TAG_INNER);
+            w.writeZigZag(-42);
+            w.endField();
+            w.beginField(TAG_UNKNOWN);
+            w.endField();
+            w.endField();
+        }
+        u32 outer = 0, tag;
+        i32 inner = 0, missing = 11;
+        int unknown = 0;
+        BinaryReader r(buffer.data(), buffer.size()), field;
+        while (r.readField(tag, field)) {
+            if (tag != TAG_OUTER) {
+                unknown++;
+                continue;
+            }
+            field.read(outer);
+            BinaryReader sub;
+            while (field.readField(tag, sub)) {
+                if (tag == TAG_INNER) sub.readZigZag(inner);
+                else if (tag == TAG_MISSING) sub.readZigZag(missing);
+                else unknown++;
+            }
+            OPENVOX_CHECK(!field.hasFailed());
+        }
+        OPENVOX_CHECK(!r.hasFailed() && r.isEnd());
+        OPENVOX_CHECK(outer == 7 && inner == -42 && missing == 11 && unknown == 2);
+    });
+
+    test::run("every truncation fails and leaves outputs unchanged", [] {
+        std::vector<u8> buffer;
+        {
+            BinaryWriter w(buffer);
+            writeAll(w);
+        }
+        int accepted = 0;
+        for (size_t size = 0; size < buffer.size(); size++) {
+            BinaryReader r(buffer.data(), size);
+            if (readAll(r) || !r.hasFailed()) accepted++;
+        }
+        OPENVOX_CHECK(accepted == 0);
+
+        // A failed reader stays failed
+        BinaryReader r(buffer.data(), 1);
+        u16 v = 0x1234;
+        u8 b = 0;
+        OPENVOX_CHECK(!r.read(v) && v == 0x1234);
+        OPENVOX_CHECK(!r.read(b) && b == 0 && r.hasFailed() && r.isEnd());
+    });
+
+    test::run("truncated or oversized fields and blobs fail", [] {
+        std::vector<u8> buffer;
+        {
+            BinaryWriter w(buffer);
+            w.beginField(TAG_OUTER);
+            w.write((u64)1);
+            w.endField();
+        }
+        u32 tag;
+        BinaryReader field;
+        BinaryReader r(buffer.data(), buffer.size() - 1);
+        OPENVOX_CHECK(!r.readField(tag, field) && r.hasFailed());
+
+        const u8 hugeBlob[] = { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F, 1, 2 };
+        const u8* data = nullptr;
+        size_t size = 0;
+        BinaryReader b(hugeBlob, sizeof(hugeBlob));
+        OPENVOX_CHECK(!b.readBlob(data, size) && data == nullptr && b.hasFailed());
+
+        BinaryArrayView<u32> view;
+        BinaryReader a(hugeBlob, sizeof(hugeBlob));
+        OPENVOX_CHECK(!a.readArray(~(size_t)0 / 2, view) && a.hasFailed());
+    });
+
+    test::run("overlong and out of range varints fail", [] {
+        u64 v = 0;
+        // Eleven bytes, and ten bytes whose last one still continues
+        std::vector<u8> overlong(11, 0x80);
+        overlong.back() = 0;
+        OPENVOX_CHECK(!readsVarint(overlong, v));
+        overlong.resize(VARINT_MAX_SIZE);
+        overlong.back() = 0x81;
+        OPENVOX_CHECK(!readsVarint(overlong, v));
+
+        // The tenth byte only has room for bit 63
+        std::vector<u8> max(VARINT_MAX_SIZE, 0xFF);
+        max.back() = 0x01;
+        OPENVOX_CHECK(readsVarint(max, v) && v == ~(u64)0);
+        for (u8 last : { 0x02, 0x03, 0x40, 0x7F }) {
+            max.back() = last;
+            OPENVOX_CHECK(!readsVarint(max, v));
+        }
+
+        // Values that do not fit the destination type
+        std::vector<u8> buffer;
+        {
+            BinaryWriter w(buffer);
+            w.writeVarint(256);
+            w.writeZigZag(128);
+        }
+        u8 small = 7;
+        BinaryReader r(buffer.data(), buffer.size());
+        OPENVOX_CHECK(!r.readVarint(small) && small == 7 && r.hasFailed());
+        i8 signedSmall = 7;
+        BinaryReader s(buffer.data() + 2, buffer.size() - 2);
+        OPENVOX_CHECK(!s.readZigZag(signedSmall) && signedSmall == 7 && s.hasFailed());
+    });
+
+    test::run("writer appends to existing data and trims on finish", [] {
+        std::vector<u8> buffer(3, 0xEE);
+        BinaryWriter w(buffer);
+        for (int i = 0; i < 1000; i++) w.writeVarint((u64)i * 1000);
+        w.writeBits(1, 1);
+        size_t size = w.getSize();
+        w.finish();
+        OPENVOX_CHECK(buffer.size() == size && buffer[0] == 0xEE && buffer[2] == 0xEE);
+        BinaryReader r(buffer.data(), buffer.size());
+        OPENVOX_CHECK(r.skip(3));
+        int mismatches = 0;
+        for (int i = 0; i < 1000; i++) {
+            u64 v;
+            if (!r.readVarint(v) || v != (u64)i * 1000) mismatches++;
+        }
+        u32 bit = 0;
+        OPENVOX_CHECK(mismatches == 0 && r.readBits(1, bit) && bit == 1 && r.isEnd());
+    });
+
+    test::run("crc32 matches the standard check value and chains", [] {
+        const char* text = "123456789";
+        const u8* p = reinterpret_cast<const u8*>(text);
+        OPENVOX_CHECK(crc32(p, 9) == 0xCBF43926u);
+        OPENVOX_CHECK(crc32(p + 4, 5, crc32(p, 4)) == 0xCBF43926u);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,318 @@
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "sim/SimulationLod.h"
+
+using namespace openvox;
+
+namespace {
+    const f32 TICK = 0.05f;
+    const i32 RADIUS = 6; ///< Chunks loaded around the origin on x and z
+    const i32 HEIGHT = 3;
+    const u32 ENTITIES = 300;
+
+    /// Tiers small enough that a few chunks span all of them, the last one bounded so far
+    /// chunks go dormant
+    std::vector<SimulationTier> makeTiers() {
+        std::vector<SimulationTier> tiers;
+        tiers.push_back({ 24.0f, 1 });
+        tiers.push_back({ 56.0f, 2 });
+        tiers.push_back({ 96.0f, 3 });
+        tiers.push_back({ 150.0f, 8 });
+        return tiers;
+    }
+
+    /// Tier of a chunk found independently of SimulationLod
+    u8 referenceTier(const std::vector<SimulationTier>& tiers, const std::vector<f32v3>& players, const i32v3& chunkPos) {
+        f64 nearest = std::numeric_limits<f64>::infinity();
+        for (const f32v3& p : players) {
+            f64 d2 = 0.0;
+            for (int i = 0; i < 3; i++) {
+                f64 lo = (f64)chunkPos[i] * CHUNK_WIDTH, hi = lo + CHUNK_WIDTH;
+                f64 d = p[i] < lo ? lo - p[i] : (p[i] > hi ? p[i] - hi : 0.0);
+                d2 += d * d;
+            }
+            nearest = std::min(nearest, std::sqrt(d2));
+        }
+        for (size_t t = 0; t < tiers.size(); t++) {
+            if (nearest <= tiers[t].maxDistance) return (u8)t;
+        }
+        return SIMULATION_TIER_NONE;
+    }
+
+    i32v3 chunkOf(const f32v3& p) {
+        return toChunkPosition(i32v3((i32)std::floor(p.x), (i32)std::floor(p.y), (i32)std::floor(p.z)));
+    }
+
+    /// What a member received since it joined
+    struct Received {
+        u64 joined = 0;
+        f64 time = 0.0; ///< Seconds for entities, ticks for chunks
+        u64 lastTick = 0;
+        bool simulated = false;
+        u32 updatesThisTick = 0;
+    };
+
+    /// Time up to the end of the last simulated tick must equal what was handed out
+    bool accountsForTime(const Received& r, f64 unit) {
+        if (!r.simulated) return r.time == 0.0;
+        return std::fabs(r.time - (f64)(r.lastTick + 1 - r.joined) * unit) < 1e-3;
+    }
+
+    struct World {
+        SimulationLod lod;
+        std::vector<SimulationTier> tiers = makeTiers();
+        std::vector<f32v3> players;
+        std::vector<f32v3> tierPlayers; ///< Positions at the last chunk crossing, which tiers are computed from
+        std::vector<f32v3> entities;
+        std::vector<u8> entityPresent;
+        std::vector<i32v3> chunks;
+        std::unordered_map<i32v3, u8, PositionHash> chunkPresent;
+        std::vector<Received> entityReceived;
+        std::unordered_map<i32v3, Received, PositionHash> chunkReceived;
+        test::Random random;
+        int failures = 0;
+
+        World(u64 seed) : lod(TICK), random(seed) {
+            lod.setTiers(tiers);
+            players.push_back(f32v3(0.5f, 40.0f, 0.5f));
+            setPlayers();
+            for (i32 y = 0; y < HEIGHT; y++) {
+                for (i32 z = -RADIUS; z <= RADIUS; z++) {
+                    for (i32 x = -RADIUS; x <= RADIUS; x++) addChunk(i32v3(x, y, z));
+                }
+            }
+            for (u32 id = 0; id < ENTITIES; id++) setEntity(id, randomPosition());
+        }
+
+        f32v3 randomPosition() {
+            f32 extent = (f32)(RADIUS * CHUNK_WIDTH);
+            return f32v3(random.range(-extent, extent), random.range(0.0f, (f32)(HEIGHT * CHUNK_WIDTH)), random.range(-extent, extent));
+        }
+        void setPlayers() {
+            bool crossed = players.size() != tierPlayers.size();
+            for (size_t i = 0; i < players.size() && !crossed; i++) crossed = chunkOf(players[i]) != chunkOf(tierPlayers[i]);
+            if (crossed) tierPlayers = players;
+            lod.setPlayers(players);
+        }
+        void addChunk(const i32v3& c) {
+            if (chunkPresent[c]) return;
+            chunkPresent[c] = 1;
+            chunks.push_back(c);
+            Received r;
+            r.joined = lod.getTick();
+            chunkReceived[c] = r;
+            lod.addChunk(c);
+        }
+        void removeChunk(size_t i) {
+            if (!accountsForTime(chunkReceived[chunks[i]], 1.0)) failures++;
+            chunkPresent[chunks[i]] = 0;
+            lod.removeChunk(chunks[i]);
+            chunks[i] = chunks.back();
+            chunks.pop_back();
+        }
+        void setEntity(u32 id, const f32v3& p) {
+            if (id >= entities.size()) {
+                entities.resize(id + 1);
+                entityPresent.resize(id + 1, 0);
+                entityReceived.resize(id + 1);
+            }
+            if (!entityPresent[id]) {
+                entityReceived[id] = Received();
+                entityReceived[id].joined = lod.getTick();
+            }
+            entityPresent[id] = 1;
+            entities[id] = p;
+            lod.setEntity(id, p);
+        }
+        void removeEntity(u32 id) {
+            if (!accountsForTime(entityReceived[id], TICK)) failures++;
+            entityPresent[id] = 0;
+            lod.removeEntity(id);
+        }
+
+        void update() {
+            u64 tick = lod.getTick();
+            for (Received& r : entityReceived) r.updatesThisTick = 0;
+            for (auto& it : chunkReceived) it.second.updatesThisTick = 0;
+            lod.update([&](SimulationLod::EntityID id, f32 dt) {
+                Received& r = entityReceived[id];
+                if (!entityPresent[id]) failures++;
+                r.time += dt;
+                r.lastTick = tick;
+                r.simulated = true;
+                r.updatesThisTick++;
+            }, [&](const i32v3& c, u32 ticks) {
+                Received& r = chunkReceived[c];
+                if (!chunkPresent[c]) failures++;
+                r.time += ticks;
+                r.lastTick = tick;
+                r.simulated = true;
+                r.updatesThisTick++;
+            });
+        }
+
+        /// Tiers match the reference and every member was simulated at most once
+        int countTierMismatches() {
+            int mismatches = 0;
+            for (u32 id = 0; id < entities.size(); id++) {
+                if (!entityPresent[id]) continue;
+                if (lod.getEntityTier(id) != referenceTier(tiers, tierPlayers, chunkOf(entities[id]))) mismatches++;
+                if (entityReceived[id].updatesThisTick > 1) mismatches++;
+            }
+            for (const i32v3& c : chunks) {
+                if (lod.getChunkTier(c) != referenceTier(tiers, tierPlayers, c)) mismatches++;
+                if (chunkReceived[c].updatesThisTick > 1) mismatches++;
+            }
+            return mismatches;
+        }
+        int countUnaccounted() {
+            int bad = 0;
+            for (u32 id = 0; id < entities.size(); id++) {
+                if (entityPresent[id] && !accountsForTime(entityReceived[id], TICK)) bad++;
+            }
+            for (const i32v3& c : chunks) {
+                if (!accountsForTime(chunkReceived[c], 1.0)) bad++;
+            }
+            return bad;
+        }
+    };
+}
+
+int main() {
+    test::run("random churn matches reference tiers and accounts for time", [] {
+        World world(66);
+        int mismatches = 0;
+        for (int tick = 0; tick < 300; tick++) {
+            // Players walk, sometimes across chunk boundaries, and occasionally a second one joins
+            for (f32v3& p : world.players) p += f32v3(world.random.range(-6.0f, 6.0f), 0.0f, world.random.range(-6.0f, 6.0f));
+            if (tick == 100) world.players.push_back(f32v3(150.0f, 20.0f, -150.0f));
+            if (tick == 200) world.players.pop_back();
+            world.setPlayers();
+
+            for (int i = 0; i < 40; i++) {
+                u32 id = (u32)world.random.range(0, ENTITIES + 20);
+                if (id < world.entityPresent.size() && world.entityPresent[id] && world.random.range(0, 9) == 0) {
+                    world.removeEntity(id);
+                } else if (id < world.entities.size() && world.entityPresent[id]) {
+                    world.setEntity(id, world.entities[id] + f32v3(world.random.range(-20.0f, 20.0f), 0.0f, world.random.range(-20.0f, 20.0f)));
+                } else {
+                    world.setEntity(id, world.randomPosition());
+                }
+            }
+            if (world.random.range(0, 3) == 0) world.removeChunk((size_t)world.random.range(0, (i32)world.chunks.size() - 1));
+            if (world.random.range(0, 2) == 0) {
+                world.addChunk(i32v3(world.random.range(-RADIUS - 3, RADIUS + 3), world.random.range(0, HEIGHT - 1),
+                                     world.random.range(-RADIUS - 3, RADIUS + 3)));
+            }
+
+            world.update();
+            mismatches += world.countTierMismatches();
+        }
+        OPENVOX_CHECK(mismatches == 0);
+        OPENVOX_CHECK(world.countUnaccounted() == 0 && world.failures == 0);
+    });
+
+    test::run("steady state runs each tier once per interval", [] {
+        World world(67);
+        for (int tick = 0; tick < 20; tick++) world.update();
+        u64 start = world.lod.getTick();
+        std::vector<Received> entitiesBefore = world.entityReceived;
+        std::unordered_map<i32v3, Received, PositionHash> chunksBefore = world.chunkReceived;
+        const u32 span = 24; // A multiple of every interval
+        std::vector<size_t> counts;
+        for (u32 tick = 0; tick < span; tick++) {
+            world.update();
+            counts.push_back(world.lod.getLastUpdateCount());
+        }
+
+        int wrong = 0;
+        for (u32 id = 0; id < ENTITIES; id++) {
+            u8 tier = world.lod.getEntityTier(id);
+            f64 received = world.entityReceived[id].time - entitiesBefore[id].time;
+            f64 expected = tier == SIMULATION_TIER_NONE ? 0.0 : span * TICK;
+            if (std::fabs(received - expected) > 1e-3) wrong++;
+        }
+        int dormant = 0;
+        for (const i32v3& c : world.chunks) {
+            u8 tier = world.lod.getChunkTier(c);
+            f64 received = world.chunkReceived[c].time - chunksBefore[c].time;
+            if (tier == SIMULATION_TIER_NONE) dormant++;
+            if (received != (tier == SIMULATION_TIER_NONE ? 0.0 : (f64)span)) wrong++;
+            // Exactly span / interval updates, each covering one interval
+            if (tier != SIMULATION_TIER_NONE && world.chunkReceived[c].lastTick + world.tiers[tier].interval < start + span) wrong++;
+        }
+        OPENVOX_CHECK(wrong == 0 && dormant > 0);
+
+        // Slices are balanced, so per tick work stays near the average
+        size_t lo = counts[0], hi = counts[0], total = 0;
+        for (size_t c : counts) {
+            lo = std::min(lo, c);
+            hi = std::max(hi, c);
+            total += c;
+        }
+        OPENVOX_CHECK(hi - lo <= world.tiers.size() * 2);
+        OPENVOX_CHECK(hi <= total / span + world.tiers.size() * 2);
+    });
+
+    test::run("dormant members catch up when they wake", [] {
+        SimulationLod lod(TICK);
+        lod.setTiers(makeTiers());
+        std::vector<f32v3> players(1, f32v3(0.0f));
+        lod.setPlayers(players);
+        const i32v3 far(20, 0, 0);
+        lod.addChunk(far);
+        lod.setEntity(1, f32v3(20.5f * CHUNK_WIDTH, 1.0f, 1.0f));
+        u32 chunkTicks = 0, chunkUpdates = 0;
+        f32 entityTime = 0.0f;
+        auto onEntity = [&](SimulationLod::EntityID, f32 dt) { entityTime += dt; };
+        auto onChunk = [&](const i32v3&, u32 ticks) { chunkTicks += ticks; chunkUpdates++; };
+        for (int i = 0; i < 10; i++) lod.update(onEntity, onChunk);
+        OPENVOX_CHECK(lod.getChunkTier(far) == SIMULATION_TIER_NONE && lod.getEntityTier(1) == SIMULATION_TIER_NONE);
+        OPENVOX_CHECK(chunkUpdates == 0 && entityTime == 0.0f);
+
+        // The player walks up, the first update covers all ten dormant ticks
+        players[0] = f32v3(20.0f * CHUNK_WIDTH, 1.0f, 1.0f);
+        lod.setPlayers(players);
+        lod.update(onEntity, onChunk);
+        OPENVOX_CHECK(lod.getChunkTier(far) == 0 && lod.getEntityTier(1) == 0);
+        OPENVOX_CHECK(chunkUpdates == 1 && chunkTicks == 11 && std::fabs(entityTime - 11 * TICK) < 1e-4f);
+
+        // Removed entities stop, and time restarts when they come back
+        lod.removeEntity(1);
+        OPENVOX_CHECK(lod.getEntityTier(1) == SIMULATION_TIER_NONE);
+        lod.update(onEntity, onChunk);
+        OPENVOX_CHECK(std::fabs(entityTime - 11 * TICK) < 1e-4f);
+        lod.setEntity(1, f32v3(20.5f * CHUNK_WIDTH, 1.0f, 1.0f));
+        lod.update(onEntity, onChunk);
+        OPENVOX_CHECK(std::fabs(entityTime - 12 * TICK) < 1e-4f && lod.getLastUpdateCount() == 2);
+    });
+
+    test::run("roaming entities do not grow the tier cache without bound", [] {
+        SimulationLod lod(TICK);
+        std::vector<SimulationTier> tiers = makeTiers();
+        lod.setTiers(tiers);
+        std::vector<f32v3> players(1, f32v3(0.0f));
+        lod.setPlayers(players);
+        // Players never move, so nothing reclassifies while the entities wander
+        test::Random random(66);
+        u32 mismatches = 0;
+        size_t largest = 0;
+        for (int i = 0; i < SIMULATION_TIER_CACHE_LIMIT * 3; i++) {
+            SimulationLod::EntityID id = (SimulationLod::EntityID)(i % 16);
+            i32v3 chunk(random.range(-200, 200), random.range(-8, 8), random.range(-200, 200));
+            lod.setEntity(id, f32v3(chunk * CHUNK_WIDTH) + 1.0f);
+            mismatches += lod.getEntityTier(id) != referenceTier(tiers, players, chunk) ? 1 : 0;
+            largest = std::max(largest, lod.getCachedTierCount());
+        }
+        OPENVOX_CHECK(mismatches == 0);
+        OPENVOX_CHECK(largest <= SIMULATION_TIER_CACHE_LIMIT);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "jobs/JobSystem.h"
+#include "physics/SpatialHash.h"
+
+using namespace openvox;
+
+namespace {
+    typedef SpatialHash::EntityID EntityID;
+
+    std::vector<EntityID> sorted(const EntityID* ids, size_t count) {
+        std::vector<EntityID> v(ids, ids + count);
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+
+    std::vector<EntityID> bruteRadius(const std::vector<f32v3>& pos, const std::vector<bool>& alive, const f32v3& c, f32 r) {
+        std::vector<EntityID> v;
+        for (size_t i = 0; i < pos.size(); i++) {
+            f32v3 d = pos[i] - c;
+            if (alive[i] && d.x * d.x + d.y * d.y + d.z * d.z <= r * r) v.push_back((EntityID)i);
+        }
+        return v;
+    }
+    std::vector<EntityID> bruteBox(const std::vector<f32v3>& pos, const std::vector<bool>& alive, const f32v3& mn, const f32v3& mx) {
+        std::vector<EntityID> v;
+        for (size_t i = 0; i < pos.size(); i++) {
+            const f32v3& p = pos[i];
+            if (alive[i] && p.x >= mn.x && p.x <= mx.x && p.y >= mn.y && p.y <= mx.y && p.z >= mn.z && p.z <= mx.z) {
+                v.push_back((EntityID)i);
+            }
+        }
+        return v;
+    }
+}
+
+int main() {
+    test::run("queries match brute force through moves and removes", [] {
+        const size_t COUNT = 3000;
+        test::Random random(52);
+        SpatialHash hash(8.0f);
+        std::vector<f32v3> pos(COUNT);
+        std::vector<bool> alive(COUNT, true);
+        for (size_t i = 0; i < COUNT; i++) {
+            pos[i] = f32v3(random.range(-100.0f, 100.0f), random.range(-20.0f, 20.0f), random.range(-100.0f, 100.0f));
+            hash.insert((EntityID)i, pos[i]);
+        }
+        std::vector<EntityID> buffer(COUNT);
+        for (int round = 0; round < 50; round++) {
+            for (size_t i = 0; i < COUNT; i++) {
+                if (!alive[i]) continue;
+                if (random.range(0, 99) == 0) {
+                    OPENVOX_CHECK(hash.remove((EntityID)i));
+                    alive[i] = false;
+                    continue;
+                }
+                pos[i] += f32v3(random.range(-3.0f, 3.0f), random.range(-1.0f, 1.0f), random.range(-3.0f, 3.0f));
+                hash.update((EntityID)i, pos[i]);
+            }
+            f32v3 c(random.range(-100.0f, 100.0f), 0.0f, random.range(-100.0f, 100.0f));
+            f32 r = random.range(1.0f, 30.0f);
+            size_t n = hash.queryRadius(c, r, buffer.data(), buffer.size());
+            OPENVOX_CHECK(sorted(buffer.data(), n) == bruteRadius(pos, alive, c, r));
+
+            f32v3 mn = c - f32v3(r, 5.0f, r * 0.5f);
+            f32v3 mx = c + f32v3(r * 0.5f, 5.0f, r);
+            n = hash.queryAABB(mn, mx, buffer.data(), buffer.size());
+            OPENVOX_CHECK(sorted(buffer.data(), n) == bruteBox(pos, alive, mn, mx));
+        }
+        size_t living = (size_t)std::count(alive.begin(), alive.end(), true);
+        OPENVOX_CHECK(hash.getEntityCount() == living);
+    });
+
+    test::run("queries respect the buffer capacity", [] {
+        SpatialHash hash(4.0f);
+        for (EntityID i = 0; i < 64; i++) hash.insert(i, f32v3((f32)(i % 4), 0.0f, (f32)(i / 4) * 0.25f));
+        // Canary after the usable part of the buffer
+        EntityID buffer[9];
+        for (int i = 0; i < 9; i++) buffer[i] = 0xDEADBEEF;
+
+        OPENVOX_CHECK(hash.queryRadius(f32v3(0.0f), 100.0f, buffer, 0) == 0);
+        OPENVOX_CHECK(hash.queryAABB(f32v3(-100.0f), f32v3(100.0f), buffer, 0) == 0);
+        OPENVOX_CHECK(hash.queryRay(f32v3(-10.0f, 0.0f, 0.0f), f32v3(1.0f, 0.0f, 0.0f), 100.0f, 50.0f, buffer, 0) == 0);
+        OPENVOX_CHECK(buffer[0] == 0xDEADBEEF);
+
+        OPENVOX_CHECK(hash.queryRadius(f32v3(0.0f), 100.0f, buffer, 8) == 8);
+        OPENVOX_CHECK(hash.queryAABB(f32v3(-100.0f), f32v3(100.0f), buffer, 8) == 8);
+        OPENVOX_CHECK(hash.queryRay(f32v3(-10.0f, 0.0f, 0.0f), f32v3(1.0f, 0.0f, 0.0f), 100.0f, 50.0f, buffer, 8) == 8);
+        OPENVOX_CHECK(buffer[8] == 0xDEADBEEF);
+    });
+
+    test::run("ray query finds entities near the segment", [] {
+        SpatialHash hash(4.0f);
+        hash.insert(0, f32v3(10.0f, 0.5f, 0.0f));
+        hash.insert(1, f32v3(30.0f, -0.5f, 0.3f));
+        hash.insert(2, f32v3(10.0f, 5.0f, 0.0f)); // Too far from the ray
+        hash.insert(3, f32v3(-5.0f, 0.0f, 0.0f)); // Behind the origin
+        hash.insert(4, f32v3(60.0f, 0.0f, 0.0f)); // Past maxDistance
+        EntityID buffer[8];
+        size_t n = hash.queryRay(f32v3(0.0f), f32v3(2.0f, 0.0f, 0.0f), 50.0f, 1.0f, buffer, 8);
+        OPENVOX_CHECK(n == 2);
+        OPENVOX_CHECK(n == 2 && buffer[0] == 0 && buffer[1] == 1);
+    });
+
+    test::run("parallel rebuild matches the serial rebuild", [] {
+        const size_t COUNT = 50000;
+        test::Random random(7);
+        std::vector<f32v3> pos(COUNT);
+        for (auto& p : pos) p = f32v3(random.range(-500.0f, 500.0f), random.range(-50.0f, 50.0f), random.range(-500.0f, 500.0f));
+
+        SpatialHash serial, parallel;
+        serial.rebuild(pos.data(), COUNT);
+        JobSystem jobs;
+        jobs.init(3);
+        parallel.rebuild(pos.data(), COUNT, &jobs);
+        jobs.dispose();
+
+        OPENVOX_CHECK(serial.getEntityCount() == parallel.getEntityCount());
+        OPENVOX_CHECK(serial.getCellCount() == parallel.getCellCount());
+        std::vector<EntityID> a(COUNT), b(COUNT);
+        for (int q = 0; q < 20; q++) {
+            f32v3 c(random.range(-500.0f, 500.0f), 0.0f, random.range(-500.0f, 500.0f));
+            size_t na = serial.queryRadius(c, 60.0f, a.data(), a.size());
+            size_t nb = parallel.queryRadius(c, 60.0f, b.data(), b.size());
+            // Same insertion order, so even the order of the results matches
+            OPENVOX_CHECK(na == nb && std::equal(a.begin(), a.begin() + na, b.begin()));
+        }
+    });
+
+    test::run("parallelFor visits every index once", [] {
+        JobSystem jobs;
+        jobs.init(3);
+        std::vector<int> hits(10007, 0);
+        jobs.parallelFor(hits.size(), 16, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) hits[i]++;
+        });
+        jobs.dispose();
+        OPENVOX_CHECK(std::count(hits.begin(), hits.end(), 1) == (ptrdiff_t)hits.size());
+    });
+
+    return test::finish();
+}
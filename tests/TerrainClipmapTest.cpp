@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestMeshes.h"
+
+#include "mesh/TerrainClipmap.h"
+
+using namespace openvox;
+
+namespace {
+    struct Config {
+        u32 levels;
+        i32 radius;
+        i32 verticalRadius;
+    };
+    const Config SMALL = { 3, 2, 2 };
+    const Config WIDE = { 2, 4, 2 }; ///< Wide enough that a move only touches the edges of a level
+
+    /// Drawn chunk with a summary of its mesh
+    typedef std::tuple<u32, i32, i32, i32, size_t, size_t> ChunkKey;
+
+    std::vector<ChunkKey> getChunkKeys(const TerrainClipmap& clipmap) {
+        std::vector<ClipmapChunk> chunks;
+        clipmap.getVisibleChunks(chunks);
+        std::vector<ChunkKey> keys;
+        for (const ClipmapChunk& c : chunks) {
+            keys.push_back(ChunkKey(c.lod, c.chunkPos.x, c.chunkPos.y, c.chunkPos.z, c.mesh->indices.size(), c.mesh->regularIndexCount));
+        }
+        std::sort(keys.begin(), keys.end());
+        return keys;
+    }
+
+    /// Welds every drawn chunk and checks that the levels close up inside the coarsest one
+    void checkClosed(const TerrainClipmap& clipmap, const f32v3& cameraPos, const Config& config) {
+        std::vector<ClipmapChunk> chunks;
+        clipmap.getVisibleChunks(chunks);
+        // Corner of the coarsest level, snapped the same way as the clipmap
+        i32 width = CHUNK_WIDTH << (config.levels - 1);
+        i32v3 size(config.radius * 2, config.verticalRadius * 2, config.radius * 2);
+        i32v3 min;
+        for (int i = 0; i < 3; i++) min[i] = (2 * (i32)std::floor((cameraPos[i] / width + 1.0f) * 0.5f) - size[i] / 2) * width;
+        test::MeshWelder welder(min, min + size * width);
+        u32 lods = 0;
+        for (const ClipmapChunk& c : chunks) {
+            welder.add(c.chunkPos, c.lod, *c.mesh);
+            lods |= 1 << c.lod;
+        }
+        test::MeshCheck check = welder.check();
+        OPENVOX_CHECK(lods == (1u << config.levels) - 1 && check.triangles > 1000 && check.boundaryEdges > 0);
+        OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.degenerate == 0);
+    }
+
+    TerrainClipmap* createClipmap(const Config& config, const TransvoxelMesher::DensityFunc& density = test::getTerrainDensity) {
+        return new TerrainClipmap(density, config.levels, config.radius, config.verticalRadius);
+    }
+}
+
+int main() {
+    test::run("levels nest into one closed surface", [] {
+        std::unique_ptr<TerrainClipmap> clipmap(createClipmap(SMALL));
+        f32v3 camera(100.0f, 96.0f, 100.0f);
+        clipmap->flush(camera);
+        // Level 0 is a full box, the others are boxes with a hole of half their size
+        u64 slots = SMALL.radius * 2 * SMALL.radius * 2 * SMALL.verticalRadius * 2;
+        OPENVOX_CHECK(clipmap->getMeshedCount() == slots + (SMALL.levels - 1) * (slots - slots / 8));
+        OPENVOX_CHECK(clipmap->update(camera) == 0 && clipmap->getMemoryUsage() > 0);
+        checkClosed(*clipmap, camera, SMALL);
+    });
+
+    test::run("a camera crossing remeshes only what changed and matches a fresh fill", [] {
+        std::unique_ptr<TerrainClipmap> clipmap(createClipmap(WIDE));
+        f32v3 camera(100.0f, 96.0f, 100.0f);
+        clipmap->flush(camera);
+        u64 total = clipmap->getMeshedCount();
+
+        // Moving inside the same pair of chunks changes nothing
+        u64 before = clipmap->getMeshedCount();
+        clipmap->flush(camera + f32v3(5.0f, 5.0f, 5.0f));
+        OPENVOX_CHECK(clipmap->getMeshedCount() == before);
+
+        // Level 0 snaps every other chunk along x and level 1 every fourth, out of step, so two
+        // of the eight moves mesh nothing. A snap meshes the slab entering its level and the
+        // chunks of the next level whose transition faces moved, a quarter of the clipmap at most.
+        u64 worst = 0;
+        int idle = 0;
+        for (int step = 0; step < 8; step++) {
+            camera.x += CHUNK_WIDTH;
+            before = clipmap->getMeshedCount();
+            clipmap->flush(camera);
+            u64 meshed = clipmap->getMeshedCount() - before;
+            worst = std::max(worst, meshed);
+            if (meshed == 0) idle++;
+        }
+        std::printf("    %llu chunks in all, at most %llu meshed again per move\n", (unsigned long long)total, (unsigned long long)worst);
+        OPENVOX_CHECK(idle == 2 && worst > 0 && worst * 4 < total);
+
+        std::unique_ptr<TerrainClipmap> fresh(createClipmap(WIDE));
+        fresh->flush(camera);
+        OPENVOX_CHECK(getChunkKeys(*clipmap) == getChunkKeys(*fresh));
+        checkClosed(*clipmap, camera, WIDE);
+    });
+
+    test::run("meshing on jobs gives the same chunks as meshing inline", [] {
+        JobSystem jobs;
+        jobs.init(2);
+        std::unique_ptr<TerrainClipmap> threaded(createClipmap(SMALL));
+        std::unique_ptr<TerrainClipmap> inlined(createClipmap(SMALL));
+        f32v3 camera(-300.0f, 80.0f, 40.0f);
+        for (int step = 0; step < 4; step++) {
+            threaded->flush(camera, &jobs);
+            inlined->flush(camera);
+            OPENVOX_CHECK(getChunkKeys(*threaded) == getChunkKeys(*inlined));
+            OPENVOX_CHECK(threaded->getMeshedCount() == inlined->getMeshedCount());
+            camera += f32v3(70.0f, 0.0f, -45.0f);
+        }
+        // Updates without waiting keep drawing only chunks whose mesh is current
+        threaded->update(camera, &jobs);
+        std::vector<ClipmapChunk> chunks;
+        threaded->getVisibleChunks(chunks);
+        OPENVOX_CHECK(chunks.size() <= getChunkKeys(*inlined).size() + 64);
+        threaded->flush(camera, &jobs);
+        inlined->flush(camera);
+        OPENVOX_CHECK(getChunkKeys(*threaded) == getChunkKeys(*inlined));
+        jobs.dispose();
+    });
+
+    test::run("the coarsest level reaches radius - 1 of its chunks past the camera", [] {
+        std::unique_ptr<TerrainClipmap> clipmap(createClipmap(SMALL, [](const i32v3&) { return (i8)1; }));
+        test::Random random(72);
+        f32 minimum = 1e30f;
+        for (int i = 0; i < 20; i++) {
+            f32v3 camera(random.range(-5000.0f, 5000.0f), random.range(-500.0f, 500.0f), random.range(-5000.0f, 5000.0f));
+            clipmap->flush(camera);
+            minimum = std::min(minimum, clipmap->getViewDistance());
+        }
+        OPENVOX_CHECK(minimum >= (SMALL.radius - 1) * (CHUNK_WIDTH << (SMALL.levels - 1)));
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+#include "TestGenStages.h"
+#include "TestHarness.h"
+#include "math/OpenVoxMath.hpp"
+
+using namespace openvox;
+
+namespace {
+    const u64 SEED = 58;
+
+    std::vector<i32v3> getRequested(i32 width, i32 height) {
+        std::vector<i32v3> chunks;
+        for (i32 y = 0; y < height; y++) {
+            for (i32 z = 0; z < width; z++) {
+                for (i32 x = 0; x < width; x++) chunks.push_back(i32v3(x, y, z));
+            }
+        }
+        return chunks;
+    }
+
+    /// Hash of the voxels of the chunks, in position order
+    u64 checksum(const ChunkMap& map, std::vector<i32v3> chunks) {
+        std::sort(chunks.begin(), chunks.end(), [](const i32v3& a, const i32v3& b) {
+            return a.y != b.y ? a.y < b.y : a.z != b.z ? a.z < b.z : a.x < b.x;
+        });
+        u64 h = 1469598103934665603ull;
+        for (const i32v3& p : chunks) {
+            const Chunk* chunk = map.getChunk(p);
+            if (!chunk) return 0;
+            const BlockID* data = chunk->getBlockData();
+            for (int i = 0; i < CHUNK_SIZE; i++) h = (h ^ data[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    u64 generate(const std::vector<i32v3>& chunks, u32 workers, size_t* completeEvents = nullptr) {
+        ChunkMap map;
+        TerrainPipeline pipeline(&map, SEED);
+        test::addTestStages(pipeline);
+        JobSystem jobs;
+        if (workers) jobs.init(workers);
+        size_t events = 0;
+        auto* listener = pipeline.onChunkComplete.addFunctor([&](Sender, i32v3) { events++; });
+        for (const i32v3& p : chunks) pipeline.requestChunk(p);
+        pipeline.flush(workers ? &jobs : nullptr);
+        pipeline.onChunkComplete -= *listener;
+        delete listener;
+        if (workers) jobs.dispose();
+        if (completeEvents) *completeEvents = events;
+        for (const i32v3& p : chunks) {
+            if (!pipeline.isComplete(p)) return 0;
+        }
+        return checksum(map, chunks);
+    }
+
+    /*! Generates every chunk of a padded region one whole stage at a time, applying spilled
+     * blocks ordered by the chunk that wrote them. Only chunks at least one chunk inside the
+     * region have all their neighbors' blocks.
+     */
+    u64 generateReference(const std::vector<i32v3>& chunks) {
+        i32v3 lo(INT_MAX), hi(INT_MIN);
+        for (const i32v3& p : chunks) {
+            lo = openvoxm::min(lo, p);
+            hi = openvoxm::max(hi, p);
+        }
+        lo -= i32v3(1);
+        hi += i32v3(1);
+        ChunkMap map;
+        std::vector<i32v3> region;
+        for (i32 y = lo.y; y <= hi.y; y++) {
+            for (i32 z = lo.z; z <= hi.z; z++) {
+                for (i32 x = lo.x; x <= hi.x; x++) {
+                    region.push_back(i32v3(x, y, z));
+                    map.createChunk(region.back());
+                }
+            }
+        }
+        struct Edit {
+            i32v3 pos;
+            BlockID id;
+            EditMode mode;
+        };
+        auto apply = [&map](const Edit& e) {
+            Chunk* c = map.getChunk(toChunkPosition(e.pos));
+            if (!c) return;
+            BlockID v = c->getBlock(toLocalPosition(e.pos));
+            if (e.mode == EditMode::FILL_AIR && v != BLOCK_AIR) return;
+            if (e.mode == EditMode::REPLACE_SOLID && v == BLOCK_AIR) return;
+            c->setBlock(toLocalPosition(e.pos), e.id);
+        };
+        for (u32 s = 0; s < TEST_GEN_STAGE_COUNT; s++) {
+            // Region order is y, z, x, the order spilled blocks are applied in
+            std::vector<Edit> spilled;
+            for (const i32v3& p : region) {
+                test::runTestStage(s, p, SEED, *map.getChunk(p), [&](const i32v3& v, BlockID id, EditMode mode) {
+                    Edit e = { v, id, mode };
+                    if (toChunkPosition(v) == p) {
+                        apply(e);
+                    } else {
+                        spilled.push_back(e);
+                    }
+                });
+            }
+            for (const Edit& e : spilled) apply(e);
+        }
+        return checksum(map, chunks);
+    }
+}
+
+int main() {
+    const std::vector<i32v3> requested = getRequested(5, 2);
+
+    test::run("output matches a stage by stage reference", [&] {
+        u64 expected = generateReference(requested);
+        size_t events = 0;
+        OPENVOX_CHECK(expected != 0);
+        OPENVOX_CHECK(generate(requested, 0, &events) == expected);
+        OPENVOX_CHECK(events == requested.size());
+    });
+
+    test::run("output is identical for any worker count", [&] {
+        u64 inlineSum = generate(requested, 0);
+        OPENVOX_CHECK(inlineSum != 0);
+        const u32 workers[] = { 1, 2, 4 };
+        for (u32 w : workers) {
+            for (int repeat = 0; repeat < 3; repeat++) OPENVOX_CHECK(generate(requested, w) == inlineSum);
+        }
+    });
+
+    test::run("output does not depend on request order", [&] {
+        std::vector<i32v3> shuffled = requested;
+        test::Random random(580);
+        for (size_t i = shuffled.size() - 1; i > 0; i--) std::swap(shuffled[i], shuffled[(size_t)random.range(0, (i32)i)]);
+        OPENVOX_CHECK(generate(shuffled, 2) == generate(requested, 0));
+    });
+
+    test::run("neighbors run only the stages they need", [] {
+        ChunkMap map;
+        TerrainPipeline pipeline(&map, SEED);
+        test::addTestStages(pipeline);
+        pipeline.requestChunk(i32v3(0));
+        pipeline.flush();
+        OPENVOX_CHECK(pipeline.isComplete(i32v3(0)));
+        OPENVOX_CHECK(!pipeline.isComplete(i32v3(1, 0, 0)));
+        // One chunk runs every step; its 26 neighbors run all four stages but not the final apply
+        OPENVOX_CHECK(pipeline.getStagesRun() == (TEST_GEN_STAGE_COUNT + 1) + 26 * TEST_GEN_STAGE_COUNT);
+
+        // Requesting a neighbor later finishes it without regenerating the first chunk
+        u64 before = checksum(map, std::vector<i32v3>(1, i32v3(0)));
+        pipeline.requestChunk(i32v3(1, 0, 0));
+        pipeline.flush();
+        OPENVOX_CHECK(pipeline.isComplete(i32v3(1, 0, 0)));
+        OPENVOX_CHECK(checksum(map, std::vector<i32v3>(1, i32v3(0))) == before);
+    });
+
+    test::run("trees spill into neighbors", [&] {
+        ChunkMap map;
+        TerrainPipeline pipeline(&map, SEED);
+        test::addTestStages(pipeline);
+        for (const i32v3& p : requested) pipeline.requestChunk(p);
+        pipeline.flush();
+        // Leaves are only written by trees; some must sit in a column whose chunk has no log below them
+        size_t leaves = 0, crossing = 0;
+        for (const i32v3& p : requested) {
+            const Chunk* c = map.getChunk(p);
+            for (int i = 0; i < CHUNK_SIZE; i++) {
+                if (c->getBlock(i) != TEST_BLOCK_LEAVES) continue;
+                leaves++;
+                i32v3 l = getVoxelPosition(i);
+                if (l.x < 2 || l.x > CHUNK_WIDTH - 3 || l.z < 2 || l.z > CHUNK_WIDTH - 3) crossing++;
+            }
+        }
+        OPENVOX_CHECK(leaves > 0);
+        OPENVOX_CHECK(crossing > 0);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,77 @@
+//
+// TestFiles.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TestFiles.h
+* @brief Scratch directories for tests of code that saves files.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "io/FileSystem.h"
+
+namespace openvox {
+    namespace test {
+        /*! @brief Empty directory under the working directory, removed with its files on destruction.
+        *
+        * CTest runs tests in the build tree, so nothing is written outside of it.
+        */
+        class TempDirectory {
+        public:
+            explicit TempDirectory(const char* name) : m_path(std::string("openvox_test_") + name) {
+                clear();
+                makeDirectory(m_path);
+            }
+            ~TempDirectory() {
+                clear();
+                std::remove(m_path.c_str());
+            }
+
+            /*! @brief Deletes every file in the directory.
+            */
+            void clear() {
+                for (const std::string& name : list()) std::remove(getPath(name).c_str());
+            }
+            std::vector<std::string> list() const {
+                std::vector<std::string> names;
+                listDirectory(m_path, names);
+                return names;
+            }
+            std::string getPath(const std::string& name) const {
+                return m_path + "/" + name;
+            }
+            const std::string& getPath() const {
+                return m_path;
+            }
+
+        private:
+            std::string m_path;
+        };
+
+        /*! @brief Reads a whole file, empty if it does not exist.
+        */
+        inline std::vector<u8> readFile(const std::string& path) {
+            std::vector<u8> data;
+            FILE* file = std::fopen(path.c_str(), "rb");
+            if (!file) return data;
+            data.resize((size_t)getFileSize(file));
+            seekFile(file, 0);
+            if (data.size() && std::fread(data.data(), 1, data.size(), file) != data.size()) data.clear();
+            std::fclose(file);
+            return data;
+        }
+        inline bool writeFile(const std::string& path, const std::vector<u8>& data) {
+            FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file) return false;
+            bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+            return std::fclose(file) == 0 && ok;
+        }
+    }
+}
@@ -0,0 +1,110 @@
+//
+// TestGenStages.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TestGenStages.h
+* @brief Four deterministic generation stages shared by the TerrainPipeline test and benchmark.
+*/
+
+#pragma once
+
+#include <functional>
+
+#include "TestWorld.h"
+#include "gen/TerrainPipeline.h"
+
+#define TEST_BLOCK_STONE 1
+#define TEST_BLOCK_GRASS 2
+#define TEST_BLOCK_DIRT 3
+#define TEST_BLOCK_LOG 4
+#define TEST_BLOCK_LEAVES 5
+#define TEST_GEN_STAGE_COUNT 4
+
+namespace openvox {
+    namespace test {
+        /// Writes a block for a stage. Blocks outside the stage's chunk may be deferred.
+        typedef std::function<void(const i32v3& voxelPos, BlockID id, EditMode mode)> GenWriter;
+
+        /*! @brief Runs one stage on a chunk: density, caves, surface, then trees.
+        *
+        * Stages read and write only their own chunk directly. Trees also write logs and leaves
+        * up to one chunk away through write.
+        */
+        inline void runTestStage(u32 stage, const i32v3& chunkPos, u64 seed, Chunk& chunk, const GenWriter& write) {
+            i32v3 origin = toVoxelPosition(chunkPos);
+            Random random(seed ^ ((u64)(u32)chunkPos.x * 73856093ull) ^ ((u64)(u32)chunkPos.y * 19349663ull) ^
+                          ((u64)(u32)chunkPos.z * 83492791ull) ^ ((u64)stage << 56));
+            switch (stage) {
+                case 0: // Density
+                    for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                        for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                            i32 h = getTerrainHeight(origin.x + x, origin.z + z, 24, 10.0f);
+                            for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+                                chunk.setBlock(x, y, z, origin.y + y <= h ? TEST_BLOCK_STONE : (BlockID)BLOCK_AIR);
+                            }
+                        }
+                    }
+                    break;
+                case 1: // Caves
+                    for (int i = 0; i < 2; i++) {
+                        i32v3 c(random.range(5, 26), random.range(5, 26), random.range(5, 26));
+                        i32 r = random.range(2, 5);
+                        for (i32 y = c.y - r; y <= c.y + r; y++) {
+                            for (i32 z = c.z - r; z <= c.z + r; z++) {
+                                for (i32 x = c.x - r; x <= c.x + r; x++) {
+                                    i32v3 d = i32v3(x, y, z) - c;
+                                    if (d.x * d.x + d.y * d.y + d.z * d.z <= r * r) chunk.setBlock(x, y, z, BLOCK_AIR);
+                                }
+                            }
+                        }
+                    }
+                    break;
+                case 2: // Surface
+                    for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                        for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                            for (i32 y = CHUNK_WIDTH - 2; y >= 0; y--) {
+                                if (chunk.getBlock(x, y, z) != TEST_BLOCK_STONE || chunk.getBlock(x, y + 1, z) != BLOCK_AIR) continue;
+                                chunk.setBlock(x, y, z, TEST_BLOCK_GRASS);
+                                for (i32 d = y - 1; d >= 0 && d >= y - 2 && chunk.getBlock(x, d, z) == TEST_BLOCK_STONE; d--) {
+                                    chunk.setBlock(x, d, z, TEST_BLOCK_DIRT);
+                                }
+                            }
+                        }
+                    }
+                    break;
+                case 3: // Trees, spilling into neighbors
+                    for (int i = 0; i < 4; i++) {
+                        i32 x = random.range(0, CHUNK_WIDTH - 1), z = random.range(0, CHUNK_WIDTH - 1);
+                        i32 y = CHUNK_WIDTH - 1;
+                        while (y >= 0 && chunk.getBlock(x, y, z) != TEST_BLOCK_GRASS) y--;
+                        if (y < 0) continue;
+                        i32v3 base = origin + i32v3(x, y + 1, z);
+                        for (i32 t = 0; t < 5; t++) write(base + i32v3(0, t, 0), TEST_BLOCK_LOG, EditMode::REPLACE);
+                        for (i32 ly = 3; ly <= 6; ly++) {
+                            for (i32 lz = -2; lz <= 2; lz++) {
+                                for (i32 lx = -2; lx <= 2; lx++) {
+                                    write(base + i32v3(lx, ly, lz), TEST_BLOCK_LEAVES, EditMode::FILL_AIR);
+                                }
+                            }
+                        }
+                    }
+                    break;
+            }
+        }
+
+        /*! @brief Adds the four test stages to a pipeline.
+        */
+        inline void addTestStages(TerrainPipeline& pipeline) {
+            const char* names[TEST_GEN_STAGE_COUNT] = { "density", "caves", "surface", "trees" };
+            for (u32 s = 0; s < TEST_GEN_STAGE_COUNT; s++) {
+                pipeline.addStage(names[s], [s](GenContext& context) {
+                    runTestStage(s, context.getChunkPosition(), context.getSeed(), context.getChunk(),
+                                 [&context](const i32v3& p, BlockID id, EditMode mode) { context.setBlock(p, id, mode); });
+                }, s == 3 ? 1 : 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,60 @@
+//
+// TestHarness.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TestHarness.h
+* @brief Minimal checks shared by the test executables.
+*
+* A test is a plain executable. Each check that fails prints its expression and location and
+* is counted, and the process exits with a non-zero code if any check failed, which is what
+* CTest looks at. Checks never abort, so one run reports every failure.
+*/
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+
+namespace openvox {
+    namespace test {
+        /// Number of failed checks in this process
+        inline int& failureCount() {
+            static int count = 0;
+            return count;
+        }
+        inline bool check(bool ok, const char* expression, const char* file, int line) {
+            if (!ok) {
+                std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+                failureCount()++;
+            }
+            return ok;
+        }
+        /*! @brief Runs one named test case, counting an escaped exception as a failure.
+        */
+        template<typename F>
+        void run(const char* name, F f) {
+            int before = failureCount();
+            try {
+                f();
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "%s: exception: %s\n", name, e.what());
+                failureCount()++;
+            }
+            std::printf("%-48s %s\n", name, failureCount() == before ? "ok" : "FAILED");
+        }
+        /*! @brief Exit code for main().
+        */
+        inline int finish() {
+            if (failureCount()) std::fprintf(stderr, "%d check(s) failed\n", failureCount());
+            return failureCount() ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
+    }
+}
+
+/// Checks a condition and keeps going on failure. Evaluates to the condition.
+/// Variadic so expressions containing template argument commas need no extra parentheses.
+#define OPENVOX_CHECK(...) openvox::test::check((__VA_ARGS__) ? true : false, #__VA_ARGS__, __FILE__, __LINE__)
@@ -0,0 +1,220 @@
+//
+// TestMeshes.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TestMeshes.h
+* @brief Density fields and watertightness checks shared by the terrain mesher tests and benchmarks.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "TestWorld.h"
+#include "math/OpenVoxMath.hpp"
+#include "mesh/PackedVertex.h"
+
+namespace openvox {
+    namespace test {
+        /*! @brief Noise caves over a weak vertical gradient, negative inside.
+        *
+        * The surface crosses every chunk face of the mesher tests at every LOD. Never returns
+        * 0, so no vertex lands exactly on a sample and distinct vertices are always apart.
+        */
+        inline i8 getTestDensity(const i32v3& p) {
+            f32 d = 40.0f * getValueNoise(f32v3(p), 3, 1.0f / 40.0f) + (p.y - 96) * 0.25f;
+            i32 v = (i32)openvoxm::clamp(openvoxm::round(d), -127.0f, 127.0f);
+            return (i8)(v == 0 ? 1 : v);
+        }
+
+        /*! @brief Smooth rolling terrain around y = 96, negative inside, never 0.
+        */
+        inline i8 getTerrainDensity(const i32v3& p) {
+            f32 height = 96.0f + 40.0f * (std::sin(p.x * 0.045f) * 0.6f + std::cos(p.z * 0.035f + p.x * 0.02f) * 0.4f) +
+                         10.0f * std::sin(p.z * 0.09f);
+            i32 v = (i32)openvoxm::clamp(openvoxm::round((p.y - height) * 4.0f), -127.0f, 127.0f);
+            return (i8)(v == 0 ? 1 : v);
+        }
+
+        /*! @brief Signed distance to a box turned about y by yaw, then tilted about x by pitch.
+        */
+        inline f32 getBoxDistance(const f32v3& p, const f32v3& center, const f32v3& halfSize, f32 yaw, f32 pitch) {
+            f32v3 d = p - center;
+            f32v3 r(std::cos(yaw) * d.x - std::sin(yaw) * d.z, d.y, std::sin(yaw) * d.x + std::cos(yaw) * d.z);
+            f32v3 q(r.x, std::cos(pitch) * r.y - std::sin(pitch) * r.z, std::sin(pitch) * r.y + std::cos(pitch) * r.z);
+            q = f32v3(openvoxm::abs(q.x), openvoxm::abs(q.y), openvoxm::abs(q.z)) - halfSize;
+            f32v3 outside(openvoxm::max(q.x, 0.0f), openvoxm::max(q.y, 0.0f), openvoxm::max(q.z, 0.0f));
+            return openvoxm::length(outside) + openvoxm::min(openvoxm::max(q.x, openvoxm::max(q.y, q.z)), 0.0f);
+        }
+
+        /*! @brief Approximate signed distance to low hills around y = 40.
+        */
+        inline f32 getHillDistance(const f32v3& p) {
+            f32 height = 40.0f + 8.0f * std::sin(p.x * 0.07f) + 6.0f * std::cos(p.z * 0.05f + p.x * 0.03f);
+            f32 dx = 0.56f * std::cos(p.x * 0.07f) - 0.18f * std::sin(p.z * 0.05f + p.x * 0.03f);
+            f32 dz = -0.3f * std::sin(p.z * 0.05f + p.x * 0.03f);
+            return (p.y - height) / std::sqrt(1.0f + dx * dx + dz * dz);
+        }
+
+        /*! @brief Density of a signed distance in voxels, 16 steps per voxel and never 0.
+        */
+        inline i8 getDistanceDensity(f32 distance) {
+            i32 v = (i32)openvoxm::clamp(openvoxm::round(distance * 16.0f), -127.0f, 127.0f);
+            return (i8)(v == 0 ? 1 : v);
+        }
+
+        /*! @brief Unit normal of a packed vertex.
+        */
+        inline f32v3 unpackNormal(const PackedVertex& vertex) {
+            f32v3 n(vertex.normal.x / 127.0f, vertex.normal.y / 127.0f, 0.0f);
+            n.z = 1.0f - openvoxm::abs(n.x) - openvoxm::abs(n.y);
+            if (n.z < 0.0f) {
+                f32v2 folded(1.0f - openvoxm::abs(n.y), 1.0f - openvoxm::abs(n.x));
+                n.x = n.x >= 0.0f ? folded.x : -folded.x;
+                n.y = n.y >= 0.0f ? folded.y : -folded.y;
+            }
+            return n / openvoxm::length(n);
+        }
+
+        struct MeshCheck {
+            size_t triangles = 0;
+            size_t vertices = 0; ///< After welding
+            size_t degenerate = 0; ///< Triangles with two corners welded together
+            size_t openEdges = 0; ///< Edges without a partner edge running the other way
+            size_t nonManifoldEdges = 0; ///< Edges used twice in the same direction
+            size_t boundaryEdges = 0; ///< Open edges on the outer box, which are expected
+            size_t badWinding = 0; ///< Triangles facing against their vertex normals
+        };
+
+        /*! @brief Welds the meshes of many chunks, at any LOD, into one surface and checks that
+        * it is closed.
+        *
+        * Positions are converted to world space in 1 / PACKED_POSITION_SCALE of a voxel. Vertices
+        * within weldDistance of each other become one, which absorbs the rounding of packed
+        * positions between LODs. A closed surface has exactly one partner edge running the other
+        * way for every edge, except along the outside of the meshed box: edges with both ends
+        * within boundaryMargin of the same side of it, which defaults to weldDistance.
+        */
+        class MeshWelder {
+        public:
+            MeshWelder(const i32v3& boxMin, const i32v3& boxMax, i64 weldDistance = 4, i64 boundaryMargin = -1) :
+                m_boxMin(i64v3(boxMin) * (i64)PACKED_POSITION_SCALE),
+                m_boxMax(i64v3(boxMax) * (i64)PACKED_POSITION_SCALE),
+                m_weldDistance(weldDistance),
+                m_boundaryMargin(boundaryMargin < 0 ? weldDistance : boundaryMargin) {
+            }
+
+            /*! @param indexBegin, indexEnd: Range of mesh indices to add, all of them by default.
+            */
+            void add(const i32v3& chunkPos, u32 lod, const PackedMesh& mesh, size_t indexBegin = 0, size_t indexEnd = (size_t)-1) {
+                m_remap.resize(mesh.vertices.size());
+                for (size_t i = 0; i < mesh.vertices.size(); i++) {
+                    i64v3 p = (i64v3(chunkPos) * (i64)(CHUNK_WIDTH * PACKED_POSITION_SCALE) + i64v3(mesh.vertices[i].position)) * ((i64)1 << lod);
+                    m_remap[i] = weld(p, unpackNormal(mesh.vertices[i]));
+                }
+                indexEnd = openvoxm::min(indexEnd, mesh.indices.size());
+                for (size_t i = indexBegin; i + 2 < indexEnd; i += 3) {
+                    m_triangles.push_back(m_remap[mesh.indices[i]]);
+                    m_triangles.push_back(m_remap[mesh.indices[i + 1]]);
+                    m_triangles.push_back(m_remap[mesh.indices[i + 2]]);
+                }
+            }
+
+            MeshCheck check() const {
+                MeshCheck result;
+                result.triangles = m_triangles.size() / 3;
+                result.vertices = m_positions.size();
+                std::unordered_map<u64, u32> edges;
+                for (size_t t = 0; t < m_triangles.size(); t += 3) {
+                    const u32* v = &m_triangles[t];
+                    if (v[0] == v[1] || v[1] == v[2] || v[2] == v[0]) {
+                        result.degenerate++;
+                        continue;
+                    }
+                    for (int i = 0; i < 3; i++) edges[getEdgeKey(v[i], v[(i + 1) % 3])]++;
+
+                    f64v3 a(m_positions[v[0]]), b(m_positions[v[1]]), c(m_positions[v[2]]);
+                    f64v3 n = openvoxm::cross(b - a, c - a);
+                    f32v3 normal = m_normals[v[0]] + m_normals[v[1]] + m_normals[v[2]];
+                    if (openvoxm::dot(n, f64v3(normal)) <= 0.0) result.badWinding++;
+                }
+                for (auto& it : edges) {
+                    u32 a = (u32)(it.first >> 32), b = (u32)it.first;
+                    if (it.second > 1) result.nonManifoldEdges++;
+                    if (edges.count(getEdgeKey(b, a))) continue;
+                    if (isOnBox(a, b)) {
+                        result.boundaryEdges++;
+                    } else {
+                        result.openEdges++;
+                    }
+                }
+                return result;
+            }
+
+        private:
+            static u64 getEdgeKey(u32 a, u32 b) {
+                return (u64)a << 32 | b;
+            }
+            /// Cell of the weld grid, 21 bits per axis
+            u64 getCellKey(const i64v3& cell) const {
+                return ((u64)(cell.x & 0x1FFFFF) << 42) | ((u64)(cell.y & 0x1FFFFF) << 21) | (u64)(cell.z & 0x1FFFFF);
+            }
+            i64v3 getCell(const i64v3& p) const {
+                i64 size = openvoxm::max(m_weldDistance * 2, (i64)16);
+                return i64v3(floorDiv(p.x, size), floorDiv(p.y, size), floorDiv(p.z, size));
+            }
+            static i64 floorDiv(i64 a, i64 b) {
+                return a >= 0 ? a / b : -((-a + b - 1) / b);
+            }
+
+            u32 weld(const i64v3& p, const f32v3& normal) {
+                i64v3 cell = getCell(p);
+                for (i64 z = -1; z <= 1; z++) {
+                    for (i64 y = -1; y <= 1; y++) {
+                        for (i64 x = -1; x <= 1; x++) {
+                            auto it = m_grid.find(getCellKey(cell + i64v3(x, y, z)));
+                            if (it == m_grid.end()) continue;
+                            for (u32 v : it->second) {
+                                i64v3 d = m_positions[v] - p;
+                                if (openvoxm::abs(d.x) <= m_weldDistance && openvoxm::abs(d.y) <= m_weldDistance &&
+                                    openvoxm::abs(d.z) <= m_weldDistance) {
+                                    return v;
+                                }
+                            }
+                        }
+                    }
+                }
+                u32 v = (u32)m_positions.size();
+                m_positions.push_back(p);
+                m_normals.push_back(normal);
+                m_grid[getCellKey(cell)].push_back(v);
+                return v;
+            }
+
+            bool isOnBox(u32 a, u32 b) const {
+                const i64v3& pa = m_positions[a];
+                const i64v3& pb = m_positions[b];
+                for (int i = 0; i < 3; i++) {
+                    if (openvoxm::abs(pa[i] - m_boxMin[i]) <= m_boundaryMargin && openvoxm::abs(pb[i] - m_boxMin[i]) <= m_boundaryMargin) return true;
+                    if (openvoxm::abs(pa[i] - m_boxMax[i]) <= m_boundaryMargin && openvoxm::abs(pb[i] - m_boxMax[i]) <= m_boundaryMargin) return true;
+                }
+                return false;
+            }
+
+            i64v3 m_boxMin;
+            i64v3 m_boxMax;
+            i64 m_weldDistance;
+            i64 m_boundaryMargin;
+            std::vector<i64v3> m_positions;
+            std::vector<f32v3> m_normals;
+            std::vector<u32> m_triangles;
+            std::vector<u32> m_remap;
+            std::unordered_map<u64, std::vector<u32> > m_grid;
+        };
+    }
+}
@@ -0,0 +1,118 @@
+//
+// TestWorld.h
+// OpenVox Engine
+//
+// Created by Benjamin Arnold on 17 Oct 2026
+//
+
+/*! \file TestWorld.h
+* @brief Deterministic worlds and random numbers shared by the tests and benchmarks.
+*/
+
+#pragma once
+
+#include <cmath>
+
+#include "voxel/ChunkMap.h"
+
+namespace openvox {
+    namespace test {
+        /*! @brief Small deterministic generator so runs are reproducible on every platform.
+        */
+        class Random {
+        public:
+            explicit Random(u64 seed = 1) : m_state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+            u64 next() {
+                // splitmix64
+                u64 z = (m_state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+            /// Uniform integer in [min, max]
+            i32 range(i32 min, i32 max) {
+                return min + (i32)(next() % (u64)((i64)max - min + 1));
+            }
+            /// Uniform float in [0, 1)
+            f32 unit() {
+                return (f32)(next() >> 40) / (f32)(1ull << 24);
+            }
+            /// Uniform float in [min, max)
+            f32 range(f32 min, f32 max) {
+                return min + unit() * (max - min);
+            }
+
+        private:
+            u64 m_state;
+        };
+
+        /*! @brief Fractal value noise with smooth interpolation, roughly in [-2, 2] for 4 octaves.
+        *
+        * @param frequency: Lattice cells per voxel of the first octave.
+        */
+        inline f32 getValueNoise(const f32v3& p, int octaves = 4, f32 frequency = 1.0f / 24.0f) {
+            auto hash = [](i32 x, i32 y, i32 z) {
+                u32 h = (u32)x * 0x8DA6B343u ^ (u32)y * 0xD8163841u ^ (u32)z * 0xCB1AB31Fu;
+                h ^= h >> 13;
+                h *= 0x5BD1E995u;
+                h ^= h >> 15;
+                return (f32)(h & 0xFFFF) / 32767.5f - 1.0f;
+            };
+            f32 sum = 0.0f, amplitude = 1.0f;
+            for (int o = 0; o < octaves; o++) {
+                f32 x = p.x * frequency, y = p.y * frequency, z = p.z * frequency;
+                i32 ix = (i32)std::floor(x), iy = (i32)std::floor(y), iz = (i32)std::floor(z);
+                f32 fx = x - ix, fy = y - iy, fz = z - iz;
+                fx = fx * fx * (3.0f - 2.0f * fx);
+                fy = fy * fy * (3.0f - 2.0f * fy);
+                fz = fz * fz * (3.0f - 2.0f * fz);
+                f32 c[2][2];
+                for (int dy = 0; dy < 2; dy++) {
+                    for (int dz = 0; dz < 2; dz++) {
+                        f32 a = hash(ix, iy + dy, iz + dz + o * 1013);
+                        f32 b = hash(ix + 1, iy + dy, iz + dz + o * 1013);
+                        c[dy][dz] = a + (b - a) * fx;
+                    }
+                }
+                f32 l0 = c[0][0] + (c[0][1] - c[0][0]) * fz;
+                f32 l1 = c[1][0] + (c[1][1] - c[1][0]) * fz;
+                sum += (l0 + (l1 - l0) * fy) * amplitude;
+                amplitude *= 0.5f;
+                frequency *= 2.0f;
+            }
+            return sum;
+        }
+
+        /*! @brief Height of the rolling test terrain at a world column.
+        */
+        inline i32 getTerrainHeight(i32 x, i32 z, i32 baseHeight = 16, f32 amplitude = 8.0f) {
+            return baseHeight + (i32)std::floor(amplitude * (std::sin(x * 0.11f) * 0.6f + std::cos(z * 0.07f + x * 0.03f) * 0.4f));
+        }
+
+        /*! @brief Creates the chunks in [chunkMin, chunkMax] and fills them with the rolling
+        * terrain: `block` at or below getTerrainHeight(), air above.
+        */
+        inline void buildTerrain(ChunkMap& map, const i32v3& chunkMin, const i32v3& chunkMax, BlockID block = 1,
+                                 i32 baseHeight = 16, f32 amplitude = 8.0f) {
+            for (i32 cy = chunkMin.y; cy <= chunkMax.y; cy++) {
+                for (i32 cz = chunkMin.z; cz <= chunkMax.z; cz++) {
+                    for (i32 cx = chunkMin.x; cx <= chunkMax.x; cx++) {
+                        Chunk* chunk = map.createChunk(i32v3(cx, cy, cz));
+                        i32v3 origin = chunk->getVoxelPosition();
+                        BlockID* blocks = chunk->getMutableBlockData();
+                        for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                            for (i32 x = 0; x < CHUNK_WIDTH; x++) {
+                                i32 h = getTerrainHeight(origin.x + x, origin.z + z, baseHeight, amplitude);
+                                for (i32 y = 0; y < CHUNK_WIDTH; y++) {
+                                    blocks[getVoxelIndex(x, y, z)] = origin.y + y <= h ? block : (BlockID)BLOCK_AIR;
+                                }
+                            }
+                        }
+                        chunk->updateOccupancy();
+                    }
+                }
+            }
+        }
+    }
+}
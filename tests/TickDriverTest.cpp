@@ -0,0 +1,168 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "TestHarness.h"
+
+#include "sim/TickDriver.h"
+
+using namespace openvox;
+
+namespace {
+    typedef std::chrono::steady_clock Clock;
+
+    /// Busy waits, the way a subsystem doing real work occupies the tick
+    void spin(f64 seconds) {
+        Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(seconds));
+        while (Clock::now() < end) {}
+    }
+
+    /// Ticks of 100 ms: over half is overloaded, under a tenth recovers after three ticks
+    const f32 RATE = 10.0f;
+    const f64 HEAVY = 0.07;
+    const f64 MEDIUM = 0.03;
+
+    struct Load {
+        f64 work = 0.0;
+        std::vector<TickContext> contexts;
+    };
+
+    void addLoad(TickDriver& driver, Load& load) {
+        driver.setThresholds(0.5f, 0.1f, 3);
+        driver.addSubsystem("load", 0.04f, [&load](const TickContext& context) {
+            load.contexts.push_back(context);
+            spin(load.work);
+        });
+    }
+}
+
+int main() {
+    test::run("subsystems run in order with the tick context", [] {
+        TickDriver driver(RATE);
+        std::vector<int> order;
+        std::vector<u64> ticks;
+        driver.addSubsystem("a", 1.0f, [&](const TickContext& c) { order.push_back(0); ticks.push_back(c.tick); });
+        size_t b = driver.addSubsystem("b", 1.0f, [&](const TickContext& c) {
+            order.push_back(1);
+            OPENVOX_CHECK(c.dt == 1.0f / RATE && c.degradationLevel == 0 && c.degradation.chunkGenerationScale == 1.0f);
+        });
+        for (int i = 0; i < 3; i++) driver.tick();
+        OPENVOX_CHECK(b == 1 && driver.getSubsystemStats().size() == 2 && driver.getSubsystemStats()[1].name == "b");
+        OPENVOX_CHECK(order == std::vector<int>({ 0, 1, 0, 1, 0, 1 }));
+        OPENVOX_CHECK(ticks == std::vector<u64>({ 0, 1, 2 }) && driver.getTickCount() == 3 && driver.getStats().ticks == 3);
+    });
+
+    test::run("overload steps the policy up one level per tick", [] {
+        TickDriver driver(RATE);
+        Load load;
+        addLoad(driver, load);
+        load.work = HEAVY;
+        for (int i = 0; i < 6; i++) driver.tick();
+        // Five default levels, so the last two ticks stay at the top one
+        OPENVOX_CHECK(driver.getDegradationLevel() == 4 && driver.getStats().degradationChanges == 4);
+        for (u32 i = 0; i < load.contexts.size(); i++) OPENVOX_CHECK(load.contexts[i].degradationLevel == (i < 4 ? i : 4));
+        OPENVOX_CHECK(load.contexts[1].degradation.chunkGenerationScale == 0.0f);
+        OPENVOX_CHECK(load.contexts[2].degradation.randomTickScale == 0.5f);
+        OPENVOX_CHECK(load.contexts[5].degradation.distantEntityInterval == 4 && load.contexts[5].degradation.randomTickScale == 0.25f);
+    });
+
+    test::run("recovery needs consecutive light ticks", [] {
+        TickDriver driver(RATE);
+        Load load;
+        addLoad(driver, load);
+        load.work = HEAVY;
+        driver.tick();
+        driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 2);
+
+        // Two light ticks, then one between the thresholds restarts the count
+        load.work = 0.0;
+        driver.tick();
+        driver.tick();
+        load.work = MEDIUM;
+        driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 2);
+        load.work = 0.0;
+        driver.tick();
+        driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 2);
+        driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 1);
+        for (int i = 0; i < 3; i++) driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 0);
+        for (int i = 0; i < 6; i++) driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 0 && driver.getStats().degradationChanges == 4);
+    });
+
+    test::run("custom policies clamp the current level", [] {
+        TickDriver driver(RATE);
+        Load load;
+        addLoad(driver, load);
+        load.work = HEAVY;
+        for (int i = 0; i < 3; i++) driver.tick();
+        std::vector<TickDegradation> policy(2);
+        policy[1].randomTickScale = 0.1f;
+        driver.setPolicy(policy);
+        OPENVOX_CHECK(driver.getDegradationLevel() == 1 && driver.getStats().degradationLevel == 1);
+        driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 1 && load.contexts.back().degradation.randomTickScale == 0.1f);
+
+        // A single level never degrades
+        driver.setPolicy(std::vector<TickDegradation>(1));
+        driver.tick();
+        OPENVOX_CHECK(driver.getDegradationLevel() == 0);
+    });
+
+    test::run("statistics count late and over budget ticks", [] {
+        TickDriver driver(20.0f);
+        f64 work = 0.0;
+        driver.addSubsystem("work", 0.01f, [&](const TickContext&) { spin(work); });
+        int sent = 0;
+        auto* listener = driver.onTick.addFunctor([&](Sender, const TickStats& s) { sent = (int)s.ticks; });
+        driver.tick();
+        work = 0.02;
+        driver.tick();
+        work = 0.06;
+        driver.tick();
+        const TickStats& stats = driver.getStats();
+        const TickSubsystemStats& sub = driver.getSubsystemStats()[0];
+        OPENVOX_CHECK(sent == 3 && stats.ticks == 3 && stats.lateTicks == 1);
+        OPENVOX_CHECK(sub.overBudgetTicks == 2 && sub.maxTime >= 0.06f && sub.lastTime >= 0.06f);
+        OPENVOX_CHECK(stats.maxTickTime >= sub.maxTime && stats.lastTickTime >= sub.lastTime);
+        OPENVOX_CHECK(stats.averageTickTime > 0.0f && stats.averageTickTime < stats.maxTickTime);
+
+        std::string text;
+        driver.exportStats(text);
+        OPENVOX_CHECK(text.find("openvox_ticks_total 3\n") != std::string::npos);
+        OPENVOX_CHECK(text.find("openvox_ticks_late_total 1\n") != std::string::npos);
+        OPENVOX_CHECK(text.find("openvox_subsystem_over_budget_total{subsystem=\"work\"} 2\n") != std::string::npos);
+
+        driver.resetStats();
+        OPENVOX_CHECK(driver.getStats().ticks == 0 && driver.getSubsystemStats()[0].overBudgetTicks == 0);
+        OPENVOX_CHECK(driver.getTickCount() == 3);
+        driver.onTick -= *listener;
+        delete listener;
+    });
+
+    test::run("run keeps the rate and drops a long backlog", [] {
+        TickDriver driver(100.0f);
+        int ticks = 0;
+        driver.addSubsystem("stop", 0.01f, [&](const TickContext& c) {
+            // Tick 10 takes 15 intervals, more than the driver catches up
+            if (c.tick == 10) spin(0.15);
+            if (++ticks == 40) driver.stop();
+        });
+        Clock::time_point start = Clock::now();
+        driver.run();
+        f64 seconds = std::chrono::duration<f64>(Clock::now() - start).count();
+        const TickStats& stats = driver.getStats();
+        OPENVOX_CHECK(ticks == 40 && stats.ticks == 40);
+        // The 14 intervals behind are dropped rather than run back to back, so the remaining
+        // ticks keep their spacing and the run ends about 0.54 s in instead of 0.4 s
+        OPENVOX_CHECK(stats.droppedTicks >= 12 && stats.droppedTicks <= 15);
+        OPENVOX_CHECK(seconds > 0.45 && seconds < 1.0);
+        OPENVOX_CHECK(stats.lateTicks == 1);
+    });
+
+    return test::finish();
+}
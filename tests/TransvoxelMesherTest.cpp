@@ -0,0 +1,162 @@
+#include <cstdio>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestMeshes.h"
+
+#include "mesh/CellShape.h"
+#include "mesh/TransvoxelMesher.h"
+
+using namespace openvox;
+
+namespace {
+    struct ChunkMesh {
+        i32v3 chunkPos;
+        u32 lod;
+        u8 transitionFaces;
+    };
+
+    /// Adds every chunk of one LOD in [chunkMin, chunkMax] without transition faces
+    void addChunks(std::vector<ChunkMesh>& chunks, const i32v3& chunkMin, const i32v3& chunkMax, u32 lod) {
+        for (i32 z = chunkMin.z; z <= chunkMax.z; z++) {
+            for (i32 y = chunkMin.y; y <= chunkMax.y; y++) {
+                for (i32 x = chunkMin.x; x <= chunkMax.x; x++) chunks.push_back({ i32v3(x, y, z), lod, 0 });
+            }
+        }
+    }
+
+    /// Meshes the chunks and welds them, checking the split between regular and transition indices
+    test::MeshCheck meshScene(const std::vector<ChunkMesh>& chunks, const i32v3& boxMin, const i32v3& boxMax,
+                              const TransvoxelMesher::DensityFunc& density, OUT size_t& transitionTriangles) {
+        TransvoxelMesher mesher;
+        TransvoxelMesh mesh;
+        test::MeshWelder welder(boxMin, boxMax);
+        transitionTriangles = 0;
+        for (const ChunkMesh& c : chunks) {
+            mesher.mesh(c.chunkPos, c.lod, c.transitionFaces, density, mesh);
+            OPENVOX_CHECK(mesh.indices.size() % 3 == 0 && mesh.regularIndexCount % 3 == 0 && mesh.regularIndexCount <= mesh.indices.size());
+            OPENVOX_CHECK(c.transitionFaces || mesh.regularIndexCount == mesh.indices.size());
+            transitionTriangles += (mesh.indices.size() - mesh.regularIndexCount) / 3;
+            welder.add(c.chunkPos, c.lod, mesh);
+        }
+        return welder.check();
+    }
+
+    /// Checks a scene on the noise field, whose surface crosses every seam, and on the smooth terrain
+    void checkScene(const char* name, const std::vector<ChunkMesh>& chunks, const i32v3& boxMin, const i32v3& boxMax) {
+        size_t transitionTriangles = 0;
+        test::MeshCheck check = meshScene(chunks, boxMin, boxMax, test::getTestDensity, transitionTriangles);
+        std::printf("    %-36s %6zu triangles, %4zu in transition cells, %zu open, %zu non-manifold, %zu degenerate\n", name,
+                    check.triangles, transitionTriangles, check.openEdges, check.nonManifoldEdges, check.degenerate);
+        OPENVOX_CHECK(check.triangles > 1000 && transitionTriangles > 0 && check.boundaryEdges > 0);
+        OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.degenerate == 0);
+        // Features of the noise near the cell size leave a few gradients facing across their triangles
+        OPENVOX_CHECK(check.badWinding * 1000 < check.triangles);
+
+        check = meshScene(chunks, boxMin, boxMax, test::getTerrainDensity, transitionTriangles);
+        OPENVOX_CHECK(check.triangles > 1000 && transitionTriangles > 0);
+        OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.degenerate == 0);
+        // Where a transition face meets a face shared with the same LOD, a few transition
+        // triangles lie flat in the seam
+        OPENVOX_CHECK(check.badWinding * 1000 < check.triangles);
+    }
+}
+
+int main() {
+    test::run("every cube case cuts each crossing edge once into closed loops", [] {
+        const CellShape& cube = CellShape::getCube();
+        OPENVOX_CHECK(cube.getPoints().size() == 8 && cube.getEdges().size() == 12);
+        int bad = 0;
+        std::vector<std::vector<int> > loops;
+        std::vector<u8> triangles;
+        for (u32 inside = 0; inside < 256; inside++) {
+            cube.getLoops(inside, loops);
+            int uses[12] = {};
+            size_t loopTriangles = 0;
+            for (const std::vector<int>& loop : loops) {
+                if (loop.size() < 3) bad++;
+                loopTriangles += loop.size() - 2;
+                for (int e : loop) uses[e]++;
+            }
+            for (int e = 0; e < 12; e++) {
+                const i32v2& edge = cube.getEdges()[e];
+                bool crossing = ((inside >> edge.x) & 1) != ((inside >> edge.y) & 1);
+                if (uses[e] != (crossing ? 1 : 0)) bad++;
+            }
+            triangles.clear();
+            cube.triangulate(inside, triangles);
+            if (triangles.size() != loopTriangles * 3) bad++;
+        }
+        OPENVOX_CHECK(bad == 0);
+        OPENVOX_CHECK(cube.findEdge(0, 1) >= 0 && cube.findEdge(1, 0) == cube.findEdge(0, 1) && cube.findEdge(0, 7) == -1);
+    });
+
+    test::run("packed vertices keep positions to the packing step and normals to a degree", [] {
+        test::Random random(70);
+        f32 worstPosition = 0.0f, worstNormal = 1.0f;
+        for (int i = 0; i < 10000; i++) {
+            f32v3 p(random.range(0.0f, 63.9f), random.range(0.0f, 63.9f), random.range(0.0f, 63.9f));
+            f32v3 n(random.range(-1.0f, 1.0f), random.range(-1.0f, 1.0f), random.range(-1.0f, 1.0f));
+            if (openvoxm::length(n) < 0.01f) continue;
+            PackedVertex v = packVertex(p, n * 37.0f);
+            for (int a = 0; a < 3; a++) worstPosition = openvoxm::max(worstPosition, openvoxm::abs(v.position[a] / (f32)PACKED_POSITION_SCALE - p[a]));
+            worstNormal = openvoxm::min(worstNormal, openvoxm::dot(test::unpackNormal(v), n / openvoxm::length(n)));
+        }
+        OPENVOX_CHECK(worstPosition <= 0.5f / PACKED_POSITION_SCALE + 1e-5f);
+        OPENVOX_CHECK(worstNormal > 0.9997f);
+    });
+
+    test::run("chunks of one LOD close up", [] {
+        std::vector<ChunkMesh> chunks;
+        addChunks(chunks, i32v3(0, 2, 0), i32v3(2, 4, 2), 0);
+        size_t transitionTriangles = 0;
+        test::MeshCheck check = meshScene(chunks, i32v3(0, 64, 0), i32v3(96, 160, 96), test::getTestDensity, transitionTriangles);
+        OPENVOX_CHECK(check.triangles > 1000 && check.boundaryEdges > 0 && transitionTriangles == 0);
+        OPENVOX_CHECK(check.openEdges == 0 && check.nonManifoldEdges == 0 && check.degenerate == 0 && check.badWinding == 0);
+        // Vertices on cell edges are shared, about one per two triangles
+        OPENVOX_CHECK(check.vertices * 10 < check.triangles * 6);
+    });
+
+    test::run("seams between LODs are crack free", [] {
+        std::vector<ChunkMesh> chunks;
+        // Two LOD 1 chunks in a row with LOD 0 along their +x faces
+        chunks.push_back({ i32v3(0, 1, 0), 1, TRANSVOXEL_FACE_POS_X });
+        chunks.push_back({ i32v3(0, 1, 1), 1, TRANSVOXEL_FACE_POS_X });
+        addChunks(chunks, i32v3(2, 2, 0), i32v3(3, 3, 3), 0);
+        checkScene("LOD 1 chunks, +x seam", chunks, i32v3(0, 64, 0), i32v3(128, 128, 128));
+
+        chunks.clear();
+        chunks.push_back({ i32v3(0, 1, 0), 1, TRANSVOXEL_FACE_POS_X | TRANSVOXEL_FACE_POS_Z });
+        addChunks(chunks, i32v3(2, 2, 0), i32v3(3, 3, 3), 0);
+        addChunks(chunks, i32v3(0, 2, 2), i32v3(1, 3, 3), 0);
+        checkScene("LOD 1 chunk, +x and +z seams", chunks, i32v3(0, 64, 0), i32v3(128, 128, 128));
+
+        chunks.clear();
+        chunks.push_back({ i32v3(1, 1, 1), 1, TRANSVOXEL_FACE_NEG_X | TRANSVOXEL_FACE_NEG_Z });
+        addChunks(chunks, i32v3(0, 2, 0), i32v3(1, 3, 3), 0);
+        addChunks(chunks, i32v3(2, 2, 0), i32v3(3, 3, 1), 0);
+        checkScene("LOD 1 chunk, -x and -z seams", chunks, i32v3(0, 64, 0), i32v3(128, 128, 128));
+
+        // LOD 1 chunks around a corner of LOD 0, one touching it only along an edge
+        chunks.clear();
+        chunks.push_back({ i32v3(0, 1, 0), 1, TRANSVOXEL_FACE_POS_X });
+        chunks.push_back({ i32v3(1, 1, 1), 1, TRANSVOXEL_FACE_NEG_Z });
+        chunks.push_back({ i32v3(0, 1, 1), 1, 0 });
+        addChunks(chunks, i32v3(2, 2, 0), i32v3(3, 3, 1), 0);
+        checkScene("LOD 1 chunks, edge next to LOD 0", chunks, i32v3(0, 64, 0), i32v3(128, 128, 128));
+
+        // A LOD 2 chunk inside a shell of LOD 1 chunks
+        chunks.clear();
+        chunks.push_back({ i32v3(0, 0, 0), 2, 0x3F });
+        std::vector<ChunkMesh> shell;
+        addChunks(shell, i32v3(-1), i32v3(2), 1);
+        for (const ChunkMesh& c : shell) {
+            if (c.chunkPos.x < 0 || c.chunkPos.x > 1 || c.chunkPos.y < 0 || c.chunkPos.y > 1 || c.chunkPos.z < 0 || c.chunkPos.z > 1) {
+                chunks.push_back(c);
+            }
+        }
+        checkScene("LOD 2 chunk, all six seams to LOD 1", chunks, i32v3(-64), i32v3(192));
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "net/UdpTransport.h"
+
+using namespace openvox;
+
+namespace {
+    /// A server and a client transport connected over localhost
+    struct Link {
+        UdpTransport server;
+        UdpTransport client;
+        ClientID serverSide = 0; ///< The client as the server knows it
+        ClientID clientSide = 0; ///< The server as the client knows it
+
+        bool open() {
+            if (!server.open(0, true) || !client.open(0, false)) return false;
+            auto* listener = server.onConnect.addFunctor([this](Sender, ClientID id) { serverSide = id; });
+            clientSide = client.connect("127.0.0.1", server.getLocalPort());
+            bool connected = pump([this]() { return serverSide != 0 && client.isConnected(clientSide); }, 5.0);
+            server.onConnect -= *listener;
+            delete listener;
+            return connected;
+        }
+        /// Updates both ends until done() or the time runs out
+        template<typename F>
+        bool pump(F done, double seconds) {
+            auto start = std::chrono::steady_clock::now();
+            while (!done()) {
+                if (std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > seconds) return false;
+                server.update();
+                client.update();
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+            return true;
+        }
+    };
+
+    std::vector<u8> makeMessage(u32 index, size_t size) {
+        std::vector<u8> m(size);
+        test::Random random(index);
+        for (size_t i = 0; i < size; i++) m[i] = (u8)random.next();
+        m[0] = (u8)index;
+        m[1] = (u8)(index >> 8);
+        return m;
+    }
+    u32 getIndex(const std::vector<u8>& m) {
+        return m[0] | (u32)m[1] << 8;
+    }
+}
+
+int main() {
+    test::run("connects over localhost", [] {
+        Link link;
+        OPENVOX_CHECK(link.open());
+        OPENVOX_CHECK(link.server.isConnected(link.serverSide));
+        std::vector<ClientID> clients;
+        link.server.getClients(clients);
+        OPENVOX_CHECK(clients.size() == 1);
+        // A client socket does not accept connections
+        UdpTransport other;
+        OPENVOX_CHECK(other.open(0, false));
+        ClientID id = other.connect("127.0.0.1", link.client.getLocalPort());
+        OPENVOX_CHECK(id != 0);
+        OPENVOX_CHECK(!link.pump([&]() { other.update(); return other.isConnected(id); }, 0.3));
+        OPENVOX_CHECK(other.connect("not an address", 1) == 0);
+    });
+
+    test::run("reliable messages survive loss and reordering", [] {
+        Link link;
+        OPENVOX_CHECK(link.open());
+        link.server.setSimulation(0.05f, 0.005f, 0.005f);
+        link.client.setSimulation(0.05f, 0.005f, 0.005f);
+
+        const u32 ordered = 300, unordered = 100;
+        for (u32 i = 0; i < ordered; i++) {
+            OPENVOX_CHECK(link.client.send(link.clientSide, makeMessage(i, i % 50 == 0 ? 16384 : 40 + i % 200).data(),
+                                           i % 50 == 0 ? 16384 : 40 + i % 200, UdpChannel::RELIABLE_ORDERED));
+        }
+        for (u32 i = 0; i < unordered; i++) {
+            u32 index = ordered + i;
+            OPENVOX_CHECK(link.client.send(link.clientSide, makeMessage(index, 300).data(), 300, UdpChannel::RELIABLE_UNORDERED));
+        }
+
+        std::vector<u8> message;
+        u32 nextOrdered = 0;
+        std::vector<int> seen(ordered + unordered, 0);
+        int corrupt = 0, outOfOrder = 0;
+        bool done = link.pump([&]() {
+            while (link.server.receive(link.serverSide, message)) {
+                u32 index = getIndex(message);
+                if (index >= ordered + unordered) {
+                    corrupt++;
+                    continue;
+                }
+                size_t size = index < ordered ? (index % 50 == 0 ? 16384 : 40 + index % 200) : 300;
+                corrupt += message != makeMessage(index, size) ? 1 : 0;
+                seen[index]++;
+                if (index < ordered) outOfOrder += index != nextOrdered++ ? 1 : 0;
+            }
+            return nextOrdered == ordered && std::count(seen.begin() + ordered, seen.end(), 1) == (int)unordered;
+        }, 30.0);
+        OPENVOX_CHECK(done);
+        OPENVOX_CHECK(corrupt == 0);
+        OPENVOX_CHECK(outOfOrder == 0);
+        OPENVOX_CHECK(std::count(seen.begin(), seen.end(), 1) == (int)(ordered + unordered));
+        OPENVOX_CHECK(link.client.getStats(link.clientSide)->unitsResent > 0);
+    });
+
+    test::run("a reliable message in a lost first data packet still arrives", [] {
+        Link link;
+        OPENVOX_CHECK(link.open());
+        // The first data packet has sequence 0, which a peer that has received nothing must not ack
+        OPENVOX_CHECK(link.client.getStats(link.clientSide)->packetsSent == 0);
+        link.client.setSimulation(1.0f, 0.0f, 0.0f);
+        std::vector<u8> sent = makeMessage(63, 200);
+        OPENVOX_CHECK(link.client.send(link.clientSide, sent.data(), sent.size(), UdpChannel::RELIABLE_ORDERED));
+        link.client.update();
+        OPENVOX_CHECK(link.client.getStats(link.clientSide)->packetsSent == 1);
+        link.client.setSimulation(0.0f, 0.0f, 0.0f);
+
+        std::vector<u8> message;
+        OPENVOX_CHECK(link.pump([&]() { return link.server.receive(link.serverSide, message); }, 3.0));
+        OPENVOX_CHECK(message == sent);
+        OPENVOX_CHECK(link.client.getStats(link.clientSide)->unitsResent > 0);
+    });
+
+    test::run("unreliable messages and size limits", [] {
+        Link link;
+        OPENVOX_CHECK(link.open());
+        std::vector<u8> small = makeMessage(7, 100);
+        OPENVOX_CHECK(link.server.send(link.serverSide, small.data(), small.size(), UdpChannel::UNRELIABLE));
+        std::vector<u8> message;
+        OPENVOX_CHECK(link.pump([&]() { return link.client.receive(link.clientSide, message); }, 2.0));
+        OPENVOX_CHECK(message == small);
+
+        std::vector<u8> big(UDP_MAX_PACKET_SIZE + 1);
+        OPENVOX_CHECK(!link.server.send(link.serverSide, big.data(), big.size(), UdpChannel::UNRELIABLE));
+        std::vector<u8> huge(UDP_MAX_MESSAGE_SIZE + 1);
+        OPENVOX_CHECK(!link.server.send(link.serverSide, huge.data(), huge.size(), UdpChannel::RELIABLE_ORDERED));
+        OPENVOX_CHECK(!link.server.send(12345, small.data(), small.size()));
+    });
+
+    test::run("disconnects and timeouts", [] {
+        Link link;
+        OPENVOX_CHECK(link.open());
+        ClientID dropped = 0;
+        auto* listener = link.server.onDisconnect.addFunctor([&](Sender, ClientID id) { dropped = id; });
+        link.client.disconnect(link.clientSide);
+        OPENVOX_CHECK(!link.client.isConnected(link.clientSide));
+        OPENVOX_CHECK(link.pump([&]() { return !link.server.isConnected(link.serverSide); }, 2.0));
+        OPENVOX_CHECK(dropped == link.serverSide);
+
+        // A peer that goes silent times out
+        Link silent;
+        OPENVOX_CHECK(silent.open());
+        silent.server.setTimeout(0.2f);
+        auto* silentListener = silent.server.onDisconnect.addFunctor([&](Sender, ClientID id) { dropped = id; });
+        dropped = 0;
+        silent.client.close();
+        auto start = std::chrono::steady_clock::now();
+        while (dropped == 0 && std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+            silent.server.update();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        OPENVOX_CHECK(dropped == silent.serverSide);
+        silent.server.onDisconnect -= *silentListener;
+        link.server.onDisconnect -= *listener;
+        delete silentListener;
+        delete listener;
+    });
+
+    return test::finish();
+}
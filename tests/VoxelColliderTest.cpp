@@ -0,0 +1,152 @@
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "physics/VoxelCollider.h"
+
+using namespace openvox;
+
+namespace {
+    // 3x1x3 chunks with a solid floor whose top face is at y = 8
+    void buildFloor(ChunkMap& map) {
+        for (i32 cz = -1; cz <= 1; cz++) {
+            for (i32 cx = -1; cx <= 1; cx++) {
+                Chunk* chunk = map.createChunk(i32v3(cx, 0, cz));
+                for (i32 y = 0; y < 8; y++) {
+                    for (i32 z = 0; z < CHUNK_WIDTH; z++) {
+                        for (i32 x = 0; x < CHUNK_WIDTH; x++) chunk->setBlock(x, y, z, 1);
+                    }
+                }
+            }
+        }
+    }
+
+    AABB makeBox(const f32v3& center, const f32v3& half) {
+        return AABB(center - half, center + half);
+    }
+}
+
+int main() {
+    test::run("falling box lands on the floor", [] {
+        ChunkMap map;
+        buildFloor(map);
+        VoxelCollider collider(&map);
+        AABB box = makeBox(f32v3(0.5f, 12.0f, 0.5f), f32v3(0.3f, 0.9f, 0.3f));
+        MoveResult r = collider.move(box, f32v3(0.0f, -10.0f, 0.0f));
+        OPENVOX_CHECK(std::fabs(box.min.y - 8.0f) < 1e-3f);
+        OPENVOX_CHECK((r.flags & COLLISION_Y) != 0);
+        OPENVOX_CHECK((r.flags & COLLISION_ON_GROUND) != 0);
+        OPENVOX_CHECK(!collider.isBoxObstructed(box));
+    });
+
+    test::run("fast move does not tunnel through a wall", [] {
+        ChunkMap map;
+        buildFloor(map);
+        for (i32 y = 8; y < 12; y++) {
+            for (i32 z = -4; z < 4; z++) map.setBlock(i32v3(5, y, z), 1);
+        }
+        VoxelCollider collider(&map);
+        AABB box = makeBox(f32v3(0.5f, 9.0f, 0.5f), f32v3(0.3f, 0.9f, 0.3f));
+        MoveResult r = collider.move(box, f32v3(40.0f, 0.0f, 0.0f));
+        OPENVOX_CHECK((r.flags & COLLISION_X) != 0);
+        OPENVOX_CHECK(std::fabs(box.max.x - 5.0f) < 1e-3f);
+    });
+
+    test::run("sliding keeps the unblocked axis", [] {
+        ChunkMap map;
+        buildFloor(map);
+        for (i32 y = 8; y < 12; y++) {
+            for (i32 z = -8; z < 8; z++) map.setBlock(i32v3(3, y, z), 1);
+        }
+        VoxelCollider collider(&map);
+        AABB box = makeBox(f32v3(0.5f, 9.0f, 0.5f), f32v3(0.3f, 0.9f, 0.3f));
+        MoveResult r = collider.move(box, f32v3(5.0f, 0.0f, 2.0f));
+        OPENVOX_CHECK((r.flags & COLLISION_X) != 0);
+        OPENVOX_CHECK((r.flags & COLLISION_Z) == 0);
+        OPENVOX_CHECK(std::fabs(r.offset.z - 2.0f) < 1e-5f);
+    });
+
+    test::run("step up onto a one voxel ledge", [] {
+        ChunkMap map;
+        buildFloor(map);
+        for (i32 z = -8; z < 8; z++) {
+            for (i32 x = 2; x < 8; x++) map.setBlock(i32v3(x, 8, z), 1);
+        }
+        VoxelCollider collider(&map);
+        AABB box = makeBox(f32v3(0.5f, 8.9f, 0.5f), f32v3(0.3f, 0.9f, 0.3f));
+        MoveResult r = collider.move(box, f32v3(2.0f, -0.1f, 0.0f), 1.05f, true);
+        OPENVOX_CHECK((r.flags & COLLISION_STEPPED) != 0);
+        OPENVOX_CHECK(std::fabs(box.min.y - 9.0f) < 1e-3f);
+        OPENVOX_CHECK(std::fabs(r.offset.x - 2.0f) < 1e-5f);
+
+        // Without step height the ledge is a wall
+        AABB blocked = makeBox(f32v3(0.5f, 8.9f, 0.5f), f32v3(0.3f, 0.9f, 0.3f));
+        MoveResult b = collider.move(blocked, f32v3(2.0f, -0.1f, 0.0f), 0.0f, true);
+        OPENVOX_CHECK((b.flags & COLLISION_X) != 0);
+        OPENVOX_CHECK(std::fabs(blocked.max.x - 2.0f) < 1e-3f);
+    });
+
+    test::run("unloaded chunks block unless disabled", [] {
+        ChunkMap map;
+        map.createChunk(i32v3(0, 0, 0));
+        VoxelCollider collider(&map);
+        AABB box = makeBox(f32v3(16.0f, 16.0f, 16.0f), f32v3(0.3f, 0.9f, 0.3f));
+        collider.move(box, f32v3(0.0f, -40.0f, 0.0f));
+        OPENVOX_CHECK(std::fabs(box.min.y) < 1e-3f);
+
+        collider.setUnloadedSolid(false);
+        box = makeBox(f32v3(16.0f, 16.0f, 16.0f), f32v3(0.3f, 0.9f, 0.3f));
+        collider.move(box, f32v3(0.0f, -40.0f, 0.0f));
+        OPENVOX_CHECK(box.min.y < -20.0f);
+    });
+
+    test::run("batched bodies never end inside terrain", [] {
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(-2, -1, -2), i32v3(1, 1, 1));
+        VoxelCollider collider(&map);
+        CollisionBatch batch;
+        test::Random random(51);
+        for (int i = 0; i < 500; i++) {
+            f32 x = random.range(-56.0f, 24.0f);
+            f32 z = random.range(-56.0f, 24.0f);
+            size_t b = batch.add(f32v3(x, (f32)test::getTerrainHeight((i32)x, (i32)z) + 4.0f, z), f32v3(0.3f, 0.9f, 0.3f), 0.6f);
+            batch.setVelocity(b, f32v3(random.range(-6.0f, 6.0f), 0.0f, random.range(-6.0f, 6.0f)));
+        }
+        int overlapping = 0;
+        for (int tick = 0; tick < 120; tick++) {
+            collider.step(batch, 1.0f / 20.0f);
+            for (size_t i = 0; i < batch.size(); i++) {
+                f32v3 p = batch.getPosition(i);
+                AABB box(p - f32v3(batch.halfX[i], batch.halfY[i], batch.halfZ[i]),
+                         p + f32v3(batch.halfX[i], batch.halfY[i], batch.halfZ[i]));
+                if (collider.isBoxObstructed(box)) overlapping++;
+            }
+        }
+        OPENVOX_CHECK(overlapping == 0);
+
+        // Walking downhill leaves the ground briefly, so stop and settle before checking
+        for (size_t i = 0; i < batch.size(); i++) batch.setVelocity(i, f32v3(0.0f));
+        for (int tick = 0; tick < 20; tick++) collider.step(batch, 1.0f / 20.0f);
+        size_t grounded = 0;
+        for (size_t i = 0; i < batch.size(); i++) grounded += batch.isOnGround(i) ? 1 : 0;
+        OPENVOX_CHECK(grounded == batch.size());
+    });
+
+    test::run("getSolidVoxels matches getBlock", [] {
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(-1, 0, -1), i32v3(0, 0, 0));
+        VoxelCollider collider(&map);
+        std::vector<i32v3> voxels;
+        AABB region(f32v3(-10.5f, 10.0f, -3.2f), f32v3(9.5f, 25.0f, 4.8f));
+        collider.getSolidVoxels(region, voxels);
+        size_t expected = 0;
+        for (i32 y = 10; y <= 25; y++) {
+            for (i32 z = -4; z <= 4; z++) {
+                for (i32 x = -11; x <= 9; x++) expected += map.getBlock(i32v3(x, y, z)) != BLOCK_AIR ? 1 : 0;
+            }
+        }
+        OPENVOX_CHECK(voxels.size() == expected);
+        for (size_t i = 0; i < voxels.size(); i++) OPENVOX_CHECK(map.getBlock(voxels[i]) != BLOCK_AIR);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,142 @@
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/VoxelCursor.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 REGION_MIN(-2, -1, -2); ///< Chunks that may be loaded
+    const i32v3 REGION_MAX(2, 1, 2);
+    const BlockID UNLOADED = 999;
+
+    /// Loads about two thirds of the region with random blocks
+    void buildRandomWorld(ChunkMap& map, test::Random& random) {
+        for (i32 cy = REGION_MIN.y; cy <= REGION_MAX.y; cy++) {
+            for (i32 cz = REGION_MIN.z; cz <= REGION_MAX.z; cz++) {
+                for (i32 cx = REGION_MIN.x; cx <= REGION_MAX.x; cx++) {
+                    if (random.range(0, 2) == 0) continue;
+                    Chunk* chunk = map.createChunk(i32v3(cx, cy, cz));
+                    BlockID* blocks = chunk->getMutableBlockData();
+                    for (int i = 0; i < CHUNK_SIZE; i++) blocks[i] = (BlockID)random.range(0, 500);
+                    chunk->updateOccupancy();
+                }
+            }
+        }
+    }
+
+    i32v3 getRandomVoxel(test::Random& random) {
+        i32v3 min = REGION_MIN * CHUNK_WIDTH, max = (REGION_MAX + i32v3(1)) * CHUNK_WIDTH - i32v3(1);
+        return i32v3(random.range(min.x, max.x), random.range(min.y, max.y), random.range(min.z, max.z));
+    }
+
+    /// Checks every link of every loaded chunk against a map lookup
+    bool linksMatch(const ChunkMap& map) {
+        for (auto& it : map.getChunks()) {
+            const Chunk* chunk = it.second;
+            for (int i = 0; i < CHUNK_NEIGHBOR_COUNT; i++) {
+                i32v3 offset(i % 3 - 1, i / 9 - 1, i / 3 % 3 - 1);
+                if (getNeighborIndex(offset) != i) return false;
+                if (chunk->getNeighbor(i) != map.getChunk(it.first + offset)) return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main() {
+    test::run("neighbor tables list faces, edges and corners with matching index offsets", [] {
+        bool tablesMatch = true;
+        for (int n = 0; n < VOXEL_NEIGHBORS; n++) {
+            i32v3 o(VOXEL_NEIGHBOR_OFFSETS[n][0], VOXEL_NEIGHBOR_OFFSETS[n][1], VOXEL_NEIGHBOR_OFFSETS[n][2]);
+            int axes = (o.x != 0) + (o.y != 0) + (o.z != 0);
+            int expectedAxes = n < VOXEL_FACE_NEIGHBORS ? 1 : n < VOXEL_EDGE_NEIGHBORS ? 2 : 3;
+            tablesMatch &= axes == expectedAxes;
+            for (int m = 0; m < n; m++) {
+                tablesMatch &= !(VOXEL_NEIGHBOR_OFFSETS[m][0] == o.x && VOXEL_NEIGHBOR_OFFSETS[m][1] == o.y &&
+                                 VOXEL_NEIGHBOR_OFFSETS[m][2] == o.z);
+            }
+            tablesMatch &= VOXEL_NEIGHBOR_INDEX_OFFSETS[n] == getVoxelIndex(i32v3(5) + o) - getVoxelIndex(i32v3(5));
+        }
+        OPENVOX_CHECK(tablesMatch);
+        // Faces follow VoxelFace
+        OPENVOX_CHECK(VOXEL_NEIGHBOR_OFFSETS[(int)VoxelFace::NEG_X][0] == -1 && VOXEL_NEIGHBOR_OFFSETS[(int)VoxelFace::POS_Y][1] == 1 &&
+                      VOXEL_NEIGHBOR_OFFSETS[(int)VoxelFace::NEG_Z][2] == -1 && VOXEL_NEIGHBOR_OFFSETS[(int)VoxelFace::POS_Z][2] == 1);
+    });
+
+    test::run("cursor reads match ChunkMap::getBlock along random walks", [] {
+        test::Random random(74);
+        ChunkMap map;
+        buildRandomWorld(map, random);
+        VoxelCursor cursor(&map, getRandomVoxel(random));
+        size_t mismatches = 0, borderReads = 0;
+        for (int step = 0; step < 20000; step++) {
+            // Mostly short steps that cross chunk borders often, sometimes long jumps
+            int kind = random.range(0, 9);
+            if (kind < 5) {
+                cursor.moveToNeighbor(random.range(0, VOXEL_NEIGHBORS - 1));
+            } else if (kind < 9) {
+                cursor.move(i32v3(random.range(-40, 40), random.range(-40, 40), random.range(-40, 40)));
+            } else {
+                cursor.setPosition(getRandomVoxel(random));
+            }
+            const i32v3& p = cursor.getPosition();
+            if (cursor.getChunk() != map.getChunk(toChunkPosition(p))) mismatches++;
+            if (cursor.getChunk() && cursor.getIndex() != getVoxelIndex(toLocalPosition(p))) mismatches++;
+            if (cursor.getBlock(UNLOADED) != map.getBlock(p, UNLOADED)) mismatches++;
+            for (int n = 0; n < VOXEL_NEIGHBORS; n++) {
+                i32v3 q = p + i32v3(VOXEL_NEIGHBOR_OFFSETS[n][0], VOXEL_NEIGHBOR_OFFSETS[n][1], VOXEL_NEIGHBOR_OFFSETS[n][2]);
+                if (cursor.getNeighborBlock(n, UNLOADED) != map.getBlock(q, UNLOADED)) mismatches++;
+                if (toChunkPosition(q) != toChunkPosition(p)) borderReads++;
+            }
+            i32v3 offset(random.range(-70, 70), random.range(-70, 70), random.range(-70, 70));
+            if (cursor.getBlock(offset, UNLOADED) != map.getBlock(p + offset, UNLOADED)) mismatches++;
+        }
+        OPENVOX_CHECK(mismatches == 0);
+        // The walk has to have read across borders for the links to be exercised
+        OPENVOX_CHECK(borderReads > 10000);
+    });
+
+    test::run("links match lookups after random loads and unloads", [] {
+        test::Random random(740);
+        ChunkMap map;
+        OPENVOX_CHECK(linksMatch(map));
+        size_t creates = 0, destroys = 0;
+        for (int step = 0; step < 3000; step++) {
+            i32v3 chunkPos(random.range(REGION_MIN.x, REGION_MAX.x), random.range(REGION_MIN.y, REGION_MAX.y),
+                           random.range(REGION_MIN.z, REGION_MAX.z));
+            if (random.range(0, 1)) {
+                if (!map.getChunk(chunkPos)) creates++;
+                Chunk* chunk = map.createChunk(chunkPos);
+                OPENVOX_CHECK(chunk->getNeighbor(CHUNK_NEIGHBOR_CENTER) == chunk);
+            } else if (map.destroyChunk(chunkPos)) {
+                destroys++;
+            }
+            if (step % 50 == 0 && !linksMatch(map)) OPENVOX_CHECK(false);
+        }
+        OPENVOX_CHECK(linksMatch(map));
+        OPENVOX_CHECK(creates > 500 && destroys > 500);
+
+        // A cursor made after the churn still reads through the links correctly
+        size_t mismatches = 0;
+        VoxelCursor cursor(&map, i32v3(0));
+        for (int step = 0; step < 5000; step++) {
+            cursor.moveToNeighbor(random.range(0, VOXEL_NEIGHBORS - 1));
+            // Stay near the region so most reads land in loaded chunks
+            i32v3 chunkPos = toChunkPosition(cursor.getPosition());
+            if (chunkPos.x < REGION_MIN.x || chunkPos.x > REGION_MAX.x || chunkPos.y < REGION_MIN.y || chunkPos.y > REGION_MAX.y ||
+                chunkPos.z < REGION_MIN.z || chunkPos.z > REGION_MAX.z) {
+                cursor.setPosition(i32v3(0));
+            }
+            for (int n = 0; n < VOXEL_FACE_NEIGHBORS; n++) {
+                i32v3 q = cursor.getPosition() + i32v3(VOXEL_NEIGHBOR_OFFSETS[n][0], VOXEL_NEIGHBOR_OFFSETS[n][1], VOXEL_NEIGHBOR_OFFSETS[n][2]);
+                if (cursor.getNeighborBlock(n, UNLOADED) != map.getBlock(q, UNLOADED)) mismatches++;
+            }
+        }
+        OPENVOX_CHECK(mismatches == 0);
+        map.dispose();
+        OPENVOX_CHECK(map.getChunkCount() == 0);
+    });
+
+    return test::finish();
+}
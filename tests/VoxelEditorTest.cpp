@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "voxel/VoxelEditor.h"
+
+using namespace openvox;
+
+namespace {
+    const i32v3 WORLD_MIN(-1, 0, -1);
+    const i32v3 WORLD_MAX(2, 2, 2);
+    const i32v3 MISSING_CHUNK(1, 1, 0);
+
+    /// Terrain with scattered blocks and one unloaded chunk in the middle
+    void buildWorld(ChunkMap& map) {
+        test::buildTerrain(map, WORLD_MIN, WORLD_MAX, 1, 40, 10.0f);
+        map.destroyChunk(MISSING_CHUNK);
+        test::Random random(57);
+        for (int i = 0; i < 20000; i++) {
+            i32v3 p(random.range(-32, 95), random.range(0, 95), random.range(-32, 95));
+            map.setBlock(p, (BlockID)random.range(0, 4));
+        }
+    }
+
+    /// Per-voxel edit of [min, max] through setBlock. f returns the new value of a voxel.
+    size_t referenceEdit(ChunkMap& map, const i32v3& min, const i32v3& max,
+                         const std::function<BlockID(const i32v3&, BlockID)>& f) {
+        size_t changed = 0;
+        for (i32 y = min.y; y <= max.y; y++) {
+            for (i32 z = min.z; z <= max.z; z++) {
+                for (i32 x = min.x; x <= max.x; x++) {
+                    i32v3 p(x, y, z);
+                    if (!map.getChunk(toChunkPosition(p))) continue;
+                    BlockID v = map.getBlock(p);
+                    BlockID n = f(p, v);
+                    if (n != v) {
+                        map.setBlock(p, n);
+                        changed++;
+                    }
+                }
+            }
+        }
+        return changed;
+    }
+
+    BlockID applyMode(BlockID v, BlockID id, EditMode mode) {
+        if (mode == EditMode::FILL_AIR) return v == BLOCK_AIR ? id : v;
+        if (mode == EditMode::REPLACE_SOLID) return v != BLOCK_AIR ? id : v;
+        return id;
+    }
+
+    bool sameWorld(const ChunkMap& a, const ChunkMap& b) {
+        if (a.getChunkCount() != b.getChunkCount()) return false;
+        for (auto& it : a.getChunks()) {
+            const Chunk* other = b.getChunk(it.first);
+            if (!other || !std::equal(it.second->getBlockData(), it.second->getBlockData() + CHUNK_SIZE, other->getBlockData())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    i32v3 randomPoint(test::Random& random) {
+        return i32v3(random.range(-40, 100), random.range(-8, 100), random.range(-40, 100));
+    }
+}
+
+int main() {
+    test::run("shape edits match per-voxel edits", [] {
+        ChunkMap map, reference;
+        buildWorld(map);
+        buildWorld(reference);
+        VoxelEditor editor(&map);
+        test::Random random(570);
+        const EditMode modes[] = { EditMode::REPLACE, EditMode::FILL_AIR, EditMode::REPLACE_SOLID };
+
+        int mismatches = 0;
+        for (int op = 0; op < 120; op++) {
+            BlockID id = (BlockID)random.range(0, 5);
+            EditMode mode = modes[random.range(0, 2)];
+            size_t got = 0, expected = 0;
+            switch (op % 5) {
+                case 0: {
+                    i32v3 a = randomPoint(random), b = a + i32v3(random.range(0, 40), random.range(0, 40), random.range(0, 40));
+                    got = editor.fillBox(a, b, id, mode);
+                    expected = referenceEdit(reference, a, b, [&](const i32v3&, BlockID v) { return applyMode(v, id, mode); });
+                    break;
+                }
+                case 1: {
+                    i32v3 c = randomPoint(random);
+                    f32 r = random.range(0, 40) * 0.5f;
+                    got = editor.fillSphere(c, r, id, mode);
+                    i32 ri = (i32)r;
+                    expected = referenceEdit(reference, c - i32v3(ri), c + i32v3(ri), [&](const i32v3& p, BlockID v) {
+                        i32v3 d = p - c;
+                        return (f32)(d.x * d.x + d.y * d.y + d.z * d.z) <= r * r ? applyMode(v, id, mode) : v;
+                    });
+                    break;
+                }
+                case 2: {
+                    i32v3 c = randomPoint(random);
+                    f32 r = random.range(0, 30) * 0.5f;
+                    i32 h = random.range(1, 40);
+                    got = editor.fillCylinder(c, r, h, id, mode);
+                    i32 ri = (i32)r;
+                    expected = referenceEdit(reference, c - i32v3(ri, 0, ri), c + i32v3(ri, h - 1, ri), [&](const i32v3& p, BlockID v) {
+                        i32v3 d = p - c;
+                        return (f32)(d.x * d.x + d.z * d.z) <= r * r ? applyMode(v, id, mode) : v;
+                    });
+                    break;
+                }
+                case 3: {
+                    // Destinations near the source so copies often overlap it
+                    i32v3 a = randomPoint(random), b = a + i32v3(random.range(0, 30), random.range(0, 30), random.range(0, 30));
+                    i32v3 dst = a + i32v3(random.range(-12, 12), random.range(-12, 12), random.range(-12, 12));
+                    bool skipAir = random.range(0, 1) != 0;
+                    got = editor.copyRegion(a, b, dst, skipAir);
+                    std::vector<BlockID> src;
+                    VoxelEditor(&reference).readRegion(a, b, src);
+                    i32v3 size = b - a + i32v3(1);
+                    expected = referenceEdit(reference, dst, dst + size - i32v3(1), [&](const i32v3& p, BlockID v) {
+                        i32v3 s = p - dst;
+                        BlockID n = src[((size_t)s.y * size.z + s.z) * size.x + s.x];
+                        return skipAir && n == BLOCK_AIR ? v : n;
+                    });
+                    break;
+                }
+                case 4: {
+                    i32v3 a = randomPoint(random), size(random.range(1, 30), random.range(1, 30), random.range(1, 30));
+                    std::vector<u8> mask((size_t)size.x * size.y * size.z);
+                    for (u8& m : mask) m = random.range(0, 2) == 0;
+                    got = editor.applyMask(a, size, mask.data(), id, mode);
+                    expected = referenceEdit(reference, a, a + size - i32v3(1), [&](const i32v3& p, BlockID v) {
+                        i32v3 s = p - a;
+                        return mask[((size_t)s.y * size.z + s.z) * size.x + s.x] ? applyMode(v, id, mode) : v;
+                    });
+                    break;
+                }
+            }
+            mismatches += got != expected ? 1 : 0;
+            if (op % 20 == 19) OPENVOX_CHECK(sameWorld(map, reference));
+        }
+        OPENVOX_CHECK(mismatches == 0);
+        OPENVOX_CHECK(sameWorld(map, reference));
+    });
+
+    test::run("commit sends one batch", [] {
+        ChunkMap map;
+        buildWorld(map);
+        VoxelEditor editor(&map);
+        std::vector<VoxelEditBatch> batches;
+        auto* listener = editor.onCommit.addFunctor([&](Sender, const VoxelEditBatch& b) { batches.push_back(b); });
+
+        // Both edits end at x = 31, the +x face of chunks at x = 0
+        size_t count = editor.fillBox(i32v3(20, 70, 4), i32v3(31, 75, 9), 9);
+        count += editor.fillBox(i32v3(24, 70, 4), i32v3(31, 71, 9), 8);
+        OPENVOX_CHECK(editor.hasPendingChanges());
+        OPENVOX_CHECK(batches.empty());
+        editor.commit();
+        editor.commit();
+
+        OPENVOX_CHECK(batches.size() == 1);
+        OPENVOX_CHECK(!editor.hasPendingChanges());
+        if (!batches.empty()) {
+            const VoxelEditBatch& b = batches[0];
+            OPENVOX_CHECK(b.voxelCount == count);
+            OPENVOX_CHECK(b.chunks.size() == 1 && b.chunks[0] == i32v3(0, 2, 0));
+            OPENVOX_CHECK(b.min == i32v3(20, 70, 4));
+            OPENVOX_CHECK(b.max == i32v3(31, 75, 9));
+            OPENVOX_CHECK(b.borderChunks.size() == 1 && b.borderChunks[0] == i32v3(1, 2, 0));
+        }
+
+        // Nothing changes when the same block is written again
+        OPENVOX_CHECK(editor.fillBox(i32v3(20, 72, 4), i32v3(31, 75, 9), 9) == 0);
+        editor.commit();
+        OPENVOX_CHECK(batches.size() == 1);
+
+        editor.onCommit -= *listener;
+        delete listener;
+    });
+
+    test::run("unloaded chunks are skipped", [] {
+        ChunkMap map;
+        buildWorld(map);
+        VoxelEditor editor(&map);
+        i32v3 origin = toVoxelPosition(MISSING_CHUNK);
+        // A box covering only the missing chunk changes nothing
+        OPENVOX_CHECK(editor.fillBox(origin, origin + i32v3(CHUNK_WIDTH - 1), 3) == 0);
+        OPENVOX_CHECK(map.getChunk(MISSING_CHUNK) == nullptr);
+
+        std::vector<BlockID> blocks;
+        editor.readRegion(origin - i32v3(1, 0, 0), origin + i32v3(0, 0, 0), blocks, 7);
+        OPENVOX_CHECK(blocks.size() == 2);
+        OPENVOX_CHECK(blocks.size() == 2 && blocks[0] == map.getBlock(origin - i32v3(1, 0, 0)) && blocks[1] == 7);
+    });
+
+    test::run("sphere carve matches brute force count", [] {
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(0), i32v3(2), 1, 200, 0.0f);
+        VoxelEditor editor(&map);
+        size_t carved = editor.fillSphere(i32v3(48), 30.0f, BLOCK_AIR);
+        size_t expected = 0;
+        for (i32 z = -30; z <= 30; z++) {
+            for (i32 y = -30; y <= 30; y++) {
+                for (i32 x = -30; x <= 30; x++) expected += x * x + y * y + z * z <= 900 ? 1 : 0;
+            }
+        }
+        OPENVOX_CHECK(carved == expected);
+        OPENVOX_CHECK(map.getBlock(i32v3(48)) == BLOCK_AIR && map.getBlock(i32v3(48, 48, 79)) == 1);
+        OPENVOX_CHECK(map.getBlock(i32v3(18, 48, 48)) == BLOCK_AIR && map.getBlock(i32v3(17, 48, 48)) == 1);
+    });
+
+    return test::finish();
+}
@@ -0,0 +1,182 @@
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "TestFiles.h"
+#include "TestHarness.h"
+#include "TestWorld.h"
+
+#include "io/RegionStore.h"
+#include "io/WorldSaver.h"
+#include "voxel/ChunkMap.h"
+#include "voxel/VoxelEditor.h"
+#include "voxel/WorldSnapshot.h"
+
+using namespace openvox;
+
+namespace {
+    typedef std::unordered_map<i32v3, std::vector<BlockID>, PositionHash> Copy;
+
+    /// Plain copy of every chunk's voxels, the reference a snapshot must match
+    Copy copyWorld(const ChunkMap& map) {
+        Copy copy;
+        for (auto& it : map.getChunks()) copy[it.first].assign(it.second->getBlockData(), it.second->getBlockData() + CHUNK_SIZE);
+        return copy;
+    }
+
+    int countSnapshotDifferences(const WorldSnapshot& snapshot, const Copy& copy) {
+        int differences = 0;
+        for (const WorldSnapshot::Entry& e : snapshot.getEntries()) {
+            auto it = copy.find(e.chunkPos);
+            if (!e.data || it == copy.end() || std::memcmp(e.data->blocks, it->second.data(), sizeof(BlockID) * CHUNK_SIZE)) differences++;
+        }
+        return differences + (int)(copy.size() - snapshot.size());
+    }
+
+    bool occupancyMatches(const Chunk& chunk) {
+        for (int i = 0; i < CHUNK_SIZE; i++) {
+            if (chunk.getOccupancy().isSolid(i) != (chunk.getBlock(i) != BLOCK_AIR)) return false;
+        }
+        return true;
+    }
+}
+
+int main() {
+    test::run("snapshots keep the captured voxels and clone only written chunks", [] {
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(0), i32v3(3, 1, 3));
+        Copy before = copyWorld(map);
+        std::unordered_map<i32v3, const ChunkData*, PositionHash> data;
+        for (auto& it : map.getChunks()) data[it.first] = it.second->getData();
+
+        WorldSnapshot snapshot;
+        snapshot.capture(map);
+        OPENVOX_CHECK(snapshot.size() == map.getChunkCount() && countSnapshotDifferences(snapshot, before) == 0);
+
+        // Reading never clones
+        u64 sum = 0;
+        for (auto& it : map.getChunks()) sum += it.second->getBlockData()[123] + it.second->getBlock(7);
+        test::Random random(68);
+        const i32v3 edited(1, 0, 2), filled(2, 1, 0);
+        for (int i = 0; i < 500; i++) {
+            map.setBlock(toVoxelPosition(edited) + i32v3(random.range(0, 31), random.range(0, 31), random.range(0, 31)), (BlockID)random.range(0, 9));
+        }
+        map.getChunk(filled)->fill(5);
+        int cloned = 0;
+        for (auto& it : map.getChunks()) cloned += it.second->getData() != data[it.first] ? 1 : 0;
+        OPENVOX_CHECK(cloned == 2 && map.getChunk(edited)->getData() != data[edited] && map.getChunk(filled)->getData() != data[filled]);
+        OPENVOX_CHECK(countSnapshotDifferences(snapshot, before) == 0);
+        OPENVOX_CHECK(occupancyMatches(*map.getChunk(edited)) && occupancyMatches(*map.getChunk(filled)));
+
+        // Released chunks are written in place
+        const i32v3 released(0, 0, 0);
+        for (size_t i = 0; i < snapshot.size(); i++) {
+            if (snapshot.getEntries()[i].chunkPos == released) snapshot.release(i);
+        }
+        map.setBlock(toVoxelPosition(released), 9);
+        OPENVOX_CHECK(map.getChunk(released)->getData() == data[released]);
+
+        // A second write to a cloned chunk does not clone again
+        const ChunkData* clone = map.getChunk(edited)->getData();
+        map.setBlock(toVoxelPosition(edited), 3);
+        OPENVOX_CHECK(map.getChunk(edited)->getData() == clone);
+
+        // Recapturing releases the old versions, after which nothing is shared
+        Copy now = copyWorld(map);
+        snapshot.capture(map);
+        OPENVOX_CHECK(countSnapshotDifferences(snapshot, now) == 0);
+        snapshot.clear();
+        int shared = 0;
+        for (auto& it : map.getChunks()) shared += it.second->getData()->isShared() ? 1 : 0;
+        OPENVOX_CHECK(shared == 0 && sum > 0);
+    });
+
+    test::run("editor operations clone only chunks whose voxels change", [] {
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(0), i32v3(3, 1, 3));
+        EditHistory history(&map);
+        VoxelEditor editor(&map);
+        editor.setHistory(&history);
+        // The box covers 2x1x2 chunks, with one air voxel left in one of them
+        const i32v3 boxMin(0), boxMax(2 * CHUNK_WIDTH - 1, CHUNK_WIDTH - 1, 2 * CHUNK_WIDTH - 1);
+        const i32v3 holed(1, 0, 1);
+        editor.fillBox(boxMin, boxMax, 4);
+        map.setBlock(toVoxelPosition(holed) + i32v3(5), BLOCK_AIR);
+        Copy before = copyWorld(map);
+        std::unordered_map<i32v3, const ChunkData*, PositionHash> data;
+        for (auto& it : map.getChunks()) data[it.first] = it.second->getData();
+
+        WorldSnapshot snapshot;
+        snapshot.capture(map);
+        OPENVOX_CHECK(editor.fillBox(boxMin, boxMax, 4) == 1);
+        OPENVOX_CHECK(editor.fillBox(boxMin, boxMax, 4) == 0 && editor.fillBox(boxMin, boxMax, 7, EditMode::FILL_AIR) == 0);
+        int cloned = 0;
+        for (auto& it : map.getChunks()) cloned += it.second->getData() != data[it.first] ? 1 : 0;
+        OPENVOX_CHECK(cloned == 1 && map.getChunk(holed)->getData() != data[holed]);
+        OPENVOX_CHECK(countSnapshotDifferences(snapshot, before) == 0 && occupancyMatches(*map.getChunk(holed)));
+    });
+
+    test::run("snapshots outlive their chunks", [] {
+        WorldSnapshot snapshot;
+        Copy before;
+        {
+            ChunkMap map;
+            test::buildTerrain(map, i32v3(0), i32v3(1, 0, 1));
+            before = copyWorld(map);
+            snapshot.capture(map);
+        }
+        OPENVOX_CHECK(countSnapshotDifferences(snapshot, before) == 0);
+    });
+
+    test::run("background save writes the world as it was at save()", [] {
+        test::TempDirectory dir("world_saver");
+        ChunkMap map;
+        test::buildTerrain(map, i32v3(-2, 0, -2), i32v3(3, 1, 3), 1, 32, 12.0f);
+        RegionStore regions;
+        OPENVOX_CHECK(regions.open(dir.getPath()));
+        Copy before = copyWorld(map);
+
+        WorldSaver saver;
+        OPENVOX_CHECK(saver.save(map, regions));
+        OPENVOX_CHECK(!saver.isSaving() || !saver.save(map, regions));
+        // The simulation keeps editing while the saver runs
+        test::Random random(69);
+        int ticks = 0;
+        do {
+            for (int i = 0; i < 200; i++) {
+                i32v3 p(random.range(-64, 127), random.range(0, 63), random.range(-64, 127));
+                map.setBlock(p, (BlockID)random.range(0, 9));
+            }
+            ticks++;
+        } while (saver.isSaving() && ticks < 100000);
+        OPENVOX_CHECK(saver.wait());
+        const WorldSaveStats& stats = saver.getStats();
+        OPENVOX_CHECK(stats.succeeded && stats.chunks == before.size() && stats.saveTime > 0.0f);
+
+        // Regions hold the world from before the edits, and the live chunks kept every edit
+        int differences = 0;
+        for (auto& it : before) {
+            Chunk chunk(it.first);
+            if (!regions.loadChunk(chunk) || std::memcmp(chunk.getBlockData(), it.second.data(), sizeof(BlockID) * CHUNK_SIZE)) differences++;
+        }
+        OPENVOX_CHECK(differences == 0);
+        int shared = 0, badOccupancy = 0;
+        for (auto& it : map.getChunks()) {
+            shared += it.second->getData()->isShared() ? 1 : 0;
+            badOccupancy += occupancyMatches(*it.second) ? 0 : 1;
+        }
+        OPENVOX_CHECK(shared == 0 && badOccupancy == 0);
+
+        // A second save picks up the edits
+        Copy after = copyWorld(map);
+        OPENVOX_CHECK(saver.save(map, regions) && saver.wait());
+        differences = 0;
+        for (auto& it : after) {
+            Chunk chunk(it.first);
+            if (!regions.loadChunk(chunk) || std::memcmp(chunk.getBlockData(), it.second.data(), sizeof(BlockID) * CHUNK_SIZE)) differences++;
+        }
+        OPENVOX_CHECK(differences == 0);
+    });
+
+    return test::finish();
+}